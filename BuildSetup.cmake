@@ -54,8 +54,11 @@ endif()
 # When doing a debug build, enable the
 # address sanitizer. This has a 2x slowdown
 # but is adept at catching various memory problems.
+# The thread sanitizer cannot be combined with it,
+# so it takes precedence when both are requested.
 #----------------------------------------
-if( (${CMAKE_BUILD_TYPE} MATCHES "debug") AND (${ADDRESS_SANITIZER} MATCHES "ON") )
+if( (${CMAKE_BUILD_TYPE} MATCHES "debug") AND (${ADDRESS_SANITIZER} MATCHES "ON")
+    AND NOT (${THREAD_SANITIZER} MATCHES "ON") )
     if (${CMAKE_CXX_COMPILER_ID} MATCHES "Clang"
         OR ((${CMAKE_CXX_COMPILER_VERSION} VERSION_GREATER "4.9.0" ) AND CMAKE_COMPILER_IS_GNUCXX))
         message(STATUS "Enabling address sanitizer for debug build")
@@ -63,6 +66,22 @@ if( (${CMAKE_BUILD_TYPE} MATCHES "debug") AND (${ADDRESS_SANITIZER} MATCHES "ON"
     endif()
 endif()
 
+#----------------------------------------
+# Optionally enable the thread sanitizer,
+# which detects data races between threads,
+# e.g. in the XvtStoreSnapshot_T tests.
+# This has a 5-15x slowdown.
+#----------------------------------------
+if( ${THREAD_SANITIZER} MATCHES "ON" )
+    if (${CMAKE_CXX_COMPILER_ID} MATCHES "Clang"
+        OR ((${CMAKE_CXX_COMPILER_VERSION} VERSION_GREATER "4.9.0" ) AND CMAKE_COMPILER_IS_GNUCXX))
+        message(STATUS "Enabling thread sanitizer")
+        set( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=thread -fno-omit-frame-pointer" )
+        set( CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} -fsanitize=thread" )
+        set( CMAKE_SHARED_LINKER_FLAGS "${CMAKE_SHARED_LINKER_FLAGS} -fsanitize=thread" )
+    endif()
+endif()
+
 #----------------------------------------
 # Windows Visual Studio flags
 #----------------------------------------
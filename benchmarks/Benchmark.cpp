@@ -0,0 +1,259 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Benchmark.cpp
+/// Timing and reporting of benchmarks.
+
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "Benchmark.hpp"
+#include "Exception.hpp"
+
+#ifndef GPSTK_BENCHMARK_VERSION
+#define GPSTK_BENCHMARK_VERSION "unknown"
+#endif
+#ifndef GPSTK_BENCHMARK_BUILD_TYPE
+#define GPSTK_BENCHMARK_BUILD_TYPE "unknown"
+#endif
+
+using namespace std;
+
+namespace gpstk
+{
+      // escape a string for JSON
+   static string jsonString(const string& s)
+   {
+      ostringstream oss;
+      oss << '"';
+      for(size_t i=0; i<s.size(); i++)
+      {
+         unsigned char c(s[i]);
+         if(c == '"' || c == '\\')
+            oss << '\\' << c;
+         else if(c == '\n')
+            oss << "\\n";
+         else if(c == '\t')
+            oss << "\\t";
+         else if(c < 0x20)
+            oss << "\\u" << hex << setw(4) << setfill('0') << int(c)
+                << dec << setfill(' ');
+         else
+            oss << c;
+      }
+      oss << '"';
+      return oss.str();
+   }
+
+      // a double for JSON, which has no inf or nan
+   static string jsonNumber(const double& d)
+   {
+      if(!std::isfinite(d))
+         return string("null");
+      ostringstream oss;
+      oss << setprecision(9) << d;
+      return oss.str();
+   }
+
+   static string compilerName()
+   {
+      ostringstream oss;
+#if defined(__clang__)
+      oss << "clang " << __clang_major__ << "." << __clang_minor__
+          << "." << __clang_patchlevel__;
+#elif defined(__GNUC__)
+      oss << "gcc " << __GNUC__ << "." << __GNUC_MINOR__
+          << "." << __GNUC_PATCHLEVEL__;
+#elif defined(_MSC_VER)
+      oss << "msvc " << _MSC_VER;
+#else
+      oss << "unknown";
+#endif
+      return oss.str();
+   }
+
+
+   BenchmarkSuite :: ~BenchmarkSuite()
+   {
+      for(size_t i=0; i<benchmarks.size(); i++)
+         delete benchmarks[i];
+      benchmarks.clear();
+   }
+
+
+   vector<BenchmarkResult> BenchmarkSuite ::
+   run(const string& filter, ostream *log)
+   {
+      vector<BenchmarkResult> results;
+      for(size_t i=0; i<benchmarks.size(); i++)
+      {
+         if(!filter.empty() &&
+            benchmarks[i]->name.find(filter) == string::npos)
+            continue;
+         BenchmarkResult res(runOne(*benchmarks[i]));
+         results.push_back(res);
+         if(log)
+         {
+            *log << left << setw(32) << res.name << right;
+            if(!res.error.empty())
+               *log << " FAILED: " << res.error << endl;
+            else
+               *log << fixed << setprecision(6)
+                    << " median " << setw(11) << res.medianTime << " s"
+                    << " min " << setw(11) << res.minTime << " s"
+                    << setprecision(0) << setw(14)
+                    << (res.medianTime > 0.0 ? res.items/res.medianTime : 0.0)
+                    << " " << res.unit << "/s"
+                    << " (" << res.iterations << " it)" << endl;
+         }
+      }
+      return results;
+   }
+
+
+   BenchmarkResult BenchmarkSuite :: runOne(Benchmark& b)
+   {
+      typedef std::chrono::steady_clock Clock;
+
+      BenchmarkResult res;
+      res.name = b.name;
+      res.unit = b.unit;
+      res.iterations = res.items = 0;
+      res.minTime = res.medianTime = res.meanTime = res.stdDevTime = 0.0;
+
+      vector<double> times;
+      try
+      {
+         b.setUp();
+            // one untimed call to warm caches and lazy initialization
+         res.items = b.run();
+
+         double total(0.0);
+         while(times.size() < minIterations || total < minTime)
+         {
+            Clock::time_point t0(Clock::now());
+            unsigned long n(b.run());
+            Clock::time_point t1(Clock::now());
+            double dt(std::chrono::duration<double>(t1-t0).count());
+            times.push_back(dt);
+            total += dt;
+            res.items = n;
+         }
+      }
+      catch(Exception& e)
+      {
+         res.error = e.getText();
+      }
+      catch(std::exception& e)
+      {
+         res.error = e.what();
+      }
+      catch(...)
+      {
+         res.error = "unknown exception";
+      }
+
+      if(!res.error.empty() || times.empty())
+         return res;
+
+      res.iterations = times.size();
+      double sum(0.0), sumsq(0.0);
+      for(size_t i=0; i<times.size(); i++)
+      {
+         sum += times[i];
+         sumsq += times[i]*times[i];
+      }
+      res.meanTime = sum/times.size();
+      res.stdDevTime = (times.size() > 1
+                        ? ::sqrt(std::max(0.0,
+                          (sumsq - sum*res.meanTime)/(times.size()-1)))
+                        : 0.0);
+      std::sort(times.begin(), times.end());
+      res.minTime = times[0];
+      size_t m(times.size()/2);
+      res.medianTime = (times.size() % 2 ? times[m]
+                        : 0.5*(times[m-1]+times[m]));
+
+      return res;
+   }
+
+
+   void BenchmarkSuite ::
+   writeJSON(ostream& os, const vector<BenchmarkResult>& results,
+             const string& dataDir)
+   {
+      char date[32];
+      time_t now(time(0));
+      strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+      os << "{\n"
+         << "  \"context\": {\n"
+         << "    \"library\": \"gpstk\",\n"
+         << "    \"version\": " << jsonString(GPSTK_BENCHMARK_VERSION) << ",\n"
+         << "    \"build_type\": " << jsonString(GPSTK_BENCHMARK_BUILD_TYPE)
+         << ",\n"
+         << "    \"compiler\": " << jsonString(compilerName()) << ",\n"
+         << "    \"date\": " << jsonString(date) << ",\n"
+         << "    \"data_dir\": " << jsonString(dataDir) << "\n"
+         << "  },\n"
+         << "  \"benchmarks\": [";
+      for(size_t i=0; i<results.size(); i++)
+      {
+         const BenchmarkResult& r(results[i]);
+         os << (i ? "," : "") << "\n    {\n"
+            << "      \"name\": " << jsonString(r.name) << ",\n"
+            << "      \"unit\": " << jsonString(r.unit) << ",\n";
+         if(!r.error.empty())
+            os << "      \"error\": " << jsonString(r.error) << ",\n";
+         os << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"items_per_iteration\": " << r.items << ",\n"
+            << "      \"min_s\": " << jsonNumber(r.minTime) << ",\n"
+            << "      \"median_s\": " << jsonNumber(r.medianTime) << ",\n"
+            << "      \"mean_s\": " << jsonNumber(r.meanTime) << ",\n"
+            << "      \"stddev_s\": " << jsonNumber(r.stdDevTime) << ",\n"
+            << "      \"items_per_second\": "
+            << jsonNumber(r.medianTime > 0.0 ? r.items/r.medianTime : 0.0)
+            << "\n    }";
+      }
+      os << (results.empty() ? "" : "\n  ") << "]\n}\n";
+   }
+
+} // namespace gpstk
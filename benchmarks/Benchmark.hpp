@@ -0,0 +1,167 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Benchmark.hpp
+/// A minimal harness for timing the hot paths of the GPSTk, with
+/// machine-readable (JSON) output for tracking performance between releases.
+
+#ifndef GPSTK_BENCHMARK_HPP
+#define GPSTK_BENCHMARK_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace gpstk
+{
+      /** A single benchmark. Derived classes do any expensive preparation
+       * (reading input files, building stores) in setUp(), which is not
+       * timed, and the work to be measured in run(), which is called
+       * repeatedly. */
+   class Benchmark
+   {
+   public:
+         /** @param[in] name name of the benchmark, e.g. "rinex3_obs_read"
+          * @param[in] unit what run() counts, e.g. "epochs" */
+      Benchmark(const std::string& name, const std::string& unit)
+            : name(name), unit(unit)
+      {}
+
+      virtual ~Benchmark() {}
+
+         /// Untimed preparation; called once before the first run().
+         /// @throw Exception if the inputs are not available
+      virtual void setUp() {}
+
+         /// Do the timed work once.
+         /// @return the number of items (in unit) processed
+      virtual unsigned long run() = 0;
+
+      std::string name;    ///< name, unique within the suite
+      std::string unit;    ///< what the items returned by run() are
+   };
+
+
+      /// Timing results for one benchmark.
+   struct BenchmarkResult
+   {
+      std::string name;
+      std::string unit;
+      std::string error;         ///< empty unless setUp() or run() threw
+      unsigned long iterations;  ///< number of timed calls of run()
+      unsigned long items;       ///< items processed per call of run()
+      double minTime;            ///< fastest call of run(), seconds
+      double medianTime;         ///< median call of run(), seconds
+      double meanTime;           ///< mean call of run(), seconds
+      double stdDevTime;         ///< standard deviation, seconds
+   };
+
+
+      /** A collection of benchmarks, which it owns, that it runs and
+       * reports. */
+   class BenchmarkSuite
+   {
+   public:
+      BenchmarkSuite()
+            : minTime(1.0), minIterations(3)
+      {}
+
+         /// Delete the benchmarks.
+      ~BenchmarkSuite();
+
+         /// Add a benchmark, which is deleted by the suite.
+      void add(Benchmark *pb)
+      { benchmarks.push_back(pb); }
+
+         /// The benchmarks in the order they were added.
+      const std::vector<Benchmark*>& getBenchmarks() const
+      { return benchmarks; }
+
+         /** Run every benchmark whose name contains filter (all if
+          * filter is empty). Each is called once untimed, then timed
+          * until it has run for at least minTime seconds and
+          * minIterations times. A benchmark that throws is reported
+          * with its error and does not stop the others.
+          * @param[in] filter substring of the names to run
+          * @param[in,out] log if not NULL, a line is written for each
+          *   benchmark as it finishes
+          * @return the results, in order */
+      std::vector<BenchmarkResult> run(const std::string& filter,
+                                       std::ostream *log);
+
+         /** Write results as JSON: an object with "context" (version,
+          * compiler, build type, date, and the given data directory)
+          * and "benchmarks", an array with one object per result. */
+      static void writeJSON(std::ostream& os,
+                            const std::vector<BenchmarkResult>& results,
+                            const std::string& dataDir);
+
+         /// Minimum total time (seconds) for each benchmark.
+      double minTime;
+         /// Minimum number of timed iterations for each benchmark.
+      unsigned long minIterations;
+
+   private:
+         /// Time one benchmark.
+      BenchmarkResult runOne(Benchmark& b);
+
+      std::vector<Benchmark*> benchmarks;
+
+         // no copies, the suite owns the benchmarks
+      BenchmarkSuite(const BenchmarkSuite&);
+      BenchmarkSuite& operator=(const BenchmarkSuite&);
+   };
+
+
+      /// @name Benchmarks of each area, each defined in its own file.
+      /// dataDir is the directory of input files, normally data/.
+      //@{
+   void addFileBenchmarks(BenchmarkSuite& suite, const std::string& dataDir);
+   void addEphBenchmarks(BenchmarkSuite& suite, const std::string& dataDir);
+   void addPosBenchmarks(BenchmarkSuite& suite, const std::string& dataDir);
+   void addTimeBenchmarks(BenchmarkSuite& suite, const std::string& dataDir);
+   void addNavFilterBenchmarks(BenchmarkSuite& suite,
+                               const std::string& dataDir);
+#ifdef GPSTK_BENCHMARK_EXT
+   void addCodeGenBenchmarks(BenchmarkSuite& suite, const std::string& dataDir);
+#endif
+      //@}
+
+} // namespace gpstk
+
+#endif
@@ -0,0 +1,256 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file CodeGenBenchmarks.cpp
+/// Benchmarks of P-code generation (ext library).
+
+#include <thread>
+#include "Benchmark.hpp"
+#include "SVPCodeGen.hpp"
+#include "PCodeReplica.hpp"
+#include "CodeBuffer.hpp"
+#include "X1Sequence.hpp"
+#include "X2Sequence.hpp"
+#include "PCodeConst.hpp"
+#include "GPSWeekSecond.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /// Allocate the X1 and X2 sequences shared by all the benchmarks, once.
+   void allocateSequences()
+   {
+      static bool allocated = false;
+      if(!allocated)
+      {
+         X1Sequence::allocateMemory();
+         X2Sequence::allocateMemory();
+         allocated = true;
+      }
+   }
+
+
+      /// Generate consecutive six-second blocks of P-code for one PRN.
+   class PCodeBenchmark : public Benchmark
+   {
+   public:
+      PCodeBenchmark(const string& name, int prnID, SVPCodeGen::Kernel k)
+            : Benchmark(name, "chips"), prn(prnID), kernel(k), gen(0),
+              buffer(0)
+      {}
+
+      virtual ~PCodeBenchmark()
+      {
+         delete gen;
+         delete buffer;
+      }
+
+      virtual void setUp()
+      {
+         allocateSequences();
+         gen = new SVPCodeGen(prn, GPSWeekSecond(1854, 0.0));
+         gen->setKernel(kernel);
+         buffer = new CodeBuffer(prn);
+      }
+
+      virtual unsigned long run()
+      {
+         gen->getCurrentSixSeconds(*buffer);
+         gen->increment4ZCounts();
+         return (unsigned long)NUM_6SEC_WORDS * MAX_BIT;
+      }
+
+      int prn;
+      SVPCodeGen::Kernel kernel;
+      SVPCodeGen *gen;
+      CodeBuffer *buffer;
+   };
+
+
+      /// Generate consecutive six-second blocks of P-code for PRNs 1-37
+      /// at once, one thread per core.
+   class PCodeAllPRNBenchmark : public Benchmark
+   {
+   public:
+      PCodeAllPRNBenchmark()
+            : Benchmark("svpcodegen_6sec_37prn", "chips"), nThreads(1)
+      {}
+
+      virtual ~PCodeAllPRNBenchmark()
+      {
+         for (size_t i=0; i<gens.size(); ++i)
+         {
+            delete gens[i];
+            delete buffers[i];
+         }
+      }
+
+      virtual void setUp()
+      {
+         allocateSequences();
+         for (int prn=1; prn<=37; ++prn)
+         {
+            gens.push_back(new SVPCodeGen(prn, GPSWeekSecond(1854, 0.0)));
+            buffers.push_back(new CodeBuffer(prn));
+         }
+         nThreads = std::thread::hardware_concurrency();
+      }
+
+      virtual unsigned long run()
+      {
+         SVPCodeGen::getCurrentSixSeconds(gens, buffers, nThreads);
+         for (size_t i=0; i<gens.size(); ++i)
+            gens[i]->increment4ZCounts();
+         return (unsigned long)NUM_6SEC_WORDS * MAX_BIT * gens.size();
+      }
+
+      unsigned int nThreads;
+      vector<SVPCodeGen*> gens;
+      vector<CodeBuffer*> buffers;
+   };
+
+
+      /// Number of samples per iteration of the replica benchmarks
+   const long REPLICA_SAMPLES = 1000000;
+
+      /// Sample rate of the replica benchmarks, not a multiple of the chip rate
+   const double REPLICA_RATE = 25e6;
+
+
+      /** Sample P-code at REPLICA_RATE one bit at a time with
+       * CodeBuffer::getBit( ), generating the next six seconds as needed. */
+   class ReplicaGetBitBenchmark : public Benchmark
+   {
+   public:
+      ReplicaGetBitBenchmark()
+            : Benchmark("replica_getbit", "samples"), gen(0), buffer(0),
+              sample(0)
+      {}
+
+      virtual ~ReplicaGetBitBenchmark()
+      {
+         delete gen;
+         delete buffer;
+      }
+
+      virtual void setUp()
+      {
+         allocateSequences();
+         gen = new SVPCodeGen(1, GPSWeekSecond(1854, 0.0));
+         buffer = new CodeBuffer(1);
+         gen->getCurrentSixSeconds(*buffer);
+         samples.resize(REPLICA_SAMPLES);
+      }
+
+      virtual unsigned long run()
+      {
+         const double chipsPerSample = PY_CHIP_FREQ_GPS / REPLICA_RATE;
+         const long chips = NUM_6SEC_WORDS * MAX_BIT;
+         for (long k=0; k<REPLICA_SAMPLES; ++k, ++sample)
+         {
+            long chip = (long)(sample * chipsPerSample);
+            if (chip >= chips)
+            {
+               gen->increment4ZCounts();
+               gen->getCurrentSixSeconds(*buffer);
+               sample = 0;
+               chip = 0;
+            }
+            samples[k] = 1 - 2 * (int)buffer->getBit(chip);
+         }
+         return REPLICA_SAMPLES;
+      }
+
+      SVPCodeGen *gen;
+      CodeBuffer *buffer;
+      long sample;
+      vector<int8_t> samples;
+   };
+
+
+      /// Sample P-code at REPLICA_RATE with PCodeReplica.
+   class ReplicaBenchmark : public Benchmark
+   {
+   public:
+      ReplicaBenchmark(const string& name, bool isPacked)
+            : Benchmark(name, "samples"), packed(isPacked), rep(0)
+      {}
+
+      virtual ~ReplicaBenchmark()
+      {
+         delete rep;
+      }
+
+      virtual void setUp()
+      {
+         allocateSequences();
+         rep = new PCodeReplica(1, GPSZcount(1854, 0), 0.0, REPLICA_RATE);
+         samples.resize(REPLICA_SAMPLES);
+         words.resize(REPLICA_SAMPLES / MAX_BIT + 1);
+      }
+
+      virtual unsigned long run()
+      {
+         if (packed)
+            rep->generatePacked(&words[0], REPLICA_SAMPLES);
+         else
+            rep->generate(&samples[0], REPLICA_SAMPLES);
+         return REPLICA_SAMPLES;
+      }
+
+      bool packed;
+      PCodeReplica *rep;
+      vector<int8_t> samples;
+      vector<uint32_t> words;
+   };
+
+
+   void addCodeGenBenchmarks(BenchmarkSuite& suite, const string& dataDir)
+   {
+      suite.add(new PCodeBenchmark("svpcodegen_6sec_reference", 1,
+                                   SVPCodeGen::REFERENCE_KERNEL));
+      suite.add(new PCodeBenchmark("svpcodegen_6sec", 1,
+                                   SVPCodeGen::AUTO_KERNEL));
+      suite.add(new PCodeAllPRNBenchmark());
+      suite.add(new ReplicaGetBitBenchmark());
+      suite.add(new ReplicaBenchmark("replica_int8", false));
+      suite.add(new ReplicaBenchmark("replica_packed", true));
+   }
+
+} // namespace gpstk
@@ -0,0 +1,284 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file EphBenchmarks.cpp
+/// Benchmarks of loading and evaluating broadcast and precise ephemerides.
+
+#include <cstdio>
+#include <set>
+#include "Benchmark.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "EphemerisCache.hpp"
+#include "ChebyshevEphemerisStore.hpp"
+#include "GPSEphemerisStore.hpp"
+#include "GPSEphemeris.hpp"
+#include "RinexNavStream.hpp"
+#include "RinexNavHeader.hpp"
+#include "RinexNavData.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /// Load an SP3 file into a new store.
+   class SP3LoadBenchmark : public Benchmark
+   {
+   public:
+      SP3LoadBenchmark(const string& file)
+            : Benchmark("sp3_load", "records"), filename(file)
+      {}
+
+      virtual unsigned long run()
+      {
+         SP3EphemerisStore store;
+         store.loadFile(filename);
+         return store.ndata();
+      }
+
+      string filename;
+   };
+
+
+      /** Load the same SP3 file into a new store from an
+       * EphemerisCache file, written in setUp(). */
+   class SP3CacheLoadBenchmark : public Benchmark
+   {
+   public:
+      SP3CacheLoadBenchmark(const string& file)
+            : Benchmark("sp3_load_cache", "records"), filename(file),
+              cacheFile("sp3_load_cache.bin")
+      {}
+
+      virtual ~SP3CacheLoadBenchmark()
+      { std::remove(cacheFile.c_str()); }
+
+      virtual void setUp()
+      {
+         SP3EphemerisStore store;
+         store.loadFile(filename);
+         EphemerisCache::write(cacheFile, store);
+      }
+
+      virtual unsigned long run()
+      {
+         SP3EphemerisStore store;
+         if(!EphemerisCache::read(cacheFile, store,
+                                  vector<string>(1, filename)))
+         {
+            Exception e("Cache file " + cacheFile + " is not valid");
+            GPSTK_THROW(e);
+         }
+         return store.ndata();
+      }
+
+      string filename, cacheFile;
+   };
+
+
+      /** Evaluate an XvtStore at every satellite and every step seconds
+       * across the span of the store, either one at a time with
+       * getXvt() or all at once with computeXvts(). */
+   class StoreXvtBenchmark : public Benchmark
+   {
+   public:
+      StoreXvtBenchmark(const string& name, XvtStore<SatID> *pStore,
+                        const vector<SatID>& satList,
+                        const CommonTime& begin, const CommonTime& end,
+                        double step, bool batch)
+            : Benchmark(name, "evaluations"), store(pStore), isBatch(batch),
+              sats(satList)
+      {
+         for(CommonTime t(begin); t <= end; t += step)
+            times.push_back(t);
+      }
+
+      virtual ~StoreXvtBenchmark()
+      { delete store; }
+
+      virtual unsigned long run()
+      {
+         unsigned long n(0);
+         if(isBatch)
+         {
+            store->computeXvts(sats, times, xvts);
+            for(size_t i=0; i<xvts.size(); i++)
+               if(xvts[i].health != Xvt::Unavailable)
+                  n++;
+            return n;
+         }
+         for(size_t i=0; i<sats.size(); i++)
+         {
+            for(size_t j=0; j<times.size(); j++)
+            {
+               try
+               {
+                  Xvt xvt(store->getXvt(sats[i], times[j]));
+                  n++;
+               }
+               catch(InvalidRequest&)
+               {}
+            }
+         }
+         return n;
+      }
+
+      XvtStore<SatID> *store;
+      bool isBatch;
+      vector<SatID> sats;
+      vector<CommonTime> times;
+      vector<Xvt> xvts;
+   };
+
+
+      /// Evaluate OrbitEph::svXvt() for each ephemeris at one second steps
+      /// across its validity.
+   class SvXvtBenchmark : public Benchmark
+   {
+   public:
+      SvXvtBenchmark(const string& file)
+            : Benchmark("orbiteph_svxvt", "evaluations"), filename(file)
+      {}
+
+      virtual void setUp()
+      {
+         RinexNavStream strm(filename.c_str(), ios::in);
+         RinexNavHeader hdr;
+         RinexNavData rnd;
+         strm >> hdr;
+         while(strm >> rnd && ephs.size() < 16)
+            ephs.push_back(GPSEphemeris(rnd));
+         if(ephs.empty())
+         {
+            Exception e("No ephemerides in " + filename);
+            GPSTK_THROW(e);
+         }
+      }
+
+      virtual unsigned long run()
+      {
+         unsigned long n(0);
+         for(size_t i=0; i<ephs.size(); i++)
+         {
+            const GPSEphemeris& eph(ephs[i]);
+            for(CommonTime t(eph.ctToe - 3600.0); t < eph.ctToe + 3600.0;
+                t += 1.0)
+            {
+               Xvt xvt(eph.svXvt(t));
+               n++;
+            }
+         }
+         return n;
+      }
+
+      string filename;
+      vector<GPSEphemeris> ephs;
+   };
+
+
+   void addEphBenchmarks(BenchmarkSuite& suite, const string& dataDir)
+   {
+      const string sp3File(dataDir + "/test_input_sp3_nav_2015_200.sp3");
+      const string navFile(dataDir + "/arlm200b.15n");
+
+      suite.add(new SP3LoadBenchmark(sp3File));
+      suite.add(new SP3CacheLoadBenchmark(sp3File));
+
+         // the stores are loaded here, rather than in setUp(), so that a
+         // missing file is reported by each benchmark that needs it
+      SP3EphemerisStore *pSP3[3] = { 0, 0, 0 };
+      ChebyshevEphemerisStore *pCheb(0);
+      GPSEphemerisStore *pGPS[2] = { 0, 0 };
+      try
+      {
+         for(int i=0; i<2; i++)
+         {
+            pSP3[i] = new SP3EphemerisStore();
+            pSP3[i]->loadFile(sp3File);
+            pGPS[i] = new GPSEphemerisStore();
+            RinexNavStream strm(navFile.c_str(), ios::in);
+            RinexNavHeader hdr;
+            RinexNavData rnd;
+            strm >> hdr;
+            while(strm >> rnd)
+               pGPS[i]->addEphemeris(GPSEphemeris(rnd));
+         }
+         pSP3[2] = new SP3EphemerisStore();
+         pSP3[2]->loadFile(sp3File);
+         pSP3[2]->setWindowCache(true);
+         pCheb = new ChebyshevEphemerisStore();
+         pCheb->fit(*pSP3[2]);
+      }
+      catch(Exception& e)
+      {
+         for(int i=0; i<2; i++)
+         {
+            delete pSP3[i];
+            delete pGPS[i];
+         }
+         delete pSP3[2];
+         delete pCheb;
+         GPSTK_RETHROW(e);
+      }
+
+         // two hours in the interior of the file, off the tabulated epochs
+         // so that every evaluation is interpolated
+      vector<SatID> sp3Sats(pSP3[0]->getSatList());
+      CommonTime sp3Begin(pSP3[0]->getInitialTime() + 7230.0),
+         sp3End(sp3Begin + 7200.0);
+      suite.add(new StoreXvtBenchmark("sp3_getxvt", pSP3[0], sp3Sats,
+                                      sp3Begin, sp3End, 30.0, false));
+      suite.add(new StoreXvtBenchmark("sp3_computexvts", pSP3[1], sp3Sats,
+                                      sp3Begin, sp3End, 30.0, true));
+      suite.add(new StoreXvtBenchmark("sp3_getxvt_window", pSP3[2], sp3Sats,
+                                      sp3Begin, sp3End, 30.0, false));
+      suite.add(new StoreXvtBenchmark("chebyshev_getxvt", pCheb, sp3Sats,
+                                      sp3Begin, sp3End, 30.0, false));
+
+      set<SatID> gpsSet(pGPS[0]->getIndexSet());
+      vector<SatID> gpsSats(gpsSet.begin(), gpsSet.end());
+      CommonTime gpsBegin(pGPS[0]->getInitialTime()),
+         gpsEnd(pGPS[0]->getFinalTime());
+      suite.add(new StoreXvtBenchmark("orbitephstore_getxvt", pGPS[0], gpsSats,
+                                      gpsBegin, gpsEnd, 30.0, false));
+      suite.add(new StoreXvtBenchmark("orbitephstore_computexvts", pGPS[1],
+                                      gpsSats, gpsBegin, gpsEnd, 30.0, true));
+
+      suite.add(new SvXvtBenchmark(navFile));
+   }
+
+} // namespace gpstk
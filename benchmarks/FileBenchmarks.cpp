@@ -0,0 +1,341 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file FileBenchmarks.cpp
+/// Benchmarks of reading RINEX observation and navigation files and
+/// BINEX files, of writing RINEX and SP3 files, and of parsing
+/// their numeric fields.
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "Benchmark.hpp"
+#include "RinexObsStream.hpp"
+#include "RinexObsHeader.hpp"
+#include "RinexObsData.hpp"
+#include "RinexNavStream.hpp"
+#include "RinexNavHeader.hpp"
+#include "RinexNavData.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavHeader.hpp"
+#include "Rinex3NavData.hpp"
+#include "SP3Stream.hpp"
+#include "SP3Header.hpp"
+#include "SP3Data.hpp"
+#include "BinexStream.hpp"
+#include "BinexRecordScanner.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /** Read an entire file, header and data, with stream type S,
+       * header type H and data type D.
+       * @return the number of data records read */
+   template <class S, class H, class D>
+   class FileReadBenchmark : public Benchmark
+   {
+   public:
+      FileReadBenchmark(const string& name, const string& unit,
+                        const string& file)
+            : Benchmark(name, unit), filename(file)
+      {}
+
+      virtual void setUp()
+      {
+         S strm(filename.c_str(), ios::in);
+         if(!strm)
+         {
+            Exception e("Unable to open " + filename);
+            GPSTK_THROW(e);
+         }
+      }
+
+      virtual unsigned long run()
+      {
+         S strm(filename.c_str(), ios::in);
+         strm.exceptions(fstream::failbit);
+         H hdr;
+         D data;
+         unsigned long n(0);
+         strm >> hdr;
+         while(strm >> data)
+            n++;
+         return n;
+      }
+
+      string filename;
+   };
+
+
+      /** Write a file, header and data, with stream type S, header
+       * type H and data type D, from the records of an input file
+       * read in setUp().
+       * @return the number of data records written */
+   template <class S, class H, class D>
+   class FileWriteBenchmark : public Benchmark
+   {
+   public:
+      FileWriteBenchmark(const string& name, const string& unit,
+                         const string& file)
+            : Benchmark(name, unit), filename(file), outname(name + ".out")
+      {}
+
+      virtual ~FileWriteBenchmark()
+      { std::remove(outname.c_str()); }
+
+      virtual void setUp()
+      {
+         S strm(filename.c_str(), ios::in);
+         if(!strm)
+         {
+            Exception e("Unable to open " + filename);
+            GPSTK_THROW(e);
+         }
+         D data;
+         strm >> hdr;
+         records.clear();
+         while(strm >> data)
+            records.push_back(data);
+      }
+
+      virtual unsigned long run()
+      {
+         S strm(outname.c_str(), ios::out);
+         strm.exceptions(fstream::failbit);
+         strm << hdr;
+         for(size_t i=0; i<records.size(); i++)
+            strm << records[i];
+         return records.size();
+      }
+
+      string filename;
+      string outname;
+      H hdr;
+      vector<D> records;
+   };
+
+
+      /** Read every record of a BINEX file, written in setUp(),
+       * either with BinexData::getRecord() from a BinexStream or by
+       * reading the file into memory and walking it with a
+       * BinexRecordScanner.
+       * @return the number of records read */
+   class BinexReadBenchmark : public Benchmark
+   {
+   public:
+      BinexReadBenchmark(const string& name, bool useScanner)
+            : Benchmark(name, "records"), filename(name + ".bnx"),
+              scan(useScanner)
+      {}
+
+      virtual ~BinexReadBenchmark()
+      { std::remove(filename.c_str()); }
+
+      virtual void setUp()
+      {
+            // a day of 30 s epochs of observation-sized records,
+            // with the odd navigation-sized one
+         BinexStream strm(filename.c_str(), ios::out | ios::binary);
+         strm.exceptions(fstream::failbit);
+         uint32_t seed(1);
+         for(unsigned i=0; i<2880*4; i++)
+         {
+            BinexData rec((i % 4) == 3 ? 1 : 0x7f);
+            string msg((i % 4) == 3 ? 120 : 700, 0);
+            for(size_t j=0; j<msg.size(); j++)
+            {
+               seed = seed * 1103515245 + 12345;
+               msg[j] = seed >> 24;
+            }
+            size_t offset(0);
+            rec.updateMessageData(offset, msg, msg.size());
+            rec.putRecord(strm);
+         }
+      }
+
+      virtual unsigned long run()
+      {
+         return scan ? runScanner() : runStream();
+      }
+
+      unsigned long runStream()
+      {
+         BinexStream strm(filename.c_str(), ios::in | ios::binary);
+         BinexData rec;
+         unsigned long n(0);
+         while(strm.peek() != BinexStream::traits_type::eof())
+         {
+            rec.getRecord(strm);
+            n++;
+         }
+         return n;
+      }
+
+      unsigned long runScanner()
+      {
+         ifstream strm(filename.c_str(), ios::in | ios::binary);
+         strm.seekg(0, ios::end);
+         vector<char> buf(strm.tellg());
+         strm.seekg(0, ios::beg);
+         strm.read(&buf[0], buf.size());
+         BinexRecordScanner scanner(&buf[0], buf.size());
+         scanner.strict = true;
+         BinexRecordView view;
+         unsigned long n(0);
+         while(scanner.next(view))
+            n++;
+         return n;
+      }
+
+      string filename;
+      bool scan;
+   };
+
+
+      /** Parse every 16-character observation field (14 character
+       * value, LLI and SSI) of the data lines of a RINEX 3 observation
+       * file, read into memory in setUp(), either from substrings
+       * or in place with the (pointer, length) StringUtils parsers.
+       * @return the number of fields parsed */
+   class FieldParseBenchmark : public Benchmark
+   {
+   public:
+      FieldParseBenchmark(const string& name, const string& file,
+                          bool inPlace)
+            : Benchmark(name, "fields"), filename(file), noCopy(inPlace),
+              sum(0)
+      {}
+
+      virtual void setUp()
+      {
+         ifstream strm(filename.c_str());
+         if(!strm)
+         {
+            Exception e("Unable to open " + filename);
+            GPSTK_THROW(e);
+         }
+         string line;
+         bool header(true);
+         lines.clear();
+         while(getline(strm, line))
+         {
+            if(header)
+               header = (line.find("END OF HEADER") == string::npos);
+            else if(line.size() > 3 && line[0] != '>')
+               lines.push_back(line);
+         }
+      }
+
+      virtual unsigned long run()
+      {
+         using namespace StringUtils;
+         unsigned long n(0);
+         for(size_t i=0; i<lines.size(); i++)
+         {
+            const string& line(lines[i]);
+            for(string::size_type pos=3; pos+14 <= line.size(); pos+=16)
+            {
+               if(noCopy)
+               {
+                  const char *field = line.data() + pos;
+                  if(!isBlank(field, 14))
+                     sum += asDouble(field, 14);
+                  if(pos+16 <= line.size())
+                     sum += asInt(field+14, 1) + asInt(field+15, 1);
+               }
+               else
+               {
+                  if(line.substr(pos, 14) != string(14, ' '))
+                     sum += asDouble(line.substr(pos, 14));
+                  if(pos+16 <= line.size())
+                     sum += asInt(line.substr(pos+14, 1)) +
+                        asInt(line.substr(pos+15, 1));
+               }
+               n++;
+            }
+         }
+         return n;
+      }
+
+      string filename;
+      bool noCopy;
+      vector<string> lines;
+      double sum;    ///< keeps the results live
+   };
+
+
+   void addFileBenchmarks(BenchmarkSuite& suite, const string& dataDir)
+   {
+      suite.add(new FileReadBenchmark<RinexObsStream, RinexObsHeader,
+                RinexObsData>("rinex2_obs_read", "epochs",
+                              dataDir + "/arlm200b.15o"));
+      suite.add(new FileReadBenchmark<Rinex3ObsStream, Rinex3ObsHeader,
+                Rinex3ObsData>("rinex3_obs_read_v2", "epochs",
+                               dataDir + "/arlm200b.15o"));
+      suite.add(new FileReadBenchmark<Rinex3ObsStream, Rinex3ObsHeader,
+                Rinex3ObsData>("rinex3_obs_read", "epochs",
+                               dataDir + "/test_input_rinex3_76193040.14o"));
+      suite.add(new FileReadBenchmark<RinexNavStream, RinexNavHeader,
+                RinexNavData>("rinex2_nav_read", "records",
+                              dataDir + "/arlm200b.15n"));
+      suite.add(new FileReadBenchmark<Rinex3NavStream, Rinex3NavHeader,
+                Rinex3NavData>("rinex3_nav_read", "records",
+                               dataDir + "/test_input_rinex3_76193040.14n"));
+      suite.add(new FileWriteBenchmark<Rinex3ObsStream, Rinex3ObsHeader,
+                Rinex3ObsData>("rinex3_obs_write", "epochs",
+                               dataDir + "/test_input_rinex3_76193040.14o"));
+      suite.add(new FileWriteBenchmark<RinexNavStream, RinexNavHeader,
+                RinexNavData>("rinex2_nav_write", "records",
+                              dataDir + "/arlm200b.15n"));
+      suite.add(new FileWriteBenchmark<SP3Stream, SP3Header,
+                SP3Data>("sp3_write", "records",
+                         dataDir + "/test_input_SP3c.sp3"));
+      suite.add(new BinexReadBenchmark("binex_read", false));
+      suite.add(new BinexReadBenchmark("binex_scan", true));
+      suite.add(new FieldParseBenchmark("rinex3_obs_fields_substr",
+                dataDir + "/test_input_rinex3_76193040.14o", false));
+      suite.add(new FieldParseBenchmark("rinex3_obs_fields",
+                dataDir + "/test_input_rinex3_76193040.14o", true));
+   }
+
+} // namespace gpstk
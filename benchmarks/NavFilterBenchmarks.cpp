@@ -0,0 +1,200 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file NavFilterBenchmarks.cpp
+/// Benchmarks of navigation message filtering.
+
+#include <fstream>
+#include "Benchmark.hpp"
+#include "NavFilterMgr.hpp"
+#include "ShardedNavFilterMgr.hpp"
+#include "LNavFilterData.hpp"
+#include "LNavParityFilter.hpp"
+#include "LNavTLMHOWFilter.hpp"
+#include "LNavCookFilter.hpp"
+#include "LNavCrossSourceFilter.hpp"
+#include "LNavOrderFilter.hpp"
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /// The filters of one LNAV chain.
+   struct LNavChain
+   {
+      LNavParityFilter parity;
+      LNavTLMHOWFilter tlmHow;
+      LNavCookFilter cook;
+      LNavCrossSourceFilter xsrc;
+      LNavOrderFilter order;
+   };
+
+
+      /** Run the LNAV subframes of test_input_NavFilterMgr.txt
+       * through the parity, TLM/HOW, cook, cross-source and order
+       * filters, as a receiver data processor would.  If nShards is
+       * 0, a NavFilterMgr is given one subframe at a time, otherwise
+       * a ShardedNavFilterMgr is given one epoch at a time. */
+   class LNavFilterBenchmark : public Benchmark
+   {
+   public:
+      LNavFilterBenchmark(const string& name, const string& file,
+                          unsigned shards)
+            : Benchmark(name, "subframes"), filename(file), nShards(shards)
+      {}
+
+      virtual void setUp()
+      {
+         ifstream inf(filename.c_str());
+         if(!inf)
+         {
+            Exception e("Could not open " + filename);
+            GPSTK_THROW(e);
+         }
+         string line;
+         CommonTime recTime;
+         while(getline(inf, line))
+         {
+            if(line.empty() || line[0] == '#')
+               continue;
+            scanTime(recTime, StringUtils::firstWord(line, ','),
+                     "%4Y %3j %02H:%02M:%04.1f");
+            for(unsigned w = 6; w <= 15; w++)
+               words.push_back(
+                  StringUtils::x2uint(StringUtils::word(line, w, ',')));
+            LNavFilterData fd;
+            fd.prn = StringUtils::asUnsigned(StringUtils::word(line, 2, ','));
+            fd.carrier = (CarrierBand)StringUtils::asInt(
+               StringUtils::word(line, 3, ','));
+            fd.code = (TrackingCode)StringUtils::asInt(
+               StringUtils::word(line, 4, ','));
+            fd.timeStamp = recTime;
+            data.push_back(fd);
+         }
+         origWords = words;
+      }
+
+      virtual unsigned long run()
+      {
+            // the cook filter uprights the subframes in place
+         std::copy(origWords.begin(), origWords.end(), words.begin());
+         for(size_t i=0; i<data.size(); i++)
+            data[i].sf = &words[i*10];
+
+         unsigned long n(nShards ? runSharded() : runSerial());
+         if(n == 0)
+         {
+            Exception e("No subframes passed the filters");
+            GPSTK_THROW(e);
+         }
+         return data.size();
+      }
+
+      unsigned long runSerial()
+      {
+         NavFilterMgr mgr;
+         LNavChain chain;
+         addChain(mgr, chain);
+         unsigned long n(0);
+         for(size_t i=0; i<data.size(); i++)
+         {
+            NavFilter::NavMsgList l(mgr.validate(&data[i]));
+            n += l.size();
+         }
+         NavFilter::NavMsgList l(mgr.finalize());
+         return n + l.size();
+      }
+
+      unsigned long runSharded()
+      {
+         ShardedNavFilterMgr mgr(nShards);
+         vector<LNavChain> chains(nShards);
+         for(unsigned s=0; s<nShards; s++)
+            addChain(mgr, s, chains[s]);
+         unsigned long n(0);
+         NavFilter::NavMsgList batch;
+         size_t i(0);
+         while(i < data.size())
+         {
+            batch.clear();
+            const CommonTime& t(data[i].timeStamp);
+            while(i < data.size() && data[i].timeStamp == t)
+               batch.push_back(&data[i++]);
+            NavFilter::NavMsgList l(mgr.validate(batch));
+            n += l.size();
+         }
+         NavFilter::NavMsgList l(mgr.finalize());
+         return n + l.size();
+      }
+
+      static void addChain(NavFilterMgr& mgr, LNavChain& chain)
+      {
+         mgr.addFilter(&chain.parity);
+         mgr.addFilter(&chain.tlmHow);
+         mgr.addFilter(&chain.cook);
+         mgr.addFilter(&chain.xsrc);
+         mgr.addFilter(&chain.order);
+      }
+
+      static void addChain(ShardedNavFilterMgr& mgr, unsigned shard,
+                           LNavChain& chain)
+      {
+         mgr.addFilter(shard, &chain.parity);
+         mgr.addFilter(shard, &chain.tlmHow);
+         mgr.addFilter(shard, &chain.cook);
+         mgr.addFilter(shard, &chain.xsrc);
+         mgr.addFilter(shard, &chain.order);
+      }
+
+      string filename;
+      unsigned nShards;
+      vector<LNavFilterData> data;
+      vector<uint32_t> words, origWords;
+   };
+
+
+   void addNavFilterBenchmarks(BenchmarkSuite& suite, const string& dataDir)
+   {
+      const string file(dataDir + "/test_input_NavFilterMgr.txt");
+      suite.add(new LNavFilterBenchmark("navfilter_lnav", file, 0));
+      suite.add(new LNavFilterBenchmark("navfilter_lnav_sharded", file, 4));
+   }
+
+} // namespace gpstk
@@ -0,0 +1,214 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file PosBenchmarks.cpp
+/// Benchmarks of the pseudorange solution and the tropospheric models.
+
+#include "Benchmark.hpp"
+#include "PRSolution.hpp"
+#include "RAIMSolver.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "TropModel.hpp"
+#include "NBTropModel.hpp"
+#include "SaasTropModel.hpp"
+#include "GGTropModel.hpp"
+#include "NeillTropModel.hpp"
+#include "GlobalTropModel.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /// Set the receiver location and day of the data files in trop
+   static void initTrop(TropModel& trop)
+   {
+      trop.setReceiverLatitude(30.4);
+      trop.setReceiverLongitude(262.2);
+      trop.setReceiverHeight(200.0);
+      trop.setDayOfYear(200);
+   }
+
+
+      /** Compute a RAIM solution at each epoch of a RINEX observation
+       * file from its C1 pseudoranges and an SP3 ephemeris, either with
+       * PRSolution::RAIMCompute() or with a RAIMSolver. When reject
+       * is true the RMS limit is made small enough that the RAIM search
+       * over subsets of satellites is done at most epochs. */
+   class RAIMBenchmark : public Benchmark
+   {
+   public:
+      RAIMBenchmark(const string& name, const string& obs, const string& sp3,
+                    int every, bool reject, RAIMSolver *pSolver)
+            : Benchmark(name, "epochs"), obsFile(obs), sp3File(sp3),
+              decimate(every), isReject(reject), solver(pSolver)
+      {}
+
+      virtual ~RAIMBenchmark()
+      { delete solver; }
+
+      virtual void setUp()
+      {
+         eph.loadFile(sp3File);
+
+         Rinex3ObsStream strm(obsFile.c_str(), ios::in);
+         Rinex3ObsHeader hdr;
+         Rinex3ObsData rod;
+         strm >> hdr;
+         const size_t ic1(hdr.getObsIndex("C1"));
+         for(int n=0; strm >> rod; n++)
+         {
+            if(n % decimate != 0)
+               continue;
+            if(rod.epochFlag != 0 && rod.epochFlag != 1)
+               continue;
+            times.push_back(rod.time);
+            sats.push_back(vector<SatID>());
+            prs.push_back(vector<double>());
+            Rinex3ObsData::DataMap::const_iterator it;
+            for(it = rod.obs.begin(); it != rod.obs.end(); ++it)
+            {
+               const double c1(it->second[ic1].data);
+               if(c1 == 0.0)
+                  continue;
+               sats.back().push_back(it->first);
+               prs.back().push_back(c1);
+            }
+         }
+         initTrop(trop);
+      }
+
+      virtual unsigned long run()
+      {
+         PRSolution sol;
+         sol.allowedGNSS.push_back(SatelliteSystem::GPS);
+         if(isReject)
+         {
+            sol.RMSLimit = 0.8;
+            sol.NSatsReject = 2;
+         }
+         Matrix<double> invMC;
+         unsigned long n(0);
+         for(size_t i=0; i<times.size(); i++)
+         {
+            vector<SatID> satsCopy(sats[i]);
+            int iret;
+            if(solver)
+               iret = solver->RAIMCompute(sol, times[i], satsCopy, prs[i],
+                                          invMC, &eph, &trop);
+            else
+               iret = sol.RAIMCompute(times[i], satsCopy, prs[i], invMC,
+                                      &eph, &trop);
+            if(iret >= 0)
+               n++;
+         }
+         return n;
+      }
+
+      string obsFile, sp3File;
+      int decimate;
+      bool isReject;
+      RAIMSolver *solver;
+      SP3EphemerisStore eph;
+      NBTropModel trop;
+      vector<CommonTime> times;
+      vector< vector<SatID> > sats;
+      vector< vector<double> > prs;
+   };
+
+
+      /// Compute the correction of a trop model over a grid of elevations.
+   class TropBenchmark : public Benchmark
+   {
+   public:
+      TropBenchmark(const string& name, TropModel *pModel)
+            : Benchmark(name, "corrections"), trop(pModel)
+      {}
+
+      virtual ~TropBenchmark()
+      { delete trop; }
+
+      virtual void setUp()
+      {
+         initTrop(*trop);
+         trop->setWeather(20.0, 1013.0, 50.0);
+      }
+
+      virtual unsigned long run()
+      {
+         unsigned long n(0);
+         double sum(0.0);
+         for(int i=0; i<8500; i++)
+         {
+            sum += trop->correction(5.0 + 0.01*i);
+            n++;
+         }
+         if(sum <= 0.0)
+         {
+            Exception e("Invalid trop model correction");
+            GPSTK_THROW(e);
+         }
+         return n;
+      }
+
+      TropModel *trop;
+   };
+
+
+   void addPosBenchmarks(BenchmarkSuite& suite, const string& dataDir)
+   {
+      const string obsFile(dataDir + "/arlm200b.15o");
+      const string sp3File(dataDir + "/test_input_sp3_nav_2015_200.sp3");
+
+      suite.add(new RAIMBenchmark("prsolution_raim", obsFile, sp3File,
+                                  1, false, 0));
+      suite.add(new RAIMBenchmark("prsolution_raim_reject", obsFile, sp3File,
+                                  10, true, 0));
+      suite.add(new RAIMBenchmark("raimsolver_raim_reject", obsFile, sp3File,
+                                  10, true, new RAIMSolver()));
+
+      suite.add(new TropBenchmark("trop_nb", new NBTropModel()));
+      suite.add(new TropBenchmark("trop_saas", new SaasTropModel()));
+      suite.add(new TropBenchmark("trop_gg", new GGTropModel()));
+      suite.add(new TropBenchmark("trop_neill", new NeillTropModel()));
+      suite.add(new TropBenchmark("trop_global", new GlobalTropModel()));
+   }
+
+} // namespace gpstk
@@ -0,0 +1,263 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file TimeBenchmarks.cpp
+/// Benchmarks of CommonTime arithmetic, conversions and formatting.
+
+#include <map>
+#include "Benchmark.hpp"
+#include "CommonTime.hpp"
+#include "CommonTimeKey.hpp"
+#include "CivilTime.hpp"
+#include "GPSWeekSecond.hpp"
+#include "MJD.hpp"
+#include "YDSTime.hpp"
+#include "TimeString.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /** Convert a sequence of CommonTimes, one every 30.5 seconds
+       * over a few days, to and from TimeTag type T. */
+   template <class T>
+   class TimeConvertBenchmark : public Benchmark
+   {
+   public:
+      TimeConvertBenchmark(const string& name)
+            : Benchmark(name, "conversions")
+      {}
+
+      virtual void setUp()
+      {
+         CommonTime t(GPSWeekSecond(1854, 0.0));
+         for(int i=0; i<10000; i++, t += 30.5)
+            times.push_back(t);
+      }
+
+      virtual unsigned long run()
+      {
+         unsigned long n(0);
+         double sum(0.0);
+         for(size_t i=0; i<times.size(); i++)
+         {
+            T tt(times[i]);
+            CommonTime ct(tt.convertToCommonTime());
+            sum += ct - times[0];
+            n++;
+         }
+         return (sum >= 0.0 ? n : 0);
+      }
+
+      vector<CommonTime> times;
+   };
+
+
+      /// CommonTime addition and comparison.
+   class TimeArithBenchmark : public Benchmark
+   {
+   public:
+      TimeArithBenchmark()
+            : Benchmark("commontime_arith", "operations")
+      {}
+
+      virtual unsigned long run()
+      {
+         CommonTime t(GPSWeekSecond(1854, 0.0)), end(t);
+         end += 86400.0;
+         unsigned long n(0);
+         double sum(0.0);
+         for(; t < end; t += 0.5)
+         {
+            sum += t - end;
+            n++;
+         }
+         return (sum < 0.0 ? n : 0);
+      }
+   };
+
+
+      /** Look up times in a std::map keyed on K, a day of 30 second
+       * epochs, as the time-indexed stores do: find() of the epochs
+       * and lower_bound() of times between them. */
+   template <class K>
+   class TimeMapBenchmark : public Benchmark
+   {
+   public:
+      TimeMapBenchmark(const string& name)
+            : Benchmark(name, "lookups")
+      {}
+
+      virtual void setUp()
+      {
+         CommonTime t(GPSWeekSecond(1854, 0.0));
+         t.setTimeSystem(TimeSystem::GPS);
+         for(int i=0; i<2880; i++, t += 30.0)
+            table[t] = i;
+         t = GPSWeekSecond(1854, 0.0);
+         t.setTimeSystem(TimeSystem::GPS);
+         for(int i=0; i<20000; i++, t += 4.32)
+            times.push_back(t);
+      }
+
+      virtual unsigned long run()
+      {
+         unsigned long n(0);
+         long sum(0);
+         for(size_t i=0; i<times.size(); i++)
+         {
+            typename map<K, int>::const_iterator it(table.find(times[i]));
+            if(it == table.end())
+               it = table.lower_bound(times[i]);
+            if(it != table.end())
+               sum += it->second;
+            n++;
+         }
+         return (sum > 0 ? n : 0);
+      }
+
+      map<K, int> table;
+      vector<CommonTime> times;
+   };
+
+
+      /** Format, and scan, a sequence of times with printTime() and
+       * scanTime(), or with a TimeFormat compiled once. */
+   class TimeStringBenchmark : public Benchmark
+   {
+   public:
+      TimeStringBenchmark(const string& name, const string& format, bool scan,
+                          bool compiled = false)
+            : Benchmark(name, scan ? "scans" : "prints"), fmt(format),
+              isScan(scan), isCompiled(compiled)
+      {}
+
+      virtual void setUp()
+      {
+         CommonTime t(GPSWeekSecond(1854, 0.0));
+         for(int i=0; i<1000; i++, t += 30.5)
+         {
+            times.push_back(t);
+            strings.push_back(printTime(t, fmt));
+         }
+      }
+
+      virtual unsigned long run()
+      {
+         unsigned long n(0);
+         if(isScan && isCompiled)
+         {
+            TimeFormat tf(fmt);
+            CommonTime t;
+            for(size_t i=0; i<strings.size(); i++)
+            {
+               tf.scan(t, strings[i]);
+               n++;
+            }
+         }
+         else if(isScan)
+         {
+            CommonTime t;
+            for(size_t i=0; i<strings.size(); i++)
+            {
+               scanTime(t, strings[i], fmt);
+               n++;
+            }
+         }
+         else if(isCompiled)
+         {
+            TimeFormat tf(fmt);
+            char buf[128];
+            size_t len(0);
+            for(size_t i=0; i<times.size(); i++)
+            {
+               len += tf.print(times[i], buf, sizeof(buf));
+               n++;
+            }
+            if(len == 0)
+               n = 0;
+         }
+         else
+         {
+            size_t len(0);
+            for(size_t i=0; i<times.size(); i++)
+            {
+               len += printTime(times[i], fmt).size();
+               n++;
+            }
+            if(len == 0)
+               n = 0;
+         }
+         return n;
+      }
+
+      string fmt;
+      bool isScan;
+      bool isCompiled;
+      vector<CommonTime> times;
+      vector<string> strings;
+   };
+
+
+   void addTimeBenchmarks(BenchmarkSuite& suite, const string& dataDir)
+   {
+      suite.add(new TimeArithBenchmark());
+      suite.add(new TimeMapBenchmark<CommonTime>("time_map_commontime"));
+      suite.add(new TimeMapBenchmark<CommonTimeKey>("time_map_key"));
+      suite.add(new TimeConvertBenchmark<CivilTime>("time_civil"));
+      suite.add(new TimeConvertBenchmark<GPSWeekSecond>("time_gpsweeksecond"));
+      suite.add(new TimeConvertBenchmark<MJD>("time_mjd"));
+      suite.add(new TimeConvertBenchmark<YDSTime>("time_yds"));
+
+      const string civil("%04Y/%02m/%02d %02H:%02M:%06.3f %P");
+      const string gps("%4F %10.3g");
+      suite.add(new TimeStringBenchmark("printtime_civil", civil, false));
+      suite.add(new TimeStringBenchmark("printtime_civil_compiled", civil,
+                                        false, true));
+      suite.add(new TimeStringBenchmark("scantime_civil", civil, true));
+      suite.add(new TimeStringBenchmark("scantime_civil_compiled", civil,
+                                        true, true));
+      suite.add(new TimeStringBenchmark("printtime_gps", gps, false));
+      suite.add(new TimeStringBenchmark("printtime_gps_compiled", gps,
+                                        false, true));
+      suite.add(new TimeStringBenchmark("scantime_gps", gps, true));
+      suite.add(new TimeStringBenchmark("scantime_gps_compiled", gps,
+                                        true, true));
+   }
+
+} // namespace gpstk
@@ -0,0 +1,169 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file gpstkBenchmarks.cpp
+/// Run the GPSTk benchmarks and report the timings, optionally as JSON.
+
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include "BasicFramework.hpp"
+#include "Benchmark.hpp"
+#include "build_config.h"
+
+using namespace std;
+using namespace gpstk;
+
+class GPSTkBenchmarks : public BasicFramework
+{
+public:
+   GPSTkBenchmarks(char* arg0);
+
+protected:
+   virtual void process();
+
+private:
+   CommandOptionWithAnyArg dataDirOption;
+   CommandOptionWithAnyArg jsonOption;
+   CommandOptionWithAnyArg filterOption;
+   CommandOptionWithNumberArg minTimeOption;
+   CommandOptionWithNumberArg minIterOption;
+   CommandOptionNoArg listOption;
+};
+
+
+GPSTkBenchmarks::GPSTkBenchmarks(char* arg0)
+      : BasicFramework(arg0, "Time the hot paths of the GPSTk: file reading,"
+                       " ephemeris evaluation, position solution, time"
+                       " conversion and code generation."),
+        dataDirOption('D', "data", "Directory of input files (default: the"
+                      " data directory of the source tree)"),
+        jsonOption('j', "json", "Write the results as JSON to this file"),
+        filterOption('f', "filter", "Run only benchmarks whose name contains"
+                     " this string"),
+        minTimeOption('t', "min-time", "Minimum seconds to time each benchmark"
+                      " (default 1)"),
+        minIterOption('n', "min-iter", "Minimum timed iterations of each"
+                      " benchmark (default 3)"),
+        listOption('l', "list", "List the benchmarks and exit")
+{
+   dataDirOption.setMaxCount(1);
+   jsonOption.setMaxCount(1);
+   filterOption.setMaxCount(1);
+   minTimeOption.setMaxCount(1);
+   minIterOption.setMaxCount(1);
+}
+
+
+void GPSTkBenchmarks::process()
+{
+   string dataDir(getPathData());
+   if(dataDirOption.getCount())
+      dataDir = dataDirOption.getValue()[0];
+
+   BenchmarkSuite suite;
+   if(minTimeOption.getCount())
+      suite.minTime = atof(minTimeOption.getValue()[0].c_str());
+   if(minIterOption.getCount())
+      suite.minIterations = atol(minIterOption.getValue()[0].c_str());
+
+   addFileBenchmarks(suite, dataDir);
+   addEphBenchmarks(suite, dataDir);
+   addPosBenchmarks(suite, dataDir);
+   addTimeBenchmarks(suite, dataDir);
+   addNavFilterBenchmarks(suite, dataDir);
+#ifdef GPSTK_BENCHMARK_EXT
+   addCodeGenBenchmarks(suite, dataDir);
+#endif
+
+   if(listOption.getCount())
+   {
+      const vector<Benchmark*>& list(suite.getBenchmarks());
+      for(size_t i=0; i<list.size(); i++)
+         cout << list[i]->name << " (" << list[i]->unit << ")" << endl;
+      return;
+   }
+
+   string filter;
+   if(filterOption.getCount())
+      filter = filterOption.getValue()[0];
+
+   vector<BenchmarkResult> results(suite.run(filter, &cout));
+
+   if(jsonOption.getCount())
+   {
+      ofstream ofs(jsonOption.getValue()[0].c_str());
+      if(!ofs)
+      {
+         cerr << "Unable to open " << jsonOption.getValue()[0] << endl;
+         exitCode = EXIST_ERROR;
+         return;
+      }
+      BenchmarkSuite::writeJSON(ofs, results, dataDir);
+   }
+
+   for(size_t i=0; i<results.size(); i++)
+      if(!results[i].error.empty())
+         exitCode = EXCEPTION_ERROR;
+}
+
+
+int main(int argc, char* argv[])
+{
+   try
+   {
+      GPSTkBenchmarks app(argv[0]);
+      if (!app.initialize(argc, argv))
+         return app.exitCode;
+      app.run();
+      return app.exitCode;
+   }
+   catch(Exception& e)
+   {
+      cout << e << endl;
+   }
+   catch(exception& e)
+   {
+      cout << e.what() << endl;
+   }
+   catch(...)
+   {
+      cout << "unknown error" << endl;
+   }
+   return gpstk::BasicFramework::EXCEPTION_ERROR;
+}
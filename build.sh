@@ -72,6 +72,8 @@ OPTIONS:
 
    -n                   Do not use address sanitizer for debug build (used by default)
 
+   -r                   Use thread sanitizer instead of address sanitizer.
+
    -P  <python_exe>     Python executable used to help determine with python system libraries
                         will be used when building python extension package.
                         Default=$python_exe
@@ -81,6 +83,8 @@ OPTIONS:
 
    -g                   Compile code with gcov instrumenation enabled.
 
+   -m                   Build the benchmark program gpstkBenchmarks.
+
    -p                   Build supported packages (source, binary, deb,  ...)
 
    -v                   Include debugging output.
@@ -88,7 +92,7 @@ EOF
 }
 
 
-while getopts "hb:cdepi:j:xnP:sutTgv" OPTION; do
+while getopts "hb:cdepi:j:xnrP:sutTgmv" OPTION; do
     case $OPTION in
         h) usage
            exit 0
@@ -114,6 +118,8 @@ while getopts "hb:cdepi:j:xnP:sutTgv" OPTION; do
            ;;
         n) no_address_sanitizer=1
            ;;
+        r) thread_sanitizer=1
+           ;;
         P) python_exe=$OPTARG
            ;;
         u) install=1
@@ -131,6 +137,8 @@ while getopts "hb:cdepi:j:xnP:sutTgv" OPTION; do
            ;;
         g) coverage_switch=1
            ;;
+        m) build_benchmarks=1
+           ;;
         v) verbose+=1
            ;;
         *) echo "Invalid option: -$OPTARG" >&2
@@ -171,6 +179,7 @@ if ((verbose>0)); then
     log "python_install       = $python_install"
     log "python_exe           = $python_exe"
     log "no_address_sanitizer = $(ptof $no_address_sanitizer)"
+    log "thread_sanitizer     = $(ptof $thread_sanitizer)"
     log "build_docs           = $(ptof $build_docs)"
     log "build_packages       = $(ptof $build_packages)"
     log "test_switch          = $(ptof $test_switch)"
@@ -235,12 +244,14 @@ args+=${verbose:+" -DDEBUG_SWITCH=ON"}
 args+=${user_install:+" -DPYTHON_USER_INSTALL=ON"}
 args+=${test_switch:+" -DTEST_SWITCH=ON"}
 args+=${coverage_switch:+" -DCOVERAGE_SWITCH=ON"}
+args+=${build_benchmarks:+" -DBUILD_BENCHMARKS=ON"}
 args+=${build_docs:+" --graphviz=$build_root/doc/graphviz/gpstk_graphviz.dot"}
-if [ $no_address_sanitizer ]; then
+if [ $no_address_sanitizer ] || [ $thread_sanitizer ]; then
     args+=" -DADDRESS_SANITIZER=OFF"
 else
     args+=" -DADDRESS_SANITIZER=ON"
 fi
+args+=${thread_sanitizer:+" -DTHREAD_SANITIZER=ON"}
 
 case `uname` in
     MINGW32_NT-6.1)
@@ -1694,6 +1694,9 @@ try {
          continue;
       }
 
+      // the time tag starts every output line; parse its format once
+      TimeFormat userTimeFmt(C.userfmt);
+
       // loop over epochs ---------------------------------------------
       while(1) {
          try { istrm >> Rdata; }
@@ -1746,7 +1749,7 @@ try {
          }
 
          // prepare start of output line
-         string line(printTime(Rdata.time,C.userfmt));
+         string line(userTimeFmt.print(Rdata.time));
 
          // if aux header data, either output or skip
          if(Rdata.epochFlag > 1) {
@@ -47,6 +47,10 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 // GPSTK
 #include "Exception.hpp"
@@ -105,6 +109,8 @@
 #include "HelmertTransform.hpp"
 
 #include "PRSolution.hpp"
+#include "RAIMSolver.hpp"
+#include "WorkerPool.hpp"
 
 //------------------------------------------------------------------------------------
 using namespace std;
@@ -128,6 +134,7 @@ public:
    virtual ~Configuration()
    {
       delete pTrop;
+      delete pRAIM;
    }
 
    // Create, parse and process command line options and user input
@@ -181,6 +188,8 @@ public:
    CommonTime beginTime,endTime,gpsBeginTime,decTime;
 
    double decimate;           // decimate input data
+   int workers;               // number of threads computing satellite geometry
+   int RAIMthreads;           // threads in RAIMSolver, 0 for PRSolution RAIM
    double elevLimit;          // limit sats to elevation mask
    bool forceElev;            // use elevLimit even without --ref
    bool searchUser;           // use SearchUser() for BCE, else SearchNear()
@@ -228,6 +237,7 @@ public:
 
    // trop models
    TropModel *pTrop;          // to pass to PRS
+   RAIMSolver *pRAIM;         // if not NULL, computes RAIM for PRS
    string TropType;           // key ~ Black, NewB, etc; use to identify model
    bool TropPos,TropTime;     // true when trop model has been init with Pos,time
                               // default weather
@@ -451,6 +461,22 @@ public:
 
 }; // end class SolutionData
 
+//------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+// The output of PRSolution::PreparePRSolution() for one SolutionObject and one epoch,
+// computed in a worker thread when epochs are pipelined (--workers); see
+// ProcessFiles(). Passed to SolutionObject::ComputeSolution(), which then avoids the
+// ephemeris computations, and gives the same result.
+class PreparedSolution {
+public:
+   PreparedSolution() throw() : isValid(false), NSVS(0) { }
+
+   bool isValid;                 // false unless PreparePRSolution() was called
+   vector<SatID> Satellites;     // sats, marked by PreparePRSolution()
+   Matrix<double> SVP;           // sat positions and corrected ranges
+   int NSVS;                     // return value of PreparePRSolution()
+};
+
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 // Object to encapsulate everything for one solution (system:freq:code[+s:f:c])
@@ -525,9 +551,16 @@ public:
 
       /** Compute a solution for the given epoch; call after
        * CollectData() same return value as RAIMCompute()
+       * @param pPrep if not NULL, the output of PreparePRSolution for this
+       *   epoch and these Satellites, computed by another thread
        * @throw Exception
        */
-   int ComputeSolution(const CommonTime& t);
+   int ComputeSolution(const CommonTime& t, const PreparedSolution *pPrep=NULL);
+
+   // Call PreparePRSolution() for the data collected by CollectData() and save
+   // the result in prep, for a later call to ComputeSolution(); used by the
+   // worker threads on their own copy of this object.
+   void PrepareSolution(const CommonTime& t, PreparedSolution& prep) throw();
 
       /** Write out ORDs - call after ComputeSolution pass it iret
        * from ComputeSolution
@@ -578,6 +611,88 @@ public:
 
 }; // end class SolutionObject
 
+//------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+// The elevation and corrected ephemeris range of one satellite at one epoch,
+// computed from the ephemeris by SatelliteGeometry().
+class EpochSat {
+public:
+   EpochSat() throw() : status(0), elev(0.0) { }
+
+   RinexSatID sat;               // satellite
+   int status;                   // 1 computed, 0 not needed, -1 failed to compute
+   double elev;                  // elevation angle (deg)
+   double rawrange;              // from CorrectedEphemerisRange
+   double svclkbias;             // ditto
+   double relativity;            // ditto
+   Triple svPos;                 // ditto - satellite position
+};
+
+//------------------------------------------------------------------------------------
+// One epoch of data as it passes through the EpochPipeline.
+class EpochData {
+public:
+   EpochData() throw() : status(0), hasGeometry(false), done(false) { }
+
+   int status;                   // return value of ReadEpoch() (-1 for exception)
+   string errmsg;                // text of the read exception (status 3)
+   Exception except;             // exception thrown in another thread (status -1)
+   Rinex3ObsData Rdata;          // the data, DCB corrected if hasGeometry
+   bool hasGeometry;             // true when sats and prep have been computed
+   vector<EpochSat> sats;        // satellites that pass editing, in Rdata order
+   vector<PreparedSolution> prep;// parallel to C.SolObjs
+   bool done;                    // true when ready for output
+};
+
+//------------------------------------------------------------------------------------
+// Process the epochs of one RINEX obs file in a pipeline, when --workers > 1. A
+// reader thread reads and edits the data (ReadEpoch()), worker threads compute the
+// satellite geometry and call PreparePRSolution() (PrepareEpoch()), and the calling
+// thread takes the epochs from next() in the order they were read, to compute the
+// solutions and write output, exactly as in serial processing. The solutions
+// themselves are not computed in parallel: PRSolution uses the previous solution as
+// the apriori and accumulates statistics, and the trop model is updated between
+// epochs. Only the RAIM search within one epoch is divided among threads, by
+// RAIMSolver (--RAIMthreads). Without a call to start(), next() simply reads the
+// next epoch.
+class EpochPipeline {
+public:
+   // Constructor, given the open stream and its header, and the DCB information
+   EpochPipeline(Rinex3ObsStream& istrm, const Rinex3ObsHeader& Rhead,
+                 const bool& DCBcorr, const map<string,int>& mapDCBindex,
+                 const Position& PrevPos) throw();
+
+   // Destructor stops and joins the threads
+   ~EpochPipeline() throw();
+
+   // Start the reader and n worker threads
+   void start(const int& n);
+
+   // Return the next epoch, in the order read; the caller must delete it.
+   // Status of the epoch is that of ReadEpoch(), or -1 if an exception was thrown.
+   EpochData *next(void);
+
+private:
+   void Reader(void) throw();
+   void Worker(const size_t n) throw();
+
+   Rinex3ObsStream& istrm;
+   const Rinex3ObsHeader& Rhead;
+   const bool DCBcorr;
+   const map<string,int>& mapDCBindex;
+   const Position& PrevPos;
+
+   vector<vector<SolutionObject> > workerSolObjs;  // a copy for each worker
+   std::unique_ptr<WorkerPool> pool;   // thread 1 is the reader, the rest workers
+   std::mutex mutex;
+   std::condition_variable cond;
+   deque<EpochData*> inorder;    // epochs in the order read, waiting for next()
+   deque<EpochData*> todo;       // epochs waiting for a worker
+   size_t capacity;              // maximum size of inorder
+   bool readDone;                // true when the reader is finished
+   bool abort;                   // true when the threads must stop
+};
+
 //------------------------------------------------------------------------------------
 // prototypes
 /**
@@ -586,6 +701,25 @@ int Initialize(string& errors);
 /**
  * @throw Exception */
 int ProcessFiles(void);
+/**
+ * @throw Exception */
+int ReadEpoch(Rinex3ObsStream& istrm, Rinex3ObsData& Rdata, string& errmsg);
+bool SatelliteGeometry(const CommonTime& time, const RinexSatID& sat,
+                       vector<RinexDatum>& vrdata, const Rinex3ObsHeader& Rhead,
+                       const bool& DCBcorr, const map<string,int>& mapDCBindex,
+                       const Position& PrevPos, EpochSat& es);
+void CollectSatellite(const CommonTime& time, const EpochSat& es,
+                      const vector<RinexDatum>& vrdata, const Position& PrevPos);
+/**
+ * @throw Exception */
+void PrepareEpoch(EpochData& ed, vector<SolutionObject>& solobjs,
+                  const Rinex3ObsHeader& Rhead, const bool& DCBcorr,
+                  const map<string,int>& mapDCBindex, const Position& PrevPos);
+/**
+ * @throw Exception */
+void ProcessEpoch(Rinex3ObsData& Rdata, Rinex3ObsHeader& Rhead,
+                  const vector<PreparedSolution>& prep, const bool& firstepoch,
+                  Rinex3ObsStream& ostrm);
 
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
@@ -1244,7 +1378,6 @@ try {
    for(nfiles=0,nfile=0; nfile<C.InputObsFiles.size(); nfile++) {
       Rinex3ObsStream istrm;
       Rinex3ObsHeader Rhead, Rheadout;
-      Rinex3ObsData Rdata;
       string filename(C.InputObsFiles[nfile]);
 
       if (C.PisY)
@@ -1369,239 +1502,525 @@ try {
       }
 
       // loop over epochs ---------------------------------------------
-      while(1) {
-         try { istrm >> Rdata; }
-         catch(Exception& e) {
-            LOG(WARNING) << " Warning : Failed to read obs data (Exception "
-               << e.getText(0) << "); dump follows.";
-            Rdata.dump(LOGstrm,Rhead);
-            istrm.close();
-            iret = 3;
-            break;
-         }
-         catch(std::exception& e) {
-            Exception ge(string("Std excep: ") + e.what());
-            GPSTK_THROW(ge);
-         }
-         catch(...) {
-            Exception ue("Unknown exception while reading RINEX data.");
-            GPSTK_THROW(ue);
-         }
+      {
+         // with --workers, read and compute geometry in other threads
+         EpochPipeline pipeline(istrm, Rhead, DCBcorr, mapDCBindex, PrevPos);
+         if(C.workers > 1 && C.debug < 0)
+            pipeline.start(C.workers);
 
-         // normal EOF
-         if(!istrm.good() || istrm.eof()) { iret = 0; break; }
+         while(1) {
+            EpochData *ped(pipeline.next());
+            try {
+               // exception in another thread
+               if(ped->status == -1) GPSTK_RETHROW(ped->except);
+
+               if(ped->status == 3) {
+                  LOG(WARNING) << " Warning : Failed to read obs data (Exception "
+                     << ped->errmsg << "); dump follows.";
+                  ped->Rdata.dump(LOGstrm,Rhead);
+                  iret = 3;
+               }
 
-         // if aux header data, or no data, skip it
-         if(Rdata.epochFlag > 1 || Rdata.obs.empty()) {
-            LOG(DEBUG) << " RINEX Data is aux header or empty.";
-            continue;
-         }
+               // normal EOF, or end time
+               else if(ped->status == 2) iret = 0;
 
-         LOG(DEBUG) << "\n Read RINEX data: flag " << Rdata.epochFlag
-            << ", timetag " << printTime(Rdata.time,C.longfmt);
+               else {
+                  Rinex3ObsData& Rdata(ped->Rdata);
 
-         // stay within time limits
-         if(Rdata.time < C.beginTime) {
-            LOG(DEBUG) << " RINEX data timetag " << printTime(C.beginTime,C.longfmt)
-               << " is before begin time.";
-            continue;
-         }
-         if(Rdata.time > C.endTime) {
-            LOG(DEBUG) << " RINEX data timetag " << printTime(C.endTime,C.longfmt)
-               << " is after end time.";
-            break;
-         }
+                  // reset solution objects for this epoch
+                  for(i=0; i<C.SolObjs.size(); ++i)
+                     C.SolObjs[i].EpochReset();
 
-         // decimate
-         if(C.decimate > 0.0) {
-            double dt(::fabs(Rdata.time - C.decTime));
-            dt -= C.decimate * long(0.5 + dt/C.decimate);
-            if(::fabs(dt) > 0.25) {
-               LOG(DEBUG) << " Decimation rejects RINEX data timetag "
-                  << printTime(Rdata.time,C.longfmt);
-               continue;
-            }
-         }
+                  // loop over satellites -----------------------------
+                  if(ped->hasGeometry) {
+                     for(i=0; i<ped->sats.size(); i++)
+                        CollectSatellite(Rdata.time, ped->sats[i],
+                                         Rdata.obs[ped->sats[i].sat], PrevPos);
+                  }
+                  else {
+                     Rinex3ObsData::DataMap::iterator it;
+                     for(it=Rdata.obs.begin(); it!=Rdata.obs.end(); ++it) {
+                        EpochSat es;
+                        if(SatelliteGeometry(Rdata.time, it->first, it->second,
+                                       Rhead, DCBcorr, mapDCBindex, PrevPos, es))
+                           CollectSatellite(Rdata.time, es, it->second, PrevPos);
+                     }
+                  }
 
-         // reset solution objects for this epoch
-         for(i=0; i<C.SolObjs.size(); ++i)
-            C.SolObjs[i].EpochReset();
+                  // compute the solutions and write output
+                  ProcessEpoch(Rdata, Rhead, ped->prep, firstepoch, ostrm);
 
-         // loop over satellites -----------------------------
-         RinexSatID sat;
-         Rinex3ObsData::DataMap::iterator it;
-         for(it=Rdata.obs.begin(); it!=Rdata.obs.end(); ++it) {
-            sat = it->first;
-            vector<RinexDatum>& vrdata(it->second);
-            string sys(asString(sat.systemChar()));
-
-            // is this system excluded?
-            if(find(C.allSystemChars.begin(),C.allSystemChars.end(),sys)
-                  == C.allSystemChars.end())
-            {
-               LOG(DEBUG) << " Sat " << sat << " : system " << sys
-                  << " is not needed.";
-               continue;
+                  firstepoch = false;
+               }
             }
+            catch(Exception& e) { delete ped; GPSTK_RETHROW(e); }
 
-            // has user excluded this satellite?
-            if(find(C.exclSat.begin(),C.exclSat.end(),sat) != C.exclSat.end()) {
-               LOG(DEBUG) << " Sat " << sat << " is excluded.";
-               continue;
-            }
+            k = ped->status;
+            delete ped;
+            if(k != 0) break;
 
-            // correct for DCB
-            if(DCBcorr && mapDCBindex.find(sys) != mapDCBindex.end()) {
-               i = mapDCBindex[sys];
-               if(C.P1C1bias.find(sat) != C.P1C1bias.end()) {
-                  LOG(DEBUG) << "Correct data " << asString(Rhead.mapObsTypes[sys][i])
-                     << " = " << fixed << setprecision(2) << vrdata[i].data
-                     << " for DCB with " << C.P1C1bias[sat];
-                  vrdata[i].data += C.P1C1bias[sat];
-               }
-            }
+         }  // end while loop over epochs
+      }
 
-            // elevation mask, azimuth and ephemeris range corrected with trop
-            // - pass elev to CollectData for m-cov matrix and ORDs
-            double elev(0), ER(0), tcorr;
-            if((C.elevLimit > 0 || C.weight || C.ORDout)
-                              && PrevPos.getCoordinateSystem() != Position::Unknown) {
-               CorrectedEphemerisRange CER;
-               try {
-                  CER.ComputeAtReceiveTime(Rdata.time, PrevPos, sat, *C.pEph);
-                  elev = CER.elevation;
-                  // const double azim = CER.azimuth;
-                  if(C.ORDout) {
-                     tcorr = C.pTrop->correction(PrevPos,CER.svPosVel.x,Rdata.time);
-                     ER = CER.rawrange - CER.svclkbias - CER.relativity + tcorr;
-                  }
-                  if(elev < C.elevLimit) {         // TD add elev mask [azim]
-                     LOG(VERBOSE) << " Reject sat " << sat << " for elevation "
-                        << fixed << setprecision(2) << elev << " at time "
-                        << printTime(Rdata.time,C.longfmt);
-                     continue;
-                  }
-               }
-               catch(Exception& e) {
-                  LOG(WARNING) << "WARNING : Failed to get elevation for sat "
-                     << sat << " at time " << printTime(Rdata.time,C.longfmt);
-                  continue;
-               }
-            }
+      istrm.close();
 
-            // pick out data for each solution object
-            for(i=0; i<C.SolObjs.size(); ++i)
-               C.SolObjs[i].CollectData(sat,elev,ER,vrdata);
+      // failure due to critical error
+      if(iret < 0) break;
 
-         }  // end loop over satellites
+      if(iret == 0) nfiles++;
 
-         // debug: dump the RINEX data object
-         if(C.debug > -1) Rdata.dump(LOGstrm,Rhead);
+   }  // end loop over files
 
-         // update the trop model's weather ------------------
-         if(C.MetStore.size() > 0) C.setWeather(Rdata.time);
+   if(!C.OutputObsFile.empty()) ostrm.close();
 
-         // put a blank line here for readability
-         LOG(INFO) << "";
+   if(iret < 0) return iret;
 
-         // compute the solution(s) --------------------------
-         // tag for DAT - required for PRSplot
-         C.msg = printTime(Rdata.time,"DAT "+C.gpsfmt);
+   return nfiles;
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}  // end ProcessFiles()
 
-         // compute and print the solution(s) ----------------
-         for(i=0; i<C.SolObjs.size(); ++i) {
-            // skip invalid descriptors
-            if(!C.SolObjs[i].isValid) continue;
+//------------------------------------------------------------------------------------
+// Read the next epoch of data and apply the time limits and decimation.
+// Return 0 if the data is to be processed, 1 if it is to be skipped, 2 at EOF or
+// after the end time, and 3 if the read failed (errmsg is the exception text).
+int ReadEpoch(Rinex3ObsStream& istrm, Rinex3ObsData& Rdata, string& errmsg)
+{
+   Configuration& C(Configuration::Instance());
 
-            // dump the "DAT" record
-            if(firstepoch)
-               LOG(VERBOSE) << C.SolObjs[i].dump(-1, "RPF", "DAT");
-            LOG(INFO) << C.SolObjs[i].dump((C.debug > -1 ? 2:1), "RPF", C.msg);
+   try { istrm >> Rdata; }
+   catch(Exception& e) {
+      errmsg = e.getText(0);
+      return 3;
+   }
+   catch(std::exception& e) {
+      Exception ge(string("Std excep: ") + e.what());
+      GPSTK_THROW(ge);
+   }
+   catch(...) {
+      Exception ue("Unknown exception while reading RINEX data.");
+      GPSTK_THROW(ue);
+   }
 
-            // compute the solution
-            if(firstepoch) LOG(VERBOSE) << C.SolObjs[i].prs.outputString(
-                        string("RPF ")+C.SolObjs[i].Descriptor,-999);
-            if(firstepoch) LOG(VERBOSE) << C.SolObjs[i].prs.outputPOSString(
-                        string("RPR ")+C.SolObjs[i].Descriptor,-999);
-            if(firstepoch) LOG(VERBOSE) << C.SolObjs[i].prs.outputPOSString(
-                        string("RNE ")+C.SolObjs[i].Descriptor,-999);
-            j = C.SolObjs[i].ComputeSolution(Rdata.time);
+   // normal EOF
+   if(!istrm.good() || istrm.eof()) return 2;
 
-            // write ORDs, even if solution is not good
-            if(C.ORDout) C.SolObjs[i].WriteORDs(Rdata.time,j);
-         }
+   // if aux header data, or no data, skip it
+   if(Rdata.epochFlag > 1 || Rdata.obs.empty()) {
+      LOG(DEBUG) << " RINEX Data is aux header or empty.";
+      return 1;
+   }
 
-         // write to output RINEX ----------------------------
-         if(!C.OutputObsFile.empty()) {
-            Rinex3ObsData auxData;
-            auxData.time = Rdata.time;
-            auxData.clockOffset = Rdata.clockOffset;
-            auxData.epochFlag = 4;
-            ostringstream oss;
-            // loop over valid descriptors
-            for(k=0,i=0; i<C.SolObjs.size(); ++i) if(C.SolObjs[i].isValid) {
-               if(!C.SolObjs[i].prs.isValid())
-               {
-                  LOG(ERROR) << "Invalid soution!";
-                  break;
-               }
-               oss.str("");
-               oss << "XYZ" << fixed << setprecision(3)
-                  << " " << setw(12) << C.SolObjs[i].prs.Solution(0)
-                  << " " << setw(12) << C.SolObjs[i].prs.Solution(1)
-                  << " " << setw(12) << C.SolObjs[i].prs.Solution(2);
-               oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
-               auxData.auxHeader.commentList.push_back(oss.str());
-               k++;
-               oss.str("");
-               oss << "CLK" << fixed << setprecision(3);
-
-               for(j=0; j<C.SolObjs[i].prs.dataGNSS.size(); j++) {
-                  RinexSatID sat(1,C.SolObjs[i].prs.dataGNSS[j]);
-                  oss << " " << sat.systemString3()
-                     << " " << setw(11) << C.SolObjs[i].prs.Solution(3+j);
-               }
-               oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
-               auxData.auxHeader.commentList.push_back(oss.str());
-               k++;
-               oss.str("");
-               oss << "DIA" << setw(2) << C.SolObjs[i].prs.Nsvs
-                  << fixed << setprecision(2)
-                  << " " << setw(4) << C.SolObjs[i].prs.PDOP
-                  << " " << setw(4) << C.SolObjs[i].prs.GDOP
-                  << " " << setw(8) << C.SolObjs[i].prs.RMSResidual
-                  << " " << C.SolObjs[i].Descriptor;     // may get truncated
-               auxData.auxHeader.commentList.push_back(oss.str());
-               k++;
-            }
-            auxData.numSVs = k;            // number of lines to write
-            auxData.auxHeader.valid |= Rinex3ObsHeader::validComment;
-            ostrm << auxData;
+   LOG(DEBUG) << "\n Read RINEX data: flag " << Rdata.epochFlag
+      << ", timetag " << printTime(Rdata.time,C.longfmt);
+
+   // stay within time limits
+   if(Rdata.time < C.beginTime) {
+      LOG(DEBUG) << " RINEX data timetag " << printTime(C.beginTime,C.longfmt)
+         << " is before begin time.";
+      return 1;
+   }
+   if(Rdata.time > C.endTime) {
+      LOG(DEBUG) << " RINEX data timetag " << printTime(C.endTime,C.longfmt)
+         << " is after end time.";
+      return 2;
+   }
+
+   // decimate
+   if(C.decimate > 0.0) {
+      double dt(::fabs(Rdata.time - C.decTime));
+      dt -= C.decimate * long(0.5 + dt/C.decimate);
+      if(::fabs(dt) > 0.25) {
+         LOG(DEBUG) << " Decimation rejects RINEX data timetag "
+            << printTime(Rdata.time,C.longfmt);
+         return 1;
+      }
+   }
+
+   return 0;
+}  // end ReadEpoch()
+
+//------------------------------------------------------------------------------------
+// Apply the system and satellite exclusions and the DCB correction to the data of
+// one satellite, and compute its elevation and ephemeris range at PrevPos, if they
+// are needed. Uses only the ephemeris and const members of Configuration, so it may
+// be called by the worker threads. Return false if the satellite is excluded.
+bool SatelliteGeometry(const CommonTime& time, const RinexSatID& sat,
+                       vector<RinexDatum>& vrdata, const Rinex3ObsHeader& Rhead,
+                       const bool& DCBcorr, const map<string,int>& mapDCBindex,
+                       const Position& PrevPos, EpochSat& es)
+{
+   Configuration& C(Configuration::Instance());
+   string sys(asString(sat.systemChar()));
+
+   // is this system excluded?
+   if(find(C.allSystemChars.begin(),C.allSystemChars.end(),sys)
+         == C.allSystemChars.end())
+   {
+      LOG(DEBUG) << " Sat " << sat << " : system " << sys
+         << " is not needed.";
+      return false;
+   }
+
+   // has user excluded this satellite?
+   if(find(C.exclSat.begin(),C.exclSat.end(),sat) != C.exclSat.end()) {
+      LOG(DEBUG) << " Sat " << sat << " is excluded.";
+      return false;
+   }
+
+   // correct for DCB
+   map<string,int>::const_iterator iit(mapDCBindex.find(sys));
+   if(DCBcorr && iit != mapDCBindex.end()) {
+      map<RinexSatID,double>::const_iterator bit(C.P1C1bias.find(sat));
+      if(bit != C.P1C1bias.end()) {
+         const int i(iit->second);
+         LOG(DEBUG) << "Correct data "
+            << asString(Rhead.mapObsTypes.find(sys)->second[i])
+            << " = " << fixed << setprecision(2) << vrdata[i].data
+            << " for DCB with " << bit->second;
+         vrdata[i].data += bit->second;
+      }
+   }
+
+   // elevation mask, azimuth and ephemeris range
+   // - pass elev to CollectData for m-cov matrix and ORDs
+   es.sat = sat;
+   if((C.elevLimit > 0 || C.weight || C.ORDout)
+                     && PrevPos.getCoordinateSystem() != Position::Unknown) {
+      CorrectedEphemerisRange CER;
+      try {
+         CER.ComputeAtReceiveTime(time, PrevPos, sat, *C.pEph);
+         es.elev = CER.elevation;
+         es.rawrange = CER.rawrange;
+         es.svclkbias = CER.svclkbias;
+         es.relativity = CER.relativity;
+         es.svPos = CER.svPosVel.x;
+         es.status = 1;
+      }
+      catch(Exception& e) { es.status = -1; }
+   }
+
+   return true;
+}  // end SatelliteGeometry()
+
+//------------------------------------------------------------------------------------
+// Given the output of SatelliteGeometry(), correct the ephemeris range for trop,
+// apply the elevation mask and give the data to the solution objects. Must be
+// called for the satellites in order, since the trop model is not const.
+void CollectSatellite(const CommonTime& time, const EpochSat& es,
+                      const vector<RinexDatum>& vrdata, const Position& PrevPos)
+{
+   Configuration& C(Configuration::Instance());
+   bool failed(es.status == -1);
+   double ER(0), tcorr;
 
-            ostrm << Rdata;
+   if(es.status == 1) {
+      try {
+         if(C.ORDout) {
+            tcorr = C.pTrop->correction(PrevPos,es.svPos,time);
+            ER = es.rawrange - es.svclkbias - es.relativity + tcorr;
          }
+         if(es.elev < C.elevLimit) {         // TD add elev mask [azim]
+            LOG(VERBOSE) << " Reject sat " << es.sat << " for elevation "
+               << fixed << setprecision(2) << es.elev << " at time "
+               << printTime(time,C.longfmt);
+            return;
+         }
+      }
+      catch(Exception& e) { failed = true; }
+   }
 
-         firstepoch = false;
+   if(failed) {
+      LOG(WARNING) << "WARNING : Failed to get elevation for sat "
+         << es.sat << " at time " << printTime(time,C.longfmt);
+      return;
+   }
 
-      }  // end while loop over epochs
+   // pick out data for each solution object
+   for(size_t i=0; i<C.SolObjs.size(); ++i)
+      C.SolObjs[i].CollectData(es.sat,es.elev,ER,vrdata);
 
-      istrm.close();
+}  // end CollectSatellite()
 
-      // failure due to critical error
-      if(iret < 0) break;
+//------------------------------------------------------------------------------------
+// Worker thread part of the EpochPipeline: compute the satellite geometry for one
+// epoch, collect the data into solobjs, a copy of C.SolObjs belonging to this
+// thread, and call PreparePRSolution() for each solution.
+void PrepareEpoch(EpochData& ed, vector<SolutionObject>& solobjs,
+                  const Rinex3ObsHeader& Rhead, const bool& DCBcorr,
+                  const map<string,int>& mapDCBindex, const Position& PrevPos)
+{
+try {
+   Configuration& C(Configuration::Instance());
+   size_t i;
 
-      if(iret == 0) nfiles++;
+   for(i=0; i<solobjs.size(); ++i)
+      solobjs[i].EpochReset();
 
-   }  // end loop over files
+   Rinex3ObsData::DataMap::iterator it;
+   for(it=ed.Rdata.obs.begin(); it!=ed.Rdata.obs.end(); ++it) {
+      EpochSat es;
+      if(!SatelliteGeometry(ed.Rdata.time, it->first, it->second, Rhead,
+                            DCBcorr, mapDCBindex, PrevPos, es))
+         continue;
+      ed.sats.push_back(es);
 
-   if(!C.OutputObsFile.empty()) ostrm.close();
+      // as CollectSatellite(); ComputeSolution() will check that the trop
+      // correction there did not reject a satellite
+      if(es.status == -1 || (es.status == 1 && es.elev < C.elevLimit))
+         continue;
+      for(i=0; i<solobjs.size(); ++i)
+         solobjs[i].CollectData(es.sat,es.elev,0.0,it->second);
+   }
 
-   if(iret < 0) return iret;
+   ed.prep = vector<PreparedSolution>(solobjs.size());
+   for(i=0; i<solobjs.size(); ++i)
+      if(solobjs[i].isValid && solobjs[i].Satellites.size() >= 4)
+         solobjs[i].PrepareSolution(ed.Rdata.time, ed.prep[i]);
 
-   return nfiles;
+   ed.hasGeometry = true;
 }
 catch(Exception& e) { GPSTK_RETHROW(e); }
-}  // end ProcessFiles()
+}  // end PrepareEpoch()
+
+//------------------------------------------------------------------------------------
+// Compute the solutions for one epoch, after CollectSatellite(), and write output.
+// prep is either empty or parallel to C.SolObjs.
+void ProcessEpoch(Rinex3ObsData& Rdata, Rinex3ObsHeader& Rhead,
+                  const vector<PreparedSolution>& prep, const bool& firstepoch,
+                  Rinex3ObsStream& ostrm)
+{
+try {
+   Configuration& C(Configuration::Instance());
+   int k,iret;
+   size_t i,j;
+
+   // debug: dump the RINEX data object
+   if(C.debug > -1) Rdata.dump(LOGstrm,Rhead);
+
+   // update the trop model's weather ------------------
+   if(C.MetStore.size() > 0) C.setWeather(Rdata.time);
+
+   // put a blank line here for readability
+   LOG(INFO) << "";
+
+   // compute the solution(s) --------------------------
+   // tag for DAT - required for PRSplot
+   C.msg = printTime(Rdata.time,"DAT "+C.gpsfmt);
+
+   // compute and print the solution(s) ----------------
+   for(i=0; i<C.SolObjs.size(); ++i) {
+      // skip invalid descriptors
+      if(!C.SolObjs[i].isValid) continue;
+
+      // dump the "DAT" record
+      if(firstepoch)
+         LOG(VERBOSE) << C.SolObjs[i].dump(-1, "RPF", "DAT");
+      LOG(INFO) << C.SolObjs[i].dump((C.debug > -1 ? 2:1), "RPF", C.msg);
+
+      // compute the solution
+      if(firstepoch) LOG(VERBOSE) << C.SolObjs[i].prs.outputString(
+                  string("RPF ")+C.SolObjs[i].Descriptor,-999);
+      if(firstepoch) LOG(VERBOSE) << C.SolObjs[i].prs.outputPOSString(
+                  string("RPR ")+C.SolObjs[i].Descriptor,-999);
+      if(firstepoch) LOG(VERBOSE) << C.SolObjs[i].prs.outputPOSString(
+                  string("RNE ")+C.SolObjs[i].Descriptor,-999);
+      iret = C.SolObjs[i].ComputeSolution(Rdata.time,
+                                          (i < prep.size() ? &prep[i] : NULL));
+
+      // write ORDs, even if solution is not good
+      if(C.ORDout) C.SolObjs[i].WriteORDs(Rdata.time,iret);
+   }
+
+   // write to output RINEX ----------------------------
+   if(!C.OutputObsFile.empty()) {
+      Rinex3ObsData auxData;
+      auxData.time = Rdata.time;
+      auxData.clockOffset = Rdata.clockOffset;
+      auxData.epochFlag = 4;
+      ostringstream oss;
+      // loop over valid descriptors
+      for(k=0,i=0; i<C.SolObjs.size(); ++i) if(C.SolObjs[i].isValid) {
+         if(!C.SolObjs[i].prs.isValid())
+         {
+            LOG(ERROR) << "Invalid soution!";
+            break;
+         }
+         oss.str("");
+         oss << "XYZ" << fixed << setprecision(3)
+            << " " << setw(12) << C.SolObjs[i].prs.Solution(0)
+            << " " << setw(12) << C.SolObjs[i].prs.Solution(1)
+            << " " << setw(12) << C.SolObjs[i].prs.Solution(2);
+         oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
+         auxData.auxHeader.commentList.push_back(oss.str());
+         k++;
+         oss.str("");
+         oss << "CLK" << fixed << setprecision(3);
+
+         for(j=0; j<C.SolObjs[i].prs.dataGNSS.size(); j++) {
+            RinexSatID sat(1,C.SolObjs[i].prs.dataGNSS[j]);
+            oss << " " << sat.systemString3()
+               << " " << setw(11) << C.SolObjs[i].prs.Solution(3+j);
+         }
+         oss << " " << C.SolObjs[i].Descriptor;     // may get truncated
+         auxData.auxHeader.commentList.push_back(oss.str());
+         k++;
+         oss.str("");
+         oss << "DIA" << setw(2) << C.SolObjs[i].prs.Nsvs
+            << fixed << setprecision(2)
+            << " " << setw(4) << C.SolObjs[i].prs.PDOP
+            << " " << setw(4) << C.SolObjs[i].prs.GDOP
+            << " " << setw(8) << C.SolObjs[i].prs.RMSResidual
+            << " " << C.SolObjs[i].Descriptor;     // may get truncated
+         auxData.auxHeader.commentList.push_back(oss.str());
+         k++;
+      }
+      auxData.numSVs = k;            // number of lines to write
+      auxData.auxHeader.valid |= Rinex3ObsHeader::validComment;
+      ostrm << auxData;
+
+      ostrm << Rdata;
+   }
+
+
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}  // end ProcessEpoch()
+
+//------------------------------------------------------------------------------------
+EpochPipeline::EpochPipeline(Rinex3ObsStream& is, const Rinex3ObsHeader& rh,
+                             const bool& dcb, const map<string,int>& dcbindex,
+                             const Position& pos) throw()
+   : istrm(is), Rhead(rh), DCBcorr(dcb), mapDCBindex(dcbindex), PrevPos(pos),
+     capacity(0), readDone(false), abort(false)
+{ }
+
+//------------------------------------------------------------------------------------
+EpochPipeline::~EpochPipeline() throw()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      abort = true;
+   }
+   cond.notify_all();
+
+   pool.reset();                 // waits for the threads
+
+   while(!inorder.empty()) {
+      delete inorder.front();
+      inorder.pop_front();
+   }
+}
+
+//------------------------------------------------------------------------------------
+void EpochPipeline::start(const int& n)
+{
+   Configuration& C(Configuration::Instance());
+
+   // the workers must not share the scratch space in SolutionObject
+   workerSolObjs = vector<vector<SolutionObject> >(n, C.SolObjs);
+
+   // enough epochs to keep the workers busy while the solutions are computed
+   capacity = 16*n;
+
+   pool.reset(new WorkerPool(n+1));
+   pool->start([this](unsigned int t) {
+      if(t == 1) Reader(); else Worker(t-2);
+   });
+}
+
+//------------------------------------------------------------------------------------
+EpochData *EpochPipeline::next(void)
+{
+   // serial processing - just read
+   if(!pool) {
+      EpochData *ped(new EpochData());
+      try {
+         do {
+            ped->status = ReadEpoch(istrm, ped->Rdata, ped->errmsg);
+         } while(ped->status == 1);
+      }
+      catch(Exception& e) { delete ped; GPSTK_RETHROW(e); }
+      return ped;
+   }
+
+   std::unique_lock<std::mutex> lock(mutex);
+   while(inorder.empty() || !inorder.front()->done)
+      cond.wait(lock);
+
+   EpochData *ped(inorder.front());
+   inorder.pop_front();
+   cond.notify_all();            // reader may be waiting for space
+
+   return ped;
+}
+
+//------------------------------------------------------------------------------------
+// Read epochs into both queues, until the end of the data or an error, which is
+// passed on as the last epoch.
+void EpochPipeline::Reader(void) throw()
+{
+   while(1) {
+      EpochData *ped(new EpochData());
+      try {
+         do {
+            ped->status = ReadEpoch(istrm, ped->Rdata, ped->errmsg);
+         } while(ped->status == 1);
+      }
+      catch(Exception& e) { ped->status = -1; ped->except = e; }
+
+      std::unique_lock<std::mutex> lock(mutex);
+      while(inorder.size() >= capacity && !abort)
+         cond.wait(lock);
+      if(abort) { delete ped; return; }
+
+      // NB ped belongs to the caller of next() once the lock is released
+      const bool last(ped->status != 0);
+      inorder.push_back(ped);
+      if(!last)
+         todo.push_back(ped);
+      else {
+         ped->done = true;
+         readDone = true;
+      }
+      lock.unlock();
+      cond.notify_all();
+
+      if(last) return;
+   }
+}
+
+//------------------------------------------------------------------------------------
+// Compute the geometry for epochs in todo, until the reader is done.
+void EpochPipeline::Worker(const size_t n) throw()
+{
+   while(1) {
+      EpochData *ped;
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         while(todo.empty() && !readDone && !abort)
+            cond.wait(lock);
+         if(abort || todo.empty()) return;
+         ped = todo.front();
+         todo.pop_front();
+      }
+
+      try {
+         PrepareEpoch(*ped, workerSolObjs[n], Rhead, DCBcorr, mapDCBindex, PrevPos);
+      }
+      catch(Exception& e) { ped->status = -1; ped->except = e; }
+      catch(std::exception& e) {
+         ped->status = -1;
+         ped->except = Exception(string("Std excep: ") + e.what());
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         ped->done = true;
+      }
+      cond.notify_all();
+   }
+}
 
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
@@ -1623,6 +2042,9 @@ void Configuration::SetDefaults(void) throw()
    LogFile = string("prs.log");
 
    decimate = elevLimit = 0.0;
+   workers = 1;
+   RAIMthreads = 0;
+   pRAIM = NULL;
    forceElev = false;
    searchUser = false;
    weight = false;
@@ -1929,6 +2351,11 @@ string Configuration::BuildCommandLine(void) throw()
    opts.Add(0, "Trop", "m,T,P,H", false, false, &TropStr, "",
             "Trop model <m> [one of Zero,Black,Saas,NewB,Neill,GG,GGHt,Global\n"
             "                      with optional weather T(C),P(mb),RH(%)]");
+   opts.Add(0, "workers", "n", false, false, &workers, "",
+            "Compute sat. geometry in n threads, pipelined with read and output;\n"
+            "                      solutions stay in epoch order [cf. --RAIMthreads]");
+   opts.Add(0, "RAIMthreads", "n", false, false, &RAIMthreads, "",
+            "Compute RAIM in fixed storage, with n threads per epoch [0: no]");
 
    opts.Add(0, "log", "fn", false, false, &LogFile, "# Output [for formats see "
             "GPSTK::Position (--ref) and GPSTK::Epoch (--timefmt)] :",
@@ -2110,6 +2537,16 @@ int Configuration::ExtraProcessing(string& errors, string& extras) throw()
    if(!OutputORDFile.empty() && knownPos.getCoordinateSystem() == Position::Unknown)
       oss << "Error : --ORDs requires --ref\n";
 
+   if(workers < 1)
+      oss << "Error : --workers must be at least 1\n";
+   else if(workers > 1 && debug > -1)
+      ossx << "   Warning : --workers is ignored at DEBUG log levels.\n";
+
+   if(RAIMthreads < 0)
+      oss << "Error : --RAIMthreads must not be negative\n";
+   else if(RAIMthreads > 0)
+      pRAIM = new RAIMSolver(64, 6, RAIMthreads);
+
    if(InputNavFiles.size() > 0 && InputSP3Files.size() > 0)
       oss << "Error : Both --nav and --eph appear: provide only one.\n";
 
@@ -2389,9 +2826,24 @@ void SolutionObject::CollectData(const RinexSatID& sat,
    }
 }
 
+//------------------------------------------------------------------------------------
+void SolutionObject::PrepareSolution(const CommonTime& ttag, PreparedSolution& prep)
+   throw()
+{
+   Configuration& C(Configuration::Instance());
+   try {
+      prep.Satellites = Satellites;
+      prep.NSVS = prs.PreparePRSolution(ttag, prep.Satellites, PRanges, C.pEph,
+                                        prep.SVP);
+      prep.isValid = true;
+   }
+   catch(Exception& e) { prep.isValid = false; }
+}
+
 //------------------------------------------------------------------------------------
 // return 0 good, negative failure - same as RAIMCompute
-int SolutionObject::ComputeSolution(const CommonTime& ttag)
+int SolutionObject::ComputeSolution(const CommonTime& ttag,
+                                    const PreparedSolution *pPrep)
 {
    try {
       int i,n,iret;
@@ -2405,6 +2857,14 @@ int SolutionObject::ComputeSolution(const CommonTime& ttag)
          return -3;
       }
 
+      // use the prepared solution only if it has the same satellites
+      if(pPrep && (!pPrep->isValid || pPrep->Satellites.size() != Satellites.size()))
+         pPrep = NULL;
+      for(size_t k=0; pPrep && k<Satellites.size(); k++)
+         if(pPrep->Satellites[k].system != Satellites[k].system
+               || ::abs(pPrep->Satellites[k].id) != Satellites[k].id)
+            pPrep = NULL;
+
       // compute the inverse measurement covariance
       Matrix<double> invMCov;       // default is empty - no weighting
       if(C.weight) {
@@ -2425,7 +2885,13 @@ int SolutionObject::ComputeSolution(const CommonTime& ttag)
       // get the straight solution --------------------------------------
       if(C.SPSout) {
          Matrix<double> SVP;
-         iret=prs.PreparePRSolution(ttag, Satellites, PRanges, C.pEph, SVP);
+         if(pPrep) {
+            Satellites = pPrep->Satellites;
+            SVP = pPrep->SVP;
+            iret = pPrep->NSVS;
+         }
+         else
+            iret=prs.PreparePRSolution(ttag, Satellites, PRanges, C.pEph, SVP);
 
          if(iret > -3) {
             Vector<double> Resid,Slopes;
@@ -2484,7 +2950,22 @@ int SolutionObject::ComputeSolution(const CommonTime& ttag)
       }  // end if SPSout
 
       // get the RAIM solution ------------------------------------------
-      iret = prs.RAIMCompute(ttag, Satellites, PRanges, invMCov, C.pEph, C.pTrop);
+      // NB PreparePRSolution gives the same result when called again on the
+      // Satellites it marked, as happens here after SPSout
+      if(pPrep) {
+         Satellites = pPrep->Satellites;
+         if(C.pRAIM)
+            iret = C.pRAIM->RAIMCompute(prs, ttag, Satellites, pPrep->SVP,
+                                        pPrep->NSVS, invMCov, C.pTrop);
+         else
+            iret = prs.RAIMCompute(ttag, Satellites, pPrep->SVP, pPrep->NSVS,
+                                   invMCov, C.pTrop);
+      }
+      else if(C.pRAIM)
+         iret = C.pRAIM->RAIMCompute(prs, ttag, Satellites, PRanges, invMCov,
+                                     C.pEph, C.pTrop);
+      else
+         iret = prs.RAIMCompute(ttag, Satellites, PRanges, invMCov, C.pEph,C.pTrop);
 
       if(iret < 0) {
          LOG(VERBOSE) << "RAIMCompute failed "
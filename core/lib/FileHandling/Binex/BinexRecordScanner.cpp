@@ -0,0 +1,316 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file BinexRecordScanner.cpp
+ * Zero-copy scanning of BINEX records held in a memory buffer
+ */
+
+#include "BinexRecordScanner.hpp"
+
+namespace gpstk
+{
+      // expected tail synchronization byte for each valid head
+      // synchronization byte, 0x01 for head bytes without a tail and
+      // 0 for bytes that do not start a forward record (cf.
+      // BinexData::isHeadSyncByteValid)
+   static const struct SyncTable
+   {
+      SyncTable()
+      {
+         for(int i=0; i<256; i++)
+            tail[i] = 0;
+         tail[0xC2] = tail[0xE2] = tail[0xC8] = tail[0xE8] = 0x01;
+         tail[0xD2] = 0xB4;
+         tail[0xF2] = 0xB0;
+         tail[0xD8] = 0xE4;
+         tail[0xF8] = 0xE0;
+      }
+      unsigned char tail[256];
+   } SYNC_TABLE;
+
+      // tables for the reflected polynomials of BinUtils::CRC16 and
+      // BinUtils::CRC32, the latter four bytes at a time ("slicing
+      // by 4"); crc32[0] is the usual table for one byte
+   static const struct CRCTable
+   {
+      CRCTable()
+      {
+         for(uint32_t i=0; i<256; i++)
+         {
+            uint32_t c(i), d(i);
+            for(int k=0; k<8; k++)
+            {
+               c = (c & 1) ? (0xa001UL ^ (c >> 1)) : (c >> 1);
+               d = (d & 1) ? (0xedb88320UL ^ (d >> 1)) : (d >> 1);
+            }
+            crc16[i] = c;
+            crc32[0][i] = d;
+         }
+         for(uint32_t i=0; i<256; i++)
+            for(int k=1; k<4; k++)
+               crc32[k][i] = (crc32[k-1][i] >> 8)
+                  ^ crc32[0][crc32[k-1][i] & 0xff];
+      }
+      uint32_t crc16[256];
+      uint32_t crc32[4][256];
+   } CRC_TABLE;
+
+      // run the reflected CRC-16 register over data
+   static uint32_t crc16Update(uint32_t crc, const unsigned char *data,
+                               size_t len)
+   {
+      for(size_t i=0; i<len; i++)
+         crc = (crc >> 8) ^ CRC_TABLE.crc16[(crc ^ data[i]) & 0xff];
+      return crc;
+   }
+
+      // run the reflected CRC-32 register over data
+   static uint32_t crc32Update(uint32_t crc, const unsigned char *data,
+                               size_t len)
+   {
+      const uint32_t (*table)[256](CRC_TABLE.crc32);
+      size_t i(0);
+      for( ; i+4 <= len; i += 4)
+      {
+         crc ^= uint32_t(data[i]) | (uint32_t(data[i+1]) << 8)
+            | (uint32_t(data[i+2]) << 16) | (uint32_t(data[i+3]) << 24);
+         crc = table[3][crc & 0xff] ^ table[2][(crc >> 8) & 0xff]
+            ^ table[1][(crc >> 16) & 0xff] ^ table[0][crc >> 24];
+      }
+      for( ; i<len; i++)
+         crc = (crc >> 8) ^ table[0][(crc ^ data[i]) & 0xff];
+      return crc;
+   }
+
+      // Decode a UBNXI as BinexData::UBNXI::decode does.  Returns the
+      // number of bytes used, or 0 if the buffer ends first.
+   static size_t decodeUBNXI(const unsigned char *p, size_t avail,
+                             bool littleEndian, unsigned long& value)
+   {
+      value = 0;
+      for(size_t n=0; n<4; n++)
+      {
+         if(n >= avail)
+            return 0;
+         unsigned long b = (n < 3) ? (p[n] & 0x7f) : p[n];
+         if(littleEndian)
+            value |= b << (7 * n);
+         else
+            value = (value << ((n < 3) ? 7 : 8)) | b;
+         if((p[n] & 0x80) == 0 || n == 3)
+            return n+1;
+      }
+      return 0;
+   }
+
+      // number of bytes in the UBNXI encoding of value
+   static size_t sizeUBNXI(unsigned long value)
+   {
+      return (value < 0x80UL) ? 1 : (value < 0x4000UL) ? 2
+         : (value < 0x200000UL) ? 3 : 4;
+   }
+
+
+   void BinexRecordView ::
+   toBinexData(BinexData& data) const
+   {
+      data.setRecordFlags(syncByte);
+      data.setRecordID(recID);
+      data.clearMessage();
+      size_t off(0);
+      data.updateMessageData(off, (const char*)message, messageSize);
+   }
+
+
+   BinexRecordScanner ::
+   BinexRecordScanner(const void *buffer, std::size_t size, bool endOfData)
+         : strict(false), skipped(0), count(0)
+   {
+      reset(buffer, size, endOfData);
+   }
+
+
+   void BinexRecordScanner ::
+   reset(const void *buffer, std::size_t size, bool endOfData)
+   {
+      data = static_cast<const unsigned char*>(buffer);
+      this->size = (buffer == NULL) ? 0 : size;
+      atEnd = endOfData;
+      offset = 0;
+   }
+
+
+   bool BinexRecordScanner ::
+   next(BinexRecordView& view)
+   {
+      while(offset < size)
+      {
+         const char *why(NULL);
+         int rc = parse(view, why);
+         if(rc > 0)
+         {
+            offset += view.recordSize;
+            count++;
+            return true;
+         }
+         if(rc == 0 && !atEnd)
+         {
+               // wait for the rest of the record
+            return false;
+         }
+         if(strict)
+         {
+            FFStreamError err(why);
+            GPSTK_THROW(err);
+         }
+            // resynchronize on the next possible head sync byte
+         do
+         {
+            offset++;
+            skipped++;
+         } while(offset < size && SYNC_TABLE.tail[data[offset]] == 0);
+      }
+      return false;
+   }
+
+
+   int BinexRecordScanner ::
+   parse(BinexRecordView& view, const char*& why) const
+   {
+      const unsigned char *p(data + offset);
+      size_t avail(size - offset);
+      BinexData::SyncByte sync(p[0]), tail(SYNC_TABLE.tail[sync]);
+      if(tail == 0)
+      {
+         why = "Invalid BINEX synchronization byte";
+         return -1;
+      }
+      why = "Incomplete BINEX record";
+      bool littleEndian((sync & BinexData::eBigEndian) == 0);
+      unsigned long recID, msgLen;
+      size_t r = decodeUBNXI(p+1, avail-1, littleEndian, recID);
+      if(r == 0)
+         return 0;
+      size_t m = decodeUBNXI(p+1+r, avail-1-r, littleEndian, msgLen);
+      if(m == 0)
+         return 0;
+      size_t headLen(1 + r + m);
+      unsigned char crc[4];
+      size_t crcLen = (r + m + msgLen >= 1048576) ? 16
+         : ((sync & BinexData::eEnhancedCRC) ? ((r + m + msgLen < 128) ? 2 : 4)
+            : ((r + m + msgLen < 128) ? 1 : (r + m + msgLen < 4096) ? 2 : 4));
+      size_t recSize(headLen + msgLen + crcLen);
+      if(sync & BinexData::eReverseReadable)
+         recSize += sizeUBNXI(recSize) + 1;
+      if(recSize > avail)
+         return 0;
+
+      if(crcLen != 16)
+      {
+         computeCRC(sync, p+1, r+m, p+headLen, msgLen, crc);
+         const unsigned char *actual(p + headLen + msgLen);
+         for(size_t i=0; i<crcLen; i++)
+         {
+            if(actual[i] != crc[i])
+            {
+               why = "Bad BINEX CRC";
+               return -1;
+            }
+         }
+      }
+      if((sync & BinexData::eReverseReadable) && p[recSize-1] != tail)
+      {
+         why = "BINEX head/tail synchronization byte mismatch";
+         return -1;
+      }
+
+      view.syncByte = sync;
+      view.recID = recID;
+      view.record = p;
+      view.recordSize = recSize;
+      view.message = p + headLen;
+      view.messageSize = msgLen;
+      return 1;
+   }
+
+
+   std::size_t BinexRecordScanner ::
+   computeCRC(BinexData::SyncByte syncByte,
+              const unsigned char *head, std::size_t headLen,
+              const unsigned char *message, std::size_t messageLen,
+              unsigned char crc[4])
+   {
+      size_t crcDataLen(headLen + messageLen);
+      if(crcDataLen >= 1048576)
+         return 16;
+
+      size_t crcLen;
+      uint32_t value(0);
+         // BinexData::getCRC runs BinUtils::computeCRC over the head
+         // and then over the message starting from the head's
+         // (reflected) result, so the register is reflected back
+         // between the two
+      if(!(syncByte & BinexData::eEnhancedCRC) && crcDataLen < 128)
+      {
+         for(size_t i=0; i<headLen; i++)
+            value ^= head[i];
+         for(size_t i=0; i<messageLen; i++)
+            value ^= message[i];
+         crcLen = 1;
+      }
+      else if(crcDataLen < ((syncByte & BinexData::eEnhancedCRC) ? 128 : 4096))
+      {
+         value = crc16Update(0, head, headLen);
+         value = crc16Update(BinUtils::reflect(value, 16), message,
+                             messageLen);
+         crcLen = 2;
+      }
+      else
+      {
+         value = crc32Update(0xffffffffUL, head, headLen) ^ 0xffffffffUL;
+         value = crc32Update(BinUtils::reflect(value, 32), message,
+                             messageLen) ^ 0xffffffffUL;
+         crcLen = 4;
+      }
+      for(size_t i=0; i<4; i++)
+         crc[i] = (value >> (8*i)) & 0xff;
+      return crcLen;
+   }
+
+} // namespace gpstk
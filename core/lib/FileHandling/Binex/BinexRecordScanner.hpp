@@ -0,0 +1,204 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file BinexRecordScanner.hpp
+ * Zero-copy scanning of BINEX records held in a memory buffer
+ */
+
+#ifndef GPSTK_BINEXRECORDSCANNER_HPP
+#define GPSTK_BINEXRECORDSCANNER_HPP
+
+#include <cstddef>
+#include "BinexData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * A lightweight reference to one BINEX record inside a buffer
+       * owned by someone else.  The pointers remain valid only as
+       * long as the buffer that was given to the BinexRecordScanner
+       * that produced the view.
+       */
+   struct BinexRecordView
+   {
+         /// Initialize to an empty view.
+      BinexRecordView()
+            : syncByte(0), recID(BinexData::INVALID_RECORD_ID),
+              record(NULL), recordSize(0), message(NULL), messageSize(0)
+      {}
+
+         /// True if the record ID and message length are little endian.
+      bool isLittleEndian() const
+      { return (syncByte & BinexData::eBigEndian) == 0; }
+
+         /// True if the record carries a reverse-readable trailer.
+      bool isReverseReadable() const
+      { return (syncByte & BinexData::eReverseReadable) != 0; }
+
+         /// True if the record uses the enhanced CRC.
+      bool isEnhancedCRC() const
+      { return (syncByte & BinexData::eEnhancedCRC) != 0; }
+
+         /** Copy the record into a BinexData object, for code that
+          * needs the full BinexData interface for a subset of the
+          * records.
+          * @throw FFStreamError
+          * @throw InvalidParameter */
+      void toBinexData(BinexData& data) const;
+
+      BinexData::SyncByte syncByte;     ///< head synchronization byte
+      BinexData::RecordID recID;        ///< record ID
+      const unsigned char *record;      ///< first byte (sync) of the record
+      std::size_t recordSize;           ///< total record length in bytes
+      const unsigned char *message;     ///< first byte of the message
+      std::size_t messageSize;          ///< message length in bytes
+   };
+
+
+      /**
+       * Walks a memory buffer containing forward-written BINEX
+       * records (e.g. a file read or mapped into memory) and yields a
+       * BinexRecordView for each record, validating the
+       * synchronization bytes and CRC without copying any data.
+       *
+       * Invalid bytes between records are skipped, one byte at a
+       * time, until a valid record is found, and counted by
+       * getSkipped().  Setting strict makes the scanner throw an
+       * FFStreamError instead, as BinexData::getRecord() would.
+       *
+       * When the buffer is only part of a stream (endOfData false),
+       * a record that runs past the end of the buffer is not
+       * consumed: next() returns false and getOffset() is left at its
+       * synchronization byte, so the reader can move the bytes from
+       * getOffset() on to the start of its buffer, append more data
+       * and call reset().  When endOfData is true such a record can
+       * never be completed and is treated as invalid data.
+       *
+       * Limitations: records written in reverse (starting with a tail
+       * synchronization byte) are treated as invalid bytes; the 16-byte
+       * MD5 checksum used for records of 1 MiB or more is skipped
+       * rather than verified; the reverse length field of a
+       * reverse-readable record is skipped, only its tail
+       * synchronization byte is checked.
+       *
+       * @code
+       * BinexRecordScanner scanner(buf.data(), buf.size());
+       * BinexRecordView view;
+       * while (scanner.next(view))
+       *    process(view.recID, view.message, view.messageSize);
+       * @endcode
+       *
+       * @sa BinexData, BinexStream
+       */
+   class BinexRecordScanner
+   {
+   public:
+         /** Scan the given buffer, which must outlive the scanner
+          * and all views it produces.
+          * @param[in] buffer the data to scan.
+          * @param[in] size the number of bytes in buffer.
+          * @param[in] endOfData true if no more data follows the
+          *   buffer. */
+      BinexRecordScanner(const void *buffer = NULL, std::size_t size = 0,
+                         bool endOfData = true);
+
+         /** Continue on a new buffer, from its first byte.  The
+          * skipped and record counts keep accumulating. */
+      void reset(const void *buffer, std::size_t size,
+                 bool endOfData = true);
+
+         /** Find the next valid record.
+          * @param[out] view set to the record found.
+          * @return false if no complete record remains in the buffer.
+          * @throw FFStreamError if strict is set and invalid data
+          *   is found. */
+      bool next(BinexRecordView& view);
+
+         /// Offset of the first byte not yet consumed.
+      std::size_t getOffset() const
+      { return offset; }
+
+         /// Number of invalid bytes skipped since construction.
+      std::size_t getSkipped() const
+      { return skipped; }
+
+         /// Number of records returned since construction.
+      std::size_t getRecordCount() const
+      { return count; }
+
+         /** Compute the CRC of a BINEX record the way
+          * BinexData::getCRC does, from the record ID and message
+          * length bytes (head, excluding the sync byte) and the
+          * message.
+          * @param[in] syncByte the record's head synchronization byte.
+          * @param[out] crc the expected CRC bytes, 0 to 4 of them.
+          * @return the number of CRC bytes in the record (which is
+          *   16 and crc is untouched for MD5 records). */
+      static std::size_t computeCRC(BinexData::SyncByte syncByte,
+                                    const unsigned char *head,
+                                    std::size_t headLen,
+                                    const unsigned char *message,
+                                    std::size_t messageLen,
+                                    unsigned char crc[4]);
+
+         /// If true, throw on invalid data rather than skipping it.
+      bool strict;
+
+   private:
+         /** Try to parse a record at the current offset.
+          * @return 1 for a valid record, 0 for an incomplete one,
+          *   -1 for invalid data. */
+      int parse(BinexRecordView& view, const char*& why) const;
+
+      const unsigned char *data;    ///< buffer being scanned
+      std::size_t size;             ///< number of bytes in data
+      bool atEnd;                   ///< no data follows the buffer
+      std::size_t offset;           ///< start of the unconsumed data
+      std::size_t skipped;          ///< invalid bytes skipped
+      std::size_t count;            ///< records returned
+   };
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_BINEXRECORDSCANNER_HPP
@@ -0,0 +1,178 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file MemoryMappedFile.cpp
+ * Read-only view of the contents of a file, memory mapped where supported.
+ */
+
+#include <fstream>
+#include "MemoryMappedFile.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace gpstk
+{
+   MemoryMappedFile ::
+   MemoryMappedFile()
+         : mapped(nullptr), length(0), isOpenFlag(false)
+   {
+   }
+
+
+   MemoryMappedFile ::
+   MemoryMappedFile(const std::string& fn)
+         : mapped(nullptr), length(0), isOpenFlag(false)
+   {
+      open(fn);
+   }
+
+
+   MemoryMappedFile ::
+   MemoryMappedFile(MemoryMappedFile&& right)
+         : mapped(right.mapped), length(right.length),
+           buffer(std::move(right.buffer)), name(std::move(right.name)),
+           isOpenFlag(right.isOpenFlag)
+   {
+      right.mapped = nullptr;
+      right.length = 0;
+      right.isOpenFlag = false;
+   }
+
+
+   MemoryMappedFile& MemoryMappedFile ::
+   operator=(MemoryMappedFile&& right)
+   {
+      if (this != &right)
+      {
+         close();
+         mapped = right.mapped;
+         length = right.length;
+         buffer = std::move(right.buffer);
+         name = std::move(right.name);
+         isOpenFlag = right.isOpenFlag;
+         right.mapped = nullptr;
+         right.length = 0;
+         right.isOpenFlag = false;
+      }
+      return *this;
+   }
+
+
+   MemoryMappedFile ::
+   ~MemoryMappedFile()
+   {
+      close();
+   }
+
+
+   void MemoryMappedFile ::
+   open(const std::string& fn)
+   {
+      close();
+#ifndef _WIN32
+      int fd = ::open(fn.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         FileMissingException exc("Unable to open " + fn);
+         GPSTK_THROW(exc);
+      }
+      struct stat sbuf;
+      if (::fstat(fd, &sbuf) != 0)
+      {
+         ::close(fd);
+         FileMissingException exc("Unable to stat " + fn);
+         GPSTK_THROW(exc);
+      }
+      length = sbuf.st_size;
+      if (length > 0)
+      {
+         void *addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+         if (addr == MAP_FAILED)
+         {
+            ::close(fd);
+            length = 0;
+            FileMissingException exc("Unable to map " + fn);
+            GPSTK_THROW(exc);
+         }
+            // Readers of this class scan front to back.
+         ::madvise(addr, length, MADV_SEQUENTIAL);
+         mapped = static_cast<const char*>(addr);
+      }
+         // the mapping remains valid after the descriptor is closed
+      ::close(fd);
+#else
+      std::ifstream ifs(fn.c_str(), std::ios::in | std::ios::binary);
+      if (!ifs)
+      {
+         FileMissingException exc("Unable to open " + fn);
+         GPSTK_THROW(exc);
+      }
+      ifs.seekg(0, std::ios::end);
+      length = ifs.tellg();
+      ifs.seekg(0, std::ios::beg);
+      buffer.resize(length);
+      if (length > 0)
+         ifs.read(&buffer[0], length);
+#endif
+      name = fn;
+      isOpenFlag = true;
+   }
+
+
+   void MemoryMappedFile ::
+   close()
+   {
+#ifndef _WIN32
+      if (mapped != nullptr)
+      {
+         ::munmap(const_cast<char*>(mapped), length);
+      }
+#endif
+      mapped = nullptr;
+      length = 0;
+      buffer.clear();
+      name.clear();
+      isOpenFlag = false;
+   }
+
+} // namespace gpstk
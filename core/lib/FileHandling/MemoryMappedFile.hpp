@@ -0,0 +1,130 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file MemoryMappedFile.hpp
+ * Read-only view of the contents of a file, memory mapped where supported.
+ */
+
+#ifndef GPSTK_MEMORYMAPPEDFILE_HPP
+#define GPSTK_MEMORYMAPPEDFILE_HPP
+
+#include <string>
+#include <vector>
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Provide read-only access to the entire contents of a file as
+       * a contiguous block of memory.  On POSIX systems the file is
+       * mapped with mmap(), so no copy of the data is made and pages
+       * are only read from disk as they are touched.  On other
+       * platforms the file is read into an internal buffer, which
+       * gives the same interface at the cost of one copy.
+       *
+       * The object is not copyable, but is movable.  The data
+       * pointer remains valid until close() is called or the object
+       * is destroyed.
+       */
+   class MemoryMappedFile
+   {
+   public:
+         /// Create an empty object not associated with any file.
+      MemoryMappedFile();
+
+         /** Map the contents of the file \a fn.
+          * @param[in] fn The path of the file to map.
+          * @throw FileMissingException if the file can not be opened
+          *   or mapped. */
+      explicit MemoryMappedFile(const std::string& fn);
+
+      MemoryMappedFile(MemoryMappedFile&& right);
+      MemoryMappedFile& operator=(MemoryMappedFile&& right);
+      MemoryMappedFile(const MemoryMappedFile&) = delete;
+      MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+         /// Unmap the file, if any.
+      ~MemoryMappedFile();
+
+         /** Map the contents of the file \a fn, releasing any file
+          * previously held by this object.
+          * @param[in] fn The path of the file to map.
+          * @throw FileMissingException if the file can not be opened
+          *   or mapped. */
+      void open(const std::string& fn);
+
+         /// Release the mapping, if any.
+      void close();
+
+         /// Return true if a file is currently held.
+      bool isOpen() const
+      { return isOpenFlag; }
+
+         /// Pointer to the first byte of the file contents.
+      const char* data() const
+      { return mapped ? mapped : (buffer.empty() ? nullptr : &buffer[0]); }
+
+         /// Number of bytes in the file.
+      size_t size() const
+      { return length; }
+
+         /// Path of the file currently held.
+      const std::string& fileName() const
+      { return name; }
+
+   private:
+         /// Start of the mmap()ed region, or nullptr when buffered/empty.
+      const char* mapped;
+         /// Size of the file in bytes.
+      size_t length;
+         /// File contents when memory mapping is not available.
+      std::vector<char> buffer;
+         /// Name of the file held.
+      std::string name;
+         /// True when a file is held (files may be empty).
+      bool isOpenFlag;
+   };
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_MEMORYMAPPEDFILE_HPP
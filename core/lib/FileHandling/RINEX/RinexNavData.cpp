@@ -302,14 +302,14 @@ namespace gpstk
             if (currentLine[i] != ' ')
                throw(FFStreamError("Badly formatted line"));
 
-         PRNID = asInt(currentLine.substr(0,2));
-
-         short yr = asInt(currentLine.substr(2,3));
-         short mo = asInt(currentLine.substr(5,3));
-         short day = asInt(currentLine.substr(8,3));
-         short hr = asInt(currentLine.substr(11,3));
-         short min = asInt(currentLine.substr(14,3));
-         double sec = asDouble(currentLine.substr(17,5));
+         PRNID = asInt(currentLine, 0, 2);
+
+         short yr = asInt(currentLine, 2, 3);
+         short mo = asInt(currentLine, 5, 3);
+         short day = asInt(currentLine, 8, 3);
+         short hr = asInt(currentLine, 11, 3);
+         short min = asInt(currentLine, 14, 3);
+         double sec = asDouble(currentLine, 17, 5);
 
             // years 80-99 represent 1980-1999
          const int rolloverYear = 80;
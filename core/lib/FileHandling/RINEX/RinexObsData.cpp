@@ -69,8 +69,8 @@ namespace gpstk
       // first the epoch line to 'line'
       line  = writeTime(time);
       line += string(2, ' ');
-      line += rightJustify(asString<short>(epochFlag), 1);
-      line += rightJustify(asString<short>(numSvs), 3);
+      appendInt(line, epochFlag, 1);
+      appendInt(line, numSvs, 3);
 
       // write satellite ids to 'line'
       const int maxPrnsPerLine = 12;
@@ -90,7 +90,7 @@ namespace gpstk
          if(clockOffset != 0.0)
          {
             line += string(68 - line.size(), ' ');
-            line += rightJustify(asString(clockOffset, 9), 12);
+            appendFixed(line, clockOffset, 9, 12);
          }
 
         // continuation lines
@@ -159,15 +159,15 @@ namespace gpstk
                RinexDatum thisData;
                if (rotmi != obsItr->second.end())
                   thisData = rotmi->second;
-               line += rightJustify(asString(thisData.data,3),14);
+               appendFixed(line, thisData.data, 3, 14);
                if (thisData.lli == 0)
                   line += string(1, ' ');
                else
-                  line += rightJustify(asString<short>(thisData.lli),1);
+                  appendInt(line, thisData.lli, 1);
                if (thisData.ssi == 0)
                   line += string(1, ' ');
                else
-                  line += rightJustify(asString<short>(thisData.ssi),1);
+                  appendInt(line, thisData.ssi, 1);
                obsWritten++;
                obsTypeItr++;
             }
@@ -221,7 +221,7 @@ namespace gpstk
             }
 
                // Check if it is a number; if not, an exception will be thrown
-            (void)asInt(line.substr(29,3));
+            (void)asInt(line, 29, 3);
          }
          catch(...)
          {
@@ -232,7 +232,7 @@ namespace gpstk
       }  // End of 'while( !isValidEpochLine )'
 
          // process the epoch line, including SV list and clock bias
-      epochFlag = asInt(line.substr(28,1));
+      epochFlag = asInt(line, 28, 1);
       if ((epochFlag < 0) || (epochFlag > 6))
       {
          FFStreamError e("Invalid epoch flag: " + asString(epochFlag));
@@ -265,10 +265,10 @@ namespace gpstk
          previousTime = time;
       }
 
-      numSvs = asInt(line.substr(29,3));
+      numSvs = asInt(line, 29, 3);
 
       if( line.size() > 68 )
-         clockOffset = asDouble(line.substr(68, 12));
+         clockOffset = asDouble(line, 68, 12);
       else
          clockOffset = 0.0;
 
@@ -321,9 +321,9 @@ namespace gpstk
 
                line.resize(80, ' ');
 
-               obs[sat][obs_type].data = asDouble(line.substr(line_ndx*16,   14));
-               obs[sat][obs_type].lli = asInt(    line.substr(line_ndx*16+14, 1));
-               obs[sat][obs_type].ssi = asInt(    line.substr(line_ndx*16+15, 1));
+               obs[sat][obs_type].data = asDouble(line, line_ndx*16, 14);
+               obs[sat][obs_type].lli = asInt(    line, line_ndx*16+14, 1);
+               obs[sat][obs_type].ssi = asInt(    line, line_ndx*16+15, 1);
             }
          }
       }
@@ -384,12 +384,12 @@ namespace gpstk
          int yy = (static_cast<CivilTime>(hdr.firstObs)).year/100;
          yy *= 100;
 
-         year  = asInt(   line.substr(1,  2 ));
-         month = asInt(   line.substr(4,  2 ));
-         day   = asInt(   line.substr(7,  2 ));
-         hour  = asInt(   line.substr(10, 2 ));
-         min   = asInt(   line.substr(13, 2 ));
-         sec   = asDouble(line.substr(15, 11));
+         year  = asInt(   line, 1, 2);
+         month = asInt(   line, 4, 2);
+         day   = asInt(   line, 7, 2);
+         hour  = asInt(   line, 10, 2);
+         min   = asInt(   line, 13, 2);
+         sec   = asDouble(line, 15, 11);
 
          // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often....
          double ds=0;
@@ -425,16 +425,16 @@ namespace gpstk
       string line;
       CivilTime civTime(dt);
       line  = string(1, ' ');
-      line += rightJustify(asString<short>(civTime.year),2);
+      appendInt(line, civTime.year, 2);
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civTime.month),2);
+      appendInt(line, civTime.month, 2);
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civTime.day),2);
+      appendInt(line, civTime.day, 2);
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civTime.hour),2);
+      appendInt(line, civTime.hour, 2);
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civTime.minute),2);
-      line += rightJustify(asString(civTime.second, 7),11);
+      appendInt(line, civTime.minute, 2);
+      appendFixed(line, civTime.second, 7, 11);
 
       return line;
    }
@@ -1243,15 +1243,15 @@ namespace gpstk
             }
 
             satSys = line.substr(0,1);
-            PRNID = asInt(line.substr(1,2));
+            PRNID = asInt(line, 1, 2);
             sat.fromString(line.substr(0,3));
 
-            yr  = asInt(line.substr( 4,4));
-            mo  = asInt(line.substr( 9,2));
-            day = asInt(line.substr(12,2));
-            hr  = asInt(line.substr(15,2));
-            min = asInt(line.substr(18,2));
-            dsec = asDouble(line.substr(21,2));
+            yr  = asInt(line, 4, 4);
+            mo  = asInt(line, 9, 2);
+            day = asInt(line, 12, 2);
+            hr  = asInt(line, 15, 2);
+            min = asInt(line, 18, 2);
+            dsec = asDouble(line, 21, 2);
          }
          else
          {
@@ -1265,18 +1265,18 @@ namespace gpstk
             }
 
             satSys = string(1,strm.header.fileSys[0]);
-            PRNID = asInt(line.substr(0,2));
+            PRNID = asInt(line, 0, 2);
             sat.fromString(satSys + line.substr(0,2));
 
-            yr  = asInt(line.substr( 2,3));
+            yr  = asInt(line, 2, 3);
             if (yr < 80)
                yr += 100;     // rollover is at 1980
             yr += 1900;
-            mo  = asInt(line.substr( 5,3));
-            day = asInt(line.substr( 8,3));
-            hr  = asInt(line.substr(11,3));
-            min = asInt(line.substr(14,3));
-            dsec = asDouble(line.substr(17,5));
+            mo  = asInt(line, 5, 3);
+            day = asInt(line, 8, 3);
+            hr  = asInt(line, 11, 3);
+            min = asInt(line, 14, 3);
+            dsec = asDouble(line, 17, 5);
          }
 
          // Fix RINEX epochs of the form 'yy mm dd hr 59 60.0'
@@ -73,19 +73,19 @@ namespace gpstk
       {
          CivilTime civTime(rod.time);
          line  = string(1, ' ');
-         line += rightJustify(asString<short>(civTime.year),2);
+         appendInt(line, civTime.year, 2);
          line += string(1, ' ');
-         line += rightJustify(asString<short>(civTime.month),2);
+         appendInt(line, civTime.month, 2);
          line += string(1, ' ');
-         line += rightJustify(asString<short>(civTime.day),2);
+         appendInt(line, civTime.day, 2);
          line += string(1, ' ');
-         line += rightJustify(asString<short>(civTime.hour),2);
+         appendInt(line, civTime.hour, 2);
          line += string(1, ' ');
-         line += rightJustify(asString<short>(civTime.minute),2);
-         line += rightJustify(asString(civTime.second, 7),11);
+         appendInt(line, civTime.minute, 2);
+         appendFixed(line, civTime.second, 7, 11);
          line += string(2, ' ');
-         line += rightJustify(asString<short>(rod.epochFlag), 1);
-         line += rightJustify(asString<short>(rod.numSVs), 3);
+         appendInt(line, rod.epochFlag, 1);
+         appendInt(line, rod.numSVs, 3);
       }
 
          // write satellite ids to 'line'
@@ -107,7 +107,7 @@ namespace gpstk
          if( rod.clockOffset != 0.0 )
          {
             line += string(68 - line.size(), ' ');
-            line += rightJustify( asString(rod.clockOffset, 9), 12 );
+            appendFixed(line, rod.clockOffset, 9, 12);
          }
 
             // continuation lines
@@ -192,11 +192,11 @@ namespace gpstk
                if (ind == -1)
                {
                   RinexDatum empty;
-                  line += empty.asString();
+                  empty.appendTo(line);
                }
                else
                {
-                  line += itr->second[ind].asString();
+                  itr->second[ind].appendTo(line);
                }
                obsWritten++;
 
@@ -326,11 +326,11 @@ namespace gpstk
       line  = ">";
       line += writeTime(time);
       line += string(2, ' ');
-      line += rightJustify(asString<short>(epochFlag), 1);
-      line += rightJustify(asString<short>(numSVs   ), 3);
+      appendInt(line, epochFlag, 1);
+      appendInt(line, numSVs, 3);
       line += string(6, ' ');
       if(clockOffset != 0.0) // optional data; need to test for its existence
-         line += rightJustify(asString(clockOffset, 12), 15);
+         appendFixed(line, clockOffset, 12, 15);
 
       strm << line << endl;
       strm.lineNumber++;
@@ -346,7 +346,7 @@ namespace gpstk
 
             for(size_t i=0; i < itr->second.size(); i++)
             {
-               line += itr->second[i].asString();
+               itr->second[i].appendTo(line);
             }
                // write the data line out
             strm << line << endl;
@@ -379,8 +379,6 @@ namespace gpstk
    
    void reallyGetRecordVer2(Rinex3ObsStream& strm, Rinex3ObsData& rod)
    {
-      static CommonTime previousTime(CommonTime::BEGINNING_OF_TIME);
-
          // get the epoch line and check
       string line;
       while(line.empty())        // ignore blank lines in place of epoch lines
@@ -394,7 +392,7 @@ namespace gpstk
       }
 
          // process the epoch line, including SV list and clock bias
-      rod.epochFlag = asInt(line.substr(28,1));
+      rod.epochFlag = asInt(line, 28, 1);
       if((rod.epochFlag < 0) || (rod.epochFlag > 6))
       {
          FFStreamError e("Invalid epoch flag: " + asString(rod.epochFlag));
@@ -416,7 +414,7 @@ namespace gpstk
          GPSTK_THROW(e);
       }
       else if(noEpochTime)
-         rod.time = previousTime;
+         rod.time = strm.previousTime;
       else
       {
          try
@@ -441,12 +439,12 @@ namespace gpstk
                int yy = (static_cast<CivilTime>(strm.header.firstObs)).year/100;
                yy *= 100;
 
-               year  = asInt(   line.substr(1,  2 ));
-               month = asInt(   line.substr(4,  2 ));
-               day   = asInt(   line.substr(7,  2 ));
-               hour  = asInt(   line.substr(10, 2 ));
-               min   = asInt(   line.substr(13, 2 ));
-               sec   = asDouble(line.substr(15, 11));
+               year  = asInt(   line, 1, 2);
+               month = asInt(   line, 4, 2);
+               day   = asInt(   line, 7, 2);
+               hour  = asInt(   line, 10, 2);
+               min   = asInt(   line, 13, 2);
+               sec   = asDouble(line, 15, 11);
 
                   // Real Rinex has epochs 'yy mm dd hr 59 60.0'
                   // surprisingly often....
@@ -477,15 +475,15 @@ namespace gpstk
             // end rod.time = parseTime(line, strm.header);
 
             // save for next call
-         previousTime = rod.time;
+         strm.previousTime = rod.time;
       }
 
          // number of satellites
-      rod.numSVs = asInt(line.substr(29,3));
+      rod.numSVs = asInt(line, 29, 3);
 
          // clock offset
       if(line.size() > 68 )
-         rod.clockOffset = asDouble(line.substr(68, 12));
+         rod.clockOffset = asDouble(line, 68, 12);
       else
          rod.clockOffset = 0.0;
 
@@ -630,7 +628,7 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
-      epochFlag = asInt(line.substr(31,1));
+      epochFlag = asInt(line, 31, 1);
       if(epochFlag < 0 || epochFlag > 6)
       {
          FFStreamError e("Invalid epoch flag: " + asString(epochFlag));
@@ -639,10 +637,10 @@ namespace gpstk
 
       time = parseTime(line, strm.header, strm.timesystem);
 
-      numSVs = asInt(line.substr(32,3));
+      numSVs = asInt(line, 32, 3);
 
       if(line.size() > 41)
-         clockOffset = asDouble(line.substr(41,15));
+         clockOffset = asDouble(line, 41, 15);
       else
          clockOffset = 0.0;
 
@@ -750,12 +748,12 @@ namespace gpstk
          int year, month, day, hour, min;
          double sec;
 
-         year  = asInt(   line.substr( 2,  4));
-         month = asInt(   line.substr( 7,  2));
-         day   = asInt(   line.substr(10,  2));
-         hour  = asInt(   line.substr(13,  2));
-         min   = asInt(   line.substr(16,  2));
-         sec   = asDouble(line.substr(19, 11));
+         year  = asInt(   line, 2, 4);
+         month = asInt(   line, 7, 2);
+         day   = asInt(   line, 10, 2);
+         hour  = asInt(   line, 13, 2);
+         min   = asInt(   line, 16, 2);
+         sec   = asDouble(line, 19, 11);
 
             // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
          double ds = 0;
@@ -794,16 +792,16 @@ namespace gpstk
       string line;
 
       line  = string(1, ' ');
-      line += rightJustify(asString<short>(civtime.year    ), 4);
+      appendInt(line, civtime.year, 4);
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civtime.month   ), 2, '0');
+      appendInt(line, civtime.month, 2, '0');
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civtime.day     ), 2, '0');
+      appendInt(line, civtime.day, 2, '0');
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civtime.hour    ), 2, '0');
+      appendInt(line, civtime.hour, 2, '0');
       line += string(1, ' ');
-      line += rightJustify(asString<short>(civtime.minute  ), 2, '0');
-      line += rightJustify(asString       (civtime.second,7),11);
+      appendInt(line, civtime.minute, 2, '0');
+      appendFixed(line, civtime.second, 7, 11);
 
       return line;
    }  // end writeTime
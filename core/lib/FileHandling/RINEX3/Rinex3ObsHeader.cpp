@@ -2170,9 +2170,17 @@ namespace gpstk
          for(size_t i=0; i<mit->second.size(); i++)
          {
             string R2ot, lab(mit->second[i].asString(version));
-               // the list of all tracking code characters for this sys, freq
-            string allCodes(
-               RinexObsID::validRinexTrackingCodes[mit->first[0]][lab[1]]);
+               // the list of all tracking code characters for this sys, freq;
+               // found without inserting, as files may be read concurrently
+            string allCodes;
+            map<char, map<char, string> >::const_iterator sit(
+               RinexObsID::validRinexTrackingCodes.find(mit->first[0]));
+            if(sit != RinexObsID::validRinexTrackingCodes.end())
+            {
+               map<char, string>::const_iterator fit(sit->second.find(lab[1]));
+               if(fit != sit->second.end())
+                  allCodes = fit->second;
+            }
 
             if (lab == string("C1C"))
                R2ot = string("C1");
@@ -0,0 +1,489 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file Rinex3ObsMappedReader.cpp
+ * Memory-mapped reader for RINEX 3 observation files.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include "StringUtils.hpp"
+#include "CivilTime.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      /* The helpers below decode fixed-width fields directly from a
+       * line in the mapped buffer.  Columns beyond the end of the
+       * line read as blanks, which matches the padding
+       * Rinex3ObsData applies to short lines. */
+   namespace
+   {
+         /// A line in the mapped buffer.
+      struct LineView
+      {
+         const char *ptr;
+         size_t len;
+
+         char at(size_t i) const
+         { return (i < len) ? ptr[i] : ' '; }
+
+            /// True if columns [pos, pos+n) are all blank.
+         bool blank(size_t pos, size_t n) const
+         {
+            for (size_t i = pos; i < pos+n && i < len; i++)
+            {
+               if (ptr[i] != ' ')
+                  return false;
+            }
+            return true;
+         }
+
+            /// Length after removing trailing blanks.
+         size_t strippedLength() const
+         {
+            size_t rv = len;
+            while (rv > 0 && ptr[rv-1] == ' ')
+               rv--;
+            return rv;
+         }
+      };
+
+
+         /// Decode an integer the same way strtol would.
+      long fieldInt(const LineView& line, size_t pos, size_t n)
+      {
+         if (pos >= line.len)
+            return 0;
+         return StringUtils::asInt(line.ptr+pos, std::min(n, line.len-pos));
+      }
+
+
+         /// Decode a floating point value the same way strtod would.
+      double fieldDouble(const LineView& line, size_t pos, size_t n)
+      {
+         if (pos >= line.len)
+            return 0.;
+         return StringUtils::asDouble(line.ptr+pos, std::min(n, line.len-pos));
+      }
+
+
+         /** Decode a satellite ID the same way RinexSatID::fromString
+          * would.
+          * @throw Exception on an invalid system character. */
+      void fieldSat(const LineView& line, size_t pos, RinexSatID& sat)
+      {
+         sat.id = -1;
+         sat.system = SatelliteSystem::GPS;
+         size_t i = pos, end = pos+3;
+         while (i < end && isspace(static_cast<unsigned char>(line.at(i))))
+            i++;
+         if (i == end)
+            return;
+         switch (line.at(i))
+         {
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+               sat.system = SatelliteSystem::GPS;
+               break;
+            case 'R': case 'r':
+               sat.system = SatelliteSystem::Glonass;
+               i++;
+               break;
+            case 'T': case 't':
+               sat.system = SatelliteSystem::Transit;
+               i++;
+               break;
+            case 'S': case 's':
+               sat.system = SatelliteSystem::Geosync;
+               i++;
+               break;
+            case 'E': case 'e':
+               sat.system = SatelliteSystem::Galileo;
+               i++;
+               break;
+            case 'M': case 'm':
+               sat.system = SatelliteSystem::Mixed;
+               i++;
+               break;
+            case 'G': case 'g':
+               sat.system = SatelliteSystem::GPS;
+               i++;
+               break;
+            case 'J': case 'j':
+               sat.system = SatelliteSystem::QZSS;
+               i++;
+               break;
+            case 'I': case 'i':
+               sat.system = SatelliteSystem::IRNSS;
+               i++;
+               break;
+            case 'C': case 'c':
+               sat.system = SatelliteSystem::BeiDou;
+               i++;
+               break;
+            default:
+               Exception e(std::string("Invalid system character \"")
+                           + line.at(i) + std::string("\""));
+               GPSTK_THROW(e);
+         }
+         int id = fieldInt(line, i, end-i);
+         if (id <= 0)
+         {
+            sat.id = -1;
+            return;
+         }
+            // do the kludging that RINEX does for PRNs > 99
+         switch (sat.system)
+         {
+            case SatelliteSystem::Geosync:
+               id += 100;
+               break;
+            case SatelliteSystem::QZSS:
+               id += (id < 83) ? 192 : 100;
+               break;
+            default:
+               break;
+         }
+         sat.id = id;
+      }
+
+
+         /// Decode a 16 column RINEX observation field.
+      void fieldDatum(const LineView& line, size_t pos, RinexDatum& rd)
+      {
+         if (line.blank(pos, 14))
+         {
+            rd.data = 0.;
+            rd.dataBlank = true;
+         }
+         else
+         {
+            rd.data = fieldDouble(line, pos, 14);
+            rd.dataBlank = false;
+         }
+         char c = line.at(pos+14);
+         rd.lliBlank = (c == ' ');
+         rd.lli = (c >= '0' && c <= '9') ? (c - '0') : 0;
+         c = line.at(pos+15);
+         rd.ssiBlank = (c == ' ');
+         rd.ssi = (c >= '0' && c <= '9') ? (c - '0') : 0;
+      }
+   }
+
+
+   Rinex3ObsMappedReader ::
+   Rinex3ObsMappedReader()
+         : timesystem(TimeSystem::GPS), dataStart(0), pos(0), lineNumber(0),
+           headerLines(0), numObsForSys(256, 0)
+   {
+   }
+
+
+   Rinex3ObsMappedReader ::
+   Rinex3ObsMappedReader(const std::string& fn)
+         : timesystem(TimeSystem::GPS), dataStart(0), pos(0), lineNumber(0),
+           headerLines(0), numObsForSys(256, 0)
+   {
+      open(fn);
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   open(const std::string& fn)
+   {
+      close();
+         // Use the existing header decoder, then pick up where it
+         // left off in the mapped buffer.
+      Rinex3ObsStream strm(fn.c_str(), std::ios::in);
+      if (!strm)
+      {
+         FileMissingException exc("Unable to open " + fn);
+         GPSTK_THROW(exc);
+      }
+      strm.exceptions(std::fstream::failbit);
+      try
+      {
+         strm >> header;
+      }
+      catch (Exception& exc)
+      {
+         FFStreamError err(exc);
+         err.addText("Unable to read header of " + fn);
+         GPSTK_THROW(err);
+      }
+      catch (std::exception& exc)
+      {
+         FFStreamError err("Unable to read header of " + fn + ": " +
+                           exc.what());
+         GPSTK_THROW(err);
+      }
+      if (header.version < 3)
+      {
+         FFStreamError err("Rinex3ObsMappedReader requires RINEX 3, " + fn +
+                           " is version " +
+                           StringUtils::asString(header.version, 2));
+         GPSTK_THROW(err);
+      }
+      timesystem = strm.timesystem;
+      headerLines = strm.lineNumber;
+      std::streamoff offs = strm.tellg();
+      strm.close();
+
+      file.open(fn);
+      dataStart = (offs < 0) ? file.size() : static_cast<size_t>(offs);
+      initTables();
+      rewind();
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   close()
+   {
+      file.close();
+      header = Rinex3ObsHeader();
+      timesystem = TimeSystem::GPS;
+      dataStart = pos = 0;
+      lineNumber = headerLines = 0;
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   rewind()
+   {
+      pos = dataStart;
+      lineNumber = headerLines;
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   initTables()
+   {
+      std::fill(numObsForSys.begin(), numObsForSys.end(), 0);
+      Rinex3ObsHeader::RinexObsMap::const_iterator i;
+      for (i = header.mapObsTypes.begin(); i != header.mapObsTypes.end(); i++)
+      {
+         if (i->first.length() == 1)
+         {
+            numObsForSys[static_cast<unsigned char>(i->first[0])] =
+               i->second.size();
+         }
+      }
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   nextLine(const char*& line, size_t& len, bool expectEOF)
+   {
+      const char *buf = file.data();
+      size_t size = file.size();
+      if (pos >= size)
+      {
+         if (expectEOF)
+            return false;
+         FFStreamError err("Unexpected EOF encountered");
+         GPSTK_THROW(err);
+      }
+      line = buf + pos;
+      const char *eol = static_cast<const char*>(
+         memchr(line, '\n', size - pos));
+      if (eol == nullptr)
+      {
+         len = size - pos;
+         pos = size;
+      }
+      else
+      {
+         len = eol - line;
+         pos += len + 1;
+      }
+         // Remove CR characters left over from windows files
+      while (len > 0 && line[len-1] == '\r')
+         len--;
+      lineNumber++;
+      for (size_t i = 0; i < len; i++)
+      {
+         if (!isprint(static_cast<unsigned char>(line[i])))
+         {
+            FFStreamError err("Non-text data in file.");
+            GPSTK_THROW(err);
+         }
+      }
+      return true;
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   getRecord(Rinex3ObsData& rod)
+   {
+      size_t initialPos = pos;
+      unsigned long initialLineNumber = lineNumber;
+      try
+      {
+         return decodeRecord(rod);
+      }
+      catch (Exception& exc)
+      {
+         FFStreamError err(exc);
+         err.addText(std::string("Near file line ") +
+                     StringUtils::asString(lineNumber));
+         pos = initialPos;
+         lineNumber = initialLineNumber;
+         GPSTK_THROW(err);
+      }
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   decodeRecord(Rinex3ObsData& rod)
+   {
+      LineView line;
+      if (!nextLine(line.ptr, line.len, true))
+         return false;
+
+      rod.time = CommonTime::BEGINNING_OF_TIME;
+      rod.clockOffset = 0.;
+      rod.auxHeader.clear();
+
+         // Check and parse the epoch line -----------------------------------
+         // Check for epoch marker ('>') and following space.
+      if (line.len < 2 || line.ptr[0] != '>' || line.ptr[1] != ' ')
+      {
+         FFStreamError e("Bad epoch line: >" + std::string(line.ptr, line.len)
+                         + "<");
+         GPSTK_THROW(e);
+      }
+
+      rod.epochFlag = fieldInt(line, 31, 1);
+      if (rod.epochFlag < 0 || rod.epochFlag > 6)
+      {
+         FFStreamError e("Invalid epoch flag: " +
+                         StringUtils::asString(rod.epochFlag));
+         GPSTK_THROW(e);
+      }
+
+         // same checks and decoding as Rinex3ObsData::parseTime
+      if ((line.at(1) != ' ') || (line.at(6) != ' ') || (line.at(9) != ' ') ||
+          (line.at(12) != ' ') || (line.at(15) != ' ') ||
+          (line.at(18) != ' ') || (line.at(29) != ' ') || (line.at(30) != ' '))
+      {
+         FFStreamError e("Invalid time format");
+         GPSTK_THROW(e);
+      }
+      if (!line.blank(2, 27))
+      {
+         int year  = fieldInt(line, 2, 4);
+         int month = fieldInt(line, 7, 2);
+         int day   = fieldInt(line, 10, 2);
+         int hour  = fieldInt(line, 13, 2);
+         int min   = fieldInt(line, 16, 2);
+         double sec = fieldDouble(line, 19, 11);
+            // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
+         double ds = 0;
+         if (sec >= 60.)
+         {
+            ds = sec;
+            sec = 0.0;
+         }
+         rod.time = CivilTime(year,month,day,hour,min,sec).convertToCommonTime();
+         if (ds != 0)
+            rod.time += ds;
+         rod.time.setTimeSystem(timesystem);
+      }
+
+      rod.numSVs = fieldInt(line, 32, 3);
+
+      if (line.strippedLength() > 41)
+         rod.clockOffset = fieldDouble(line, 41, 15);
+
+         // Read the observations: SV ID and data ----------------------------
+      if (rod.epochFlag == 0 || rod.epochFlag == 1 || rod.epochFlag == 6)
+      {
+         epochSats.clear();
+         RinexSatID sat;
+         for (int isv = 0; isv < rod.numSVs; isv++)
+         {
+            nextLine(line.ptr, line.len, false);
+            fieldSat(line, 0, sat);
+            int size = numObsForSys[static_cast<unsigned char>(
+                                       sat.systemChar())];
+               // Reuse the vector from the previous epoch if the
+               // satellite is still there.
+            std::vector<RinexDatum>& data = rod.obs[sat];
+            data.resize(size);
+            for (int i = 0; i < size; i++)
+            {
+               fieldDatum(line, 3 + 16*i, data[i]);
+            }
+            epochSats.push_back(sat);
+         }
+            // Remove satellites carried over from a previous epoch.
+            // The map size alone can not tell, as a satellite may be
+            // listed twice in an epoch.
+         std::sort(epochSats.begin(), epochSats.end());
+         Rinex3ObsData::DataMap::iterator oi = rod.obs.begin();
+         while (oi != rod.obs.end())
+         {
+            if (std::binary_search(epochSats.begin(), epochSats.end(),
+                                   oi->first))
+               ++oi;
+            else
+               rod.obs.erase(oi++);
+         }
+      }
+         // ... or the auxiliary header information
+      else
+      {
+         rod.obs.clear();
+         for (int i = 0; i < rod.numSVs; i++)
+         {
+            nextLine(line.ptr, line.len, false);
+            std::string hline(line.ptr, line.strippedLength());
+            rod.auxHeader.parseHeaderRecord(hline);
+         }
+      }
+
+      return true;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,166 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+/**
+ * @file Rinex3ObsMappedReader.hpp
+ * Memory-mapped reader for RINEX 3 observation files.
+ */
+
+#ifndef GPSTK_RINEX3OBSMAPPEDREADER_HPP
+#define GPSTK_RINEX3OBSMAPPEDREADER_HPP
+
+#include <string>
+#include <vector>
+
+#include "MemoryMappedFile.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads RINEX 3 observation files by mapping the
+       * whole file into memory and decoding the fixed-width fields
+       * in place, rather than copying each line into a std::string
+       * and each field into a substring as Rinex3ObsStream does.
+       * The records produced are identical to those produced by
+       * reading the same file through Rinex3ObsStream.
+       *
+       * The header is decoded with the usual Rinex3ObsHeader code;
+       * only the epoch records use the in-place decoder.  When the
+       * same Rinex3ObsData object is passed to successive calls of
+       * getRecord(), the storage for satellites that remain in
+       * view is reused, so steady-state reading does not allocate.
+       *
+       * Only RINEX version 3 files are supported; use
+       * Rinex3ObsStream for RINEX 2.
+       *
+       * @code
+       * Rinex3ObsMappedReader rdr("file.15o");
+       * Rinex3ObsData rod;
+       * while (rdr.getRecord(rod))
+       * {
+       *    ...
+       * }
+       * @endcode
+       *
+       * @sa Rinex3ObsStream, Rinex3ObsData and Rinex3ObsHeader.
+       */
+   class Rinex3ObsMappedReader
+   {
+   public:
+         /// Create a reader not associated with any file.
+      Rinex3ObsMappedReader();
+
+         /** Open the RINEX 3 observation file \a fn and read its header.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header is invalid or the
+          *   file is not RINEX version 3. */
+      explicit Rinex3ObsMappedReader(const std::string& fn);
+
+         /** Open the RINEX 3 observation file \a fn and read its
+          * header, releasing any file currently open.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header is invalid or the
+          *   file is not RINEX version 3. */
+      void open(const std::string& fn);
+
+         /// Release the file.
+      void close();
+
+         /** Decode the next epoch record into \a rod.
+          * @param[out] rod The record to fill in.
+          * @return true if a record was decoded, false at the end
+          *   of the file.
+          * @throw FFStreamError if the record is malformed.  The
+          *   reader is left positioned at the start of the offending
+          *   record. */
+      bool getRecord(Rinex3ObsData& rod);
+
+         /// Go back to the first epoch record following the header.
+      void rewind();
+
+         /// Line number of the most recently decoded line (1 based).
+      unsigned long getLineNumber() const
+      { return lineNumber; }
+
+         /// The header for this file.
+      Rinex3ObsHeader header;
+
+         /// Time system for epochs in this file
+      TimeSystem timesystem;
+
+   private:
+         /// Set up the per-system tables after reading the header.
+      void initTables();
+
+         /** Find the next line in the buffer, advancing pos.
+          * @param[out] line Start of the line.
+          * @param[out] len Length of the line, excluding line ending.
+          * @param[in] expectEOF If true, return false at EOF,
+          *   otherwise throw.
+          * @return false at EOF when expectEOF is true.
+          * @throw FFStreamError on non-text data or unexpected EOF. */
+      bool nextLine(const char*& line, size_t& len, bool expectEOF);
+
+         /// Do the actual record decoding for getRecord.
+      bool decodeRecord(Rinex3ObsData& rod);
+
+         /// The file contents.
+      MemoryMappedFile file;
+         /// Offset of the first epoch record in file.
+      size_t dataStart;
+         /// Offset of the next unread line in file.
+      size_t pos;
+         /// Line number of the most recently decoded line.
+      unsigned long lineNumber;
+         /// Line number of the last line of the header.
+      unsigned long headerLines;
+         /// Number of observations per satellite, indexed by system char.
+      std::vector<int> numObsForSys;
+         /// Satellites seen in the current epoch (reused storage).
+      std::vector<RinexSatID> epochSats;
+   }; // class Rinex3ObsMappedReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_RINEX3OBSMAPPEDREADER_HPP
@@ -90,6 +90,7 @@ namespace gpstk
       headerRead = false;
       header = Rinex3ObsHeader();
       timesystem = TimeSystem::GPS;
+      previousTime = CommonTime::BEGINNING_OF_TIME;
    }
 
 
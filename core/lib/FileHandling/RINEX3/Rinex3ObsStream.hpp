@@ -112,6 +112,10 @@ namespace gpstk
          /// Time system for epochs in this file
       TimeSystem timesystem;
 
+         /** Time of the last RINEX 2 epoch read with an epoch time,
+          * used for records with epoch flag 2-4 that have none. */
+      CommonTime previousTime;
+
          /// Check if the input stream is the kind of Rinex3ObsStream
       static bool isRinex3ObsStream(std::istream& i);
 
@@ -65,39 +65,36 @@ namespace gpstk
    void RinexDatum ::
    fromString(const std::string& str)
    {
-      std::string tmpStr;
       GPSTK_ASSERT(str.length() == 16);
-      tmpStr = str.substr(0, 14);
-      if (tmpStr.find_last_not_of(" ") == std::string::npos)
+      const char *field = str.data();
+      if (StringUtils::isBlank(field, 14))
       {
          data = 0.;
          dataBlank = true;
       }
       else
       {
-         data = StringUtils::asDouble(tmpStr);
+         data = StringUtils::asDouble(field, 14);
          dataBlank = false;
       }
-      tmpStr = str.substr(14, 1);
-      if (tmpStr == " ")
+      if (field[14] == ' ')
       {
          lli = 0.;
          lliBlank = true;
       }
       else
       {
-         lli = StringUtils::asInt(tmpStr);
+         lli = StringUtils::asInt(field+14, 1);
          lliBlank = false;
       }
-      tmpStr = str.substr(15, 1);
-      if (tmpStr == " ")
+      if (field[15] == ' ')
       {
          ssi = 0.;
          ssiBlank = true;
       }
       else
       {
-         ssi = StringUtils::asInt(tmpStr);
+         ssi = StringUtils::asInt(field+15, 1);
          ssiBlank = false;
       }
    }
@@ -107,34 +104,40 @@ namespace gpstk
    asString() const
    {
       std::string rv;
-      using gpstk::StringUtils::rightJustify;
+      rv.reserve(16);
+      appendTo(rv);
+      return rv;
+   } // asString() const
 
+
+   void RinexDatum ::
+   appendTo(std::string& line) const
+   {
       if (!dataBlank)
       {
             // double 14.3
-         rv += rightJustify(gpstk::StringUtils::asString(data, 3), 14);
+         StringUtils::appendFixed(line, data, 3, 14);
       }
       else
       {
-         rv += std::string(14, ' ');
+         line.append(14, ' ');
       }
       if ((lli != 0) || !lliBlank)
       {
-         rv += rightJustify(gpstk::StringUtils::asString<short>(lli),1);
+         StringUtils::appendInt(line, lli, 1);
       }
       else
       {
-         rv += " ";
+         line += ' ';
       }
       if ((ssi != 0) || !ssiBlank)
       {
-         rv += rightJustify(gpstk::StringUtils::asString<short>(ssi),1);
+         StringUtils::appendInt(line, ssi, 1);
       }
       else
       {
-         rv += " ";
+         line += ' ';
       }
-      return rv;
-   } // asString() const
+   } // appendTo()
 
 } // namespace gpstk
@@ -73,6 +73,11 @@ namespace gpstk
          /// Turn this datum into a RINEX OBS formatted string
       std::string asString() const;
 
+         /** Append this datum, formatted as by asString(), to a line
+          * being built, without making a string for the datum.
+          * @param[in,out] line the line to append the 16 characters to. */
+      void appendTo(std::string& line) const;
+
       double data;    ///< The actual data point.
       bool dataBlank; ///< True if the data is blank in the file
       short lli;      ///< See the RINEX Spec. for an explanation.
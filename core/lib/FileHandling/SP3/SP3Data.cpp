@@ -158,12 +158,12 @@ namespace gpstk
 
             // parse the epoch line
             RecType = strm.lastLine[0];
-            int year = asInt(strm.lastLine.substr(3,4));
-            int month = asInt(strm.lastLine.substr(8,2));
-            int dom = asInt(strm.lastLine.substr(11,2));
-            int hour = asInt(strm.lastLine.substr(14,2));
-            int minute = asInt(strm.lastLine.substr(17,2));
-            double second = asInt(strm.lastLine.substr(20,10));
+            int year = asInt(strm.lastLine, 3, 4);
+            int month = asInt(strm.lastLine, 8, 2);
+            int dom = asInt(strm.lastLine, 11, 2);
+            int hour = asInt(strm.lastLine, 14, 2);
+            int minute = asInt(strm.lastLine, 17, 2);
+            double second = asInt(strm.lastLine, 20, 10);
             CivilTime t;
             try {
                t = CivilTime(year, month, dom, hour, minute, second, timeSystem);
@@ -202,10 +202,10 @@ namespace gpstk
             // parse the line
             sat = static_cast<SatID>(SP3SatID(strm.lastLine.substr(1,3)));
 
-            x[0] = asDouble(strm.lastLine.substr(4,14));             // XYZ
-            x[1] = asDouble(strm.lastLine.substr(18,14));
-            x[2] = asDouble(strm.lastLine.substr(32,14));
-            clk = asDouble(strm.lastLine.substr(46,14));             // Clock
+            x[0] = asDouble(strm.lastLine, 4, 14);             // XYZ
+            x[1] = asDouble(strm.lastLine, 18, 14);
+            x[2] = asDouble(strm.lastLine, 32, 14);
+            clk = asDouble(strm.lastLine, 46, 14);             // Clock
 
             // handle NGA extension to SP3a - the event flag
             eventFlag = false;
@@ -219,10 +219,10 @@ namespace gpstk
 
             // the rest is version c only
             if(isVerC) {
-               sig[0] = asInt(strm.lastLine.substr(61,2));           // sigma XYZ
-               sig[1] = asInt(strm.lastLine.substr(64,2));
-               sig[2] = asInt(strm.lastLine.substr(67,2));
-               sig[3] = asInt(strm.lastLine.substr(70,3));           // sigma clock
+               sig[0] = asInt(strm.lastLine, 61, 2);           // sigma XYZ
+               sig[1] = asInt(strm.lastLine, 64, 2);
+               sig[2] = asInt(strm.lastLine, 67, 2);
+               sig[3] = asInt(strm.lastLine, 70, 3);           // sigma clock
 
                if(RecType == 'P') {                                  // P flags
                   clockEventFlag = clockPredFlag
@@ -257,16 +257,16 @@ namespace gpstk
             }
 
             // parse the line
-            sdev[0] = abs(asInt(strm.lastLine.substr(4,4)));
-            sdev[1] = abs(asInt(strm.lastLine.substr(9,4)));
-            sdev[2] = abs(asInt(strm.lastLine.substr(14,4)));
-            sdev[3] = abs(asInt(strm.lastLine.substr(19,7)));
-            correlation[0] = asInt(strm.lastLine.substr(27,8));
-            correlation[1] = asInt(strm.lastLine.substr(36,8));
-            correlation[2] = asInt(strm.lastLine.substr(45,8));
-            correlation[3] = asInt(strm.lastLine.substr(54,8));
-            correlation[4] = asInt(strm.lastLine.substr(63,8));
-            correlation[5] = asInt(strm.lastLine.substr(72,8));
+            sdev[0] = abs(asInt(strm.lastLine, 4, 4));
+            sdev[1] = abs(asInt(strm.lastLine, 9, 4));
+            sdev[2] = abs(asInt(strm.lastLine, 14, 4));
+            sdev[3] = abs(asInt(strm.lastLine, 19, 7));
+            correlation[0] = asInt(strm.lastLine, 27, 8);
+            correlation[1] = asInt(strm.lastLine, 36, 8);
+            correlation[2] = asInt(strm.lastLine, 45, 8);
+            correlation[3] = asInt(strm.lastLine, 54, 8);
+            correlation[4] = asInt(strm.lastLine, 63, 8);
+            correlation[5] = asInt(strm.lastLine, 72, 8);
 
             // tell the caller that correlation data is now present
             correlationFlag = true;
@@ -335,9 +335,18 @@ namespace gpstk
       // output Epoch Header Record
       if(RecType == '*') {
          CivilTime civTime(time);
-         line = "* ";
-         line += civTime.printf(" %4Y %2m %2d %2H %2M");
-         line += " " + rightJustify(civTime.printf("%.8f"),11);
+         line = "*  ";
+         appendInt(line, civTime.year, 4);
+         line += ' ';
+         appendInt(line, civTime.month, 2);
+         line += ' ';
+         appendInt(line, civTime.day, 2);
+         line += ' ';
+         appendInt(line, civTime.hour, 2);
+         line += ' ';
+         appendInt(line, civTime.minute, 2);
+         line += ' ';
+         appendFixed(line, civTime.second, 8, 11);
       }
 
       // output Position and Clock OR Velocity and Clock Rate Record
@@ -348,15 +357,15 @@ namespace gpstk
                FFStreamError fse("Cannot output non-GPS to SP3a");
                GPSTK_THROW(fse);
             }
-            line += rightJustify(asString(sat.id),3);
+            appendInt(line, sat.id, 3);
          }
          else
             line += static_cast<SP3SatID>(sat).toString();  // sat ID
 
-         line += rightJustify(asString(x[0],6),14);         // XYZ
-         line += rightJustify(asString(x[1],6),14);
-         line += rightJustify(asString(x[2],6),14);
-         line += rightJustify(asString(clk,6),14);          // Clock
+         appendFixed(line, x[0], 6, 14);                    // XYZ
+         appendFixed(line, x[1], 6, 14);
+         appendFixed(line, x[2], 6, 14);
+         appendFixed(line, clk, 6, 14);                     // Clock
 
          // handle NGA extension to SP3a
          if(isVerA && strm.header.allowSP3aEvents
@@ -367,10 +376,10 @@ namespace gpstk
          }
 
          if(isVerC) {
-            line += rightJustify(asString(sig[0]),3);       // sigma XYZ
-            line += rightJustify(asString(sig[1]),3);
-            line += rightJustify(asString(sig[2]),3);
-            line += rightJustify(asString(sig[3]),4);       // sigma Clock
+            appendInt(line, sig[0], 3);                     // sigma XYZ
+            appendInt(line, sig[1], 3);
+            appendInt(line, sig[2], 3);
+            appendInt(line, sig[3], 4);                     // sigma Clock
 
             if(RecType == 'P') {                            // flags or blanks
                line += string(" ");
@@ -395,12 +404,12 @@ namespace gpstk
                line = "EP ";
             else
                line = "EV ";
-            line += rightJustify(asString(sdev[0]),5);         // stddev X
-            line += rightJustify(asString(sdev[1]),5);         // stddev Y
-            line += rightJustify(asString(sdev[2]),5);         // stddev Z
-            line += rightJustify(asString(sdev[3]),8);         // stddev Clk
+            appendInt(line, sdev[0], 5);                       // stddev X
+            appendInt(line, sdev[1], 5);                       // stddev Y
+            appendInt(line, sdev[2], 5);                       // stddev Z
+            appendInt(line, sdev[3], 8);                       // stddev Clk
             for(int i=0; i<6; i++)                             // correlations
-               line += rightJustify(asString(correlation[i]),9);
+               appendInt(line, correlation[i], 9);
          }
       }
 
@@ -47,6 +47,7 @@
 
 #include <map>
 #include "CommonTime.hpp"
+#include "CommonTimeKey.hpp"
 #include "CarrierBand.hpp"
 #include "IonoModel.hpp"
 
@@ -119,7 +120,8 @@ namespace gpstk
    private:
 
 
-      typedef std::map<CommonTime, IonoModel> IonoModelMap;
+         /// Private, so keyed on the cheaper CommonTimeKey.
+      typedef std::map<CommonTimeKey, IonoModel> IonoModelMap;
 
       IonoModelMap ims;
 
@@ -48,6 +48,19 @@
 
 namespace gpstk
 {
+   namespace
+   {
+         // Look up a key in one of the static translation tables without
+         // inserting it, so that decoding never writes to the tables and
+         // files may be decoded concurrently.
+      template <class Key, class Value>
+      Value findOrDefault(const std::map<Key,Value>& table, const Key& key,
+                          const Value& dflt)
+      {
+         typename std::map<Key,Value>::const_iterator it(table.find(key));
+         return (it == table.end() ? dflt : it->second);
+      }
+   }
 
    // string containing the system characters for all valid RINEX systems.
    std::string RinexObsID::validRinexSystems("GRESCJI");
@@ -153,9 +166,9 @@ namespace gpstk
    {
       char buff[4];
 
-      buff[0] = ot2char[type];
-      buff[1] = cb2char[band];
-      buff[2] = tc2char[code];
+      buff[0] = findOrDefault(ot2char, type, '\0');
+      buff[1] = findOrDefault(cb2char, band, '\0');
+      buff[2] = findOrDefault(tc2char, code, '\0');
       if ((fabs(version - 3.02) < 0.005) && (band == CarrierBand::B1) &&
           ((code == TrackingCode::B1I) || (code == TrackingCode::B1Q) ||
            (code == TrackingCode::B1IQ)))
@@ -261,7 +274,13 @@ namespace gpstk
       char ot(strID[0]);
       char cb(strID[1]);
       char tc(strID[2]);
-      const std::string &codes(RinexObsID::validRinexTrackingCodes[sys][cb]);
+      std::string codes;
+      std::map<char, std::map<char, std::string> >::const_iterator sit(
+         RinexObsID::validRinexTrackingCodes.find(sys));
+      if(sit != RinexObsID::validRinexTrackingCodes.end())
+      {
+         codes = findOrDefault(sit->second, cb, std::string());
+      }
       if(ot == ' ' || ot == '-')
       {
          return false;
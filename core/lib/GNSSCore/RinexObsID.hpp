@@ -214,6 +214,9 @@ namespace gpstk
           * touched. If not then each character of the specification
           * is examined and the new ones are created. The returned
           * ObsID can then be examined for the assigned values.
+          * This is the only function that changes the static
+          * translation tables, which decoding only reads; it must not
+          * be called while files are being read in other threads.
           * @throw InvalidParameter */
       static RinexObsID newID(const std::string& id,
                               const std::string& desc="");
@@ -0,0 +1,133 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CRC24Q.cpp
+ * Table-driven CRC-24Q, as used by the GPS CNAV and CNAV-2 messages.
+ */
+
+#include "CRC24Q.hpp"
+
+namespace gpstk
+{
+      // The CRC register is held in the 24 most significant bits of a
+      // uint32_t, so that a whole byte or word lines up with it.
+   static const uint32_t POLY32 = CRC24Q::POLY << 8;
+
+      // tables for the CRC eight bytes at a time ("slicing by 8");
+      // entry[0] is the usual table for one byte, entry[k] is that
+      // byte followed by k zero bytes
+   static const struct CRC24QTable
+   {
+      CRC24QTable()
+      {
+         for (uint32_t i = 0; i < 256; i++)
+         {
+            uint32_t r = i << 24;
+            for (int k = 0; k < 8; k++)
+               r = (r & 0x80000000) ? ((r << 1) ^ POLY32) : (r << 1);
+            entry[0][i] = r;
+         }
+         for (uint32_t i = 0; i < 256; i++)
+            for (int k = 1; k < 8; k++)
+               entry[k][i] = (entry[k-1][i] << 8)
+                  ^ entry[0][entry[k-1][i] >> 24];
+      }
+      uint32_t entry[8][256];
+   } CRC24Q_TABLE;
+
+
+      // process 64 bits, most significant first
+   static inline uint32_t crcWord(uint32_t r, uint64_t w)
+   {
+      const uint32_t (*t)[256] = CRC24Q_TABLE.entry;
+      uint64_t v = (static_cast<uint64_t>(r) << 32) ^ w;
+      return t[7][v >> 56] ^ t[6][(v >> 48) & 0xff]
+         ^ t[5][(v >> 40) & 0xff] ^ t[4][(v >> 32) & 0xff]
+         ^ t[3][(v >> 24) & 0xff] ^ t[2][(v >> 16) & 0xff]
+         ^ t[1][(v >> 8) & 0xff] ^ t[0][v & 0xff];
+   }
+
+
+   static inline uint32_t crcByte(uint32_t r, uint8_t b)
+   {
+      return (r << 8) ^ CRC24Q_TABLE.entry[0][(r >> 24) ^ b];
+   }
+
+
+   uint32_t CRC24Q ::
+   compute(const uint8_t* data, std::size_t numBytes, uint32_t crc)
+   {
+      uint32_t r = crc << 8;
+      std::size_t i = 0;
+      for (; i + 8 <= numBytes; i += 8)
+      {
+         uint64_t w = 0;
+         for (int k = 0; k < 8; k++)
+            w = (w << 8) | data[i+k];
+         r = crcWord(r, w);
+      }
+      for (; i < numBytes; i++)
+         r = crcByte(r, data[i]);
+      return r >> 8;
+   }
+
+
+   uint32_t CRC24Q ::
+   computeBits(const uint64_t* words, std::size_t numBits, uint32_t crc)
+   {
+      uint32_t r = crc << 8;
+      std::size_t nWords = numBits / 64;
+      for (std::size_t i = 0; i < nWords; i++)
+         r = crcWord(r, words[i]);
+      unsigned rem = numBits % 64;
+      if (rem)
+      {
+         uint64_t w = words[nWords];
+         for (; rem >= 8; rem -= 8, w <<= 8)
+            r = crcByte(r, static_cast<uint8_t>(w >> 56));
+         for (; rem > 0; rem--, w <<= 1)
+         {
+            r ^= static_cast<uint32_t>(w >> 63) << 31;
+            r = (r & 0x80000000) ? ((r << 1) ^ POLY32) : (r << 1);
+         }
+      }
+      return r >> 8;
+   }
+
+} // namespace gpstk
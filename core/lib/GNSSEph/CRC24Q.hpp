@@ -0,0 +1,96 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CRC24Q.hpp
+ * Table-driven CRC-24Q, as used by the GPS CNAV and CNAV-2 messages.
+ */
+
+#ifndef GPSTK_CRC24Q_HPP
+#define GPSTK_CRC24Q_HPP
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace gpstk
+{
+      /// @ingroup ephemcalc
+      //@{
+
+      /** The CRC-24Q parity check of IS-GPS-200 section 20.3.5.2,
+       * also used by the CNAV messages of IS-GPS-705 and the CNAV-2
+       * messages of IS-GPS-800.  The generator polynomial is
+       * 0x1864cfb, the initial value is 0 and there is no final
+       * XOR, so the CRC of a message that includes its own parity
+       * bits is 0 when the parity is good.
+       *
+       * The CRC is computed eight bytes at a time by table lookup
+       * ("slicing by 8"), with any bits beyond the last whole byte
+       * done one at a time.  A CRC may be computed in pieces by
+       * passing the result of one call as crc to the next, as long
+       * as all but the last piece are a whole number of bytes. */
+   class CRC24Q
+   {
+   public:
+         /// The generator polynomial without its leading 1.
+      static const uint32_t POLY = 0x864cfb;
+
+         /** Compute the CRC of a byte array.
+          * @param[in] data The bytes, most significant bit first.
+          * @param[in] numBytes The number of bytes in data.
+          * @param[in] crc The CRC of any preceding data.
+          * @return The 24-bit CRC. */
+      static uint32_t compute(const uint8_t* data, std::size_t numBytes,
+                              uint32_t crc = 0);
+
+         /** Compute the CRC of the leading bits of an array of
+          * 64-bit words, as held by PackedNavBits.
+          * @param[in] words The bits, most significant bit of the
+          *   first word first.
+          * @param[in] numBits The number of bits to use.
+          * @param[in] crc The CRC of any preceding data.
+          * @return The 24-bit CRC. */
+      static uint32_t computeBits(const uint64_t* words, std::size_t numBits,
+                                  uint32_t crc = 0);
+   };
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_CRC24Q_HPP
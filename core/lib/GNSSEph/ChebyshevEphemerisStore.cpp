@@ -0,0 +1,925 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file ChebyshevEphemerisStore.cpp
+ * Store precise satellite orbits and clocks as piecewise Chebyshev
+ * polynomials fitted to SP3 and RINEX clock data. */
+
+#include <algorithm>
+#include <cmath>
+
+#include "GNSSconstants.hpp"
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
+#include "RinexSatID.hpp"
+#include "ChebyshevEphemerisStore.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   using namespace StringUtils;
+
+      // slack in seconds allowed at the ends of a segment
+   static const double SEGMENT_SLACK = 1.e-6;
+
+      // fraction of the error bound to be met on the check grid, as
+      // the error may peak between the points of the grid
+   static const double GRID_MARGIN = 0.9;
+
+
+   ChebyshevEphemerisStore ::
+   ChebyshevEphemerisStore() throw()
+         : timeSystem(TimeSystem::Any), span(14400.0), minSpan(60.0),
+           maxDegree(16), posTol(0.001), clkTol(1.e-11),
+           maxPosErr(0.0), maxClkErr(0.0)
+   {
+      onlyHealthy = false;
+   }
+
+
+   CommonTime ChebyshevEphemerisStore ::
+   blockStart(long j) const
+   {
+      return CommonTime::BEGINNING_OF_TIME + j*span;
+   }
+
+
+   long ChebyshevEphemerisStore ::
+   blockIndex(const CommonTime& t, double& dt) const
+   {
+      long j(static_cast<long>(
+                std::floor((t - CommonTime::BEGINNING_OF_TIME)/span)));
+         // the division is not exact; the difference is
+      dt = t - blockStart(j);
+      if(dt < 0.0)
+      {
+         j--;
+         dt += span;
+      }
+      else if(dt >= span)
+      {
+         j++;
+         dt -= span;
+      }
+      return j;
+   }
+
+
+   const ChebyshevEphemerisStore::Block* ChebyshevEphemerisStore ::
+   findBlock(const SatTable& table, const CommonTime& t, double& dt) const
+   {
+      long j(blockIndex(t, dt));
+      if(j < table.first || j >= table.first + long(table.blocks.size()))
+         return 0;
+      return &table.blocks[j - table.first];
+   }
+
+
+   bool ChebyshevEphemerisStore ::
+   evaluate(const vector<Segment>& segs, double dt, int ncomp,
+            double *val, double *der)
+   {
+      const Segment *seg(0);
+      for(size_t k=0; k<segs.size(); k++)
+      {
+         if(dt >= segs[k].begin - SEGMENT_SLACK &&
+            dt <= segs[k].end + SEGMENT_SLACK)
+         {
+            seg = &segs[k];
+            break;
+         }
+      }
+      if(!seg)
+         return false;
+
+         // normalized time
+      const double len(seg->end - seg->begin);
+      double T((2.0*dt - seg->begin - seg->end)/len);
+      if(T < -1.0) T = -1.0;
+      if(T > 1.0) T = 1.0;
+
+         // the Chebyshevs and their derivatives
+      const int N(seg->coef.size()/ncomp);
+      double C[MAX_DEGREE+1], U[MAX_DEGREE+1];
+      C[0] = 1; U[0] = 0;
+      if(N > 1)
+      {
+         C[1] = T; U[1] = 1;
+      }
+      for(int j=2; j<N; j++)
+      {
+         C[j] = 2*T*C[j-1] - C[j-2];
+         U[j] = 2*T*U[j-1] + 2*C[j-1] - U[j-2];
+      }
+
+      for(int i=0; i<ncomp; i++)
+      {
+         const double *c(&seg->coef[i*N]);
+         val[i] = der[i] = 0.0;
+         for(int j=N-1; j>-1; j--)
+            val[i] += c[j] * C[j];
+         for(int j=N-1; j>0; j--)
+            der[i] += c[j] * U[j];
+         der[i] *= 2.0/len;             // per second
+      }
+
+      return true;
+   }
+
+
+   Xvt ChebyshevEphemerisStore ::
+   compute(const SatID& sat, const CommonTime& t, string& why) const
+   {
+      Xvt rv;
+      rv.health = Xvt::HealthStatus::Unavailable;
+
+      if(timeSystem != TimeSystem::Any &&
+         t.getTimeSystem() != TimeSystem::Any &&
+         t.getTimeSystem() != timeSystem)
+      {
+         why = "Time system " + asString(t.getTimeSystem())
+            + " does not match the store, " + asString(timeSystem);
+         return rv;
+      }
+
+      map<SatID, SatTable>::const_iterator it(tables.find(sat));
+      if(it == tables.end())
+      {
+         why = "Satellite is not in the store";
+         return rv;
+      }
+
+      double dt, pos[3], vel[3], bias, drift;
+      const Block *block(findBlock(it->second, t, dt));
+      if(!block || !evaluate(block->pos, dt, 3, pos, vel))
+      {
+         why = "No position";
+         return rv;
+      }
+      if(!evaluate(block->clk, dt, 1, &bias, &drift))
+      {
+         why = "No clock";
+         return rv;
+      }
+
+      for(int i=0; i<3; i++)
+      {
+         rv.x[i] = pos[i];
+         rv.v[i] = vel[i];
+      }
+      rv.clkbias = bias;
+      rv.clkdrift = drift;
+      rv.computeRelativityCorrection();
+      rv.health = Xvt::HealthStatus::Unused;
+
+      return rv;
+   }
+
+
+   Xvt ChebyshevEphemerisStore ::
+   getXvt(const SatID& sat, const CommonTime& t) const
+   {
+      string why;
+      Xvt rv(compute(sat, t, why));
+      if(rv.health == Xvt::HealthStatus::Unavailable)
+      {
+         InvalidRequest ir(why + " for satellite " + asString(sat) + " at "
+                           + printTime(t, "%Y/%02m/%02d %02H:%02M:%02S %P"));
+         GPSTK_THROW(ir);
+      }
+      return rv;
+   }
+
+
+   Xvt ChebyshevEphemerisStore ::
+   computeXvt(const SatID& sat, const CommonTime& t) const throw()
+   {
+      Xvt rv;
+      rv.health = Xvt::HealthStatus::Unavailable;
+      try
+      {
+         string why;
+         rv = compute(sat, t, why);
+      }
+      catch(...)
+      {
+         rv = Xvt();
+         rv.health = Xvt::HealthStatus::Unavailable;
+      }
+      return rv;
+   }
+
+
+   Xvt::HealthStatus ChebyshevEphemerisStore ::
+   getSVHealth(const SatID& sat, const CommonTime& t) const throw()
+   {
+      return computeXvt(sat, t).health;
+   }
+
+
+   bool ChebyshevEphemerisStore ::
+   sample(const SP3EphemerisStore& store, const SatID& sat, bool clock,
+          const CommonTime& t, double *val)
+   {
+      try
+      {
+         if(clock)
+         {
+            ClockRecord rec(store.getClockStore().getValue(sat, t));
+               // microseconds in SP3, seconds in RINEX clock
+            val[0] = rec.bias * (store.usingSP3ClockData() ? 1.e-6 : 1.0);
+         }
+         else
+         {
+            PositionRecord rec(store.getPositionStore().getValue(sat, t));
+            for(int i=0; i<3; i++)
+               val[i] = rec.Pos[i] * 1000.0;  // km -> m
+         }
+      }
+      catch(Exception& e)
+      {
+         return false;
+      }
+      return true;
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   fitRange(const SP3EphemerisStore& store, const SatID& sat, bool clock,
+            const CommonTime& t0, double epoch, double step, double a,
+            double b, vector<Segment>& segs)
+   {
+      const int ncomp(clock ? 1 : 3);
+      const int N(maxDegree+1);
+      const double tol(clock ? clkTol : posTol);
+      const double mid(0.5*(a+b)), half(0.5*(b-a));
+      double f[MAX_DEGREE+1][3], c[3][MAX_DEGREE+1];
+      double err(0.0);
+      int i, j, k, n(N);
+
+         // the store interpolates with a different polynomial between
+         // each pair of tabulated times, so split at the tabulated time
+         // nearest the middle, if there is one in the range
+      double split(mid);
+      if(step > 0.0)
+      {
+         double e(epoch + step*std::floor((mid-epoch)/step + 0.5));
+         if(e > a + SEGMENT_SLACK && e < b - SEGMENT_SLACK)
+            split = e;
+      }
+
+         // sample at the Chebyshev nodes
+      bool ok(true);
+      for(k=0; ok && k<N; k++)
+      {
+         double x(std::cos(PI*(k+0.5)/N));
+         ok = sample(store, sat, clock, t0 + (mid + half*x), f[k]);
+      }
+
+      if(ok)
+      {
+            // coefficients of the interpolating series
+         for(i=0; i<ncomp; i++)
+         {
+            for(j=0; j<N; j++)
+            {
+               double sum(0.0);
+               for(k=0; k<N; k++)
+                  sum += f[k][i] * std::cos(PI*j*(k+0.5)/N);
+               c[i][j] = 2.0*sum/N;
+            }
+            c[i][0] *= 0.5;
+         }
+
+            // drop the terms whose total size is well within the bound
+         double tail[3] = { 0.0, 0.0, 0.0 };
+         while(n > 1)
+         {
+            bool small(true);
+            for(i=0; i<ncomp; i++)
+               if(tail[i] + std::abs(c[i][n-1]) > 0.25*tol/ncomp)
+                  small = false;
+            if(!small)
+               break;
+            for(i=0; i<ncomp; i++)
+               tail[i] += std::abs(c[i][n-1]);
+            n--;
+         }
+
+            // check the truncated series on a grid finer than the nodes,
+            // and at the tabulated times, where the store changes
+            // polynomial and the error peaks
+         Segment seg;
+         seg.begin = a;
+         seg.end = b;
+         seg.coef.resize(ncomp*n);
+         for(i=0; i<ncomp; i++)
+            for(j=0; j<n; j++)
+               seg.coef[i*n+j] = c[i][j];
+         vector<Segment> one(1, seg);
+         const int M(4*N);
+         vector<double> checks;
+         for(k=0; k<=M; k++)
+            checks.push_back(a + (b-a)*k/M);
+         if(step > 0.0)
+         {
+            double e(epoch + step*std::ceil((a-epoch)/step));
+            for( ; e < b; e += step)
+               checks.push_back(e);
+         }
+         for(k=0; ok && k<int(checks.size()); k++)
+         {
+            double dt(checks[k]);
+            double truth[3], val[3], der[3], sum(0.0);
+            ok = sample(store, sat, clock, t0 + dt, truth);
+            if(!ok)
+               break;
+            evaluate(one, dt, ncomp, val, der);
+            for(i=0; i<ncomp; i++)
+               sum += (val[i]-truth[i])*(val[i]-truth[i]);
+            err = std::max(err, std::sqrt(sum));
+         }
+
+            // accept it, if it is good or splitting will not help
+         if(ok && (err <= GRID_MARGIN*tol || half < minSpan))
+         {
+            double& maxErr(clock ? maxClkErr : maxPosErr);
+            maxErr = std::max(maxErr, err);
+            segs.push_back(seg);
+            return;
+         }
+      }
+
+         // split it, or drop it where the store can not be sampled
+      if(half < minSpan)
+         return;
+      fitRange(store, sat, clock, t0, epoch, step, a, split, segs);
+      fitRange(store, sat, clock, t0, epoch, step, split, b, segs);
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   trimEnd(const SP3EphemerisStore& store, const SatID& sat, bool clock,
+           CommonTime& t, const CommonTime& limit, double step) const
+   {
+         // probe just off t, since the store returns a record exactly
+         // at its time even where it cannot interpolate
+      const double eps(step > 0.0 ? 1.e-3 : -1.e-3);
+      double val[3], lo(eps), hi(eps + step), len(std::abs(limit - t));
+      if(sample(store, sat, clock, t + eps, val))
+         return;
+
+         // step toward the limit until it can, then bisect the step
+         // down to the probe offset
+      while(std::abs(hi) < len && !sample(store, sat, clock, t + hi, val))
+      {
+         lo = hi;
+         hi += step;
+      }
+      if(std::abs(hi) >= len)
+         return;                 // leave it to fitRange()
+      while(std::abs(hi - lo) > std::abs(eps))
+      {
+         double mid(0.5*(lo + hi));
+         if(sample(store, sat, clock, t + mid, val))
+            hi = mid;
+         else
+            lo = mid;
+      }
+      t += hi;
+   }
+
+
+   ChebyshevEphemerisStore::Segment ChebyshevEphemerisStore ::
+   subSegment(const Segment& seg, int ncomp, double a, double b)
+   {
+         // interpolate the polynomial at as many nodes as it has terms,
+         // which reproduces it
+      const int n(seg.coef.size()/ncomp);
+      const double mid(0.5*(a+b)), half(0.5*(b-a));
+      const vector<Segment> one(1, seg);
+      double f[MAX_DEGREE+1][3], der[3];
+      int i, j, k;
+      for(k=0; k<n; k++)
+         evaluate(one, mid + half*std::cos(PI*(k+0.5)/n), ncomp, f[k], der);
+
+      Segment part;
+      part.begin = a;
+      part.end = b;
+      part.coef.resize(ncomp*n);
+      for(i=0; i<ncomp; i++)
+      {
+         for(j=0; j<n; j++)
+         {
+            double sum(0.0);
+            for(k=0; k<n; k++)
+               sum += f[k][i] * std::cos(PI*j*(k+0.5)/n);
+            part.coef[i*n+j] = 2.0*sum/n;
+         }
+         part.coef[i*n] *= 0.5;
+      }
+      return part;
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   fitSat(const SP3EphemerisStore& store, const SatID& sat, bool clock,
+          const CommonTime& tmin, const CommonTime& tmax)
+   {
+      const int ncomp(clock ? 1 : 3);
+      CommonTime tb, te, epoch;
+      try
+      {
+         tb = (clock ? store.getClockInitialTime(sat)
+                     : store.getPositionInitialTime(sat));
+         te = (clock ? store.getClockFinalTime(sat)
+                     : store.getPositionFinalTime(sat));
+         epoch = tb;
+      }
+      catch(InvalidRequest& e)
+      {
+         return;
+      }
+      if(tb < tmin) tb = tmin;
+      if(te > tmax) te = tmax;
+      if(te <= tb)
+         return;
+
+         // the store cannot interpolate near the ends of its data;
+         // find where it can, so that the fit need not split there
+      double step(clock ? store.getClockTimeStep(sat)
+                        : store.getPositionTimeStep(sat));
+      if(!(step > 0.0))
+         step = 0.0;
+      trimEnd(store, sat, clock, tb, te, std::max(step, minSpan));
+      trimEnd(store, sat, clock, te, tb, -std::max(step, minSpan));
+      if(te <= tb)
+         return;
+
+         // the blocks containing tb and te
+      double dt;
+      long j0(blockIndex(tb, dt)), j1(blockIndex(te, dt));
+
+         // make room for the blocks
+      map<SatID, SatTable>::iterator it(tables.find(sat));
+      if(it == tables.end())
+      {
+         SatTable table;
+         table.first = j0;
+         it = tables.insert(make_pair(sat, table)).first;
+      }
+      SatTable& table(it->second);
+      if(table.blocks.empty())
+         table.first = j0;
+      if(j0 < table.first)
+      {
+         table.blocks.insert(table.blocks.begin(), table.first - j0, Block());
+         table.first = j0;
+      }
+      if(j1 >= table.first + long(table.blocks.size()))
+         table.blocks.resize(j1 - table.first + 1);
+
+      for(long j=j0; j<=j1; j++)
+      {
+         CommonTime t0(blockStart(j));
+         double lo(std::max(0.0, tb - t0)), hi(std::min(span, te - t0));
+         if(hi - lo < SEGMENT_SLACK)
+            continue;
+
+            // replace what is there in the range; a segment that is
+            // only partly in the range keeps the parts outside it, as
+            // the source may have no data there
+         Block& block(table.blocks[j - table.first]);
+         vector<Segment>& segs(clock ? block.clk : block.pos);
+         vector<Segment> keep;
+         for(size_t k=0; k<segs.size(); k++)
+         {
+            if(segs[k].end <= lo || segs[k].begin >= hi)
+               keep.push_back(segs[k]);
+            else
+            {
+               if(segs[k].begin < lo - SEGMENT_SLACK)
+                  keep.push_back(subSegment(segs[k], ncomp, segs[k].begin,
+                                             lo));
+               if(segs[k].end > hi + SEGMENT_SLACK)
+                  keep.push_back(subSegment(segs[k], ncomp, hi, segs[k].end));
+            }
+         }
+         fitRange(store, sat, clock, t0, epoch - t0, step, lo, hi, keep);
+         std::sort(keep.begin(), keep.end());
+         segs.swap(keep);
+      }
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   fit(const SP3EphemerisStore& store)
+   {
+      try
+      {
+         fit(store, CommonTime::BEGINNING_OF_TIME, CommonTime::END_OF_TIME);
+      }
+      catch(InvalidRequest& ir)
+      {
+         GPSTK_RETHROW(ir);
+      }
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   fit(const SP3EphemerisStore& store, const CommonTime& tmin,
+       const CommonTime& tmax)
+   {
+      if(!(posTol > 0.0) || !(clkTol > 0.0) || !(minSpan > 0.0))
+      {
+         InvalidRequest ir("Tolerances and minimum span must be positive");
+         GPSTK_THROW(ir);
+      }
+      if(!tables.empty() && store.getTimeSystem() != timeSystem)
+      {
+         InvalidRequest ir("Time system " + asString(store.getTimeSystem())
+                           + " does not match the store, "
+                           + asString(timeSystem));
+         GPSTK_THROW(ir);
+      }
+      timeSystem = store.getTimeSystem();
+
+      vector<SatID> posSats(store.getPositionStore().getSatList());
+      vector<SatID> clkSats(store.getClockStore().getSatList());
+      set<SatID> sats(posSats.begin(), posSats.end());
+      sats.insert(clkSats.begin(), clkSats.end());
+
+      for(set<SatID>::const_iterator it = sats.begin(); it != sats.end(); ++it)
+      {
+         fitSat(store, *it, false, tmin, tmax);
+         fitSat(store, *it, true, tmin, tmax);
+
+            // drop a satellite that could not be fitted at all
+         map<SatID, SatTable>::iterator jt(tables.find(*it));
+         if(jt != tables.end())
+         {
+            double dt;
+            long j;
+            if(!segmentTime(jt->second, false, false, dt, j) &&
+               !segmentTime(jt->second, true, false, dt, j))
+               tables.erase(jt);
+         }
+      }
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   loadFiles(const vector<string>& sp3Files, const vector<string>& clockFiles)
+   {
+      SP3EphemerisStore store;
+      store.setWindowCache(true);
+      try
+      {
+         if(!clockFiles.empty())
+            store.useRinexClockData();
+         for(size_t i=0; i<sp3Files.size(); i++)
+            store.loadSP3File(sp3Files[i]);
+         for(size_t i=0; i<clockFiles.size(); i++)
+            store.loadRinexClockFile(clockFiles[i]);
+         fit(store);
+      }
+      catch(Exception& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   setSpan(double seconds)
+   {
+      if(!(seconds > 0.0) || !tables.empty())
+      {
+         InvalidRequest ir("Span must be positive, and set before fitting");
+         GPSTK_THROW(ir);
+      }
+      span = seconds;
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   setMaxDegree(int degree)
+   {
+      if(degree < 1 || degree > MAX_DEGREE)
+      {
+         InvalidRequest ir("Degree must be between 1 and "
+                           + asString(MAX_DEGREE));
+         GPSTK_THROW(ir);
+      }
+      maxDegree = degree;
+   }
+
+
+   bool ChebyshevEphemerisStore ::
+   segmentTime(const SatTable& table, bool clock, bool last, double& dt,
+               long& j)
+   {
+      const size_t nb(table.blocks.size());
+      for(size_t k=0; k<nb; k++)
+      {
+         const Block& block(table.blocks[last ? nb-1-k : k]);
+         const vector<Segment>& segs(clock ? block.clk : block.pos);
+         if(segs.empty())
+            continue;
+         dt = (last ? segs.back().end : segs.front().begin);
+         j = table.first + (last ? nb-1-k : k);
+         return true;
+      }
+      return false;
+   }
+
+
+   CommonTime ChebyshevEphemerisStore ::
+   getInitialTime(const SatID& sat) const
+   {
+      map<SatID, SatTable>::const_iterator it(tables.find(sat));
+      double dtp, dtc;
+      long jp, jc;
+      if(it == tables.end() ||
+         !segmentTime(it->second, false, false, dtp, jp) ||
+         !segmentTime(it->second, true, false, dtc, jc))
+      {
+         InvalidRequest ir("No data for satellite " + asString(sat));
+         GPSTK_THROW(ir);
+      }
+      CommonTime tp(blockStart(jp) + dtp), tc(blockStart(jc) + dtc);
+      CommonTime rv(tp > tc ? tp : tc);
+      rv.setTimeSystem(timeSystem);
+      return rv;
+   }
+
+
+   CommonTime ChebyshevEphemerisStore ::
+   getFinalTime(const SatID& sat) const
+   {
+      map<SatID, SatTable>::const_iterator it(tables.find(sat));
+      double dtp, dtc;
+      long jp, jc;
+      if(it == tables.end() ||
+         !segmentTime(it->second, false, true, dtp, jp) ||
+         !segmentTime(it->second, true, true, dtc, jc))
+      {
+         InvalidRequest ir("No data for satellite " + asString(sat));
+         GPSTK_THROW(ir);
+      }
+      CommonTime tp(blockStart(jp) + dtp), tc(blockStart(jc) + dtc);
+      CommonTime rv(tp < tc ? tp : tc);
+      rv.setTimeSystem(timeSystem);
+      return rv;
+   }
+
+
+   CommonTime ChebyshevEphemerisStore ::
+   getInitialTime(void) const
+   {
+      CommonTime rv(CommonTime::END_OF_TIME);
+      map<SatID, SatTable>::const_iterator it;
+      for(it = tables.begin(); it != tables.end(); ++it)
+      {
+         try
+         {
+            CommonTime t(getInitialTime(it->first));
+            if(t < rv)
+               rv = t;
+         }
+         catch(InvalidRequest& ir)
+         {
+         }
+      }
+      if(rv == CommonTime::END_OF_TIME)
+      {
+         InvalidRequest ir("Store has no data");
+         GPSTK_THROW(ir);
+      }
+      return rv;
+   }
+
+
+   CommonTime ChebyshevEphemerisStore ::
+   getFinalTime(void) const
+   {
+      CommonTime rv(CommonTime::BEGINNING_OF_TIME);
+      map<SatID, SatTable>::const_iterator it;
+      for(it = tables.begin(); it != tables.end(); ++it)
+      {
+         try
+         {
+            CommonTime t(getFinalTime(it->first));
+            if(t > rv)
+               rv = t;
+         }
+         catch(InvalidRequest& ir)
+         {
+         }
+      }
+      if(rv == CommonTime::BEGINNING_OF_TIME)
+      {
+         InvalidRequest ir("Store has no data");
+         GPSTK_THROW(ir);
+      }
+      return rv;
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   edit(const CommonTime& tmin, const CommonTime& tmax)
+   {
+      map<SatID, SatTable>::iterator it(tables.begin());
+      while(it != tables.end())
+      {
+         SatTable& table(it->second);
+         for(size_t k=0; k<table.blocks.size(); k++)
+         {
+            CommonTime t0(blockStart(table.first + k));
+            double lo(tmin - t0), hi(tmax - t0);
+            for(int kind=0; kind<2; kind++)
+            {
+               vector<Segment>& segs(kind ? table.blocks[k].clk
+                                          : table.blocks[k].pos);
+               vector<Segment> keep;
+               for(size_t n=0; n<segs.size(); n++)
+               {
+                  if(segs[n].end >= lo && segs[n].begin <= hi)
+                     keep.push_back(segs[n]);
+               }
+               segs.swap(keep);
+            }
+         }
+
+            // trim empty blocks from the ends
+         while(!table.blocks.empty() && table.blocks.back().pos.empty() &&
+               table.blocks.back().clk.empty())
+            table.blocks.pop_back();
+         size_t n(0);
+         while(n < table.blocks.size() && table.blocks[n].pos.empty() &&
+               table.blocks[n].clk.empty())
+            n++;
+         table.blocks.erase(table.blocks.begin(), table.blocks.begin() + n);
+         table.first += n;
+
+         if(table.blocks.empty())
+            tables.erase(it++);
+         else
+            ++it;
+      }
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   clear(void) throw()
+   {
+      tables.clear();
+      timeSystem = TimeSystem::Any;
+      maxPosErr = maxClkErr = 0.0;
+   }
+
+
+   set<SatID> ChebyshevEphemerisStore ::
+   getIndexSet(void) const
+   {
+      set<SatID> rv;
+      map<SatID, SatTable>::const_iterator it;
+      for(it = tables.begin(); it != tables.end(); ++it)
+         rv.insert(it->first);
+      return rv;
+   }
+
+
+   unsigned long ChebyshevEphemerisStore ::
+   nsegments(void) const throw()
+   {
+      unsigned long rv(0);
+      map<SatID, SatTable>::const_iterator it;
+      for(it = tables.begin(); it != tables.end(); ++it)
+      {
+         for(size_t k=0; k<it->second.blocks.size(); k++)
+            rv += it->second.blocks[k].pos.size()
+               + it->second.blocks[k].clk.size();
+      }
+      return rv;
+   }
+
+
+   unsigned long ChebyshevEphemerisStore ::
+   ncoefficients(void) const throw()
+   {
+      unsigned long rv(0);
+      map<SatID, SatTable>::const_iterator it;
+      for(it = tables.begin(); it != tables.end(); ++it)
+      {
+         for(size_t k=0; k<it->second.blocks.size(); k++)
+         {
+            const Block& block(it->second.blocks[k]);
+            for(size_t n=0; n<block.pos.size(); n++)
+               rv += block.pos[n].coef.size();
+            for(size_t n=0; n<block.clk.size(); n++)
+               rv += block.clk[n].coef.size();
+         }
+      }
+      return rv;
+   }
+
+
+   void ChebyshevEphemerisStore ::
+   dump(ostream& os, short detail) const
+   {
+      static const string fmt("%Y/%02m/%02d %02H:%02M:%02S %P");
+      os << "Dump of ChebyshevEphemerisStore (detail level=" << detail
+         << "):\n";
+      os << " " << tables.size() << " satellites, " << nsegments()
+         << " segments, " << ncoefficients() << " coefficients" << endl;
+      os << " Blocks of " << span << " seconds, degree <= " << maxDegree
+         << ", segments >= " << minSpan << " seconds" << endl;
+      os << " Tolerance " << posTol << " m, " << clkTol
+         << " s; largest error " << maxPosErr << " m, " << maxClkErr
+         << " s" << endl;
+      if(tables.empty())
+         return;
+      try
+      {
+         os << " Data from " << printTime(getInitialTime(), fmt) << " to "
+            << printTime(getFinalTime(), fmt) << endl;
+      }
+      catch(InvalidRequest& ir)
+      {
+         os << " No satellite has both position and clock" << endl;
+      }
+      if(detail == 0)
+         return;
+
+      map<SatID, SatTable>::const_iterator it;
+      for(it = tables.begin(); it != tables.end(); ++it)
+      {
+         const SatTable& table(it->second);
+         unsigned long npos(0), nclk(0);
+         for(size_t k=0; k<table.blocks.size(); k++)
+         {
+            npos += table.blocks[k].pos.size();
+            nclk += table.blocks[k].clk.size();
+         }
+         os << "Sat " << RinexSatID(it->first) << " has " << npos
+            << " position and " << nclk << " clock segments in "
+            << table.blocks.size() << " blocks" << endl;
+         if(detail < 2)
+            continue;
+         for(size_t k=0; k<table.blocks.size(); k++)
+         {
+            CommonTime t0(blockStart(table.first + k));
+            t0.setTimeSystem(timeSystem);
+            for(int kind=0; kind<2; kind++)
+            {
+               const vector<Segment>& segs(kind ? table.blocks[k].clk
+                                                : table.blocks[k].pos);
+               for(size_t n=0; n<segs.size(); n++)
+                  os << "  " << (kind ? "clk " : "pos ")
+                     << printTime(t0 + segs[n].begin, fmt) << " to "
+                     << printTime(t0 + segs[n].end, fmt) << " "
+                     << segs[n].coef.size()/(kind ? 1 : 3) << " terms"
+                     << endl;
+            }
+         }
+      }
+   }
+
+}  // namespace gpstk
@@ -0,0 +1,408 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file ChebyshevEphemerisStore.hpp
+ * Store precise satellite orbits and clocks as piecewise Chebyshev
+ * polynomials fitted to SP3 and RINEX clock data. */
+
+#ifndef GPSTK_CHEBYSHEVEPHEMERISSTORE_INCLUDE
+#define GPSTK_CHEBYSHEVEPHEMERISSTORE_INCLUDE
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "Xvt.hpp"
+#include "XvtStore.hpp"
+#include "SP3EphemerisStore.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** A compact store of precise orbits and clocks, in which the
+       * position and clock bias of each satellite are represented by
+       * Chebyshev polynomial segments, in the manner of the JPL
+       * planetary ephemerides (cf. SolarSystemEphemeris), rather
+       * than by the tabulated records of SP3EphemerisStore.
+       *
+       * The polynomials are fitted to an SP3EphemerisStore by
+       * fit(), or to SP3 and RINEX clock files by loadFiles().
+       * Time is divided into blocks of fixed length (setSpan(),
+       * default 4 hours) on a grid common to all satellites.  In
+       * each block the store's interpolated position (clock) is
+       * sampled at the Chebyshev nodes of a polynomial of degree
+       * setMaxDegree(), the series is truncated to the fewest terms
+       * that meet the error bound setPositionTolerance()
+       * (setClockTolerance()), and the fit is checked against the
+       * store on a grid of four points per node and at the tabulated
+       * times, where it must be within 90% of the bound, since the
+       * error may peak between the points.  A fit that misses the
+       * bound is split in two at the tabulated time nearest its
+       * middle, since the store interpolates each tabulated interval
+       * with a different polynomial, or at its middle if it lies
+       * within one interval, down to setMinSpan() seconds; the
+       * largest error found is reported by getMaxPositionError()
+       * (getMaxClockError()).  Times at which
+       * the store cannot interpolate are excluded: the ends of the
+       * data, where it returns only the tabulated records, to within
+       * a millisecond, and data gaps to within setMinSpan() seconds.
+       *
+       * Evaluation finds the block by division and a segment among
+       * the few in the block, and sums one series for position and
+       * velocity (bias and drift) together, so its cost does not
+       * depend on the amount of data.  Velocity and clock drift are
+       * the derivatives of the position and clock polynomials.
+       * The store is smaller than an SP3EphemerisStore, but does
+       * not compress the data much: at the default bounds, a day of
+       * IGS rapid orbits and clocks, tabulated every 15 minutes,
+       * takes about 320 coefficients per satellite for position and
+       * 300 for clock, a quarter of the 96 records of 24 values
+       * (position, velocity, acceleration, clock and their sigmas)
+       * that SP3EphemerisStore holds, but more than the 4 values per
+       * record of the SP3 file.  The fit follows the store's
+       * interpolation, which changes polynomial at every tabulated
+       * time, so it needs several segments per block; looser bounds
+       * need far fewer coefficients.
+       *
+       * Position and clock are fitted separately, since clocks
+       * often come from RINEX clock files with a different interval
+       * and coverage.  Health is not available,
+       * as for SP3EphemerisStore.  The store is not changed by
+       * evaluation, so it may be read by many threads at once. */
+   class ChebyshevEphemerisStore : public XvtStore<SatID>
+   {
+   public:
+         /// The largest allowed degree of the polynomials
+      static const int MAX_DEGREE = 30;
+
+         /// Constructor; the store is empty.
+      ChebyshevEphemerisStore() throw();
+
+         /// Destructor
+      virtual ~ChebyshevEphemerisStore()
+      {}
+
+         /** Returns the position, velocity, and clock offset of the
+          * indicated satellite in ECEF coordinates (meters) at the
+          * indicated time.
+          * @param[in] sat the satellite of interest
+          * @param[in] t the time to look up
+          * @return the Xvt of the satellite at the indicated time
+          * @throw InvalidRequest if the time system of t is not
+          *   that of the store, or there is no position or clock
+          *   segment at t. */
+      virtual Xvt getXvt(const SatID& sat, const CommonTime& t) const;
+
+         /** Compute the position, velocity and clock offset of the
+          * indicated satellite as getXvt() does, but without
+          * throwing; an Xvt that cannot be computed has health
+          * Xvt::HealthStatus::Unavailable.
+          * @param[in] sat the satellite of interest
+          * @param[in] t the time to look up
+          * @return the Xvt of the satellite at the indicated time */
+      virtual Xvt computeXvt(const SatID& sat, const CommonTime& t) const
+         throw();
+
+         /** Get the satellite health at a specific time.
+          * @return Unused if computeXvt() succeeds (health is not
+          *   available in precise orbits), otherwise Unavailable. */
+      virtual Xvt::HealthStatus getSVHealth(const SatID& sat,
+                                            const CommonTime& t) const throw();
+
+         /** Dump information about the store to an ostream.
+          * @param[in] os ostream to receive the output
+          * @param[in] detail 0: a summary, 1: also one line per
+          *   satellite, 2: also every segment */
+      virtual void dump(std::ostream& os = std::cout, short detail = 0) const;
+
+         /** Remove segments that lie entirely outside [tmin, tmax];
+          * segments that straddle tmin or tmax are kept.
+          * @param[in] tmin defines the beginning of the time interval
+          * @param[in] tmax defines the end of the time interval */
+      virtual void edit(const CommonTime& tmin,
+                        const CommonTime& tmax = CommonTime::END_OF_TIME);
+
+         /// Remove all data; the fit parameters are unchanged.
+      virtual void clear(void) throw();
+
+         /// Return the time system of the store
+      virtual TimeSystem getTimeSystem(void) const
+      { return timeSystem; }
+
+         /** Return the earliest time at which any satellite has both
+          * position and clock.
+          * @throw InvalidRequest if the store has no data */
+      virtual CommonTime getInitialTime(void) const;
+
+         /** Return the latest time at which any satellite has both
+          * position and clock.
+          * @throw InvalidRequest if the store has no data */
+      virtual CommonTime getFinalTime(void) const;
+
+         /** Return the earliest time at which the satellite has both
+          * position and clock.
+          * @throw InvalidRequest if there is no data for sat */
+      CommonTime getInitialTime(const SatID& sat) const;
+
+         /** Return the latest time at which the satellite has both
+          * position and clock.
+          * @throw InvalidRequest if there is no data for sat */
+      CommonTime getFinalTime(const SatID& sat) const;
+
+         /// Always true, velocity is the derivative of the position
+      virtual bool hasVelocity(void) const
+      { return true; }
+
+         /// Return true if the satellite has any data in the store
+      virtual bool isPresent(const SatID& sat) const
+      { return (tables.find(sat) != tables.end()); }
+
+         /// Return the satellites in the store
+      virtual std::set<SatID> getIndexSet(void) const;
+
+         /** Fit polynomials to the whole of an SP3EphemerisStore,
+          * as fit(store, tmin, tmax) with the limits of the store.
+          * @param[in] store the source of positions and clocks */
+      void fit(const SP3EphemerisStore& store);
+
+         /** Fit polynomials to an SP3EphemerisStore between two
+          * times, replacing any segments of this store within the
+          * same blocks and times.  Fitting consecutive, e.g. daily,
+          * ranges from stores that each hold some data beyond the
+          * range (e.g. the neighbouring days) builds a continuous
+          * store of any length.
+          * @note for speed, enable the window cache of the source,
+          *   SP3EphemerisStore::setWindowCache().
+          * @param[in] store the source of positions and clocks
+          * @param[in] tmin beginning of the range to fit
+          * @param[in] tmax end of the range to fit
+          * @throw InvalidRequest if the time system of the source is
+          *   not that of this store (when not empty), or the fit
+          *   parameters are inconsistent. */
+      void fit(const SP3EphemerisStore& store, const CommonTime& tmin,
+               const CommonTime& tmax);
+
+         /** Load SP3 files and (optionally) RINEX clock files into a
+          * temporary SP3EphemerisStore and fit() all of it.
+          * @param[in] sp3Files names of the SP3 files
+          * @param[in] clockFiles names of RINEX clock files; if any,
+          *   the clocks are taken from these rather than the SP3
+          * @throw Exception if the files cannot be read */
+      void loadFiles(const std::vector<std::string>& sp3Files,
+                     const std::vector<std::string>& clockFiles =
+                        std::vector<std::string>());
+
+         /// Set the length of the blocks in seconds (default 14400)
+         /// @throw InvalidRequest if not positive, or the store is
+         ///   not empty
+      void setSpan(double seconds);
+
+         /// Get the length of the blocks in seconds
+      double getSpan(void) const throw()
+      { return span; }
+
+         /// Set the shortest segment in seconds (default 60)
+      void setMinSpan(double seconds) throw()
+      { minSpan = seconds; }
+
+         /// Get the shortest segment in seconds
+      double getMinSpan(void) const throw()
+      { return minSpan; }
+
+         /// Set the largest degree of the polynomials (default 16)
+         /// @throw InvalidRequest if not in [1, MAX_DEGREE]
+      void setMaxDegree(int degree);
+
+         /// Get the largest degree of the polynomials
+      int getMaxDegree(void) const throw()
+      { return maxDegree; }
+
+         /// Set the error bound on position in meters (default 0.001)
+      void setPositionTolerance(double meters) throw()
+      { posTol = meters; }
+
+         /// Get the error bound on position in meters
+      double getPositionTolerance(void) const throw()
+      { return posTol; }
+
+         /// Set the error bound on clock bias in seconds (default 1.e-11)
+      void setClockTolerance(double seconds) throw()
+      { clkTol = seconds; }
+
+         /// Get the error bound on clock bias in seconds
+      double getClockTolerance(void) const throw()
+      { return clkTol; }
+
+         /// Largest position error (meters) found in the checks of
+         /// the segments fitted since the store was last cleared
+      double getMaxPositionError(void) const throw()
+      { return maxPosErr; }
+
+         /// Largest clock error (seconds) found in the checks of the
+         /// segments fitted since the store was last cleared
+      double getMaxClockError(void) const throw()
+      { return maxClkErr; }
+
+         /// Return the number of position and clock segments
+      unsigned long nsegments(void) const throw();
+
+         /// Return the number of coefficients, a measure of the size
+      unsigned long ncoefficients(void) const throw();
+
+   private:
+         /** One polynomial: the Chebyshev series of each component,
+          * valid from begin to end seconds after the start of its
+          * block. Coefficient j of component i is coef[i*n+j], with
+          * n = coef.size()/(number of components). */
+      struct Segment
+      {
+         double begin, end;
+         std::vector<double> coef;
+            /// order by beginning
+         bool operator<(const Segment& right) const
+         { return (begin < right.begin); }
+      };
+
+         /// Position and clock segments of one block, in time order
+      struct Block
+      {
+         std::vector<Segment> pos;
+         std::vector<Segment> clk;
+      };
+
+         /// The blocks of one satellite; blocks[k] is block first+k
+      struct SatTable
+      {
+         long first;
+         std::vector<Block> blocks;
+      };
+
+         /// Start time of block j
+      CommonTime blockStart(long j) const;
+
+         /** Find the index of the block containing t.
+          * @param[out] dt seconds from the start of the block to t */
+      long blockIndex(const CommonTime& t, double& dt) const;
+
+         /** Find the block containing t.
+          * @param[out] dt seconds from the start of the block to t
+          * @return the block, or 0 if there is none */
+      const Block* findBlock(const SatTable& table, const CommonTime& t,
+                             double& dt) const;
+
+         /** Evaluate the segment of segs containing dt.
+          * @param[in] ncomp number of components (3 or 1)
+          * @param[out] val values of the components
+          * @param[out] der time derivatives of the components
+          * @return false if no segment contains dt */
+      static bool evaluate(const std::vector<Segment>& segs, double dt,
+                           int ncomp, double *val, double *der);
+
+         /** Evaluate the store being fitted.
+          * @param[in] clock true for clock bias (s), else position (m)
+          * @return false if it cannot be interpolated at t */
+      static bool sample(const SP3EphemerisStore& store, const SatID& sat,
+                         bool clock, const CommonTime& t, double *val);
+
+         /** Fit segments to the store from a to b seconds after t0,
+          * splitting as necessary, appending them to segs.
+          * @param[in] epoch seconds from t0 to one tabulated time
+          * @param[in] step nominal spacing of the tabulated times,
+          *   or 0 if unknown */
+      void fitRange(const SP3EphemerisStore& store, const SatID& sat,
+                    bool clock, const CommonTime& t0, double epoch,
+                    double step, double a, double b,
+                    std::vector<Segment>& segs);
+
+         /** The part of seg from a to b, a sub-interval of it, as a
+          * segment of its own; the polynomial is the same, to rounding.
+          * @param[in] ncomp number of components (3 or 1) */
+      static Segment subSegment(const Segment& seg, int ncomp, double a,
+                              double b);
+
+         /** Move t toward limit, in steps of step seconds (negative
+          * to move back) then by bisection, to within a millisecond of
+          * the first time at which the store can be sampled; t is not
+          * changed if there is no such time before limit. */
+      void trimEnd(const SP3EphemerisStore& store, const SatID& sat,
+                   bool clock, CommonTime& t, const CommonTime& limit,
+                   double step) const;
+
+         /** Fit one kind of data of one satellite between two times,
+          * replacing the segments there, and only there: a segment
+          * that extends beyond the data of the source keeps that part.
+          * @param[in] clock true for the clock, else position */
+      void fitSat(const SP3EphemerisStore& store, const SatID& sat,
+                  bool clock, const CommonTime& tmin, const CommonTime& tmax);
+
+         /** Common part of getXvt() and computeXvt().
+          * @param[out] why reason the Xvt is Unavailable, if it is
+          * @return the Xvt, with health Unavailable on failure */
+      Xvt compute(const SatID& sat, const CommonTime& t,
+                  std::string& why) const;
+
+         /// Earliest or latest time of one kind of segment
+      static bool segmentTime(const SatTable& table, bool clock, bool last,
+                              double& dt, long& j);
+
+      TimeSystem timeSystem;  ///< time system of the data
+      double span;            ///< length of the blocks in seconds
+      double minSpan;         ///< shortest segment in seconds
+      int maxDegree;          ///< largest degree of the polynomials
+      double posTol;          ///< position error bound in meters
+      double clkTol;          ///< clock error bound in seconds
+      double maxPosErr;       ///< largest position fit error found
+      double maxClkErr;       ///< largest clock fit error found
+
+         /// The segments of each satellite
+      std::map<SatID, SatTable> tables;
+
+   }; // end class ChebyshevEphemerisStore
+
+      //@}
+
+} // namespace
+
+#endif // GPSTK_CHEBYSHEVEPHEMERISSTORE_INCLUDE
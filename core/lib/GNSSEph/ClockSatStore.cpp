@@ -60,16 +60,10 @@ namespace gpstk
       return os;
    }
 
-   // Return value for the given satellite at the given time (usually via
-   // interpolation of the data table). This interface from TabularSatStore.
-   // @param[in] sat the SatID of the satellite of interest
-   // @param[in] ttag the time (CommonTime) of interest
-   // @return object of type ClockRecord containing the data value(s).
-   // @throw InvalidRequest if data value cannot be computed, for example because
-   //  a) the time t does not lie within the time limits of the data table
-   //  b) checkDataGap is true and there is a data gap
-   //  c) checkInterval is true and the interval is larger than maxInterval
-   ClockRecord ClockSatStore::getValue(const SatID& sat, const CommonTime& ttag)
+   // Implementation of getValue(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   ClockRecord ClockSatStore::getValueFrom(const SatID& sat, const CommonTime& ttag)
       const
    {
       try {
@@ -77,7 +71,7 @@ namespace gpstk
 
          bool isExact;
          ClockRecord rec;
-         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+         TableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
 
          isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift);
          if(isExact && haveClockDrift) {
@@ -192,21 +186,159 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
-   // Return the clock bias for the given satellite at the given time
+   // Implementation of getValue() using the interpolation window cache: the
+   // same computation as getValueFrom(), with the Lagrange weights of the
+   // window applied to bias, drift and acceleration in one pass.
+   ClockRecord ClockSatStore::getValueWindow(const SatID& sat,
+                                             const CommonTime& ttag)
+      const
+   {
+      try {
+         checkTimeSystem(ttag.getTimeSystem());
+
+         InterpWindow& win(findWindow(sat, ttag, Nhalf, haveClockDrift));
+         if(win.isExact && haveClockDrift)
+            return win.recs[0];
+
+         size_t n,N(win.recs.size()),Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
+         if(win.isExact) Nmatch = win.match;
+         if(win.isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
+
+         const vector<double>& times(win.times);
+         const ClockRecord& rlo(win.recs[Nlow]);
+         const ClockRecord& rhi(win.recs[Nhi]);
+
+         // Lagrange interpolation of every quantity in one pass; B,D,A are
+         // interpolated bias, drift and accel, dB,dD the derivatives
+         double dt(ttag-win.t0), slope, B(0),D(0),A(0),dB(0),dD(0);
+         if(interpType == 2) {
+            if(haveClockDrift && haveClockAccel) {
+               win.lagrange.coefficients(dt, win.L);
+               for(n=0; n<N; n++) {
+                  const ClockRecord& r(win.recs[n]);
+                  B += win.L[n]*r.bias;
+                  D += win.L[n]*r.drift;
+                  A += win.L[n]*r.accel;
+               }
+            }
+            else {
+               win.lagrange.coefficients(dt, win.L, win.Lp);
+               for(n=0; n<N; n++) {
+                  const ClockRecord& r(win.recs[n]);
+                  B += win.L[n]*r.bias;
+                  D += win.L[n]*r.drift;
+                  A += win.L[n]*r.accel;
+                  dB += win.Lp[n]*r.bias;
+                  dD += win.Lp[n]*r.drift;
+               }
+            }
+         }
+
+         ClockRecord rec;
+         rec.accel = rec.sig_accel = 0.0;              // defaults
+         if(haveClockDrift) {
+            if(interpType == 2) {
+               rec.bias = B;                                        // sec
+               rec.drift = D;                                       // sec/sec
+            }
+            else {
+               // linear interpolation
+               slope = (rhi.bias-rlo.bias) / (times[Nhi]-times[Nlow]); // sec/sec
+               rec.bias = rlo.bias + slope*(dt-times[Nlow]);           // sec
+               slope = (rhi.drift-rlo.drift)/(times[Nhi]-times[Nlow]);
+               rec.drift = rlo.drift + slope*(dt-times[Nlow]);         // sec/sec
+            }
+
+            // sigmas
+            if(win.isExact)
+               rec.sig_bias = win.recs[Nmatch].sig_bias;
+            else
+               rec.sig_bias = RSS(rhi.sig_bias,rlo.sig_bias);
+            rec.sig_drift = RSS(rhi.sig_drift,rlo.sig_drift);
+         }
+         else {                              // must interpolate biases to get drift
+            if(interpType == 2) {
+               rec.bias = B;
+               rec.drift = dB;
+            }
+            else {
+               // linear interpolation
+               rec.drift = (rhi.bias-rlo.bias) / (times[Nhi]-times[Nlow]); // sec/sec^2
+               rec.bias = rlo.bias + (dt-times[Nlow])*rec.drift;          // sec/sec
+            }
+
+            // sigmas
+            if(win.isExact)
+               rec.sig_bias = win.recs[Nmatch].sig_bias;
+            else
+               rec.sig_bias = RSS(rhi.sig_bias,rlo.sig_bias);
+            rec.sig_drift = rec.sig_bias/(times[Nhi]-times[Nlow]);
+         }
+
+         if(haveClockAccel) {
+            if(interpType == 2) {
+               rec.accel = A;                                       // sec/sec^2
+            }
+            else {
+               // linear interpolation
+               slope = (rhi.drift-rlo.drift) / (times[Nhi]-times[Nlow]);  // sec/sec^2
+               rec.accel = rlo.accel + slope*(dt-times[Nlow]);             // sec/sec^2
+            }
+
+            // sigma
+            if(win.isExact)
+               rec.sig_accel = win.recs[Nmatch].sig_accel;
+            else
+               rec.sig_accel = RSS(rhi.sig_accel,rlo.sig_accel);
+         }
+         else if(haveClockDrift) {              // must interpolate drift to get accel
+            if(interpType == 2) {
+               rec.accel = dD;
+            }
+            else {
+               // linear interpolation                                   // sec/sec^2
+               rec.accel = (rhi.drift-rlo.drift) / (times[Nhi]-times[Nlow]);
+            }
+
+            // sigmas  TD is there a better way?
+            rec.sig_accel = rec.sig_drift/(times[Nhi]-times[Nlow]);
+         }
+         // else zero
+
+         return rec;
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
+
+   // Return value for the given satellite at the given time (usually via
+   // interpolation of the data table). This interface from TabularSatStore.
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
-   // @return double the clock bias
-   // @throw InvalidRequest if bias cannot be computed, for example because
+   // @return object of type ClockRecord containing the data value(s).
+   // @throw InvalidRequest if data value cannot be computed, for example because
    //  a) the time t does not lie within the time limits of the data table
    //  b) checkDataGap is true and there is a data gap
    //  c) checkInterval is true and the interval is larger than maxInterval
-   double ClockSatStore::getClockBias(const SatID& sat, const CommonTime& ttag)
+   ClockRecord ClockSatStore::getValue(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useWindowCache)
+         return getValueWindow(sat, ttag);
+      if(useFlatTables)
+         return getValueFrom<FlatTableIterator>(sat, ttag);
+      return getValueFrom<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getClockBias(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   double ClockSatStore::getClockBiasFrom(const SatID& sat, const CommonTime& ttag)
       const
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
-         DataTableIterator it1, it2, kt;
+         TableIterator it1, it2, kt;
          if(getTableInterval(sat, ttag, Nhalf, it1, it2, true)) {
             // exact match
             ClockRecord rec;
@@ -240,22 +372,34 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
-   // Return the clock drift for the given satellite at the given time
+   // Return the clock bias for the given satellite at the given time
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
-   // @return double the clock drift
-   // @throw InvalidRequest if drift cannot be computed, for example because
+   // @return double the clock bias
+   // @throw InvalidRequest if bias cannot be computed, for example because
    //  a) the time t does not lie within the time limits of the data table
    //  b) checkDataGap is true and there is a data gap
    //  c) checkInterval is true and the interval is larger than maxInterval
-   //  d) there is no drift data in the store
-   double ClockSatStore::getClockDrift(const SatID& sat, const CommonTime& ttag)
+   double ClockSatStore::getClockBias(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useWindowCache)
+         return getValueWindow(sat, ttag).bias;
+      if(useFlatTables)
+         return getClockBiasFrom<FlatTableIterator>(sat, ttag);
+      return getClockBiasFrom<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getClockDrift(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   double ClockSatStore::getClockDriftFrom(const SatID& sat, const CommonTime& ttag)
       const
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
-         DataTableIterator it1, it2, kt;
+         TableIterator it1, it2, kt;
          bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift));
          if(isExact && haveClockDrift) {
             ClockRecord rec;
@@ -274,7 +418,7 @@ namespace gpstk
             if(isExact && ABS(kt->first-ttag) < 1.e-8) Nhi=n;
             times.push_back(kt->first - ttag0);    // sec
             if(haveClockDrift)
-               drifts.push_back(kt->second.bias);  // sec/sec
+               drifts.push_back(kt->second.drift); // sec/sec
             else
                biases.push_back(kt->second.bias);  // sec
             if(kt == it2) break;
@@ -313,12 +457,32 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
+   // Return the clock drift for the given satellite at the given time
+   // @param[in] sat the SatID of the satellite of interest
+   // @param[in] ttag the time (CommonTime) of interest
+   // @return double the clock drift
+   // @throw InvalidRequest if drift cannot be computed, for example because
+   //  a) the time t does not lie within the time limits of the data table
+   //  b) checkDataGap is true and there is a data gap
+   //  c) checkInterval is true and the interval is larger than maxInterval
+   //  d) there is no drift data in the store
+   double ClockSatStore::getClockDrift(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useWindowCache)
+         return getValueWindow(sat, ttag).drift;
+      if(useFlatTables)
+         return getClockDriftFrom<FlatTableIterator>(sat, ttag);
+      return getClockDriftFrom<DataTableIterator>(sat, ttag);
+   }
+
    // Add a ClockRecord to the store.
    void ClockSatStore::addClockRecord(const SatID& sat, const CommonTime& ttag,
                                       const ClockRecord& rec)
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          if(rec.drift != 0.0) haveClockDrift = true;
          if(rec.accel != 0.0) haveClockAccel = true;
@@ -350,6 +514,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          if(tables.find(sat) != tables.end() &&
             tables[sat].find(ttag) != tables[sat].end()) {
@@ -377,6 +542,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          haveClockDrift = true;
 
@@ -406,6 +572,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          haveClockAccel = true;
 
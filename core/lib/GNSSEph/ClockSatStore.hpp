@@ -99,6 +99,10 @@ namespace gpstk
        *   consistently. */
    class ClockSatStore : public TabularSatStore<ClockRecord>
    {
+         /// EphemerisCache saves and restores the tables
+      friend class EphemerisCache;
+         /// SP3EphemerisStore::computeXvts() interpolates with windows
+      friend class SP3EphemerisStore;
 
          // member data
    protected:
@@ -121,6 +125,21 @@ namespace gpstk
          /// Flag to reject bad clock data; default true
       bool rejectBadClockFlag;
 
+         /** Implementations of getValue(), getClockBias() and
+          * getClockDrift(); TableIterator is DataTableIterator or
+          * FlatTableIterator, cf. setFlatTables() */
+      template <class TableIterator>
+      ClockRecord getValueFrom(const SatID& sat, const CommonTime& ttag) const;
+      template <class TableIterator>
+      double getClockBiasFrom(const SatID& sat, const CommonTime& ttag) const;
+      template <class TableIterator>
+      double getClockDriftFrom(const SatID& sat, const CommonTime& ttag) const;
+
+         /** Implementation of getValue(), getClockBias() and
+          * getClockDrift() with barycentric weights and the
+          * interpolation window cache, cf. setWindowCache() */
+      ClockRecord getValueWindow(const SatID& sat, const CommonTime& ttag) const;
+
          // member functions
    public:
 
@@ -627,50 +627,75 @@ namespace gpstk
    }
 
 
+      /*
+        Parity bit masks, one for each of the six parity bits.  Each
+        is a bit mask with bits set corresponding to the bits which
+        are to be exclusive-OR'd together to form the parity check
+        bit.  The following bit maps define the masks.  They were
+        drawn from table 20-XIV of ICD-GPS-200C (10 OCT 1993).
+
+        Bit in navigation message
+              bit1                             bit 30
+        bit    12 3456 789. 1234 5678 9.12 3456 789.
+        ---    -------------------------------------
+        D25    11 1011 0001 1111 0011 0100 1000 0000
+        D26    01 1101 1000 1111 1001 1010 0100 0000
+        D27    10 1110 1100 0111 1100 1101 0000 0000
+        D28    01 0111 0110 0011 1110 0110 1000 0000
+        D29    10 1011 1011 0001 1111 0011 0100 0000
+        D30    00 1011 0111 1010 1000 1001 1100 0000
+      */
+   static const uint32_t PARITY_MASK[6] =
+   { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
+     0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+
+      // Parity bits D25-D30 (as bits 5-0) contributed by the D29* of
+      // the previous word, and by D30*.
+   static const uint32_t PARITY_D29 = 0x29;
+   static const uint32_t PARITY_D30 = 0x16;
+
+      // Parity is linear in the 24 data bits, so it is the XOR of the
+      // parity of each of their three bytes.  entry[k][b] is the
+      // parity of the byte b at bits 6+8k to 13+8k of a word.
+   static const struct ParityTable
+   {
+      ParityTable()
+      {
+         for (unsigned k = 0; k < 3; k++)
+         {
+            for (uint32_t b = 0; b < 256; b++)
+            {
+               uint32_t d = b << (6 + 8*k);
+               uint8_t p = 0;
+               for (unsigned i = 0; i < 6; i++)
+                  p |= (BinUtils::countBits(PARITY_MASK[i] & d) & 1) << (5-i);
+               entry[k][b] = p;
+            }
+         }
+      }
+      uint8_t entry[3][256];
+   } PARITY_TABLE;
+
+
    uint32_t EngNav :: computeParity(uint32_t sfword,
                                     uint32_t psfword,
                                     bool knownUpright)
    {
-         /*
-           This function is somewhat table-driven.  There is one
-           element in bmask for each of the six parity bits.  Each
-           element is a bit mask with bits set corresponding to the
-           bits which are to be exclusive-OR'd together to form the
-           parity check bit.  The following bit maps define the bmask
-           array.  They were drawn from table 20-XIV of ICD-GPS-200C
-           (10 OCT 1993).
-
-           Bit in navigation message
-                 bit1                             bit 30
-           bit    12 3456 789. 1234 5678 9.12 3456 789.
-           ---    -------------------------------------
-           D25    11 1011 0001 1111 0011 0100 1000 0000
-           D26    01 1101 1000 1111 1001 1010 0100 0000
-           D27    10 1110 1100 0111 1100 1101 0000 0000
-           D28    01 0111 0110 0011 1110 0110 1000 0000
-           D29    10 1011 1011 0001 1111 0011 0100 0000
-           D30    00 1011 0111 1010 1000 1001 1100 0000
-         */
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                            0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
-
-      uint32_t D = 0;
       uint32_t d = sfword;
-      uint32_t D29 = getd29(psfword);
-      uint32_t D30 = getd30(psfword);
 
          // If D30 of the previous subframe was set, complement the word
          // to get the source data bits.  This will also complement the
          // parity, but we don't need the original parity to compute the
          // new.
-      if (D30 && !knownUpright)
+      if (getd30(psfword) && !knownUpright)
          d = ~d;
-      D |= ((D29 + BinUtils::countBits(bmask[0] & d)) % 2) << 5;
-      D |= ((D30 + BinUtils::countBits(bmask[1] & d)) % 2) << 4;
-      D |= ((D29 + BinUtils::countBits(bmask[2] & d)) % 2) << 3;
-      D |= ((D30 + BinUtils::countBits(bmask[3] & d)) % 2) << 2;
-      D |= ((D30 + BinUtils::countBits(bmask[4] & d)) % 2) << 1;
-      D |= ((D29 + BinUtils::countBits(bmask[5] & d)) % 2);
+      uint32_t D = PARITY_TABLE.entry[0][(d >> 6) & 0xff]
+         ^ PARITY_TABLE.entry[1][(d >> 14) & 0xff]
+         ^ PARITY_TABLE.entry[2][(d >> 22) & 0xff];
+      if (getd29(psfword))
+         D ^= PARITY_D29;
+      if (getd30(psfword))
+         D ^= PARITY_D30;
 
       return D;
    }
@@ -680,9 +705,6 @@ namespace gpstk
                                 bool nib,
                                 bool knownUpright)
    {
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                                 0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
-
       uint32_t D = 0;
       uint32_t d = sfword;
       uint32_t D29 = getd29(psfword);
@@ -692,9 +714,9 @@ namespace gpstk
       {
             // make sure the non-information bits are zero to start with.
          d &= 0xffffff00;
-         if ((D30 + BinUtils::countBits(bmask[4] & d)) % 2)
+         if ((D30 + BinUtils::countBits(PARITY_MASK[4] & d)) % 2)
             d |= 0x00000040;
-         if ((D29 + BinUtils::countBits(bmask[5] & d)) % 2)
+         if ((D29 + BinUtils::countBits(PARITY_MASK[5] & d)) % 2)
             d |= 0x00000080;
       }
 
@@ -732,6 +754,20 @@ namespace gpstk
          ((sf[9] & 0x0000003f) == computeParity(sf[9], sf[8], knownUpright));
    }
 
+   std::size_t EngNav :: checkParity(const uint32_t *subframes,
+                                     std::size_t count,
+                                     bool *valid,
+                                     bool knownUpright)
+   {
+      std::size_t numValid = 0;
+      for (std::size_t i = 0; i < count; i++)
+      {
+         valid[i] = checkParity(subframes + 10*i, knownUpright);
+         numValid += valid[i];
+      }
+      return numValid;
+   }
+
    void EngNav :: convertQuant(const uint32_t input[10],
                                double output[60],
                                DecodeQuant *p)
@@ -124,6 +124,21 @@ namespace gpstk
       static bool checkParity(const uint32_t input[10], bool knownUpright=true);
       static bool checkParity(const std::vector<uint32_t>& v, bool knownUpright=true);
 
+         /**
+          * Perform a parity check on each of a buffer of subframes.
+          * @param subframes count subframes of 10 words each, one
+          *   after the other.
+          * @param count The number of subframes.
+          * @param valid Set to the result of checkParity() for each
+          *   subframe; must have room for count values.
+          * @param knownUpright As for checkParity().
+          * @return the number of subframes that passed.
+          */
+      static std::size_t checkParity(const uint32_t *subframes,
+                                     std::size_t count,
+                                     bool *valid,
+                                     bool knownUpright=true);
+
 
          /// This is the old routine only left around for compatibility
       static bool subframeParity(const long input[10]);
@@ -0,0 +1,948 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file EphemerisCache.cpp
+ * Save the contents of ephemeris stores in a binary cache file, and
+ * restore them from it when the source files have not changed. */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+#include "BinUtils.hpp"
+#include "GPSEphemeris.hpp"
+#include "GalEphemeris.hpp"
+#include "BDSEphemeris.hpp"
+#include "QZSEphemeris.hpp"
+#include "SP3Stream.hpp"
+#include "SP3Header.hpp"
+#include "Rinex3ClockStream.hpp"
+#include "Rinex3ClockHeader.hpp"
+#include "EphemerisCache.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+      // first bytes of a cache file
+   static const char CACHE_MAGIC[8] = { 'G','P','S','T','K','E','P','H' };
+
+      // members of the SP3 records, in the order they are saved
+   static Triple PositionRecord::* const POSITION_MEMBERS[6] =
+   {
+      &PositionRecord::Pos, &PositionRecord::sigPos,
+      &PositionRecord::Vel, &PositionRecord::sigVel,
+      &PositionRecord::Acc, &PositionRecord::sigAcc
+   };
+   static double ClockRecord::* const CLOCK_MEMBERS[6] =
+   {
+      &ClockRecord::bias, &ClockRecord::sig_bias,
+      &ClockRecord::drift, &ClockRecord::sig_drift,
+      &ClockRecord::accel, &ClockRecord::sig_accel
+   };
+
+      // type tags of the OrbitEph objects in an OrbitEphStore cache
+   enum EphTypeTag
+   {
+      OrbitEphTag = 0,
+      GPSEphemerisTag = 1,
+      GalEphemerisTag = 2,
+      BDSEphemerisTag = 3,
+      QZSEphemerisTag = 4
+   };
+
+      /* Append little-endian binary values to a string. */
+   class CacheEncoder
+   {
+   public:
+      CacheEncoder(string& s) : buf(s) {}
+
+      void putInt8(int v)
+      { buf.push_back(static_cast<char>(v)); }
+
+      void putUint32(uint32_t v)
+      { char b[4]; BinUtils::buhtoil(b, v); buf.append(b, 4); }
+
+      void putInt32(int32_t v)
+      { char b[4]; BinUtils::buhtoisl(b, v); buf.append(b, 4); }
+
+      void putUint64(uint64_t v)
+      { char b[8]; BinUtils::buhtoill(b, v); buf.append(b, 8); }
+
+      void putInt64(int64_t v)
+      { char b[8]; BinUtils::buhtoisll(b, v); buf.append(b, 8); }
+
+      void putDouble(double v)
+      { char b[8]; BinUtils::buhtoid(b, v); buf.append(b, 8); }
+
+      void putString(const string& s)
+      { putUint32(s.size()); buf.append(s); }
+
+      void putTime(const CommonTime& t)
+      {
+         long day, msod;
+         double fsod;
+         TimeSystem ts;
+         t.getInternal(day, msod, fsod, ts);
+         putInt32(day);
+         putInt32(msod);
+         putDouble(fsod);
+         putInt32(static_cast<int32_t>(ts));
+      }
+
+      void putSat(const SatID& sat)
+      {
+         putInt32(sat.id);
+         putInt32(static_cast<int32_t>(sat.system));
+      }
+
+      void putTriple(const Triple& t)
+      { putDouble(t[0]); putDouble(t[1]); putDouble(t[2]); }
+
+      string& buf;
+   };
+
+      /* Read little-endian binary values from a string, throwing
+       * InvalidRequest at the end of the data. */
+   class CacheDecoder
+   {
+   public:
+      CacheDecoder(const string& s, size_t begin, size_t end)
+            : buf(s.data()), pos(begin), last(end)
+      {}
+
+      void need(size_t n)
+      {
+         if(pos + n > last)
+         {
+            InvalidRequest ir("Unexpected end of cache data");
+            GPSTK_THROW(ir);
+         }
+      }
+
+      int getInt8()
+      { need(1); return static_cast<unsigned char>(buf[pos++]); }
+
+      uint32_t getUint32()
+      { need(4); uint32_t v; BinUtils::buitohl(buf, v, pos); pos += 4; return v; }
+
+      int32_t getInt32()
+      { need(4); int32_t v; BinUtils::buitohsl(buf, v, pos); pos += 4; return v; }
+
+      uint64_t getUint64()
+      { need(8); uint64_t v; BinUtils::buitohll(buf, v, pos); pos += 8; return v; }
+
+      int64_t getInt64()
+      { need(8); int64_t v; BinUtils::buitohsll(buf, v, pos); pos += 8; return v; }
+
+      double getDouble()
+      { need(8); double v; BinUtils::buitohd(buf, v, pos); pos += 8; return v; }
+
+      string getString()
+      {
+         uint32_t n(getUint32());
+         need(n);
+         string s(buf+pos, n);
+         pos += n;
+         return s;
+      }
+
+      CommonTime getTime()
+      {
+         long day(getInt32()), msod(getInt32());
+         double fsod(getDouble());
+         TimeSystem ts(static_cast<TimeSystem>(getInt32()));
+         CommonTime t;
+         t.setInternal(day, msod, fsod, ts);
+         return t;
+      }
+
+      SatID getSat()
+      {
+         int id(getInt32());
+         return SatID(id, static_cast<SatelliteSystem>(getInt32()));
+      }
+
+      void getTriple(Triple& t)
+      {
+         t[0] = getDouble();
+         t[1] = getDouble();
+         t[2] = getDouble();
+      }
+
+      const char *buf;
+      size_t pos, last;
+   };
+
+
+      // Encode the members of OrbitEph
+   static void putOrbitEph(CacheEncoder& enc, const OrbitEph& eph)
+   {
+      enc.putInt8(eph.dataLoadedFlag ? 1 : 0);
+      enc.putSat(eph.satID);
+      enc.putInt32(static_cast<int32_t>(eph.obsID.type));
+      enc.putInt32(static_cast<int32_t>(eph.obsID.band));
+      enc.putInt32(static_cast<int32_t>(eph.obsID.code));
+      enc.putTime(eph.ctToe);
+      enc.putTime(eph.ctToc);
+      enc.putDouble(eph.af0);
+      enc.putDouble(eph.af1);
+      enc.putDouble(eph.af2);
+      enc.putDouble(eph.M0);
+      enc.putDouble(eph.dn);
+      enc.putDouble(eph.ecc);
+      enc.putDouble(eph.A);
+      enc.putDouble(eph.OMEGA0);
+      enc.putDouble(eph.i0);
+      enc.putDouble(eph.w);
+      enc.putDouble(eph.OMEGAdot);
+      enc.putDouble(eph.idot);
+      enc.putDouble(eph.dndot);
+      enc.putDouble(eph.Adot);
+      enc.putDouble(eph.Cuc);
+      enc.putDouble(eph.Cus);
+      enc.putDouble(eph.Crc);
+      enc.putDouble(eph.Crs);
+      enc.putDouble(eph.Cic);
+      enc.putDouble(eph.Cis);
+      enc.putTime(eph.beginValid);
+      enc.putTime(eph.endValid);
+   }
+
+      // Decode the members of OrbitEph
+   static void getOrbitEph(CacheDecoder& dec, OrbitEph& eph)
+   {
+      eph.dataLoadedFlag = (dec.getInt8() != 0);
+      eph.satID = dec.getSat();
+      eph.obsID.type = static_cast<ObservationType>(dec.getInt32());
+      eph.obsID.band = static_cast<CarrierBand>(dec.getInt32());
+      eph.obsID.code = static_cast<TrackingCode>(dec.getInt32());
+      eph.ctToe = dec.getTime();
+      eph.ctToc = dec.getTime();
+      eph.af0 = dec.getDouble();
+      eph.af1 = dec.getDouble();
+      eph.af2 = dec.getDouble();
+      eph.M0 = dec.getDouble();
+      eph.dn = dec.getDouble();
+      eph.ecc = dec.getDouble();
+      eph.A = dec.getDouble();
+      eph.OMEGA0 = dec.getDouble();
+      eph.i0 = dec.getDouble();
+      eph.w = dec.getDouble();
+      eph.OMEGAdot = dec.getDouble();
+      eph.idot = dec.getDouble();
+      eph.dndot = dec.getDouble();
+      eph.Adot = dec.getDouble();
+      eph.Cuc = dec.getDouble();
+      eph.Cus = dec.getDouble();
+      eph.Crc = dec.getDouble();
+      eph.Crs = dec.getDouble();
+      eph.Cic = dec.getDouble();
+      eph.Cis = dec.getDouble();
+      eph.beginValid = dec.getTime();
+      eph.endValid = dec.getTime();
+   }
+
+      // Encode an OrbitEph, or one of the classes derived from it,
+      // with its type tag.  Throw InvalidRequest for an unknown type.
+   static void putEphemeris(CacheEncoder& enc, const OrbitEph *ptr)
+   {
+      const string name(ptr->getName());
+      if(name == "GPSEphemeris")
+      {
+         const GPSEphemeris& eph(dynamic_cast<const GPSEphemeris&>(*ptr));
+         enc.putInt8(GPSEphemerisTag);
+         putOrbitEph(enc, eph);
+         enc.putTime(eph.transmitTime);
+         enc.putInt32(eph.HOWtime);
+         enc.putInt32(eph.IODE);
+         enc.putInt32(eph.IODC);
+         enc.putInt32(eph.health);
+         enc.putInt32(eph.accuracyFlag);
+         enc.putDouble(eph.accuracy);
+         enc.putDouble(eph.Tgd);
+         enc.putInt32(eph.codeflags);
+         enc.putInt32(eph.L2Pdata);
+         enc.putInt32(eph.fitDuration);
+         enc.putInt32(eph.fitint);
+      }
+      else if(name == "GalEphemeris")
+      {
+         const GalEphemeris& eph(dynamic_cast<const GalEphemeris&>(*ptr));
+         enc.putInt8(GalEphemerisTag);
+         putOrbitEph(enc, eph);
+         enc.putTime(eph.transmitTime);
+         enc.putInt32(eph.HOWtime);
+         enc.putInt32(eph.IODnav);
+         enc.putInt32(static_cast<int32_t>(eph.health));
+         enc.putDouble(eph.accuracy);
+         enc.putDouble(eph.Tgda);
+         enc.putDouble(eph.Tgdb);
+         enc.putInt32(eph.datasources);
+         enc.putInt32(eph.fitDuration);
+      }
+      else if(name == "BDSEphemeris")
+      {
+         const BDSEphemeris& eph(dynamic_cast<const BDSEphemeris&>(*ptr));
+         enc.putInt8(BDSEphemerisTag);
+         putOrbitEph(enc, eph);
+         enc.putTime(eph.transmitTime);
+         enc.putInt32(eph.HOWtime);
+         enc.putInt32(eph.IODE);
+         enc.putInt32(eph.IODC);
+         enc.putInt32(eph.health);
+         enc.putDouble(eph.accuracy);
+         enc.putDouble(eph.Tgd13);
+         enc.putDouble(eph.Tgd23);
+         enc.putInt32(eph.fitDuration);
+      }
+      else if(name == "QZSEphemeris")
+      {
+         const QZSEphemeris& eph(dynamic_cast<const QZSEphemeris&>(*ptr));
+         enc.putInt8(QZSEphemerisTag);
+         putOrbitEph(enc, eph);
+         enc.putTime(eph.transmitTime);
+         enc.putInt32(eph.HOWtime);
+         enc.putInt32(eph.IODE);
+         enc.putInt32(eph.IODC);
+         enc.putInt32(eph.health);
+         enc.putDouble(eph.accuracy);
+         enc.putDouble(eph.Tgd);
+         enc.putInt32(eph.codeflags);
+         enc.putInt32(eph.L2Pdata);
+         enc.putInt32(eph.fitDuration);
+         enc.putInt32(eph.fitint);
+      }
+      else if(name == "OrbitEph")
+      {
+         enc.putInt8(OrbitEphTag);
+         putOrbitEph(enc, *ptr);
+      }
+      else
+      {
+         InvalidRequest ir("EphemerisCache cannot save " + name + " objects");
+         GPSTK_THROW(ir);
+      }
+   }
+
+      // Decode the members of an OrbitEph, or one of the classes
+      // derived from it, written by putEphemeris() after its tag.
+   static void getEphemeris(CacheDecoder& dec, int tag, OrbitEph *ptr)
+   {
+      getOrbitEph(dec, *ptr);
+      if(tag == GPSEphemerisTag)
+      {
+         GPSEphemeris& eph(dynamic_cast<GPSEphemeris&>(*ptr));
+         eph.transmitTime = dec.getTime();
+         eph.HOWtime = dec.getInt32();
+         eph.IODE = dec.getInt32();
+         eph.IODC = dec.getInt32();
+         eph.health = dec.getInt32();
+         eph.accuracyFlag = dec.getInt32();
+         eph.accuracy = dec.getDouble();
+         eph.Tgd = dec.getDouble();
+         eph.codeflags = dec.getInt32();
+         eph.L2Pdata = dec.getInt32();
+         eph.fitDuration = dec.getInt32();
+         eph.fitint = dec.getInt32();
+      }
+      else if(tag == GalEphemerisTag)
+      {
+         GalEphemeris& eph(dynamic_cast<GalEphemeris&>(*ptr));
+         eph.transmitTime = dec.getTime();
+         eph.HOWtime = dec.getInt32();
+         eph.IODnav = dec.getInt32();
+         eph.health = static_cast<Xvt::HealthStatus>(dec.getInt32());
+         eph.accuracy = dec.getDouble();
+         eph.Tgda = dec.getDouble();
+         eph.Tgdb = dec.getDouble();
+         eph.datasources = dec.getInt32();
+         eph.fitDuration = dec.getInt32();
+      }
+      else if(tag == BDSEphemerisTag)
+      {
+         BDSEphemeris& eph(dynamic_cast<BDSEphemeris&>(*ptr));
+         eph.transmitTime = dec.getTime();
+         eph.HOWtime = dec.getInt32();
+         eph.IODE = dec.getInt32();
+         eph.IODC = dec.getInt32();
+         eph.health = dec.getInt32();
+         eph.accuracy = dec.getDouble();
+         eph.Tgd13 = dec.getDouble();
+         eph.Tgd23 = dec.getDouble();
+         eph.fitDuration = dec.getInt32();
+      }
+      else if(tag == QZSEphemerisTag)
+      {
+         QZSEphemeris& eph(dynamic_cast<QZSEphemeris&>(*ptr));
+         eph.transmitTime = dec.getTime();
+         eph.HOWtime = dec.getInt32();
+         eph.IODE = dec.getInt32();
+         eph.IODC = dec.getInt32();
+         eph.health = dec.getInt32();
+         eph.accuracy = dec.getDouble();
+         eph.Tgd = dec.getDouble();
+         eph.codeflags = dec.getInt32();
+         eph.L2Pdata = dec.getInt32();
+         eph.fitDuration = dec.getInt32();
+         eph.fitint = dec.getInt32();
+      }
+   }
+
+      // Decode an OrbitEph written by putEphemeris(); the caller owns
+      // the object returned.  Throw InvalidRequest for an unknown tag.
+   static OrbitEph *getEphemeris(CacheDecoder& dec)
+   {
+      OrbitEph *ptr(0);
+      int tag(dec.getInt8());
+      switch(tag)
+      {
+         case OrbitEphTag:     ptr = new OrbitEph();     break;
+         case GPSEphemerisTag: ptr = new GPSEphemeris(); break;
+         case GalEphemerisTag: ptr = new GalEphemeris(); break;
+         case BDSEphemerisTag: ptr = new BDSEphemeris(); break;
+         case QZSEphemerisTag: ptr = new QZSEphemeris(); break;
+         default:
+            InvalidRequest ir("Unknown ephemeris type in cache");
+            GPSTK_THROW(ir);
+      }
+
+      try {
+         getEphemeris(dec, tag, ptr);
+      }
+      catch(Exception& e)
+      {
+         delete ptr;
+         GPSTK_RETHROW(e);
+      }
+      return ptr;
+   }
+
+
+   //---------------------------------------------------------------------------
+   void EphemerisCache::write(const string& filename,
+                              const OrbitEphStore& store,
+                              const vector<string>& sources)
+   {
+      try {
+         vector<Source> srcs(sources.size());
+         for(size_t i=0; i<sources.size(); i++)
+         {
+            if(!statFile(sources[i], srcs[i]))
+            {
+               InvalidRequest ir("Cannot find source file " + sources[i]);
+               GPSTK_THROW(ir);
+            }
+            srcs[i].kind = NavSource;
+         }
+
+         string data;
+         CacheEncoder enc(data);
+         set<SatID> sats(store.getIndexSet());
+         uint32_t count(0);
+         set<SatID>::const_iterator sit;
+         for(sit = sats.begin(); sit != sats.end(); ++sit)
+            count += store.getTimeOrbitEphMap(*sit).size();
+         enc.putUint32(count);
+         for(sit = sats.begin(); sit != sats.end(); ++sit)
+         {
+            const OrbitEphStore::TimeOrbitEphTable&
+               table(store.getTimeOrbitEphMap(*sit));
+            OrbitEphStore::TimeOrbitEphTable::const_iterator it;
+            for(it = table.begin(); it != table.end(); ++it)
+               putEphemeris(enc, it->second);
+         }
+
+         writeFile(filename, OrbitEphKind, srcs, data);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------
+   bool EphemerisCache::read(const string& filename,
+                             OrbitEphStore& store,
+                             const vector<string>& sources)
+   {
+      string buffer;
+      vector<Source> srcs;
+      size_t offset;
+      if(!readFile(filename, OrbitEphKind, sources, buffer, srcs, offset))
+         return false;
+
+         // decode everything before changing the store
+      vector<OrbitEph*> ephs;
+      try {
+         CacheDecoder dec(buffer, offset, buffer.size()-4);
+         uint32_t count(dec.getUint32());
+         ephs.reserve(count);
+         for(uint32_t i=0; i<count; i++)
+            ephs.push_back(getEphemeris(dec));
+      }
+      catch(Exception&)
+      {
+         for(size_t i=0; i<ephs.size(); i++)
+            delete ephs[i];
+         return false;
+      }
+
+      try {
+         for(size_t i=0; i<ephs.size(); i++)
+         {
+            store.addEphemeris(ephs[i]);
+            delete ephs[i];
+            ephs[i] = 0;
+         }
+      }
+      catch(Exception& e)
+      {
+         for(size_t i=0; i<ephs.size(); i++)
+            delete ephs[i];
+         GPSTK_RETHROW(e);
+      }
+
+      return true;
+   }
+
+   //---------------------------------------------------------------------------
+   void EphemerisCache::write(const string& filename,
+                              const SP3EphemerisStore& store)
+   {
+      try {
+         vector<Source> srcs;
+         vector<string> names(store.SP3Files.getFileNames());
+         for(size_t i=0; i<names.size(); i++)
+         {
+            Source src;
+            if(!statFile(names[i], src))
+            {
+               InvalidRequest ir("Cannot find source file " + names[i]);
+               GPSTK_THROW(ir);
+            }
+            src.kind = SP3Source;
+            srcs.push_back(src);
+         }
+         if(!store.useSP3clock)
+         {
+            names = store.clkFiles.getFileNames();
+            for(size_t i=0; i<names.size(); i++)
+            {
+               Source src;
+               if(!statFile(names[i], src))
+               {
+                  InvalidRequest ir("Cannot find source file " + names[i]);
+                  GPSTK_THROW(ir);
+               }
+               src.kind = ClockSource;
+               srcs.push_back(src);
+            }
+         }
+
+         string data;
+         CacheEncoder enc(data);
+         enc.putInt32(static_cast<int32_t>(store.storeTimeSystem));
+         enc.putInt8(store.useSP3clock);
+         enc.putInt8(store.rejectBadPosFlag);
+         enc.putInt8(store.rejectBadClockFlag);
+         enc.putInt8(store.rejectPredPosFlag);
+         enc.putInt8(store.rejectPredClockFlag);
+         enc.putInt8(store.posStore.haveVelocity);
+         enc.putInt8(store.posStore.haveAcceleration);
+         enc.putInt8(store.clkStore.haveClockDrift);
+         enc.putInt8(store.clkStore.haveClockAccel);
+
+            // only the members that are not all zero are saved
+         const PositionSatStore::SatTable& pos(store.posStore.tables);
+         int posMask(0);
+         PositionSatStore::SatTable::const_iterator pit;
+         for(pit = pos.begin(); pit != pos.end(); ++pit)
+         {
+            PositionSatStore::DataTable::const_iterator it;
+            for(it = pit->second.begin(); it != pit->second.end(); ++it)
+               for(int k=0; k<6; k++)
+               {
+                  const Triple& t(it->second.*POSITION_MEMBERS[k]);
+                  if(t[0] != 0.0 || t[1] != 0.0 || t[2] != 0.0)
+                     posMask |= (1 << k);
+               }
+         }
+         enc.putInt8(posMask);
+         enc.putUint32(pos.size());
+         for(pit = pos.begin(); pit != pos.end(); ++pit)
+         {
+            enc.putSat(pit->first);
+            enc.putUint32(pit->second.size());
+            PositionSatStore::DataTable::const_iterator it;
+            for(it = pit->second.begin(); it != pit->second.end(); ++it)
+            {
+               const PositionRecord& rec(it->second);
+               enc.putTime(it->first);
+               for(int k=0; k<6; k++)
+                  if(posMask & (1 << k))
+                     enc.putTriple(rec.*POSITION_MEMBERS[k]);
+            }
+         }
+
+         const ClockSatStore::SatTable& clk(store.clkStore.tables);
+         int clkMask(0);
+         ClockSatStore::SatTable::const_iterator cit;
+         for(cit = clk.begin(); cit != clk.end(); ++cit)
+         {
+            ClockSatStore::DataTable::const_iterator it;
+            for(it = cit->second.begin(); it != cit->second.end(); ++it)
+               for(int k=0; k<6; k++)
+                  if(it->second.*CLOCK_MEMBERS[k] != 0.0)
+                     clkMask |= (1 << k);
+         }
+         enc.putInt8(clkMask);
+         enc.putUint32(clk.size());
+         for(cit = clk.begin(); cit != clk.end(); ++cit)
+         {
+            enc.putSat(cit->first);
+            enc.putUint32(cit->second.size());
+            ClockSatStore::DataTable::const_iterator it;
+            for(it = cit->second.begin(); it != cit->second.end(); ++it)
+            {
+               const ClockRecord& rec(it->second);
+               enc.putTime(it->first);
+               for(int k=0; k<6; k++)
+                  if(clkMask & (1 << k))
+                     enc.putDouble(rec.*CLOCK_MEMBERS[k]);
+            }
+         }
+
+         writeFile(filename, SP3Kind, srcs, data);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   //---------------------------------------------------------------------------
+   bool EphemerisCache::read(const string& filename,
+                             SP3EphemerisStore& store,
+                             const vector<string>& sources)
+   {
+      string buffer;
+      vector<Source> srcs;
+      size_t offset;
+      if(!readFile(filename, SP3Kind, sources, buffer, srcs, offset))
+         return false;
+
+         // a source that is already loaded would be loaded twice
+      vector<string> sp3Names(store.SP3Files.getFileNames()),
+         clkNames(store.clkFiles.getFileNames());
+      for(size_t i=0; i<srcs.size(); i++)
+      {
+         const vector<string>& names(srcs[i].kind == SP3Source ? sp3Names
+                                                                : clkNames);
+         if(find(names.begin(), names.end(), srcs[i].name) != names.end())
+            return false;
+      }
+
+         // decode everything before changing the store
+      PositionSatStore::SatTable pos;
+      ClockSatStore::SatTable clk;
+      TimeSystem ts;
+      bool haveVelocity, haveAcceleration, haveClockDrift, haveClockAccel;
+      try {
+         CacheDecoder dec(buffer, offset, buffer.size()-4);
+         ts = static_cast<TimeSystem>(dec.getInt32());
+         bool useSP3clock(dec.getInt8() != 0),
+            rejectBadPos(dec.getInt8() != 0),
+            rejectBadClock(dec.getInt8() != 0),
+            rejectPredPos(dec.getInt8() != 0),
+            rejectPredClock(dec.getInt8() != 0);
+         haveVelocity = (dec.getInt8() != 0);
+         haveAcceleration = (dec.getInt8() != 0);
+         haveClockDrift = (dec.getInt8() != 0);
+         haveClockAccel = (dec.getInt8() != 0);
+
+            // the data depend on the store's settings
+         if(useSP3clock != store.useSP3clock ||
+            rejectBadPos != store.rejectBadPosFlag ||
+            rejectBadClock != store.rejectBadClockFlag ||
+            rejectPredPos != store.rejectPredPosFlag ||
+            rejectPredClock != store.rejectPredClockFlag)
+            return false;
+         if(ts != TimeSystem::Any && store.storeTimeSystem != TimeSystem::Any
+            && ts != store.storeTimeSystem)
+            return false;
+
+            // the records were written in time order, so each is
+            // inserted at the end of its table
+         int posMask(dec.getInt8());
+         uint32_t nsat(dec.getUint32());
+         for(uint32_t i=0; i<nsat; i++)
+         {
+            PositionSatStore::DataTable& table(pos[dec.getSat()]);
+            uint32_t n(dec.getUint32());
+            for(uint32_t j=0; j<n; j++)
+            {
+               CommonTime ttag(dec.getTime());
+               PositionRecord& rec(table.insert(table.end(),
+                  make_pair(ttag, PositionRecord()))->second);
+               for(int k=0; k<6; k++)
+                  if(posMask & (1 << k))
+                     dec.getTriple(rec.*POSITION_MEMBERS[k]);
+            }
+         }
+
+         int clkMask(dec.getInt8());
+         nsat = dec.getUint32();
+         for(uint32_t i=0; i<nsat; i++)
+         {
+            ClockSatStore::DataTable& table(clk[dec.getSat()]);
+            uint32_t n(dec.getUint32());
+            for(uint32_t j=0; j<n; j++)
+            {
+               CommonTime ttag(dec.getTime());
+               ClockRecord& rec(table.insert(table.end(),
+                  make_pair(ttag, ClockRecord()))->second);
+               for(int k=0; k<6; k++)
+                  rec.*CLOCK_MEMBERS[k] = ((clkMask & (1 << k)) ?
+                                           dec.getDouble() : 0.0);
+            }
+         }
+      }
+      catch(Exception&)
+      {
+         return false;
+      }
+
+      try {
+            // the FileStores hold the headers, so read them again
+         vector<SP3Header> sp3Heads(srcs.size());
+         vector<Rinex3ClockHeader> clkHeads(srcs.size());
+         for(size_t i=0; i<srcs.size(); i++)
+         {
+            if(srcs[i].kind == SP3Source)
+            {
+               SP3Stream strm(srcs[i].name.c_str(), ios::in);
+               if(!strm)
+               {
+                  Exception e("File " + srcs[i].name + " could not be opened");
+                  GPSTK_THROW(e);
+               }
+               strm.exceptions(ios::failbit);
+               strm >> sp3Heads[i];
+            }
+            else
+            {
+               Rinex3ClockStream strm(srcs[i].name.c_str(), ios::in);
+               if(!strm)
+               {
+                  Exception e("File " + srcs[i].name + " could not be opened");
+                  GPSTK_THROW(e);
+               }
+               strm.exceptions(ios::failbit);
+               strm >> clkHeads[i];
+            }
+         }
+
+         if(ts != TimeSystem::Any && store.storeTimeSystem == TimeSystem::Any)
+         {
+            store.storeTimeSystem = ts;
+            store.posStore.setTimeSystem(ts);
+            store.clkStore.setTimeSystem(ts);
+         }
+         for(size_t i=0; i<srcs.size(); i++)
+         {
+            if(srcs[i].kind == SP3Source)
+               store.SP3Files.addFile(srcs[i].name, sp3Heads[i]);
+            else
+               store.clkFiles.addFile(srcs[i].name, clkHeads[i]);
+         }
+
+            // a satellite new to the store takes the whole table;
+            // otherwise the records are merged as loading would
+         PositionSatStore& posStore(store.posStore);
+         posStore.invalidateFlatTables();
+         posStore.haveVelocity |= haveVelocity;
+         posStore.haveAcceleration |= haveAcceleration;
+         PositionSatStore::SatTable::iterator pit;
+         for(pit = pos.begin(); pit != pos.end(); ++pit)
+         {
+            PositionSatStore::DataTable& table(posStore.tables[pit->first]);
+            if(table.empty())
+               table.swap(pit->second);
+            else
+            {
+               PositionSatStore::DataTable::const_iterator it;
+               for(it = pit->second.begin(); it != pit->second.end(); ++it)
+                  posStore.addPositionRecord(pit->first, it->first,
+                                             it->second);
+            }
+         }
+
+         ClockSatStore& clkStore(store.clkStore);
+         clkStore.invalidateFlatTables();
+         clkStore.haveClockDrift |= haveClockDrift;
+         clkStore.haveClockAccel |= haveClockAccel;
+         ClockSatStore::SatTable::iterator cit;
+         for(cit = clk.begin(); cit != clk.end(); ++cit)
+         {
+            ClockSatStore::DataTable& table(clkStore.tables[cit->first]);
+            if(table.empty())
+               table.swap(cit->second);
+            else
+            {
+               ClockSatStore::DataTable::const_iterator it;
+               for(it = cit->second.begin(); it != cit->second.end(); ++it)
+                  clkStore.addClockRecord(cit->first, it->first, it->second);
+            }
+         }
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+
+      return true;
+   }
+
+   //---------------------------------------------------------------------------
+   bool EphemerisCache::statFile(const string& name, Source& src)
+   {
+      struct stat st;
+      if(::stat(name.c_str(), &st) != 0)
+         return false;
+      src.name = name;
+      src.size = st.st_size;
+      src.mtime = st.st_mtime;
+      return true;
+   }
+
+   //---------------------------------------------------------------------------
+   void EphemerisCache::writeFile(const string& filename, StoreKind kind,
+                                  const vector<Source>& srcs,
+                                  const string& data)
+   {
+      string buffer(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+      CacheEncoder enc(buffer);
+      enc.putUint32(VERSION);
+      enc.putUint32(kind);
+      enc.putUint32(srcs.size());
+      for(size_t i=0; i<srcs.size(); i++)
+      {
+         enc.putString(srcs[i].name);
+         enc.putInt8(srcs[i].kind);
+         enc.putUint64(srcs[i].size);
+         enc.putInt64(srcs[i].mtime);
+      }
+      buffer.reserve(buffer.size() + data.size() + 4);
+      buffer.append(data);
+      enc.putUint32(BinUtils::computeCRC(
+                       reinterpret_cast<const unsigned char *>(buffer.data()),
+                       buffer.size(), BinUtils::CRC32));
+
+      ofstream ofs(filename.c_str(), ios::out | ios::binary | ios::trunc);
+      if(ofs)
+         ofs.write(buffer.data(), buffer.size());
+      if(!ofs)
+      {
+         InvalidRequest ir("Cannot write cache file " + filename);
+         GPSTK_THROW(ir);
+      }
+   }
+
+   //---------------------------------------------------------------------------
+   bool EphemerisCache::readFile(const string& filename, StoreKind kind,
+                                 const vector<string>& sources,
+                                 string& buffer, vector<Source>& srcs,
+                                 size_t& offset)
+   {
+         // read the whole file in one block
+      ifstream ifs(filename.c_str(), ios::in | ios::binary);
+      if(!ifs)
+         return false;
+      ifs.seekg(0, ios::end);
+      streamoff size(ifs.tellg());
+      if(size < static_cast<streamoff>(sizeof(CACHE_MAGIC) + 16))
+         return false;
+      ifs.seekg(0, ios::beg);
+      buffer.resize(size);
+      if(!ifs.read(&buffer[0], size))
+         return false;
+
+      if(buffer.compare(0, sizeof(CACHE_MAGIC), CACHE_MAGIC,
+                        sizeof(CACHE_MAGIC)) != 0)
+         return false;
+      uint32_t crc;
+      BinUtils::buitohl(buffer.data(), crc, size-4);
+      if(crc != BinUtils::computeCRC(
+             reinterpret_cast<const unsigned char *>(buffer.data()),
+             size-4, BinUtils::CRC32))
+         return false;
+
+      vector<string> names;
+      try {
+         CacheDecoder dec(buffer, sizeof(CACHE_MAGIC), size-4);
+         if(dec.getUint32() != VERSION || dec.getUint32() != uint32_t(kind))
+            return false;
+         uint32_t n(dec.getUint32());
+         srcs.resize(n);
+         for(uint32_t i=0; i<n; i++)
+         {
+            srcs[i].name = dec.getString();
+            srcs[i].kind = dec.getInt8();
+            srcs[i].size = dec.getUint64();
+            srcs[i].mtime = dec.getInt64();
+            names.push_back(srcs[i].name);
+         }
+         offset = dec.pos;
+      }
+      catch(Exception&)
+      {
+         return false;
+      }
+
+         // same set of sources, none changed
+      vector<string> wanted(sources);
+      sort(wanted.begin(), wanted.end());
+      sort(names.begin(), names.end());
+      if(wanted != names)
+         return false;
+      for(size_t i=0; i<srcs.size(); i++)
+      {
+         Source now;
+         if(!statFile(srcs[i].name, now) ||
+            now.size != srcs[i].size || now.mtime != srcs[i].mtime)
+            return false;
+      }
+
+      return true;
+   }
+
+}  // namespace gpstk
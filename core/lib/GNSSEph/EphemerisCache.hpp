@@ -0,0 +1,201 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file EphemerisCache.hpp
+ * Save the contents of ephemeris stores in a binary cache file, and
+ * restore them from it when the source files have not changed. */
+
+#ifndef GPSTK_EPHEMERISCACHE_INCLUDE
+#define GPSTK_EPHEMERISCACHE_INCLUDE
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+#include "OrbitEphStore.hpp"
+#include "SP3EphemerisStore.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** Save and restore the contents of an OrbitEphStore or an
+       * SP3EphemerisStore in a binary cache file, so that the parsing
+       * of the RINEX navigation, SP3 and RINEX clock files from which
+       * the store was loaded is done only once.
+       *
+       * The cache file records the name, size and modification time
+       * of each source file; read() restores the store only if it is
+       * given the same set of source files and none of them has
+       * changed since write().  Otherwise, or if the cache file is
+       * missing, from another version of this class, truncated or
+       * fails its checksum, read() returns false and leaves the store
+       * unchanged; the caller then loads the source files as usual
+       * and calls write() to refresh the cache, e.g.
+       * @code
+       *    SP3EphemerisStore store;
+       *    if(!EphemerisCache::read(cacheFile, store, files)) {
+       *       for(int i=0; i<files.size(); i++)
+       *          store.loadSP3File(files[i]);
+       *       EphemerisCache::write(cacheFile, store);
+       *    }
+       * @endcode
+       *
+       * The file is a header (magic, version, store kind and the
+       * source list) followed by the data, all little-endian, and a
+       * CRC-32 of the whole.  The data are stored as fixed-size
+       * records: CommonTime as its internal day, millisecond of day,
+       * fraction and time system, doubles as IEEE 754; members of the
+       * SP3 records that are zero throughout the store are omitted.
+       * The file is read in a single block and decoded directly into
+       * the tables of the store.  It is not portable to a platform
+       * whose doubles are not IEEE.
+       */
+   class EphemerisCache
+   {
+   public:
+         /// Version of the file format; files of other versions are stale.
+      static const uint32_t VERSION = 1;
+
+         /** Save the ephemerides in an OrbitEphStore, which was loaded
+          * from the given source files.  Supports OrbitEph,
+          * GPSEphemeris, GalEphemeris, BDSEphemeris and QZSEphemeris.
+          * @param[in] filename name of the cache file, overwritten
+          * @param[in] store the store to save
+          * @param[in] sources names of the files loaded into the store
+          * @throw InvalidRequest if a source file cannot be found, the
+          *   store holds another type of OrbitEph, or the cache file
+          *   cannot be written */
+      static void write(const std::string& filename,
+                        const OrbitEphStore& store,
+                        const std::vector<std::string>& sources);
+
+         /** Add the ephemerides saved in a cache file to an
+          * OrbitEphStore, as OrbitEphStore::addEphemeris().
+          * @param[in] filename name of the cache file
+          * @param[in,out] store the store to load
+          * @param[in] sources names of the files the cache must have
+          *   been made from, in any order
+          * @return true if the store was loaded, false if the cache is
+          *   missing, stale or corrupt
+          * @throw InvalidRequest if the store rejects an ephemeris */
+      static bool read(const std::string& filename,
+                       OrbitEphStore& store,
+                       const std::vector<std::string>& sources);
+
+         /** Save the position and clock data in an SP3EphemerisStore;
+          * the source files are the SP3 and RINEX clock files in the
+          * store's FileStores.
+          * @param[in] filename name of the cache file, overwritten
+          * @param[in] store the store to save
+          * @throw InvalidRequest if a source file cannot be found or
+          *   the cache file cannot be written */
+      static void write(const std::string& filename,
+                        const SP3EphemerisStore& store);
+
+         /** Add the data saved in a cache file to an SP3EphemerisStore,
+          * as loading the source files would, including the FileStores
+          * (the headers are read again from the source files).  The
+          * cache is stale if the store's reject flags or clock source
+          * (useSP3 or useRinexClock) differ from those of the store
+          * that was saved, or if a source file is already loaded.
+          * @param[in] filename name of the cache file
+          * @param[in,out] store the store to load
+          * @param[in] sources names of the SP3 and RINEX clock files
+          *   the cache must have been made from, in any order
+          * @return true if the store was loaded, false if the cache is
+          *   missing, stale or corrupt
+          * @throw Exception if a source header cannot be read */
+      static bool read(const std::string& filename,
+                       SP3EphemerisStore& store,
+                       const std::vector<std::string>& sources);
+
+   private:
+         /// Kind of store in a cache file
+      enum StoreKind
+      {
+         OrbitEphKind = 1,
+         SP3Kind = 2
+      };
+
+         /// Kind of source file
+      enum SourceKind
+      {
+         NavSource = 0,
+         SP3Source = 1,
+         ClockSource = 2
+      };
+
+         /// A source file, as recorded in the cache
+      struct Source
+      {
+         std::string name;
+         int kind;            ///< SourceKind
+         uint64_t size;       ///< size in bytes
+         int64_t mtime;       ///< modification time, seconds since 1970
+      };
+
+         /** Get the size and modification time of a file.
+          * @return false if the file cannot be found */
+      static bool statFile(const std::string& name, Source& src);
+
+         /** Write a cache file from its sources and encoded data.
+          * @throw InvalidRequest */
+      static void writeFile(const std::string& filename, StoreKind kind,
+                            const std::vector<Source>& srcs,
+                            const std::string& data);
+
+         /** Read a cache file and check its checksum, kind and sources.
+          * @param[out] buffer contents of the file
+          * @param[out] srcs the sources recorded in the file
+          * @param[out] offset position of the data in buffer
+          * @return false if the file is missing, stale or corrupt */
+      static bool readFile(const std::string& filename, StoreKind kind,
+                           const std::vector<std::string>& sources,
+                           std::string& buffer, std::vector<Source>& srcs,
+                           size_t& offset);
+
+   }; // end class EphemerisCache
+
+      //@}
+
+}  // namespace gpstk
+
+#endif // GPSTK_EPHEMERISCACHE_INCLUDE
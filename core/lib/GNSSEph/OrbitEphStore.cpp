@@ -47,6 +47,7 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 
 #include "StringUtils.hpp"
 #include "MathBase.hpp"
@@ -61,6 +62,56 @@ using namespace gpstk::StringUtils;
 
 namespace gpstk
 {
+      /** One selection of findUserOrbitEph() or findNearOrbitEph(),
+       * eph, which is the selection for sat at any time t in the
+       * interval from lo to hi (excluding an end point where loOpen or
+       * hiOpen is set) and, if compareToe is set, with
+       * (nextToe - t > t - lastToe) == prior. */
+   struct OrbitEphStore::Selection
+   {
+      Selection()
+            : nearest(false), eph(NULL), loOpen(false), hiOpen(false),
+              compareToe(false), prior(false)
+      {}
+
+      bool contains(const CommonTime& t) const
+      {
+         if(loOpen ? !(lo < t) : t < lo) return false;
+         if(hiOpen ? !(t < hi) : hi < t) return false;
+         if(compareToe && (nextToe - t > t - lastToe) != prior) return false;
+         return true;
+      }
+
+         /// Exclude the times before t (and t itself if open)
+      void raiseLo(const CommonTime& t, bool open)
+      {
+         if(lo < t || (open && !(t < lo)))
+         {
+            lo = t;
+            loOpen = open;
+         }
+      }
+
+         /// Exclude the times after t (and t itself if open)
+      void lowerHi(const CommonTime& t, bool open)
+      {
+         if(t < hi || (open && !(hi < t)))
+         {
+            hi = t;
+            hiOpen = open;
+         }
+      }
+
+      SatID sat;
+      bool nearest;
+      const OrbitEph *eph;
+      CommonTime lo, hi;
+      bool loOpen, hiOpen;
+      bool compareToe, prior;
+      CommonTime lastToe, nextToe;
+   };
+
+
    Xvt OrbitEphStore::getXvt(const SatID& sat, const CommonTime& t) const
    {
       try
@@ -116,6 +167,59 @@ namespace gpstk
    }
 
 
+   void OrbitEphStore::computeXvts(const vector<SatID>& ids,
+                                   const vector<CommonTime>& times,
+                                   vector<Xvt>& xvts) const throw()
+   {
+      const size_t nt(times.size());
+      Xvt unavailable;
+      unavailable.health = Xvt::HealthStatus::Unavailable;
+      xvts.assign(ids.size()*nt, unavailable);
+
+      for (size_t i = 0; i < ids.size(); i++)
+      {
+            // find the table once per satellite
+         SatTableMap::const_iterator sit = satTables.find(ids[i]);
+         if (sit == satTables.end() || sit->second.empty())
+            continue;
+         const TimeOrbitEphTable& table = sit->second;
+
+            // lower_bound of the previous time, reused while the times
+            // fall between the same two keys of the table
+         TimeOrbitEphTable::const_iterator it = table.end();
+         bool haveIt = false;
+         for (size_t j = 0; j < nt; j++)
+         {
+            try
+            {
+               const CommonTime& t(times[j]);
+               if (!haveIt ||
+                   (it != table.end() && it->first < t) ||
+                   (it != table.begin() && !(std::prev(it)->first < t)))
+               {
+                  it = table.lower_bound(t);
+                  haveIt = true;
+               }
+
+               const OrbitEph *eph = (strictMethod ?
+                                      selectUserOrbitEph(table, it, t) :
+                                      selectNearOrbitEph(table, it, t));
+               if (eph != nullptr)
+               {
+                  Xvt& rv(xvts[i*nt+j]);
+                  rv = eph->svXvt(t);
+                  rv.health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
+                               : Xvt::HealthStatus::Unhealthy);
+               }
+            }
+            catch (...)
+            {
+            }
+         }
+      }
+   }
+
+
    Xvt::HealthStatus OrbitEphStore ::
    getSVHealth(const SatID& sat, const CommonTime& t) const throw()
    {
@@ -249,6 +353,7 @@ namespace gpstk
    OrbitEph* OrbitEphStore::addEphemeris(const OrbitEph* eph)
    {
       OrbitEph *ret(0);
+      invalidateSelectionCache();
       try {
          // is the satellite found in the table? If not, create one
          if(satTables.find(eph->satID) == satTables.end()) {
@@ -359,6 +464,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::edit(const CommonTime& tmin, const CommonTime& tmax)
    {
+      invalidateSelectionCache();
       for(SatTableMap::iterator i = satTables.begin(); i != satTables.end(); i++)
       {
          TimeOrbitEphTable& eMap = i->second;
@@ -387,6 +493,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::clear(void)
    {
+      invalidateSelectionCache();
       for(SatTableMap::iterator ui=satTables.begin(); ui!=satTables.end(); ui++) {
          TimeOrbitEphTable& toet = ui->second;
          for(TimeOrbitEphTable::iterator toeti = toet.begin(); toeti != toet.end(); toeti++) {
@@ -441,50 +548,59 @@ namespace gpstk
    const OrbitEph* OrbitEphStore::findUserOrbitEph(const SatID& sat,
                                                    const CommonTime& t) const
    {
+      const OrbitEph *eph;
+      if(findCachedSelection(sat, t, false, eph))
+         return eph;
+
       // Is this satellite found in the table?
-      if(satTables.find(sat) == satTables.end())
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end() || sit->second.empty())
          return NULL;
-      // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
 
-      // The map is ordered by beginning times of validity, which
-      // is another way of saying "earliest transmit time".  A call
-      // to table.lower_bound(t) will return the element of the map
-      // with a key "just beyond t" assuming the t is NOT a direct match for any key.
+      const TimeOrbitEphTable& table(sit->second);
+      TimeOrbitEphTable::const_iterator it = table.lower_bound(t);
+      eph = selectUserOrbitEph(table, it, t);
+      saveSelection(sat, t, false, table, it, eph);
+      return eph;
 
-      if (table.empty())
-         return NULL;
+   }  // end OrbitEph* OrbitEphStore::findUserOrbitEph
 
-      TimeOrbitEphTable::const_iterator it = table.find(t);
-      if(it == table.end()) {                   // not a direct match
-         it = table.lower_bound(t);
-
-         // Tricky case here.  If the key is beyond the last key in the table,
-         // lower_bound() will return table.end(). However, this doesn't entirely
-         // settle the matter. It is theoretically possible that the final
-         // item in the table may have an effectivity that "stretches" far enough
-         // to cover time t. Therefore, if it==table.end() we need to check
-         // the period of validity of the final element in the table against time t.
-         if(it == table.end()) {
-            TimeOrbitEphTable::const_reverse_iterator rit = table.rbegin();
-            if(rit->second->isValid(t))         // Last element in map works
-            {
-               return rit->second;
-            }
 
-            // have nothing
-            //string mess = "Time is beyond table for satellite " + asString(sat)
-            //   + " for time " + printTime(t,fmt);
-            //InvalidRequest e(mess);
-            //GPSTK_THROW(e);
-            return NULL;
+   //---------------------------------------------------------------------------------
+   const OrbitEph* OrbitEphStore::selectUserOrbitEph(const TimeOrbitEphTable& table,
+                                     TimeOrbitEphTable::const_iterator it,
+                                     const CommonTime& t)
+   {
+      // The map is ordered by beginning times of validity, which
+      // is another way of saying "earliest transmit time".  The iterator
+      // it = table.lower_bound(t) is either a direct match for t, or
+      // the element of the map with a key "just beyond t".
+
+      // Tricky case here.  If the key is beyond the last key in the table,
+      // lower_bound() will return table.end(). However, this doesn't entirely
+      // settle the matter. It is theoretically possible that the final
+      // item in the table may have an effectivity that "stretches" far enough
+      // to cover time t. Therefore, if it==table.end() we need to check
+      // the period of validity of the final element in the table against time t.
+      if(it == table.end()) {
+         TimeOrbitEphTable::const_reverse_iterator rit = table.rbegin();
+         if(rit->second->isValid(t))         // Last element in map works
+         {
+            return rit->second;
          }
-      }  // end if not a direct match
+
+         // have nothing
+         //string mess = "Time is beyond table for satellite " + asString(sat)
+         //   + " for time " + printTime(t,fmt);
+         //InvalidRequest e(mess);
+         //GPSTK_THROW(e);
+         return NULL;
+      }
 
       // Found a direct match. should probably use the PRIOR set
       // since it takes ~30 seconds from beginning of transmission to complete
       // reception.
-      // If lower_bound( ) was called, it points to the element after the time t,
+      // If there is no direct match, it points to the element after the time t,
       // So either way, it points ONE BEYOND the element we want.
       // The exception is if it is pointing to table.begin( ),
       // then all of the elements in the map are too late.
@@ -522,26 +638,138 @@ namespace gpstk
 
       return it->second;
 
-   }  // end OrbitEph* OrbitEphStore::findUserOrbitEph
+   }  // end OrbitEph* OrbitEphStore::selectUserOrbitEph
 
 
    //---------------------------------------------------------------------------------
    const OrbitEph* OrbitEphStore::findNearOrbitEph(const SatID& sat,
                                                    const CommonTime& t) const
    {
+      const OrbitEph *eph;
+      if(findCachedSelection(sat, t, true, eph))
+         return eph;
+
         // Check for any OrbitEph for this SV
-      if(satTables.find(sat) == satTables.end())
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end() || sit->second.empty())
          return NULL;
 
-      // No OrbitEph in store for requested sat time
-      // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
+      const TimeOrbitEphTable& table(sit->second);
+      TimeOrbitEphTable::const_iterator it = table.lower_bound(t);
+      eph = selectNearOrbitEph(table, it, t);
+      saveSelection(sat, t, true, table, it, eph);
+      return eph;
+   }
 
-      if (table.empty())
-         return NULL;
 
-      TimeOrbitEphTable::const_iterator itNext = table.find(t);
-      if(itNext != table.end())               // exact match
+   //---------------------------------------------------------------------------------
+   OrbitEphStore::SelectionCache::Slot& OrbitEphStore::selectionSlot(
+      const SatID& sat, bool nearest) const
+   {
+      return selCache.slot((static_cast<size_t>(sat.id) * 31
+                            + static_cast<size_t>(sat.system)) * 2
+                           + (nearest ? 1 : 0));
+   }
+
+
+   //---------------------------------------------------------------------------------
+   bool OrbitEphStore::findCachedSelection(const SatID& sat, const CommonTime& t,
+                                           bool nearest, const OrbitEph*& eph) const
+   {
+      const SelectionCache::Slot& slot(selectionSlot(sat, nearest));
+      const Selection& sel(slot.value);
+      if(selCache.holds(slot) && sel.sat == sat && sel.nearest == nearest &&
+         sel.contains(t))
+      {
+         eph = sel.eph;
+         selCache.hit();
+         return true;
+      }
+      selCache.miss();
+      return false;
+   }
+
+
+   //---------------------------------------------------------------------------------
+   // selectUserOrbitEph() and selectNearOrbitEph() choose between at most two
+   // OrbitEph, it and std::prev(it), by their validity [beginValid,endValid]
+   // at t, and for the near search by the distance of t from their Toe.
+   // So eph remains the selection for the times that keep lower_bound() at it
+   // and lie within the validity of eph, as long as the preferred candidate
+   // is the same and, if that is not eph, is still not valid.
+   void OrbitEphStore::saveSelection(const SatID& sat, const CommonTime& t,
+                                     bool nearest,
+                                     const TimeOrbitEphTable& table,
+                                     TimeOrbitEphTable::const_iterator it,
+                                     const OrbitEph *eph) const
+   {
+      if(eph == NULL)
+         return;
+
+      SelectionCache::Slot& cslot(selectionSlot(sat, nearest));
+      SelectionCache::release(cslot);
+      Selection& slot(cslot.value);
+      slot.lo = eph->beginValid;
+      slot.hi = eph->endValid;
+      slot.loOpen = slot.hiOpen = false;
+      slot.compareToe = false;
+
+      if(nearest && it != table.end() && !(t < it->first))
+      {
+         // an exact match is selected at its key only
+         slot.lo = slot.hi = it->first;
+      }
+      else
+      {
+         // times for which lower_bound() is it; for the near search the
+         // key of it itself is an exact match
+         if(it != table.begin())
+            slot.raiseLo(std::prev(it)->first, true);
+         if(it != table.end())
+            slot.lowerHi(it->first, nearest);
+
+         // the other candidate, if any
+         const OrbitEph *other = NULL;
+         if(it != table.begin() && it != table.end())
+            other = (eph == it->second ? std::prev(it)->second : it->second);
+
+         bool preferred(true);
+         if(other != NULL && nearest)
+         {
+            slot.compareToe = true;
+            slot.lastToe = std::prev(it)->second->ctToe;
+            slot.nextToe = it->second->ctToe;
+            slot.prior = (slot.nextToe - t > t - slot.lastToe);
+            preferred = (eph == (slot.prior ? std::prev(it)->second
+                                            : it->second));
+         }
+         else if(other != NULL)
+            preferred = (eph == it->second);
+
+         // eph was selected because other is not valid at t
+         if(!preferred)
+         {
+            if(t < other->beginValid)
+               slot.lowerHi(other->beginValid, true);
+            else
+               slot.raiseLo(other->endValid, true);
+         }
+      }
+
+      slot.sat = sat;
+      slot.nearest = nearest;
+      slot.eph = eph;
+      selCache.fill(cslot);
+   }
+
+
+   //---------------------------------------------------------------------------------
+   const OrbitEph* OrbitEphStore::selectNearOrbitEph(const TimeOrbitEphTable& table,
+                                     TimeOrbitEphTable::const_iterator itNext,
+                                     const CommonTime& t)
+   {
+      // itNext = lower_bound(t), the first element with key >= t
+      if(itNext != table.end() && !(t < itNext->first))   // exact match
          return itNext->second;
 
       // Three cases:
@@ -549,8 +777,6 @@ namespace gpstk
       // 2. t is before all OrbitEph in the store
       // 3. t is after all OrbitEph in the store
 
-      // lower_bound returns the first element with key >= t
-      itNext = table.lower_bound(t);
       if(itNext == table.begin())             // Test for case 2
       {
             // Verify the first item in the table has a fit interval that
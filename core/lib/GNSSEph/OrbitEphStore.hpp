@@ -51,12 +51,14 @@
 #include <iostream>
 #include <list>
 #include <set>
+#include <vector>
 
 #include "OrbitEph.hpp"
 #include "Exception.hpp"
 #include "SatID.hpp"
 #include "CommonTime.hpp"
 #include "XvtStore.hpp"
+#include "ThreadSlotCache.hpp"
 //#include "Rinex3NavData.hpp"
 
 namespace gpstk
@@ -69,6 +71,9 @@ namespace gpstk
        * remove data that has been added. */
    class OrbitEphStore : public XvtStore<SatID>
    {
+         /// XvtStoreSnapshot copies the tables
+      friend class XvtStoreSnapshot;
+
    public:
 
          /** Default empty constructor. Derived classes may want to
@@ -122,6 +127,20 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t) const
          throw();
 
+         /** Compute the Xvt of each of several satellites at each of
+          * several times; see XvtStore::computeXvts().  Each
+          * satellite's table is found once, and the search within it
+          * is skipped when a time falls between the same two table
+          * entries as the previous time.  The ephemerides chosen are
+          * those of findUserOrbitEph() or findNearOrbitEph().
+          * @param[in] ids the satellites
+          * @param[in] times the times to look up
+          * @param[out] xvts the Xvt of ids[i] at times[j] is
+          *   xvts[i*times.size()+j] */
+      virtual void computeXvts(const std::vector<SatID>& ids,
+                               const std::vector<CommonTime>& times,
+                               std::vector<Xvt>& xvts) const throw();
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
@@ -351,6 +370,10 @@ namespace gpstk
          return false; 
       }
 
+         /// Return true if getXvt() uses findNearOrbitEph(), cf. SearchNear()
+      bool isSearchNear(void) const
+      { return !strictMethod; }
+
          /** This map stores sets of unique orbital elements for a
           * single satellite.  The key is the beginning of the period
           * of validity for each set of elements. */
@@ -360,6 +383,21 @@ namespace gpstk
           * key is the SatID of the satellite. */
       typedef std::map<SatID, TimeOrbitEphTable> SatTableMap;
 
+         /** Get the number of findUserOrbitEph() and findNearOrbitEph()
+          * calls answered from the calling threads' ephemeris selection
+          * caches, which skip the search of the satellite's table. */
+      unsigned long getSelectionCacheHits(void) const
+      { return selCache.getHits(); }
+
+         /** Get the number of findUserOrbitEph() and findNearOrbitEph()
+          * calls that searched the satellite's table. */
+      unsigned long getSelectionCacheMisses(void) const
+      { return selCache.getMisses(); }
+
+         /// Reset the selection cache hit and miss counters to zero.
+      void resetSelectionCacheStats(void)
+      { selCache.resetStats(); }
+
          /** Returns a map of the ephemerides available for the
           * specified satellite.  Note that the return is specifically
           * chosen as a const reference.  The intent is to provide
@@ -385,9 +423,65 @@ namespace gpstk
 
       TimeSystem timeSystem;  ///< Time system of store i.e. initial and final times
 
+         /** The selection of findUserOrbitEph(), given the satellite's
+          * table and it = table.lower_bound(t).
+          * @return the OrbitEph, or NULL if none is valid at t */
+      static const OrbitEph* selectUserOrbitEph(
+         const TimeOrbitEphTable& table,
+         TimeOrbitEphTable::const_iterator it,
+         const CommonTime& t);
+
+         /** The selection of findNearOrbitEph(), given the satellite's
+          * table and it = table.lower_bound(t).
+          * @return the OrbitEph, or NULL if none is valid at t */
+      static const OrbitEph* selectNearOrbitEph(
+         const TimeOrbitEphTable& table,
+         TimeOrbitEphTable::const_iterator it,
+         const CommonTime& t);
+
          /// flag indicating search method (find...Eph) to use.
       bool strictMethod;
 
+         /** Look for the selection of findUserOrbitEph() (nearest false)
+          * or findNearOrbitEph() (nearest true) for sat at t in the
+          * calling thread's selection cache.
+          * @param[out] eph the cached OrbitEph, if found
+          * @return true if the cache held the selection at t */
+      bool findCachedSelection(const SatID& sat, const CommonTime& t,
+                               bool nearest, const OrbitEph*& eph) const;
+
+         /** Save eph, selected for sat at t from table with
+          * it = table.lower_bound(t), in the calling thread's
+          * selection cache, together with the interval of times
+          * around t for which the same selection would be made. */
+      void saveSelection(const SatID& sat, const CommonTime& t, bool nearest,
+                         const TimeOrbitEphTable& table,
+                         TimeOrbitEphTable::const_iterator it,
+                         const OrbitEph *eph) const;
+
+         /** Make the selection caches of all threads out of date for
+          * this store.  This must be called by any method that adds,
+          * removes or re-keys entries of satTables. */
+      void invalidateSelectionCache(void)
+      { selCache.invalidate(); }
+
+         /** One selection of findUserOrbitEph() or findNearOrbitEph()
+          * and the times for which it holds; defined in
+          * OrbitEphStore.cpp. */
+      struct Selection;
+
+         /** Per-thread selection caches of all stores; see
+          * ThreadSlotCache.  Each satellite and search method of a
+          * store has one slot. */
+      typedef ThreadSlotCache<Selection, 256> SelectionCache;
+
+         /// Ephemeris selection cache used by find...OrbitEph()
+      SelectionCache selCache;
+
+         /// Return the calling thread's slot for sat and method in selCache
+      SelectionCache::Slot& selectionSlot(const SatID& sat, bool nearest)
+         const;
+
          /// Convenience routines
       void updateTimeLimits(const OrbitEph* eph)
       {
@@ -45,6 +45,7 @@
 #include <iomanip>
 
 #include "PackedNavBits.hpp"
+#include "CRC24Q.hpp"
 #include "GPSWeekSecond.hpp"
 #include "TimeString.hpp"
 //#include "CivilTime.hpp"
@@ -54,10 +55,18 @@
 namespace gpstk
 {
    using namespace std;
+
+      // Number of bits held by a new object
+   static const size_t INITIAL_BITS = 900;
+
+      // Bits in a word of PackedNavBits::bits
+   static const int WORD_BITS = 64;
+
    PackedNavBits::PackedNavBits()
                  : transmitTime(CommonTime::BEGINNING_OF_TIME),
                    parityStatus(psUnknown),
-                   bits(900),
+                   bits((INITIAL_BITS+WORD_BITS-1)/WORD_BITS, 0),
+                   bits_size(INITIAL_BITS),
                    bits_used(0),
                    rxID(""),
                    xMitCoerced(false)
@@ -67,7 +76,8 @@ namespace gpstk
    PackedNavBits::PackedNavBits(const SatID& satSysArg, 
                                 const ObsID& obsIDArg,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : bits((INITIAL_BITS+WORD_BITS-1)/WORD_BITS, 0),
+                                  bits_size(INITIAL_BITS),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
@@ -83,7 +93,8 @@ namespace gpstk
                                 const ObsID& obsIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : bits((INITIAL_BITS+WORD_BITS-1)/WORD_BITS, 0),
+                                  bits_size(INITIAL_BITS),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
@@ -101,7 +112,8 @@ namespace gpstk
                                 const NavID& navIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : bits((INITIAL_BITS+WORD_BITS-1)/WORD_BITS, 0),
+                                  bits_size(INITIAL_BITS),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
@@ -124,12 +136,10 @@ namespace gpstk
       rxID   = right.rxID;
       transmitTime = right.transmitTime;
       bits_used = right.bits_used;
-      bits.resize(bits_used);
+      bits_size = 0;
+      resizeBits(bits_used);
       parityStatus = right.parityStatus;
-      for (int i=0;i<bits_used;i++)
-      {
-         bits[i] = right.bits[i];
-      }
+      copyField(right, 0, 0, bits_used);
       xMitCoerced = right.xMitCoerced;
    }
  
@@ -188,6 +198,7 @@ namespace gpstk
    void PackedNavBits::clearBits()
    {
       bits.clear();
+      bits_size = 0;
       bits_used = 0;
    }
 
@@ -225,20 +236,81 @@ namespace gpstk
    uint64_t PackedNavBits::asUint64_t(const int startBit, 
                                       const int numBits ) const
    {
-      uint64_t temp = 0L;       // Set up a temporary variable with a known size
-                                // It needs to be AT LEAST 33 bits.
       size_t stop = startBit + numBits;
-      if (stop>bits.size())
+      if (stop>bits_size)
       {
          InvalidParameter exc("Requested bits not present.");
          GPSTK_THROW(exc);
       }
-      for (size_t i=startBit; i<stop; ++i)
+      if (numBits<=0) return 0;
+         // Only the last 64 bits of a longer field fit in the result
+      if (numBits>WORD_BITS)
+         return getField(stop-WORD_BITS, WORD_BITS);
+      return getField(startBit, numBits);
+   }
+
+   uint64_t PackedNavBits::getField(const size_t startBit,
+                                    const int numBits) const
+   {
+      if (numBits==0) return 0;
+      size_t ndx = startBit / WORD_BITS;
+      int offset = startBit % WORD_BITS;
+      uint64_t temp = bits[ndx] << offset;
+      if (offset+numBits > WORD_BITS)
+         temp |= bits[ndx+1] >> (WORD_BITS-offset);
+      return temp >> (WORD_BITS-numBits);
+   }
+
+   void PackedNavBits::setField(const size_t startBit,
+                                const int numBits,
+                                const uint64_t value)
+   {
+      if (numBits<=0) return;
+      uint64_t field = value;
+      if (numBits<WORD_BITS) field &= (uint64_t(1) << numBits) - 1;
+      size_t ndx = startBit / WORD_BITS;
+      int offset = startBit % WORD_BITS;
+      int end = offset + numBits;
+      if (end <= WORD_BITS)
+      {
+         int shift = WORD_BITS - end;
+         uint64_t mask = (numBits==WORD_BITS) ? ~uint64_t(0) :
+            ((uint64_t(1) << numBits) - 1) << shift;
+         bits[ndx] = (bits[ndx] & ~mask) | (field << shift);
+      }
+      else
       {
-         temp <<= 1;
-         if (bits[i]) temp++;
+            // The first WORD_BITS-offset bits end the first word, the
+            // rest start the second.
+         int numBits2 = end - WORD_BITS;
+         uint64_t mask1 = (uint64_t(1) << (WORD_BITS-offset)) - 1;
+         bits[ndx] = (bits[ndx] & ~mask1) | (field >> numBits2);
+         int shift = WORD_BITS - numBits2;
+         uint64_t mask2 = ~uint64_t(0) << shift;
+         bits[ndx+1] = (bits[ndx+1] & ~mask2) | (field << shift);
+      }
+   }
+
+   void PackedNavBits::resizeBits(const size_t newSize)
+   {
+      bits.resize((newSize+WORD_BITS-1)/WORD_BITS, 0);
+         // Keep the bits past the end 0
+      int used = newSize % WORD_BITS;
+      if (used>0)
+         bits.back() &= ~uint64_t(0) << (WORD_BITS-used);
+      bits_size = newSize;
+   }
+
+   void PackedNavBits::copyField(const PackedNavBits& src,
+                                 const size_t srcBit,
+                                 const size_t startBit,
+                                 const size_t numBits)
+   {
+      for (size_t i=0; i<numBits; i+=WORD_BITS)
+      {
+         int n = (numBits-i < size_t(WORD_BITS)) ? numBits-i : WORD_BITS;
+         setField(startBit+i, n, src.getField(srcBit+i, n));
       }
-      return( temp ); 
    }
 
    unsigned long PackedNavBits::asUnsignedLong(const int startBit, 
@@ -457,7 +529,7 @@ namespace gpstk
 
    bool PackedNavBits::asBool( const unsigned bitNum) const
    {
-      return bits[bitNum]; 
+      return getField(bitNum, 1) != 0;
    }
 
 
@@ -592,31 +664,16 @@ namespace gpstk
    {
       int old_bits_used = bits_used;
       bits_used += right.bits_used;
-      bits.resize(bits_used);
-      
-      for (int i=0;i<right.bits_used;i++)
-      {
-         bits[i+old_bits_used] = right.bits[i];
-      }
+      resizeBits(bits_used);
+      copyField(right, 0, old_bits_used, right.bits_used);
    }
 
    void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
    {
-      size_t ndx = bits_used;
-      uint64_t mask = 0x0000000000000001L;
-      mask <<= (numBits-1);
-
-      for (int i=0; i<numBits; ++i)
-      {
-         bits[ndx] = false;
-         if (value & mask) 
-         {
-             //set the bits to true
-            bits[ndx] = true;
-         }
-         mask>>= 1;
-         ndx++;
-      }
+         // Grow the storage if the new bits don't fit
+      if (numBits>0 && size_t(bits_used+numBits)>bits_size)
+         resizeBits(bits_used+numBits);
+      setField(bits_used, numBits, value);
       bits_used += numBits;
    }
 
@@ -627,9 +684,9 @@ namespace gpstk
    // in which left has a FALSE whereas right has a TRUE starting at the 
    // lowest index and scanning to the maximum index.
    //
-   // NOTE: This is one of the cases in which the PackedNavBits implementation 
-   // is probably not the fastest.  Since we are scanning a bit array rather 
-   // than testing a series of unsigned ints.
+   //
+   // Since the bits are stored MSB first and the bits past the end are 0,
+   // the first differing bit is found by comparing whole words.
    bool PackedNavBits::operator<(const PackedNavBits& right) const
    {
          // If the two objects don't have the same number of bits,
@@ -637,27 +694,49 @@ namespace gpstk
          // happen.  In the context of NavFilter, data SHOULD be
          // from the same system, therefore, the same length should 
          // always be true.
-      if (bits.size()!=right.bits.size())
+      if (bits_size!=right.bits_size)
       {
-         if (bits.size()<right.bits.size()) return true;
+         if (bits_size<right.bits_size) return true;
          return false;
       }
 
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<bits.size();i++)
       {
-         if (bits[i]==false && right.bits[i]==true)
-         //if (bits[i]<right.bits[i])
+         if (bits[i]!=right.bits[i])
          {
-            return true;
-         }
-         if (bits[i]==true && right.bits[i]==false)
-         {
-            return false;
+            return bits[i]<right.bits[i];
          }
       }
       return false;
    }
 
+   std::size_t PackedNavBits::hash() const
+   {
+         // FNV-1a over the words, then the size
+      uint64_t h = 14695981039346656037ULL;
+      for (size_t i=0;i<bits.size();i++)
+      {
+         h ^= bits[i];
+         h *= 1099511628211ULL;
+      }
+      h ^= bits_size;
+      h *= 1099511628211ULL;
+      return static_cast<std::size_t>(h ^ (h >> 32));
+   }
+
+   uint32_t PackedNavBits::crc24q() const
+   {
+      return CRC24Q::computeBits(bits.data(), bits_used);
+   }
+
+   std::vector<bool> PackedNavBits::getBits() const
+   {
+      std::vector<bool> rv(bits_size);
+      for (size_t i=0;i<bits_size;i++)
+         rv[i] = getField(i, 1) != 0;
+      return rv;
+   }
+
    void PackedNavBits::invert( )
    {
          // Each bit is either 1 or 0.
@@ -669,11 +748,13 @@ namespace gpstk
          //    0       1 - 0          1
          //
          // This accomplishes the purpose without incurring
-         // the cost of a conditional statement.
-      for (int i=0;i<bits.size();i++)
+         // the cost of a conditional statement.  A word at a time, it
+         // is a complement; resizeBits() clears the bits past the end.
+      for (size_t i=0;i<bits.size();i++)
       {
-         bits[i] = 1 - bits[i];
+         bits[i] = ~bits[i];
       }
+      resizeBits(bits_size);
    } 
 
       /**
@@ -697,10 +778,8 @@ namespace gpstk
       short finalBit = endBit;
       if (finalBit==-1) finalBit = bits_used - 1;
 
-      for (short i=startBit; i<=finalBit; i++)
-      {
-         bits[i] = src.bits[i];
-      }
+      if (finalBit>=startBit)
+         copyField(src, startBit, startBit, finalBit-startBit+1);
    }
 
 
@@ -729,20 +808,7 @@ namespace gpstk
          GPSTK_THROW(exc);
       }
 
-      size_t ndx = startBit;
-      uint64_t mask = 0x0000000000000001L; 
-
-      mask <<= (numBits-1);
-      for (int i=0; i<numBits; i++)
-      {
-         bits[ndx] = false;
-         if (out & mask)
-         {
-            bits[ndx] = true;
-         }
-         mask >>= 1;
-         ndx++;
-      }
+      setField(startBit, numBits, out);
    }
 
 
@@ -757,7 +823,7 @@ namespace gpstk
    //--------------------------------------------------------------------------
    void PackedNavBits::trimsize()
    {
-      bits.resize(bits_used);
+      resizeBits(bits_used);
    }
 
    //--------------------------------------------------------------------------
@@ -820,10 +886,10 @@ namespace gpstk
       int numBitInWord = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (getField(i, 1)) word++;
        
          numBitInWord++;
          if (numBitInWord >= 32)
@@ -859,10 +925,10 @@ namespace gpstk
       int bit_count    = 0; 
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (getField(i, 1)) word++;
        
          numBitInWord++;
          if (numBitInWord >= numBitsPerWord)
@@ -876,7 +942,7 @@ namespace gpstk
             //but ONLY if there are more bits left to put on the next line.
             if (word_count>0 && 
                 word_count % rollover == 0 &&
-                (i+1) < bits.size()) s << endl;        
+                (i+1) < bits_size) s << endl;        
          }
       }
          // Need to check if there is a partial word in the buffer
@@ -886,7 +952,7 @@ namespace gpstk
          s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
-      return(bits.size()); 
+      return(bits_size); 
    }
 
    bool PackedNavBits::operator==(const PackedNavBits& right) const
@@ -939,19 +1005,21 @@ namespace gpstk
    {
          // If the two objects don't have the same number of bits,
          // don't even try to compare them. 
-      if (bits.size()!=right.bits.size()) return false; 
+      if (bits_size!=right.bits_size) return false; 
+      if (bits_size==0) return true;
 
       short startBit = startBitA;
       short endBit = endBitA; 
          // Check for nonsense arguments
       if (endBit==-1 ||
-          endBit>=int(bits.size())) endBit = bits.size()-1;
+          endBit>=int(bits_size)) endBit = bits_size-1;
       if (startBit<0) startBit=0;
-      if (startBit>=int(bits.size())) startBit = bits.size()-1;
+      if (startBit>=int(bits_size)) startBit = bits_size-1;
 
-      for (int i=startBit;i<=endBit;i++)
+      for (int i=startBit;i<=endBit;i+=WORD_BITS)
       {
-         if (bits[i]!=right.bits[i])
+         int n = (endBit-i+1 < WORD_BITS) ? endBit-i+1 : WORD_BITS;
+         if (getField(i, n)!=right.getField(i, n))
          {
             return false;
          }
@@ -60,6 +60,14 @@ namespace gpstk
       /// @ingroup ephemcalc 
       //@{
 
+      /**
+       * PackedNavBits holds a navigation message (subframe, message,
+       * string, ...) as a sequence of bits together with the metadata
+       * that identify it.  The bits are stored 64 to a word, first bit in
+       * the MSB, so that fields are unpacked and packed with a shift and a
+       * mask of at most two words, and operator<, matchBits() and hash()
+       * work a word at a time.
+       */
    class PackedNavBits
    {
    public:
@@ -369,6 +377,19 @@ namespace gpstk
           */
       bool operator<(const PackedNavBits& right) const; 
 
+         /**
+          * Return a hash of the bits (not the metadata), e.g. for use
+          * with unordered containers.  Objects for which matchBits() is
+          * true over all bits have the same hash.
+          */
+      std::size_t hash() const;
+
+         /**
+          * Return the CRC-24Q of the bits in use (see CRC24Q).  This
+          * is 0 for a GPS CNAV or CNAV-2 message with good parity.
+          */
+      uint32_t crc24q() const;
+
          /**
           *  Bitwise invert contents of this object.
           */
@@ -436,8 +457,8 @@ namespace gpstk
       void setXmitCoerced(bool tf=true) {xMitCoerced=tf;}
       bool isXmitCoerced() const {return xMitCoerced;}
 
-      const std::vector<bool>& getBits() const
-      { return bits; }
+         /// Return a copy of the bits, one element per bit.
+      std::vector<bool> getBits() const;
 
          /** Indicate the status of parity/CRC checking.  Must be
           * explicitly set after construction, no parity checking is
@@ -450,7 +471,9 @@ namespace gpstk
       NavID navID;             /**< Defines the navigation message tracked */ 
       std::string rxID;        /**< Defines the receiver that collected the data */
       CommonTime transmitTime; /**< Time nav message is transmitted */
-      std::vector<bool> bits;  /**< Holds the packed data */
+      std::vector<uint64_t> bits; /**< Holds the packed data, MSB first */
+      size_t bits_size;        /**< Number of bits held in bits; bits
+                                  beyond this are always 0 */
       int bits_used;
       
       bool xMitCoerced;        /**< Used to indicate that the transmit
@@ -462,6 +485,24 @@ namespace gpstk
           */
       uint64_t asUint64_t(const int startBit, const int numBits ) const;
 
+         /** Return numBits (0-64) bits starting at startBit, right
+          * justified, without checking the range. */
+      uint64_t getField(const size_t startBit, const int numBits) const;
+
+         /** Overwrite numBits (0-64) bits starting at startBit with the
+          * low numBits bits of value, without checking the range. */
+      void setField(const size_t startBit, const int numBits,
+                    const uint64_t value);
+
+         /** Change the number of bits held, clearing any bits dropped
+          * from the last word and adding 0 bits. */
+      void resizeBits(const size_t newSize);
+
+         /** Copy numBits bits of src starting at srcBit to this object
+          * starting at startBit. */
+      void copyField(const PackedNavBits& src, const size_t srcBit,
+                     const size_t startBit, const size_t numBits);
+
          /** Pack the bits */
       void addUint64_t( const uint64_t value, const int numBits );
 
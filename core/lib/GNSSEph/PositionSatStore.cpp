@@ -83,23 +83,18 @@ namespace gpstk
       return os;
    }
 
-   // Return value for the given satellite at the given time (usually via
-   // interpolation of the data table). This interface from TabularSatStore.
-   // @param[in] sat the SatID of the satellite of interest
-   // @param[in] ttag the time (CommonTime) of interest
-   // @return object of type PositionRecord containing the data value(s).
-   // @throw InvalidRequest if data value cannot be computed, for example because
-   //  a) the time t does not lie within the time limits of the data table
-   //  b) checkDataGap is true and there is a data gap
-   //  c) checkInterval is true and the interval is larger than maxInterval
-   PositionRecord PositionSatStore::getValue(const SatID& sat, const CommonTime& ttag)
+   // Implementation of getValue(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   PositionRecord PositionSatStore::getValueFrom(const SatID& sat,
+                                                 const CommonTime& ttag)
       const
    {
       try {
          bool isExact;
          int i;
          PositionRecord rec;
-         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+         TableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
 
          isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity);
          if(isExact && haveVelocity) {
@@ -187,20 +182,129 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
-   // Return the position for the given satellite at the given time
+   // Implementation of getValue() using the interpolation window cache: the
+   // same computation as getValueFrom(), with the Lagrange weights of the
+   // window applied to all components of the records in one pass.
+   PositionRecord PositionSatStore::getValueWindow(const SatID& sat,
+                                                   const CommonTime& ttag)
+      const
+   {
+      try {
+         InterpWindow& win(findWindow(sat, ttag, Nhalf, haveVelocity));
+         if(win.isExact && haveVelocity)
+            return win.recs[0];
+
+         size_t i,n,N(win.recs.size()),Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
+         if(win.isExact) Nmatch = win.match;
+         if(win.isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
+
+         // Lagrange interpolation; the derivative is needed unless both
+         // velocity and acceleration are tabulated
+         PositionRecord rec;
+         double dt(ttag-win.t0), P[3]={0,0,0}, V[3]={0,0,0}, A[3]={0,0,0};
+         if(haveVelocity && haveAcceleration) {
+            win.lagrange.coefficients(dt, win.L);
+            for(n=0; n<N; n++) {
+               const PositionRecord& r(win.recs[n]);
+               for(i=0; i<3; i++) {
+                  P[i] += win.L[n]*r.Pos[i];
+                  V[i] += win.L[n]*r.Vel[i];
+                  A[i] += win.L[n]*r.Acc[i];
+               }
+            }
+         }
+         else if(haveVelocity) {
+            // interpolate velocities(dm/s) to get V and A
+            win.lagrange.coefficients(dt, win.L, win.Lp);
+            for(n=0; n<N; n++) {
+               const PositionRecord& r(win.recs[n]);
+               for(i=0; i<3; i++) {
+                  P[i] += win.L[n]*r.Pos[i];
+                  V[i] += win.L[n]*r.Vel[i];
+                  A[i] += win.Lp[n]*r.Vel[i];
+               }
+            }
+            for(i=0; i<3; i++)
+               A[i] *= 0.1;         // dm/s/s -> m/s/s
+         }
+         else {
+            // no V data - interpolate positions(km) to get P and V
+            win.lagrange.coefficients(dt, win.L, win.Lp);
+            for(n=0; n<N; n++) {
+               const PositionRecord& r(win.recs[n]);
+               for(i=0; i<3; i++) {
+                  P[i] += win.L[n]*r.Pos[i];
+                  V[i] += win.Lp[n]*r.Pos[i];
+               }
+            }
+            for(i=0; i<3; i++)
+               V[i] *= 10000.;      // km/sec -> dm/sec
+         }
+
+         rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
+         for(i=0; i<3; i++) {
+            rec.Pos[i] = P[i];
+            rec.Vel[i] = V[i];
+            if(haveVelocity) {
+               rec.Acc[i] = A[i];
+               if(win.isExact) {
+                  rec.sigPos[i] = win.recs[Nmatch].sigPos[i];
+                  rec.sigVel[i] = win.recs[Nmatch].sigVel[i];
+                  if(haveAcceleration)
+                     rec.sigAcc[i] = win.recs[Nmatch].sigAcc[i];
+               }
+               else {
+                  rec.sigPos[i] = RSS(win.recs[Nhi].sigPos[i],
+                                      win.recs[Nlow].sigPos[i]);
+                  rec.sigVel[i] = RSS(win.recs[Nhi].sigVel[i],
+                                      win.recs[Nlow].sigVel[i]);
+                  if(haveAcceleration)
+                     rec.sigAcc[i] = RSS(win.recs[Nhi].sigAcc[i],
+                                         win.recs[Nlow].sigAcc[i]);
+               }
+            }
+            else {
+               if(win.isExact)
+                  rec.sigPos[i] = win.recs[Nmatch].sigPos[i];
+               else
+                  rec.sigPos[i] = RSS(win.recs[Nhi].sigPos[i],
+                                      win.recs[Nlow].sigPos[i]);
+               rec.sigVel[i] = 0.0;
+            }
+         }
+         return rec;
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
+
+   // Return value for the given satellite at the given time (usually via
+   // interpolation of the data table). This interface from TabularSatStore.
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
-   // @return Triple containing the position ECEF XYZ meters
-   // @throw InvalidRequest if result cannot be computed, for example because
+   // @return object of type PositionRecord containing the data value(s).
+   // @throw InvalidRequest if data value cannot be computed, for example because
    //  a) the time t does not lie within the time limits of the data table
    //  b) checkDataGap is true and there is a data gap
    //  c) checkInterval is true and the interval is larger than maxInterval
-   Triple PositionSatStore::getPosition(const SatID& sat, const CommonTime& ttag)
+   PositionRecord PositionSatStore::getValue(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useWindowCache)
+         return getValueWindow(sat, ttag);
+      if(useFlatTables)
+         return getValueFrom<FlatTableIterator>(sat, ttag);
+      return getValueFrom<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getPosition(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   Triple PositionSatStore::getPositionFrom(const SatID& sat, const CommonTime& ttag)
       const
    {
       try {
          int i;
-         DataTableIterator it1, it2, kt;
+         TableIterator it1, it2, kt;
 
          if(getTableInterval(sat, ttag, Nhalf, it1, it2, true)) {
             // exact match
@@ -232,20 +336,31 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
-   // Return the velocity for the given satellite at the given time
+   // Return the position for the given satellite at the given time
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
-   // @return Triple containing the velocity ECEF XYZ meters/second
+   // @return Triple containing the position ECEF XYZ meters
    // @throw InvalidRequest if result cannot be computed, for example because
    //  a) the time t does not lie within the time limits of the data table
    //  b) checkDataGap is true and there is a data gap
    //  c) checkInterval is true and the interval is larger than maxInterval
-   Triple PositionSatStore::getVelocity(const SatID& sat, const CommonTime& ttag)
+   Triple PositionSatStore::getPosition(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useFlatTables)
+         return getPositionFrom<FlatTableIterator>(sat, ttag);
+      return getPositionFrom<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getVelocity(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   Triple PositionSatStore::getVelocityFrom(const SatID& sat, const CommonTime& ttag)
       const
    {
       try {
          int i;
-         DataTableIterator it1, it2, kt;
+         TableIterator it1, it2, kt;
 
          bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity));
          if(isExact && haveVelocity) {
@@ -285,16 +400,27 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
-   // Return the acceleration for the given satellite at the given time
+   // Return the velocity for the given satellite at the given time
    // @param[in] sat the SatID of the satellite of interest
    // @param[in] ttag the time (CommonTime) of interest
-   // @return Triple containing the acceleration ECEF XYZ meters/second/second
+   // @return Triple containing the velocity ECEF XYZ meters/second
    // @throw InvalidRequest if result cannot be computed, for example because
    //  a) the time t does not lie within the time limits of the data table
    //  b) checkDataGap is true and there is a data gap
    //  c) checkInterval is true and the interval is larger than maxInterval
-   //  d) neither velocity nor acceleration data are present
-   Triple PositionSatStore::getAcceleration(const SatID& sat, const CommonTime& ttag)
+   Triple PositionSatStore::getVelocity(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useFlatTables)
+         return getVelocityFrom<FlatTableIterator>(sat, ttag);
+      return getVelocityFrom<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getAcceleration(), using iterators into either the maps
+   // (DataTableIterator) or the flat tables (FlatTableIterator).
+   template <class TableIterator>
+   Triple PositionSatStore::getAccelerationFrom(const SatID& sat,
+                                                const CommonTime& ttag)
       const
    {
       if(!haveVelocity && !haveAcceleration) {
@@ -304,7 +430,7 @@ namespace gpstk
 
       try {
          int i;
-         DataTableIterator it1, it2, kt;
+         TableIterator it1, it2, kt;
 
          bool isExact(getTableInterval(sat,ttag,Nhalf,it1,it2,haveAcceleration));
          if(isExact && haveAcceleration) {
@@ -344,12 +470,30 @@ namespace gpstk
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
    }
 
+   // Return the acceleration for the given satellite at the given time
+   // @param[in] sat the SatID of the satellite of interest
+   // @param[in] ttag the time (CommonTime) of interest
+   // @return Triple containing the acceleration ECEF XYZ meters/second/second
+   // @throw InvalidRequest if result cannot be computed, for example because
+   //  a) the time t does not lie within the time limits of the data table
+   //  b) checkDataGap is true and there is a data gap
+   //  c) checkInterval is true and the interval is larger than maxInterval
+   //  d) neither velocity nor acceleration data are present
+   Triple PositionSatStore::getAcceleration(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      if(useFlatTables)
+         return getAccelerationFrom<FlatTableIterator>(sat, ttag);
+      return getAccelerationFrom<DataTableIterator>(sat, ttag);
+   }
+
    // Add a PositionRecord to the store.
    void PositionSatStore::addPositionRecord(const SatID& sat, const CommonTime& ttag,
                                             const PositionRecord& rec)
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          int i;
          if(!haveVelocity)
@@ -381,6 +525,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          if(tables.find(sat) != tables.end() &&
             tables[sat].find(ttag) != tables[sat].end()) {
@@ -407,6 +552,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          haveVelocity = true;
 
@@ -435,6 +581,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         invalidateFlatTables();
 
          haveAcceleration = true;
 
@@ -99,6 +99,10 @@ namespace gpstk
        *   derived classes must deal with units consistently.*/
    class PositionSatStore : public TabularSatStore<PositionRecord>
    {
+         /// EphemerisCache saves and restores the tables
+      friend class EphemerisCache;
+         /// SP3EphemerisStore::computeXvts() interpolates with windows
+      friend class SP3EphemerisStore;
 
          // member data
    protected:
@@ -119,6 +123,25 @@ namespace gpstk
          /// Store half the interpolation order, for convenience
       unsigned int Nhalf;
 
+         /** Implementations of getValue(), getPosition(),
+          * getVelocity() and getAcceleration(); TableIterator is
+          * DataTableIterator or FlatTableIterator, cf. setFlatTables() */
+      template <class TableIterator>
+      PositionRecord getValueFrom(const SatID& sat, const CommonTime& ttag)
+         const;
+      template <class TableIterator>
+      Triple getPositionFrom(const SatID& sat, const CommonTime& ttag) const;
+      template <class TableIterator>
+      Triple getVelocityFrom(const SatID& sat, const CommonTime& ttag) const;
+      template <class TableIterator>
+      Triple getAccelerationFrom(const SatID& sat, const CommonTime& ttag)
+         const;
+
+         /** Implementation of getValue() with barycentric weights and
+          * the interpolation window cache, cf. setWindowCache() */
+      PositionRecord getValueWindow(const SatID& sat, const CommonTime& ttag)
+         const;
+
          // member functions
    public:
 
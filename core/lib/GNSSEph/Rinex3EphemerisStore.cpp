@@ -344,6 +344,79 @@ namespace gpstk
    }
 
 
+   void Rinex3EphemerisStore ::
+   computeXvts(const vector<SatID>& ids, const vector<CommonTime>& intimes,
+               vector<Xvt>& xvts) const throw()
+   {
+      const size_t nt(intimes.size());
+      Xvt unavailable;
+      unavailable.health = Xvt::HealthStatus::Unavailable;
+      xvts.assign(ids.size()*nt, unavailable);
+
+         // group the satellites by time system, which also selects the store
+      map<TimeSystem, vector<size_t> > groups;
+      for(size_t i=0; i<ids.size(); i++)
+      {
+         switch(ids[i].system)
+         {
+            case SatelliteSystem::GPS:
+               groups[TimeSystem::GPS].push_back(i); break;
+            case SatelliteSystem::Galileo:
+               groups[TimeSystem::GAL].push_back(i); break;
+            case SatelliteSystem::BeiDou:
+               groups[TimeSystem::BDT].push_back(i); break;
+            case SatelliteSystem::QZSS:
+               groups[TimeSystem::QZS].push_back(i); break;
+            case SatelliteSystem::Glonass:
+               groups[TimeSystem::GLO].push_back(i); break;
+            default:
+               break;
+         }
+      }
+
+      map<TimeSystem, vector<size_t> >::const_iterator git;
+      for(git = groups.begin(); git != groups.end(); ++git)
+      {
+         const TimeSystem& ts(git->first);
+         const vector<size_t>& index(git->second);
+
+            // correct each time once; times that cannot be corrected
+            // remain Unavailable
+         vector<CommonTime> times;
+         vector<size_t> tindex;
+         for(size_t j=0; j<nt; j++)
+         {
+            try
+            {
+               times.push_back(correctTimeSystem(intimes[j], ts));
+               tindex.push_back(j);
+            }
+            catch(...)
+            {
+            }
+         }
+         if(times.empty())
+            continue;
+
+         vector<SatID> sats;
+         for(size_t k=0; k<index.size(); k++)
+            sats.push_back(ids[index[k]]);
+
+         vector<Xvt> subxvts;
+         if(ts == TimeSystem::GLO)
+            GLOstore.computeXvts(sats, times, subxvts);
+         else
+            ORBstore.computeXvts(sats, times, subxvts);
+
+         for(size_t k=0; k<index.size(); k++)
+         {
+            for(size_t j=0; j<tindex.size(); j++)
+               xvts[index[k]*nt+tindex[j]] = subxvts[k*times.size()+j];
+         }
+      }
+   }
+
+
    Xvt::HealthStatus Rinex3EphemerisStore ::
    getSVHealth(const SatID& sat, const CommonTime& inttag) const throw()
    {
@@ -73,6 +73,9 @@ namespace gpstk
 
    class Rinex3EphemerisStore : public XvtStore<SatID>
    {
+         /// XvtStoreSnapshot copies the system stores
+      friend class XvtStoreSnapshot;
+
          // member data:
    private:
 
@@ -149,6 +152,18 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t) const
          throw();
 
+         /** Compute the Xvt of each of several satellites at each of
+          * several times; see XvtStore::computeXvts().  The times are
+          * corrected once per satellite system, and each system's
+          * satellites are passed as one batch to the underlying store.
+          * @param[in] ids the satellites
+          * @param[in] times the times to look up
+          * @param[out] xvts the Xvt of ids[i] at times[j] is
+          *   xvts[i*times.size()+j] */
+      virtual void computeXvts(const std::vector<SatID>& ids,
+                               const std::vector<CommonTime>& times,
+                               std::vector<Xvt>& xvts) const throw();
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
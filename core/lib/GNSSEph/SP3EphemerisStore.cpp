@@ -115,6 +115,33 @@ namespace gpstk
    }
 
 
+   Xvt SP3EphemerisStore::makeXvt(const PositionRecord& prec,
+                                  const ClockRecord& crec) const
+   {
+      Xvt rv;
+      for (int i=0; i<3; i++)
+      {
+         rv.x[i] = prec.Pos[i] * 1000.0;    // km -> m
+         rv.v[i] = prec.Vel[i] * 0.1;       // dm/s -> m/s
+      }
+      if (useSP3clock)
+      {                                        // SP3
+         rv.clkbias = crec.bias * 1.e-6;       // microsec -> sec
+         rv.clkdrift = crec.drift * 1.e-6;     // microsec/sec -> sec/sec
+      }
+      else
+      {                                        // RINEX clock
+         rv.clkbias = crec.bias;               // sec
+         rv.clkdrift = crec.drift;             // sec/sec
+      }
+
+         // compute relativity correction, in seconds
+      rv.computeRelativityCorrection();
+      rv.health = Xvt::HealthStatus::Unused;
+      return rv;
+   }
+
+
    Xvt SP3EphemerisStore::computeXvt(const SatID& sat, const CommonTime& ttag)
       const throw()
    {
@@ -141,25 +168,7 @@ namespace gpstk
 
       try
       {
-         for (int i=0; i<3; i++)
-         {
-            rv.x[i] = prec.Pos[i] * 1000.0;    // km -> m
-            rv.v[i] = prec.Vel[i] * 0.1;       // dm/s -> m/s
-         }
-         if (useSP3clock)
-         {                                        // SP3
-            rv.clkbias = crec.bias * 1.e-6;       // microsec -> sec
-            rv.clkdrift = crec.drift * 1.e-6;     // microsec/sec -> sec/sec
-         }
-         else
-         {                                        // RINEX clock
-            rv.clkbias = crec.bias;               // sec
-            rv.clkdrift = crec.drift;             // sec/sec
-         }
-
-            // compute relativity correction, in seconds
-         rv.computeRelativityCorrection();
-         rv.health = Xvt::HealthStatus::Unused;
+         rv = makeXvt(prec, crec);
       }
       catch(...)
       {
@@ -168,6 +177,73 @@ namespace gpstk
    }
 
 
+   //-----------------------------------------------------------------------------
+   namespace
+   {
+         // orders indexes into a vector of times by time
+      struct TimeIndexLess
+      {
+         TimeIndexLess(const vector<CommonTime>& t) : times(t) {}
+         bool operator()(size_t a, size_t b) const
+         {
+            try { return times[a] < times[b]; }
+            catch(...) { return a < b; }
+         }
+         const vector<CommonTime>& times;
+      };
+   }
+
+
+   void SP3EphemerisStore::computeXvts(const vector<SatID>& ids,
+                                       const vector<CommonTime>& times,
+                                       vector<Xvt>& xvts) const throw()
+   {
+      const size_t nt(times.size());
+      Xvt unavailable;
+      unavailable.health = Xvt::HealthStatus::Unavailable;
+      xvts.assign(ids.size()*nt, unavailable);
+
+         // visit the times in time order, so that each satellite's
+         // interpolation windows are found once and reused for all the
+         // times between the same records
+      vector<size_t> order(nt);
+      for(size_t j=0; j<nt; j++)
+         order[j] = j;
+      std::stable_sort(order.begin(), order.end(), TimeIndexLess(times));
+
+      for(size_t i=0; i<ids.size(); i++)
+      {
+         const SatID& sat(ids[i]);
+         if(!posStore.isPresent(sat) || !clkStore.isPresent(sat))
+            continue;
+
+            // times outside the span of either table cannot be interpolated
+         CommonTime first(posStore.getInitialTime(sat));
+         CommonTime last(posStore.getFinalTime(sat));
+         CommonTime clkfirst(clkStore.getInitialTime(sat));
+         CommonTime clklast(clkStore.getFinalTime(sat));
+         if(first < clkfirst) first = clkfirst;
+         if(clklast < last) last = clklast;
+
+         for(size_t k=0; k<nt; k++)
+         {
+            const size_t j(order[k]);
+            try
+            {
+               if(times[j] < first || last < times[j])
+                  continue;
+               PositionRecord prec(posStore.getValueWindow(sat, times[j]));
+               ClockRecord crec(clkStore.getValueWindow(sat, times[j]));
+               xvts[i*nt+j] = makeXvt(prec, crec);
+            }
+            catch(...)
+            {
+            }
+         }
+      }
+   }
+
+
    Xvt::HealthStatus SP3EphemerisStore ::
    getSVHealth(const SatID& sat, const CommonTime& ttag) const throw()
    {
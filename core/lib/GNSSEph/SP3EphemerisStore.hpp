@@ -77,6 +77,8 @@ namespace gpstk
        * used. Inherit XvtStore for the interface it defines. */
    class SP3EphemerisStore : public XvtStore<SatID>
    {
+         /// EphemerisCache saves and restores the stores and flags
+      friend class EphemerisCache;
 
          // member data
    private:
@@ -135,6 +137,11 @@ namespace gpstk
          */
       void loadSP3Store(const std::string& filename, bool fillClockStore);
 
+         /** Private utility routine used by computeXvt and computeXvts.
+          * Form the Xvt from interpolated position and clock records,
+          * converting units. */
+      Xvt makeXvt(const PositionRecord& prec, const ClockRecord& crec) const;
+
    public:
 
          /// Default constructor
@@ -184,6 +191,25 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t) const
          throw();
 
+         /** Compute the Xvt of each of several satellites at each of
+          * several times; see XvtStore::computeXvts().  Satellites
+          * missing from either the position or clock store, and times
+          * outside a satellite's data, are marked "Unavailable"
+          * without searching the tables.  The times of each satellite
+          * are taken in time order, interpolating with the window
+          * cache of the tables (cf. setWindowCache()) whatever its
+          * setting, so the tables are searched once per pair of
+          * records rather than once per time.  The results are those
+          * of computeXvt() with the window cache on, and agree with
+          * it to within rounding with the cache off.
+          * @param[in] ids the satellites
+          * @param[in] times the times to look up
+          * @param[out] xvts the Xvt of ids[i] at times[j] is
+          *   xvts[i*times.size()+j] */
+      virtual void computeXvts(const std::vector<SatID>& ids,
+                               const std::vector<CommonTime>& times,
+                               std::vector<Xvt>& xvts) const throw();
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
@@ -459,6 +485,23 @@ namespace gpstk
       double getClockTimeStep(const SatID& sat) const throw()
       { return clkStore.nomTimeStep(sat); }
 
+         /** Get the position store, e.g. to interpolate positions
+          * without the clock, with PositionSatStore::getValue()
+          * (units km, dm/s). */
+      const PositionSatStore& getPositionStore(void) const throw()
+      { return posStore; }
+
+         /** Get the clock store, e.g. to interpolate clocks without
+          * the position, with ClockSatStore::getValue() (units
+          * microseconds if usingSP3ClockData(), otherwise seconds). */
+      const ClockSatStore& getClockStore(void) const throw()
+      { return clkStore; }
+
+         /// Return true if the clock store holds SP3 clock data (the
+         /// default), false if it holds RINEX clock data
+      bool usingSP3ClockData(void) const throw()
+      { return useSP3clock; }
+
 
          /// Get current interpolation order for the position table
       unsigned int getPositionInterpOrder(void) const throw()
@@ -491,6 +534,56 @@ namespace gpstk
       void setClockLinearInterp(void) throw()
       { clkStore.setLinearInterp(); }
 
+         /** Look up data in flat (contiguous, per-satellite) copies
+          * of the position and clock tables, rather than in the maps;
+          * faster, at the cost of memory. Results are identical.
+          * @see TabularSatStore::setFlatTables() */
+      void setFlatTables(bool flat)
+      {
+         posStore.setFlatTables(flat);
+         clkStore.setFlatTables(flat);
+      }
+
+         /// Return true if flat tables are used, cf. setFlatTables()
+      bool usingFlatTables(void) const throw()
+      { return posStore.usingFlatTables(); }
+
+         /** Interpolate the position and clock tables with barycentric
+          * Lagrange weights computed once per interpolation window and
+          * cached for each satellite, rather than interpolating each
+          * quantity separately; much faster when evaluating densely
+          * between records. Results agree to within rounding.
+          * @see TabularSatStore::setWindowCache() */
+      void setWindowCache(bool cache)
+      {
+         posStore.setWindowCache(cache);
+         clkStore.setWindowCache(cache);
+      }
+
+         /// Return true if the window cache is used, cf. setWindowCache()
+      bool usingWindowCache(void) const throw()
+      { return posStore.usingWindowCache(); }
+
+         /// Return the number of position and clock lookups that reused a
+         /// cached window, cf. setWindowCache()
+      unsigned long getWindowCacheHits(void) const
+      { return posStore.getWindowCacheHits() + clkStore.getWindowCacheHits(); }
+
+         /// Return the number of position and clock lookups that computed a
+         /// new window, cf. setWindowCache()
+      unsigned long getWindowCacheMisses(void) const
+      {
+         return posStore.getWindowCacheMisses()
+            + clkStore.getWindowCacheMisses();
+      }
+
+         /// Reset the window cache hit and miss counters to zero
+      void resetWindowCacheStats(void)
+      {
+         posStore.resetWindowCacheStats();
+         clkStore.resetWindowCacheStats();
+      }
+
 
          /** Get a list (std::vector) of SatIDs present in both clock
           * and position stores */
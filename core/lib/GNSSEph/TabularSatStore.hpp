@@ -45,8 +45,12 @@
 #define GPSTK_TABULAR_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <atomic>
+#include <mutex>
 
 #include "Exception.hpp"
 #include "SatID.hpp"
@@ -54,6 +58,9 @@
 #include "TimeString.hpp"
 #include "Xvt.hpp"
 #include "CivilTime.hpp"
+#include "BarycentricLagrange.hpp"
+#include "ThreadSlotCache.hpp"
+#include "CommonTimeKey.hpp"
 //#include "logstream.hpp"      // TEMP
 
 namespace gpstk
@@ -62,6 +69,112 @@ namespace gpstk
       /// @ingroup GNSSEph
       //@{
 
+      /** Data table for one satellite, stored contiguously in time
+       * order; it is a flat copy of a std::map<CommonTime,
+       * DataRecord>, and provides the part of the std::map interface
+       * used by TabularSatStore::getTableInterval().  When the times
+       * are (nearly) evenly spaced, lower_bound() and find() compute
+       * the index directly; otherwise they use a binary search on a
+       * CommonTimeKey copy of the times, which falls back on
+       * CommonTime comparisons only where the keys are equal.  In
+       * either case the results are exactly those of the std::map. */
+   template <class DataRecord>
+   class FlatDataTable
+   {
+   public:
+         /// records are (time, data) pairs, like the std::map
+      typedef std::pair<CommonTime, DataRecord> value_type;
+
+         /// iterator over records; supports it->first and it->second
+      typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+         /// Default constructor, an empty table
+      FlatDataTable() throw()
+            : step(0.0)
+      {}
+
+         /** Construct from a DataTable (std::map) of the same records.
+          * @param[in] table map<CommonTime, DataRecord> to copy */
+      explicit FlatDataTable(const std::map<CommonTime, DataRecord>& table)
+            : records(table.begin(), table.end()), step(0.0)
+      {
+         keys.reserve(records.size());
+         for(size_t i=0; i<records.size(); i++)
+            keys.push_back(records[i].first);
+         if(records.size() < 2)
+            return;
+
+            // the step is uniform if every time is within a small
+            // fraction of a step of its nominal value
+         double dt(records[1].first - records[0].first);
+         if(dt <= 0.0)
+            return;
+         for(size_t i=2; i<records.size(); i++)
+         {
+            if(std::fabs((records[i].first - records[0].first) - i*dt)
+               > 0.01*dt)
+               return;
+         }
+         step = dt;
+      }
+
+      const_iterator begin() const throw() { return records.begin(); }
+      const_iterator end() const throw() { return records.end(); }
+      size_t size() const throw() { return records.size(); }
+
+         /// Uniform time step in seconds, or zero if the times are not
+         /// evenly spaced
+      double getStep() const throw() { return step; }
+
+         /** Find the first record with time >= ttag.
+          * @throw InvalidRequest if the time systems do not match */
+      const_iterator lower_bound(const CommonTime& ttag) const
+      {
+         const long n(records.size());
+         long i;
+         if(step > 0.0)
+         {
+            double x((ttag - records[0].first)/step);
+            i = (x <= 0.0 ? 0 : (x >= n ? n : long(std::ceil(x))));
+               // the computed index may be off by one; finish with
+               // the same comparisons the map would use
+            while(i > 0 && !(records[i-1].first < ttag))
+               i--;
+            while(i < n && records[i].first < ttag)
+               i++;
+            return records.begin() + i;
+         }
+            // binary search on the integer keys, which are rounded
+            // to a picosecond; where a key equals that of ttag,
+            // finish with the comparison the map would use
+         const CommonTimeKey key(ttag);
+         i = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+         while(i < n && keys[i] == key && records[i].first < ttag)
+            i++;
+         return records.begin() + i;
+      }
+
+         /** Find the record with time equal to ttag, or end().
+          * @throw InvalidRequest if the time systems do not match */
+      const_iterator find(const CommonTime& ttag) const
+      {
+         const_iterator it(lower_bound(ttag));
+         if(it != records.end() && !(ttag < it->first))
+            return it;
+         return records.end();
+      }
+
+   private:
+         /// the records, in time order
+      std::vector<value_type> records;
+
+         /// the times of the records, for the searches
+      std::vector<CommonTimeKey> keys;
+
+         /// uniform time step (seconds), or 0.0
+      double step;
+   };
+
       /** Store a table of data vs time for each of several
        * satellites.  The data are stored as DataRecords, one for each
        * satellite,time.  The getValue(sat, t) routine interpolates
@@ -85,6 +198,12 @@ namespace gpstk
          /// std::map with key=SatID, value=DataTable
       typedef std::map<SatID, DataTable> SatTable;
 
+         /// flat (contiguous) copy of a DataTable
+      typedef FlatDataTable<DataRecord> FlatTable;
+
+         /// std::map with key=SatID, value=FlatTable
+      typedef std::map<SatID, FlatTable> FlatSatTable;
+
          // member data
    protected:
 
@@ -130,6 +249,196 @@ namespace gpstk
 
       typedef typename DataTable::const_iterator DataTableIterator;
 
+         /** If true, the data are looked up in flatTables, copies of
+          * the tables stored contiguously, rather than in the maps;
+          * default false.  See setFlatTables(). */
+      bool useFlatTables;
+
+         /** Flat copies of the data tables, built from the tables on
+          * first use after they change; used when useFlatTables is
+          * true. */
+      mutable FlatSatTable flatTables;
+
+         /// True when flatTables is up to date with the tables.
+      mutable std::atomic<bool> flatTablesValid;
+
+         /// Guards the (re)building of flatTables by const methods.
+      mutable std::mutex flatTablesMutex;
+
+      typedef typename FlatTable::const_iterator FlatTableIterator;
+
+         /** Mark flatTables, and the interpolation window cache, out
+          * of date; must be called by any method that modifies the
+          * tables. */
+      void invalidateFlatTables() throw()
+      {
+         flatTablesValid = false;
+         invalidateWindowCache();
+      }
+
+         /** Return flatTables, rebuilding them first if the tables
+          * have changed.  Safe to call from several threads, as long
+          * as none of them is modifying the store. */
+      const FlatSatTable& getFlatTables() const
+      {
+         if(!flatTablesValid.load(std::memory_order_acquire))
+         {
+            std::lock_guard<std::mutex> lock(flatTablesMutex);
+            if(!flatTablesValid.load(std::memory_order_relaxed))
+            {
+               flatTables.clear();
+               typename SatTable::const_iterator it;
+               for(it=tables.begin(); it!=tables.end(); ++it)
+                  flatTables.insert(std::make_pair(it->first,
+                                                   FlatTable(it->second)));
+               flatTablesValid.store(true, std::memory_order_release);
+            }
+         }
+         return flatTables;
+      }
+
+         /** An interpolation window: the 2*nhalf records of one
+          * satellite that getTableInterval() selects for a time, and
+          * the Lagrange weights over their times. */
+      struct InterpWindow
+      {
+         int nhalf;                 ///< records on each side of the time
+         bool isExact;              ///< the time matched a record
+         size_t match;              ///< index of the record matched
+         CommonTime t0;             ///< time of the first record
+         CommonTime lo, hi;         ///< times of records nhalf-1, nhalf
+         std::vector<double> times; ///< record times - t0, seconds
+         std::vector<DataRecord> recs;          ///< the records
+         BarycentricLagrange<double> lagrange;  ///< weights over times
+         std::vector<double> L, Lp; ///< coefficients, for the caller
+      };
+
+         /// The last window of one satellite in a thread's cache
+      struct CachedWindow
+      {
+         SatID sat;           ///< satellite of the window
+         InterpWindow win;    ///< the window
+      };
+
+         /// Per-thread interpolation window caches of the stores of a type
+      typedef ThreadSlotCache<CachedWindow, 128> WindowCache;
+
+         /** Return the place in the calling thread's window cache for
+          * sat in this store, or, when exact is true, the thread's
+          * window for exact matches, which is not kept; see
+          * ThreadSlotCache. */
+      typename WindowCache::Slot& windowSlot(const SatID& sat, bool exact)
+         const
+      {
+         if(exact)
+            return windowCache.scratch();
+         return windowCache.slot(static_cast<size_t>(sat.id) * 31
+                                 + static_cast<size_t>(sat.system));
+      }
+
+         /// Make the window caches of all threads out of date for this store
+      void invalidateWindowCache() throw()
+      { windowCache.invalidate(); }
+
+         /** If true, getValue() interpolates with barycentric
+          * Lagrange weights kept in windowCache; default false.  See
+          * setWindowCache(). */
+      bool useWindowCache;
+
+         /// Interpolation windows used by getValue(), cf. useWindowCache
+      mutable WindowCache windowCache;
+
+         /** Return the interpolation window of 2*nhalf records for sat
+          * at ttag, with the weights over its times computed.  When
+          * ttag lies strictly between the two central records of the
+          * satellite's last window in the calling thread, that window
+          * is returned with no search; otherwise the window is found
+          * with getTableInterval(), in either the maps or the flat
+          * tables, and kept for the next call unless ttag is an exact
+          * match.  If ttag is an exact match and exactReturn is true,
+          * the window holds only the matching record.  The window
+          * belongs to the calling thread, and is valid until its next
+          * call.
+          * @throw InvalidRequest as getTableInterval() */
+      template <class TableIterator>
+      InterpWindow& findWindowFrom(const SatID& sat,
+                                   const CommonTime& ttag,
+                                   const int& nhalf,
+                                   bool exactReturn)
+         const
+      {
+         typename WindowCache::Slot& slot(windowSlot(sat, false));
+         if(windowCache.holds(slot) && slot.value.sat == sat &&
+            slot.value.win.nhalf == nhalf &&
+            slot.value.win.lo < ttag && ttag < slot.value.win.hi)
+         {
+            windowCache.hit();
+            return slot.value.win;
+         }
+         windowCache.miss();
+
+         TableIterator it1, it2;
+         bool isExact(getTableInterval(sat, ttag, nhalf, it1, it2,
+                                       exactReturn));
+
+         typename WindowCache::Slot& wslot(isExact ? windowSlot(sat, true)
+                                                   : slot);
+         WindowCache::release(wslot);  // not valid until complete
+         InterpWindow& win(wslot.value.win);
+         win.nhalf = -1;
+         win.isExact = isExact;
+         win.match = 0;
+         win.t0 = it1->first;
+         win.times.clear();
+         win.recs.clear();
+         if(isExact && exactReturn)
+         {
+            win.times.push_back(0.0);
+            win.recs.push_back(it1->second);
+            win.nhalf = nhalf;
+            return win;
+         }
+
+         size_t n(0);
+         for(TableIterator kt(it1); ; ++kt, ++n)
+         {
+            if(isExact && std::fabs(kt->first - ttag) < 1.e-8)
+               win.match = n;
+            if(int(n) == nhalf-1)
+               win.lo = kt->first;
+            else if(int(n) == nhalf)
+               win.hi = kt->first;
+            win.times.push_back(kt->first - win.t0);
+            win.recs.push_back(kt->second);
+            if(kt == it2)
+               break;
+         }
+         win.lagrange.setNodes(win.times);
+         win.nhalf = nhalf;
+         if(!isExact)
+         {
+            wslot.value.sat = sat;
+            windowCache.fill(wslot);
+         }
+         return win;
+      }
+
+         /** Call findWindowFrom() for the maps or the flat tables,
+          * according to useFlatTables.
+          * @throw InvalidRequest as getTableInterval() */
+      InterpWindow& findWindow(const SatID& sat,
+                               const CommonTime& ttag,
+                               const int& nhalf,
+                               bool exactReturn)
+         const
+      {
+         if(useFlatTables)
+            return findWindowFrom<FlatTableIterator>(sat, ttag, nhalf,
+                                                     exactReturn);
+         return findWindowFrom<DataTableIterator>(sat, ttag, nhalf,
+                                                  exactReturn);
+      }
+
          // member functions
    public:
          /// Default constructor
@@ -137,8 +446,45 @@ namespace gpstk
       : storeTimeSystem(TimeSystem::Any),
          havePosition(false), haveVelocity(false),
          haveClockBias(false), haveClockDrift(false),
-         checkDataGap(false), checkInterval(false)
+         checkDataGap(false), checkInterval(false),
+         useFlatTables(false), flatTablesValid(false),
+         useWindowCache(false)
+      {}
+
+         /// Copy constructor; the flat tables are rebuilt when needed
+      TabularSatStore(const TabularSatStore& right)
+      : tables(right.tables), storeTimeSystem(right.storeTimeSystem),
+         havePosition(right.havePosition), haveVelocity(right.haveVelocity),
+         haveClockBias(right.haveClockBias),
+         haveClockDrift(right.haveClockDrift),
+         checkDataGap(right.checkDataGap), gapInterval(right.gapInterval),
+         checkInterval(right.checkInterval), maxInterval(right.maxInterval),
+         useFlatTables(right.useFlatTables), flatTablesValid(false),
+         useWindowCache(right.useWindowCache)
       {}
+
+         /// Assignment; the flat tables are rebuilt when needed
+      TabularSatStore& operator=(const TabularSatStore& right)
+      {
+         if(this == &right)
+            return *this;
+         tables = right.tables;
+         storeTimeSystem = right.storeTimeSystem;
+         havePosition = right.havePosition;
+         haveVelocity = right.haveVelocity;
+         haveClockBias = right.haveClockBias;
+         haveClockDrift = right.haveClockDrift;
+         checkDataGap = right.checkDataGap;
+         gapInterval = right.gapInterval;
+         checkInterval = right.checkInterval;
+         maxInterval = right.maxInterval;
+         useFlatTables = right.useFlatTables;
+         flatTables.clear();
+         flatTablesValid = false;
+         useWindowCache = right.useWindowCache;
+         windowCache = right.windowCache;
+         return *this;
+      }
          /// Destructor
       virtual ~TabularSatStore() {}
 
@@ -219,9 +565,6 @@ namespace gpstk
       {
          try
          {
-            static const char *fmt=
-               " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
-
                // find the DataTable for this sat
             typename std::map<SatID, DataTable>::const_iterator satit;
             satit = tables.find(sat);
@@ -233,146 +576,257 @@ namespace gpstk
                GPSTK_THROW(e);
             }
 
-               // this is the data table for the sat
-            const DataTable& dtable(satit->second);
+            return findTableInterval(satit->second, sat, ttag, nhalf,
+                                     it1, it2, exactReturn);
+         }
+         catch(InvalidRequest& ir)
+         {
+            GPSTK_RETHROW(ir);
+         }
+      }
 
-               // cannot interpolate with one point
-            if(dtable.size() < 2)
+         /** Version of getTableInterval() that searches the flat
+          * tables (see setFlatTables()) and returns iterators into
+          * them; the interval, exceptions and return value are
+          * identical to those of getTableInterval() on the maps.
+          * @throw InvalidRequest as getTableInterval() */
+      bool getTableInterval(const SatID& sat,
+                            const CommonTime& ttag,
+                            const int& nhalf,
+                            FlatTableIterator& it1,
+                            FlatTableIterator& it2,
+                            bool exactReturn=true)
+         const
+      {
+         try
+         {
+               // find the FlatTable for this sat
+            const FlatSatTable& ftables(getFlatTables());
+            typename FlatSatTable::const_iterator satit(ftables.find(sat));
+            if(satit == ftables.end())
             {
-               InvalidRequest e("Inadequate data (size < 2) for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
+               InvalidRequest
+                  e("Satellite " + gpstk::StringUtils::asString(sat) +
+                    " not found.");
                GPSTK_THROW(e);
             }
 
-               // find the timetag in this table
+            return findTableInterval(satit->second, sat, ttag, nhalf,
+                                     it1, it2, exactReturn);
+         }
+         catch(InvalidRequest& ir)
+         {
+            GPSTK_RETHROW(ir);
+         }
+      }
 
-               /** @note throw here if time systems do not match and
-                * are not "Any" */
-            it1 = dtable.find(ttag);
-               // is it an exact match?
-            bool exactMatch(it1 != dtable.end());
+         /** Select storage used to look up data: if true, use flat
+          * (contiguous, per-satellite) copies of the data tables,
+          * which are faster to search than the maps, particularly
+          * for evenly spaced data; if false (the default) use the
+          * maps.  The copies cost as much memory again as the
+          * tables; they are built on the first lookup after the
+          * tables change, so load all the data first.  The results
+          * of getValue() etc. are identical either way. */
+      void setFlatTables(bool flat)
+      {
+         std::lock_guard<std::mutex> lock(flatTablesMutex);
+         useFlatTables = flat;
+         flatTables.clear();
+         flatTablesValid = false;
+      }
 
-               // user must decide whether to return with exact value;
-               // e.g. without velocity data, user needs the interval
-               // to compute v from x data
-            if(exactMatch && exactReturn)
-               return true;
+         /// Return true if the flat tables are used, cf. setFlatTables()
+      bool usingFlatTables() const throw()
+      { return useFlatTables; }
+
+         /** Select the interpolation used by getValue(), and by
+          * ClockSatStore::getClockBias() and getClockDrift(): if true,
+          * compute barycentric Lagrange weights once per interpolation
+          * window and apply them to every quantity in the record in
+          * one pass, keeping the last window of each satellite so that
+          * the search of the table and the weights are reused for
+          * every time between the same two records; if false (the
+          * default) interpolate each quantity separately with
+          * LagrangeInterpolation().  The results agree to within
+          * rounding.  Dense evaluation, e.g. every second between
+          * 15-minute records, is then much cheaper. */
+      void setWindowCache(bool cache)
+      {
+         useWindowCache = cache;
+         invalidateWindowCache();
+      }
 
-               // lower_bound points to the first element with key >= ttag
-            it1 = it2 = dtable.lower_bound(ttag);
-            if (it1 == dtable.end())
-            {
-               InvalidRequest e("No data in time range for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
+         /// Return true if the window cache is used, cf. setWindowCache()
+      bool usingWindowCache() const throw()
+      { return useWindowCache; }
+
+         /** Get the number of lookups that reused a cached
+          * interpolation window. */
+      unsigned long getWindowCacheHits(void) const
+      { return windowCache.getHits(); }
+
+         /** Get the number of lookups that searched the table
+          * for the interpolation window. */
+      unsigned long getWindowCacheMisses(void) const
+      { return windowCache.getMisses(); }
+
+         /// Reset the window cache hit and miss counters to zero.
+      void resetWindowCacheStats(void)
+      { windowCache.resetStats(); }
+
+   protected:
+         /** Implementation of getTableInterval(), for either a
+          * DataTable (std::map) or a FlatTable.
+          * @param[in] dtable the data table for sat
+          * (see getTableInterval() for the other parameters) */
+      template <class Table>
+      bool findTableInterval(const Table& dtable,
+                             const SatID& sat,
+                             const CommonTime& ttag,
+                             const int& nhalf,
+                             typename Table::const_iterator& it1,
+                             typename Table::const_iterator& it2,
+                             bool exactReturn)
+         const
+      {
+         static const char *fmt=
+            " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
+
+            // cannot interpolate with one point
+         if(dtable.size() < 2)
+         {
+            InvalidRequest e("Inadequate data (size < 2) for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // find the timetag in this table
+
+            /** @note throw here if time systems do not match and
+             * are not "Any" */
+         it1 = dtable.find(ttag);
+            // is it an exact match?
+         bool exactMatch(it1 != dtable.end());
 
-               // ttag is <= first time in table
-            if(it1 == dtable.begin())
+            // user must decide whether to return with exact value;
+            // e.g. without velocity data, user needs the interval
+            // to compute v from x data
+         if(exactMatch && exactReturn)
+            return true;
+
+            // lower_bound points to the first element with key >= ttag
+         it1 = it2 = dtable.lower_bound(ttag);
+         if (it1 == dtable.end())
+         {
+            InvalidRequest e("No data in time range for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
+
+            // ttag is <= first time in table
+         if(it1 == dtable.begin())
+         {
+               // at table begin but its an exact match && an
+               // interval of only 2
+            if(exactMatch && nhalf==1)
             {
-                  // at table begin but its an exact match && an
-                  // interval of only 2
-               if(exactMatch && nhalf==1)
-               {
-                  ++(it2 = it1);
-                  return exactMatch;
-               }
-               InvalidRequest e("Inadequate data before(1) requested time for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
+               ++(it2 = it1);
+               return exactMatch;
             }
+            InvalidRequest e("Inadequate data before(1) requested time for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
 
-               // move it1 down by one
-            if(--it1 == dtable.begin())
+            // move it1 down by one
+         if(--it1 == dtable.begin())
+         {
+               // if an interval of only 2
+            if(nhalf==1)
             {
-                  // if an interval of only 2
-               if(nhalf==1)
-               {
-                  ++(it2 = it1);
-                  return exactMatch;
-               }
-               InvalidRequest e("Inadequate data before(2) requested time for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
+               ++(it2 = it1);
+               return exactMatch;
             }
+            InvalidRequest e("Inadequate data before(2) requested time for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
 
-               //LOG(INFO) << "OK, have interval " << printTime(it1->first,"%F/%g") <<
-               //" <= " <<printTime(ttag,"%F/%g")<< " < " <<printTime(it2->first,"%F/%g");
+            //LOG(INFO) << "OK, have interval " << printTime(it1->first,"%F/%g") <<
+            //" <= " <<printTime(ttag,"%F/%g")<< " < " <<printTime(it2->first,"%F/%g");
+
+            // now have it1->first <= ttag < it2->first and it2 ==
+            // it1+1 check for gap between these two table entries
+            // surrounding ttag
+         if(checkDataGap && (it2->first-it1->first) > gapInterval)
+         {
+            InvalidRequest e("Gap at interpolation time for satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
+         }
 
-               // now have it1->first <= ttag < it2->first and it2 ==
-               // it1+1 check for gap between these two table entries
-               // surrounding ttag
-            if(checkDataGap && (it2->first-it1->first) > gapInterval)
+            // now expand the interval to include 2*nhalf timesteps
+         for(int k=0; k<nhalf-1; k++)
+         {
+            bool last(k==nhalf-2); // true only on the last iteration
+               // move left by one; if require full interval && out
+               // of room on left, fail
+            if(--it1 == dtable.begin() && !last)
             {
-               InvalidRequest e("Gap at interpolation time for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
+               InvalidRequest
+                  e("Inadequate data before(3) requested time for"
+                    " satellite " + gpstk::StringUtils::asString(sat) +
+                    printTime(ttag,fmt));
                GPSTK_THROW(e);
             }
+               //LOG(INFO) << k << " expand left " << printTime(it1->first,"%F/%g");
 
-               // now expand the interval to include 2*nhalf timesteps
-            for(int k=0; k<nhalf-1; k++)
+            if(++it2 == dtable.end())
             {
-               bool last(k==nhalf-2); // true only on the last iteration
-                  // move left by one; if require full interval && out
-                  // of room on left, fail
-               if(--it1 == dtable.begin() && !last)
+               if(exactMatch && last && it1 != dtable.begin())
+               {
+                     // exact match && at end of interval && with
+                     // room to move down
+
+                     // move interval down by one
+                  it2--;
+                  it1--;
+               }
+               else
                {
                   InvalidRequest
-                     e("Inadequate data before(3) requested time for"
+                     e("Inadequate data after(2) requested time for"
                        " satellite " + gpstk::StringUtils::asString(sat) +
                        printTime(ttag,fmt));
                   GPSTK_THROW(e);
                }
-                  //LOG(INFO) << k << " expand left " << printTime(it1->first,"%F/%g");
-
-               if(++it2 == dtable.end())
-               {
-                  if(exactMatch && last && it1 != dtable.begin())
-                  {
-                        // exact match && at end of interval && with
-                        // room to move down
-
-                        // move interval down by one
-                     it2--;
-                     it1--;
-                  }
-                  else
-                  {
-                     InvalidRequest
-                        e("Inadequate data after(2) requested time for"
-                          " satellite " + gpstk::StringUtils::asString(sat) +
-                          printTime(ttag,fmt));
-                     GPSTK_THROW(e);
-                  }
-               }
-                  //LOG(INFO) << k << " expand right " << printTime(it2->first,"%F/%g");
-            }
-
-               // check that the interval is not too large
-            if(checkInterval && (it2->first - it1->first) > maxInterval)
-            {
-               InvalidRequest e("Interpolation interval too large for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
             }
-
-            return exactMatch;
+               //LOG(INFO) << k << " expand right " << printTime(it2->first,"%F/%g");
          }
-         catch(InvalidRequest& ir)
+
+            // check that the interval is not too large
+         if(checkInterval && (it2->first - it1->first) > maxInterval)
          {
-            GPSTK_RETHROW(ir);
+            InvalidRequest e("Interpolation interval too large for"
+                             " satellite " +
+                             gpstk::StringUtils::asString(sat) +
+                             printTime(ttag,fmt));
+            GPSTK_THROW(e);
          }
+
+         return exactMatch;
       }
 
+   public:
+
          /** Version of getTableInterval() which does not require the
           * time of interest to lie in the center of the interval,
           * with nhalf points on either side.  (See getTableInterval()
@@ -673,6 +1127,7 @@ namespace gpstk
             if(jt != dtab.begin() && --jt != dtab.begin())
                dtab.erase(dtab.begin(),jt);
          }
+         invalidateFlatTables();
       }
 
          // remaining functions are not virtual
@@ -684,6 +1139,7 @@ namespace gpstk
          for(satit=tables.begin(); satit!=tables.end(); ++satit)
             satit->second.clear();
          tables.clear();
+         invalidateFlatTables();
       }
 
          /// Return true if the given SatID is present in the store
@@ -942,20 +1398,26 @@ namespace gpstk
       bool isDataGapCheck(void) throw() { return checkDataGap; }
 
          /// Disable checking of data gaps.
-      void disableDataGapCheck(void) throw() { checkDataGap = false; }
+      void disableDataGapCheck(void) throw()
+      { checkDataGap = false; invalidateWindowCache(); }
 
          /// Get current gap interval.
       double getGapInterval(void) throw() { return gapInterval; }
 
          /// Set gap interval and turn on gap checking
       void setGapInterval(double interval) throw()
-      { checkDataGap = true; gapInterval = interval; }
+      {
+         checkDataGap = true;
+         gapInterval = interval;
+         invalidateWindowCache();
+      }
 
          /// Is interval checking on?
       bool isIntervalCheck(void) throw() { return checkInterval; }
 
          /// Disable checking of maximum interval.
-      void disableIntervalCheck(void) throw() { checkInterval = false; }
+      void disableIntervalCheck(void) throw()
+      { checkInterval = false; invalidateWindowCache(); }
 
          /// Get current maximum interval.
       double getMaxInterval(void) throw() { return maxInterval; }
@@ -965,6 +1427,7 @@ namespace gpstk
       {
          checkInterval = true;
          maxInterval = interval;
+         invalidateWindowCache();
       }
 
          /// get the store's time system
@@ -47,6 +47,7 @@
 
 #include <iostream>
 #include <set>
+#include <vector>
 
 #include "Exception.hpp"
 #include "CommonTime.hpp"
@@ -94,6 +95,34 @@ namespace gpstk
       virtual Xvt computeXvt(const IndexType& id, const CommonTime& t)
          const throw() = 0;
 
+         /** Compute the position, velocity and clock offset of each
+          * of several objects at each of several times, as
+          * computeXvt() does for one object at one time.  Derived
+          * classes override this where a batch can be computed faster
+          * than by repeated calls to computeXvt(), for example by
+          * searching their tables once per object.
+          * @note Like computeXvt(), this does not throw and ignores
+          *   the onlyHealthy flag; an Xvt that cannot be computed has
+          *   health Xvt::HealthStatus::Unavailable.
+          * @param[in] ids the objects' identifiers
+          * @param[in] times the times to look up; sorted times are
+          *   usually fastest
+          * @param[out] xvts resized to ids.size()*times.size(); the
+          *   Xvt of ids[i] at times[j] is xvts[i*times.size()+j] */
+      virtual void computeXvts(const std::vector<IndexType>& ids,
+                               const std::vector<CommonTime>& times,
+                               std::vector<Xvt>& xvts)
+         const throw()
+      {
+         const size_t nt(times.size());
+         xvts.resize(ids.size()*nt);
+         for(size_t i=0; i<ids.size(); i++)
+         {
+            for(size_t j=0; j<nt; j++)
+               xvts[i*nt+j] = computeXvt(ids[i], times[j]);
+         }
+      }
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
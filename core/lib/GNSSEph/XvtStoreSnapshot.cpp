@@ -0,0 +1,331 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file XvtStoreSnapshot.cpp
+ * An immutable copy of the ephemerides of an OrbitEphStore,
+ * SP3EphemerisStore, GloEphemerisStore or Rinex3EphemerisStore over a
+ * time window. */
+
+#include <algorithm>
+
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
+#include "XvtStoreSnapshot.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   using namespace StringUtils;
+
+      // format of the times in messages
+   static const string timeFmt("%Y/%02m/%02d %02H:%02M:%02S %P");
+
+      // GloEphemerisStore uses a record within this many seconds of it
+   static const double gloValidity(900.0);
+
+      // more than the difference between any two of the time systems
+      // that Rinex3EphemerisStore converts between
+   static const double timeSystemMargin(60.0);
+
+
+   void XvtStoreSnapshot ::
+   copyOrbit(const OrbitEphStore& src, OrbitEphStore& dst,
+             const CommonTime& begin, const CommonTime& end)
+   {
+      dst.strictMethod = !src.isSearchNear();
+      dst.timeSystem = src.getTimeSystem();
+      dst.initialTime.setTimeSystem(dst.timeSystem);
+      dst.finalTime.setTimeSystem(dst.timeSystem);
+
+         // the tables may hold several time systems
+      CommonTime b(begin), e(end);
+      b.setTimeSystem(TimeSystem::Any);
+      e.setTimeSystem(TimeSystem::Any);
+
+         // the selection at a time in the window chooses between the
+         // OrbitEph valid then, and one keyed in the window
+      set<SatID> sats(src.getIndexSet());
+      for(set<SatID>::const_iterator it = sats.begin(); it != sats.end(); ++it)
+      {
+         const OrbitEphStore::TimeOrbitEphTable& table(
+            src.getTimeOrbitEphMap(*it));
+         OrbitEphStore::TimeOrbitEphTable::const_iterator jt;
+         for(jt = table.begin(); jt != table.end(); ++jt)
+         {
+            const OrbitEph *eph(jt->second);
+            bool valid(!(eph->endValid < b) && !(e < eph->beginValid));
+            bool keyed(!(jt->first < b) && !(e < jt->first));
+            if(!valid && !keyed)
+               continue;
+            OrbitEph *clone(eph->clone());
+            dst.satTables[*it][jt->first] = clone;
+            dst.updateTimeLimits(clone);
+         }
+      }
+   }
+
+
+   void XvtStoreSnapshot ::
+   copyGlo(const GloEphemerisStore& src, GloEphemerisStore& dst,
+           const CommonTime& begin, const CommonTime& end)
+   {
+         // the records are keyed in GLONASS time, and getXvt() uses
+         // the one nearest the time, when it is within gloValidity
+      CommonTime b(begin - gloValidity), e(end + gloValidity);
+      b.setTimeSystem(src.getTimeSystem());
+      e.setTimeSystem(src.getTimeSystem());
+      dst = src;
+      dst.edit(b, e);
+   }
+
+
+   XvtStoreSnapshot ::
+   XvtStoreSnapshot(const XvtStore<SatID>& src, const CommonTime& begin,
+                    const CommonTime& end)
+         : beginTime(begin), endTime(end), source(OrbitSource)
+   {
+      if(end < begin)
+      {
+         InvalidRequest ir("End time " + printTime(end, timeFmt)
+                           + " is before begin time "
+                           + printTime(begin, timeFmt));
+         GPSTK_THROW(ir);
+      }
+
+      timeSystem = src.getTimeSystem();
+      onlyHealthy = src.getOnlyHealthyFlag();
+
+      const OrbitEphStore *orb(dynamic_cast<const OrbitEphStore*>(&src));
+      const SP3EphemerisStore *sp3(
+         dynamic_cast<const SP3EphemerisStore*>(&src));
+      const GloEphemerisStore *glo(
+         dynamic_cast<const GloEphemerisStore*>(&src));
+      const Rinex3EphemerisStore *rin3(
+         dynamic_cast<const Rinex3EphemerisStore*>(&src));
+      if(orb)
+      {
+         copyOrbit(*orb, orbitStore, begin, end);
+      }
+      else if(sp3)
+      {
+         source = SP3Source;
+            // keep the records that the interpolation at the ends of
+            // the window uses, plus one
+         sp3Store = *sp3;
+         double step(0.0);
+         set<SatID> sats(sp3->getIndexSet());
+         for(set<SatID>::const_iterator it = sats.begin(); it != sats.end();
+             ++it)
+         {
+            step = std::max(step, sp3->getPositionTimeStep(*it));
+            step = std::max(step, sp3->getClockTimeStep(*it));
+         }
+         unsigned order(std::max(sp3Store.getPositionInterpOrder(),
+                                 sp3Store.getClockInterpOrder()));
+         double margin((order/2 + 1) * step);
+         sp3Store.edit(begin - margin, end + margin);
+      }
+      else if(glo)
+      {
+         source = GloSource;
+         copyGlo(*glo, gloStore, begin, end);
+      }
+      else if(rin3)
+      {
+            // the flag of the store is kept by its OrbitEphStore
+         source = Rinex3Source;
+         onlyHealthy = rin3->ORBstore.getOnlyHealthyFlag();
+         rin3Store.mapTimeCorr = rin3->mapTimeCorr;
+         copyOrbit(rin3->ORBstore, rin3Store.ORBstore,
+                   begin - timeSystemMargin, end + timeSystemMargin);
+         copyGlo(rin3->GLOstore, rin3Store.GLOstore,
+                 begin - timeSystemMargin, end + timeSystemMargin);
+      }
+      else
+      {
+         InvalidRequest ir("XvtStoreSnapshot can copy an OrbitEphStore,"
+                           " SP3EphemerisStore, GloEphemerisStore or"
+                           " Rinex3EphemerisStore only");
+         GPSTK_THROW(ir);
+      }
+
+         // the snapshot checks the health, with the satellite and time
+         // in the message
+      orbitStore.setOnlyHealthyFlag(false);
+      sp3Store.setOnlyHealthyFlag(false);
+      rin3Store.ORBstore.setOnlyHealthyFlag(false);
+   }
+
+
+   const XvtStore<SatID>& XvtStoreSnapshot ::
+   store(void) const
+   {
+      switch(source)
+      {
+         case SP3Source:
+            return sp3Store;
+         case GloSource:
+            return gloStore;
+         case Rinex3Source:
+            return rin3Store;
+         default:
+            return orbitStore;
+      }
+   }
+
+
+   bool XvtStoreSnapshot ::
+   inWindow(const CommonTime& t) const
+   {
+      CommonTime tt(t);
+      tt.setTimeSystem(beginTime.getTimeSystem());
+      return !(tt < beginTime) && !(endTime < tt);
+   }
+
+
+   Xvt XvtStoreSnapshot ::
+   getXvt(const SatID& sat, const CommonTime& t) const
+   {
+      if(!inWindow(t))
+      {
+         InvalidRequest ir("Time is outside the snapshot for satellite "
+                           + asString(sat) + " at "
+                           + printTime(t, timeFmt));
+         GPSTK_THROW(ir);
+      }
+
+      Xvt rv;
+      try
+      {
+         rv = store().getXvt(sat, t);
+      }
+      catch(InvalidRequest& ir)
+      {
+         GPSTK_RETHROW(ir);
+      }
+
+      if(onlyHealthy && (rv.health == Xvt::HealthStatus::Unhealthy ||
+                         rv.health == Xvt::HealthStatus::Degraded))
+      {
+         InvalidRequest ir("Not healthy: satellite " + asString(sat)
+                           + " at " + printTime(t, timeFmt));
+         GPSTK_THROW(ir);
+      }
+
+      return rv;
+   }
+
+
+   Xvt XvtStoreSnapshot ::
+   computeXvt(const SatID& sat, const CommonTime& t) const throw()
+   {
+      Xvt rv;
+      rv.health = Xvt::HealthStatus::Unavailable;
+      if(!inWindow(t))
+         return rv;
+      return store().computeXvt(sat, t);
+   }
+
+
+   Xvt::HealthStatus XvtStoreSnapshot ::
+   getSVHealth(const SatID& sat, const CommonTime& t) const throw()
+   {
+      if(!inWindow(t))
+         return Xvt::HealthStatus::Unavailable;
+      return store().getSVHealth(sat, t);
+   }
+
+
+   void XvtStoreSnapshot ::
+   dump(ostream& os, short detail) const
+   {
+      static const char *names[] = { "an OrbitEphStore",
+                                     "an SP3EphemerisStore",
+                                     "a GloEphemerisStore",
+                                     "a Rinex3EphemerisStore" };
+      os << "Dump of XvtStoreSnapshot (detail level=" << detail << "):\n";
+      os << " " << store().getIndexSet().size() << " satellites from "
+         << printTime(beginTime, timeFmt) << " to "
+         << printTime(endTime, timeFmt) << ", copied from "
+         << names[source] << endl;
+      if(detail > 0)
+         store().dump(os, detail-1);
+   }
+
+
+   void XvtStoreSnapshot ::
+   edit(const CommonTime& tmin, const CommonTime& tmax)
+   {
+      InvalidRequest ir("XvtStoreSnapshot cannot be edited");
+      GPSTK_THROW(ir);
+   }
+
+
+   void XvtStoreSnapshot ::
+   clear(void)
+   {
+      InvalidRequest ir("XvtStoreSnapshot cannot be cleared");
+      GPSTK_THROW(ir);
+   }
+
+
+   CommonTime XvtStoreSnapshot ::
+   getInitialTime(void) const
+   {
+      if(store().getIndexSet().empty())
+      {
+         InvalidRequest ir("Snapshot has no data");
+         GPSTK_THROW(ir);
+      }
+      return beginTime;
+   }
+
+
+   CommonTime XvtStoreSnapshot ::
+   getFinalTime(void) const
+   {
+      if(store().getIndexSet().empty())
+      {
+         InvalidRequest ir("Snapshot has no data");
+         GPSTK_THROW(ir);
+      }
+      return endTime;
+   }
+
+}  // namespace gpstk
@@ -0,0 +1,235 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/** @file XvtStoreSnapshot.hpp
+ * An immutable copy of the ephemerides of an OrbitEphStore,
+ * SP3EphemerisStore, GloEphemerisStore or Rinex3EphemerisStore over a
+ * time window, which may be read concurrently by any number of threads
+ * without locking. */
+
+#ifndef GPSTK_XVTSTORESNAPSHOT_INCLUDE
+#define GPSTK_XVTSTORESNAPSHOT_INCLUDE
+
+#include <iostream>
+#include <set>
+
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "SatID.hpp"
+#include "Xvt.hpp"
+#include "XvtStore.hpp"
+#include "OrbitEphStore.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "GloEphemerisStore.hpp"
+#include "Rinex3EphemerisStore.hpp"
+
+namespace gpstk
+{
+      /// @ingroup GNSSEph
+      //@{
+
+      /** A frozen, read-only copy of the ephemeris data of an
+       * XvtStore<SatID> over a time window, for sharing between
+       * threads.
+       *
+       * The stores are not safe to modify while other threads read
+       * them.  A snapshot deep copies the ephemerides of the source
+       * that are needed within its window, and keeps no reference to
+       * the source:
+       *  - from an OrbitEphStore (e.g. GPSEphemerisStore,
+       *    RinexEphemerisStore), a clone of every OrbitEph whose
+       *    validity or key lies in the window, under the same keys
+       *    and with the same search method;
+       *  - from an SP3EphemerisStore, a copy of the store edited to
+       *    the window, keeping the records around it that its
+       *    interpolation uses;
+       *  - from a GloEphemerisStore, a copy of the store edited to
+       *    the window widened by the 15 minutes within which a
+       *    record is used;
+       *  - from a Rinex3EphemerisStore, both of the above for its
+       *    OrbitEph and GLONASS tables, with its time system
+       *    corrections; the window is widened by a minute, since the
+       *    store converts the times it is given to the system of
+       *    each satellite.
+       * Within the window, getXvt(), computeXvt() and getSVHealth()
+       * therefore give the same results as the source, including at
+       * the handover from one broadcast ephemeris to the next.
+       * Nothing is modified after construction, and the caches used
+       * by the lookups are kept per thread, so the lookups may be
+       * called from many threads at once without locks.
+       *
+       * Times outside the window are Unavailable; a time in another
+       * time system than the window is compared by its value.  The edit() and
+       * clear() methods of XvtStore throw InvalidRequest, since a
+       * snapshot cannot be changed. */
+   class XvtStoreSnapshot : public XvtStore<SatID>
+   {
+   public:
+         /** Copy the ephemerides of the source store needed from
+          * begin to end.
+          * @param[in] src the store to be copied, an OrbitEphStore,
+          *   SP3EphemerisStore, GloEphemerisStore or
+          *   Rinex3EphemerisStore
+          * @param[in] begin the beginning of the window
+          * @param[in] end the end of the window
+          * @throw InvalidRequest if end is before begin, or the source
+          *   is of another type. */
+      XvtStoreSnapshot(const XvtStore<SatID>& src, const CommonTime& begin,
+                       const CommonTime& end);
+
+         /// Destructor
+      virtual ~XvtStoreSnapshot()
+      {}
+
+         /** Returns the position, velocity, and clock offset of the
+          * indicated satellite in ECEF coordinates (meters) at the
+          * indicated time.
+          * @param[in] sat the satellite of interest
+          * @param[in] t the time to look up
+          * @return the Xvt of the satellite at the indicated time
+          * @throw InvalidRequest if t is outside the window, the
+          *   copied store cannot compute the Xvt, or the onlyHealthy
+          *   flag is set and the satellite is Unhealthy or Degraded. */
+      virtual Xvt getXvt(const SatID& sat, const CommonTime& t) const;
+
+         /** Compute the position, velocity and clock offset of the
+          * indicated satellite as getXvt() does, but without
+          * throwing; an Xvt that cannot be computed has health
+          * Xvt::HealthStatus::Unavailable.
+          * @note This function ignores the onlyHealthy flag.
+          * @param[in] sat the satellite of interest
+          * @param[in] t the time to look up
+          * @return the Xvt of the satellite at the indicated time */
+      virtual Xvt computeXvt(const SatID& sat, const CommonTime& t) const
+         throw();
+
+         /** Get the satellite health at a specific time.
+          * @param[in] sat the satellite of interest
+          * @param[in] t the time to look up
+          * @return the health of the copied store, or Unavailable
+          *   outside the window */
+      virtual Xvt::HealthStatus getSVHealth(const SatID& sat,
+                                            const CommonTime& t) const throw();
+
+         /** Dump information about the snapshot to an ostream.
+          * @param[in] os ostream to receive the output
+          * @param[in] detail 0: the window, 1 and up: also the dump of
+          *   the copied store at detail-1 */
+      virtual void dump(std::ostream& os = std::cout, short detail = 0) const;
+
+         /// A snapshot cannot be edited.
+         /// @throw InvalidRequest always
+      virtual void edit(const CommonTime& tmin,
+                        const CommonTime& tmax = CommonTime::END_OF_TIME);
+
+         /// A snapshot cannot be cleared.
+         /// @throw InvalidRequest always
+      virtual void clear(void);
+
+         /// Return the time system of the source store
+      virtual TimeSystem getTimeSystem(void) const
+      { return timeSystem; }
+
+         /// Return the beginning of the window.
+         /// @throw InvalidRequest if the snapshot has no data
+      virtual CommonTime getInitialTime(void) const;
+
+         /// Return the end of the window.
+         /// @throw InvalidRequest if the snapshot has no data
+      virtual CommonTime getFinalTime(void) const;
+
+         /// Return true if the copied store has velocity
+      virtual bool hasVelocity(void) const
+      { return store().hasVelocity(); }
+
+         /// Return true if the satellite has any data in the snapshot
+      virtual bool isPresent(const SatID& sat) const
+      { return store().isPresent(sat); }
+
+         /// Return the satellites in the snapshot
+      virtual std::set<SatID> getIndexSet(void) const
+      { return store().getIndexSet(); }
+
+   private:
+         /// The types of store that can be copied
+      enum SourceType
+      {
+         OrbitSource,
+         SP3Source,
+         GloSource,
+         Rinex3Source
+      };
+
+         /** Clone the OrbitEph of src whose validity or key lies
+          * between begin and end into the empty dst, under the same
+          * keys. */
+      static void copyOrbit(const OrbitEphStore& src, OrbitEphStore& dst,
+                            const CommonTime& begin, const CommonTime& end);
+
+         /** Copy src into dst, keeping the records that may be used
+          * between begin and end. */
+      static void copyGlo(const GloEphemerisStore& src,
+                          GloEphemerisStore& dst, const CommonTime& begin,
+                          const CommonTime& end);
+
+         /// Copying would share the OrbitEph of the copied store
+      XvtStoreSnapshot(const XvtStoreSnapshot&);
+      XvtStoreSnapshot& operator=(const XvtStoreSnapshot&);
+
+         /// The copied store
+      const XvtStore<SatID>& store(void) const;
+
+         /// True if t is within the window
+      bool inWindow(const CommonTime& t) const;
+
+      CommonTime beginTime;   ///< beginning of the window
+      CommonTime endTime;     ///< end of the window
+      TimeSystem timeSystem;  ///< time system of the source store
+      SourceType source;      ///< the type of the source store
+      OrbitEphStore orbitStore;        ///< copy of an OrbitEphStore source
+      SP3EphemerisStore sp3Store;      ///< copy of an SP3EphemerisStore source
+      GloEphemerisStore gloStore;      ///< copy of a GloEphemerisStore source
+      Rinex3EphemerisStore rin3Store;  ///< copy of a Rinex3EphemerisStore
+
+   }; // end class XvtStoreSnapshot
+
+      //@}
+
+} // namespace
+
+#endif // GPSTK_XVTSTORESNAPSHOT_INCLUDE
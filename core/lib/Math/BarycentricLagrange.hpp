@@ -0,0 +1,248 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file BarycentricLagrange.hpp
+ * Lagrange interpolation in barycentric form, with weights computed once
+ * per set of nodes.
+ */
+
+#ifndef GPSTK_BARYCENTRICLAGRANGE_HPP
+#define GPSTK_BARYCENTRICLAGRANGE_HPP
+
+#include <vector>
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /// @ingroup MathGroup
+      //@{
+
+      /**
+       * Lagrange interpolation on a fixed set of nodes X[i], i=0,N-1,
+       * using the barycentric weights w[i] = 1/PROD(j!=i)[X[i]-X[j]].
+       * The weights depend only on the nodes and are computed once, in
+       * setNodes(); then, for each x, coefficients() computes the
+       * Lagrange basis L[i](x) (and optionally its derivative) in O(N)
+       * (O(N^2) for the derivative) operations, and these apply to any
+       * number of data sets Y on the same nodes:
+       *    y(x) = SUM[L[i](x)*Y[i]], dy/dx(x) = SUM[Lp[i](x)*Y[i]].
+       * This is the same polynomial as LagrangeInterpolation() in
+       * MiscMath.hpp computes, so the results agree to within rounding,
+       * but when several quantities are tabulated at the same times,
+       * or many x lie between the same nodes, it is much cheaper.
+       *
+       * @code
+       * BarycentricLagrange<double> BL(times);
+       * std::vector<double> L, Lp;
+       * BL.coefficients(t, L, Lp);
+       * for(i=0; i<times.size(); i++) {
+       *    x += L[i]*X[i];  vx += Lp[i]*X[i];
+       *    y += L[i]*Y[i];  vy += Lp[i]*Y[i];
+       * }
+       * @endcode
+       */
+   template <class T>
+   class BarycentricLagrange
+   {
+   public:
+         /// Empty constructor; call setNodes() before use.
+      BarycentricLagrange()
+      {}
+
+         /** Constructor given the nodes.
+          * @throw Exception as setNodes() */
+      explicit BarycentricLagrange(const std::vector<T>& X)
+      { setNodes(X); }
+
+         /** Set the nodes and compute the barycentric weights.
+          * @param[in] X the nodes, which must be distinct
+          * @throw Exception if there are fewer than 2 nodes, or two
+          *   nodes are equal */
+      void setNodes(const std::vector<T>& X)
+      {
+         const size_t N(X.size());
+         if(N < 2) {
+            GPSTK_THROW(Exception("At least 2 nodes are required"));
+         }
+         nodes = X;
+         weights.assign(N, T(1));
+         for(size_t i=0; i<N; i++) {
+            for(size_t j=0; j<N; j++) {
+               if(i == j) continue;
+               if(X[i] == X[j]) {
+                  GPSTK_THROW(Exception("Nodes must be distinct"));
+               }
+               weights[i] *= X[i]-X[j];
+            }
+            weights[i] = T(1)/weights[i];
+         }
+      }
+
+         /// Number of nodes
+      size_t size() const
+      { return nodes.size(); }
+
+         /// The nodes
+      const std::vector<T>& getNodes() const
+      { return nodes; }
+
+         /// The barycentric weights w[i]
+      const std::vector<T>& getWeights() const
+      { return weights; }
+
+         /** Compute the Lagrange basis L[i](x), i=0,N-1. At a node
+          * X[k], L[i] is exactly 1 for i=k and 0 otherwise.
+          * @param[in] x where to interpolate
+          * @param[out] L the N coefficients, resized if necessary */
+      void coefficients(const T& x, std::vector<T>& L) const
+      {
+         const size_t N(nodes.size());
+         L.resize(N);
+         size_t i, k(findNode(x));
+         if(k < N) {
+            for(i=0; i<N; i++) L[i] = T(0);
+            L[k] = T(1);
+            return;
+         }
+            // L[i] = w[i]*PROD(j!=i)[x-X[j]], using prefix and suffix
+            // products, so there is no division by x-X[i]
+         T p(1);
+         for(i=0; i<N; i++) {
+            L[i] = p;
+            p *= x-nodes[i];
+         }
+         p = T(1);
+         for(i=N; i-- > 0; ) {
+            L[i] *= p * weights[i];
+            p *= x-nodes[i];
+         }
+      }
+
+         /** Compute the Lagrange basis L[i](x) and its derivative
+          * Lp[i](x) = dL[i]/dx, i=0,N-1.
+          * @param[in] x where to interpolate
+          * @param[out] L the N coefficients, resized if necessary
+          * @param[out] Lp the N derivative coefficients */
+      void coefficients(const T& x, std::vector<T>& L, std::vector<T>& Lp)
+         const
+      {
+         const size_t N(nodes.size());
+         coefficients(x, L);
+         Lp.resize(N);
+         size_t i, k(findNode(x));
+
+         if(k < N) {
+               // at node k: Lp[i] = (w[i]/w[k])/(X[k]-X[i]) for i != k,
+               // and Lp[k] = SUM(j!=k)[1/(X[k]-X[j])]
+            T s(0);
+            for(i=0; i<N; i++) {
+               if(i == k) continue;
+               Lp[i] = (weights[i]/weights[k])/(nodes[k]-nodes[i]);
+               s += T(1)/(nodes[k]-nodes[i]);
+            }
+            Lp[k] = s;
+            return;
+         }
+
+            // Lp[i] = L[i]*SUM(j!=i)[1/(x-X[j])]; the sum is formed from
+            // prefix and suffix sums, without the term j=i, to avoid
+            // cancellation near a node
+         T s(0);
+         for(i=0; i<N; i++) {
+            Lp[i] = s;
+            s += T(1)/(x-nodes[i]);
+         }
+         s = T(0);
+         for(i=N; i-- > 0; ) {
+            Lp[i] = L[i]*(Lp[i]+s);
+            s += T(1)/(x-nodes[i]);
+         }
+      }
+
+         /** Interpolate the data Y at x.
+          * @throw Exception if Y is smaller than the number of nodes */
+      T interpolate(const std::vector<T>& Y, const T& x) const
+      {
+         if(Y.size() < nodes.size()) {
+            GPSTK_THROW(Exception("Input vectors must be of same size"));
+         }
+         std::vector<T> L;
+         coefficients(x, L);
+         T y(0);
+         for(size_t i=0; i<L.size(); i++)
+            y += L[i]*Y[i];
+         return y;
+      }
+
+         /** Interpolate the data Y at x, returning y(x) and dy/dx(x).
+          * @throw Exception if Y is smaller than the number of nodes */
+      void interpolate(const std::vector<T>& Y, const T& x, T& y, T& dydx)
+         const
+      {
+         if(Y.size() < nodes.size()) {
+            GPSTK_THROW(Exception("Input vectors must be of same size"));
+         }
+         std::vector<T> L, Lp;
+         coefficients(x, L, Lp);
+         y = dydx = T(0);
+         for(size_t i=0; i<L.size(); i++) {
+            y += L[i]*Y[i];
+            dydx += Lp[i]*Y[i];
+         }
+      }
+
+   private:
+         /// Return k if x == X[k], otherwise N
+      size_t findNode(const T& x) const
+      {
+         size_t k;
+         for(k=0; k<nodes.size(); k++)
+            if(x == nodes[k]) break;
+         return k;
+      }
+
+      std::vector<T> nodes;            ///< the nodes X[i]
+      std::vector<T> weights;          ///< barycentric weights w[i]
+   };
+
+      //@}
+
+}  // namespace gpstk
+
+#endif
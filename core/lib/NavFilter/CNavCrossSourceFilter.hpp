@@ -100,9 +100,13 @@ namespace gpstk
 
    protected:
          /// Map from subframe data to source list
-      typedef std::map<CNavFilterData*, NavMsgList, CNavMsgSort> MessageMap;
+      typedef std::map<CNavFilterData*, NavMsgList, CNavMsgSort,
+                       PoolAllocator<std::pair<CNavFilterData* const,
+                                               NavMsgList> > > MessageMap;
          /// Map from PRN to SubframeMap
-      typedef std::map<uint32_t, MessageMap> NavMap;
+      typedef std::map<uint32_t, MessageMap, std::less<uint32_t>,
+                       PoolAllocator<std::pair<const uint32_t,
+                                               MessageMap> > > NavMap;
 
          /// Nav subframes grouped by prn and unique nav bits
       NavMap groupedNav;
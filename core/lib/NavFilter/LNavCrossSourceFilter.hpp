@@ -88,9 +88,13 @@ namespace gpstk
 
    protected:
          /// Map from subframe data to source list
-      typedef std::map<LNavFilterData*, NavMsgList, LNavMsgSort> SubframeMap;
+      typedef std::map<LNavFilterData*, NavMsgList, LNavMsgSort,
+                       PoolAllocator<std::pair<LNavFilterData* const,
+                                               NavMsgList> > > SubframeMap;
          /// Map from PRN to SubframeMap
-      typedef std::map<uint32_t, SubframeMap> NavMap;
+      typedef std::map<uint32_t, SubframeMap, std::less<uint32_t>,
+                       PoolAllocator<std::pair<const uint32_t,
+                                               SubframeMap> > > NavMap;
 
          /// Nav subframes grouped by prn and unique nav bits
       NavMap groupedNav;
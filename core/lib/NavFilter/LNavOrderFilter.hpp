@@ -122,7 +122,8 @@ namespace gpstk
       unsigned procDepth;
 
    protected:
-      typedef std::set<LNavFilterData*, LNavTimeSort> SubframeSet;
+      typedef std::set<LNavFilterData*, LNavTimeSort,
+                       PoolAllocator<LNavFilterData*> > SubframeSet;
 
          /// Ordered set of nav message subframes
       SubframeSet orderedNav;
@@ -44,6 +44,7 @@
 #include <list>
 #include "ObsID.hpp"
 #include "NavFilterKey.hpp"
+#include "PoolAllocator.hpp"
 
 namespace gpstk
 {
@@ -55,7 +56,16 @@ namespace gpstk
    class NavFilter
    {
    public:
-      typedef std::list<NavFilterKey*> NavMsgList;
+         /** List of navigation messages passed between filters.
+          * List nodes come from a pool so that, once the filters
+          * have reached their working size, messages flow through a
+          * filter chain without heap allocation.
+          * @note This type used to be std::list<NavFilterKey*>.
+          *   Code that declares its lists with that type must use
+          *   NavFilter::NavMsgList instead to pass them to a filter
+          *   or NavFilterMgr; the list otherwise behaves the same. */
+      typedef std::list<NavFilterKey*, PoolAllocator<NavFilterKey*> >
+      NavMsgList;
 
       NavFilter();
 
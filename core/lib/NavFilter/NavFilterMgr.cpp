@@ -68,7 +68,7 @@ namespace gpstk
          (*i)->validate(rv, newrv);
          if (!(*i)->rejected.empty())
             rejected.insert(*i);
-         rv = newrv;
+         rv.swap(newrv);
       }
       return rv;
    }
@@ -97,22 +97,18 @@ namespace gpstk
             fliNxt = fliCur;
             fliNxt++;
                // cascade the data through the end.
-            rv1 = rv2;
+            rv1.swap(rv2);
             while ((fliNxt != filters.end()) && !rv1.empty())
             {
                (*fliNxt)->rejected.clear();
                rv2.clear();
                (*fliNxt)->validate(rv1, rv2);
-               rv1 = rv2;
+               rv1.swap(rv2);
                fliNxt++;
             }
                // If the filter cascade got some data that passed all
                // filters, add it to the final return value.
-            if (!rv1.empty())
-            {
-               std::copy(rv1.begin(), rv1.end(),
-                         std::back_insert_iterator<NavFilter::NavMsgList>(rv));
-            }
+            rv.splice(rv.end(), rv1);
          }
       }
       return rv;
@@ -166,6 +166,9 @@ namespace gpstk
        * filters are added via addFilter() in the desired order of
        * precedence.  Navigation messages are validated using the
        * validate() method.
+       *
+       * @see ShardedNavFilterMgr to filter large volumes of data
+       *   on several threads.
        */
    class NavFilterMgr
    {
@@ -173,7 +176,8 @@ namespace gpstk
          /// A list of navigation data filters.
       typedef std::list<NavFilter*> FilterList;
          /// A set of unique filter pointers.
-      typedef std::set<NavFilter*> FilterSet;
+      typedef std::set<NavFilter*, std::less<NavFilter*>,
+                       PoolAllocator<NavFilter*> > FilterSet;
 
          /// Do-nothing default constructor.
       NavFilterMgr();
@@ -122,7 +122,8 @@ namespace gpstk
       unsigned procDepth;
 
    protected:
-      typedef std::set<NavFilterKey*, NavTimeSort> SubframeSet;
+      typedef std::set<NavFilterKey*, NavTimeSort,
+                       PoolAllocator<NavFilterKey*> > SubframeSet;
 
          /// Ordered set of nav message subframes
       SubframeSet orderedNav;
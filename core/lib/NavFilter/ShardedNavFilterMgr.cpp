@@ -0,0 +1,185 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <algorithm>
+#include <thread>
+#include "ShardedNavFilterMgr.hpp"
+
+namespace
+{
+      /// Sort navigation messages by time stamp.
+   struct NavKeyTimeLess
+   {
+      bool operator()(const gpstk::NavFilterKey* l,
+                      const gpstk::NavFilterKey* r) const
+      { return l->timeStamp < r->timeStamp; }
+   };
+
+      /// The number of shards to use when nShards are asked for.
+   unsigned shardCount(unsigned nShards)
+   {
+      if (nShards == 0)
+         nShards = std::thread::hardware_concurrency();
+      return (nShards == 0 ? 1 : nShards);
+   }
+}
+
+namespace gpstk
+{
+   ShardedNavFilterMgr ::
+   ShardedNavFilterMgr(unsigned nShards)
+         : finalizing(false),
+           pool(shardCount(nShards) - 1)
+   {
+      shards.resize(shardCount(nShards));
+   }
+
+
+   void ShardedNavFilterMgr ::
+   addFilter(unsigned shard, NavFilter* filt)
+   {
+      if (shard >= shards.size())
+      {
+         InvalidParameter exc("Invalid shard index");
+         GPSTK_THROW(exc);
+      }
+      shards[shard].mgr.addFilter(filt);
+      shards[shard].filters.push_back(filt);
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   validate(const NavFilter::NavMsgList& msgBits)
+   {
+      NavFilter::NavMsgList::const_iterator nmli;
+      for (nmli = msgBits.begin(); nmli != msgBits.end(); nmli++)
+         shards[getShard(*nmli)].input.push_back(*nmli);
+      finalizing = false;
+      runShards();
+      return mergeOutput();
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   finalize()
+   {
+      finalizing = true;
+      runShards();
+      return mergeOutput();
+   }
+
+
+   unsigned ShardedNavFilterMgr ::
+   processingDepth()
+      const throw()
+   {
+      unsigned rv = 1;
+      for (size_t s = 0; s < shards.size(); s++)
+         rv = std::max(rv, shards[s].mgr.processingDepth());
+      return rv;
+   }
+
+
+   void ShardedNavFilterMgr ::
+   processShard(unsigned s)
+   {
+      Shard& shard(shards[s]);
+      NavFilter::NavMsgList out;
+      if (finalizing)
+      {
+         out = shard.mgr.finalize();
+         shard.output.splice(shard.output.end(), out);
+            // NavFilterMgr::finalize() only leaves the rejects of
+            // the last filters it ran
+         for (size_t f = 0; f < shard.filters.size(); f++)
+            shard.rejected.splice(shard.rejected.end(),
+                                  shard.filters[f]->rejected);
+         return;
+      }
+      for (size_t i = 0; i < shard.input.size(); i++)
+      {
+         out = shard.mgr.validate(shard.input[i]);
+         shard.output.splice(shard.output.end(), out);
+            // the filters' rejected lists are cleared by the next
+            // validate call, so collect them now
+         NavFilterMgr::FilterSet::iterator fsi;
+         for (fsi = shard.mgr.rejected.begin();
+              fsi != shard.mgr.rejected.end(); fsi++)
+         {
+            shard.rejected.splice(shard.rejected.end(), (*fsi)->rejected);
+         }
+      }
+      shard.input.clear();
+   }
+
+
+   void ShardedNavFilterMgr ::
+   runShards()
+   {
+      rejected.clear();
+      try
+      {
+         pool.run([this](unsigned s) { processShard(s); });
+      }
+      catch (Exception& e)
+      {
+            // don't leave unprocessed input for the next call
+         for (size_t s = 0; s < shards.size(); s++)
+            shards[s].input.clear();
+         GPSTK_RETHROW(e);
+      }
+   }
+
+
+   NavFilter::NavMsgList ShardedNavFilterMgr ::
+   mergeOutput()
+   {
+      std::vector<NavFilterKey*> merged;
+      for (size_t s = 0; s < shards.size(); s++)
+      {
+         merged.insert(merged.end(), shards[s].output.begin(),
+                       shards[s].output.end());
+         shards[s].output.clear();
+         rejected.splice(rejected.end(), shards[s].rejected);
+      }
+         // stable, so messages with the same time stay in shard
+         // order and, within a shard, in the order they were output
+      std::stable_sort(merged.begin(), merged.end(), NavKeyTimeLess());
+      return NavFilter::NavMsgList(merged.begin(), merged.end());
+   }
+}
@@ -0,0 +1,175 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef SHARDEDNAVFILTERMGR_HPP
+#define SHARDEDNAVFILTERMGR_HPP
+
+#include <vector>
+#include "NavFilterMgr.hpp"
+#include "Exception.hpp"
+#include "WorkerPool.hpp"
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Runs navigation message filters on several threads at once.
+       * Messages are partitioned into shards by satellite (PRN), and
+       * each shard has its own chain of filters in its own
+       * NavFilterMgr, run by its own thread.  The messages passing
+       * the filters of all shards in a call are merged in time
+       * order.
+       *
+       * Because all the messages from a given satellite, from every
+       * receiver and code, go to the same shard, filters that make
+       * their decisions per satellite, such as the cross-source
+       * filters, accept exactly the messages they would accept in a
+       * single NavFilterMgr.  The LNAV and CNAV parity, empty,
+       * TLM/HOW, TOW, cook and cross-source filters are all of this
+       * kind.  The order filters are also, as long as every shard
+       * receives data at every epoch, since their window is measured
+       * from the newest message each has seen.
+       *
+       * Each shard must be given its own instances of the filters,
+       * with the same configuration:
+       * \code{.cpp}
+       * ShardedNavFilterMgr mgr(4);
+       * std::vector<LNavParityFilter> parity(mgr.getNumShards());
+       * std::vector<LNavCrossSourceFilter> xsrc(mgr.getNumShards());
+       * for (unsigned i = 0; i < mgr.getNumShards(); i++)
+       * {
+       *    mgr.addFilter(i, &parity[i]);
+       *    mgr.addFilter(i, &xsrc[i]);
+       * }
+       * \endcode
+       *
+       * Messages are passed in batches, for example all the
+       * subframes received at one epoch, to validate().  Within a
+       * shard, messages are processed in the order given.
+       *
+       * @note Filters that hold data, such as the cross-source and
+       *   order filters, release it when newer data arrives in the
+       *   same shard.  If none of the satellites of a shard have
+       *   data for a while, e.g. at start-up or when they are all
+       *   out of view, their held messages are returned late, after
+       *   newer messages from other shards returned by earlier
+       *   calls. */
+   class ShardedNavFilterMgr
+   {
+   public:
+         /** Start the worker threads.
+          * @param[in] nShards The number of filter chains, and
+          *   threads, to use.  If 0, the number of hardware threads
+          *   is used. */
+      ShardedNavFilterMgr(unsigned nShards = 0);
+
+         /// Return the number of shards.
+      unsigned getNumShards() const throw()
+      { return shards.size(); }
+
+         /// Return the shard that processes the given message.
+      unsigned getShard(const NavFilterKey* msgBits) const throw()
+      { return msgBits->prn % shards.size(); }
+
+         /** Add a filter to the end of the chain of one shard.
+          * @param[in] shard The shard, 0 to getNumShards()-1.
+          * @param[in] filt The filter to be added.  It must not be
+          *   added to any other shard.
+          * @throw InvalidParameter if shard is out of range. */
+      void addFilter(unsigned shard, NavFilter* filt);
+
+         /** Validate a batch of navigation messages.
+          * @param[in] msgBits The navigation messages to filter.
+          * @return Any messages that have successfully passed all
+          *   the filters of their shard, sorted by time stamp.
+          * @throw Exception if a filter throws. */
+      NavFilter::NavMsgList validate(const NavFilter::NavMsgList& msgBits);
+
+         /** Flush the stored data of the filters of all shards.
+          * @return The remaining messages successfully passing the
+          *   filters, sorted by time stamp.
+          * @throw Exception if a filter throws. */
+      NavFilter::NavMsgList finalize();
+
+         /** Gets the effective buffer size in epochs required for
+          * maintaining subframe data, which is the largest
+          * NavFilterMgr::processingDepth() of the shards. */
+      unsigned processingDepth() const throw();
+
+         /** Messages rejected by any filter during the most recent
+          * validate() or finalize() call.  The list is cleared at the
+          * beginning of each of those calls. */
+      NavFilter::NavMsgList rejected;
+
+   private:
+         /// The filters and data of one shard.
+      struct Shard
+      {
+         NavFilterMgr mgr;
+         std::vector<NavFilter*> filters;
+            /// Messages to be processed in the current call.
+         std::vector<NavFilterKey*> input;
+            /// Messages accepted and rejected in the current call.
+         NavFilter::NavMsgList output, rejected;
+      };
+
+         /// Process the input of shard s, in the current thread.
+      void processShard(unsigned s);
+         /// Run processShard() on every shard and wait for them.
+      void runShards();
+         /// Merge the outputs of the shards in time order.
+      NavFilter::NavMsgList mergeOutput();
+
+      std::vector<Shard> shards;
+         /// true during finalize(), false during validate()
+      bool finalizing;
+
+         /// worker threads, for shards 1..n-1; the calling thread
+         /// processes shard 0
+      WorkerPool pool;
+
+         // no copies
+      ShardedNavFilterMgr(const ShardedNavFilterMgr&);
+      ShardedNavFilterMgr& operator=(const ShardedNavFilterMgr&);
+   };
+
+      //@}
+}
+
+#endif // SHARDEDNAVFILTERMGR_HPP
@@ -516,7 +516,30 @@ namespace gpstk
 
          LOG(DEBUG) << "RAIMCompute at time " << printTime(Tr,gpsfmt);
 
-         int iret,N;
+         // ----------------------------------------------------------------
+         // fill the SVP matrix, and use it for every solution
+         // NB this routine will reject sat systems not found in allowedGNSS, and
+         //    sats without ephemeris.
+         Matrix<double> SVP;
+         int N = PreparePRSolution(Tr, Sats, Pseudorange, pEph, SVP);
+
+         return RAIMCompute(Tr, Sats, SVP, N, invMC, pTropModel);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }  // end PRSolution::RAIMCompute()
+
+
+   // -------------------------------------------------------------------------
+   // Compute a solution using RAIM, given the output of PreparePRSolution().
+   int PRSolution::RAIMCompute(const CommonTime& Tr,
+                               vector<SatID>& Sats,
+                               const Matrix<double>& SVP,
+                               const int& NSVS,
+                               const Matrix<double>& invMC,
+                               TropModel *pTropModel)
+   {
+      try {
+         int iret,N(NSVS);
          size_t i,j;
          vector<int> GoodIndexes;
          // use these to save the 'best' solution within the loop.
@@ -526,7 +549,7 @@ namespace gpstk
          double BestRMS(-1.0),BestSL(0.0),BestConv(0.0);
          Vector<double> BestSol(3,0.0),BestPFR;
          vector<SatID> BestSats,SaveSats;
-         Matrix<double> SVP,BestCov,BestInvMCov,BestPartials;
+         Matrix<double> BestCov,BestInvMCov,BestPartials;
          vector<SatelliteSystem> BestGNSS;
 
          // initialize
@@ -534,12 +557,6 @@ namespace gpstk
          currTime = Tr;
          TropFlag = SlopeFlag = RMSFlag = false;
 
-         // ----------------------------------------------------------------
-         // fill the SVP matrix, and use it for every solution
-         // NB this routine will reject sat systems not found in allowedGNSS, and
-         //    sats without ephemeris.
-         N = PreparePRSolution(Tr, Sats, Pseudorange, pEph, SVP);
-
          if(LOGlevel >= ConfigureLOG::Level("DEBUG")) {
             LOG(DEBUG) << "Prepare returns " << N;
             ostringstream oss;
@@ -765,6 +782,24 @@ namespace gpstk
                }
             }
 
+         }
+
+         return finishRAIM(iret);
+      }
+      catch(Exception& e) {
+         GPSTK_RETHROW(e);
+      }
+   }  // end PRSolution::RAIMCompute()
+
+
+   // -------------------------------------------------------------------------
+   // Finish a RAIM solution, given the best solution in the member data.
+   int PRSolution::finishRAIM(int iret)
+   {
+      try {
+         size_t i;
+
+         if(iret >= 0) {
             // compute number of satellites actually used
             for(Nsvs=0,i=0; i<SatelliteIDs.size(); i++)
                if(SatelliteIDs[i].id > 0)
@@ -778,14 +813,13 @@ namespace gpstk
                // update apriori solution
                updateAPSolution(Solution);
             }
-
          }
 
          // ----------------------------------------------------------------
          if(iret==0) {
-            if(BestSL > SlopeLimit) { iret = 1; SlopeFlag = true; }
-            if(BestSL > SlopeLimit/2.0 && Nsvs == 5) { iret = 1; SlopeFlag = true; }
-            if(BestRMS >= RMSLimit) { iret = 1; RMSFlag = true; }
+            if(MaxSlope > SlopeLimit) { iret = 1; SlopeFlag = true; }
+            if(MaxSlope > SlopeLimit/2.0 && Nsvs == 5) { iret = 1; SlopeFlag = true; }
+            if(RMSResidual >= RMSLimit) { iret = 1; RMSFlag = true; }
             if(TropFlag) iret = 1;
             Valid = true;
          }
@@ -799,7 +833,7 @@ namespace gpstk
       catch(Exception& e) {
          GPSTK_RETHROW(e);
       }
-   }  // end PRSolution::RAIMCompute()
+   }  // end PRSolution::finishRAIM()
 
 
    // -------------------------------------------------------------------------
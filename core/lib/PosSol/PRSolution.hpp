@@ -473,6 +473,28 @@ namespace gpstk
                       const XvtStore<SatID> *pEph,
                       TropModel *pTropModel);
 
+      /// Compute a RAIM solution exactly as RAIMCompute() above does, but given
+      /// the output of a previous call to PreparePRSolution() rather than the
+      /// pseudoranges and ephemeris. Since PreparePRSolution() is const, this
+      /// allows the ephemeris computations of many epochs to be done in parallel
+      /// while the solutions themselves, which depend on the memory of this
+      /// object, are computed in order.
+      /// @param Tr          Measured time of reception of the data.
+      /// @param Satellites  std::vector<SatID> of satellites, as marked by
+      ///                    PreparePRSolution(); on return, also marked as above.
+      /// @param SVP         Matrix<double> output by PreparePRSolution().
+      /// @param NSVS        the value returned by PreparePRSolution().
+      /// @param invMC       gpstk::Matrix<double> measurement covariance inverse,
+      ///                    as above.
+      /// @param pTropModel  pointer to gpstk::TropModel for trop correction.
+      /// @return same as RAIMCompute() above.
+      int RAIMCompute(const CommonTime& Tr,
+                      std::vector<SatID>& Satellites,
+                      const Matrix<double>& SVP,
+                      const int& NSVS,
+                      const Matrix<double>& invMC,
+                      TropModel *pTropModel);
+
       /// Compute DOPs using the partials matrix from the last successful solution.
       /// RAIMCompute(), if successful, calls this before returning.
       /// Results stored in PRSolution::TDOP,PDOP,GDOP.
@@ -628,6 +650,16 @@ namespace gpstk
 
    private:
 
+      /// Finish RAIMCompute() after the best solution has been copied into the
+      /// member data: count satellites, compute DOPs, update the memory and set
+      /// the flags and Valid.
+      /// @param iret the return value of RAIMCompute() so far
+      /// @return the return value of RAIMCompute()
+      int finishRAIM(int iret);
+
+      /// RAIMSolver computes RAIMCompute() in its own storage.
+      friend class RAIMSolver;
+
       /// flag: output content is valid.
       bool Valid;
 
@@ -0,0 +1,865 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file RAIMSolver.cpp
+/// Fixed-size RAIM kernel for PRSolution: the same algorithm as
+/// PRSolution::RAIMCompute(), computed in storage allocated at construction.
+
+#include "MathBase.hpp"
+#include "MiscMath.hpp"
+#include "RAIMSolver.hpp"
+#include "GPSEllipsoid.hpp"
+#include "Position.hpp"
+#include "logstream.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   // -------------------------------------------------------------------------
+   // RSS of v[0..n-1], computed as gpstk::norm(Vector) does.
+   static double vecNorm(const double *v, const int& n)
+   {
+      double mag(0.0);
+      if(n == 0) return mag;
+      mag = ::fabs(v[0]);
+      for(int i=1; i<n; i++) {
+         if(mag > ::fabs(v[i]))
+            mag *= SQRT(1.0+(v[i]/mag)*(v[i]/mag));
+         else if(::fabs(v[i]) > mag)
+            mag = ::fabs(v[i])*SQRT(1.0+(mag/v[i])*(mag/v[i]));
+         else
+            mag *= SQRT(2.0);
+      }
+      return mag;
+   }
+
+   // -------------------------------------------------------------------------
+   // Number of combinations of k in N, or cap+1 if that is larger than cap.
+   static unsigned long nCombos(const int& N, const int& k, const unsigned long& cap)
+   {
+      unsigned long n(1);
+      for(int i=1; i<=k; i++) {
+         n = n*(N-k+i)/i;
+         if(n > cap) return cap+1;
+      }
+      return n;
+   }
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::Workspace::init(const unsigned int M, const unsigned int D)
+   {
+      use.assign(M,0);
+      combo.assign(M,0);
+      sys.assign(D-3,0);
+      col.assign(D-3,0);
+      idx.assign(M,0);
+      P.assign(M*D,0.0);
+      R.assign(M,0.0);
+      PtW.assign(D*M,0.0);
+      L.assign(D*D,0.0);
+      b.assign(D,0.0);
+      X.assign(D,0.0);
+      dX.assign(D,0.0);
+      Cov.assign(D*D,0.0);
+      g.assign(D,0.0);
+      iret = nsvs = dim = nsys = niter = 0;
+      tropFlag = isSVD = false;
+      conv = rms = maxSlope = 0.0;
+   }
+
+   // -------------------------------------------------------------------------
+   RAIMSolver::RAIMSolver(const unsigned int maxSatellites,
+                          const unsigned int maxSystems,
+                          const unsigned int nthreads,
+                          const unsigned int maxCombinations)
+      : maxSats(maxSatellites), maxGNSS(maxSystems), maxDim(3+maxSystems),
+        nThreads(nthreads < 1 ? 1 : nthreads), maxCombos(maxCombinations),
+        pPRS(NULL), pTime(NULL), pSVP(NULL), pInvMC(NULL), pTrop(NULL),
+        nSats(0), nGood(0), weighted(false), diagonal(true), haveFirst(false),
+        firstNsys(0), pool(nThreads-1), stageN(0), stageK(0), stageTotal(0)
+   {
+      if(maxSats < 1 || maxGNSS < 1) {
+         Exception e("RAIMSolver requires at least one satellite and system");
+         GPSTK_THROW(e);
+      }
+
+      good.assign(maxSats,0);
+      sysIndex.assign(maxSats,-1);
+      wt.assign(maxSats,0.0);
+      AP.assign(maxDim,0.0);
+      firstP.assign(maxSats*3,0.0);
+      firstR.assign(maxSats,0.0);
+      firstL.assign(maxDim*maxDim,0.0);
+      firstB.assign(maxDim,0.0);
+      firstSys.assign(maxGNSS,0);
+      combo.assign(maxSats,0);
+      saveSats.reserve(maxSats);
+
+      work.resize(nThreads+1);
+      for(size_t i=0; i<work.size(); i++)
+         work[i].init(maxSats,maxDim);
+      pCur = &work[0];
+
+      if(nThreads > 1) {
+         stageIret.assign(maxCombos,0);
+         stageRMS.assign(maxCombos,0.0);
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   int RAIMSolver::RAIMCompute(PRSolution& prs,
+                               const CommonTime& Tr,
+                               vector<SatID>& Sats,
+                               const vector<double>& Pseudorange,
+                               const Matrix<double>& invMC,
+                               const XvtStore<SatID> *pEph,
+                               TropModel *pTropModel)
+   {
+      try {
+         Matrix<double> SVP;
+         int N = prs.PreparePRSolution(Tr, Sats, Pseudorange, pEph, SVP);
+
+         return RAIMCompute(prs, Tr, Sats, SVP, N, invMC, pTropModel);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
+   // -------------------------------------------------------------------------
+   // The stage and combination loops follow PRSolution::RAIMCompute() exactly;
+   // only the solution of each combination, and where it is stored, differ.
+   int RAIMSolver::RAIMCompute(PRSolution& prs,
+                               const CommonTime& Tr,
+                               vector<SatID>& Sats,
+                               const Matrix<double>& SVP,
+                               const int& NSVS,
+                               const Matrix<double>& invMC,
+                               TropModel *pTropModel)
+   {
+      try {
+         int i,iret(-4),N(NSVS);
+         double BestRMS(-1.0);
+
+         // problems that do not fit
+         if(Sats.size() > maxSats || prs.allowedGNSS.size() > maxGNSS)
+            return prs.RAIMCompute(Tr, Sats, SVP, NSVS, invMC, pTropModel);
+
+         // initialize
+         prs.Valid = false;
+         prs.currTime = Tr;
+         prs.TropFlag = prs.SlopeFlag = prs.RMSFlag = false;
+
+         // return is >=0(number of good sats) or -4(no ephemeris)
+         if(N <= 0) return -4;
+
+         // same checks as SimplePRSolution()
+         if(!pTropModel) {
+            Exception e("Undefined tropospheric model");
+            GPSTK_THROW(e);
+         }
+         if(Sats.size() != SVP.rows() ||
+            (invMC.rows() > 0 && invMC.rows() != Sats.size())) {
+            Exception e("Invalid dimensions");
+            GPSTK_THROW(e);
+         }
+         if(prs.allowedGNSS.size() == 0) {
+            Exception e("Must define systems vector allowedGNSS before processing");
+            GPSTK_THROW(e);
+         }
+
+         pPRS = &prs;
+         pTime = &Tr;
+         pSVP = &SVP;
+         pInvMC = &invMC;
+         pTrop = pTropModel;
+         prepareEpoch(Sats);
+
+         // work spaces for the current and best solutions
+         pCur = &work[0];
+         Workspace *pBest(&work[1]);
+
+         // the stage and rank of the last combination computed
+         int lastStage(0);
+         unsigned long lastRank(0);
+
+         // stage is the number of satellites to reject.
+         int stage(0);
+
+         do {
+            if(stage > N) { iret = -3; break; }
+
+            const unsigned long total(nCombos(N, stage, maxCombos));
+
+            if(nThreads > 1 && stage > 0
+                            && total >= nThreads && total <= maxCombos) {
+               // compute the whole stage, then examine it in order
+               parallelStage(N, stage, total);
+
+               long bestRank(-1);
+               unsigned long r;
+               for(r=0; r<total; r++) {
+                  iret = stageIret[r];
+                  if(iret < 0) {
+                     if(iret == -3 || iret == -4) break;
+                     continue;
+                  }
+                  if(BestRMS < 0.0 || stageRMS[r] < BestRMS) {
+                     BestRMS = stageRMS[r];
+                     bestRank = r;
+                  }
+               }
+               lastStage = stage;
+               lastRank = (r < total ? r : total-1);
+
+               // compute the best again, to save it
+               if(bestRank > -1) {
+                  firstCombo(&combo[0], stage);
+                  for(r=0; r<(unsigned long)(bestRank); r++)
+                     nextCombo(&combo[0], N, stage);
+                  markCombo(*pCur, &combo[0], stage);
+                  solve(*pCur);
+                  swap(pCur, pBest);
+               }
+            }
+            else {
+               // compute a solution for each combination of marked satellites
+               unsigned long r(0);
+               firstCombo(&combo[0], stage);
+               do {
+                  lastStage = stage;
+                  lastRank = r++;
+
+                  markCombo(*pCur, &combo[0], stage);
+                  solve(*pCur);
+                  iret = pCur->iret;
+
+                  // if error, either quit or continue with next combo
+                  if(iret < 0) {
+                     if(iret == -3 || iret == -4) break;
+                     continue;
+                  }
+
+                  // save 'best' solution for later
+                  const double rms(pCur->rms);
+                  if(BestRMS < 0.0 || rms < BestRMS) {
+                     BestRMS = rms;
+                     swap(pCur, pBest);
+                  }
+
+                  if(stage==0 && rms < pPRS->RMSLimit)
+                     break;
+
+               } while(nextCombo(&combo[0], N, stage));
+            }
+
+            // end of the stage
+            if(BestRMS > 0.0 && BestRMS < prs.RMSLimit) {          // success
+               iret = 0;
+               break;
+            }
+
+            // go to next stage
+            stage++;
+
+            // but not if too many are being rejected
+            if(prs.NSatsReject > -1 && stage > prs.NSatsReject)
+               break;
+
+            // already broke out of the combo loop...
+            if(iret == -3 || iret == -4)
+               break;
+
+         } while(1);    // end loop over stages
+
+         // ----------------------------------------------------------------
+         // copy out the best solution
+         if(iret >= 0) {
+            copyOut(prs, *pBest, Sats);
+            iret = 0;
+         }
+         else {
+            // leave Sats marked by the last combination, as RAIMCompute() does
+            firstCombo(&combo[0], lastStage);
+            for(unsigned long r=0; r<lastRank; r++)
+               nextCombo(&combo[0], N, lastStage);
+            markCombo(*pCur, &combo[0], lastStage);
+            for(i=0; i<nSats; i++) Sats[i] = saveSats[i];
+            for(i=0; i<nGood; i++) if(!pCur->use[i])
+               Sats[good[i]].id = -::abs(Sats[good[i]].id);
+         }
+
+         return prs.finishRAIM(iret);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }  // end RAIMSolver::RAIMCompute()
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::prepareEpoch(const vector<SatID>& Sats)
+   {
+      const PRSolution& prs(*pPRS);
+      const Matrix<double>& SVP(*pSVP);
+      const Matrix<double>& invMC(*pInvMC);
+      const int nAllowed(prs.allowedGNSS.size());
+      GPSEllipsoid ellip;
+      int i,j,k,n;
+
+      // save the input; saveSats has capacity maxSats
+      saveSats = Sats;
+      nSats = Sats.size();
+
+      // the good satellites, as indexed by the combinations, and their systems
+      for(nGood=0,i=0; i<nSats; i++) {
+         sysIndex[i] = -1;
+         if(Sats[i].id <= 0) continue;
+         good[nGood++] = i;
+         sysIndex[i] = vectorindex(prs.allowedGNSS, Sats[i].system);
+      }
+
+      // weights
+      weighted = (invMC.rows() > 0);
+      diagonal = true;
+      for(j=0; j<nGood; j++) {
+         i = good[j];
+         wt[i] = (weighted ? invMC(i,i) : 1.0);
+         if(weighted && diagonal) for(k=0; k<nGood; k++)
+            if(k != j && invMC(i,good[k]) != 0.0) { diagonal = false; break; }
+      }
+
+      // apriori solution, by allowedGNSS
+      for(i=0; i<3+nAllowed; i++)
+         AP[i] = (prs.hasMemory && i < int(prs.APSolution.size())
+                  ? prs.APSolution[i] : 0.0);
+
+      // first iteration, linearized at the apriori for every combination;
+      // this is the n_iterate == 0 branch of SimplePRSolution()
+      double rho,w,svxyz[3];
+      for(j=0; j<nGood; j++) {
+         i = good[j];
+         if(sysIndex[i] == -1) continue;
+
+         rho = 0.070;
+         w = ellip.angVelocity()*rho;
+         svxyz[0] =  ::cos(w)*SVP(i,0) + ::sin(w)*SVP(i,1);
+         svxyz[1] = -::sin(w)*SVP(i,0) + ::cos(w)*SVP(i,1);
+         svxyz[2] = SVP(i,2);
+         rho = RSS(svxyz[0]-AP[0], svxyz[1]-AP[1], svxyz[2]-AP[2]);
+         for(k=0; k<3; k++)
+            firstP[3*i+k] = (AP[k]-svxyz[k])/rho;
+         firstR[i] = (SVP(i,3) - rho) - AP[3+sysIndex[i]];
+      }
+
+      // factor the first iteration of the full set, for downdating
+      haveFirst = false;
+      if(weighted && !diagonal) return;
+
+      Workspace& ws(work[0]);
+      for(j=0; j<nGood; j++) ws.use[j] = 1;
+      if(!setSystems(ws)) return;
+      if(ws.nsvs < ws.dim) return;
+
+      for(n=0,j=0; j<nGood; j++) {
+         i = good[j];
+         if(!ws.use[j] || sysIndex[i] == -1) continue;
+         ws.idx[n] = i;
+         setFirstRow(ws, n, i);
+         n++;
+      }
+      buildNormal(ws);
+      const int dim(ws.dim);
+      for(i=0; i<dim*dim; i++) ws.L[i] = ws.Cov[i];
+      if(!cholesky(&ws.L[0], dim)) return;
+
+      for(i=0; i<dim*dim; i++) firstL[i] = ws.L[i];
+      for(i=0; i<dim; i++) firstB[i] = ws.b[i];
+      for(i=0; i<ws.nsys; i++) firstSys[i] = ws.sys[i];
+      firstNsys = ws.nsys;
+      haveFirst = true;
+   }
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::firstCombo(int *c, const int& k)
+   {
+      for(int j=0; j<k; j++) c[j] = j;
+   }
+
+   // -------------------------------------------------------------------------
+   bool RAIMSolver::nextCombo(int *c, const int& N, const int& k)
+   {
+      // Combinations::Next() and Increment()
+      for(int j=k-1; j>=0; j--) {
+         if(c[j] < N-k+j) {
+            c[j]++;
+            for(int m=j+1; m<k; m++) c[m] = c[m-1]+1;
+            return true;
+         }
+      }
+      return false;
+   }
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::markCombo(Workspace& ws, const int *c, const int& k)
+   {
+      int j;
+      for(j=0; j<nGood; j++) ws.use[j] = 1;
+      for(j=0; j<k; j++)
+         if(c[j] < nGood) ws.use[c[j]] = 0;
+   }
+
+   // -------------------------------------------------------------------------
+   // define the clocks of the satellites in ws.use, and count satellites
+   bool RAIMSolver::setSystems(Workspace& ws)
+   {
+      const int nAllowed(pPRS->allowedGNSS.size());
+      int i,j;
+
+      for(i=0; i<nAllowed; i++) ws.col[i] = 0;
+      for(ws.nsvs=0,j=0; j<nGood; j++) {
+         if(!ws.use[j]) continue;
+         i = sysIndex[good[j]];
+         if(i == -1) continue;
+         ws.nsvs++;
+         ws.col[i] = 1;
+      }
+
+      // sorted as in allowedGNSS
+      for(ws.nsys=0,i=0; i<nAllowed; i++) {
+         if(ws.col[i]) {
+            ws.sys[ws.nsys] = i;
+            ws.col[i] = 3 + ws.nsys;
+            ws.nsys++;
+         }
+         else
+            ws.col[i] = -1;
+      }
+
+      ws.dim = 3 + ws.nsys;
+      return (ws.nsys > 0);
+   }
+
+   // -------------------------------------------------------------------------
+   // row n of partials and residuals from the first iteration of satellite i
+   void RAIMSolver::setFirstRow(Workspace& ws, const int& n, const int& i)
+   {
+      const int dim(ws.dim);
+      double *p(&ws.P[n*dim]);
+      for(int k=0; k<dim; k++) p[k] = 0.0;
+      p[0] = firstP[3*i];
+      p[1] = firstP[3*i+1];
+      p[2] = firstP[3*i+2];
+      p[ws.col[sysIndex[i]]] = 1.0;
+      ws.R[n] = firstR[i];
+   }
+
+   // -------------------------------------------------------------------------
+   // normal matrix transpose(P)*W*P into ws.Cov and transpose(P)*W*R into ws.b
+   void RAIMSolver::buildNormal(Workspace& ws)
+   {
+      const int dim(ws.dim), nsvs(ws.nsvs);
+      int j,k,n,m;
+
+      for(j=0; j<dim*dim; j++) ws.Cov[j] = 0.0;
+      for(j=0; j<dim; j++) ws.b[j] = 0.0;
+
+      if(weighted && !diagonal) {
+         const Matrix<double>& invMC(*pInvMC);
+         // PtW(k,m) = sum_n P(n,k) W(n,m)
+         for(k=0; k<dim; k++) for(m=0; m<nsvs; m++) {
+            double sum(0.0);
+            for(n=0; n<nsvs; n++)
+               sum += ws.P[n*dim+k] * invMC(ws.idx[n],ws.idx[m]);
+            ws.PtW[k*nsvs+m] = sum;
+         }
+         for(j=0; j<dim; j++) {
+            for(k=0; k<=j; k++) {
+               double sum(0.0);
+               for(m=0; m<nsvs; m++) sum += ws.PtW[j*nsvs+m] * ws.P[m*dim+k];
+               ws.Cov[j*dim+k] = ws.Cov[k*dim+j] = sum;
+            }
+            for(m=0; m<nsvs; m++) ws.b[j] += ws.PtW[j*nsvs+m] * ws.R[m];
+         }
+      }
+      else {
+         for(n=0; n<nsvs; n++) {
+            const double *p(&ws.P[n*dim]);
+            const double w(wt[ws.idx[n]]);
+            for(j=0; j<dim; j++) {
+               if(p[j] == 0.0) continue;
+               const double wp(w*p[j]);
+               for(k=0; k<=j; k++) ws.Cov[j*dim+k] += wp*p[k];
+               ws.b[j] += wp*ws.R[n];
+            }
+         }
+         for(j=0; j<dim; j++) for(k=0; k<j; k++)
+            ws.Cov[k*dim+j] = ws.Cov[j*dim+k];
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   bool RAIMSolver::cholesky(double *L, const int& dim)
+   {
+      int i,j,k;
+      double big(0.0);
+      for(j=0; j<dim; j++) if(L[j*dim+j] > big) big = L[j*dim+j];
+
+      for(j=0; j<dim; j++) {
+         double d(L[j*dim+j]);
+         for(k=0; k<j; k++) d -= L[j*dim+k]*L[j*dim+k];
+         // near singular: leave it to the SVD, which edits singular values
+         if(d <= 1.e-10*big) return false;
+         d = SQRT(d);
+         L[j*dim+j] = d;
+         for(i=j+1; i<dim; i++) {
+            double s(L[i*dim+j]);
+            for(k=0; k<j; k++) s -= L[i*dim+k]*L[j*dim+k];
+            L[i*dim+j] = s/d;
+         }
+         for(i=0; i<j; i++) L[i*dim+j] = 0.0;
+      }
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   bool RAIMSolver::downdate(double *L, const int& dim, double *x)
+   {
+      for(int k=0; k<dim; k++) {
+         const double Lkk(L[k*dim+k]);
+         const double r2(Lkk*Lkk - x[k]*x[k]);
+         // losing precision: rebuild the normal equations instead
+         if(r2 <= 1.e-6*Lkk*Lkk) return false;
+         const double r(SQRT(r2)), c(r/Lkk), s(x[k]/Lkk);
+         L[k*dim+k] = r;
+         for(int i=k+1; i<dim; i++) {
+            L[i*dim+k] = (L[i*dim+k] - s*x[i])/c;
+            x[i] = c*x[i] - s*L[i*dim+k];
+         }
+      }
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::cholSolve(const double *L, const int& dim, double *b)
+   {
+      int i,k;
+      for(i=0; i<dim; i++) {
+         for(k=0; k<i; k++) b[i] -= L[i*dim+k]*b[k];
+         b[i] /= L[i*dim+i];
+      }
+      for(i=dim-1; i>=0; i--) {
+         for(k=i+1; k<dim; k++) b[i] -= L[k*dim+i]*b[k];
+         b[i] /= L[i*dim+i];
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   // Solve for the satellites in ws.use; this is SimplePRSolution() with
+   // the results left in ws.
+   void RAIMSolver::solve(Workspace& ws)
+   {
+      const PRSolution& prs(*pPRS);
+      const Matrix<double>& SVP(*pSVP);
+      GPSEllipsoid ellip;
+      int i,j,k,n;
+
+      ws.rms = ws.maxSlope = ws.conv = 0.0;
+      ws.niter = 0;
+      ws.tropFlag = ws.isSVD = false;
+
+      // counts, systems and dimensions
+      setSystems(ws);
+      const int dim(ws.dim), nsvs(ws.nsvs);
+
+      // require number of good satellites to be >= number unknowns
+      if(nsvs < dim) { ws.iret = -3; return; }
+
+      // the satellites used, in order
+      for(n=0,j=0; j<nGood; j++) {
+         i = good[j];
+         if(ws.use[j] && sysIndex[i] != -1) ws.idx[n++] = i;
+      }
+
+      // start with solution = apriori
+      for(k=0; k<3; k++) ws.X[k] = AP[k];
+      for(k=0; k<ws.nsys; k++) ws.X[3+k] = AP[3+ws.sys[k]];
+
+      // iterate at least twice so that trop model gets evaluated
+      const int niter_limit(prs.MaxNIterations < 2 ? 2 : prs.MaxNIterations);
+      int n_iterate(0);
+      double rho,w,svxyz[3];
+      Position R,S;
+
+      ws.iret = 0;
+      do {
+         ws.tropFlag = false;
+
+         if(n_iterate == 0) {
+            // the first iteration is the same for every combination
+            for(n=0; n<nsvs; n++) setFirstRow(ws, n, ws.idx[n]);
+
+            bool ok(false);
+            if(haveFirst && ws.nsys == firstNsys) {
+               // downdate the full set by the rejected satellites
+               for(k=0; k<dim*dim; k++) ws.L[k] = firstL[k];
+               for(k=0; k<dim; k++) ws.b[k] = firstB[k];
+               ok = true;
+               for(j=0; ok && j<nGood; j++) {
+                  i = good[j];
+                  if(ws.use[j] || sysIndex[i] == -1) continue;
+                  const double sw(SQRT(wt[i]));
+                  for(k=0; k<dim; k++) ws.g[k] = 0.0;
+                  for(k=0; k<3; k++) ws.g[k] = firstP[3*i+k];
+                  ws.g[ws.col[sysIndex[i]]] = 1.0;
+                  for(k=0; k<dim; k++) ws.b[k] -= wt[i]*ws.g[k]*firstR[i];
+                  for(k=0; k<dim; k++) ws.g[k] *= sw;
+                  ok = downdate(&ws.L[0], dim, &ws.g[0]);
+               }
+            }
+            if(!ok) {
+               buildNormal(ws);
+               for(k=0; k<dim*dim; k++) ws.L[k] = ws.Cov[k];
+               ws.isSVD = !cholesky(&ws.L[0], dim);
+            }
+         }
+         else {
+            // current estimate of position solution
+            R.setECEF(ws.X[0],ws.X[1],ws.X[2]);
+            const double ht(R.getHeight());
+
+            for(n=0; n<nsvs; n++) {
+               i = ws.idx[n];
+               double *p(&ws.P[n*dim]);
+
+               // rho is time of flight (sec)
+               rho = RSS(SVP(i,0)-ws.X[0], SVP(i,1)-ws.X[1], SVP(i,2)-ws.X[2])
+                                                                     / ellip.c();
+
+               // correct for earth rotation
+               w = ellip.angVelocity()*rho;
+               svxyz[0] =  ::cos(w)*SVP(i,0) + ::sin(w)*SVP(i,1);
+               svxyz[1] = -::sin(w)*SVP(i,0) + ::cos(w)*SVP(i,1);
+               svxyz[2] = SVP(i,2);
+
+               // rho is now geometric range
+               rho = RSS(svxyz[0]-ws.X[0], svxyz[1]-ws.X[1], svxyz[2]-ws.X[2]);
+
+               for(k=0; k<dim; k++) p[k] = 0.0;
+               for(k=0; k<3; k++) p[k] = (ws.X[k]-svxyz[k])/rho;
+
+               // corrected pseudorange (m) minus geometric range
+               double cr(SVP(i,3) - rho);
+
+               // trop; R is tested for reasonableness as in SimplePRSolution()
+               S.setECEF(svxyz[0],svxyz[1],svxyz[2]);
+               double tc(0.0);
+               if(R.elevation(S) < 0.0 || ht > 44247. || ht < -1000.0)
+                  ws.tropFlag = true;
+               else if(nThreads > 1) {
+                  lock_guard<mutex> lock(tropMutex);
+                  tc = pTrop->correction(R,S,*pTime);
+               }
+               else
+                  tc = pTrop->correction(R,S,*pTime);
+               cr -= tc;
+
+               // clock
+               j = ws.col[sysIndex[i]];
+               ws.R[n] = cr - ws.X[j];
+               p[j] = 1.0;
+            }
+
+            buildNormal(ws);
+            for(k=0; k<dim*dim; k++) ws.L[k] = ws.Cov[k];
+            ws.isSVD = !cholesky(&ws.L[0], dim);
+         }
+
+         // solve the normal equations; near singular problems use the SVD
+         if(ws.isSVD) {
+            Matrix<double> A(dim,dim);
+            for(j=0; j<dim; j++) for(k=0; k<dim; k++) A(j,k) = ws.Cov[j*dim+k];
+            try { A = inverseSVD(A); }
+            catch(SingularMatrixException& sme) { ws.iret = -2; return; }
+            for(j=0; j<dim; j++) {
+               ws.dX[j] = 0.0;
+               for(k=0; k<dim; k++) {
+                  ws.Cov[j*dim+k] = A(j,k);
+                  ws.dX[j] += A(j,k)*ws.b[k];
+               }
+            }
+         }
+         else {
+            for(k=0; k<dim; k++) ws.dX[k] = ws.b[k];
+            cholSolve(&ws.L[0], dim, &ws.dX[0]);
+         }
+
+         n_iterate++;
+
+         // compute solution
+         for(k=0; k<dim; k++) ws.X[k] += ws.dX[k];
+
+         // test for convergence
+         ws.conv = vecNorm(&ws.dX[0], dim);
+         if(n_iterate > 1 && ws.conv < prs.ConvergenceLimit) {
+            ws.iret = 0;
+            break;
+         }
+         if(n_iterate >= niter_limit || ws.conv > 1.e10) {
+            ws.iret = -1;
+            break;
+         }
+
+      } while(1);    // end iteration loop
+
+      ws.niter = n_iterate;
+      ws.rms = vecNorm(&ws.R[0], nsvs)/SQRT(double(nsvs));
+      if(ws.iret != 0) return;
+
+      // covariance
+      if(!ws.isSVD) {
+         for(j=0; j<dim; j++) {
+            for(k=0; k<dim; k++) ws.g[k] = (k == j ? 1.0 : 0.0);
+            cholSolve(&ws.L[0], dim, &ws.g[0]);
+            for(k=0; k<dim; k++) ws.Cov[k*dim+j] = ws.g[k];
+         }
+      }
+
+      // slopes, from the columns of the generalized inverse G = Cov*PT*W
+      for(n=0; n<nsvs; n++) {
+         const double *p(&ws.P[n*dim]);
+         for(j=0; j<dim; j++) {
+            double sum(0.0);
+            if(weighted && !diagonal)
+               for(k=0; k<dim; k++) sum += ws.Cov[j*dim+k]*ws.PtW[k*nsvs+n];
+            else
+               for(k=0; k<dim; k++) sum += ws.Cov[j*dim+k]*p[k];
+            ws.g[j] = (weighted && !diagonal ? sum : sum*wt[ws.idx[n]]);
+         }
+         double pg(0.0), gg(0.0);
+         for(k=0; k<dim; k++) { pg += p[k]*ws.g[k]; gg += ws.g[k]*ws.g[k]; }
+
+         // PG(j,j) = 1 (nearly 1) when one (few) sats have their own clock;
+         // SimplePRSolution() then computes no more slopes
+         if(::fabs(1.0-pg) < 1.e-8) break;
+
+         const double slope(SQRT(gg*double(nsvs-dim)/(1.0-pg)));
+         if(slope > ws.maxSlope) ws.maxSlope = slope;
+      }
+
+   }  // end RAIMSolver::solve()
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::parallelStage(const int& N, const int& k,
+                                  const unsigned long& total)
+   {
+      stageN = N;
+      stageK = k;
+      stageTotal = total;
+      pool.run([this](unsigned int t) { stagePart(t); });
+   }
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::stagePart(const unsigned int& t)
+   {
+      Workspace& ws(t == 0 ? *pCur : work[1+t]);
+      int *c(t == 0 ? &combo[0] : &ws.combo[0]);
+      unsigned long r(0);
+
+      firstCombo(c, stageK);
+      do {
+         if(r % nThreads == t) {
+            markCombo(ws, c, stageK);
+            solve(ws);
+            stageIret[r] = ws.iret;
+            stageRMS[r] = ws.rms;
+         }
+         r++;
+      } while(r < stageTotal && nextCombo(c, stageN, stageK));
+   }
+
+   // -------------------------------------------------------------------------
+   void RAIMSolver::copyOut(PRSolution& prs, Workspace& ws, vector<SatID>& Sats)
+   {
+      const int dim(ws.dim), nsvs(ws.nsvs);
+      int i,j,k;
+
+      for(i=0; i<nSats; i++) Sats[i] = saveSats[i];
+      for(j=0; j<nGood; j++) if(!ws.use[j])
+         Sats[good[j]].id = -::abs(Sats[good[j]].id);
+      prs.SatelliteIDs = Sats;
+
+      prs.dataGNSS.clear();
+      for(i=0; i<ws.nsys; i++)
+         prs.dataGNSS.push_back(prs.allowedGNSS[ws.sys[i]]);
+
+      prs.Solution.resize(dim);
+      prs.Covariance.resize(dim,dim);
+      for(j=0; j<dim; j++) {
+         prs.Solution(j) = ws.X[j];
+         for(k=0; k<dim; k++) prs.Covariance(j,k) = ws.Cov[j*dim+k];
+      }
+
+      prs.Partials.resize(nsvs,dim);
+      for(i=0; i<nsvs; i++) for(j=0; j<dim; j++)
+         prs.Partials(i,j) = ws.P[i*dim+j];
+
+      if(weighted) {
+         const Matrix<double>& invMC(*pInvMC);
+         prs.invMeasCov.resize(nsvs,nsvs);
+         for(i=0; i<nsvs; i++) for(j=0; j<nsvs; j++)
+            prs.invMeasCov(i,j) = invMC(ws.idx[i],ws.idx[j]);
+      }
+      else
+         prs.invMeasCov = Matrix<double>();
+
+      // pre-fit residuals = P*(Solution-apriori) - Resids
+      if(prs.hasMemory) {
+         prs.PreFitResidual.resize(nsvs);
+         for(i=0; i<nsvs; i++) {
+            double sum(0.0);
+            for(j=0; j<dim; j++)
+               sum += ws.P[i*dim+j]*(ws.X[j] - (j<3 ? AP[j] : AP[3+ws.sys[j-3]]));
+            prs.PreFitResidual(i) = sum - ws.R[i];
+         }
+      }
+
+      prs.Convergence = ws.conv;
+      prs.NIterations = ws.niter;
+      prs.RMSResidual = ws.rms;
+      prs.MaxSlope = ws.maxSlope;
+      prs.TropFlag = ws.tropFlag;
+   }
+
+}  // namespace gpstk
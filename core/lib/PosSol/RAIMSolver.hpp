@@ -0,0 +1,272 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file RAIMSolver.hpp
+/// Fixed-size RAIM kernel for PRSolution: the same algorithm as
+/// PRSolution::RAIMCompute(), computed in storage allocated at construction.
+
+#ifndef RAIM_SOLVER_HPP
+#define RAIM_SOLVER_HPP
+
+#include <vector>
+#include <mutex>
+#include "PRSolution.hpp"
+#include "WorkerPool.hpp"
+
+namespace gpstk
+{
+   /** @addtogroup GPSsolutions */
+   //@{
+
+   /// Class RAIMSolver computes the RAIM solution of PRSolution::RAIMCompute()
+   /// without allocating memory in the search over satellite subsets.
+   ///
+   /// RAIMCompute() solves a linearized least squares problem for every
+   /// combination of rejected satellites, and with many satellites this search
+   /// dominates the cost of a position solution. RAIMSolver does the same search
+   /// using work space sized at construction for a maximum number of satellites
+   /// and systems, so that a solution involves no heap allocation until the
+   /// selected solution is copied into the PRSolution. In addition
+   ///  - the normal equations are solved by Cholesky decomposition,
+   ///  - the first iteration, which is linearized at the apriori solution and so
+   ///    is the same for every subset, is computed once per epoch; each subset
+   ///    then starts from the factorization of the full set, with the rejected
+   ///    satellites removed by rank-one downdates (only when the data are not
+   ///    weighted, or weighted by a diagonal matrix),
+   ///  - optionally, the subsets within each stage of the search are solved by
+   ///    a pool of threads; the results are then examined in the same order as
+   ///    RAIMCompute() does, so the selected solution does not depend on the
+   ///    number of threads.
+   ///
+   /// The results, stored in the PRSolution in the same members RAIMCompute()
+   /// uses, agree with those of RAIMCompute() to within rounding; the SVD
+   /// inverse is used only when the normal matrix is near singular.
+   /// A problem larger than the work space is passed to RAIMCompute().
+   ///
+   /// The TropModel is called with a lock held, so one model may be shared by
+   /// the threads. The PRSolution itself is read by the threads, and so must not
+   /// be modified during a call.
+   class RAIMSolver
+   {
+   public:
+      /// Constructor. Allocates all the work space and starts the threads.
+      /// @param maxSats    maximum number of satellites (good or marked) per epoch
+      /// @param maxGNSS    maximum number of systems in PRSolution::allowedGNSS
+      /// @param nThreads   number of threads to use, including the calling thread
+      /// @param maxCombos  largest RAIM stage (number of combinations of rejected
+      ///                    satellites) that will be divided among the threads;
+      ///                    larger stages are computed in the calling thread.
+      RAIMSolver(const unsigned int maxSats=64,
+                 const unsigned int maxGNSS=4,
+                 const unsigned int nThreads=1,
+                 const unsigned int maxCombos=8192);
+
+      /// Compute a RAIM solution as PRSolution::RAIMCompute() does with the
+      /// same arguments, storing the results in prs. The selected satellites
+      /// are the same, and the solution agrees to rounding.
+      /// @return same as PRSolution::RAIMCompute().
+      int RAIMCompute(PRSolution& prs,
+                      const CommonTime& Tr,
+                      std::vector<SatID>& Satellites,
+                      const std::vector<double>& Pseudorange,
+                      const Matrix<double>& invMC,
+                      const XvtStore<SatID> *pEph,
+                      TropModel *pTropModel);
+
+      /// Compute a RAIM solution as PRSolution::RAIMCompute() does given the
+      /// output of PRSolution::PreparePRSolution(), storing the results in prs;
+      /// the solution agrees with RAIMCompute() to rounding.
+      /// @return same as PRSolution::RAIMCompute().
+      int RAIMCompute(PRSolution& prs,
+                      const CommonTime& Tr,
+                      std::vector<SatID>& Satellites,
+                      const Matrix<double>& SVP,
+                      const int& NSVS,
+                      const Matrix<double>& invMC,
+                      TropModel *pTropModel);
+
+      /// @return the maximum number of satellites
+      unsigned int getMaxSats(void) const throw() { return maxSats; }
+
+      /// @return the maximum number of systems
+      unsigned int getMaxGNSS(void) const throw() { return maxGNSS; }
+
+      /// @return the number of threads, including the calling thread
+      unsigned int getNThreads(void) const throw() { return nThreads; }
+
+   private:
+
+      /// Storage for one least squares solution of a subset of the satellites.
+      /// D = 3+maxGNSS is the largest dimension, M = maxSats.
+      struct Workspace
+      {
+         /// allocate for M satellites and dimension D
+         void init(const unsigned int M, const unsigned int D);
+
+         std::vector<char> use;     ///< (M) false if n-th good sat is rejected
+         std::vector<int> combo;    ///< (M) combination, for pool threads
+         std::vector<int> sys;      ///< (D-3) allowedGNSS index of each clock
+         std::vector<int> col;      ///< (D-3) column of each allowedGNSS clock
+         std::vector<int> idx;      ///< (M) Sats index of n-th used satellite
+         std::vector<double> P;     ///< (M*D) partials, row n for n-th used sat
+         std::vector<double> R;     ///< (M) data residuals
+         std::vector<double> PtW;   ///< (D*M) transpose(P)*W for full weighting
+         std::vector<double> L;     ///< (D*D) Cholesky factor of transpose(P)*W*P
+         std::vector<double> b;     ///< (D) transpose(P)*W*R
+         std::vector<double> X;     ///< (D) solution
+         std::vector<double> dX;    ///< (D) solution update
+         std::vector<double> Cov;   ///< (D*D) normal matrix, then covariance
+         std::vector<double> g;     ///< (D) scratch
+
+         int iret;                  ///< return value as SimplePRSolution()
+         int nsvs;                  ///< number of satellites used
+         int dim;                   ///< dimension of the solution
+         int nsys;                  ///< number of clocks
+         int niter;                 ///< number of iterations
+         bool tropFlag;             ///< true if trop was not applied
+         bool isSVD;                ///< Cov was computed by SVD
+         double conv;               ///< final convergence
+         double rms;                ///< RMS residual
+         double maxSlope;           ///< largest slope
+      };
+
+      /// Set up, for one call, the quantities that do not depend on the subset:
+      /// good satellites, their systems, weights, and the first iteration.
+      void prepareEpoch(const std::vector<SatID>& Sats);
+
+      /// First combination of k, in the order of class Combinations.
+      static void firstCombo(int *c, const int& k);
+
+      /// Next combination of k in N, in the order of class Combinations.
+      /// @return false if there are no more.
+      static bool nextCombo(int *c, const int& N, const int& k);
+
+      /// Set ws.use for the combination c of k rejected satellites.
+      void markCombo(Workspace& ws, const int *c, const int& k);
+
+      /// Set the systems, clock columns, dimension and count of ws.use.
+      /// @return false if there are no systems
+      bool setSystems(Workspace& ws);
+
+      /// Set row n of partials and data residuals to the first iteration of
+      /// satellite i.
+      void setFirstRow(Workspace& ws, const int& n, const int& i);
+
+      /// Form the normal matrix in ws.Cov and right hand side in ws.b.
+      void buildNormal(Workspace& ws);
+
+      /// Solve the least squares problem for the satellites in ws.use,
+      /// storing the results in ws.
+      void solve(Workspace& ws);
+
+      /// Cholesky decomposition, in place, of the dim x dim matrix L.
+      /// @return false if the matrix is near singular
+      static bool cholesky(double *L, const int& dim);
+
+      /// Rank-one downdate of the Cholesky factor L by x (destroyed).
+      /// @return false if the result would be inaccurate
+      static bool downdate(double *L, const int& dim, double *x);
+
+      /// Solve (L*transpose(L)) x = b in place of b.
+      static void cholSolve(const double *L, const int& dim, double *b);
+
+      /// Compute the stage (k rejected of N) in all the threads, storing
+      /// the return value and RMS of each combination in stageIret,stageRMS
+      void parallelStage(const int& N, const int& k, const unsigned long& total);
+
+      /// Compute every nThreads-th combination of the stage, starting at t.
+      void stagePart(const unsigned int& t);
+
+      /// Copy the solution in ws into prs, as RAIMCompute() does.
+      void copyOut(PRSolution& prs, Workspace& ws, std::vector<SatID>& Sats);
+
+      // sizes
+      unsigned int maxSats, maxGNSS, maxDim, nThreads, maxCombos;
+
+      // per-call inputs, set by RAIMCompute()
+      const PRSolution *pPRS;
+      const CommonTime *pTime;
+      const Matrix<double> *pSVP;
+      const Matrix<double> *pInvMC;
+      TropModel *pTrop;
+
+      // per-call quantities shared by all subsets
+      int nSats;                    ///< number of satellites (Sats.size())
+      int nGood;                    ///< number of good satellites
+      bool weighted;                ///< invMC is given
+      bool diagonal;                ///< invMC is diagonal over the good satellites
+      bool haveFirst;               ///< first iteration of the full set is ready
+      int firstNsys;                ///< number of clocks in the full set
+      std::vector<int> good;        ///< (M) Sats index of each good satellite
+      std::vector<int> sysIndex;    ///< (M) allowedGNSS index of each sat or -1
+      std::vector<double> wt;       ///< (M) diagonal weight of each satellite
+      std::vector<double> AP;       ///< (D) apriori solution, by allowedGNSS
+      std::vector<double> firstP;   ///< (M*4) first iteration dircos and 1
+      std::vector<double> firstR;   ///< (M) first iteration data residual
+      std::vector<double> firstL;   ///< (D*D) factor of the full first iteration
+      std::vector<double> firstB;   ///< (D) rhs of the full first iteration
+      std::vector<int> firstSys;    ///< (maxGNSS) clocks of the full set
+      std::vector<int> combo;       ///< (M) combination, for the calling thread
+      std::vector<SatID> saveSats;  ///< (M) input Sats
+
+      // work spaces: [0],[1] are the current and best solutions of the calling
+      // thread, [1+t] the current solution of pool thread t > 0
+      std::vector<Workspace> work;
+      Workspace *pCur;              ///< current solution of the calling thread
+
+      // results of each combination in a parallel stage
+      std::vector<int> stageIret;
+      std::vector<double> stageRMS;
+
+      // thread pool; the calling thread is thread 0
+      WorkerPool pool;
+      std::mutex tropMutex;
+      int stageN, stageK;           ///< the current parallel stage
+      unsigned long stageTotal;     ///< number of combinations in the stage
+
+      // no copies
+      RAIMSolver(const RAIMSolver&);
+      RAIMSolver& operator=(const RAIMSolver&);
+
+   }; // end class RAIMSolver
+
+   //@}
+
+}  // namespace gpstk
+
+#endif
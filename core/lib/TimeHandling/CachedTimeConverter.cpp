@@ -0,0 +1,123 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CachedTimeConverter.cpp
+ * Incremental conversion of CommonTime to the calendar TimeTags
+ */
+
+#include "CachedTimeConverter.hpp"
+#include "TimeConverters.hpp"
+#include "TimeConstants.hpp"
+
+namespace gpstk
+{
+   void CachedTimeConverter ::
+   setCalendarDay(long jday)
+   {
+      if(jday != calDay)
+      {
+         convertJDtoCalendar(jday, year, month, dom);
+         doy = jday - convertCalendarToJD(year, 1, 1) + 1;
+         calDay = jday;
+      }
+   }
+
+
+   void CachedTimeConverter ::
+   convert(const CommonTime& ct, CivilTime& civ)
+   {
+      long jday, sod;
+      double fsod;
+      TimeSystem ts;
+      ct.get(jday, sod, fsod, ts);
+      setCalendarDay(jday);
+      civ.setTimeSystem(ts);
+      civ.year = year;
+      civ.month = month;
+      civ.day = dom;
+         // convertSODtoTime() of a whole second of day
+      civ.hour = sod / 3600;
+      civ.minute = (sod % 3600) / 60;
+      civ.second = static_cast<double>(sod % 60) + fsod;
+   }
+
+
+   void CachedTimeConverter ::
+   convert(const CommonTime& ct, YDSTime& yds)
+   {
+      long jday, sod;
+      double fsod;
+      TimeSystem ts;
+      ct.get(jday, sod, fsod, ts);
+      setCalendarDay(jday);
+      yds.setTimeSystem(ts);
+      yds.year = year;
+      yds.doy = doy;
+      yds.sod = static_cast<double>(sod) + fsod;
+   }
+
+
+   void CachedTimeConverter ::
+   convert(const CommonTime& ct, WeekSecond& ws)
+   {
+      long jday, sod;
+      double fsod;
+      ct.get(jday, sod, fsod);
+      long epoch(ws.MJDEpoch());
+      if(jday != weekDay || epoch != weekEpoch)
+      {
+            // WeekSecond::convertFromCommonTime() compares the MJD,
+            // which is before the epoch exactly when its day is
+         long days(jday - MJD_JDAY - epoch);
+         if(days < 0)
+         {
+            InvalidRequest ir("Unable to convert to Week/Second - before Epoch.");
+            GPSTK_THROW(ir);
+         }
+         week = static_cast<int>(days / 7);
+         dow = days % 7;
+         weekDay = jday;
+         weekEpoch = epoch;
+      }
+      ws.setTimeSystem(ct.getTimeSystem());
+      ws.week = week;
+      ws.sow = static_cast<double>(dow * SEC_PER_DAY + sod) + fsod;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,109 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CachedTimeConverter.hpp
+ * Incremental conversion of CommonTime to the calendar TimeTags
+ */
+
+#ifndef GPSTK_CACHEDTIMECONVERTER_HPP
+#define GPSTK_CACHEDTIMECONVERTER_HPP
+
+#include "CommonTime.hpp"
+#include "CivilTime.hpp"
+#include "YDSTime.hpp"
+#include "WeekSecond.hpp"
+
+namespace gpstk
+{
+      /// @ingroup TimeHandling
+      //@{
+
+      /**
+       * Converts CommonTime to CivilTime, YDSTime and the WeekSecond
+       * classes with the same results as their convertFromCommonTime(),
+       * but remembers the day of the last conversion, so that the
+       * calendar arithmetic (convertJDtoCalendar() etc.) is only
+       * done when the day changes and a time in the same day only
+       * costs the split of its seconds of day.  This is meant for
+       * writers that convert a long run of increasing times, e.g. one
+       * per output line.
+       *
+       * An object is not safe to share between threads.
+       */
+   class CachedTimeConverter
+   {
+   public:
+         /// Start with nothing cached.
+      CachedTimeConverter()
+            : calDay(-1), year(0), month(0), dom(0), doy(0),
+              weekDay(-1), weekEpoch(0), week(0), dow(0)
+      {}
+
+         /// Set civ from ct, as civ.convertFromCommonTime(ct) would.
+      void convert(const CommonTime& ct, CivilTime& civ);
+
+         /// Set yds from ct, as yds.convertFromCommonTime(ct) would.
+      void convert(const CommonTime& ct, YDSTime& yds);
+
+         /** Set ws (a GPSWeekSecond, GALWeekSecond etc.) from ct, as
+          * ws.convertFromCommonTime(ct) would.
+          * @throw InvalidRequest if ct is before the epoch of ws */
+      void convert(const CommonTime& ct, WeekSecond& ws);
+
+   private:
+         /// Update the calendar date for day jday.
+      void setCalendarDay(long jday);
+
+      long calDay;        ///< day of the cached calendar date
+      int year;           ///< year of calDay
+      int month;          ///< month of calDay
+      int dom;            ///< day of month of calDay
+      int doy;            ///< day of year of calDay
+
+      long weekDay;       ///< day of the cached week
+      long weekEpoch;     ///< MJD epoch of the week system of weekDay
+      int week;           ///< full week of weekDay
+      long dow;           ///< day of week of weekDay
+   };
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_CACHEDTIMECONVERTER_HPP
@@ -0,0 +1,106 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CommonTimeKey.cpp
+ * Fixed-point time stamp for use as a container key
+ */
+
+#include <cmath>
+#include "CommonTimeKey.hpp"
+#include "StringUtils.hpp"
+
+namespace gpstk
+{
+   CommonTimeKey ::
+   CommonTimeKey(const CommonTime& t)
+   {
+      long day, msod;
+      double fsod;
+      t.getInternal(day, msod, fsod, m_timeSystem);
+      m_ms = static_cast<int64_t>(day) * MS_PER_DAY + msod;
+      m_ticks = static_cast<int32_t>(std::floor(fsod * 1e12 + 0.5));
+      if(m_ticks >= TICKS_PER_MS)
+      {
+            // rounded up to the next millisecond, unless there is none
+         if(day < CommonTime::END_LIMIT_JDAY || msod < MS_PER_DAY - 1)
+         {
+            m_ms++;
+            m_ticks = 0;
+         }
+         else
+         {
+            m_ticks = TICKS_PER_MS - 1;
+         }
+      }
+   }
+
+
+   CommonTime CommonTimeKey ::
+   asCommonTime() const
+   {
+      CommonTime t;
+      t.setInternal(static_cast<long>(m_ms / MS_PER_DAY),
+                    static_cast<long>(m_ms % MS_PER_DAY),
+                    m_ticks * 1e-12, m_timeSystem);
+      return t;
+   }
+
+
+   void CommonTimeKey ::
+   checkTimeSystem(const CommonTimeKey& right) const
+   {
+      if(m_timeSystem != TimeSystem::Any &&
+         right.m_timeSystem != TimeSystem::Any)
+      {
+         InvalidRequest ir(
+            "CommonTimeKey objects not in same time system, cannot be"
+            " compared: " + StringUtils::asString(m_timeSystem) + " != " +
+            StringUtils::asString(right.m_timeSystem));
+         GPSTK_THROW(ir);
+      }
+   }
+
+
+   std::ostream& operator<<(std::ostream& o, const CommonTimeKey& key)
+   {
+      o << key.asCommonTime();
+      return o;
+   }
+
+} // namespace gpstk
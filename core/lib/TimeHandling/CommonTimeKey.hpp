@@ -0,0 +1,173 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file CommonTimeKey.hpp
+ * Fixed-point time stamp for use as a container key
+ */
+
+#ifndef GPSTK_COMMONTIMEKEY_HPP
+#define GPSTK_COMMONTIMEKEY_HPP
+
+#include <stdint.h>
+#include <iostream>
+#include "CommonTime.hpp"
+
+namespace gpstk
+{
+      /// @ingroup TimeHandling
+      //@{
+
+      /**
+       * A CommonTime held as an integer count of picoseconds, in two
+       * parts (milliseconds since CommonTime day 0 and picoseconds of
+       * the millisecond), plus the time system.  It covers the whole
+       * range of CommonTime in 16 bytes, and comparison and
+       * difference are a few integer operations rather than
+       * CommonTime's field-by-field normalization, which makes it the
+       * cheaper key for time-ordered maps and searches.  It is
+       * meant for containers private to a class; public container
+       * typedefs, such as OrbitEphStore::TimeOrbitEphTable and
+       * TabularSatStore::DataTable, keep their CommonTime keys.  It
+       * is used by IonoModelStore and by the binary search of
+       * FlatDataTable.
+       *
+       * CommonTime converts to CommonTimeKey implicitly, and back, so
+       * a map keyed on CommonTimeKey accepts CommonTime arguments to
+       * find(), lower_bound() etc. and its keys can be used where a
+       * CommonTime is expected.
+       *
+       * The fractional seconds of the CommonTime are rounded to the
+       * nearest picosecond, so CommonTimes that differ by less than
+       * that may have equal keys, and a CommonTime does not always
+       * survive the trip through a key exactly.  Time systems are
+       * treated as by CommonTime: comparing keys of different time
+       * systems, neither of which is TimeSystem::Any, throws from
+       * operator<() and operator-() and is false for operator==().
+       */
+   class CommonTimeKey
+   {
+   public:
+         /// Number of ticks (picoseconds) in a millisecond.
+      static const int32_t TICKS_PER_MS = 1000000000;
+
+         /// Initialize to CommonTime day 0, unknown time system.
+      CommonTimeKey()
+            : m_ms(0), m_ticks(0), m_timeSystem(TimeSystem::Unknown)
+      {}
+
+         /// Convert a CommonTime (implicitly).
+      CommonTimeKey(const CommonTime& t);
+
+         /// Convert back to a CommonTime.
+      CommonTime asCommonTime() const;
+
+         /// Convert back to a CommonTime (implicitly).
+      operator CommonTime() const
+      { return asCommonTime(); }
+
+         /// Milliseconds since CommonTime day 0.
+      int64_t getMilliseconds() const
+      { return m_ms; }
+
+         /// Picoseconds of the millisecond, 0 <= val < TICKS_PER_MS.
+      int32_t getTicks() const
+      { return m_ticks; }
+
+      TimeSystem getTimeSystem() const
+      { return m_timeSystem; }
+
+         /** Difference two keys.
+          * @return the difference in seconds
+          * @throw InvalidRequest if the time systems differ */
+      double operator-(const CommonTimeKey& right) const
+      {
+         if(m_timeSystem != right.m_timeSystem)
+            checkTimeSystem(right);
+         return (m_ms - right.m_ms) * 1e-3 + (m_ticks - right.m_ticks) * 1e-12;
+      }
+
+         /// @throw InvalidRequest if the time systems differ
+      bool operator<(const CommonTimeKey& right) const
+      {
+         if(m_timeSystem != right.m_timeSystem)
+            checkTimeSystem(right);
+         return (m_ms < right.m_ms)
+            | ((m_ms == right.m_ms) & (m_ticks < right.m_ticks));
+      }
+
+         /// @throw InvalidRequest if the time systems differ
+      bool operator>(const CommonTimeKey& right) const
+      { return right < *this; }
+
+         /// @throw InvalidRequest if the time systems differ
+      bool operator<=(const CommonTimeKey& right) const
+      { return !(right < *this); }
+
+         /// @throw InvalidRequest if the time systems differ
+      bool operator>=(const CommonTimeKey& right) const
+      { return !(*this < right); }
+
+      bool operator==(const CommonTimeKey& right) const
+      {
+         return (m_ms == right.m_ms) & (m_ticks == right.m_ticks)
+            & ((m_timeSystem == right.m_timeSystem)
+               | (m_timeSystem == TimeSystem::Any)
+               | (right.m_timeSystem == TimeSystem::Any));
+      }
+
+      bool operator!=(const CommonTimeKey& right) const
+      { return !operator==(right); }
+
+   private:
+         /** Throw InvalidRequest unless one of the time systems is
+          * TimeSystem::Any. */
+      void checkTimeSystem(const CommonTimeKey& right) const;
+
+      int64_t m_ms;              ///< milliseconds since CommonTime day 0
+      int32_t m_ticks;           ///< picoseconds of the millisecond
+      TimeSystem m_timeSystem;   ///< time system of the time
+   };
+
+   std::ostream& operator<<(std::ostream& o, const CommonTimeKey& key);
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_COMMONTIMEKEY_HPP
@@ -40,6 +40,12 @@
 
 #include "TimeString.hpp"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <functional>
+
 #include "ANSITime.hpp"
 #include "CivilTime.hpp"
 #include "GPSWeekSecond.hpp"
@@ -56,49 +62,515 @@
 
 #include "TimeConverters.hpp"
 #include "TimeConstants.hpp"
+#include "ThreadSlotCache.hpp"
 
 using namespace std;
 
 namespace gpstk
 {
+   namespace
+   {
+         /// Formats compiled for printTime() and scanTime(), per thread.
+      typedef ThreadSlotCache<TimeFormat, 16> FormatCache;
+
+         /** Return fmt compiled, from the calling thread's cache.  The
+          * result is only valid until the thread's next call, which
+          * may compile another format in its place. */
+      const TimeFormat& cachedFormat( const string& fmt )
+      {
+         static const FormatCache cache;
+         FormatCache::Slot& s( cache.slot( std::hash<string>()( fmt ) ) );
+         if( !cache.holds( s ) || s.value.getFormat() != fmt )
+         {
+            FormatCache::release( s );
+            s.value.setFormat( fmt );
+            cache.fill( s );
+         }
+         return s.value;
+      }
+   }
+
    string printTime( const CommonTime& t,
                           const string& fmt )
    {
-      try
+      return cachedFormat( fmt ).print( t );
+   }
+   
+   namespace
+   {
+         /// The TimeTag classes used by TimeFormat, in the order
+         /// printTime() applies them.
+      enum FormatTag
+      {
+         ftANSI, ftCivil, ftGPSWS, ftGPSZ, ftJD, ftMJD, ftUnix, ftPosix,
+         ftYDS, ftGAL, ftBDS, ftQZS, ftIRN, ftCount
+      };
+
+         /** Return the sprintf() conversion printTime() uses for print
+          * identifier id, or NULL if id is not a print identifier.
+          * isFloat is set to whether id takes a precision. */
+      const char* formatConversion( char id, bool& isFloat )
       {
-         string rv( fmt );
-         try {rv = ANSITime(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = CivilTime(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = GPSWeekSecond(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = GPSWeekZcount(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = JulianDate(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = MJD(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = UnixTime(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = PosixTime(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = YDSTime(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = GALWeekSecond(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = BDSWeekSecond(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = QZSWeekSecond(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         try {rv = IRNWeekSecond(t).printf( rv );} catch (gpstk::InvalidRequest e){};
-         return rv;
+         isFloat = false;
+         switch( id )
+         {
+            case 'Y': case 'y':
+               return "d";
+            case 'm': case 'd': case 'H': case 'M': case 'S':
+            case 'E': case 'F': case 'G': case 'w':
+            case 'z': case 'Z': case 'c': case 'C': case 'j':
+            case 'T': case 'L': case 'l': case 'R': case 'D': case 'e':
+            case 'V': case 'h': case 'i': case 'X': case 'O': case 'o':
+               return "u";
+            case 'K': case 'U': case 'u': case 'W': case 'N':
+               return "lu";
+            case 'b': case 'B': case 'P':
+               return "s";
+            case 'f': case 'g': case 's':
+               isFloat = true;
+               return "f";
+            case 'J': case 'Q':
+               isFloat = true;
+               return "Lf";
+         }
+         return NULL;
       }
-      catch( gpstk::StringUtils::StringException& se )
+
+         /// Return the FormatTag bits of the classes that print id.
+      unsigned formatTags( char id )
       {
-         GPSTK_RETHROW( se );
+         switch( id )
+         {
+            case 'K':
+               return 1 << ftANSI;
+            case 'Y': case 'y':
+               return (1 << ftCivil) | (1 << ftYDS);
+            case 'm': case 'b': case 'B': case 'd': case 'H': case 'M':
+            case 'S': case 'f':
+               return 1 << ftCivil;
+            case 'E': case 'F': case 'G':
+               return (1 << ftGPSWS) | (1 << ftGPSZ);
+            case 'w':
+               return ((1 << ftGPSWS) | (1 << ftGPSZ) | (1 << ftGAL) |
+                       (1 << ftBDS) | (1 << ftQZS) | (1 << ftIRN));
+            case 'g':
+               return ((1 << ftGPSWS) | (1 << ftGAL) | (1 << ftBDS) |
+                       (1 << ftQZS) | (1 << ftIRN));
+            case 'z': case 'Z': case 'c': case 'C':
+               return 1 << ftGPSZ;
+            case 'J':
+               return 1 << ftJD;
+            case 'Q':
+               return 1 << ftMJD;
+            case 'U': case 'u':
+               return 1 << ftUnix;
+            case 'W': case 'N':
+               return 1 << ftPosix;
+            case 'j': case 's':
+               return 1 << ftYDS;
+            case 'T': case 'L': case 'l':
+               return 1 << ftGAL;
+            case 'R': case 'D': case 'e':
+               return 1 << ftBDS;
+            case 'V': case 'h': case 'i':
+               return 1 << ftQZS;
+            case 'X': case 'O': case 'o':
+               return 1 << ftIRN;
+            case 'P':
+               return (1 << ftCount) - 1;
+         }
+         return 0;
       }
+
+         /// The TimeTag objects for one time, each converted when it
+         /// is first needed.
+      class FormatTags
+      {
+      public:
+         FormatTags( const CommonTime& t, CachedTimeConverter& c )
+               : ct(t), conv(c)
+         {
+            for(int i=0; i<ftCount; i++)
+               status[i] = 0;
+         }
+
+            /// Convert to tag if not done yet, return false if the
+            /// conversion failed.
+         bool have( int tag )
+         {
+            if(status[tag] == 0)
+            {
+               status[tag] = 1;
+               try
+               {
+                  switch( tag )
+                  {
+                     case ftANSI:  ansi.convertFromCommonTime(ct);  break;
+                     case ftCivil: conv.convert(ct, civ);           break;
+                     case ftGPSWS: conv.convert(ct, gps);           break;
+                     case ftGPSZ:  gpsz.convertFromCommonTime(ct);  break;
+                     case ftJD:    jd.convertFromCommonTime(ct);    break;
+                     case ftMJD:   mjd.convertFromCommonTime(ct);   break;
+                     case ftUnix:  unixt.convertFromCommonTime(ct); break;
+                     case ftPosix: posix.convertFromCommonTime(ct); break;
+                     case ftYDS:   conv.convert(ct, yds);           break;
+                     case ftGAL:   conv.convert(ct, gal);           break;
+                     case ftBDS:   conv.convert(ct, bds);           break;
+                     case ftQZS:   conv.convert(ct, qzs);           break;
+                     case ftIRN:   conv.convert(ct, irn);           break;
+                  }
+               }
+               catch( InvalidRequest& )
+               {
+                  status[tag] = -1;
+               }
+            }
+            return status[tag] > 0;
+         }
+
+            /// The WeekSecond object of a week tag other than ftGPSZ.
+         const WeekSecond& weekSecond( int tag ) const
+         {
+            switch( tag )
+            {
+               case ftGAL:  return gal;
+               case ftBDS:  return bds;
+               case ftQZS:  return qzs;
+               case ftIRN:  return irn;
+            }
+            return gps;
+         }
+
+            /** Print identifier id as converted by tag into buf using
+             * the sprintf() format spec.  Return what snprintf()
+             * returns. */
+         int print( char *buf, size_t len, const char *spec, char id,
+                    int tag ) const
+         {
+            switch( id )
+            {
+               case 'K':
+                  return snprintf(buf, len, spec, ansi.time);
+               case 'P':
+                  return snprintf(buf, len, spec,
+                     StringUtils::asString(ct.getTimeSystem()).c_str());
+               case 'Y':
+                  return snprintf(buf, len, spec,
+                                  tag == ftCivil ? civ.year : yds.year);
+               case 'y':
+                  return snprintf(buf, len, spec, static_cast<short>(
+                     (tag == ftCivil ? civ.year : yds.year) % 100));
+               case 'm':
+                  return snprintf(buf, len, spec, civ.month);
+               case 'b':
+                  return snprintf(buf, len, spec,
+                                  CivilTime::MonthAbbrevNames[civ.month]);
+               case 'B':
+                  return snprintf(buf, len, spec,
+                                  CivilTime::MonthNames[civ.month]);
+               case 'd':
+                  return snprintf(buf, len, spec, civ.day);
+               case 'H':
+                  return snprintf(buf, len, spec, civ.hour);
+               case 'M':
+                  return snprintf(buf, len, spec, civ.minute);
+               case 'S':
+                  return snprintf(buf, len, spec,
+                                  static_cast<short>(civ.second));
+               case 'f':
+                  return snprintf(buf, len, spec, civ.second);
+               case 'E': case 'F': case 'G': case 'w':
+                  if( tag == ftGPSZ )
+                  {
+                     switch( id )
+                     {
+                        case 'E':
+                           return snprintf(buf, len, spec, gpsz.getEpoch());
+                        case 'F':
+                           return snprintf(buf, len, spec, gpsz.week);
+                        case 'G':
+                           return snprintf(buf, len, spec, gpsz.getWeek10());
+                     }
+                     return snprintf(buf, len, spec, gpsz.getDayOfWeek());
+                  }
+                  switch( id )
+                  {
+                     case 'E':
+                        return snprintf(buf, len, spec,
+                                        weekSecond(tag).getEpoch());
+                     case 'F':
+                        return snprintf(buf, len, spec, weekSecond(tag).week);
+                     case 'G':
+                        return snprintf(buf, len, spec,
+                                        weekSecond(tag).getModWeek());
+                  }
+                  return snprintf(buf, len, spec,
+                                  weekSecond(tag).getDayOfWeek());
+               case 'T': case 'R': case 'V': case 'X':
+                  return snprintf(buf, len, spec, weekSecond(tag).getEpoch());
+               case 'L': case 'D': case 'h': case 'O':
+                  return snprintf(buf, len, spec, weekSecond(tag).week);
+               case 'l': case 'e': case 'i': case 'o':
+                  return snprintf(buf, len, spec,
+                                  weekSecond(tag).getModWeek());
+               case 'g':
+                  return snprintf(buf, len, spec, weekSecond(tag).sow);
+               case 'z': case 'Z':
+                  return snprintf(buf, len, spec, gpsz.zcount);
+               case 'c':
+                  return snprintf(buf, len, spec, gpsz.getZcount29());
+               case 'C':
+                  return snprintf(buf, len, spec, gpsz.getZcount32());
+               case 'J':
+                  return snprintf(buf, len, spec, jd.jd);
+               case 'Q':
+                  return snprintf(buf, len, spec, mjd.mjd);
+               case 'U':
+                  return snprintf(buf, len, spec, unixt.tv.tv_sec);
+               case 'u':
+                  return snprintf(buf, len, spec, unixt.tv.tv_usec);
+               case 'W':
+                  return snprintf(buf, len, spec, posix.ts.tv_sec);
+               case 'N':
+                  return snprintf(buf, len, spec, posix.ts.tv_nsec);
+               case 'j':
+                  return snprintf(buf, len, spec, yds.doy);
+               case 's':
+                  return snprintf(buf, len, spec, yds.sod);
+            }
+            return -1;
+         }
+
+         ANSITime ansi;
+         CivilTime civ;
+         GPSWeekSecond gps;
+         GPSWeekZcount gpsz;
+         JulianDate jd;
+         MJD mjd;
+         UnixTime unixt;
+         PosixTime posix;
+         YDSTime yds;
+         GALWeekSecond gal;
+         BDSWeekSecond bds;
+         QZSWeekSecond qzs;
+         IRNWeekSecond irn;
+
+      private:
+         const CommonTime& ct;
+         CachedTimeConverter& conv;
+            /// 0 if not converted yet, 1 if converted, -1 if failed
+         signed char status[ftCount];
+      };
    }
-   
-      /// Fill the TimeTag object \a btime with time information found in
-      /// string \a str formatted according to string \a fmt.
-   void scanTime( TimeTag& btime,
-                  const string& str,
-                  const string& fmt )
+
+
+   TimeFormat ::
+   TimeFormat( const string& fmt )
+   {
+      setFormat( fmt );
+   }
+
+
+   void TimeFormat ::
+   setFormat( const string& fmt )
+   {
+      format = fmt;
+      items.clear();
+      Item lit;
+      lit.id = 0;
+      string::size_type i = 0, n = fmt.size();
+      while( i < n )
+      {
+         if( fmt[i] != '%' )
+         {
+            lit.text += fmt[i++];
+            continue;
+         }
+            // same grammar as getFormatPrefixInt()/getFormatPrefixFloat()
+         string::size_type j = i + 1;
+         if( j < n && (fmt[j] == ' ' || fmt[j] == '0' || fmt[j] == '-') )
+            j++;
+         while( j < n && isdigit(fmt[j]) )
+            j++;
+         bool precision = false;
+         if( j + 1 < n && fmt[j] == '.' && isdigit(fmt[j+1]) )
+         {
+            precision = true;
+            for( j += 2; j < n && isdigit(fmt[j]); j++ )
+               ;
+         }
+         bool isFloat;
+         const char *conv = (j < n ? formatConversion(fmt[j], isFloat) : NULL);
+         if( conv == NULL || (precision && !isFloat) )
+         {
+               // not a print identifier, printTime() leaves it alone
+            lit.text += fmt[i++];
+            continue;
+         }
+         if( !lit.text.empty() )
+         {
+            items.push_back( lit );
+            lit.text.clear();
+         }
+         Item item;
+         item.id = fmt[j];
+         item.text = fmt.substr( i, j + 1 - i );
+         item.spec = fmt.substr( i, j - i ) + conv;
+         items.push_back( item );
+         i = j + 1;
+      }
+      if( !lit.text.empty() )
+         items.push_back( lit );
+
+         // Walk the format as TimeTag::getInfo() does.  What it does
+         // with the format never depends on the string being
+         // scanned, except for where a delimited field ends.
+      fields.clear();
+      i = 0;
+      while( true )
+      {
+         Field field;
+         field.skip = 0;
+         field.id = 0;
+         field.width = string::npos;
+         field.delimiter = 0;
+         while( i < n && fmt[i] != '%' )
+         {
+            field.skip++;
+            i++;
+         }
+         if( i == n )
+         {
+            fields.push_back( field );
+            break;
+         }
+         i++;
+         bool sized = ( i == n || !isalpha( fmt[i] ) );
+         if( sized )
+         {
+               // getInfo() uses asInt() of the rest of the format
+            field.width = static_cast<string::size_type>(
+               strtol( fmt.c_str() + i, NULL, 10 ) );
+            while( i < n && !isalpha( fmt[i] ) )
+               i++;
+            if( i == n )
+            {
+                  // getInfo() stops at the '%', with str not empty
+               field.skip++;
+               fields.push_back( field );
+               break;
+            }
+         }
+         field.id = fmt[i++];
+         if( !sized && i < n )
+         {
+            if( fmt[i] != '%' )
+               field.delimiter = fmt[i++];
+            else
+               field.width = 1;
+         }
+         fields.push_back( field );
+      }
+   }
+
+
+   string TimeFormat ::
+   print( const CommonTime& t ) const
+   {
+      char buffer[128];
+      size_t len = print( t, buffer, sizeof(buffer) );
+      if( len < sizeof(buffer) )
+         return string( buffer, len );
+      string rv( len + 1, '\0' );
+      print( t, &rv[0], rv.size() );
+      rv.resize( len );
+      return rv;
+   }
+
+
+   size_t TimeFormat ::
+   print( const CommonTime& t, char *buf, size_t len ) const
+   {
+      FormatTags tags( t, converter );
+      size_t total = 0;
+      for( size_t k = 0; k < items.size(); k++ )
+      {
+         const Item& item( items[k] );
+         char *dst = ( total < len ? buf + total : NULL );
+         size_t room = ( total < len ? len - total : 0 );
+         int n = -1;
+         if( item.id )
+         {
+               // the first class (in printTime() order) that converts
+            unsigned mask = formatTags( item.id );
+            for( int tag = 0; tag < ftCount; tag++ )
+            {
+               if( (mask & (1 << tag)) && tags.have(tag) )
+               {
+                  n = tags.print( dst, room, item.spec.c_str(), item.id, tag );
+                  break;
+               }
+            }
+         }
+         if( n < 0 )
+         {
+            n = item.text.size();
+            if( room > 0 )
+               item.text.copy( dst, std::min<size_t>( n, room - 1 ) );
+         }
+         total += n;
+      }
+      if( len > 0 )
+         buf[std::min( total, len - 1 )] = '\0';
+      return total;
+   }
+
+
+   void TimeFormat ::
+   getInfo( const string& str, TimeTag::IdToValue& info ) const
+   {
+      string::size_type pos = 0, len = str.size();
+      for( size_t k = 0; k < fields.size(); k++ )
+      {
+         const Field& field( fields[k] );
+         if( field.id == 0 )
+         {
+            if( len - pos < field.skip )
+               break;
+            return;
+         }
+            // each field needs something in str after the literal text
+         if( len - pos <= field.skip )
+            break;
+         pos += field.skip;
+         string::size_type width = field.width;
+         if( field.delimiter )
+         {
+            while( pos < len && str[pos] == ' ' )
+               pos++;
+            width = str.find( field.delimiter, pos );
+            if( width != string::npos )
+               width -= pos;
+         }
+         width = std::min( width, len - pos );
+         info[field.id].assign( str, pos, width );
+         pos += width;
+         if( field.delimiter && pos < len )
+            pos++;
+      }
+      gpstk::StringUtils::StringException
+         exc("Failed to process time string");
+      GPSTK_THROW(exc);
+   }
+
+
+   void TimeFormat ::
+   scan( TimeTag& btime, const string& str ) const
    {
       try
       {
-            // Get the mapping of character (from fmt) to value (from str).
          TimeTag::IdToValue info;
-         TimeTag::getInfo( str, fmt, info );
+         getInfo( str, info );
          
          if( btime.setFromInfo( info ) )
          {
@@ -107,7 +579,7 @@ namespace gpstk
          
             // Convert to CommonTime, and try to set using all formats.
          CommonTime ct( btime.convertToCommonTime() );
-         scanTime( ct, str, fmt );
+         scanInfo( ct, info );
 
             // Convert the CommonTime into the requested format.
          btime.convertFromCommonTime( ct );
@@ -121,19 +593,44 @@ namespace gpstk
          GPSTK_RETHROW( se );
       }
    }
+
+
+   void TimeFormat ::
+   scan( CommonTime& t, const string& str ) const
+   {
+      try
+      {
+         TimeTag::IdToValue info;
+         getInfo( str, info );
+         scanInfo( t, info );
+      }
+      catch( gpstk::StringUtils::StringException& se )
+      {
+         GPSTK_RETHROW( se );
+      }
+   }
+
+   void scanTime( TimeTag& btime,
+                  const string& str,
+                  const string& fmt )
+   {
+      cachedFormat( fmt ).scan( btime, str );
+   }
    
    void scanTime( CommonTime& t,
                   const string& str,
                   const string& fmt )
+   {
+      cachedFormat( fmt ).scan( t, str );
+   }
+
+   void TimeFormat ::
+   scanInfo( CommonTime& t, TimeTag::IdToValue& info )
    {
       try
       {
          using namespace gpstk::StringUtils;
 
-            // Get the mapping of character (from fmt) to value (from str).
-         TimeTag::IdToValue info;
-         TimeTag::getInfo( str, fmt, info );
-         
             // These indicate which information has been found.
          bool hmjd( false ), hsow( false ), hweek( false ), hfullweek( false ),
             hdow( false ), hyear( false ), hmonth( false ), hday( false ),
@@ -439,7 +936,7 @@ namespace gpstk
 
             // Get the mapping of character (from fmt) to value (from str).
          TimeTag::IdToValue info;
-         TimeTag::getInfo( str, fmt, info );
+         cachedFormat( fmt ).getInfo( str, info );
          
             // These indicate which information has been found.
          bool hsow( false ), hweek( false ), hfullweek( false ),
@@ -41,8 +41,10 @@
 #ifndef GPSTK_TIMESTRING_HPP
 #define GPSTK_TIMESTRING_HPP
 
+#include <vector>
 #include "TimeTag.hpp"
 #include "CommonTime.hpp"
+#include "CachedTimeConverter.hpp"
 
 namespace gpstk
 {
@@ -125,6 +127,111 @@ namespace gpstk
    std::string printTime( const CommonTime& t,
                           const std::string& fmt );
 
+      /**
+       * A printTime() and scanTime() format that has been parsed
+       * once, for printing or scanning many times with the same
+       * format, e.g. one per line of a file.  printTime() and
+       * scanTime() are implemented with a TimeFormat; each thread
+       * keeps the formats it has used recently, so calling them
+       * repeatedly with the same format parses it only once.
+       *
+       * For printing, the format is split into literal text and
+       * print identifiers (see printTime()), and print() converts
+       * the time only to the TimeTag classes that the identifiers
+       * need, with the calendar and week conversions going through a
+       * CachedTimeConverter.  Identifiers whose conversion fails are
+       * left in the output.
+       *
+       * For scanning, the format is split into fields of fixed width
+       * or ending at a delimiter, with the same rules as
+       * TimeTag::getInfo(), so scan() finds each value by position
+       * instead of editing copies of the strings.
+       *
+       * A TimeFormat keeps the converter cache between calls to
+       * print(), so one object is not safe to share between threads.
+       */
+   class TimeFormat
+   {
+   public:
+         /// Compile the printTime() format fmt.
+      TimeFormat( const std::string& fmt = std::string() );
+
+         /// Replace the format with fmt.
+      void setFormat( const std::string& fmt );
+
+         /// Return the format this object was compiled from.
+      const std::string& getFormat() const
+      { return format; }
+
+         /// Return t printed with this format.
+      std::string print( const CommonTime& t ) const;
+
+         /** Print t with this format into buf without allocating
+          * memory.  As with snprintf(), at most len characters are
+          * written including the terminating null.
+          * @param[in] t the time to print.
+          * @param[out] buf the buffer to print into.
+          * @param[in] len the size of buf.
+          * @return the length of the whole output, not counting the
+          *   null, so a return value of len or more means the
+          *   output was truncated. */
+      size_t print( const CommonTime& t, char *buf, size_t len ) const;
+
+         /** Fill btime with the time in str written with this format.
+          * @throw InvalidRequest if str does not have enough
+          *   information to set btime.
+          * @throw StringUtils::StringException if str is too short
+          *   for the format. */
+      void scan( TimeTag& btime, const std::string& str ) const;
+
+         /** Set t to the time in str written with this format.
+          * @throw InvalidRequest if str does not have enough
+          *   information to set t.
+          * @throw StringUtils::StringException if str is too short
+          *   for the format. */
+      void scan( CommonTime& t, const std::string& str ) const;
+
+         /** Add the value of each identifier in str to info, as
+          * TimeTag::getInfo(str, getFormat(), info) does.
+          * @throw StringUtils::StringException if str is too short
+          *   for the format. */
+      void getInfo( const std::string& str, TimeTag::IdToValue& info ) const;
+
+   private:
+         /// One piece of the compiled format.
+      struct Item
+      {
+            /// Print identifier, or 0 for literal text.
+         char id;
+            /// The literal text, or the identifier as it was written.
+         std::string text;
+            /// The sprintf() format used to print the identifier.
+         std::string spec;
+      };
+
+         /// One field of the format as scanned by getInfo().
+      struct Field
+      {
+            /// Literal characters in str before the field.
+         std::string::size_type skip;
+            /// Identifier, or 0 for the end of the format, where str
+            /// must have at least skip more characters.
+         char id;
+            /// Field width, npos for the rest of str.
+         std::string::size_type width;
+            /// Character that ends the field instead of width, or 0.
+         char delimiter;
+      };
+
+         /// Set t from the identifier values found by getInfo().
+      static void scanInfo( CommonTime& t, TimeTag::IdToValue& info );
+
+      std::string format;              ///< the format as given
+      std::vector<Item> items;         ///< the compiled format
+      std::vector<Field> fields;       ///< the compiled scan format
+      mutable CachedTimeConverter converter;
+   };
+
       /// This function converts the given CommonTime into the templatized
       /// TimeTag object, before calling the TimeTag's printf(fmt).  If
       /// there's an error in conversion, it instead calls printf(fmt, true)
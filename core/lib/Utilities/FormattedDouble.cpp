@@ -75,6 +75,15 @@ namespace gpstk
    FormattedDouble& FormattedDouble ::
    operator=(const std::string& s)
    {
+         // Most numbers convert exactly without a stream.  Only
+         // letters can be exponent characters there, as anything
+         // else could be taken for part of the mantissa.
+      const char expChars[] = { 'e', 'E', exponentChar, 0 };
+      if (isalpha(static_cast<unsigned char>(exponentChar)) &&
+          StringUtils::parseDouble(s.data(), s.size(), val, expChars))
+      {
+         return *this;
+      }
       if ((exponentChar != 'e') && (exponentChar != 'E'))
       {
             // If the exponent character is different from standard,
@@ -103,9 +112,23 @@ namespace gpstk
 
    std::ostream& operator<<(std::ostream& s, const FormattedDouble& d)
    {
-      s << StringUtils::floatFormat(d.val, d.leadChar, d.mantissaLen,
-                                    d.exponentLen, d.totalLen, d.exponentChar,
-                                    d.leadSign, d.alignment);
+         // Format on the stack, only making a string for the rare
+         // value that does not fit.
+      char buf[64];
+      if (StringUtils::floatFormat(buf, sizeof(buf), d.val, d.leadChar,
+                                   d.mantissaLen, d.exponentLen, d.totalLen,
+                                   d.exponentChar, d.leadSign, d.alignment)
+          < sizeof(buf))
+      {
+         s << buf;
+      }
+      else
+      {
+         s << StringUtils::floatFormat(d.val, d.leadChar, d.mantissaLen,
+                                       d.exponentLen, d.totalLen,
+                                       d.exponentChar, d.leadSign,
+                                       d.alignment);
+      }
       return s;
    }
 
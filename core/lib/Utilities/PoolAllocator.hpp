@@ -0,0 +1,310 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file PoolAllocator.hpp
+ * Fixed-size block pool and an STL allocator that draws from it, for
+ * node-based containers that are filled and emptied at high rates.
+ */
+
+#ifndef GPSTK_POOLALLOCATOR_HPP
+#define GPSTK_POOLALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+
+namespace gpstk
+{
+      /** Pool of fixed-size memory blocks.  There is one pool per
+       * block size, shared by all the PoolAllocator instantiations
+       * whose nodes round up to that size.
+       *
+       * Each thread keeps its own free list, so the common
+       * allocate/deallocate path takes no lock.  Blocks move to and
+       * from a global, mutex-protected free list in batches when a
+       * thread's list runs dry or grows past CACHE_MAX.  Memory is
+       * obtained from the heap CHUNK_BLOCKS blocks at a time and is
+       * never returned to the heap; the pool only grows to the
+       * largest number of blocks simultaneously in use.
+       *
+       * Blocks may be freed by a thread other than the one that
+       * allocated them.  When a thread exits, its free list is
+       * returned to the global list.
+       *
+       * @param BlockSize Size of each block in bytes.  Must be a
+       *   multiple of ALIGN. */
+   template <std::size_t BlockSize>
+   class FixedBlockPool
+   {
+   public:
+         /// All blocks are aligned to this many bytes.
+      static const std::size_t ALIGN = 16;
+         /// Number of blocks obtained from the heap at once.
+      static const std::size_t CHUNK_BLOCKS = 256;
+         /// Number of blocks moved from the global list at once.
+      static const std::size_t BATCH_BLOCKS = 64;
+         /// Per-thread free list size above which half is returned.
+      static const std::size_t CACHE_MAX = 4096;
+
+         /// Get a block of BlockSize bytes.
+      static void* allocate()
+      {
+         Cache& c(cache);
+         if (c.head == NULL)
+         {
+            if (!c.registered)
+               registerThread();
+            refill(c);
+         }
+         Block *b = c.head;
+         c.head = b->next;
+         c.count--;
+         return b;
+      }
+
+         /// Return a block obtained from allocate().
+      static void deallocate(void* p)
+      {
+         Block *b = static_cast<Block*>(p);
+         Cache& c(cache);
+         if (c.dead)
+         {
+               // thread-local storage is being torn down, e.g. a
+               // container with static storage duration
+            Global& g(global());
+            std::lock_guard<std::mutex> lock(g.mtx);
+            b->next = g.head;
+            g.head = b;
+            return;
+         }
+         if (!c.registered)
+            registerThread();
+         b->next = c.head;
+         c.head = b;
+         if (++c.count > CACHE_MAX)
+            spill(c, CACHE_MAX / 2);
+      }
+
+   private:
+      struct Block
+      {
+         Block *next;
+      };
+
+         /** Per-thread free list.  Trivially constructible and
+          * destructible so it remains usable while other
+          * thread-local objects are being destroyed. */
+      struct Cache
+      {
+         Block *head;
+         std::size_t count;
+         bool registered;
+         bool dead;
+      };
+
+         /// Returns the calling thread's free list at thread exit.
+      struct Flusher
+      {
+         ~Flusher()
+         {
+            Cache& c(cache);
+            spill(c, c.count);
+            c.dead = true;
+         }
+      };
+
+      struct Global
+      {
+         Global() : head(NULL) {}
+         std::mutex mtx;
+         Block *head;
+      };
+
+      static_assert(BlockSize >= sizeof(Block) && (BlockSize % ALIGN) == 0,
+                    "FixedBlockPool block size must be a multiple of ALIGN");
+
+         /** The global free list.  Intentionally never destroyed,
+          * since blocks can be freed during static destruction. */
+      static Global& global()
+      {
+         static Global *g = new Global;
+         return *g;
+      }
+
+      static void registerThread()
+      {
+         static thread_local Flusher flusher;
+         (void)flusher;
+         cache.registered = true;
+      }
+
+         /// Move up to BATCH_BLOCKS blocks into c, growing the pool if needed.
+      static void refill(Cache& c)
+      {
+         Global& g(global());
+         std::lock_guard<std::mutex> lock(g.mtx);
+         if (g.head == NULL)
+         {
+            char *chunk = static_cast<char*>(
+               ::operator new(BlockSize * CHUNK_BLOCKS));
+            for (std::size_t i = 0; i < CHUNK_BLOCKS; i++)
+            {
+               Block *b = reinterpret_cast<Block*>(chunk + i * BlockSize);
+               b->next = g.head;
+               g.head = b;
+            }
+         }
+         for (std::size_t i = 0; (i < BATCH_BLOCKS) && (g.head != NULL); i++)
+         {
+            Block *b = g.head;
+            g.head = b->next;
+            b->next = c.head;
+            c.head = b;
+            c.count++;
+         }
+      }
+
+         /// Move n blocks from c to the global free list.
+      static void spill(Cache& c, std::size_t n)
+      {
+         if (n == 0)
+            return;
+         Block *first = c.head, *last = c.head;
+         for (std::size_t i = 1; i < n; i++)
+            last = last->next;
+         c.head = last->next;
+         c.count -= n;
+         Global& g(global());
+         std::lock_guard<std::mutex> lock(g.mtx);
+         last->next = g.head;
+         g.head = first;
+      }
+
+      static thread_local Cache cache;
+   };
+
+   template <std::size_t BlockSize>
+   thread_local typename FixedBlockPool<BlockSize>::Cache
+   FixedBlockPool<BlockSize>::cache;
+
+
+      /** STL allocator that takes single objects from a
+       * FixedBlockPool, for use with node-based containers
+       * (std::list, std::set, std::map).  Once the containers have
+       * reached their working size, inserting and erasing elements
+       * no longer touches the heap.  Requests for more than one
+       * object, e.g. from std::vector, are passed to operator new.
+       *
+       * All instances are interchangeable, so containers using this
+       * allocator may be swapped and spliced freely.
+       *
+       * @code
+       * typedef std::list<int, gpstk::PoolAllocator<int> > IntList;
+       * @endcode */
+   template <class T>
+   class PoolAllocator
+   {
+   public:
+      typedef T value_type;
+      typedef T* pointer;
+      typedef const T* const_pointer;
+      typedef T& reference;
+      typedef const T& const_reference;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+
+      template <class U>
+      struct rebind
+      {
+         typedef PoolAllocator<U> other;
+      };
+
+         /// Size of the pool blocks used for T, rounded up to 16 bytes.
+      static const std::size_t BLOCK_SIZE = (sizeof(T) + 15) & ~size_type(15);
+
+      PoolAllocator() throw()
+      {}
+      template <class U>
+      PoolAllocator(const PoolAllocator<U>&) throw()
+      {}
+
+      pointer address(reference x) const
+      { return &x; }
+      const_pointer address(const_reference x) const
+      { return &x; }
+
+      pointer allocate(size_type n, const void* hint = 0)
+      {
+         if (n == 1)
+            return static_cast<pointer>(FixedBlockPool<BLOCK_SIZE>::allocate());
+         if (n > max_size())
+            throw std::bad_alloc();
+         return static_cast<pointer>(::operator new(n * sizeof(T)));
+      }
+
+      void deallocate(pointer p, size_type n)
+      {
+         if (p == NULL)
+            return;
+         if (n == 1)
+            FixedBlockPool<BLOCK_SIZE>::deallocate(p);
+         else
+            ::operator delete(p);
+      }
+
+      size_type max_size() const throw()
+      { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+      void construct(pointer p, const T& val)
+      { new(static_cast<void*>(p)) T(val); }
+      void destroy(pointer p)
+      { p->~T(); }
+   };
+
+   template <class T, class U>
+   inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+   { return true; }
+   template <class T, class U>
+   inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+   { return false; }
+
+} // namespace gpstk
+
+#endif // GPSTK_POOLALLOCATOR_HPP
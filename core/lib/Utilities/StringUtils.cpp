@@ -42,6 +42,11 @@
  */
 
 #include "StringUtils.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
 
 /* The DEBUG_COL macro is used to help debug issues with column
  * alignment and positioning.  If enabled, it will print, to stderr, a
@@ -280,5 +285,464 @@ namespace gpstk
          }
          return rv;
       }
+
+
+      namespace
+      {
+            /// Numbers shorter than this are copied to the stack for strtod().
+         const std::string::size_type numberBufLen = 64;
+
+            /// The powers of ten that are exact as doubles.
+         const double exactPow10[] =
+         {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+         };
+
+            /// The powers of ten that are exact as floats.
+         const float exactPow10f[] =
+         {
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+         };
+
+            /** Split the number at s into its sign, significant digits
+             * and power of ten.  Returns false for the numbers that
+             * parseDouble() leaves to strtod(), except that the number
+             * of digits and the power of ten are only limited to what
+             * fits in mant and exp10. */
+         bool decimalParts(const char* s, std::string::size_type len,
+                           const char* expChars, bool& neg, uint64_t& mant,
+                           int& exp10)
+         {
+            std::string::size_type i = 0;
+            while (i < len && isspace(static_cast<unsigned char>(s[i])))
+               i++;
+            neg = false;
+            if (i < len && (s[i] == '-' || s[i] == '+'))
+            {
+               neg = (s[i] == '-');
+               i++;
+            }
+               // strtod() reads hexadecimal
+            if (i+1 < len && s[i] == '0' && (s[i+1] == 'x' || s[i+1] == 'X'))
+               return false;
+            mant = 0;
+            exp10 = 0;
+            int digits = 0, significant = 0;
+            bool point = false;
+            for ( ; i < len; i++)
+            {
+               if (s[i] >= '0' && s[i] <= '9')
+               {
+                  digits++;
+                  if (point)
+                     exp10--;
+                  if (mant == 0 && s[i] == '0')
+                     continue;
+                  if (++significant > 19)
+                     return false;
+                  mant = mant * 10 + (s[i] - '0');
+               }
+               else if (s[i] == '.' && !point)
+                  point = true;
+               else
+                  break;
+            }
+            if (digits == 0)
+               return false;
+            if (i < len && s[i] != 0 && strchr(expChars, s[i]) != NULL)
+            {
+               i++;
+               bool expNeg = false;
+               if (i < len && (s[i] == '-' || s[i] == '+'))
+               {
+                  expNeg = (s[i] == '-');
+                  i++;
+               }
+                  // strtod() and streams disagree on what this means
+               if (i == len || s[i] < '0' || s[i] > '9')
+                  return false;
+               int e = 0;
+               for ( ; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+               {
+                  if (e < 100000)
+                     e = e * 10 + (s[i] - '0');
+               }
+               exp10 += (expNeg ? -e : e);
+            }
+            return true;
+         }
+      }
+
+
+      bool parseDouble(const char* s, std::string::size_type len,
+                       double& value, const char* expChars)
+      {
+#if FLT_EVAL_METHOD == 0
+         bool neg;
+         uint64_t mant;
+         int exp10;
+         if (!decimalParts(s, len, expChars, neg, mant, exp10))
+            return false;
+         double rv = 0.;
+         if (mant != 0)
+         {
+               // Both operands are exact, so the one rounding is the
+               // same as strtod()'s.
+            if (mant > (UINT64_C(1) << 53) || exp10 < -22 || exp10 > 22)
+               return false;
+            if (exp10 < 0)
+               rv = static_cast<double>(mant) / exactPow10[-exp10];
+            else
+               rv = static_cast<double>(mant) * exactPow10[exp10];
+         }
+         value = (neg ? -rv : rv);
+         return true;
+#else
+            // extended precision arithmetic would round twice
+         return false;
+#endif
+      }
+
+
+      double asDouble(const char* s, std::string::size_type len)
+      {
+         double rv;
+         if (parseDouble(s, len, rv))
+            return rv;
+         if (len < numberBufLen)
+         {
+            char buf[numberBufLen];
+            memcpy(buf, s, len);
+            buf[len] = 0;
+            return strtod(buf, 0);
+         }
+         return asDouble(std::string(s, len));
+      }
+
+
+      long asInt(const char* s, std::string::size_type len)
+      {
+         std::string::size_type i = 0;
+         while (i < len && isspace(static_cast<unsigned char>(s[i])))
+            i++;
+         bool neg = false;
+         if (i < len && (s[i] == '-' || s[i] == '+'))
+         {
+            neg = (s[i] == '-');
+            i++;
+         }
+         long rv = 0;
+         for (int digits = 0; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+         {
+               // leave possible overflow to strtol()
+            if (++digits > 18)
+            {
+               if (len < numberBufLen)
+               {
+                  char buf[numberBufLen];
+                  memcpy(buf, s, len);
+                  buf[len] = 0;
+                  return strtol(buf, 0, 10);
+               }
+               return asInt(std::string(s, len));
+            }
+            rv = rv * 10 + (s[i] - '0');
+         }
+         return (neg ? -rv : rv);
+      }
+
+
+      float asFloat(const char* s, std::string::size_type len)
+      {
+#if FLT_EVAL_METHOD == 0
+         bool neg;
+         uint64_t mant;
+         int exp10;
+         if (decimalParts(s, len, "eE", neg, mant, exp10) &&
+             (mant == 0 ||
+              (mant <= (UINT64_C(1) << 24) && exp10 >= -10 && exp10 <= 10)))
+         {
+            float rv = 0.f;
+            if (mant != 0 && exp10 < 0)
+               rv = static_cast<float>(mant) / exactPow10f[-exp10];
+            else if (mant != 0)
+               rv = static_cast<float>(mant) * exactPow10f[exp10];
+            return (neg ? -rv : rv);
+         }
+#endif
+         return asFloat(std::string(s, len));
+      }
+
+
+      double asFortranDouble(const char* s, std::string::size_type len)
+      {
+         if (isBlank(s, len))
+            return 0;
+         double rv;
+         if (parseDouble(s, len, rv, "eEDd"))
+            return rv;
+         return for2doub(std::string(s, len));
+      }
+
+
+      namespace
+      {
+            /** Round x*10^k, for x >= 0, to the nearest integer.
+             * Returns false, leaving the work to printf(), if the
+             * result would not be below 2^52, if 10^k is not a product
+             * of at most two exact powers of ten, or if x*10^k is too
+             * close to halfway between two integers to be sure which
+             * way printf() rounds it.  scaled is set to the unrounded
+             * x*10^k. */
+         bool roundScaled(double x, int k, uint64_t& rv, double& scaled)
+         {
+            if (k >= 0 && k <= 22)
+               scaled = x * exactPow10[k];
+            else if (k < 0 && k >= -22)
+               scaled = x / exactPow10[-k];
+            else if (k > 22 && k <= 44)
+               scaled = (x * exactPow10[22]) * exactPow10[k-22];
+            else if (k < -22 && k >= -44)
+               scaled = (x / exactPow10[22]) / exactPow10[-k-22];
+            else
+               return false;
+               // also rejects NaN
+            if (!(scaled < 4503599627370496.0))
+               return false;
+               // at most two roundings, each within 2^-53 of scaled
+            double whole = std::floor(scaled);
+            double frac = scaled - whole;
+            if (std::fabs(frac - 0.5) <= scaled * 1e-15)
+               return false;
+            rv = static_cast<uint64_t>(whole) + (frac > 0.5 ? 1 : 0);
+            return true;
+         }
+
+            /** Get the prec+1 significant digits and the power of ten
+             * of the first one that printf("%.*e") gives for x >= 0.
+             * @return false if roundScaled() can not do it. */
+         bool sciDigits(double x, int prec, uint64_t& digits, int& exp10)
+         {
+            if (x == 0)
+            {
+               digits = 0;
+               exp10 = 0;
+               return true;
+            }
+            const uint64_t low = static_cast<uint64_t>(exactPow10[prec]);
+            const uint64_t high = low * 10;
+            exp10 = static_cast<int>(std::floor(std::log10(x)));
+               // log10() may be out by one next to a power of ten
+            for (int tries = 0; tries < 3; tries++)
+            {
+               double scaled;
+               if (!roundScaled(x, prec - exp10, digits, scaled))
+                  return false;
+               if (scaled < low)
+                  exp10--;
+               else if (scaled >= high)
+                  exp10++;
+               else
+               {
+                  if (digits == high)
+                  {
+                     digits = low;
+                     exp10++;
+                  }
+                  return true;
+               }
+            }
+            return false;
+         }
+
+            /** Write the decimal digits of n, at least minDigits of
+             * them, ending just before end.
+             * @return a pointer to the first digit. */
+         char* putDigits(char* end, uint64_t n, int minDigits)
+         {
+            char *p = end;
+            while (n != 0 || minDigits > 0)
+            {
+               *--p = static_cast<char>('0' + n % 10);
+               n /= 10;
+               minDigits--;
+            }
+            return p;
+         }
+
+            /** Write s, of length len, into width characters at buf
+             * as rightJustify() does, padding on the left with pad or
+             * keeping the rightmost width characters. */
+         void justifyRight(char* buf, std::string::size_type width,
+                           char pad, const char* s,
+                           std::string::size_type len)
+         {
+            if (len >= width)
+            {
+               std::memcpy(buf, s + len - width, width);
+            }
+            else
+            {
+               std::memset(buf, pad, width - len);
+               std::memcpy(buf + width - len, s, len);
+            }
+         }
+
+            /** Copy s, of length len, to buf as snprintf() would. */
+         std::string::size_type copyOut(char* buf,
+                                        std::string::size_type bufLen,
+                                        const char* s,
+                                        std::string::size_type len)
+         {
+            if (bufLen > 0)
+            {
+               std::string::size_type n = std::min(len, bufLen-1);
+               std::memcpy(buf, s, n);
+               buf[n] = 0;
+            }
+            return len;
+         }
+      }
+
+
+      std::string::size_type floatFormat(char* buf,
+                                         std::string::size_type bufLen,
+                                         double d, FFLead lead,
+                                         unsigned mantissa, unsigned exponent,
+                                         unsigned width, char expChar,
+                                         FFSign sign, FFAlign align)
+      {
+            // the value and precision that the string version formats
+            // with the stream before moving the decimal point, which
+            // it needs to find
+         int prec = static_cast<int>(mantissa) - 1;
+         int minPrec = 1;
+         double v = d * 10;
+         switch (lead)
+         {
+            case FFLead::Zero:
+               prec--;
+               break;
+            case FFLead::Decimal:
+               break;
+            case FFLead::NonZero:
+               v = d;
+               minPrec = 0;
+               break;
+         }
+         uint64_t digits;
+         int exp10;
+         if (prec < minPrec || prec > 14 || exponent > 20 ||
+             !std::isfinite(v) ||
+             !sciDigits(std::fabs(v), prec, digits, exp10))
+         {
+            std::string rv = floatFormat(d, lead, mantissa, exponent, width,
+                                         expChar, sign, align);
+            return copyOut(buf, bufLen, rv.data(), rv.size());
+         }
+         char tmp[64];
+         char *p = tmp;
+         if ((sign == FFSign::NegSpace) && (d >= 0))
+            *p++ = ' ';
+         if (std::signbit(v))
+            *p++ = '-';
+         else if (sign == FFSign::NegPos)
+            *p++ = '+';
+         char digitBuf[20];
+         char *first = putDigits(digitBuf + sizeof(digitBuf), digits, prec+1);
+         switch (lead)
+         {
+            case FFLead::Zero:
+               *p++ = '0';
+                  // fall through
+            case FFLead::Decimal:
+               *p++ = '.';
+               std::memcpy(p, first, prec+1);
+               p += prec+1;
+               break;
+            case FFLead::NonZero:
+               *p++ = *first;
+               if (prec > 0)
+               {
+                  *p++ = '.';
+                  std::memcpy(p, first+1, prec);
+                  p += prec;
+               }
+               break;
+         }
+         *p++ = expChar;
+         *p++ = (exp10 < 0 ? '-' : '+');
+         char expBuf[24];
+         char *expFirst = putDigits(expBuf + sizeof(expBuf),
+                                    exp10 < 0 ? -exp10 : exp10,
+                                    std::max(exponent, 2u));
+         std::string::size_type expLen = expBuf + sizeof(expBuf) - expFirst;
+         std::memcpy(p, expFirst, expLen);
+         p += expLen;
+         std::string::size_type len = p - tmp;
+         if (len >= width)
+            return copyOut(buf, bufLen, tmp, len);
+            // pad to width, as far as buf allows
+         char padded[128];
+         if (width > sizeof(padded))
+         {
+            std::string rv(tmp, len);
+            rv.insert((align == FFAlign::Right ? 0 : len), width - len, ' ');
+            return copyOut(buf, bufLen, rv.data(), rv.size());
+         }
+         if (align == FFAlign::Right)
+            justifyRight(padded, width, ' ', tmp, len);
+         else
+         {
+            std::memcpy(padded, tmp, len);
+            std::memset(padded + len, ' ', width - len);
+         }
+         return copyOut(buf, bufLen, padded, width);
+      }
+
+
+      void formatFixed(char* buf, double x, std::string::size_type precision,
+                       std::string::size_type width, char pad)
+      {
+         uint64_t n;
+         double scaled;
+         if (precision > 22 ||
+             !roundScaled(std::fabs(x), precision, n, scaled))
+         {
+            std::string s = asString(x, precision);
+            justifyRight(buf, width, pad, s.data(), s.size());
+            return;
+         }
+            // 2^52 has 16 digits, plus sign and decimal point
+         char tmp[48];
+         char *end = tmp + sizeof(tmp);
+         char *p = putDigits(end, n, precision+1);
+         if (precision > 0)
+         {
+            std::string::size_type whole = (end - p) - precision;
+            std::memmove(p-1, p, whole);
+            p--;
+            p[whole] = '.';
+         }
+         if (std::signbit(x))
+            *--p = '-';
+         justifyRight(buf, width, pad, p, end - p);
+      }
+
+
+      void formatInt(char* buf, long x, std::string::size_type width,
+                     char pad)
+      {
+         char tmp[24];
+         char *end = tmp + sizeof(tmp);
+         unsigned long u = static_cast<unsigned long>(x);
+         if (x < 0)
+            u = 0UL - u;
+         char *p = putDigits(end, u, 1);
+         if (x < 0)
+            *--p = '-';
+         justifyRight(buf, width, pad, p, end - p);
+      }
    } // namespace StringUtils
 } // namespace gpstk
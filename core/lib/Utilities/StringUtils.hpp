@@ -53,6 +53,8 @@
 #include <cstdio>   /// @todo Get rid of the stdio.h dependency if possible.
 #include <cctype>
 #include <limits>
+#include <algorithm>
+#include <stdexcept>
 
 #ifdef _WIN32
 #if _MSC_VER < 1700
@@ -737,6 +739,132 @@ namespace gpstk
           */
       inline long double asLongDouble(const std::string& s);
 
+         /**
+          * Convert a number in a character buffer to a double
+          * precision floating point number without allocating memory.
+          * Numbers of up to 19 significant digits with a power of ten
+          * of at most 22, which covers the fixed-width fields of RINEX
+          * and SP3 files, are converted directly; anything else is
+          * given to strtod().  The result is the same as
+          * asDouble(std::string(s, len)).
+          * @param s the characters to convert, which need not be
+          *   null terminated.
+          * @param len the number of characters at \a s.
+          * @return double representation of the characters.
+          */
+      double asDouble(const char* s, std::string::size_type len);
+
+         /**
+          * Convert part of a string to a double precision floating
+          * point number, as asDouble(s.substr(pos, len)) but without
+          * making the substring.
+          * @throw std::out_of_range if pos > s.size(), as substr().
+          */
+      inline double asDouble(const std::string& s, std::string::size_type pos,
+                             std::string::size_type len);
+
+         /**
+          * Convert a number in a character buffer to an integer
+          * without allocating memory.  The result is the same as
+          * asInt(std::string(s, len)).
+          * @param s the characters to convert, which need not be
+          *   null terminated.
+          * @param len the number of characters at \a s.
+          * @return long integer representation of the characters.
+          */
+      long asInt(const char* s, std::string::size_type len);
+
+         /**
+          * Convert part of a string to an integer, as
+          * asInt(s.substr(pos, len)) but without making the substring.
+          * @throw std::out_of_range if pos > s.size(), as substr().
+          */
+      inline long asInt(const std::string& s, std::string::size_type pos,
+                        std::string::size_type len);
+
+         /**
+          * Convert a number in a character buffer to a single
+          * precision floating point number, without allocating memory
+          * for numbers of up to 7 significant digits with a power of
+          * ten of at most 10.  The result is the same as
+          * asFloat(std::string(s, len)).
+          * @param s the characters to convert, which need not be
+          *   null terminated.
+          * @param len the number of characters at \a s.
+          * @return single representation of the characters.
+          * @throw StringException
+          */
+      float asFloat(const char* s, std::string::size_type len);
+
+         /**
+          * Convert part of a string to a single precision floating
+          * point number, as asFloat(s.substr(pos, len)) but without
+          * making the substring.
+          * @throw std::out_of_range if pos > s.size(), as substr().
+          * @throw StringException
+          */
+      inline float asFloat(const std::string& s, std::string::size_type pos,
+                           std::string::size_type len);
+
+         /**
+          * Convert a FORTRAN number in a character buffer, which may
+          * use D or d as well as E or e for the exponent, to a double
+          * precision floating point number without allocating memory.
+          * A blank field is zero.  The result is the same as
+          * for2doub(std::string(s, len)).
+          * @param s the characters to convert, which need not be
+          *   null terminated.
+          * @param len the number of characters at \a s.
+          * @return double representation of the characters.
+          */
+      double asFortranDouble(const char* s, std::string::size_type len);
+
+         /**
+          * Convert a FORTRAN number in part of a string, as
+          * for2doub(s, pos, len) but without making the substring.
+          * @throw std::out_of_range if pos > s.size(), as substr().
+          */
+      inline double asFortranDouble(const std::string& s,
+                                    std::string::size_type pos,
+                                    std::string::size_type len);
+
+         /**
+          * Convert a decimal number in a character buffer exactly,
+          * without strtod().  This is the fast path of asDouble(),
+          * asFortranDouble() and FormattedDouble, for callers that
+          * have their own handling of other numbers.
+          * @param s the characters to convert, which need not be
+          *   null terminated.  Leading white space is skipped and
+          *   conversion stops at the first character that is not part
+          *   of the number.
+          * @param len the number of characters at \a s.
+          * @param value set to the number if true is returned.
+          * @param expChars the characters that may start an exponent.
+          * @return false, leaving \a value unchanged, if the
+          *   characters have no digits, are hexadecimal, infinity or
+          *   NaN, have an exponent character without an exponent, or
+          *   have more than 19 significant digits or a power of ten
+          *   beyond 22.
+          */
+      bool parseDouble(const char* s, std::string::size_type len,
+                       double& value, const char* expChars = "eE");
+
+         /**
+          * Determine if a field is blank, as RINEX writes missing data.
+          * @param s the characters to check.
+          * @param len the number of characters at \a s.
+          * @return true if all len characters are spaces, or len is 0.
+          */
+      inline bool isBlank(const char* s, std::string::size_type len);
+
+         /**
+          * Determine if part of a string is blank, as
+          * isBlank(s.substr(pos, len)).
+          * @throw std::out_of_range if pos > s.size(), as substr().
+          */
+      inline bool isBlank(const std::string& s, std::string::size_type pos,
+                          std::string::size_type len);
+
          /**
           * Convert a value in a string to a type specified by the template
           * class.  The template class type must have stream operators
@@ -1290,6 +1418,73 @@ namespace gpstk
                               FFSign sign = FFSign::NegOnly,
                               FFAlign align = FFAlign::Left);
 
+         /** Format a floating point value as floatFormat(d, lead,
+          * mantissa, exponent, width, expChar, sign, align) does, into
+          * a buffer rather than a new string.  Like snprintf(), at
+          * most bufLen-1 characters are written followed by a null,
+          * and the return value is the length of the complete
+          * formatted value, so a return value >= bufLen means the
+          * output was truncated.
+          * @param[out] buf the buffer to write into.
+          * @param[in] bufLen the size of buf.
+          * @return the length of the formatted value.
+          * @see floatFormat(double,FFLead,unsigned,unsigned,unsigned,
+          *   char,FFSign,FFAlign) for the other parameters. */
+      std::string::size_type floatFormat(char* buf,
+                                         std::string::size_type bufLen,
+                                         double d, FFLead lead,
+                                         unsigned mantissa, unsigned exponent,
+                                         unsigned width = 0,
+                                         char expChar = 'e',
+                                         FFSign sign = FFSign::NegOnly,
+                                         FFAlign align = FFAlign::Left);
+
+         /** Write a value in fixed point notation into exactly width
+          * characters of a line buffer, giving the same characters as
+          * rightJustify(asString(x, precision), width, pad) without
+          * creating any strings.  The buffer is not null terminated.
+          * @param[out] buf where to write the width characters.
+          * @param[in] x the value to format.
+          * @param[in] precision the number of digits after the
+          *   decimal point.
+          * @param[in] width the width of the field.
+          * @param[in] pad the character to fill the field with on
+          *   the left. */
+      void formatFixed(char* buf, double x,
+                       std::string::size_type precision,
+                       std::string::size_type width, char pad = ' ');
+
+         /** Write an integer into exactly width characters of a line
+          * buffer, giving the same characters as
+          * rightJustify(asString(x), width, pad).  The buffer is not
+          * null terminated.
+          * @param[out] buf where to write the width characters.
+          * @param[in] x the value to format.
+          * @param[in] width the width of the field.
+          * @param[in] pad the character to fill the field with on
+          *   the left. */
+      void formatInt(char* buf, long x, std::string::size_type width,
+                     char pad = ' ');
+
+         /** Append a value in fixed point notation to a line, as
+          * s += rightJustify(asString(x, precision), width, pad)
+          * does, without allocating if s has the capacity.
+          * @see formatFixed() for the parameters.
+          * @return a reference to \a s. */
+      inline std::string& appendFixed(std::string& s, double x,
+                                      std::string::size_type precision,
+                                      std::string::size_type width,
+                                      char pad = ' ');
+
+         /** Append an integer to a line, as
+          * s += rightJustify(asString(x), width, pad) does, without
+          * allocating if s has the capacity.
+          * @see formatInt() for the parameters.
+          * @return a reference to \a s. */
+      inline std::string& appendInt(std::string& s, long x,
+                                    std::string::size_type width,
+                                    char pad = ' ');
+
          /**
           * Change a string into printable characters.  Control
           * characters 0, 1, ... 31 are changed to ^@, ^A, ... ^_ ;
@@ -1623,7 +1818,7 @@ namespace gpstk
          try
          {
             std::istringstream is(s);
-            float f;
+            float f = 0;
             is >> f;
             return f;
          }
@@ -1650,6 +1845,65 @@ namespace gpstk
          }
       }
 
+         /** Return a pointer to and the length of s.substr(pos, len)
+          * without making the substring.
+          * @throw std::out_of_range if pos > s.size(), as substr(). */
+      inline const char* subPointer(const std::string& s,
+                                    std::string::size_type pos,
+                                    std::string::size_type& len)
+      {
+         if (pos > s.size())
+            throw std::out_of_range("StringUtils: pos > size()");
+         len = std::min(len, s.size() - pos);
+         return s.data() + pos;
+      }
+
+      inline double asDouble(const std::string& s, std::string::size_type pos,
+                             std::string::size_type len)
+      {
+         const char *p = subPointer(s, pos, len);
+         return asDouble(p, len);
+      }
+
+      inline long asInt(const std::string& s, std::string::size_type pos,
+                        std::string::size_type len)
+      {
+         const char *p = subPointer(s, pos, len);
+         return asInt(p, len);
+      }
+
+      inline float asFloat(const std::string& s, std::string::size_type pos,
+                           std::string::size_type len)
+      {
+         const char *p = subPointer(s, pos, len);
+         return asFloat(p, len);
+      }
+
+      inline double asFortranDouble(const std::string& s,
+                                    std::string::size_type pos,
+                                    std::string::size_type len)
+      {
+         const char *p = subPointer(s, pos, len);
+         return asFortranDouble(p, len);
+      }
+
+      inline bool isBlank(const char* s, std::string::size_type len)
+      {
+         for (std::string::size_type i = 0; i < len; i++)
+         {
+            if (s[i] != ' ')
+               return false;
+         }
+         return true;
+      }
+
+      inline bool isBlank(const std::string& s, std::string::size_type pos,
+                          std::string::size_type len)
+      {
+         const char *p = subPointer(s, pos, len);
+         return isBlank(p, len);
+      }
+
       template <class X>
       inline X asData(const std::string& s)
       {
@@ -1689,6 +1943,27 @@ namespace gpstk
          return ss.str();
       }
 
+      inline std::string& appendFixed(std::string& s, double x,
+                                      std::string::size_type precision,
+                                      std::string::size_type width,
+                                      char pad)
+      {
+         std::string::size_type n = s.size();
+         s.resize(n + width);
+         formatFixed(&s[n], x, precision, width, pad);
+         return s;
+      }
+
+      inline std::string& appendInt(std::string& s, long x,
+                                    std::string::size_type width,
+                                    char pad)
+      {
+         std::string::size_type n = s.size();
+         s.resize(n + width);
+         formatInt(&s[n], x, width, pad);
+         return s;
+      }
+
          // decimal to hex...
       inline std::string& d2x(std::string& s)
       {
@@ -0,0 +1,178 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file ThreadSlotCache.hpp
+ * Per-thread cache of lookup results, for objects that are read by
+ * many threads at once and are not modified meanwhile.
+ */
+
+#ifndef GPSTK_THREADSLOTCACHE_HPP
+#define GPSTK_THREADSLOTCACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace gpstk
+{
+      /** A cache of lookup results kept by each thread, on behalf of
+       * an object that is read by many threads at once, such as an
+       * ephemeris store.  The object holds a ThreadSlotCache as a
+       * member, and keeps in its slots what it needs to answer the
+       * next lookup quickly.
+       *
+       * Each thread has NSlots slots, shared by all the caches of the
+       * same instantiation.  slot() picks one by the address of the
+       * cache and a key chosen by the owner, e.g. from a satellite;
+       * another cache or key may take the slot over, so the Value
+       * must identify what it was computed for.  Since the slots
+       * belong to the thread, no lock is needed.
+       *
+       * A slot holds a value of the cache only if it was filled in
+       * the cache's current generation; see holds().  The owner calls
+       * invalidate() whenever the data the values were derived from
+       * change.  Generations are unique among the caches of one
+       * instantiation, so a cache created at the address of a deleted
+       * one, or a copy, never sees the old values.
+       *
+       * The cache also counts the hits and misses the owner records.
+       *
+       * @param Value the data kept in a slot; must be default
+       *   constructible
+       * @param NSlots number of slots per thread */
+   template <class Value, std::size_t NSlots>
+   class ThreadSlotCache
+   {
+   public:
+         /// A place in a thread's cache
+      struct Slot
+      {
+         Slot() : generation(0) {}
+         unsigned long generation;  ///< generation that filled value
+         Value value;               ///< the cached data
+      };
+
+      ThreadSlotCache()
+            : generation(newGeneration()), hits(0), misses(0)
+      {}
+
+         /// A copy starts with a new generation and no statistics.
+      ThreadSlotCache(const ThreadSlotCache&)
+            : generation(newGeneration()), hits(0), misses(0)
+      {}
+
+         /// Assignment starts a new generation and clears the statistics.
+      ThreadSlotCache& operator=(const ThreadSlotCache&)
+      {
+         invalidate();
+         resetStats();
+         return *this;
+      }
+
+         /// Return the calling thread's slot for key in this cache.
+      Slot& slot(std::size_t key) const
+      {
+         static thread_local Slot slots[NSlots];
+         std::size_t h = reinterpret_cast<std::size_t>(this) / sizeof(void*);
+         return slots[(h * 31 + key) % NSlots];
+      }
+
+         /** Return a slot of the calling thread outside the table,
+          * for a value that is computed like the cached ones but not
+          * kept. */
+      Slot& scratch(void) const
+      {
+         static thread_local Slot s;
+         return s;
+      }
+
+         /// Return true if s was filled in the current generation.
+      bool holds(const Slot& s) const throw()
+      { return s.generation == generation.load(std::memory_order_relaxed); }
+
+         /** Mark s as filled in the current generation; call this
+          * only once its value is complete. */
+      void fill(Slot& s) const throw()
+      { s.generation = generation.load(std::memory_order_relaxed); }
+
+         /// Mark s as not holding a value, e.g. while it is refilled.
+      static void release(Slot& s) throw()
+      { s.generation = 0; }
+
+         /// Make the slots of all threads out of date for this cache.
+      void invalidate(void) throw()
+      { generation = newGeneration(); }
+
+         /// Count a lookup answered from the cache.
+      void hit(void) const throw()
+      { hits.fetch_add(1, std::memory_order_relaxed); }
+
+         /// Count a lookup that was not answered from the cache.
+      void miss(void) const throw()
+      { misses.fetch_add(1, std::memory_order_relaxed); }
+
+         /// Get the number of lookups answered from the cache.
+      unsigned long getHits(void) const throw()
+      { return hits; }
+
+         /// Get the number of lookups not answered from the cache.
+      unsigned long getMisses(void) const throw()
+      { return misses; }
+
+         /// Reset the hit and miss counters to zero.
+      void resetStats(void) throw()
+      {
+         hits = 0;
+         misses = 0;
+      }
+
+   private:
+         /// @return a generation number not used before; never 0
+      static unsigned long newGeneration(void) throw()
+      {
+         static std::atomic<unsigned long> next(1);
+         return next++;
+      }
+
+      std::atomic<unsigned long> generation;
+      mutable std::atomic<unsigned long> hits, misses;
+   }; // end class ThreadSlotCache
+
+} // namespace gpstk
+
+#endif // GPSTK_THREADSLOTCACHE_HPP
@@ -0,0 +1,175 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include "WorkerPool.hpp"
+
+namespace gpstk
+{
+   WorkerPool ::
+   WorkerPool(unsigned nThreads)
+         : generation(0),
+           nDone(0),
+           running(false),
+           quit(false),
+           haveExcept(false)
+   {
+      for (unsigned t = 1; t <= nThreads; t++)
+         threads.push_back(std::thread(&WorkerPool::threadLoop, this, t));
+   }
+
+
+   WorkerPool ::
+   ~WorkerPool()
+   {
+      {
+         std::unique_lock<std::mutex> lock(poolMutex);
+         while (running && (nDone < threads.size()))
+            doneCond.wait(lock);
+         quit = true;
+      }
+      poolCond.notify_all();
+      for (size_t i = 0; i < threads.size(); i++)
+         threads[i].join();
+   }
+
+
+   void WorkerPool ::
+   run(const Task& task)
+   {
+      start(task);
+      try
+      {
+         task(0);
+      }
+      catch (Exception& e)
+      {
+         saveException(e);
+      }
+      catch (std::exception& e)
+      {
+         saveException(Exception(e.what()));
+      }
+      wait();
+   }
+
+
+   void WorkerPool ::
+   start(const Task& task)
+   {
+      {
+         std::lock_guard<std::mutex> lock(poolMutex);
+         if (running)
+         {
+            InvalidRequest exc("WorkerPool is already running a task");
+            GPSTK_THROW(exc);
+         }
+         job = task;
+         nDone = 0;
+         haveExcept = false;
+         running = true;
+         ++generation;
+      }
+      poolCond.notify_all();
+   }
+
+
+   void WorkerPool ::
+   wait()
+   {
+      std::unique_lock<std::mutex> lock(poolMutex);
+      while (running && (nDone < threads.size()))
+         doneCond.wait(lock);
+      running = false;
+      if (haveExcept)
+      {
+         haveExcept = false;
+         GPSTK_THROW(poolExcept);
+      }
+   }
+
+
+   void WorkerPool ::
+   threadLoop(unsigned t)
+   {
+      unsigned long seen = 0;
+      while (true)
+      {
+         {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            while (!quit && (generation == seen))
+               poolCond.wait(lock);
+            if (quit)
+               return;
+            seen = generation;
+         }
+
+         try
+         {
+            job(t);
+         }
+         catch (Exception& e)
+         {
+            saveException(e);
+         }
+         catch (std::exception& e)
+         {
+            saveException(Exception(e.what()));
+         }
+
+         {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            ++nDone;
+         }
+         doneCond.notify_all();
+      }
+   }
+
+
+   void WorkerPool ::
+   saveException(const Exception& e)
+   {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      if (!haveExcept)
+      {
+         haveExcept = true;
+         poolExcept = e;
+      }
+   }
+
+} // namespace gpstk
@@ -0,0 +1,141 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+/**
+ * @file WorkerPool.hpp
+ * A fixed set of threads that run a task together.
+ */
+
+#ifndef GPSTK_WORKERPOOL_HPP
+#define GPSTK_WORKERPOOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /** A fixed set of worker threads that run one task at a time.
+       * The threads are started by the constructor and wait for a
+       * task; each calls the task with its own index, 1 to
+       * getNumThreads(), so that the task can divide the work
+       * between them.  Index 0 stands for the calling thread.
+       *
+       * There are two ways to use the pool.  run() divides a task
+       * between the workers and the calling thread and returns when
+       * all are done, e.g. to process the parts of a data set in
+       * parallel:
+       * \code{.cpp}
+       * WorkerPool pool(3);
+       * std::vector<double> sums(4);
+       * pool.run([&](unsigned t) { sums[t] = partialSum(t, 4); });
+       * \endcode
+       * start() and wait() instead leave the calling thread free
+       * while the workers run, for tasks such as reading ahead that
+       * wait on their own queues; the task must then return when
+       * the caller tells it to.
+       *
+       * An exception thrown by the task is caught in the thread
+       * that threw it, and the first one is rethrown by run() or
+       * wait() once all the threads are done.  A std::exception is
+       * rethrown as an Exception with the same text. */
+   class WorkerPool
+   {
+   public:
+         /// The work given to the threads, called with the thread index.
+      typedef std::function<void(unsigned)> Task;
+
+         /** Start the worker threads.
+          * @param[in] nThreads The number of worker threads, not
+          *   counting the calling thread.  With 0, run() simply
+          *   calls the task in the calling thread. */
+      WorkerPool(unsigned nThreads);
+
+         /// Wait for a task that was started, then stop the threads.
+      ~WorkerPool();
+
+         /// Return the number of worker threads.
+      unsigned getNumThreads() const throw()
+      { return threads.size(); }
+
+         /** Call task(0) in the calling thread and task(t), t = 1 to
+          * getNumThreads(), in the workers, and wait for all of
+          * them.
+          * @throw InvalidRequest if a task is already running.
+          * @throw Exception if any of the calls threw. */
+      void run(const Task& task);
+
+         /** Call task(t), t = 1 to getNumThreads(), in the workers
+          * and return at once.
+          * @throw InvalidRequest if a task is already running. */
+      void start(const Task& task);
+
+         /** Wait for the task given to start() to return in all the
+          * workers.  Returns at once if no task is running.
+          * @throw Exception if any of the calls threw. */
+      void wait();
+
+   private:
+         /// Body of worker thread t.
+      void threadLoop(unsigned t);
+         /// Keep e if it is the first exception of the task.
+      void saveException(const Exception& e);
+
+      std::vector<std::thread> threads;
+      std::mutex poolMutex;
+      std::condition_variable poolCond, doneCond;
+      Task job;                     ///< the task being run
+      unsigned long generation;     ///< incremented for each task
+      unsigned nDone;               ///< number of workers done with the task
+      bool running;                 ///< a task was started and not waited for
+      bool quit;                    ///< stop the worker threads
+      bool haveExcept;              ///< the task threw
+      Exception poolExcept;         ///< what it threw
+
+         // no copies
+      WorkerPool(const WorkerPool&);
+      WorkerPool& operator=(const WorkerPool&);
+   };
+
+} // namespace gpstk
+
+#endif // GPSTK_WORKERPOOL_HPP
@@ -0,0 +1,252 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "BinexRecordScanner.hpp"
+#include "TestUtil.hpp"
+#include <sstream>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace gpstk;
+
+class BinexRecordScanner_T
+{
+public:
+   BinexRecordScanner_T()
+   {
+      const BinexData::SyncByte flags[] =
+      {
+         0, BinexData::eBigEndian, BinexData::eEnhancedCRC,
+         BinexData::eBigEndian | BinexData::eEnhancedCRC,
+         BinexData::eReverseReadable,
+         BinexData::eReverseReadable | BinexData::eBigEndian,
+         BinexData::eReverseReadable | BinexData::eEnhancedCRC,
+         BinexData::eReverseReadable | BinexData::eBigEndian
+         | BinexData::eEnhancedCRC
+      };
+         // message sizes around each change of CRC length
+      const size_t sizes[] = { 0, 5, 124, 126, 200, 4090, 5000 };
+      const BinexData::RecordID ids[] = { 0, 1, 200, 20000, 3000000 };
+      uint64_t seed = 1;
+      ostringstream oss;
+      for (size_t f = 0; f < 8; f++)
+      {
+         for (size_t s = 0; s < 7; s++)
+         {
+            BinexData rec(ids[(f+s) % 5], flags[f]);
+            string msg(sizes[s], 0);
+            for (size_t i = 0; i < msg.size(); i++)
+            {
+               seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+               msg[i] = seed >> 56;
+            }
+            size_t off = 0;
+            rec.updateMessageData(off, msg, msg.size());
+            records.push_back(rec);
+            rec.putRecord(oss);
+         }
+      }
+      stream = oss.str();
+   }
+
+      /// Number of views that do not match records[first...].
+   unsigned mismatches(const vector<BinexRecordView>& views, size_t first = 0)
+   {
+      unsigned bad = 0;
+      for (size_t i = 0; i < views.size(); i++)
+      {
+         BinexData rec;
+         views[i].toBinexData(rec);
+         const BinexData& expect = records[first + i];
+         bad += !(rec == expect) || (rec.getRecordFlags()
+                                     != expect.getRecordFlags())
+            || (views[i].recordSize != expect.getRecordSize())
+            || (views[i].messageSize != expect.getMessageLength());
+      }
+      return bad;
+   }
+
+   unsigned scanTest()
+   {
+      TUDEF("BinexRecordScanner", "next");
+
+      BinexRecordScanner scanner(stream.data(), stream.size());
+      vector<BinexRecordView> views;
+      BinexRecordView view;
+      while (scanner.next(view))
+         views.push_back(view);
+      TUASSERTE(size_t, records.size(), views.size());
+      TUASSERTE(unsigned, 0, mismatches(views));
+      TUASSERTE(size_t, stream.size(), scanner.getOffset());
+      TUASSERTE(size_t, 0, scanner.getSkipped());
+      TUASSERTE(size_t, records.size(), scanner.getRecordCount());
+
+         // the views point into the buffer
+      TUASSERT(views[3].record == (const unsigned char*)stream.data()
+               + records[0].getRecordSize() + records[1].getRecordSize()
+               + records[2].getRecordSize());
+
+         // BinexData::getRecord agrees on the forward-only records
+      istringstream iss(stream);
+      size_t pos = 0;
+      unsigned bad = 0;
+      for (size_t i = 0; i < 14; i++)
+      {
+         BinexData rec;
+         size_t n = rec.getRecord(iss);
+         bad += (n != views[i].recordSize)
+            || (rec.getMessageData()
+                != string((const char*)views[i].message,
+                          views[i].messageSize))
+            || (views[i].record != (const unsigned char*)stream.data() + pos);
+         pos += n;
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+      BinexRecordScanner empty;
+      TUASSERT(!empty.next(view));
+
+      TURETURN();
+   }
+
+   unsigned resyncTest()
+   {
+      TUDEF("BinexRecordScanner", "next");
+
+         // garbage, including sync-like bytes, before the first
+         // record and after the tenth, and a corrupt eleventh record
+      size_t tenth = 0;
+      for (size_t i = 0; i < 10; i++)
+         tenth += records[i].getRecordSize();
+      string bad(stream);
+      bad[tenth + records[10].getHeadLength() + 2] ^= 0x40;
+      const char junk[] = "\xe2\x05\x7f\x01\xc2\xd2\x00\x00\xff";
+      bad.insert(tenth, junk, sizeof(junk) - 1);
+      bad.insert(0, junk, sizeof(junk) - 1);
+
+      BinexRecordScanner scanner(bad.data(), bad.size());
+      vector<BinexRecordView> views;
+      BinexRecordView view;
+      while (scanner.next(view))
+         views.push_back(view);
+      TUASSERTE(size_t, records.size() - 1, views.size());
+      views.erase(views.begin() + 10, views.end());
+      TUASSERTE(unsigned, 0, mismatches(views));
+      TUASSERTE(size_t, 2 * (sizeof(junk) - 1) + records[10].getRecordSize(),
+                scanner.getSkipped());
+
+         // strict mode stops at the junk
+      BinexRecordScanner strict(bad.data(), bad.size());
+      strict.strict = true;
+      TUTHROW(strict.next(view));
+      TUASSERTE(size_t, 0, strict.getOffset());
+
+      TURETURN();
+   }
+
+   unsigned streamTest()
+   {
+      TUDEF("BinexRecordScanner", "reset");
+
+         // feed the stream a few bytes at a time, keeping the
+         // incomplete tail
+      const size_t chunk = 97;
+      string buf;
+      vector<BinexRecordView> views;
+      vector<string> messages;
+      BinexRecordScanner scanner;
+      BinexRecordView view;
+      for (size_t pos = 0; pos < stream.size(); pos += chunk)
+      {
+         buf.append(stream, pos, chunk);
+         bool last = (pos + chunk >= stream.size());
+         scanner.reset(buf.data(), buf.size(), last);
+         while (scanner.next(view))
+         {
+            views.push_back(view);
+            messages.push_back(string((const char*)view.message,
+                                      view.messageSize));
+         }
+         buf.erase(0, scanner.getOffset());
+      }
+      TUASSERTE(size_t, records.size(), views.size());
+      TUASSERTE(size_t, 0, buf.size());
+      TUASSERTE(size_t, 0, scanner.getSkipped());
+      unsigned bad = 0;
+      for (size_t i = 0; i < messages.size(); i++)
+         bad += (messages[i] != records[i].getMessageData());
+      TUASSERTE(unsigned, 0, bad);
+
+         // a truncated last record is left unconsumed while more
+         // data may follow, and skipped at the end of the data
+      string cut(stream, 0, stream.size() - 3);
+      BinexRecordScanner partial(cut.data(), cut.size(), false);
+      size_t n = 0;
+      while (partial.next(view))
+         n++;
+      TUASSERTE(size_t, records.size() - 1, n);
+      TUASSERTE(size_t, stream.size() - records.back().getRecordSize(),
+                partial.getOffset());
+      partial.reset(cut.data() + partial.getOffset(),
+                    cut.size() - partial.getOffset());
+      TUASSERT(!partial.next(view));
+      TUASSERTE(size_t, records.back().getRecordSize() - 3,
+                partial.getSkipped());
+
+      TURETURN();
+   }
+
+   vector<BinexData> records;
+   string stream;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   BinexRecordScanner_T testClass;
+
+   errorTotal += testClass.scanTest();
+   errorTotal += testClass.resyncTest();
+   errorTotal += testClass.streamTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,235 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "TestUtil.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsMappedReader_T
+{
+public:
+   Rinex3ObsMappedReader_T();
+
+      /// Compare every record against Rinex3ObsStream
+   unsigned compareTest();
+      /// Make sure satellites are not carried over between epochs
+   unsigned satChangeTest();
+      /// Make sure errors are reported and the reader can recover
+   unsigned errorTest();
+      /// Make sure RINEX 2 is rejected
+   unsigned versionTest();
+
+   void compareFile(TestUtil& testFramework, const std::string& fn);
+
+   std::string dataPath;
+};
+
+
+Rinex3ObsMappedReader_T ::
+Rinex3ObsMappedReader_T()
+{
+   dataPath = getPathData() + getFileSep();
+}
+
+
+void Rinex3ObsMappedReader_T ::
+compareFile(TestUtil& testFramework, const std::string& fn)
+{
+   Rinex3ObsStream strm(fn.c_str());
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData expRec, gotRec;
+   Rinex3ObsMappedReader rdr;
+   unsigned long count = 0;
+   TUCATCH(rdr.open(fn));
+   strm >> hdr;
+   TUASSERTE(int, hdr.mapObsTypes.size(), rdr.header.mapObsTypes.size());
+   TUASSERTE(TimeSystem, strm.timesystem, rdr.timesystem);
+   while (strm >> expRec)
+   {
+      bool rv = false;
+      TUCATCH(rv = rdr.getRecord(gotRec));
+      TUASSERT(rv);
+      if (!rv)
+         break;
+      count++;
+      TUASSERTE(CommonTime, expRec.time, gotRec.time);
+      TUASSERTE(short, expRec.epochFlag, gotRec.epochFlag);
+      TUASSERTE(short, expRec.numSVs, gotRec.numSVs);
+      TUASSERTFE(expRec.clockOffset, gotRec.clockOffset);
+      TUASSERTE(size_t, expRec.obs.size(), gotRec.obs.size());
+      Rinex3ObsData::DataMap::const_iterator ei, gi;
+      for (ei = expRec.obs.begin(), gi = gotRec.obs.begin();
+           ei != expRec.obs.end() && gi != gotRec.obs.end(); ++ei, ++gi)
+      {
+         TUASSERTE(RinexSatID, ei->first, gi->first);
+         TUASSERTE(size_t, ei->second.size(), gi->second.size());
+         for (unsigned i = 0; i < ei->second.size() && i < gi->second.size();
+              i++)
+         {
+            const RinexDatum& e(ei->second[i]);
+            const RinexDatum& g(gi->second[i]);
+               // exact equality is intended, both use strtod
+            TUASSERTE(double, e.data, g.data);
+            TUASSERTE(bool, e.dataBlank, g.dataBlank);
+            TUASSERTE(short, e.lli, g.lli);
+            TUASSERTE(bool, e.lliBlank, g.lliBlank);
+            TUASSERTE(short, e.ssi, g.ssi);
+            TUASSERTE(bool, e.ssiBlank, g.ssiBlank);
+         }
+      }
+   }
+   bool rv = true;
+   TUCATCH(rv = rdr.getRecord(gotRec));
+   TUASSERTE(bool, false, rv);
+   TUASSERT(count > 0);
+      // rewinding must give the first record again
+   strm.close();
+   Rinex3ObsStream strm2(fn.c_str());
+   strm2 >> hdr;
+   strm2 >> expRec;
+   rdr.rewind();
+   TUCATCH(rdr.getRecord(gotRec));
+   TUASSERTE(CommonTime, expRec.time, gotRec.time);
+   TUASSERTE(size_t, expRec.obs.size(), gotRec.obs.size());
+}
+
+
+unsigned Rinex3ObsMappedReader_T ::
+compareTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "getRecord");
+   compareFile(testFramework, dataPath + "test_input_rinex3_obs_RinexObsFile.15o");
+   compareFile(testFramework, dataPath + "test_input_rinex3_76193040.14o");
+   compareFile(testFramework, dataPath + "test_input_rinex3_obs_SystemMixed.15o");
+   compareFile(testFramework, dataPath + "inputs" + getFileSep() + "igs" +
+               getFileSep() + "nrmg0150.16o");
+   compareFile(testFramework, dataPath + "inputs" + getFileSep() + "igs" +
+               getFileSep() + "solo0150.16o");
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsMappedReader_T ::
+satChangeTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "getRecord");
+      // Epochs with the same number of satellites as the one before
+      // but a different set, including one listing a satellite twice.
+   string fn = getPathTestTemp() + getFileSep() +
+      "test_output_rinex3_obs_SatChange.14o";
+   ifstream in((dataPath + "test_input_rinex3_76193040.14o").c_str());
+   ofstream out(fn.c_str());
+   string line;
+   while (getline(in, line))
+   {
+      out << line << endl;
+      if (line.find("END OF HEADER") != string::npos)
+         break;
+   }
+   const char *obs = "  23448820.047 5              "
+      "                                    123224404.83915";
+   out << "> 2014 10 31 20 28  0.0000000  0  2" << endl
+       << "G05" << obs << endl
+       << "G15" << obs << endl
+       << "> 2014 10 31 20 28 15.0000000  0  2" << endl
+       << "G05" << obs << endl
+       << "G20" << obs << endl
+       << "> 2014 10 31 20 28 30.0000000  0  2" << endl
+       << "G05" << obs << endl
+       << "G05" << obs << endl;
+   out.close();
+   compareFile(testFramework, fn);
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsMappedReader_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "getRecord");
+   Rinex3ObsData rod;
+   Rinex3ObsMappedReader rdr(dataPath + "test_input_rinex3_obs_BadEpochFlag.15o");
+   bool sawError = false;
+   try
+   {
+      while (rdr.getRecord(rod))
+         ;
+   }
+   catch (FFStreamError& exc)
+   {
+      sawError = true;
+   }
+   TUASSERT(sawError);
+      // the reader stays at the bad record
+   TUTHROW(rdr.getRecord(rod));
+   TUTHROW(rdr.open(dataPath + "test_input_rinex3_obs_IncompleteHeader.15o"));
+   TUTHROW(rdr.open(dataPath + "no_such_file.15o"));
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsMappedReader_T ::
+versionTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "open");
+   Rinex3ObsMappedReader rdr;
+   TUTHROW(rdr.open(dataPath + "arlm200a.15o"));
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsMappedReader_T testClass;
+
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.satChangeTest();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.versionTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,146 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "CRC24Q.hpp"
+#include "TestUtil.hpp"
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace gpstk;
+
+class CRC24Q_T
+{
+public:
+      /// The CRC one bit at a time, from the definition.
+   static uint32_t bitwise(const vector<bool>& bits)
+   {
+      uint32_t crc = 0;
+      for (size_t i = 0; i < bits.size(); i++)
+      {
+         bool msb = ((crc >> 23) & 1) != bits[i];
+         crc = (crc << 1) & 0xffffff;
+         if (msb)
+            crc ^= CRC24Q::POLY;
+      }
+      return crc;
+   }
+
+   unsigned computeTest()
+   {
+      TUDEF("CRC24Q", "compute");
+
+         // the standard check value for this CRC (also known as
+         // CRC-24/LTE-A)
+      const char check[] = "123456789";
+      TUASSERTE(uint32_t, 0xcde703,
+                CRC24Q::compute(reinterpret_cast<const uint8_t*>(check), 9));
+      TUASSERTE(uint32_t, 0, CRC24Q::compute(NULL, 0));
+
+         // every length up to a few words, whole or in two pieces
+      vector<uint8_t> data(40);
+      uint64_t seed = 42;
+      for (size_t i = 0; i < data.size(); i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         data[i] = seed >> 56;
+      }
+      unsigned failures = 0, pieceFailures = 0;
+      for (size_t n = 0; n <= data.size(); n++)
+      {
+         vector<bool> bits;
+         for (size_t i = 0; i < n*8; i++)
+            bits.push_back((data[i/8] >> (7 - i%8)) & 1);
+         uint32_t crc = CRC24Q::compute(&data[0], n);
+         failures += (crc != bitwise(bits));
+         size_t half = n / 2;
+         pieceFailures += (crc != CRC24Q::compute(&data[half], n - half,
+                                                  CRC24Q::compute(&data[0],
+                                                                  half)));
+      }
+      TUASSERTE(unsigned, 0, failures);
+      TUASSERTE(unsigned, 0, pieceFailures);
+
+      TURETURN();
+   }
+
+   unsigned computeBitsTest()
+   {
+      TUDEF("CRC24Q", "computeBits");
+
+      vector<uint64_t> words(6);
+      vector<bool> bits;
+      uint64_t seed = 7;
+      for (size_t i = 0; i < words.size(); i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         words[i] = seed;
+         for (int b = 63; b >= 0; b--)
+            bits.push_back((seed >> b) & 1);
+      }
+      unsigned failures = 0;
+      for (size_t n = 0; n <= bits.size(); n++)
+      {
+         vector<bool> first(bits.begin(), bits.begin() + n);
+         failures += (CRC24Q::computeBits(&words[0], n) != bitwise(first));
+      }
+      TUASSERTE(unsigned, 0, failures);
+
+         // appending the CRC gives a CRC of 0
+      uint32_t crc = CRC24Q::computeBits(&words[0], 276);
+      words[4] &= ~(0xffffffULL << 20);
+      words[4] |= static_cast<uint64_t>(crc) << 20;
+      TUASSERTE(uint32_t, 0, CRC24Q::computeBits(&words[0], 300));
+
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   CRC24Q_T testClass;
+
+   errorTotal += testClass.computeTest();
+   errorTotal += testClass.computeBitsTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,324 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <set>
+#include <iostream>
+
+#include "ChebyshevEphemerisStore.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+class ChebyshevEphemerisStore_T
+{
+public:
+   ChebyshevEphemerisStore_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string fileSep = gpstk::getFileSep();
+      inputIGSData = dataFilePath + fileSep + "inputs" + fileSep + "igs"
+         + fileSep + "igr20354.sp3";
+      inputSP3cData = dataFilePath + fileSep + "test_input_SP3c.sp3";
+   }
+
+
+      /// Check the fit against the source store
+   unsigned fitTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "fit");
+
+      const std::string files[] = { inputIGSData, inputSP3cData };
+      for (unsigned f = 0; f < 2; f++)
+      {
+         SP3EphemerisStore sp3;
+         sp3.loadFile(files[f]);
+         sp3.setWindowCache(true);
+         ChebyshevEphemerisStore cheb;
+         TUCATCH(cheb.fit(sp3));
+
+         TUASSERTE(TimeSystem, sp3.getTimeSystem(), cheb.getTimeSystem());
+         TUASSERT(cheb.getIndexSet() == sp3.getIndexSet());
+         TUASSERT(cheb.hasVelocity());
+            // the source cannot interpolate near the ends of its data
+         TUASSERT(cheb.getInitialTime() >= sp3.getInitialTime());
+         TUASSERT(cheb.getInitialTime() < sp3.getInitialTime() + 7200.);
+         TUASSERT(cheb.getFinalTime() <= sp3.getFinalTime());
+         TUASSERT(cheb.getFinalTime() > sp3.getFinalTime() - 7200.);
+         TUASSERT(cheb.getMaxPositionError() <= cheb.getPositionTolerance());
+         TUASSERT(cheb.getMaxClockError() <= cheb.getClockTolerance());
+            // at most a quarter of the 24 values per record held by
+            // the SP3 store
+         TUASSERT(4*cheb.ncoefficients() < 24*sp3.ndata());
+
+         double maxdx = 0, maxdv = 0, maxdb = 0, maxdd = 0;
+         unsigned n = 0, nmissing = 0, nextra = 0;
+         vector<SatID> sats(sp3.getSatList());
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+            for (CommonTime t = sp3.getInitialTime();
+                 t <= sp3.getFinalTime(); t += 97.3)
+            {
+               Xvt a(sp3.computeXvt(sats[i], t));
+               Xvt b(cheb.computeXvt(sats[i], t));
+               bool ua(a.health == Xvt::HealthStatus::Unavailable);
+               bool ub(b.health == Xvt::HealthStatus::Unavailable);
+               if (ua && !ub)
+                  nextra++;
+                  // except for its first record, which the source
+                  // returns where it cannot interpolate
+               if (ub && !ua && t > sp3.getInitialTime())
+                  nmissing++;
+               if (ua || ub)
+                  continue;
+               n++;
+               TUASSERTE(Xvt::HealthStatus, a.health, b.health);
+               maxdx = std::max(maxdx, a.x.slantRange(b.x));
+               maxdv = std::max(maxdv, a.v.slantRange(b.v));
+               maxdb = std::max(maxdb, std::abs(a.clkbias - b.clkbias));
+               maxdd = std::max(maxdd, std::abs(a.clkdrift - b.clkdrift));
+               TUASSERTFEPS(a.relcorr, b.relcorr, 1.e-12);
+            }
+         }
+         TUASSERT(n > 1000);
+         TUASSERTE(unsigned, 0, nextra);
+         TUASSERTE(unsigned, 0, nmissing);
+         TUASSERT(maxdx <= cheb.getPositionTolerance());
+         TUASSERT(maxdv < 1.e-3);
+         TUASSERT(maxdb <= cheb.getClockTolerance());
+         TUASSERT(maxdd < 1.e-11);
+
+         SatID sat(sats[0]);
+         CommonTime tmid(cheb.getInitialTime() + 3600.);
+         TUCATCH(cheb.getXvt(sat, tmid));
+         TUTHROW(cheb.getXvt(SatID(32,SatelliteSystem::Glonass), tmid));
+         TUTHROW(cheb.getXvt(sat, cheb.getInitialTime() - 3600.));
+         TUTHROW(cheb.getXvt(sat, cheb.getFinalTime() + 3600.));
+         CommonTime tother(tmid);
+         tother.setTimeSystem(TimeSystem::UTC);
+         TUTHROW(cheb.getXvt(sat, tother));
+         TUASSERTE(Xvt::HealthStatus, Xvt::HealthStatus::Unused,
+                   cheb.getSVHealth(sat, tmid));
+         TUASSERTE(Xvt::HealthStatus, Xvt::HealthStatus::Unavailable,
+                   cheb.getSVHealth(sat, cheb.getFinalTime() + 3600.));
+      }
+
+      TURETURN();
+   }
+
+
+      /// Check the parameters of the fit
+   unsigned parameterTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "setPositionTolerance");
+
+      SP3EphemerisStore sp3;
+      sp3.loadFile(inputIGSData);
+      sp3.setWindowCache(true);
+
+      ChebyshevEphemerisStore cheb;
+      TUASSERTE(double, 14400., cheb.getSpan());
+      TUASSERTE(int, 16, cheb.getMaxDegree());
+      TUTHROW(cheb.setMaxDegree(0));
+      TUTHROW(cheb.setMaxDegree(ChebyshevEphemerisStore::MAX_DEGREE+1));
+      TUTHROW(cheb.setSpan(0.));
+      cheb.setPositionTolerance(0.);
+      TUTHROW(cheb.fit(sp3));
+      cheb.setPositionTolerance(0.001);
+      TUCATCH(cheb.fit(sp3));
+      TUTHROW(cheb.setSpan(7200.));
+
+         // a looser bound needs fewer coefficients
+      ChebyshevEphemerisStore loose;
+      loose.setPositionTolerance(0.01);
+      loose.setClockTolerance(1.e-10);
+      TUCATCH(loose.fit(sp3));
+      TUASSERT(loose.ncoefficients() < cheb.ncoefficients());
+      TUASSERT(loose.getMaxPositionError() > cheb.getMaxPositionError());
+
+         // loadFiles() is fit() of the loaded files
+      ChebyshevEphemerisStore loaded;
+      TUCATCH(loaded.loadFiles(vector<string>(1, inputIGSData)));
+      TUASSERTE(unsigned long, cheb.nsegments(), loaded.nsegments());
+      TUASSERTE(unsigned long, cheb.ncoefficients(), loaded.ncoefficients());
+      TUTHROW(loaded.loadFiles(vector<string>(1, "no_such_file.sp3")));
+
+      TURETURN();
+   }
+
+
+      /// Check fitting in pieces, edit() and clear()
+   unsigned editTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "edit");
+
+      SP3EphemerisStore sp3;
+      sp3.loadFile(inputIGSData);
+      sp3.setWindowCache(true);
+      ChebyshevEphemerisStore whole, pieces;
+      whole.fit(sp3);
+
+         // fit the afternoon, then the morning, then refit the middle;
+         // the pieces meet at a time which is not on a block boundary
+      CommonTime tmid(sp3.getInitialTime() + 43200. + 1234.);
+      pieces.fit(sp3, tmid, CommonTime::END_OF_TIME);
+      TUASSERT(pieces.getInitialTime() >= tmid);
+      pieces.fit(sp3, CommonTime::BEGINNING_OF_TIME, tmid);
+      pieces.fit(sp3, tmid - 3000., tmid + 3000.);
+      TUASSERTE(CommonTime, whole.getInitialTime(), pieces.getInitialTime());
+      TUASSERTE(CommonTime, whole.getFinalTime(), pieces.getFinalTime());
+
+      set<SatID> sats(whole.getIndexSet());
+      unsigned bad = 0;
+      for (set<SatID>::const_iterator it = sats.begin(); it != sats.end(); ++it)
+      {
+         for (CommonTime t = whole.getInitialTime();
+              t <= whole.getFinalTime(); t += 301.)
+         {
+            Xvt a(whole.computeXvt(*it, t)), b(pieces.computeXvt(*it, t));
+            if (a.health != b.health)
+               bad++;
+            else if (a.health != Xvt::HealthStatus::Unavailable &&
+                     a.x.slantRange(b.x) > 2*whole.getPositionTolerance())
+               bad++;
+         }
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+         // keep segments that overlap the morning
+      SatID sat(*sats.begin());
+      CommonTime t0(whole.getInitialTime());
+      pieces.edit(t0, tmid);
+      TUASSERT(pieces.getFinalTime() >= tmid);
+      TUASSERT(pieces.getFinalTime() < tmid + whole.getSpan());
+      TUCATCH(pieces.getXvt(sat, t0 + 3600.));
+      TUTHROW(pieces.getXvt(sat, tmid + whole.getSpan()));
+      TUASSERT(pieces.nsegments() < whole.nsegments());
+
+      pieces.edit(CommonTime::END_OF_TIME - 86400.);
+      TUASSERT(pieces.getIndexSet().empty());
+      TUTHROW(pieces.getInitialTime());
+      whole.clear();
+      TUASSERTE(unsigned long, 0, whole.nsegments());
+      TUASSERTE(double, 0., whole.getMaxPositionError());
+      TUTHROW(whole.getFinalTime());
+      TUASSERT(!whole.isPresent(sat));
+
+      TURETURN();
+   }
+
+      /** Fit a store, then a second store whose data overlap only
+       * part of the first; the data of the first outside the second
+       * must be kept. */
+   unsigned overlapTest()
+   {
+      TUDEF("ChebyshevEphemerisStore", "fit overlapping");
+
+      SP3EphemerisStore sp3, part;
+      sp3.loadFile(inputIGSData);
+      sp3.setWindowCache(true);
+      part.loadFile(inputIGSData);
+      part.setWindowCache(true);
+         // ends that are not on block or segment boundaries
+      CommonTime tb(sp3.getInitialTime() + 20700.),
+         te(sp3.getInitialTime() + 50400.);
+      part.edit(tb, te);
+
+      ChebyshevEphemerisStore whole, both;
+      whole.fit(sp3);
+      both.fit(sp3);
+      both.fit(part);
+      TUASSERTE(CommonTime, whole.getInitialTime(), both.getInitialTime());
+      TUASSERTE(CommonTime, whole.getFinalTime(), both.getFinalTime());
+      TUASSERT(both.getMaxPositionError() <= both.getPositionTolerance());
+
+      set<SatID> sats(whole.getIndexSet());
+      unsigned bad = 0, n = 0;
+      double maxdx = 0.;
+      for (set<SatID>::const_iterator it = sats.begin(); it != sats.end(); ++it)
+      {
+         for (CommonTime t = whole.getInitialTime();
+              t <= whole.getFinalTime(); t += 97.3)
+         {
+            Xvt a(sp3.computeXvt(*it, t)), b(both.computeXvt(*it, t));
+            bool uw(whole.computeXvt(*it, t).health ==
+                    Xvt::HealthStatus::Unavailable);
+            bool ub(b.health == Xvt::HealthStatus::Unavailable);
+               // both covers exactly what whole covers
+            if (uw != ub)
+               bad++;
+            if (uw || ub)
+               continue;
+            n++;
+            maxdx = std::max(maxdx, a.x.slantRange(b.x));
+         }
+      }
+      TUASSERT(n > 1000);
+      TUASSERTE(unsigned, 0, bad);
+      TUASSERT(maxdx <= both.getPositionTolerance());
+
+      TURETURN();
+   }
+
+private:
+   std::string inputIGSData;
+   std::string inputSP3cData;
+};
+
+
+int main()
+{
+   ChebyshevEphemerisStore_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.fitTest();
+   errorTotal += testClass.parameterTest();
+   errorTotal += testClass.editTest();
+   errorTotal += testClass.overlapTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
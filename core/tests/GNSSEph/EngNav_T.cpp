@@ -41,6 +41,7 @@
 #include "TimeString.hpp"
 #include "GPSWeekSecond.hpp"
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -178,6 +179,59 @@ public:
       testFramework.assert(gpstk::EngNav::checkParity(subframe3P, false),
                            testMesg, __LINE__);
 
+         // the same subframes, and a bad one, as one buffer
+      TUCSM("checkParity(buffer)");
+      uint32_t buffer[40];
+      std::copy(subframe1P, subframe1P+10, buffer);
+      std::copy(subframe2P, subframe2P+10, buffer+10);
+      std::copy(subframe3P, subframe3P+10, buffer+20);
+      std::copy(subframe3P, subframe3P+10, buffer+30);
+      buffer[35] ^= 0x00100000;
+      bool valid[4];
+      TUASSERTE(size_t, 3, gpstk::EngNav::checkParity(buffer, 4, valid, false));
+      TUASSERT(valid[0]);
+      TUASSERT(valid[1]);
+      TUASSERT(valid[2]);
+      TUASSERT(!valid[3]);
+
+      TURETURN();
+   }
+
+
+      /** Compare computeParity, which uses tables, with the
+       * definition of the parity in IS-GPS-200 table 20-XIV. */
+   unsigned parityTableTest(void)
+   {
+      TUDEF("EngNav", "Compute Parity");
+
+      const uint32_t bmask[6] = { 0x3B1F3480, 0x1D8F9A40, 0x2EC7CD00,
+                                  0x1763E680, 0x2BB1F340, 0x0B7A89C0 };
+      const unsigned prev[6] = { 29, 30, 29, 30, 30, 29 };
+      uint64_t seed = 12345;
+      unsigned failures = 0;
+      for (unsigned n = 0; n < 100000; n++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         uint32_t word = (seed >> 34) & 0x3fffffff;
+         uint32_t pword = (seed >> 4) & 0x3fffffff;
+         bool upright = (n & 1) != 0;
+         uint32_t d = word;
+         if ((pword & 1) && !upright)
+            d = ~d;
+         uint32_t expected = 0;
+         for (unsigned i = 0; i < 6; i++)
+         {
+            unsigned dstar = (prev[i] == 29) ? ((pword >> 1) & 1) : (pword & 1);
+            unsigned ones = dstar;
+            for (unsigned bit = 0; bit < 32; bit++)
+               ones += (bmask[i] & d) >> bit & 1;
+            expected |= (ones & 1) << (5-i);
+         }
+         failures += (gpstk::EngNav::computeParity(word, pword, upright) !=
+                      expected);
+      }
+      TUASSERTE(unsigned, 0, failures);
+
       TURETURN();
    }
 
@@ -454,6 +508,7 @@ int main() //Main function to initialize and run all tests above
    errorTotal += testClass.getHOWTimeTest();
    errorTotal += testClass.getSFIDTest();
    errorTotal += testClass.checkParityTest();
+   errorTotal += testClass.parityTableTest();
    errorTotal += testClass.getSubframePatternTest();
    errorTotal += testClass.subframeConvertTest();
    errorTotal += testClass.nmctValidityTest();
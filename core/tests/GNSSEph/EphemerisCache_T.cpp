@@ -0,0 +1,312 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "EphemerisCache.hpp"
+#include "GPSEphemerisStore.hpp"
+#include "GPSEphemeris.hpp"
+#include "GalEphemeris.hpp"
+#include "BDSEphemeris.hpp"
+#include "RinexNavStream.hpp"
+#include "RinexNavHeader.hpp"
+#include "RinexNavData.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+class EphemerisCache_T
+{
+public:
+   EphemerisCache_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string tempFilePath = gpstk::getPathTestTemp();
+      std::string fileSep = gpstk::getFileSep();
+      inputNavData = dataFilePath + fileSep + "arlm200b.15n";
+      inputSP3Data = dataFilePath + fileSep + "inputs" + fileSep + "igs"
+         + fileSep + "igr20354.sp3";
+      copySP3Data = tempFilePath + fileSep + "test_output_EphemerisCache.sp3";
+      cacheFile = tempFilePath + fileSep + "test_output_EphemerisCache.bin";
+   }
+
+
+      /// Load a RINEX navigation file into a store.
+   void loadNav(GPSEphemerisStore& store, const string& file)
+   {
+      RinexNavStream strm(file.c_str(), ios::in);
+      RinexNavHeader hdr;
+      RinexNavData rnd;
+      strm >> hdr;
+      while (strm >> rnd)
+         store.addEphemeris(GPSEphemeris(rnd));
+   }
+
+
+      /// Copy a file, byte for byte.
+   void copyFile(const string& from, const string& to)
+   {
+      ifstream ifs(from.c_str(), ios::binary);
+      ofstream ofs(to.c_str(), ios::binary);
+      ofs << ifs.rdbuf();
+   }
+
+
+      /// Save and restore a GPSEphemerisStore, with other OrbitEph types
+   unsigned orbitEphTest()
+   {
+      TUDEF("EphemerisCache", "OrbitEphStore");
+
+      GPSEphemerisStore store;
+      loadNav(store, inputNavData);
+      vector<string> sources(1, inputNavData);
+
+         // one of each of the other types, with the GPS orbit
+      const GPSEphemeris *gps = dynamic_cast<const GPSEphemeris*>(
+         store.getTimeOrbitEphMap(SatID(1,SatelliteSystem::GPS)).begin()->second);
+      TUASSERT(gps != NULL);
+      GalEphemeris gal;
+      static_cast<OrbitEph&>(gal) = *gps;
+      gal.satID = SatID(11, SatelliteSystem::Galileo);
+      gal.IODnav = 77;
+      gal.health = Xvt::Degraded;
+      gal.Tgdb = 1.25e-9;
+      store.OrbitEphStore::addEphemeris(&gal);
+      BDSEphemeris bds;
+      static_cast<OrbitEph&>(bds) = *gps;
+      bds.satID = SatID(6, SatelliteSystem::BeiDou);
+      bds.Tgd23 = -2.5e-9;
+      store.OrbitEphStore::addEphemeris(&bds);
+
+      TUCATCH(EphemerisCache::write(cacheFile, store, sources));
+
+      GPSEphemerisStore copy;
+      TUASSERT(EphemerisCache::read(cacheFile, copy, sources));
+      TUASSERTE(unsigned, store.size(), copy.size());
+      TUASSERT(store.getIndexSet() == copy.getIndexSet());
+      TUASSERTE(CommonTime, store.getInitialTime(), copy.getInitialTime());
+      TUASSERTE(CommonTime, store.getFinalTime(), copy.getFinalTime());
+
+      set<SatID> sats(store.getIndexSet());
+      for (set<SatID>::const_iterator sit = sats.begin(); sit != sats.end();
+           ++sit)
+      {
+         const OrbitEphStore::TimeOrbitEphTable&
+            a(store.getTimeOrbitEphMap(*sit)), b(copy.getTimeOrbitEphMap(*sit));
+         TUASSERTE(unsigned, a.size(), b.size());
+         OrbitEphStore::TimeOrbitEphTable::const_iterator ia, ib;
+         for (ia = a.begin(), ib = b.begin(); ia != a.end() && ib != b.end();
+              ++ia, ++ib)
+         {
+            TUASSERTE(CommonTime, ia->first, ib->first);
+            TUASSERTE(string, ia->second->getName(), ib->second->getName());
+               // the text form includes every member
+            TUASSERTE(string, ia->second->asString(), ib->second->asString());
+            Xvt xa(ia->second->svXvt(ia->second->ctToe + 100.));
+            Xvt xb(ib->second->svXvt(ib->second->ctToe + 100.));
+            TUASSERTE(double, xa.x[0], xb.x[0]);
+            TUASSERTE(double, xa.clkbias, xb.clkbias);
+         }
+      }
+
+      const GalEphemeris *pgal = dynamic_cast<const GalEphemeris*>(
+         copy.findNearOrbitEph(gal.satID, gal.ctToe));
+      TUASSERT(pgal != NULL);
+      if (pgal != NULL)
+      {
+         TUASSERTE(short, 77, pgal->IODnav);
+         TUASSERTE(Xvt::HealthStatus, Xvt::Degraded, pgal->health);
+         TUASSERTE(double, 1.25e-9, pgal->Tgdb);
+      }
+      const BDSEphemeris *pbds = dynamic_cast<const BDSEphemeris*>(
+         copy.findNearOrbitEph(bds.satID, bds.ctToe));
+      TUASSERT(pbds != NULL);
+      if (pbds != NULL)
+         TUASSERTE(double, -2.5e-9, pbds->Tgd23);
+
+      std::remove(cacheFile.c_str());
+      TURETURN();
+   }
+
+
+      /// Save and restore an SP3EphemerisStore
+   unsigned sp3Test()
+   {
+      TUDEF("EphemerisCache", "SP3EphemerisStore");
+
+      SP3EphemerisStore store;
+      store.loadSP3File(inputSP3Data);
+      vector<string> sources(1, inputSP3Data);
+      TUCATCH(EphemerisCache::write(cacheFile, store));
+
+      SP3EphemerisStore copy;
+      TUASSERT(EphemerisCache::read(cacheFile, copy, sources));
+      TUASSERTE(int, store.ndata(), copy.ndata());
+      TUASSERTE(int, store.nfiles(), copy.nfiles());
+      TUASSERTE(TimeSystem, store.getTimeSystem(), copy.getTimeSystem());
+      TUASSERTE(CommonTime, store.getInitialTime(), copy.getInitialTime());
+      TUASSERTE(CommonTime, store.getFinalTime(), copy.getFinalTime());
+      TUASSERTE(bool, store.hasVelocity(), copy.hasVelocity());
+      TUASSERT(store.getIndexSet() == copy.getIndexSet());
+
+      vector<SatID> sats(store.getSatList());
+      for (unsigned i = 0; i < sats.size(); i++)
+      {
+         for (CommonTime t = store.getInitialTime() + 3600.;
+              t < store.getFinalTime() - 3600.; t += 1234.5)
+         {
+            Xvt a(store.computeXvt(sats[i], t));
+            Xvt b(copy.computeXvt(sats[i], t));
+            TUASSERTE(Xvt::HealthStatus, a.health, b.health);
+            TUASSERTE(double, a.x[0], b.x[0]);
+            TUASSERTE(double, a.x[2], b.x[2]);
+            TUASSERTE(double, a.v[1], b.v[1]);
+            TUASSERTE(double, a.clkbias, b.clkbias);
+            TUASSERTE(double, a.clkdrift, b.clkdrift);
+         }
+      }
+
+         // a second read would load the file twice
+      TUASSERT(!EphemerisCache::read(cacheFile, copy, sources));
+
+      std::remove(cacheFile.c_str());
+      TURETURN();
+   }
+
+
+      /// A stale or damaged cache is not used, and the store is unchanged
+   unsigned staleTest()
+   {
+      TUDEF("EphemerisCache", "read");
+
+      copyFile(inputSP3Data, copySP3Data);
+      vector<string> sources(1, copySP3Data);
+      SP3EphemerisStore store;
+      store.loadSP3File(copySP3Data);
+
+      SP3EphemerisStore copy;
+      std::remove(cacheFile.c_str());
+      TUASSERT(!EphemerisCache::read(cacheFile, copy, sources));
+      TUCATCH(EphemerisCache::write(cacheFile, store));
+
+         // wrong sources
+      TUASSERT(!EphemerisCache::read(cacheFile, copy,
+                                     vector<string>(1, inputSP3Data)));
+      TUASSERT(!EphemerisCache::read(cacheFile, copy, vector<string>()));
+         // wrong kind of store
+      GPSEphemerisStore orbit;
+      TUASSERT(!EphemerisCache::read(cacheFile, orbit, sources));
+         // different settings
+      copy.rejectPredPositions(true);
+      TUASSERT(!EphemerisCache::read(cacheFile, copy, sources));
+      copy.rejectPredPositions(false);
+      TUASSERTE(int, 0, copy.ndata());
+
+         // damaged cache: flip one bit in the data
+      string contents;
+      {
+         ifstream ifs(cacheFile.c_str(), ios::binary);
+         contents.assign(istreambuf_iterator<char>(ifs),
+                         istreambuf_iterator<char>());
+      }
+      string damaged(contents);
+      damaged[damaged.size()/2] ^= 0x10;
+      {
+         ofstream ofs(cacheFile.c_str(), ios::binary);
+         ofs << damaged;
+      }
+      TUASSERT(!EphemerisCache::read(cacheFile, copy, sources));
+      {
+         ofstream ofs(cacheFile.c_str(), ios::binary);
+         ofs << contents.substr(0, contents.size()-100);
+      }
+      TUASSERT(!EphemerisCache::read(cacheFile, copy, sources));
+      TUASSERTE(int, 0, copy.ndata());
+
+         // restored, it is good
+      {
+         ofstream ofs(cacheFile.c_str(), ios::binary);
+         ofs << contents;
+      }
+      TUASSERT(EphemerisCache::read(cacheFile, copy, sources));
+      TUASSERTE(int, store.ndata(), copy.ndata());
+
+         // modified source
+      {
+         ofstream ofs(copySP3Data.c_str(), ios::binary | ios::app);
+         ofs << "\n";
+      }
+      SP3EphemerisStore other;
+      TUASSERT(!EphemerisCache::read(cacheFile, other, sources));
+      TUASSERTE(int, 0, other.ndata());
+
+      std::remove(cacheFile.c_str());
+      std::remove(copySP3Data.c_str());
+      TURETURN();
+   }
+
+
+private:
+   std::string inputNavData;
+   std::string inputSP3Data;
+   std::string copySP3Data;
+   std::string cacheFile;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   EphemerisCache_T testClass;
+
+   errorTotal += testClass.orbitEphTest();
+   errorTotal += testClass.sp3Test();
+   errorTotal += testClass.staleTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
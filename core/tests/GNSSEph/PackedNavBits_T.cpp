@@ -64,6 +64,8 @@ public:
    unsigned realDataTest();
    unsigned equalityTest();
    unsigned ancillaryMethods();
+   unsigned wordBoundaryTest();
+   unsigned crc24qTest();
 
    double eps; 
 };
@@ -836,6 +838,131 @@ ancillaryMethods()
    TURETURN();
 }
 
+   // Fields of every width at every offset around the 64-bit word
+   // boundaries of the storage, checked against getBits( ) one bit at
+   // a time.
+unsigned PackedNavBits_T::
+wordBoundaryTest()
+{
+   TUDEF("PackedNavBits", "word boundaries");
+
+   SatID satID(1, SatelliteSystem::GPS);
+   ObsID obsID( ObservationType::NavMsg, CarrierBand::L2, TrackingCode::L2CML );
+   CommonTime ct = CivilTime( 2011, 6, 2, 12, 14, 44.0, TimeSystem::GPS );
+
+      // A pattern with no repeats at a period of 64
+   PackedNavBits pnb(satID,obsID,ct);
+   uint64_t seed = 0x9E3779B97F4A7C15ULL;
+   for (int i=0; i<10; i++)
+   {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      pnb.addUnsignedLong((unsigned long)(seed >> 34), 30, 1);
+   }
+   pnb.trimsize();
+   TUASSERTE(size_t, 300, pnb.getNumBits());
+   vector<bool> bits = pnb.getBits();
+   TUASSERTE(size_t, 300, bits.size());
+
+   int failures = 0;
+   for (int start=50; start<140; start++)
+   {
+      for (int numBits=1; numBits<=32; numBits++)
+      {
+         unsigned long expected = 0;
+         for (int i=start; i<start+numBits; i++)
+            expected = (expected << 1) | (bits[i] ? 1 : 0);
+         if (pnb.asUnsignedLong(start, numBits, 1) != expected)
+            failures++;
+      }
+   }
+   TUASSERTE(int, 0, failures);
+
+      // Overwrite fields across a boundary and read them back
+   PackedNavBits copy(pnb);
+   copy.insertUnsignedLong(0x2AAAAAA, 60, 26, 1);
+   TUASSERTE(unsigned long, 0x2AAAAAA, copy.asUnsignedLong(60, 26, 1));
+   TUASSERTE(unsigned long, pnb.asUnsignedLong(0, 60, 1),
+             copy.asUnsignedLong(0, 60, 1));
+   TUASSERTE(unsigned long, pnb.asUnsignedLong(86, 30, 1),
+             copy.asUnsignedLong(86, 30, 1));
+   TUASSERTE(bool, false, copy.matchBits(pnb));
+   TUASSERTE(bool, true, copy.matchBits(pnb, 86, 299));
+   TUASSERTE(bool, true, copy.matchBits(pnb, 0, 59));
+
+      // Ordering and hash agree with the bits
+   copy.copyBits(pnb, 60, 85);
+   TUASSERTE(bool, true, copy.matchBits(pnb));
+   TUASSERTE(size_t, pnb.hash(), copy.hash());
+   TUASSERTE(bool, false, copy<pnb);
+   TUASSERTE(bool, false, pnb<copy);
+   copy.insertUnsignedLong(bits[299] ? 0 : 1, 299, 1, 1);
+   TUASSERTE(bool, bits[299], copy<pnb);
+   TUASSERTE(bool, !bits[299], pnb<copy);
+   TUASSERT(copy.hash() != pnb.hash());
+
+      // Inverting twice restores the bits; the bits past the end stay 0
+   copy = pnb;
+   copy.invert();
+   TUASSERTE(bool, !bits[123], copy.asBool(123));
+   copy.invert();
+   TUASSERTE(bool, true, copy.matchBits(pnb));
+   TUASSERTE(size_t, pnb.hash(), copy.hash());
+
+      // Appending at an odd offset
+   PackedNavBits joined(satID,obsID,ct);
+   joined.addUnsignedLong(5, 3, 1);
+   joined.addPackedNavBits(pnb);
+   joined.trimsize();
+   TUASSERTE(size_t, 303, joined.getNumBits());
+   TUASSERTE(unsigned long, 5, joined.asUnsignedLong(0, 3, 1));
+   TUASSERTE(unsigned long, pnb.asUnsignedLong(250, 50, 1),
+             joined.asUnsignedLong(253, 50, 1));
+
+   TURETURN();
+}
+
+unsigned PackedNavBits_T ::
+crc24qTest()
+{
+   TUDEF("PackedNavBits", "crc24q");
+
+   SatID satID(1, SatelliteSystem::GPS);
+   ObsID obsID( ObservationType::NavMsg, CarrierBand::L2, TrackingCode::L2CML );
+   CommonTime ct = CivilTime( 2011, 6, 2, 12, 14, 44.0, TimeSystem::GPS );
+
+      // A CNAV-sized message: 276 bits of data and a 24 bit CRC
+   PackedNavBits pnb(satID,obsID,ct);
+   uint64_t seed = 0x9E3779B97F4A7C15ULL;
+   for (int i=0; i<23; i++)
+   {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      pnb.addUnsignedLong((unsigned long)(seed >> 52), 12, 1);
+   }
+   pnb.trimsize();
+
+      // bit by bit, from the definition
+   uint32_t expected = 0;
+   for (size_t i=0; i<pnb.getNumBits(); i++)
+   {
+      bool msb = ((expected >> 23) & 1) != pnb.asBool(i);
+      expected = (expected << 1) & 0xffffff;
+      if (msb)
+         expected ^= 0x864cfb;
+   }
+   uint32_t crc = pnb.crc24q();
+   TUASSERTE(uint32_t, expected, crc);
+
+   pnb.addUnsignedLong(crc, 24, 1);
+   pnb.trimsize();
+   TUASSERTE(size_t, 300, pnb.getNumBits());
+   TUASSERTE(uint32_t, 0, pnb.crc24q());
+   pnb.insertUnsignedLong(pnb.asBool(150) ? 0 : 1, 150, 1, 1);
+   TUASSERT(pnb.crc24q() != 0);
+
+   TURETURN();
+}
+
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -846,6 +973,8 @@ int main()
    errorTotal += testClass.realDataTest();
    errorTotal += testClass.equalityTest();
    errorTotal += testClass.ancillaryMethods();
+   errorTotal += testClass.wordBoundaryTest();
+   errorTotal += testClass.crc24qTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
@@ -42,6 +42,10 @@
 #include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <future>
 
 #include "Xvt.hpp"
 #include "RinexEphemerisStore.hpp"
@@ -61,6 +65,60 @@ using namespace gpstk;
 using namespace std;
 
 
+   /// Expose the selection cache of OrbitEphStore to the tests
+class CacheTestStore : public RinexEphemerisStore
+{
+public:
+   const OrbitEph* findUncached(const SatID& sat, const CommonTime& t)
+   {
+      invalidateSelectionCache();
+      return findOrbitEph(sat, t);
+   }
+};
+
+
+   /// Look up the ephemerides of sats at times, for the thread test
+static void findAll(const OrbitEphStore *store, const vector<SatID> *sats,
+                    const vector<CommonTime> *times,
+                    vector<const OrbitEph*> *found)
+{
+   for (size_t i = 0; i < sats->size(); i++)
+   {
+      for (size_t j = 0; j < times->size(); j++)
+         found->push_back(store->findOrbitEph((*sats)[i], (*times)[j]));
+   }
+}
+
+
+   /** Look up the ephemerides of sats at times, in the order given by
+    * step, before and after the store is edited, for the thread test.
+    * The thread's cache is kept across the edit. */
+static void findAcrossEdit(const OrbitEphStore *store,
+                           const vector<SatID> *sats,
+                           const vector<CommonTime> *times, int step,
+                           vector<const OrbitEph*> *before,
+                           vector<const OrbitEph*> *after,
+                           promise<void> *done, shared_future<void> edited)
+{
+   size_t n = times->size();
+   for (int pass = 0; pass < 2; pass++)
+   {
+      vector<const OrbitEph*> *found = (pass == 0 ? before : after);
+      for (size_t k = 0; k < n; k++)
+      {
+         const CommonTime& t((*times)[(k * step) % n]);
+         for (size_t i = 0; i < sats->size(); i++)
+            found->push_back(store->findOrbitEph((*sats)[i], t));
+      }
+      if (pass == 0)
+      {
+         done->set_value();
+         edited.wait();
+      }
+   }
+}
+
+
 class RinexEphemerisStore_T
 {
 public:
@@ -561,6 +619,326 @@ public:
    }
 
 
+      /// Compare every field of two Xvt exactly
+   static bool sameXvt(const Xvt& a, const Xvt& b)
+   {
+      if (a.health != b.health)
+         return false;
+      if (a.health == Xvt::HealthStatus::Unavailable)
+         return true;
+      for (int i = 0; i < 3; i++)
+      {
+         if (a.x[i] != b.x[i] || a.v[i] != b.v[i])
+            return false;
+      }
+      return (a.clkbias == b.clkbias && a.clkdrift == b.clkdrift &&
+              a.relcorr == b.relcorr);
+   }
+
+
+      /** Verify that computeXvts() gives exactly the results of
+       * computeXvt(), for both search methods, with the times in
+       * order and out of order. */
+   unsigned computeXvtsTest()
+   {
+      TUDEF("OrbitEphStore", "computeXvts");
+
+      try
+      {
+         RinexEphemerisStore rinEphStore;
+         rinEphStore.loadFile(inputRinexNavData.c_str());
+
+         vector<SatID> sats;
+         for (int prn = 0; prn <= 33; prn++)
+            sats.push_back(SatID(prn,SatelliteSystem::GPS));
+         sats.push_back(SatID(1,SatelliteSystem::Galileo));
+
+            // 600s steps include the exact epochs of the ephemerides
+         CommonTime t0 = CivilTime(2006,1,30,22,0,0,TimeSystem::GPS);
+         vector<CommonTime> times;
+         for (int i = 0; i < 6*28; i++)
+            times.push_back(t0 + 600.0*i);
+         vector<CommonTime> shuffled(times.rbegin(), times.rend());
+         for (size_t i = 0; i+7 < shuffled.size(); i += 7)
+            std::swap(shuffled[i], shuffled[i+5]);
+
+         for (int method = 0; method < 2; method++)
+         {
+            if (method == 0)
+               rinEphStore.SearchUser();
+            else
+               rinEphStore.SearchNear();
+
+            for (int order = 0; order < 2; order++)
+            {
+               const vector<CommonTime>& tv(order == 0 ? times : shuffled);
+               vector<Xvt> xvts;
+               rinEphStore.computeXvts(sats, tv, xvts);
+               TUASSERTE(size_t, sats.size()*tv.size(), xvts.size());
+               if (xvts.size() != sats.size()*tv.size())
+                  continue;
+
+               unsigned bad = 0, healthy = 0, unavail = 0;
+               for (size_t i = 0; i < sats.size(); i++)
+               {
+                  for (size_t j = 0; j < tv.size(); j++)
+                  {
+                     Xvt rv = rinEphStore.computeXvt(sats[i], tv[j]);
+                     const Xvt& bv(xvts[i*tv.size()+j]);
+                     if (!sameXvt(rv, bv))
+                        bad++;
+                     if (bv.health == Xvt::HealthStatus::Healthy)
+                        healthy++;
+                     else if (bv.health == Xvt::HealthStatus::Unavailable)
+                        unavail++;
+                  }
+               }
+               TUASSERTE(unsigned, 0, bad);
+                  // make sure both outcomes were exercised
+               TUASSERT(healthy > 0);
+               TUASSERT(unavail > 0);
+            }
+         }
+
+            // the default implementation in XvtStore agrees as well
+         vector<Xvt> xvts, dxvts;
+         rinEphStore.computeXvts(sats, times, xvts);
+         rinEphStore.XvtStore<SatID>::computeXvts(sats, times, dxvts);
+         TUASSERTE(size_t, xvts.size(), dxvts.size());
+         unsigned bad = 0;
+         for (size_t i = 0; i < xvts.size() && i < dxvts.size(); i++)
+         {
+            if (!sameXvt(xvts[i], dxvts[i]))
+               bad++;
+         }
+         TUASSERTE(unsigned, 0, bad);
+
+            // empty input gives empty output
+         rinEphStore.computeXvts(vector<SatID>(), times, xvts);
+         TUASSERTE(size_t, 0, xvts.size());
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Verify that the ephemeris selection cache gives the same
+       * choices as an uncached search, for both search methods, and
+       * that it counts hits and misses. */
+   unsigned selectionCacheTest()
+   {
+      TUDEF("OrbitEphStore", "findOrbitEph cache");
+
+      try
+      {
+         vector<SatID> sats;
+         for (int prn = 0; prn <= 33; prn++)
+            sats.push_back(SatID(prn,SatelliteSystem::GPS));
+
+         CommonTime t0 = CivilTime(2006,1,30,22,0,0,TimeSystem::GPS);
+         vector<CommonTime> times;
+         for (int i = 0; i < 4*28; i++)
+            times.push_back(t0 + 900.0*i);
+            // backwards, and an exact key
+         for (int i = 4*28-1; i >= 0; i -= 3)
+            times.push_back(t0 + 900.0*i + 1.0);
+         times.push_back(CivilTime(2006,1,31,12,0,0,TimeSystem::GPS));
+
+         for (int method = 0; method < 2; method++)
+         {
+            CacheTestStore cached, uncached;
+            if (method == 1)
+            {
+               cached.SearchNear();
+               uncached.SearchNear();
+            }
+            cached.loadFile(inputRinexNavData.c_str());
+            uncached.loadFile(inputRinexNavData.c_str());
+            TUASSERTE(unsigned long, 0, cached.getSelectionCacheHits());
+
+            unsigned bad = 0, nfound = 0;
+            for (size_t i = 0; i < sats.size(); i++)
+            {
+               for (size_t j = 0; j < times.size(); j++)
+               {
+                  const OrbitEph *a = cached.findOrbitEph(sats[i], times[j]);
+                  const OrbitEph *b = uncached.findUncached(sats[i], times[j]);
+                  if ((a == NULL) != (b == NULL))
+                     bad++;
+                  else if (a != NULL)
+                  {
+                     nfound++;
+                     if (a->beginValid != b->beginValid ||
+                         a->ctToe != b->ctToe)
+                        bad++;
+                  }
+               }
+            }
+            TUASSERTE(unsigned, 0, bad);
+            TUASSERT(nfound > 0);
+            TUASSERT(cached.getSelectionCacheHits() > 0);
+            TUASSERT(cached.getSelectionCacheMisses() > 0);
+            TUASSERTE(unsigned long, sats.size()*times.size(),
+                      cached.getSelectionCacheHits() +
+                      cached.getSelectionCacheMisses());
+
+               // repeating a time is always a hit
+            cached.resetSelectionCacheStats();
+            cached.findOrbitEph(sats[1], times[10]);
+            cached.findOrbitEph(sats[1], times[10]);
+            TUASSERTE(unsigned long, 1, cached.getSelectionCacheHits());
+
+               // adding data invalidates the cache
+            const OrbitEph *eph = cached.findOrbitEph(sats[1], times[10]);
+            TUASSERT(eph != NULL);
+            if (eph != NULL)
+               cached.OrbitEphStore::addEphemeris(eph);
+            cached.resetSelectionCacheStats();
+            cached.findOrbitEph(sats[1], times[10]);
+            TUASSERTE(unsigned long, 0, cached.getSelectionCacheHits());
+            TUASSERTE(unsigned long, 1, cached.getSelectionCacheMisses());
+
+               // concurrent readers make the same choices
+            const unsigned nthreads = 4;
+            vector< vector<const OrbitEph*> > found(nthreads);
+            vector<std::thread> threads;
+            for (unsigned k = 0; k < nthreads; k++)
+               threads.push_back(std::thread(findAll, &cached, &sats, &times,
+                                             &found[k]));
+            for (unsigned k = 0; k < nthreads; k++)
+               threads[k].join();
+            vector<const OrbitEph*> serial;
+            findAll(&cached, &sats, &times, &serial);
+            for (unsigned k = 0; k < nthreads; k++)
+               TUASSERT(found[k] == serial);
+         }
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Count the lookups in found, made in the order of
+       * findAcrossEdit(), that differ from an uncached search of store,
+       * and add the number found to nfound. */
+   unsigned compareFound(CacheTestStore& store, const vector<SatID>& sats,
+                         const vector<CommonTime>& times, int step,
+                         const vector<const OrbitEph*>& found,
+                         unsigned& nfound)
+   {
+      unsigned bad = 0;
+      size_t n = times.size(), m = 0;
+      for (size_t k = 0; k < n; k++)
+      {
+         const CommonTime& t(times[(k * step) % n]);
+         for (size_t i = 0; i < sats.size(); i++, m++)
+         {
+            const OrbitEph *a = found[m];
+            const OrbitEph *b = store.findUncached(sats[i], t);
+            if ((a == NULL) != (b == NULL))
+               bad++;
+            else if (a != NULL)
+            {
+               nfound++;
+               if (a->beginValid != b->beginValid || a->ctToe != b->ctToe)
+                  bad++;
+            }
+         }
+      }
+      return bad;
+   }
+
+
+      /** Verify that threads reading one store, each with its own
+       * order of times, make the same choices as an uncached search,
+       * and that an edit of the store is seen by the selection caches
+       * of threads that were reading it before. */
+   unsigned selectionCacheThreadTest()
+   {
+      TUDEF("OrbitEphStore", "findOrbitEph cache threads");
+
+      try
+      {
+         vector<SatID> sats;
+         for (int prn = 1; prn <= 32; prn++)
+            sats.push_back(SatID(prn,SatelliteSystem::GPS));
+
+         CommonTime t0 = CivilTime(2006,1,30,22,0,0,TimeSystem::GPS);
+         vector<CommonTime> times;
+         for (int i = 0; i < 28*60; i++)
+            times.push_back(t0 + 60.0*i);
+         CommonTime tmin = t0 + 6*3600.0, tmax = t0 + 20*3600.0;
+
+            // steps prime to the number of times, so each visits all
+         const int steps[] = { 1, 1679, 11, 601 };
+         const unsigned nthreads = sizeof(steps)/sizeof(steps[0]);
+
+         for (int method = 0; method < 2; method++)
+         {
+            CacheTestStore cached, uncached;
+            if (method == 1)
+            {
+               cached.SearchNear();
+               uncached.SearchNear();
+            }
+            cached.loadFile(inputRinexNavData.c_str());
+            uncached.loadFile(inputRinexNavData.c_str());
+
+            vector< vector<const OrbitEph*> > before(nthreads), after(nthreads);
+            vector< promise<void> > done(nthreads);
+            promise<void> edit;
+            shared_future<void> edited(edit.get_future().share());
+            vector<std::thread> threads;
+            for (unsigned k = 0; k < nthreads; k++)
+               threads.push_back(std::thread(findAcrossEdit, &cached, &sats,
+                                             &times, steps[k], &before[k],
+                                             &after[k], &done[k], edited));
+               // compare before the edit deletes OrbitEph found
+            unsigned bad = 0, nfound = 0, nlost = 0;
+            for (unsigned k = 0; k < nthreads; k++)
+            {
+               done[k].get_future().wait();
+               bad += compareFound(uncached, sats, times, steps[k], before[k],
+                                   nfound);
+            }
+            vector< vector<bool> > wasFound(nthreads);
+            for (unsigned k = 0; k < nthreads; k++)
+               for (size_t m = 0; m < before[k].size(); m++)
+                  wasFound[k].push_back(before[k][m] != NULL);
+
+            cached.edit(tmin, tmax);
+            uncached.edit(tmin, tmax);
+            edit.set_value();
+            for (unsigned k = 0; k < nthreads; k++)
+            {
+               threads[k].join();
+               bad += compareFound(uncached, sats, times, steps[k], after[k],
+                                   nfound);
+               for (size_t m = 0; m < after[k].size(); m++)
+                  if (wasFound[k][m] && after[k][m] == NULL)
+                     nlost++;
+            }
+            TUASSERTE(unsigned, 0, bad);
+            TUASSERT(nfound > 0);
+               // the edit removed ephemerides the threads had cached
+            TUASSERT(nlost > 0);
+            TUASSERT(cached.getSelectionCacheHits() > 0);
+         }
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
    unsigned getSVHealthTest()
    {
       TUDEF("OrbitEphStore", "getSVHealth");
@@ -1651,6 +2029,9 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.findEphTest();
    errorTotal += testClass.getXvtTest();
    errorTotal += testClass.computeXvtTest();
+   errorTotal += testClass.computeXvtsTest();
+   errorTotal += testClass.selectionCacheTest();
+   errorTotal += testClass.selectionCacheThreadTest();
    errorTotal += testClass.getSVHealthTest();
    errorTotal += testClass.dumpTest();
    errorTotal += testClass.addToListTest();
@@ -37,11 +37,14 @@
 //==============================================================================
 
 #include <list>
+#include <cmath>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
+#include <thread>
 
 #include "SatID.hpp"
 #include "Exception.hpp"
@@ -696,6 +699,426 @@ public:
       TURETURN();
    }
 
+//=============================================================================
+// Test for setFlatTables
+// Compares every lookup, including exact epochs, times between epochs and
+// times outside the data, using the flat tables against the maps
+//=============================================================================
+   unsigned windowCacheTest()
+   {
+      TUDEF("SP3EphemerisStore", "setWindowCache");
+
+      const std::string files[] = { inputSP3Data, inputAPCData,
+                                    inputSixNinesData };
+      for (unsigned f = 0; f < 3; f++)
+      {
+         SP3EphemerisStore mapStore, winStore;
+         TUCATCH(mapStore.loadFile(files[f]));
+         TUCATCH(winStore.loadFile(files[f]));
+         TUASSERTE(bool, false, winStore.usingWindowCache());
+         winStore.setWindowCache(true);
+         TUASSERTE(bool, true, winStore.usingWindowCache());
+            // the window cache works with the flat tables as well
+         SP3EphemerisStore flatStore(winStore);
+         TUASSERTE(bool, true, flatStore.usingWindowCache());
+         flatStore.setFlatTables(true);
+
+         std::vector<SatID> sats(mapStore.getSatList());
+         sats.push_back(SatID(32,SatelliteSystem::GPS));
+         CommonTime t0(mapStore.getInitialTime() - 3600.);
+         CommonTime t1(mapStore.getFinalTime() + 3600.);
+         unsigned nxvt(0), nthrow(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+               // step of 225s hits every epoch, and several times within
+               // each interval
+            for (CommonTime t = t0; t <= t1; t += 225.)
+            {
+               for (unsigned k = 0; k < 2; k++)
+               {
+                  const SP3EphemerisStore& store(k == 0 ? winStore : flatStore);
+                  Xvt xm, xw;
+                  bool mthrow(false), wthrow(false);
+                  try { xm = mapStore.getXvt(sats[i], t); }
+                  catch (InvalidRequest& e) { mthrow = true; }
+                  try { xw = store.getXvt(sats[i], t); }
+                  catch (InvalidRequest& e) { wthrow = true; }
+                  TUASSERTE(bool, mthrow, wthrow);
+                  if (mthrow || wthrow)
+                  {
+                     nthrow++;
+                     continue;
+                  }
+                  nxvt++;
+                     // the same polynomial, summed in a different order
+                  for (unsigned j = 0; j < 3; j++)
+                  {
+                     TUASSERTFEPS(xm.x[j], xw.x[j], 1.e-6);
+                     TUASSERTFEPS(xm.v[j], xw.v[j], 1.e-9);
+                  }
+                  TUASSERTFEPS(xm.clkbias, xw.clkbias, 1.e-16);
+                  TUASSERTFEPS(xm.clkdrift, xw.clkdrift, 1.e-19);
+               }
+            }
+         }
+         TUASSERT(nxvt > 0);
+         TUASSERT(nthrow > 0);
+         TUASSERT(winStore.getWindowCacheHits() > 0);
+         TUASSERT(winStore.getWindowCacheMisses() > 0);
+         TUASSERT(flatStore.getWindowCacheHits() > 0);
+
+            // data loaded after a lookup must be seen by the window cache
+         SP3EphemerisStore lateStore;
+         lateStore.setWindowCache(true);
+         TUTHROW(lateStore.getXvt(sats[0], mapStore.getInitialTime()));
+         TUCATCH(lateStore.loadFile(files[f]));
+         CommonTime tmid(t0 + (t1-t0)/2. + 100.);
+         Triple pm(mapStore.getPosition(sats[0], tmid)),
+            pw(lateStore.getPosition(sats[0], tmid));
+         for (unsigned j = 0; j < 3; j++)
+            TUASSERTFEPS(pm[j], pw[j], 1.e-6);
+      }
+
+      TURETURN();
+   }
+
+//=============================================================================
+// Test that ClockSatStore::getClockBias() and getClockDrift() give the same
+// results through the window cache, with and without drift data
+//=============================================================================
+   unsigned clockWindowTest()
+   {
+      TUDEF("ClockSatStore", "getClockBias");
+
+      const SatID sat(5,SatelliteSystem::GPS);
+      const CommonTime t0(CivilTime(2020,1,1,0,0,0,TimeSystem::GPS));
+      for (int withDrift = 0; withDrift < 2; withDrift++)
+      {
+         ClockSatStore tabStore, winStore;
+         for (int i = 0; i < 20; i++)
+         {
+            double dt(300. * i);
+            ClockRecord rec = { 1.e-4 + 2.e-9*dt + 3.e-14*dt*dt, 0.0,
+                                withDrift ? 2.e-9 + 6.e-14*dt : 0.0, 0.0,
+                                0.0, 0.0 };
+            tabStore.addClockRecord(sat, t0 + dt, rec);
+            winStore.addClockRecord(sat, t0 + dt, rec);
+         }
+         winStore.setWindowCache(true);
+
+            // between and on the records, away from the ends
+         unsigned n(0);
+         for (double dt = 1500.; dt <= 4200.; dt += 37.5, n++)
+         {
+            CommonTime t(t0 + dt);
+            TUASSERTFEPS(tabStore.getClockBias(sat, t),
+                         winStore.getClockBias(sat, t), 1.e-16);
+            TUASSERTFEPS(tabStore.getClockDrift(sat, t),
+                         winStore.getClockDrift(sat, t), 1.e-19);
+               // the records are exact for a quadratic
+            TUASSERTFEPS(2.e-9 + 6.e-14*dt, winStore.getClockDrift(sat, t),
+                         1.e-18);
+         }
+         TUASSERT(winStore.getWindowCacheHits() > n);
+         TUASSERTE(unsigned long, 0, tabStore.getWindowCacheHits());
+         TUTHROW(winStore.getClockBias(sat, t0 - 300.));
+         TUTHROW(winStore.getClockDrift(SatID(6,SatelliteSystem::GPS),
+                                        t0 + 1500.));
+      }
+
+      TURETURN();
+   }
+
+   /** Compute the Xvt of sats at times in the order given by step; where
+    * getXvt() throws, leave the default Xvt */
+   static void getXvtAll(const SP3EphemerisStore *store,
+                         const std::vector<SatID> *sats,
+                         const std::vector<CommonTime> *times, unsigned step,
+                         std::vector<Xvt> *xvts)
+   {
+      size_t n(times->size());
+      xvts->resize(n * sats->size());
+      for (size_t k = 0; k < n; k++)
+      {
+         size_t j((k * step) % n);
+         for (size_t i = 0; i < sats->size(); i++)
+         {
+            try
+            {
+               (*xvts)[j * sats->size() + i] = store->getXvt((*sats)[i],
+                                                            (*times)[j]);
+            }
+            catch (InvalidRequest& e) {}
+         }
+      }
+   }
+
+//=============================================================================
+// Test for setWindowCache with several threads reading one store
+// Each thread visits the times in its own order, so the threads' window
+// caches hold different windows
+//=============================================================================
+   unsigned windowCacheThreadTest()
+   {
+      TUDEF("SP3EphemerisStore", "setWindowCache threads");
+
+      SP3EphemerisStore mapStore, winStore;
+      TUCATCH(mapStore.loadFile(inputSP3Data));
+      TUCATCH(winStore.loadFile(inputSP3Data));
+      winStore.setWindowCache(true);
+
+      std::vector<SatID> sats(mapStore.getSatList());
+      std::vector<CommonTime> times;
+      CommonTime t0(mapStore.getInitialTime() + 3600.);
+      for (int i = 0; i < 720; i++)
+         times.push_back(t0 + 30.*i);
+
+      std::vector<Xvt> expect;
+      getXvtAll(&mapStore, &sats, &times, 1, &expect);
+
+         // steps prime to the number of times, so each visits all
+      const unsigned steps[] = { 1, 719, 7, 101 };
+      const unsigned nthreads(sizeof(steps)/sizeof(steps[0]));
+      std::vector< std::vector<Xvt> > got(nthreads);
+      std::vector<std::thread> threads;
+      for (unsigned k = 0; k < nthreads; k++)
+         threads.push_back(std::thread(getXvtAll, &winStore, &sats, &times,
+                                       steps[k], &got[k]));
+      for (unsigned k = 0; k < nthreads; k++)
+         threads[k].join();
+
+      unsigned bad(0);
+      for (unsigned k = 0; k < nthreads; k++)
+      {
+         TUASSERTE(size_t, expect.size(), got[k].size());
+         for (size_t m = 0; m < expect.size() && m < got[k].size(); m++)
+         {
+            for (unsigned j = 0; j < 3; j++)
+            {
+               if (std::fabs(expect[m].x[j] - got[k][m].x[j]) > 1.e-6 ||
+                   std::fabs(expect[m].v[j] - got[k][m].v[j]) > 1.e-9)
+                  bad++;
+            }
+            if (std::fabs(expect[m].clkbias - got[k][m].clkbias) > 1.e-16)
+               bad++;
+         }
+      }
+      TUASSERTE(unsigned, 0, bad);
+      TUASSERT(winStore.getWindowCacheHits() > 0);
+
+      TURETURN();
+   }
+
+   unsigned flatTablesTest()
+   {
+      TUDEF("SP3EphemerisStore", "setFlatTables");
+
+      const std::string files[] = { inputSP3Data, inputAPCData,
+                                    inputSixNinesData };
+      for (unsigned f = 0; f < 3; f++)
+      {
+         SP3EphemerisStore mapStore, flatStore;
+         TUCATCH(mapStore.loadFile(files[f]));
+         TUCATCH(flatStore.loadFile(files[f]));
+         TUASSERTE(bool, false, flatStore.usingFlatTables());
+         flatStore.setFlatTables(true);
+         TUASSERTE(bool, true, flatStore.usingFlatTables());
+            // a copy must rebuild its own flat tables
+         SP3EphemerisStore copyStore(flatStore);
+         TUASSERTE(bool, true, copyStore.usingFlatTables());
+
+         std::vector<SatID> sats(mapStore.getSatList());
+         sats.push_back(SatID(32,SatelliteSystem::GPS));
+         CommonTime t0(mapStore.getInitialTime() - 3600.);
+         CommonTime t1(mapStore.getFinalTime() + 3600.);
+         unsigned nxvt(0), nthrow(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+               // step of 450s hits every epoch as well as times between
+            for (CommonTime t = t0; t <= t1; t += 450.)
+            {
+               for (unsigned k = 0; k < 2; k++)
+               {
+                  const SP3EphemerisStore& store(k == 0 ? flatStore : copyStore);
+                  Xvt xm, xf;
+                  bool mthrow(false), fthrow(false);
+                  try { xm = mapStore.getXvt(sats[i], t); }
+                  catch (InvalidRequest& e) { mthrow = true; }
+                  try { xf = store.getXvt(sats[i], t); }
+                  catch (InvalidRequest& e) { fthrow = true; }
+                  TUASSERTE(bool, mthrow, fthrow);
+                  if (mthrow || fthrow)
+                  {
+                     nthrow++;
+                     continue;
+                  }
+                  nxvt++;
+                  TUASSERTE(Triple, xm.x, xf.x);
+                  TUASSERTE(Triple, xm.v, xf.v);
+                  TUASSERTE(double, xm.clkbias, xf.clkbias);
+                  TUASSERTE(double, xm.clkdrift, xf.clkdrift);
+               }
+            }
+         }
+         TUASSERT(nxvt > 0);
+         TUASSERT(nthrow > 0);
+
+            // data loaded after a lookup must be seen by the flat tables
+         SP3EphemerisStore lateStore;
+         lateStore.setFlatTables(true);
+         TUTHROW(lateStore.getXvt(sats[0], mapStore.getInitialTime()));
+         TUCATCH(lateStore.loadFile(files[f]));
+         CommonTime tmid(t0 + (t1-t0)/2. + 100.);
+         TUASSERTE(Triple, mapStore.getPosition(sats[0], tmid),
+                   lateStore.getPosition(sats[0], tmid));
+      }
+
+      TURETURN();
+   }
+
+      /** Verify that FlatDataTable finds what the std::map does when
+       * the times are not evenly spaced, so the search is on the
+       * CommonTimeKeys, including times within a picosecond of the
+       * records, where the keys are equal. */
+   unsigned flatTableSearchTest()
+   {
+      TUDEF("FlatDataTable", "lower_bound");
+
+      std::map<CommonTime, int> table;
+      CommonTime t0(CivilTime(2015,7,19,0,0,0.0,TimeSystem::GPS));
+      double dt(0.0);
+      for (int i = 0; i < 200; i++)
+      {
+         table[t0 + dt] = i;
+         dt += 30.0 + (i % 7) * 0.125 + 1.e-13 * (i % 3);
+      }
+      FlatDataTable<int> flat(table);
+      TUASSERTE(double, 0.0, flat.getStep());
+      TUASSERTE(size_t, table.size(), flat.size());
+
+      const double offsets[] = { -1.0, -4.e-13, -1.e-13, 0.0, 1.e-13,
+                                 4.e-13, 1.0 };
+      unsigned bad(0), ntest(0);
+      std::map<CommonTime, int>::const_iterator it;
+      for (it = table.begin(); it != table.end(); it++)
+      {
+         for (unsigned k = 0; k < sizeof(offsets)/sizeof(offsets[0]); k++)
+         {
+            CommonTime t(it->first + offsets[k]);
+            std::map<CommonTime, int>::const_iterator mlb(table.lower_bound(t));
+            FlatDataTable<int>::const_iterator flb(flat.lower_bound(t));
+            bad += ((mlb == table.end()) != (flb == flat.end()));
+            if (mlb != table.end() && flb != flat.end())
+               bad += (mlb->second != flb->second);
+            std::map<CommonTime, int>::const_iterator mf(table.find(t));
+            FlatDataTable<int>::const_iterator ff(flat.find(t));
+            bad += ((mf == table.end()) != (ff == flat.end()));
+            ntest++;
+         }
+      }
+      TUASSERT(ntest > 1000);
+      TUASSERTE(unsigned, 0, bad);
+         // before and after all the records
+      TUASSERTE(int, 0, flat.lower_bound(t0 - 100.)->second);
+      TUASSERT(flat.lower_bound(table.rbegin()->first + 1.) == flat.end());
+      TUASSERT(FlatDataTable<int>().lower_bound(t0) ==
+               FlatDataTable<int>().end());
+
+      TURETURN();
+   }
+
+      /** Verify that computeXvts() gives the results of computeXvt(),
+       * exactly with the window cache on and to within rounding with
+       * it off, including times outside the data; and that it reuses
+       * each satellite's interpolation windows over times given out
+       * of order. */
+   unsigned computeXvtsTest()
+   {
+      TUDEF("SP3EphemerisStore", "computeXvts");
+
+      SP3EphemerisStore store;
+      TUCATCH(store.loadFile(inputSP3Data));
+
+      std::vector<SatID> sats(store.getSatList());
+      sats.push_back(SatID(32,SatelliteSystem::GPS));
+      std::vector<CommonTime> times;
+      CommonTime t0(store.getInitialTime() - 3600.);
+      CommonTime t1(store.getFinalTime() + 3600.);
+      for (CommonTime t = t0; t <= t1; t += 1350.)
+         times.push_back(t);
+         // out of order as well
+      times.push_back(t0 + 7200.);
+
+      for (int cache = 0; cache < 2; cache++)
+      {
+         store.setWindowCache(cache != 0);
+         std::vector<Xvt> xvts;
+         store.computeXvts(sats, times, xvts);
+         TUASSERTE(size_t, sats.size()*times.size(), xvts.size());
+         if (xvts.size() != sats.size()*times.size())
+            TURETURN();
+
+            // differences allowed, for rounding
+         const double scale(cache ? 0.0 : 1.0);
+         unsigned nused(0), nunavail(0), nbad(0);
+         for (unsigned i = 0; i < sats.size(); i++)
+         {
+            for (unsigned j = 0; j < times.size(); j++)
+            {
+               Xvt rv(store.computeXvt(sats[i], times[j]));
+               const Xvt& bv(xvts[i*times.size()+j]);
+               bool same(true);
+               for (int k = 0; k < 3; k++)
+               {
+                  same = same &&
+                     std::fabs(rv.x[k]-bv.x[k]) <= scale*1.e-6 &&
+                     std::fabs(rv.v[k]-bv.v[k]) <= scale*1.e-9;
+               }
+               same = same &&
+                  std::fabs(rv.clkbias-bv.clkbias) <= scale*1.e-15 &&
+                  std::fabs(rv.clkdrift-bv.clkdrift) <= scale*1.e-18 &&
+                  std::fabs(rv.relcorr-bv.relcorr) <= scale*1.e-15;
+               if (rv.health != bv.health)
+                  nbad++;
+               else if (rv.health == Xvt::HealthStatus::Unavailable)
+                  nunavail++;
+               else if (!same)
+                  nbad++;
+               else
+                  nused++;
+            }
+         }
+         TUASSERTE(unsigned, 0, nbad);
+         TUASSERT(nused > 0);
+         TUASSERT(nunavail > 0);
+      }
+
+         // every minute of the data, alternating between the two
+         // halves: the windows of each satellite are still found only
+         // once per pair of 15-minute records
+      store.setWindowCache(false);
+      std::vector<CommonTime> dense;
+      CommonTime mid(store.getInitialTime() + 0.5*(store.getFinalTime() -
+                                                   store.getInitialTime()));
+      for (CommonTime t = store.getInitialTime() + 1.; t < mid; t += 60.)
+      {
+         dense.push_back(t);
+         dense.push_back(mid + (t - store.getInitialTime()));
+      }
+      std::vector<SatID> one(1, sats[0]);
+      std::vector<Xvt> xvts;
+      store.resetWindowCacheStats();
+      store.computeXvts(one, dense, xvts);
+         // position and clock lookups, each missing about once per
+         // record and for every time near the ends of the table
+      unsigned long misses(store.getWindowCacheMisses());
+      TUASSERT(misses > 0);
+      TUASSERT(misses < dense.size()/4);
+      TUASSERT(store.getWindowCacheHits() > 5*misses);
+
+      TURETURN();
+   }
+
 private:
    double epsilon; // Floating point error threshold
    std::string dataFilePath;
@@ -730,6 +1153,12 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.getFinalTimeTest();
    errorTotal += testClass.getPositionTest();
    errorTotal += testClass.getVelocityTest();
+   errorTotal += testClass.flatTablesTest();
+   errorTotal += testClass.flatTableSearchTest();
+   errorTotal += testClass.windowCacheTest();
+   errorTotal += testClass.windowCacheThreadTest();
+   errorTotal += testClass.clockWindowTest();
+   errorTotal += testClass.computeXvtsTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
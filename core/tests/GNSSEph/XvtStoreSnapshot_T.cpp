@@ -0,0 +1,499 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <list>
+#include <thread>
+#include <iostream>
+
+#include "XvtStoreSnapshot.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "RinexEphemerisStore.hpp"
+#include "GloEphemerisStore.hpp"
+#include "Rinex3EphemerisStore.hpp"
+#include "Rinex3NavStream.hpp"
+#include "ChebyshevEphemerisStore.hpp"
+#include "TimeString.hpp"
+#include "StringUtils.hpp"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+   /// True if every field of the two Xvt is identical
+static bool sameXvt(const Xvt& a, const Xvt& b)
+{
+   if (a.health != b.health)
+      return false;
+   for (int i = 0; i < 3; i++)
+   {
+      if (a.x[i] != b.x[i] || a.v[i] != b.v[i])
+         return false;
+   }
+   return (a.clkbias == b.clkbias && a.clkdrift == b.clkdrift &&
+           a.relcorr == b.relcorr);
+}
+
+
+   /// Queries made by each thread of the stress test
+struct Queries
+{
+   vector<SatID> sats;
+   vector<CommonTime> times;
+};
+
+
+   /** Call getXvt() (or computeXvt() when it throws) and
+    * getSVHealth() for every query, in an order depending on seed. */
+static void runQueries(const XvtStore<SatID> *store, const Queries *q,
+                       unsigned seed, vector<Xvt> *results)
+{
+   const size_t nt = q->times.size(), n = q->sats.size() * nt;
+   results->assign(n, Xvt());
+   for (size_t m = 0; m < n; m++)
+   {
+         // visit the queries in a different order in each thread
+      size_t k = (m * 7919 + seed * 104729) % n;
+      const SatID& sat(q->sats[k / nt]);
+      const CommonTime& t(q->times[k % nt]);
+      Xvt& rv((*results)[k]);
+      try
+      {
+         rv = store->getXvt(sat, t);
+      }
+      catch (InvalidRequest& e)
+      {
+         rv = store->computeXvt(sat, t);
+      }
+      if (store->getSVHealth(sat, t) == Xvt::HealthStatus::Uninitialized)
+         rv.health = Xvt::HealthStatus::Uninitialized;
+   }
+}
+
+
+   /** Load a mixed RINEX 3 navigation file into rin3, and its GLONASS
+    * records into glo.  Each GLONASS record is repeated every 30
+    * minutes for 6 hours, so that the stores hand over from one
+    * record to the next. */
+static void loadGlonass(const string& fn, GloEphemerisStore& glo,
+                        Rinex3EphemerisStore& rin3)
+{
+   rin3.loadFile(fn);
+   Rinex3NavStream strm(fn.c_str());
+   Rinex3NavHeader hdr;
+   Rinex3NavData nd;
+   strm >> hdr;
+   while (strm >> nd)
+   {
+      if (nd.sat.system != SatelliteSystem::Glonass)
+         continue;
+      for (int k = 0; k < 12; k++)
+      {
+         Rinex3NavData rec(nd);
+         rec.time += k * 1800.;
+         glo.addEphemeris(rec);
+         rin3.addEphemeris(rec);
+      }
+   }
+}
+
+
+   /** Count the times from b to e, every step seconds, at which the
+    * snapshot and the store it was copied from differ. */
+static unsigned countDiffs(const XvtStore<SatID>& src,
+                           const XvtStoreSnapshot& snap, const CommonTime& b,
+                           const CommonTime& e, double step,
+                           unsigned& navail)
+{
+   unsigned bad = 0;
+   set<SatID> sats(snap.getIndexSet());
+   for (set<SatID>::const_iterator it = sats.begin(); it != sats.end(); ++it)
+   {
+      for (CommonTime t = b; t <= e; t += step)
+      {
+         Xvt a(src.computeXvt(*it, t)), c(snap.computeXvt(*it, t));
+         if (!sameXvt(a, c))
+            bad++;
+         if (snap.getSVHealth(*it, t) != src.getSVHealth(*it, t))
+            bad++;
+         bool threw = false;
+         try
+         {
+            snap.getXvt(*it, t);
+         }
+         catch (InvalidRequest& ir)
+         {
+            threw = true;
+         }
+         try
+         {
+            src.getXvt(*it, t);
+            if (threw)
+               bad++;
+         }
+         catch (InvalidRequest& ir)
+         {
+            if (!threw)
+               bad++;
+         }
+         if (c.health != Xvt::HealthStatus::Unavailable)
+            navail++;
+      }
+   }
+   return bad;
+}
+
+
+class XvtStoreSnapshot_T
+{
+public:
+   XvtStoreSnapshot_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string fileSep = gpstk::getFileSep();
+      inputSP3Data = dataFilePath + fileSep +
+         "test_input_sp3_nav_ephemerisData.sp3";
+      inputRinexNavData = dataFilePath + fileSep +
+         "test_input_rinex_nav_ephemerisData.031";
+      inputMixedNavData = dataFilePath + fileSep + "mixed.06n";
+   }
+
+
+      /// Check the window, and that an SP3 source is copied exactly
+   unsigned constructTest()
+   {
+      TUDEF("XvtStoreSnapshot", "XvtStoreSnapshot");
+
+      SP3EphemerisStore sp3;
+      sp3.loadFile(inputSP3Data);
+
+      TUTHROW(XvtStoreSnapshot(sp3, sp3.getFinalTime(),
+                               sp3.getInitialTime()));
+      ChebyshevEphemerisStore cheb;
+      TUTHROW(XvtStoreSnapshot(cheb, sp3.getInitialTime(),
+                               sp3.getFinalTime()));
+
+      CommonTime t0(sp3.getInitialTime() + 7200.), t1(t0 + 21600.);
+      XvtStoreSnapshot snap(sp3, t0, t1);
+      TUASSERTE(CommonTime, t0, snap.getInitialTime());
+      TUASSERTE(CommonTime, t1, snap.getFinalTime());
+      TUASSERTE(TimeSystem, sp3.getTimeSystem(), snap.getTimeSystem());
+      TUASSERTE(bool, sp3.hasVelocity(), snap.hasVelocity());
+      TUASSERT(snap.getIndexSet() == sp3.getIndexSet());
+
+         // on and between the tabulated times, and at the ends
+      set<SatID> sats(snap.getIndexSet());
+      unsigned bad = 0, nused = 0;
+      for (set<SatID>::const_iterator it = sats.begin(); it != sats.end(); ++it)
+      {
+         TUASSERT(snap.isPresent(*it));
+         for (CommonTime t = t0; t <= t1; t += 112.5)
+         {
+            Xvt a(sp3.computeXvt(*it, t)), b(snap.computeXvt(*it, t));
+            if (!sameXvt(a, b))
+               bad++;
+            if (b.health == Xvt::HealthStatus::Unused)
+               nused++;
+            if (snap.getSVHealth(*it, t) != sp3.getSVHealth(*it, t))
+               bad++;
+         }
+      }
+      TUASSERTE(unsigned, 0, bad);
+      TUASSERT(nused > 0);
+      TUASSERT(!snap.isPresent(SatID(32,SatelliteSystem::GPS)));
+
+         // times outside the window are not available
+      SatID sat(*sats.begin());
+      TUCATCH(snap.getXvt(sat, t0 + 3600.));
+      TUTHROW(snap.getXvt(SatID(32,SatelliteSystem::GPS), t0 + 3600.));
+      TUTHROW(snap.getXvt(sat, t0 - 1.0));
+      TUTHROW(snap.getXvt(sat, t1 + 1.0));
+      TUASSERTE(Xvt::HealthStatus, Xvt::HealthStatus::Unavailable,
+                snap.computeXvt(sat, t1 + 1.0).health);
+      TUASSERTE(Xvt::HealthStatus, Xvt::HealthStatus::Unavailable,
+                snap.getSVHealth(sat, t0 - 1.0));
+
+         // a snapshot is immutable
+      TUTHROW(snap.edit(snap.getInitialTime(), snap.getFinalTime()));
+      TUTHROW(snap.clear());
+
+      TURETURN();
+   }
+
+
+      /** Check that a snapshot of broadcast ephemerides is a copy,
+       * also where one ephemeris replaces the next, with both search
+       * methods. */
+   unsigned broadcastTest()
+   {
+      TUDEF("XvtStoreSnapshot", "getSVHealth");
+
+      CommonTime t0(CivilTime(2006,1,31,0,0,0,TimeSystem::GPS));
+      for (int method = 0; method < 2; method++)
+      {
+         RinexEphemerisStore bce;
+         if (method == 1)
+            bce.SearchNear();
+         bce.loadFile(inputRinexNavData.c_str());
+         XvtStoreSnapshot snap(bce, t0, t0 + 86400.);
+         TUASSERT(snap.getIndexSet() == bce.getIndexSet());
+
+         unsigned nhealthy = 0, bad = 0;
+         set<SatID> sats(snap.getIndexSet());
+         for (set<SatID>::const_iterator it = sats.begin();
+              it != sats.end(); ++it)
+         {
+               // every 15 s, which includes the times of handover
+            for (CommonTime t = t0; t <= t0 + 86400.; t += 15.)
+            {
+               Xvt a(bce.computeXvt(*it, t)), b(snap.computeXvt(*it, t));
+               if (!sameXvt(a, b))
+                  bad++;
+               if (snap.getSVHealth(*it, t) != bce.getSVHealth(*it, t))
+                  bad++;
+               if (b.health == Xvt::HealthStatus::Healthy)
+                  nhealthy++;
+            }
+         }
+         TUASSERTE(unsigned, 0, bad);
+         TUASSERT(nhealthy > 0);
+      }
+
+         // an unhealthy satellite is named in the exception
+      RinexEphemerisStore bce;
+      bce.loadFile(inputRinexNavData.c_str());
+      bce.setOnlyHealthyFlag(true);
+      XvtStoreSnapshot snap(bce, t0, t0 + 86400.);
+      TUASSERT(snap.getOnlyHealthyFlag());
+      set<SatID> sats(snap.getIndexSet());
+      SatID sat(*sats.begin());
+      CommonTime tbad;
+      bool found(false);
+      for (set<SatID>::const_iterator it = sats.begin();
+           !found && it != sats.end(); ++it)
+      {
+         for (CommonTime t = t0; !found && t <= t0 + 86400.; t += 900.)
+         {
+            if (snap.getSVHealth(*it, t) == Xvt::HealthStatus::Unhealthy)
+            {
+               sat = *it;
+               tbad = t;
+               found = true;
+            }
+         }
+      }
+      if (found)
+      {
+         try
+         {
+            snap.getXvt(sat, tbad);
+            TUFAIL("getXvt() of an unhealthy satellite did not throw");
+         }
+         catch (InvalidRequest& e)
+         {
+            string text(e.getText());
+            TUASSERT(text.find("Not healthy") != string::npos);
+            TUASSERT(text.find(StringUtils::asString(sat)) != string::npos);
+            TUASSERT(text.find(printTime(tbad, "%Y/%02m/%02d %02H:%02M"))
+                     != string::npos);
+         }
+      }
+
+      TURETURN();
+   }
+
+
+      /** Check that snapshots of a GloEphemerisStore and of a
+       * Rinex3EphemerisStore are copies, including where one GLONASS
+       * record replaces the next, and at the ends of the window. */
+   unsigned glonassTest()
+   {
+      TUDEF("XvtStoreSnapshot", "GLONASS");
+
+      GloEphemerisStore glo;
+      Rinex3EphemerisStore rin3;
+      loadGlonass(inputMixedNavData, glo, rin3);
+      list<GloEphemeris> recs;
+      glo.addToList(recs);
+      TUASSERTE(size_t, 24, recs.size());
+
+         // the window starts with the data and ends inside it
+      CommonTime t0(CivilTime(2006,10,1,0,0,0,TimeSystem::GLO)),
+         t1(t0 + 3 * 3600.);
+      XvtStoreSnapshot gsnap(glo, t0, t1);
+      TUASSERTE(TimeSystem, TimeSystem::GLO, gsnap.getTimeSystem());
+      TUASSERT(gsnap.getIndexSet() == glo.getIndexSet());
+      TUASSERTE(bool, glo.hasVelocity(), gsnap.hasVelocity());
+      unsigned navail = 0;
+      TUASSERTE(unsigned, 0, countDiffs(glo, gsnap, t0, t1, 60., navail));
+      TUASSERT(navail > 0);
+      TUASSERTE(Xvt::HealthStatus, Xvt::HealthStatus::Unavailable,
+                gsnap.computeXvt(*glo.getIndexSet().begin(),
+                                 t1 + 60.).health);
+      TUTHROW(gsnap.edit(t0, t1));
+
+         // GPS and GLONASS, queried in GPS time
+      CommonTime g0(CivilTime(2006,10,1,0,0,0,TimeSystem::GPS)),
+         g1(g0 + 3 * 3600.);
+      XvtStoreSnapshot rsnap(rin3, g0, g1);
+      TUASSERT(rsnap.getIndexSet() == rin3.getIndexSet());
+      TUASSERT(rsnap.isPresent(SatID(1,SatelliteSystem::GPS)));
+      TUASSERT(rsnap.isPresent(SatID(1,SatelliteSystem::Glonass)));
+      navail = 0;
+      TUASSERTE(unsigned, 0, countDiffs(rin3, rsnap, g0, g1, 60., navail));
+      TUASSERT(navail > 0);
+      TUASSERTE(Xvt::HealthStatus, Xvt::HealthStatus::Unavailable,
+                rsnap.getSVHealth(SatID(1,SatelliteSystem::Glonass),
+                                  g0 - 60.));
+
+         // the snapshot holds a copy, which outlives the source
+      Xvt before(rsnap.computeXvt(SatID(1,SatelliteSystem::Glonass),
+                                  g0 + 3600.));
+      rin3.clear();
+      glo.clear();
+      TUASSERT(sameXvt(before,
+                       rsnap.computeXvt(SatID(1,SatelliteSystem::Glonass),
+                                        g0 + 3600.)));
+
+      TURETURN();
+   }
+
+
+      /** Read one snapshot and the stores it was made from in many
+       * threads at once, checking the results against those of a
+       * single thread.  Build with THREAD_SANITIZER=ON to check for
+       * data races. */
+   unsigned threadTest()
+   {
+      TUDEF("XvtStoreSnapshot", "threads");
+
+      const unsigned nthreads = 8;
+
+      SP3EphemerisStore sp3;
+      sp3.loadFile(inputSP3Data);
+      sp3.setFlatTables(true);
+      RinexEphemerisStore bce;
+      bce.loadFile(inputRinexNavData.c_str());
+      CommonTime t0(CivilTime(2006,1,31,0,0,0,TimeSystem::GPS));
+      XvtStoreSnapshot snap(bce, t0, t0 + 86400.);
+      XvtStoreSnapshot sp3snap(sp3, sp3.getInitialTime(),
+                               sp3.getFinalTime());
+      GloEphemerisStore glo;
+      Rinex3EphemerisStore rin3;
+      loadGlonass(inputMixedNavData, glo, rin3);
+      CommonTime g0(CivilTime(2006,10,1,0,0,0,TimeSystem::GLO));
+      XvtStoreSnapshot glosnap(glo, g0, g0 + 6 * 3600.);
+      g0.setTimeSystem(TimeSystem::GPS);
+      XvtStoreSnapshot rin3snap(rin3, g0, g0 + 6 * 3600.);
+
+      const XvtStore<SatID> *stores[] = { &snap, &sp3, &bce, &sp3snap,
+                                          &glosnap, &rin3snap };
+      const char *names[] = { "snapshot", "SP3EphemerisStore",
+                              "RinexEphemerisStore", "SP3 snapshot",
+                              "GloEphemerisStore snapshot",
+                              "Rinex3EphemerisStore snapshot" };
+      for (unsigned s = 0; s < 6; s++)
+      {
+         const XvtStore<SatID>& store(*stores[s]);
+         Queries q;
+         set<SatID> sats(store.getIndexSet());
+         q.sats.assign(sats.begin(), sats.end());
+         q.sats.push_back(SatID(33,SatelliteSystem::GPS));
+         CommonTime b(store.getInitialTime()), e(store.getFinalTime());
+         if (s == 2)
+         {
+            b = CivilTime(2006,1,31,0,0,0,TimeSystem::GPS);
+            e = b + 86400.;
+         }
+            // include times outside the data at both ends
+         double dt = (e - b + 200.)/97.;
+         for (int k = 0; k < 98; k++)
+            q.times.push_back(b - 100. + k*dt);
+
+         vector<Xvt> serial;
+         runQueries(&store, &q, 0, &serial);
+
+         vector< vector<Xvt> > results(nthreads);
+         vector<std::thread> threads;
+         for (unsigned k = 0; k < nthreads; k++)
+            threads.push_back(std::thread(runQueries, &store, &q, k+1,
+                                          &results[k]));
+         for (unsigned k = 0; k < nthreads; k++)
+            threads[k].join();
+
+         unsigned bad = 0;
+         for (unsigned k = 0; k < nthreads; k++)
+         {
+            for (size_t i = 0; i < serial.size(); i++)
+            {
+               if (!sameXvt(serial[i], results[k][i]))
+                  bad++;
+            }
+         }
+         testFramework.assert(bad == 0, string(names[s]) +
+                              " results differ between threads", __LINE__);
+      }
+
+      TURETURN();
+   }
+
+private:
+   std::string inputSP3Data;
+   std::string inputRinexNavData;
+   std::string inputMixedNavData;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   XvtStoreSnapshot_T testClass;
+
+   errorTotal += testClass.constructTest();
+   errorTotal += testClass.broadcastTest();
+   errorTotal += testClass.glonassTest();
+   errorTotal += testClass.threadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
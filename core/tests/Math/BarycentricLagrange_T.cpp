@@ -0,0 +1,163 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <vector>
+#include "BarycentricLagrange.hpp"
+#include "MiscMath.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class BarycentricLagrange_T
+{
+public:
+   BarycentricLagrange_T()
+   {
+         // ten unevenly spaced nodes, and a smooth function on them,
+         // like an orbit component tabulated every 900s
+      for(int i=0; i<10; i++) {
+         X.push_back(900.*i + (i%3)*7.5);
+         Y.push_back(26000.*sin(1.4e-4*X[i]) + 3000.*cos(2.9e-4*X[i]));
+      }
+   }
+
+      /// Compare with LagrangeInterpolation() from MiscMath.hpp
+   unsigned interpolateTest()
+   {
+      TUDEF("BarycentricLagrange", "interpolate");
+
+      BarycentricLagrange<double> BL(X);
+      TUASSERTE(size_t, X.size(), BL.size());
+
+         // times across the central interval, as the stores use it,
+         // including points very near the nodes
+      vector<double> xs;
+      for(double x=X[4]; x<=X[5]; x+=37.)
+         xs.push_back(x);
+      xs.push_back(X[4]+1.e-6);
+      xs.push_back(X[5]-1.e-6);
+
+      for(size_t k=0; k<xs.size(); k++) {
+         double x(xs[k]), err, yref, dref, y, dydx;
+         yref = LagrangeInterpolation(X, Y, x, err);
+         TUASSERTFEPS(yref, BL.interpolate(Y, x), 1.e-9);
+
+         LagrangeInterpolation(X, Y, x, yref, dref);
+         BL.interpolate(Y, x, y, dydx);
+         TUASSERTFEPS(yref, y, 1.e-9);
+         TUASSERTFEPS(dref, dydx, 1.e-12);
+      }
+
+      TURETURN();
+   }
+
+      /// The coefficients are exact at the nodes, and reproduce polynomials
+   unsigned coefficientsTest()
+   {
+      TUDEF("BarycentricLagrange", "coefficients");
+
+      BarycentricLagrange<double> BL(X);
+      vector<double> L, Lp;
+      size_t i, k;
+
+         // at a node, L is exactly the unit vector
+      for(k=0; k<X.size(); k++) {
+         BL.coefficients(X[k], L);
+         TUASSERTE(size_t, X.size(), L.size());
+         for(i=0; i<L.size(); i++)
+            TUASSERTE(double, (i == k ? 1.0 : 0.0), L[i]);
+      }
+
+         // the basis sums to 1 and its derivative to 0, and it
+         // interpolates the cubic p(x) and its derivative exactly,
+         // at and between the nodes
+      for(double x=X[0]; x<=X[9]; x+=450.) {
+         BL.coefficients(x, L, Lp);
+         double sumL(0), sumLp(0), p(0), dp(0), s(x/1000.);
+         for(i=0; i<X.size(); i++) {
+            double t(X[i]/1000.);
+            sumL += L[i];
+            sumLp += Lp[i];
+            p += L[i]*(t*t*t - 2.*t + 1.);
+            dp += Lp[i]*(t*t*t - 2.*t + 1.);
+         }
+         TUASSERTFEPS(1.0, sumL, 1.e-12);
+         TUASSERTFEPS(0.0, sumLp, 1.e-14);
+         TUASSERTFEPS(s*s*s - 2.*s + 1., p, 1.e-10);
+         TUASSERTFEPS((3.*s*s - 2.)/1000., dp, 1.e-13);
+      }
+
+      TURETURN();
+   }
+
+      /// Invalid nodes are rejected
+   unsigned exceptionTest()
+   {
+      TUDEF("BarycentricLagrange", "setNodes");
+
+      BarycentricLagrange<double> BL;
+      vector<double> one(1, 0.0), same(3, 1.0);
+      TUTHROW(BL.setNodes(one));
+      TUTHROW(BL.setNodes(same));
+      TUCATCH(BL.setNodes(X));
+      TUTHROW(BL.interpolate(one, X[0]));
+
+      TURETURN();
+   }
+
+private:
+   vector<double> X, Y;
+};
+
+
+int main()
+{
+   BarycentricLagrange_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.interpolateTest();
+   errorTotal += testClass.coefficientsTest();
+   errorTotal += testClass.exceptionTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
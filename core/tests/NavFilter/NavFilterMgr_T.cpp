@@ -36,6 +36,8 @@
 //
 //==============================================================================
 
+#include <cstdlib>
+#include <new>
 #include "TestUtil.hpp"
 #include "NavFilterMgr.hpp"
 #include "LNavFilterData.hpp"
@@ -45,6 +47,7 @@
 #include "LNavTLMHOWFilter.hpp"
 #include "LNavEphMaker.hpp"
 #include "LNavCrossSourceFilter.hpp"
+#include "LNavOrderFilter.hpp"
 #include "NavOrderFilter.hpp"
 #include "CommonTime.hpp"
 #include "TimeString.hpp"
@@ -70,6 +73,24 @@ unsigned long expLNavEphs = 5210;
 
 typedef std::set<gpstk::CommonTime> TimeSet;
 
+// Count heap allocations, to check that a warmed-up filter chain
+// makes none.
+static unsigned long heapAllocCount = 0;
+
+void* operator new(std::size_t size)
+{
+   heapAllocCount++;
+   void *p = std::malloc(size ? size : 1);
+   if (p == NULL)
+      throw std::bad_alloc();
+   return p;
+}
+
+void operator delete(void* p) throw()
+{
+   std::free(p);
+}
+
 // define some classes for exercising NavFilterMgr
 class BunkFilterData : public NavFilterKey
 {
@@ -154,6 +175,10 @@ public:
    unsigned testLNavEphMaker();
       /// Test the combination of parity, empty and TLM/HOW filters
    unsigned testLNavCombined();
+      /** Test that the parity, TLM/HOW, cook, cross-source and
+       * order filters, once their pools have grown, process the
+       * data without heap allocation. */
+   unsigned testLNavChainAllocations();
       /** Test that the processingDepth() method returns a correct
        * value for any given NavFilter class. */
    template <class Filter>
@@ -553,6 +578,54 @@ testLNavCombined()
 }
 
 
+unsigned NavFilterMgr_T ::
+testLNavChainAllocations()
+{
+   TUDEF("NavFilterMgr", "validate");
+
+   unsigned long allocs[2] = { 0, 0 }, accepted[2] = { 0, 0 };
+      // the cook filter modifies the subframes, so each pass starts
+      // from a copy
+   vector<uint32_t> savedLNAV(subframesLNAV);
+
+      // The first pass grows the pools to their working size, the
+      // second should be served entirely from them.
+   for (unsigned pass = 0; pass < 2; pass++)
+   {
+      subframesLNAV = savedLNAV;
+      NavFilterMgr mgr;
+      LNavParityFilter filtParity;
+      LNavTLMHOWFilter filtTLMHOW;
+      LNavCookFilter filtCook;
+      LNavCrossSourceFilter filtXSrc;
+      LNavOrderFilter filtOrder;
+
+      mgr.addFilter(&filtParity);
+      mgr.addFilter(&filtTLMHOW);
+      mgr.addFilter(&filtCook);
+      mgr.addFilter(&filtXSrc);
+      mgr.addFilter(&filtOrder);
+
+      unsigned long before = heapAllocCount;
+      for (unsigned i = 0; i < dataIdxLNAV; i++)
+      {
+         gpstk::NavFilter::NavMsgList l = mgr.validate(&dataLNAV[i]);
+         accepted[pass] += l.size();
+      }
+      gpstk::NavFilter::NavMsgList l = mgr.finalize();
+      accepted[pass] += l.size();
+      allocs[pass] = heapAllocCount - before;
+   }
+   subframesLNAV = savedLNAV;
+   TUASSERT(accepted[0] > 0);
+   TUASSERTE(unsigned long, accepted[0], accepted[1]);
+   TUASSERT(allocs[0] > 0);
+   TUASSERTE(unsigned long, 0, allocs[1]);
+
+   TURETURN();
+}
+
+
 template <class Filter>
 unsigned NavFilterMgr_T ::
 testProcessingDepth(const std::string& filterName)
@@ -811,6 +884,7 @@ int main()
    errorTotal += testClass.testLNavTLMHOW();
    errorTotal += testClass.testLNavEphMaker();
    errorTotal += testClass.testLNavCombined();
+   errorTotal += testClass.testLNavChainAllocations();
    errorTotal += testClass.testProcessingDepths();
    errorTotal += testClass.testBunk1();
    errorTotal += testClass.testBunk2();
@@ -0,0 +1,264 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <algorithm>
+#include <fstream>
+#include "TestUtil.hpp"
+#include "ShardedNavFilterMgr.hpp"
+#include "LNavFilterData.hpp"
+#include "LNavParityFilter.hpp"
+#include "LNavTLMHOWFilter.hpp"
+#include "LNavCookFilter.hpp"
+#include "LNavCrossSourceFilter.hpp"
+#include "LNavOrderFilter.hpp"
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+typedef vector<NavFilterKey*> KeyVec;
+
+   /// The filters of one LNAV chain.
+struct LNavChain
+{
+   LNavParityFilter parity;
+   LNavTLMHOWFilter tlmHow;
+   LNavCookFilter cook;
+   LNavCrossSourceFilter xsrc;
+   LNavOrderFilter order;
+};
+
+class ShardedNavFilterMgr_T
+{
+public:
+   ShardedNavFilterMgr_T();
+
+   unsigned loadData();
+
+      /** Run the serial NavFilterMgr over the data to get the
+       * expected accepted and rejected messages. */
+   void runSerial();
+
+      /** Test that a sharded manager with nShards shards accepts and
+       * rejects the same messages as the serial one, and returns
+       * them in time order. */
+   unsigned testShards(unsigned nShards);
+
+      /// Test that addFilter rejects a bad shard index.
+   unsigned testAddFilter();
+
+      /// Put the subframes back as they were loaded
+   void restore()
+   { subframes = origSubframes; }
+
+   vector<LNavFilterData> data;
+   vector<uint32_t> subframes, origSubframes;
+   KeyVec expAccepted, expRejected;
+};
+
+
+ShardedNavFilterMgr_T ::
+ShardedNavFilterMgr_T()
+{
+}
+
+
+unsigned ShardedNavFilterMgr_T ::
+loadData()
+{
+   string fileName(getPathData() + getFileSep() + "test_input_NavFilterMgr.txt");
+   ifstream inf(fileName.c_str());
+   if (!inf)
+   {
+      cerr << "Could not load input file \"" << fileName << "\"" << endl;
+      return 1;
+   }
+   string line;
+   CommonTime recTime;
+   while (getline(inf, line))
+   {
+      if (line.empty() || (line[0] == '#'))
+         continue;
+      scanTime(recTime, StringUtils::firstWord(line, ','),
+               "%4Y %3j %02H:%02M:%04.1f");
+      for (unsigned strWord = 6; strWord <= 15; strWord++)
+      {
+         subframes.push_back(
+            StringUtils::x2uint(StringUtils::word(line, strWord, ',')));
+      }
+      LNavFilterData tmp;
+      tmp.prn = StringUtils::asUnsigned(StringUtils::word(line, 2, ','));
+      tmp.carrier = (CarrierBand)StringUtils::asInt(
+         StringUtils::word(line, 3, ','));
+      tmp.code = (TrackingCode)StringUtils::asInt(
+         StringUtils::word(line, 4, ','));
+      tmp.timeStamp = recTime;
+      data.push_back(tmp);
+   }
+   for (size_t i = 0; i < data.size(); i++)
+      data[i].sf = &subframes[i*10];
+   origSubframes = subframes;
+   cout << "Using " << data.size() << " LNAV subframes" << endl;
+   return 0;
+}
+
+
+void ShardedNavFilterMgr_T ::
+runSerial()
+{
+   restore();
+   NavFilterMgr mgr;
+   LNavChain chain;
+   mgr.addFilter(&chain.parity);
+   mgr.addFilter(&chain.tlmHow);
+   mgr.addFilter(&chain.cook);
+   mgr.addFilter(&chain.xsrc);
+   mgr.addFilter(&chain.order);
+   NavFilter::NavMsgList l;
+   NavFilterMgr::FilterSet::iterator fsi;
+   for (size_t i = 0; i < data.size(); i++)
+   {
+      l = mgr.validate(&data[i]);
+      expAccepted.insert(expAccepted.end(), l.begin(), l.end());
+      for (fsi = mgr.rejected.begin(); fsi != mgr.rejected.end(); fsi++)
+      {
+         expRejected.insert(expRejected.end(), (*fsi)->rejected.begin(),
+                            (*fsi)->rejected.end());
+      }
+   }
+   l = mgr.finalize();
+   expAccepted.insert(expAccepted.end(), l.begin(), l.end());
+   NavFilter *filters[] = { &chain.parity, &chain.tlmHow, &chain.cook,
+                            &chain.xsrc, &chain.order };
+   for (unsigned f = 0; f < 5; f++)
+   {
+      expRejected.insert(expRejected.end(), filters[f]->rejected.begin(),
+                         filters[f]->rejected.end());
+   }
+   sort(expAccepted.begin(), expAccepted.end());
+   sort(expRejected.begin(), expRejected.end());
+}
+
+
+unsigned ShardedNavFilterMgr_T ::
+testShards(unsigned nShards)
+{
+   TUDEF("ShardedNavFilterMgr", "validate");
+
+   restore();
+   ShardedNavFilterMgr mgr(nShards);
+   TUASSERTE(unsigned, nShards, mgr.getNumShards());
+   vector<LNavChain> chains(nShards);
+   for (unsigned s = 0; s < nShards; s++)
+   {
+      mgr.addFilter(s, &chains[s].parity);
+      mgr.addFilter(s, &chains[s].tlmHow);
+      mgr.addFilter(s, &chains[s].cook);
+      mgr.addFilter(s, &chains[s].xsrc);
+      mgr.addFilter(s, &chains[s].order);
+   }
+
+   KeyVec accepted, rejected;
+   NavFilter::NavMsgList batch, l;
+   bool sorted = true;
+   size_t i = 0;
+   while (i < data.size())
+   {
+         // one epoch at a time
+      batch.clear();
+      CommonTime t(data[i].timeStamp);
+      while ((i < data.size()) && (data[i].timeStamp == t))
+         batch.push_back(&data[i++]);
+      l = mgr.validate(batch);
+      size_t first = accepted.size();
+      accepted.insert(accepted.end(), l.begin(), l.end());
+      for (size_t j = first + 1; j < accepted.size(); j++)
+         sorted &= !(accepted[j]->timeStamp < accepted[j-1]->timeStamp);
+      rejected.insert(rejected.end(), mgr.rejected.begin(), mgr.rejected.end());
+   }
+   l = mgr.finalize();
+   size_t first = accepted.size();
+   accepted.insert(accepted.end(), l.begin(), l.end());
+   for (size_t j = first + 1; j < accepted.size(); j++)
+      sorted &= !(accepted[j]->timeStamp < accepted[j-1]->timeStamp);
+   rejected.insert(rejected.end(), mgr.rejected.begin(), mgr.rejected.end());
+   TUASSERT(sorted);
+
+   sort(accepted.begin(), accepted.end());
+   sort(rejected.begin(), rejected.end());
+   TUASSERTE(size_t, expAccepted.size(), accepted.size());
+   TUASSERT(accepted == expAccepted);
+   TUASSERTE(size_t, expRejected.size(), rejected.size());
+   TUASSERT(rejected == expRejected);
+
+   TURETURN();
+}
+
+
+unsigned ShardedNavFilterMgr_T ::
+testAddFilter()
+{
+   TUDEF("ShardedNavFilterMgr", "addFilter");
+
+   ShardedNavFilterMgr mgr(2);
+   LNavParityFilter filt;
+   TUCATCH(mgr.addFilter(1, &filt));
+   TUTHROW(mgr.addFilter(2, &filt));
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+
+   ShardedNavFilterMgr_T testClass;
+
+   errorTotal += testClass.loadData();
+   testClass.runSerial();
+   errorTotal += testClass.testShards(1);
+   errorTotal += testClass.testShards(3);
+   errorTotal += testClass.testShards(8);
+   errorTotal += testClass.testAddFilter();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
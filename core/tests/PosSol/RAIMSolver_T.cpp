@@ -0,0 +1,282 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "RAIMSolver.hpp"
+#include "PRSolution.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+#include "NBTropModel.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+   /// Pseudoranges of one epoch
+struct EpochPR
+{
+   CommonTime time;
+   vector<SatID> sats;
+   vector<double> pr;
+};
+
+
+class RAIMSolver_T
+{
+public:
+   RAIMSolver_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string fileSep = gpstk::getFileSep();
+      inputObs = dataFilePath + fileSep + "arlm200b.15o";
+      inputSP3 = dataFilePath + fileSep + "test_input_sp3_nav_2015_200.sp3";
+   }
+
+
+      /// Read the C1 pseudoranges of every 5th epoch, and the ephemeris
+   void load()
+   {
+      sp3.loadFile(inputSP3);
+
+      Rinex3ObsStream strm(inputObs.c_str());
+      Rinex3ObsHeader hdr;
+      Rinex3ObsData rod;
+      strm >> hdr;
+      const size_t ic1(hdr.getObsIndex("C1"));
+      for(int n=0; strm >> rod; n++) {
+         if(n % 5 != 0) continue;
+         if(rod.epochFlag != 0 && rod.epochFlag != 1) continue;
+         EpochPR ep;
+         ep.time = rod.time;
+         Rinex3ObsData::DataMap::const_iterator it;
+         for(it = rod.obs.begin(); it != rod.obs.end(); ++it) {
+            const double c1(it->second[ic1].data);
+            if(c1 == 0.0) continue;
+            ep.sats.push_back(it->first);
+            ep.pr.push_back(c1);
+         }
+         epochs.push_back(ep);
+      }
+   }
+
+
+      /// Configure a PRSolution so that the RAIM search rejects satellites
+   static void configure(PRSolution& prs)
+   {
+      prs.allowedGNSS.push_back(SatelliteSystem::GPS);
+      prs.RMSLimit = 0.8;
+      prs.NSatsReject = 3;
+   }
+
+
+      /// Make the trop model valid, as PRSolve does before processing
+   static void initTrop(NBTropModel& trop)
+   {
+      trop.setReceiverLatitude(30.0);
+      trop.setReceiverHeight(200.0);
+      trop.setDayOfYear(200);
+   }
+
+
+      /// Measurement covariance inverse for ep; diagonal unless full is true
+   static Matrix<double> weights(const EpochPR& ep, bool full)
+   {
+      const size_t n(ep.sats.size());
+      Matrix<double> invMC(n,n,0.0);
+      for(size_t i=0; i<n; i++) {
+         invMC(i,i) = 1.0/(1.0+0.1*(ep.sats[i].id % 7));
+         if(full && i > 0)
+            invMC(i,i-1) = invMC(i-1,i) = 0.05;
+      }
+      return invMC;
+   }
+
+
+      /** Compare the results of RAIMSolver with those of
+       * PRSolution::RAIMCompute() on every epoch. */
+   unsigned compareTest()
+   {
+      TUDEF("RAIMSolver", "RAIMCompute");
+
+      for(int wt=0; wt<3; wt++) {
+         PRSolution ref, prs;
+         configure(ref);
+         configure(prs);
+         RAIMSolver solver;
+         NBTropModel trop1, trop2;
+         initTrop(trop1);
+         initTrop(trop2);
+         int nrej(0);
+
+         for(size_t i=0; i<epochs.size(); i++) {
+            const EpochPR& ep(epochs[i]);
+            Matrix<double> invMC;
+            if(wt > 0) invMC = weights(ep, wt == 2);
+
+            vector<SatID> sats1(ep.sats), sats2(ep.sats);
+            int iret1 = ref.RAIMCompute(ep.time, sats1, ep.pr, invMC, &sp3, &trop1);
+            int iret2 = solver.RAIMCompute(prs, ep.time, sats2, ep.pr, invMC,
+                                           &sp3, &trop2);
+
+            TUASSERTE(int, iret1, iret2);
+            TUASSERT(sats1 == sats2);
+            TUASSERTE(bool, ref.isValid(), prs.isValid());
+            if(iret1 < 0) continue;
+
+            for(size_t j=0; j<sats1.size(); j++)
+               if(sats1[j].id < 0) nrej++;
+
+            TUASSERT(ref.SatelliteIDs == prs.SatelliteIDs);
+            TUASSERT(ref.dataGNSS == prs.dataGNSS);
+            TUASSERTE(int, ref.Nsvs, prs.Nsvs);
+            TUASSERTE(bool, ref.TropFlag, prs.TropFlag);
+            TUASSERTE(bool, ref.RMSFlag, prs.RMSFlag);
+            TUASSERTE(bool, ref.SlopeFlag, prs.SlopeFlag);
+            TUASSERTFEPS(ref.RMSResidual, prs.RMSResidual, 1.e-6);
+            TUASSERTFEPS(ref.MaxSlope, prs.MaxSlope, 1.e-8);
+            TUASSERTFEPS(ref.PDOP, prs.PDOP, 1.e-8);
+            TUASSERTE(size_t, ref.Solution.size(), prs.Solution.size());
+            for(size_t j=0; j<ref.Solution.size(); j++) {
+               TUASSERTFEPS(ref.Solution(j), prs.Solution(j), 1.e-5);
+               for(size_t k=0; k<ref.Solution.size(); k++)
+                  TUASSERTFEPS(ref.Covariance(j,k), prs.Covariance(j,k), 1.e-8);
+            }
+            TUASSERTE(size_t, ref.PreFitResidual.size(), prs.PreFitResidual.size());
+            for(size_t j=0; j<ref.PreFitResidual.size(); j++)
+               TUASSERTFEPS(ref.PreFitResidual(j), prs.PreFitResidual(j), 1.e-5);
+            TUASSERTE(size_t, ref.invMeasCov.rows(), prs.invMeasCov.rows());
+         }
+
+            // make sure the RAIM search did reject satellites
+         TUASSERT(nrej > 0);
+         TUASSERTE(int, ref.ndata, prs.ndata);
+         TUASSERTFEPS(ref.getAPV(), prs.getAPV(), 1.e-6);
+      }
+
+      TURETURN();
+   }
+
+
+      /** The solution must not depend on the number of threads,
+       * and a problem larger than the solver must give the same
+       * results as PRSolution. */
+   unsigned threadTest()
+   {
+      TUDEF("RAIMSolver", "threads");
+
+      PRSolution prs1, prs4, prsRef, prsBig;
+      configure(prs1);
+      configure(prs4);
+      configure(prsRef);
+      configure(prsBig);
+      RAIMSolver solver1(64, 4, 1), solver4(64, 4, 4), small(6, 4, 2);
+      TUASSERTE(unsigned, 4, solver4.getNThreads());
+      NBTropModel trop;
+      initTrop(trop);
+
+      for(size_t i=0; i<epochs.size(); i++) {
+         const EpochPR& ep(epochs[i]);
+         Matrix<double> invMC;
+         vector<SatID> sats1(ep.sats), sats4(ep.sats), satsR(ep.sats),
+            satsB(ep.sats);
+
+         int iret1 = solver1.RAIMCompute(prs1, ep.time, sats1, ep.pr, invMC,
+                                         &sp3, &trop);
+         int iret4 = solver4.RAIMCompute(prs4, ep.time, sats4, ep.pr, invMC,
+                                         &sp3, &trop);
+         TUASSERTE(int, iret1, iret4);
+         TUASSERT(sats1 == sats4);
+         if(iret1 >= 0) {
+            TUASSERTE(double, prs1.RMSResidual, prs4.RMSResidual);
+            TUASSERTE(double, prs1.MaxSlope, prs4.MaxSlope);
+            TUASSERTE(double, prs1.Convergence, prs4.Convergence);
+            TUASSERTE(int, prs1.NIterations, prs4.NIterations);
+            TUASSERT(prs1.Solution.size() == prs4.Solution.size());
+            for(size_t j=0; j<prs1.Solution.size(); j++) {
+               TUASSERTE(double, prs1.Solution(j), prs4.Solution(j));
+               for(size_t k=0; k<prs1.Solution.size(); k++)
+                  TUASSERTE(double, prs1.Covariance(j,k), prs4.Covariance(j,k));
+            }
+         }
+
+            // too many satellites for small: computed by PRSolution
+         int iretR = prsRef.RAIMCompute(ep.time, satsR, ep.pr, invMC, &sp3, &trop);
+         int iretB = small.RAIMCompute(prsBig, ep.time, satsB, ep.pr, invMC,
+                                       &sp3, &trop);
+         TUASSERTE(int, iretR, iretB);
+         TUASSERT(satsR == satsB);
+         if(iretR >= 0) {
+            TUASSERTE(double, prsRef.RMSResidual, prsBig.RMSResidual);
+            for(size_t j=0; j<prsRef.Solution.size(); j++)
+               TUASSERTE(double, prsRef.Solution(j), prsBig.Solution(j));
+         }
+      }
+
+      TURETURN();
+   }
+
+
+   std::vector<EpochPR> epochs;
+
+private:
+   std::string inputObs;
+   std::string inputSP3;
+   SP3EphemerisStore sp3;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   RAIMSolver_T testClass;
+
+   testClass.load();
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.threadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
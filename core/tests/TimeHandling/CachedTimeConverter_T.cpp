@@ -0,0 +1,193 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "CachedTimeConverter.hpp"
+#include "GPSWeekSecond.hpp"
+#include "GALWeekSecond.hpp"
+#include "TestUtil.hpp"
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace gpstk;
+
+class CachedTimeConverter_T
+{
+public:
+   CachedTimeConverter_T()
+   {
+         // runs of times in the same day, steps across midnight and
+         // week ends, and random times from before the GPS epoch on
+      CommonTime t(CivilTime(2017, 12, 30, 23, 59, 0.0, TimeSystem::GPS));
+      for (int i = 0; i < 200; i++)
+      {
+         times.push_back(t);
+         t += 0.7;
+      }
+      uint64_t seed = 7;
+      for (int i = 0; i < 200; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         long day = 2440000 + (seed >> 50) % 25000;
+         long msod = (seed >> 20) % MS_PER_DAY;
+         double fsod = ((seed >> 8) % 1000) * 1e-6;
+         CommonTime ct;
+         ct.setInternal(day, msod, fsod,
+                        (i % 2) ? TimeSystem::UTC : TimeSystem::GPS);
+         times.push_back(ct);
+            // and another time in the same day
+         ct.setInternal(day, (msod + 12345) % MS_PER_DAY, fsod,
+                        ct.getTimeSystem());
+         times.push_back(ct);
+      }
+   }
+
+   unsigned civilTest()
+   {
+      TUDEF("CachedTimeConverter", "convert(CivilTime)");
+
+      CachedTimeConverter conv;
+      unsigned bad = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         CivilTime expect(times[i]), got;
+         conv.convert(times[i], got);
+         bad += !(expect.year == got.year && expect.month == got.month &&
+                  expect.day == got.day && expect.hour == got.hour &&
+                  expect.minute == got.minute &&
+                  expect.second == got.second &&
+                  expect.getTimeSystem() == got.getTimeSystem());
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+      TURETURN();
+   }
+
+   unsigned ydsTest()
+   {
+      TUDEF("CachedTimeConverter", "convert(YDSTime)");
+
+      CachedTimeConverter conv;
+      unsigned bad = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+            // alternate with CivilTime, which shares the cached day
+         CivilTime civ;
+         if (i % 3 == 0)
+            conv.convert(times[i], civ);
+         YDSTime expect(times[i]), got;
+         conv.convert(times[i], got);
+         bad += !(expect.year == got.year && expect.doy == got.doy &&
+                  expect.sod == got.sod &&
+                  expect.getTimeSystem() == got.getTimeSystem());
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+      TURETURN();
+   }
+
+   unsigned weekSecondTest()
+   {
+      TUDEF("CachedTimeConverter", "convert(WeekSecond)");
+
+      CachedTimeConverter conv;
+      unsigned bad = 0, throws = 0, expectThrows = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         GPSWeekSecond expect, got;
+         bool failed = false;
+         try
+         {
+            expect.convertFromCommonTime(times[i]);
+         }
+         catch (InvalidRequest&)
+         {
+            failed = true;
+            expectThrows++;
+         }
+         try
+         {
+            conv.convert(times[i], got);
+         }
+         catch (InvalidRequest&)
+         {
+            throws++;
+            continue;
+         }
+         bad += failed || !(expect.week == got.week && expect.sow == got.sow &&
+                            expect.getTimeSystem() == got.getTimeSystem());
+            // a different epoch must not use the cached GPS week
+         if (i % 4 == 0)
+         {
+            GALWeekSecond galExpect, galGot;
+            try
+            {
+               galExpect.convertFromCommonTime(times[i]);
+               conv.convert(times[i], galGot);
+               bad += !(galExpect.week == galGot.week &&
+                        galExpect.sow == galGot.sow);
+            }
+            catch (InvalidRequest&)
+            {
+            }
+         }
+      }
+      TUASSERTE(unsigned, 0, bad);
+      TUASSERTE(unsigned, expectThrows, throws);
+      TUASSERT(throws > 0);
+
+      TURETURN();
+   }
+
+   vector<CommonTime> times;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   CachedTimeConverter_T testClass;
+
+   errorTotal += testClass.civilTest();
+   errorTotal += testClass.ydsTest();
+   errorTotal += testClass.weekSecondTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
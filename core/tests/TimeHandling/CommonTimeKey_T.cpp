@@ -0,0 +1,189 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "CommonTimeKey.hpp"
+#include "GPSWeekSecond.hpp"
+#include "TestUtil.hpp"
+#include <map>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace gpstk;
+
+class CommonTimeKey_T
+{
+public:
+   CommonTimeKey_T()
+   {
+         // a spread of days, milliseconds and fractions, including
+         // equal and nearly equal times
+      uint64_t seed = 3;
+      for (int i = 0; i < 200; i++)
+      {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         long day = 2450000 + (seed >> 60);
+         long msod = (seed >> 20) % MS_PER_DAY;
+         double fsod = ((seed >> 8) % 1000) * 1e-6;
+         CommonTime t;
+         t.setInternal(day, msod, fsod, TimeSystem::GPS);
+         times.push_back(t);
+         if (i % 10 == 0)
+            times.push_back(t);
+      }
+   }
+
+   unsigned conversionTest()
+   {
+      TUDEF("CommonTimeKey", "CommonTimeKey");
+
+      unsigned bad = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         CommonTime back(CommonTimeKey(times[i]));
+         bad += !(back == times[i]) || fabs(back - times[i]) > 1e-12;
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+         // the ends of time survive exactly
+      TUASSERTE(CommonTime, CommonTime::BEGINNING_OF_TIME,
+                CommonTimeKey(CommonTime::BEGINNING_OF_TIME).asCommonTime());
+      TUASSERTE(CommonTime, CommonTime::END_OF_TIME,
+                CommonTimeKey(CommonTime::END_OF_TIME).asCommonTime());
+
+         // rounding to the next millisecond
+      CommonTime t;
+      t.setInternal(2450000, 86399999, 0.001 - 1e-14, TimeSystem::GPS);
+      CommonTimeKey key(t);
+      TUASSERTE(int32_t, 0, key.getTicks());
+      TUASSERTE(int64_t, 2450001LL * MS_PER_DAY, key.getMilliseconds());
+      TUASSERT(key.getTimeSystem() == TimeSystem::GPS);
+      t.setInternal(2450000, 1, 2.5e-10, TimeSystem::GPS);
+      TUASSERTE(int32_t, 250, CommonTimeKey(t).getTicks());
+
+      TURETURN();
+   }
+
+   unsigned compareTest()
+   {
+      TUDEF("CommonTimeKey", "operator<");
+
+         // the keys order and difference as the CommonTimes do
+      unsigned badLess = 0, badEqual = 0, badDiff = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         for (size_t j = 0; j < times.size(); j++)
+         {
+            CommonTimeKey a(times[i]), b(times[j]);
+            badLess += ((a < b) != (times[i] < times[j]))
+               || ((a <= b) != (times[i] <= times[j]))
+               || ((a > b) != (times[i] > times[j]))
+               || ((a >= b) != (times[i] >= times[j]));
+            badEqual += ((a == b) != (times[i] == times[j]))
+               || ((a != b) != (times[i] != times[j]));
+            badDiff += fabs((a - b) - (times[i] - times[j])) > 1e-6;
+         }
+      }
+      TUASSERTE(unsigned, 0, badLess);
+      TUASSERTE(unsigned, 0, badEqual);
+      TUASSERTE(unsigned, 0, badDiff);
+
+         // time systems
+      CommonTime gal(times[0]), any(times[0]);
+      gal.setTimeSystem(TimeSystem::GAL);
+      any.setTimeSystem(TimeSystem::Any);
+      CommonTimeKey k(times[0]), kgal(gal), kany(any);
+      TUTHROW(k < kgal);
+      TUTHROW(k - kgal);
+      TUASSERT(k != kgal);
+      TUASSERT(k == kany);
+      TUASSERT(!(kany < k));
+
+      TURETURN();
+   }
+
+   unsigned mapTest()
+   {
+      TUDEF("CommonTimeKey", "operator<");
+
+         // a map keyed on CommonTimeKey behaves as one keyed on
+         // CommonTime for CommonTime arguments
+      map<CommonTime, int> ctMap;
+      map<CommonTimeKey, int> keyMap;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         ctMap[times[i]] = i;
+         keyMap[times[i]] = i;
+      }
+      TUASSERTE(size_t, ctMap.size(), keyMap.size());
+      unsigned bad = 0;
+      CommonTime t(GPSWeekSecond(1000, 0.0));
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         map<CommonTime, int>::const_iterator ci(ctMap.lower_bound(times[i]));
+         map<CommonTimeKey, int>::const_iterator ki(
+            keyMap.lower_bound(times[i]));
+         bad += (ci->second != ki->second) || !(ci->first == ki->first)
+            || (keyMap.find(times[i]) == keyMap.end());
+         CommonTime later(times[i] + 0.5);
+         ci = ctMap.upper_bound(later);
+         ki = keyMap.upper_bound(later);
+         bad += (ci == ctMap.end()) != (ki == keyMap.end());
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+      TURETURN();
+   }
+
+   vector<CommonTime> times;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   CommonTimeKey_T testClass;
+
+   errorTotal += testClass.conversionTest();
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.mapTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -45,17 +45,45 @@
 #include "GPSWeekSecond.hpp"
 #include "GPSWeekZcount.hpp"
 #include "UnixTime.hpp"
+#include "PosixTime.hpp"
 #include "YDSTime.hpp"
+#include "GALWeekSecond.hpp"
+#include "BDSWeekSecond.hpp"
+#include "QZSWeekSecond.hpp"
+#include "IRNWeekSecond.hpp"
 #include "TestUtil.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <iomanip>
+#include <vector>
 #include <sstream>
+#include <thread>
+#include <cmath>
 
 using namespace gpstk;
 using namespace std;
 
+   /// printTime() as it was before TimeFormat, one TimeTag at a time.
+string printEachTag( const CommonTime& t, const string& fmt )
+{
+   string rv( fmt );
+   try {rv = ANSITime(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = CivilTime(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = GPSWeekSecond(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = GPSWeekZcount(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = JulianDate(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = MJD(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = UnixTime(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = PosixTime(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = YDSTime(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = GALWeekSecond(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = BDSWeekSecond(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = QZSWeekSecond(t).printf( rv );} catch (InvalidRequest& e){};
+   try {rv = IRNWeekSecond(t).printf( rv );} catch (InvalidRequest& e){};
+   return rv;
+}
+
 //=============================================================================
 //	This test file will contain a series of scanTime checks for
 //	each of the directly tested TimeTag classes.
@@ -708,6 +736,197 @@ public:
       TUASSERTE(CommonTime,hardcodedCommonTime,scannedCommonTime); 
       return testFramework.countFails();
    }
+
+//=============================================================================
+//	TimeFormat print Test
+//=============================================================================
+   int printTimeFormat( void )
+   {
+      TestUtil testFramework( "TimeString", "TimeFormat::print", __FILE__, __LINE__ );
+
+         // Formats covering every print identifier, flags, widths,
+         // precisions and things that are not identifiers
+      const char *formats[] =
+      {
+         "%04Y/%02m/%02d %02H:%02M:%06.3f %P",
+         "%02y %3b %-10B %2d %S %.9f",
+         "%4F %10.3g %w %E %G %P",
+         "%z %Z %c %C %w %F",
+         "%.6J %15.8Q %K %U %u %W %N",
+         "%4Y %03j %9.3s %-5s|",
+         "%T %L %l %R %D %e %V %h %i %X %O %o %g",
+         "no identifiers at all",
+         "%% %%Y %5.3Y %.Y %q %-0Y %5. trailing %",
+         "",
+      };
+      vector<CommonTime> times;
+      times.push_back(CivilTime(2008,8,21,13,30,15.25,TimeSystem::UTC));
+      times.push_back(CivilTime(2008,8,21,13,30,16.5,TimeSystem::UTC));
+      times.push_back(CivilTime(2019,4,6,23,59,59.999,TimeSystem::GPS));
+      times.push_back(CivilTime(2019,4,7,0,0,0.,TimeSystem::GPS));
+         // before the GPS epoch and outside the ANSI range
+      times.push_back(CivilTime(1975,1,2,3,4,5.,TimeSystem::GPS));
+      times.push_back(CivilTime(1960,1,2,3,4,5.,TimeSystem::Any));
+      times.push_back(CivilTime(2050,12,31,12,0,0.,TimeSystem::BDT));
+
+      for (size_t f = 0; f < sizeof(formats)/sizeof(formats[0]); f++)
+      {
+         TimeFormat tf(formats[f]);
+         TUASSERTE(std::string, formats[f], tf.getFormat());
+         for (size_t i = 0; i < times.size(); i++)
+         {
+            std::string expect(printEachTag(times[i], formats[f]));
+            TUASSERTE(std::string, expect, tf.print(times[i]));
+            TUASSERTE(std::string, expect, printTime(times[i], formats[f]));
+               // print into a buffer, whole and truncated
+            char buf[128];
+            TUASSERTE(size_t, expect.size(),
+                      tf.print(times[i], buf, sizeof(buf)));
+            TUASSERTE(std::string, expect, std::string(buf));
+            TUASSERTE(size_t, expect.size(), tf.print(times[i], buf, 6));
+            TUASSERTE(std::string, expect.substr(0,5), std::string(buf));
+            buf[0] = 'x';
+            TUASSERTE(size_t, expect.size(), tf.print(times[i], buf, 0));
+            TUASSERTE(char, 'x', buf[0]);
+         }
+      }
+
+         // output longer than print()'s own buffer
+      std::string longFmt(std::string(200, '-') + "%04Y %300.3f|");
+      TUASSERTE(std::string, printEachTag(times[0], longFmt),
+                TimeFormat(longFmt).print(times[0]));
+
+      return testFramework.countFails();
+   }
+
+//=============================================================================
+//	TimeFormat scan Test
+//=============================================================================
+   int scanTimeFormat( void )
+   {
+      TestUtil testFramework( "TimeString", "TimeFormat::scan", __FILE__, __LINE__ );
+
+         // Pairs of format and string, with fixed width fields,
+         // delimited fields, adjacent fields, strings that run out
+         // and things that are not identifiers
+      const char *scans[][2] =
+      {
+         { "%4Y %2m %2d %2H %2M %11.7f", "2008  8 21 13 30 15.2500000" },
+         { " %4Y %2m %2d %2H %2M%11.7f  %1d", " 2008 08 21 13 3015.2500000  0" },
+         { "%Y/%m/%d %H:%M:%S", "2008/8/21 13:30:15" },
+         { "%Y/%m/%d %H:%M:%S", "  2008/   8/21 13:30" },
+         { "%Y%j%s", "2008234" },
+         { "%F %g %P", "1493 394215.000000 GPS" },
+         { "%04F%10.3g", "1493394215.000" },
+         { "%-5Y %j", "2008 234" },
+         { "%.3f %%Y %5", "15.250 %2008 x" },
+         { "%Y %j trailing", "2008 234 trailing text" },
+         { "%Y %j trailing", "2008 234 trail" },
+         { "%Y %j %", "2008 234 " },
+         { "%Y %j %", "2008 234" },
+         { "%4Y%3j", "20" },
+         { "%4Y", "" },
+         { "", "2008" },
+         { "%Q", "54699.5625" },
+      };
+
+      for (size_t k = 0; k < sizeof(scans)/sizeof(scans[0]); k++)
+      {
+         const std::string fmt(scans[k][0]), str(scans[k][1]);
+         TimeTag::IdToValue expect, info;
+         bool expectThrow = false, didThrow = false;
+         try
+         {
+            TimeTag::getInfo(str, fmt, expect);
+         }
+         catch (StringUtils::StringException& e)
+         {
+            expectThrow = true;
+         }
+         try
+         {
+            TimeFormat(fmt).getInfo(str, info);
+         }
+         catch (StringUtils::StringException& e)
+         {
+            didThrow = true;
+         }
+         testFramework.assert(expectThrow == didThrow,
+                              "getInfo exception differs for \"" + fmt +
+                              "\" \"" + str + "\"", __LINE__);
+         testFramework.assert(expect == info,
+                              "getInfo values differ for \"" + fmt +
+                              "\" \"" + str + "\"", __LINE__);
+      }
+
+         // round trip through one TimeFormat, e.g. RINEX epoch lines
+      TimeFormat tf("%4Y %2m %2d %2H %2M %11.7f");
+      CommonTime expect = CivilTime(2008,8,21,13,30,15.25,TimeSystem::Any);
+      CommonTime scanned;
+      tf.scan(scanned, tf.print(expect));
+      TUASSERTE(CommonTime, expect, scanned);
+      CivilTime civ;
+      tf.scan(civ, tf.print(expect));
+      TUASSERTE(CommonTime, expect, civ.convertToCommonTime());
+      try
+      {
+         tf.scan(scanned, "2008  8 21");
+         TUFAIL("scan() of a short string did not throw");
+      }
+      catch (StringUtils::StringException& e)
+      {
+         TUPASS("scan() of a short string");
+      }
+
+      return testFramework.countFails();
+   }
+
+//=============================================================================
+//	printTime/scanTime format cache Test
+//=============================================================================
+      /** printTime() and scanTime() keep compiled formats per
+       * thread.  Use more formats than the cache holds, in several
+       * threads at once, and check every result against a TimeFormat
+       * of its own. */
+   int formatCacheTest( void )
+   {
+      TestUtil testFramework( "TimeString", "printTime", __FILE__, __LINE__ );
+
+      std::vector<std::string> fmts;
+      for (int w = 0; w < 40; w++)
+      {
+         std::ostringstream oss;
+         int decimals = (w % 5) + 2;
+         oss << "%04Y/%02m/%02d %02H:%02M:%0" << decimals + 3 + (w % 3)
+             << "." << decimals << "f " << std::string(w / 8, '-') << "%P";
+         fmts.push_back(oss.str());
+      }
+      const unsigned nthreads = 4;
+      std::vector<unsigned> bad(nthreads, 0);
+      std::vector<std::thread> threads;
+      for (unsigned k = 0; k < nthreads; k++)
+      {
+         threads.push_back(std::thread([&fmts, &bad, k]()
+         {
+            CommonTime t = CivilTime(2008,8,21,13,30,15.25,TimeSystem::GPS);
+            for (unsigned n = 0; n < 2000; n++)
+            {
+               const std::string& fmt(fmts[(n * (k + 1)) % fmts.size()]);
+               CommonTime tn(t + n * 0.5), back;
+               std::string str(printTime(tn, fmt));
+               bad[k] += (str != TimeFormat(fmt).print(tn));
+               scanTime(back, str, fmt);
+               bad[k] += (std::fabs(back - tn) > 1e-5);
+            }
+         }));
+      }
+      for (unsigned k = 0; k < nthreads; k++)
+         threads[k].join();
+      for (unsigned k = 0; k < nthreads; k++)
+         TUASSERTE(unsigned, 0, bad[k]);
+
+      return testFramework.countFails();
+   }
 };
 
 
@@ -740,6 +959,15 @@ int main() // Main function to initialize and run all tests above
 
    check = testClass.scanTimeYDSTime();
    errorCounter += check;
+
+   check = testClass.printTimeFormat();
+   errorCounter += check;
+
+   check = testClass.scanTimeFormat();
+   errorCounter += check;
+
+   check = testClass.formatCacheTest();
+   errorCounter += check;
 	
    std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
 
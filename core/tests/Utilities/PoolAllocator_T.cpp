@@ -0,0 +1,217 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "PoolAllocator.hpp"
+#include "TestUtil.hpp"
+#include <list>
+#include <map>
+#include <vector>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+
+using namespace gpstk;
+
+class PoolAllocator_T
+{
+public:
+      /// Blocks freed are handed out again, most recent first.
+   unsigned reuseTest()
+   {
+      TUDEF("FixedBlockPool", "allocate");
+
+      void *p1 = FixedBlockPool<32>::allocate();
+      void *p2 = FixedBlockPool<32>::allocate();
+      TUASSERT(p1 != NULL);
+      TUASSERT(p2 != NULL);
+      TUASSERT(p1 != p2);
+      TUASSERTE(unsigned long, 0,
+                reinterpret_cast<unsigned long>(p1) %
+                FixedBlockPool<32>::ALIGN);
+      FixedBlockPool<32>::deallocate(p1);
+      TUASSERT(FixedBlockPool<32>::allocate() == p1);
+      FixedBlockPool<32>::deallocate(p2);
+      FixedBlockPool<32>::deallocate(p1);
+
+         // more than one chunk's worth, all distinct
+      std::vector<void*> blocks;
+      for (unsigned i = 0; i < 3 * FixedBlockPool<32>::CHUNK_BLOCKS; i++)
+         blocks.push_back(FixedBlockPool<32>::allocate());
+      std::vector<void*> sorted(blocks);
+      std::sort(sorted.begin(), sorted.end());
+      TUASSERT(std::adjacent_find(sorted.begin(), sorted.end()) ==
+               sorted.end());
+      for (unsigned i = 0; i < blocks.size(); i++)
+         FixedBlockPool<32>::deallocate(blocks[i]);
+
+      TURETURN();
+   }
+
+
+      /// Node containers work as usual with the allocator.
+   unsigned containerTest()
+   {
+      TUDEF("PoolAllocator", "allocate");
+
+      typedef std::list<int, PoolAllocator<int> > IntList;
+      typedef std::map<int, IntList, std::less<int>,
+                       PoolAllocator<std::pair<const int, IntList> > > IntMap;
+      IntMap m;
+      for (int i = 0; i < 10000; i++)
+         m[i % 100].push_back(i);
+      TUASSERTE(size_t, 100, m.size());
+      TUASSERTE(size_t, 100, m[42].size());
+      TUASSERTE(int, 9942, m[42].back());
+
+      IntList a, b;
+      a.push_back(1);
+      a.push_back(2);
+      b.push_back(3);
+      a.swap(b);
+      TUASSERTE(size_t, 1, a.size());
+      a.splice(a.end(), b);
+      TUASSERTE(size_t, 3, a.size());
+      TUASSERT(b.empty());
+      m.clear();
+
+         // arrays bypass the pool
+      PoolAllocator<double> alloc;
+      double *arr = alloc.allocate(100);
+      arr[99] = 1.0;
+      alloc.deallocate(arr, 100);
+
+      TUCSM("operator==");
+      TUASSERT(PoolAllocator<int>() == PoolAllocator<double>());
+      TUASSERT(!(PoolAllocator<int>() != PoolAllocator<double>()));
+
+      TURETURN();
+   }
+
+
+      /** Blocks allocated in one thread may be freed in another, and
+       * blocks left in a thread's free list survive its exit. */
+   unsigned threadTest()
+   {
+      TUDEF("FixedBlockPool", "deallocate");
+
+      const unsigned n = 2 * FixedBlockPool<48>::CACHE_MAX;
+      std::vector<void*> blocks(n);
+      std::thread t1(allocateBlocks, &blocks);
+      t1.join();
+      std::thread t2(freeBlocks, &blocks);
+      t2.join();
+         // this thread gets blocks from those the others returned
+      for (unsigned i = 0; i < n; i++)
+      {
+         blocks[i] = FixedBlockPool<48>::allocate();
+         *static_cast<unsigned*>(blocks[i]) = i;
+      }
+      unsigned bad = 0;
+      for (unsigned i = 0; i < n; i++)
+      {
+         bad += (*static_cast<unsigned*>(blocks[i]) != i);
+         FixedBlockPool<48>::deallocate(blocks[i]);
+      }
+      TUASSERTE(unsigned, 0, bad);
+
+      TURETURN();
+   }
+
+
+      /** A thread that only frees blocks still returns them to the
+       * global list when it exits. */
+   unsigned freeOnlyThreadTest()
+   {
+      TUDEF("FixedBlockPool", "deallocate");
+
+      std::vector<void*> freed(10);
+      for (unsigned i = 0; i < freed.size(); i++)
+         freed[i] = FixedBlockPool<64>::allocate();
+      std::thread t(freeBlocks64, &freed);
+      t.join();
+         // the freed blocks come back within one chunk's worth
+      std::vector<void*> blocks;
+      for (unsigned i = 0; i < FixedBlockPool<64>::CHUNK_BLOCKS; i++)
+         blocks.push_back(FixedBlockPool<64>::allocate());
+      unsigned found = 0;
+      for (unsigned i = 0; i < freed.size(); i++)
+         found += (std::find(blocks.begin(), blocks.end(), freed[i]) !=
+                   blocks.end());
+      TUASSERTE(unsigned, freed.size(), found);
+      for (unsigned i = 0; i < blocks.size(); i++)
+         FixedBlockPool<64>::deallocate(blocks[i]);
+
+      TURETURN();
+   }
+
+private:
+   static void allocateBlocks(std::vector<void*>* blocks)
+   {
+      for (unsigned i = 0; i < blocks->size(); i++)
+         (*blocks)[i] = FixedBlockPool<48>::allocate();
+   }
+
+   static void freeBlocks(std::vector<void*>* blocks)
+   {
+      for (unsigned i = 0; i < blocks->size(); i++)
+         FixedBlockPool<48>::deallocate((*blocks)[i]);
+   }
+
+   static void freeBlocks64(std::vector<void*>* blocks)
+   {
+      for (unsigned i = 0; i < blocks->size(); i++)
+         FixedBlockPool<64>::deallocate((*blocks)[i]);
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   PoolAllocator_T testClass;
+
+   errorTotal += testClass.reuseTest();
+   errorTotal += testClass.containerTest();
+   errorTotal += testClass.threadTest();
+   errorTotal += testClass.freeOnlyThreadTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,244 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <set>
+#include <string>
+#include "StringUtils.hpp"
+#include "FormattedDouble.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+/* Check the allocation-free numeric field conversions in StringUtils
+ * against the std::string conversions they replace.  The command
+ * line arguments are files, normally every file in the data
+ * directory, whose lines are cut into fields to convert. */
+class StringUtilsFields_T
+{
+public:
+   StringUtilsFields_T()
+         : checked(0)
+   {}
+
+      /// Numbers chosen to exercise each path of the conversions.
+   unsigned specialCasesTest()
+   {
+      TUDEF("StringUtils", "asDouble(const char*,size_type)");
+      const char *fields[] =
+      {
+         "", " ", "              ", "0", "-0", "+0", "-0.000", "0.0e5",
+         "123", "  -123", "12345.67890", "  23619095.450", "-.5", "5.",
+         ".", "-", "+.e3", "1e", "1e+", "1.5e-3x", "1.5E+03", "1.5D+03",
+         "1.5d-03", " .123456789012D+05", "-0.240699201822D-08",
+         "1e22", "1e23", "1e-22", "1e-23", "9007199254740993",
+         "9007199254740992", "1234567890123456789",
+         "12345678901234567890", "0.00000000000000000000000001",
+         "1e400", "-1e400", "1e-400", "0x1A", "  0X10", "inf", "-nan",
+         "1 2", "12\t", "\t12", "99999999999999999999999", "1.2.3",
+         "16777217", "16777216", "3.4028236e38", "1e-45",
+      };
+      for (size_t i = 0; i < sizeof(fields)/sizeof(fields[0]); i++)
+      {
+         checkField(testFramework, fields[i], strlen(fields[i]));
+      }
+         // a field that is not null terminated
+      checkField(testFramework, "1234.5678", 6);
+         // a field longer than the stack copy of the number
+      std::string longField(70, '1');
+      checkField(testFramework, longField.c_str(), longField.size());
+      longField.replace(60, 3, ".5e");
+      checkField(testFramework, longField.c_str(), longField.size());
+
+      TUCSM("asDouble(const std::string&,size_type,size_type)");
+      std::string line("  23619095.450 7  ");
+      TUASSERTE(double, StringUtils::asDouble(line.substr(0,14)),
+                StringUtils::asDouble(line, 0, 14));
+      TUASSERTE(long, 7, StringUtils::asInt(line, 14, 2));
+      TUASSERTE(double, 0, StringUtils::asDouble(line, line.size(), 5));
+      TUASSERTE(bool, true, StringUtils::isBlank(line, 16, 10));
+      TUASSERTE(bool, false, StringUtils::isBlank(line, 14, 2));
+      try
+      {
+         StringUtils::asInt(line, line.size()+1, 1);
+         TUFAIL("asInt past the end of the string did not throw");
+      }
+      catch (std::out_of_range& e)
+      {
+         TUPASS("asInt past the end of the string");
+      }
+
+      TURETURN();
+   }
+
+      /// Convert fields cut from every line of file.
+   unsigned fileTest(const std::string& file)
+   {
+      TUDEF("StringUtils", "asDouble(const char*,size_type)");
+      std::ifstream in(file.c_str(), std::ios::binary);
+      TUASSERT(in.good());
+      std::string line;
+      unsigned failures = 0;
+      while (std::getline(in, line) && failures < 10)
+      {
+            // Each blank separated word, with and without the blanks
+            // before it, and cut short, as fixed-width fields often
+            // are.
+         for (size_t start = 0; start < line.size(); )
+         {
+            size_t first = line.find_first_not_of(' ', start);
+            if (first == std::string::npos)
+               break;
+            size_t end = line.find(' ', first);
+            if (end == std::string::npos)
+               end = line.size();
+            const char *p = line.data();
+            failures += checkField(testFramework, p+first, end-first);
+            failures += checkField(testFramework, p+start, end-start);
+            if (end - first > 2)
+               failures += checkField(testFramework, p+first, end-first-2);
+            start = end;
+         }
+      }
+      TURETURN();
+   }
+
+   size_t checked;
+
+private:
+   std::set<std::string> seen;    ///< fields already checked
+
+      /// True if a and b have the same bits, or are both NaN.
+   template <class T>
+   static bool same(T a, T b)
+   {
+      return (memcmp(&a, &b, sizeof(T)) == 0) || (a != a && b != b);
+   }
+
+      /// FormattedDouble::operator=(std::string) before the fast path.
+   static double oldFormatted(const std::string& s, char expChar)
+   {
+      std::string copy(s);
+      if ((expChar != 'e') && (expChar != 'E'))
+      {
+         std::string::size_type pos = copy.find(expChar);
+         if (pos != std::string::npos)
+            copy[pos] = 'e';
+      }
+      double val = 0;
+      std::istringstream iss(copy);
+      iss >> val;
+      return val;
+   }
+
+      /** Compare each conversion of the len characters at s with
+       * the std::string conversion, and return the number of
+       * differences. */
+   unsigned checkField(TestUtil& testFramework, const char* s, size_t len)
+   {
+      std::string str(s, len);
+      if (!seen.insert(str).second)
+         return 0;
+      std::string what("\"" + str + "\"");
+      unsigned fails = 0;
+      checked++;
+      if (!same(StringUtils::asDouble(str), StringUtils::asDouble(s, len)))
+      {
+         TUFAIL("asDouble differs for " + what);
+         fails++;
+      }
+      if (StringUtils::asInt(str) != StringUtils::asInt(s, len))
+      {
+         TUFAIL("asInt differs for " + what);
+         fails++;
+      }
+      if (!same(StringUtils::asFloat(str), StringUtils::asFloat(s, len)))
+      {
+         TUFAIL("asFloat differs for " + what);
+         fails++;
+      }
+      if (!same(StringUtils::for2doub(str),
+                StringUtils::asFortranDouble(s, len)))
+      {
+         TUFAIL("asFortranDouble differs for " + what);
+         fails++;
+      }
+      if (StringUtils::isBlank(s, len) !=
+          (str.find_first_not_of(' ') == std::string::npos))
+      {
+         TUFAIL("isBlank differs for " + what);
+         fails++;
+      }
+      const char expChars[] = { 'D', 'e' };
+      for (size_t i = 0; i < sizeof(expChars); i++)
+      {
+         FormattedDouble fd(0u, expChars[i]);
+         fd = str;
+         if (!same(oldFormatted(str, expChars[i]), fd.val))
+         {
+            TUFAIL("FormattedDouble differs for " + what);
+            fails++;
+         }
+      }
+      return fails;
+   }
+};
+
+
+int main(int argc, char *argv[])
+{
+   unsigned errorTotal = 0;
+   StringUtilsFields_T testClass;
+
+   errorTotal += testClass.specialCasesTest();
+   for (int i = 1; i < argc; i++)
+   {
+      errorTotal += testClass.fileTest(argv[i]);
+   }
+
+   std::cout << "Checked " << testClass.checked << " distinct fields from "
+             << (argc-1) << " files" << std::endl;
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -40,6 +40,8 @@
 #include <string>
 #include <sstream>
 #include <iterator>
+#include <cmath>
+#include <random>
 #include "StringUtils.hpp"
 #include "TestUtil.hpp"
 
@@ -1243,6 +1245,108 @@ public:
 
       TURETURN();
    }
+
+
+      /** Compare the buffer versions of floatFormat() and the line
+       * formatters with the string functions they replace, for the
+       * formats used by the RINEX and SP3 writers and for random
+       * values and formats. */
+   unsigned formatIntoBufferTest()
+   {
+      TUDEF("StringUtils", "formatFixed");
+
+      string line("G01");
+      appendFixed(line, 20594327.256, 3, 14);
+      appendInt(line, 1, 1);
+      appendInt(line, 7, 1);
+      TUASSERTE(string, "G01  20594327.25617", line);
+      line.clear();
+      appendFixed(line, -0.0004, 3, 14);
+      appendInt(line, 2015, 2);
+      appendInt(line, 3, 2, '0');
+      appendInt(line, -12, 4);
+      appendFixed(line, 123456.5, 3, 4);
+      TUASSERTE(string, "        -0.0001503 -12.500", line);
+      char buf[8];
+      formatFixed(buf, 1.25, 1, 5, '*');
+      TUASSERTE(string, "**1.2", string(buf, 5));
+      formatInt(buf, -7, 3, '0');
+      TUASSERTE(string, "0-7", string(buf, 3));
+
+      TUCSM("floatFormat");
+      char fbuf[64];
+      TUASSERTE(size_t, 19, floatFormat(fbuf, sizeof(fbuf), -1.2345e-5,
+                                        FFLead::Decimal, 12, 2, 19, 'D',
+                                        FFSign::NegOnly, FFAlign::Right));
+      TUASSERTE(string, " -.123450000000D-04", string(fbuf));
+      TUASSERTE(size_t, 19, floatFormat(fbuf, 8, -1.2345e-5,
+                                        FFLead::Decimal, 12, 2, 19, 'D',
+                                        FFSign::NegOnly, FFAlign::Right));
+      TUASSERTE(string, " -.1234", string(fbuf));
+      TUASSERTE(size_t, 13, floatFormat(fbuf, sizeof(fbuf), 1.2345,
+                                        FFLead::Zero, 5, 4, 0, 'E',
+                                        FFSign::NegPos));
+      TUASSERTE(string, "+0.1234E+0001", string(fbuf));
+
+      std::mt19937 rng(1);
+      unsigned fixedFail = 0, intFail = 0, floatFail = 0;
+      for (unsigned i = 0; i < 200000; i++)
+      {
+         double x;
+         switch (i % 4)
+         {
+            case 0:
+               x = (double)rng() / 1000.0 - 2e6;
+               break;
+            case 1:
+               x = ldexp((double)rng(), (int)(rng() % 100) - 80);
+               break;
+            case 2:
+                  // halfway cases in decimal
+               x = (double)(rng() % 100000) / 1000.0 + 0.0005;
+               break;
+            default:
+               x = pow(10.0, (int)(rng() % 40) - 20) * ((rng() & 1) ? 1 : -1);
+               break;
+         }
+         string::size_type precision = rng() % 13, width = rng() % 20;
+         char pad = (rng() & 1) ? ' ' : '0';
+         line.clear();
+         if (appendFixed(line, x, precision, width, pad) !=
+             rightJustify(asString(x, precision), width, pad))
+         {
+            fixedFail++;
+         }
+         long l = (long)rng() - (long)(rng() % 2) * 3000000000L;
+         line.clear();
+         if (appendInt(line, l, width, pad) != rightJustify(asString(l),
+                                                            width, pad))
+         {
+            intFail++;
+         }
+         FFLead lead = (FFLead)(i % 3);
+         unsigned mantissa = 3 + rng() % 12, exponent = rng() % 4;
+         unsigned ffWidth = rng() % 25;
+         FFSign sign = (FFSign)(rng() % 3);
+         FFAlign align = (FFAlign)(rng() % 2);
+         string expect = floatFormat(x, lead, mantissa, exponent, ffWidth,
+                                     'D', sign, align);
+         if ((floatFormat(fbuf, sizeof(fbuf), x, lead, mantissa, exponent,
+                          ffWidth, 'D', sign, align) != expect.size()) ||
+             (expect != fbuf))
+         {
+            floatFail++;
+         }
+      }
+      TUCSM("formatFixed");
+      TUASSERTE(unsigned, 0, fixedFail);
+      TUCSM("formatInt");
+      TUASSERTE(unsigned, 0, intFail);
+      TUCSM("floatFormat");
+      TUASSERTE(unsigned, 0, floatFail);
+
+      TURETURN();
+   }
 };
 
 int main() // Main function to initialize and run all tests above
@@ -1268,6 +1372,7 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.hexDumpDataConfigTest();
    errorTotal += testClass.hexToAsciiTest();
    errorTotal += testClass.floatFormatTest();
+   errorTotal += testClass.formatIntoBufferTest();
 
    std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
              << std::endl;
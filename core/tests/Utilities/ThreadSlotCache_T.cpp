@@ -0,0 +1,178 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "ThreadSlotCache.hpp"
+#include "TestUtil.hpp"
+#include <thread>
+#include <vector>
+#include <iostream>
+
+using namespace gpstk;
+
+   /// Value cached by the tests: a key and the result computed for it
+struct Square
+{
+   Square() : key(-1), value(0) {}
+   int key;
+   long value;
+};
+
+typedef ThreadSlotCache<Square, 16> SquareCache;
+
+   /// Look up key*key in cache, computing and saving it on a miss.
+static long lookup(const SquareCache& cache, int key)
+{
+   SquareCache::Slot& s(cache.slot(key));
+   if (cache.holds(s) && s.value.key == key)
+   {
+      cache.hit();
+      return s.value.value;
+   }
+   cache.miss();
+   SquareCache::release(s);
+   s.value.key = key;
+   s.value.value = long(key) * key;
+   cache.fill(s);
+   return s.value.value;
+}
+
+
+class ThreadSlotCache_T
+{
+public:
+      /// Values are kept until invalidated, per cache.
+   unsigned generationTest()
+   {
+      TUDEF("ThreadSlotCache", "holds");
+
+      SquareCache a, b;
+      TUASSERTE(long, 9, lookup(a, 3));
+      TUASSERTE(unsigned long, 0, a.getHits());
+      TUASSERTE(unsigned long, 1, a.getMisses());
+      TUASSERTE(long, 9, lookup(a, 3));
+      TUASSERTE(unsigned long, 1, a.getHits());
+
+         // another cache, or a copy, does not see the value
+      TUASSERT(!b.holds(a.slot(3)));
+      SquareCache c(a);
+      TUASSERT(!c.holds(a.slot(3)));
+      TUASSERTE(unsigned long, 0, c.getHits());
+      b = a;
+      TUASSERT(!b.holds(a.slot(3)));
+
+         // invalidate() drops every value
+      TUASSERT(a.holds(a.slot(3)));
+      a.invalidate();
+      TUASSERT(!a.holds(a.slot(3)));
+      TUASSERTE(long, 9, lookup(a, 3));
+      TUASSERTE(unsigned long, 2, a.getMisses());
+
+         // a slot taken by another key is detected by the value
+      for (int k = 0; k < 100; k++)
+         TUASSERTE(long, long(k) * k, lookup(a, k));
+
+         // a released slot holds nothing; the scratch slot is separate
+      SquareCache::Slot& s(a.slot(5));
+      SquareCache::release(s);
+      TUASSERT(!a.holds(s));
+      TUASSERT(&a.scratch() != &s);
+      TUASSERT(&a.scratch() == &b.scratch());
+
+      a.resetStats();
+      TUASSERTE(unsigned long, 0, a.getHits());
+      TUASSERTE(unsigned long, 0, a.getMisses());
+
+      TURETURN();
+   }
+
+
+      /// Each thread has its own slots.
+   unsigned threadTest()
+   {
+      TUDEF("ThreadSlotCache", "slot");
+
+      const unsigned nthreads = 8;
+      SquareCache cache;
+      lookup(cache, 7);
+      std::vector<int> held(nthreads, 1);
+      std::vector<long> sums(nthreads, 0);
+      std::vector<std::thread> threads;
+      for (unsigned t = 0; t < nthreads; t++)
+      {
+         threads.push_back(std::thread(
+            [&cache, &held, &sums, t]()
+            {
+                  // nothing saved by the main thread is seen here
+               held[t] = cache.holds(cache.slot(7));
+               for (int n = 0; n < 10000; n++)
+                  sums[t] += lookup(cache, (n + t) % 10);
+            }));
+      }
+      for (unsigned t = 0; t < nthreads; t++)
+         threads[t].join();
+
+      for (unsigned t = 0; t < nthreads; t++)
+      {
+         TUASSERTE(int, 0, held[t]);
+         long e = 0;
+         for (int n = 0; n < 10000; n++)
+            e += long((n + t) % 10) * ((n + t) % 10);
+         TUASSERTE(long, e, sums[t]);
+      }
+      TUASSERTE(unsigned long, 1 + nthreads * 10000,
+                cache.getHits() + cache.getMisses());
+      TUASSERT(cache.getHits() > 0);
+
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   ThreadSlotCache_T testClass;
+
+   errorTotal += testClass.generationTest();
+   errorTotal += testClass.threadTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,204 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include "WorkerPool.hpp"
+#include "TestUtil.hpp"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stdexcept>
+#include <vector>
+#include <iostream>
+
+using namespace gpstk;
+
+class WorkerPool_T
+{
+public:
+      /// Every index runs once per call, in its own thread.
+   unsigned runTest()
+   {
+      TUDEF("WorkerPool", "run");
+
+      WorkerPool pool(3);
+      TUASSERTE(unsigned, 3, pool.getNumThreads());
+      std::vector<int> calls(4, 0);
+      std::vector<std::thread::id> ids(4);
+      WorkerPool::Task count = [&](unsigned t)
+         {
+            calls[t]++;
+            ids[t] = std::this_thread::get_id();
+         };
+      for (int i = 0; i < 100; i++)
+         TUCATCH(pool.run(count));
+      unsigned bad = 0;
+      for (unsigned t = 0; t < calls.size(); t++)
+         bad += (calls[t] != 100);
+      TUASSERTE(unsigned, 0, bad);
+      TUASSERT(ids[0] == std::this_thread::get_id());
+      for (unsigned t = 1; t < ids.size(); t++)
+         TUASSERT(ids[t] != ids[0]);
+
+         // without workers, only the calling thread runs
+      WorkerPool none(0);
+      calls.assign(4, 0);
+      TUCATCH(none.run([&](unsigned t) { calls[t]++; }));
+      TUASSERTE(int, 1, calls[0]);
+      TUASSERTE(int, 0, calls[1]);
+
+      TURETURN();
+   }
+
+
+      /** The workers run while the calling thread waits on them,
+       * and return when told to. */
+   unsigned startTest()
+   {
+      TUDEF("WorkerPool", "start");
+
+      WorkerPool pool(2);
+      std::mutex mtx;
+      std::condition_variable cond;
+      unsigned started = 0;
+      bool stop = false;
+      pool.start([&](unsigned t)
+                 {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    started++;
+                    cond.notify_all();
+                    while (!stop)
+                       cond.wait(lock);
+                 });
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         while (started < 2)
+            cond.wait(lock);
+      }
+         // only one task at a time
+      TUTHROW(pool.start([](unsigned) {}));
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         stop = true;
+      }
+      cond.notify_all();
+      TUCATCH(pool.wait());
+      TUASSERTE(unsigned, 2, started);
+         // no task is running now
+      TUCATCH(pool.wait());
+      TUCATCH(pool.run([](unsigned) {}));
+
+      TURETURN();
+   }
+
+
+      /** An exception in any thread is rethrown once all the
+       * threads are done, and the pool can be used again. */
+   unsigned exceptionTest()
+   {
+      TUDEF("WorkerPool", "run");
+
+      WorkerPool pool(3);
+      std::atomic<unsigned> finished(0);
+      bool caught = false;
+      try
+      {
+         pool.run([&](unsigned t)
+                  {
+                     if (t == 2)
+                     {
+                        InvalidParameter exc("bad part");
+                        GPSTK_THROW(exc);
+                     }
+                     finished++;
+                  });
+      }
+      catch (Exception& e)
+      {
+         caught = (e.getText().find("bad part") != std::string::npos);
+      }
+      TUASSERT(caught);
+      TUASSERTE(unsigned, 3, finished);
+
+      caught = false;
+      try
+      {
+         pool.run([](unsigned t)
+                  {
+                     if (t == 0)
+                        throw std::runtime_error("std failure");
+                  });
+      }
+      catch (Exception& e)
+      {
+         caught = (e.getText().find("std failure") != std::string::npos);
+      }
+      TUASSERT(caught);
+
+      TUCSM("wait");
+      pool.start([](unsigned t)
+                 {
+                    if (t == 1)
+                       throw std::runtime_error("worker failure");
+                 });
+      TUTHROW(pool.wait());
+
+      finished = 0;
+      TUCATCH(pool.run([&](unsigned) { finished++; }));
+      TUASSERTE(unsigned, 4, finished);
+
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   WorkerPool_T testClass;
+
+   errorTotal += testClass.runTest();
+   errorTotal += testClass.startTest();
+   errorTotal += testClass.exceptionTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
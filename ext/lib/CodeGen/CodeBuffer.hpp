@@ -150,17 +150,12 @@ namespace gpstk
 
    inline unsigned long CodeBuffer::getBit( const long i ) const
    {
-      unsigned long iret;
       long bNdx = i / MAX_BIT;
       long bitNum = i - (bNdx * MAX_BIT);
-      iret = buffer[bNdx];
-   
-      // Shift LEFT to clear off msbs
-      iret <<= bitNum;
-      // Then shift RIGHT to clear off lsbs
-      iret >>= (MAX_BIT-1);
-   
-      return iret;
+
+      // Shift the bit to the LSB and mask it, as unsigned long may be
+      // wider than MAX_BIT bits
+      return (buffer[bNdx] >> (MAX_BIT-1-bitNum)) & 1;
    }
    //@}
 }     // end of namespace
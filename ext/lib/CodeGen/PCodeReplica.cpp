@@ -0,0 +1,273 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include <cmath>
+#include <cstring>
+#include "PCodeReplica.hpp"
+#include "GPSWeekZcount.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PCODEREPLICA_AVX2
+#include <immintrin.h>
+#endif
+
+using namespace std;
+namespace gpstk
+{
+      // Chips in six seconds
+   const long CHIPS_PER_6SEC = NUM_6SEC_WORDS * MAX_BIT;
+
+   namespace
+   {
+         /*
+            Sample n chips from chips[], starting at chip 'phase' (fixed
+            point, relative to chips[0]) and stepping 'step'.
+         */
+      void sampleScalar( int8_t* out, const uint32_t* chips, uint64_t phase,
+                         const uint64_t step, const long n )
+      {
+         for (long k=0; k<n; ++k)
+         {
+            uint32_t c = static_cast<uint32_t>(
+               phase >> PCodeReplica::FRAC_BITS);
+            uint32_t bit = (chips[c / MAX_BIT] >> (MAX_BIT - 1 - c % MAX_BIT))
+                           & 1;
+            out[k] = 1 - 2 * static_cast<int8_t>(bit);
+            phase += step;
+         }
+      }
+
+         // Pack n +/-1 samples into bits, MSB first.
+      void packScalar( uint32_t* words, const int8_t* samples, const long n )
+      {
+         for (long k=0; k<n; k+=MAX_BIT)
+         {
+            long m = (n-k < MAX_BIT) ? n-k : MAX_BIT;
+            uint32_t w = 0;
+            for (long j=0; j<m; ++j)
+               w |= static_cast<uint32_t>(samples[k+j] < 0) << (MAX_BIT-1-j);
+            words[k / MAX_BIT] = w;
+         }
+      }
+
+#ifdef PCODEREPLICA_AVX2
+         // Same as sampleScalar, eight samples at a time.
+      __attribute__((target("avx2")))
+      void sampleAVX2( int8_t* out, const uint32_t* chips, uint64_t phase,
+                       const uint64_t step, const long n )
+      {
+         const __m256i one = _mm256_set1_epi32(1);
+         const __m256i mask = _mm256_set1_epi32(MAX_BIT-1);
+         const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+         const __m256i inc = _mm256_set1_epi64x(8 * step);
+         __m256i p0 = _mm256_setr_epi64x(phase, phase + step,
+                                         phase + 2*step, phase + 3*step);
+         __m256i p1 = _mm256_add_epi64(p0, _mm256_set1_epi64x(4 * step));
+         long k = 0;
+         for (; k+8<=n; k+=8)
+         {
+               // chip numbers of the eight samples, in order
+            __m256i c0 = _mm256_srli_epi64(p0, PCodeReplica::FRAC_BITS);
+            __m256i c1 = _mm256_srli_epi64(p1, PCodeReplica::FRAC_BITS);
+            __m256i c = _mm256_blend_epi32(c0, _mm256_slli_epi64(c1, 32),
+                                           0xAA);
+            c = _mm256_permutevar8x32_epi32(c, order);
+               // bit of each chip, as +1 or -1
+            __m256i w = _mm256_i32gather_epi32((const int*)chips,
+                                               _mm256_srli_epi32(c, 5), 4);
+            __m256i shift = _mm256_sub_epi32(mask, _mm256_and_si256(c, mask));
+            __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(w, shift), one);
+            __m256i v = _mm256_sub_epi32(one, _mm256_slli_epi32(bit, 1));
+               // narrow to bytes; samples 0-3 and 4-7 end up in the low
+               // four bytes of each half
+            v = _mm256_packs_epi32(v, v);
+            v = _mm256_packs_epi16(v, v);
+            int32_t lo = _mm256_cvtsi256_si32(v);
+            int32_t hi = _mm_cvtsi128_si32(_mm256_extracti128_si256(v, 1));
+            memcpy(out+k, &lo, 4);
+            memcpy(out+k+4, &hi, 4);
+            p0 = _mm256_add_epi64(p0, inc);
+            p1 = _mm256_add_epi64(p1, inc);
+         }
+         if (k<n) sampleScalar(out+k, chips, phase + k*step, step, n-k);
+      }
+
+         // Same as packScalar, 32 samples at a time.
+      __attribute__((target("avx2")))
+      void packAVX2( uint32_t* words, const int8_t* samples, const long n )
+      {
+         long k = 0;
+         for (; k+MAX_BIT<=n; k+=MAX_BIT)
+         {
+               // bit j is the sign of sample j; reverse for MSB first
+            uint32_t w = _mm256_movemask_epi8(
+               _mm256_loadu_si256((const __m256i*)(samples+k)));
+            w = ((w >> 1) & 0x55555555) | ((w & 0x55555555) << 1);
+            w = ((w >> 2) & 0x33333333) | ((w & 0x33333333) << 2);
+            w = ((w >> 4) & 0x0F0F0F0F) | ((w & 0x0F0F0F0F) << 4);
+            w = ((w >> 8) & 0x00FF00FF) | ((w & 0x00FF00FF) << 8);
+            words[k / MAX_BIT] = (w >> 16) | (w << 16);
+         }
+         if (k<n) packScalar(words + k/MAX_BIT, samples+k, n-k);
+      }
+#endif
+   }
+
+   PCodeReplica::PCodeReplica( const int SVPRNID,
+                               const gpstk::GPSZcount& z,
+                               const double chipOffset,
+                               const double sampleRate,
+                               const double chipRate )
+         : gen(SVPRNID, GPSWeekZcount(z.getWeek(), z.getZcount())),
+           sampleRate(sampleRate), step(0), phase(0), sixSeconds(0),
+           window(WINDOW_WORDS), windowBegin(0), windowEnd(0),
+           useAVX2(false)
+   {
+      if (!(chipOffset >= 0.))
+      {
+         gpstk::Exception e("The chip offset must not be negative");
+         GPSTK_THROW(e);
+      }
+      if (!(sampleRate > 0.))
+      {
+         gpstk::Exception e("The sample rate must be positive");
+         GPSTK_THROW(e);
+      }
+      gen.setCurrentZCount(z);
+      setChipRate(chipRate);
+      setKernel(SVPCodeGen::AUTO_KERNEL);
+
+         // whole six-second intervals of the offset
+      double whole = std::floor(chipOffset / CHIPS_PER_6SEC);
+      sixSeconds = static_cast<long>(whole);
+      for (long i=0; i<sixSeconds; ++i)
+         gen.increment4ZCounts();
+      phase = static_cast<uint64_t>(std::ldexp(
+         chipOffset - whole * CHIPS_PER_6SEC, FRAC_BITS));
+   }
+
+   void PCodeReplica::setChipRate( const double chipRate )
+   {
+      double chipsPerSample = chipRate / sampleRate;
+         // at least one sample in six seconds
+      if (!(chipsPerSample > 0.) || chipsPerSample > CHIPS_PER_6SEC)
+      {
+         gpstk::Exception e("The chip rate must be positive and at most six"
+                            " seconds of chips per sample");
+         GPSTK_THROW(e);
+      }
+      step = static_cast<uint64_t>(std::ldexp(chipsPerSample, FRAC_BITS) + 0.5);
+      if (step==0) step = 1;
+   }
+
+   double PCodeReplica::getChipOffset( ) const
+   {
+      return static_cast<double>(sixSeconds) * CHIPS_PER_6SEC +
+         std::ldexp(static_cast<double>(phase), -FRAC_BITS);
+   }
+
+   void PCodeReplica::setKernel( const SVPCodeGen::Kernel k )
+   {
+      gen.setKernel(k);
+      useAVX2 = (gen.getKernel() == SVPCodeGen::AVX2_KERNEL);
+   }
+
+   void PCodeReplica::generate( int8_t* samples, const long n )
+   {
+      long left = n;
+      while (left > 0)
+      {
+         long chip = static_cast<long>(phase >> FRAC_BITS);
+         if (chip >= CHIPS_PER_6SEC)
+         {
+            phase -= static_cast<uint64_t>(CHIPS_PER_6SEC) << FRAC_BITS;
+            ++sixSeconds;
+            gen.increment4ZCounts();
+            windowBegin = windowEnd = 0;
+            continue;
+         }
+         if (chip >= windowEnd * MAX_BIT)
+            fillWindow(chip);
+
+            // the samples up to the end of the window
+         uint64_t start = static_cast<uint64_t>(windowBegin * MAX_BIT)
+            << FRAC_BITS;
+         uint64_t end = static_cast<uint64_t>(windowEnd * MAX_BIT)
+            << FRAC_BITS;
+         long m = static_cast<long>((end - phase + step - 1) / step);
+         if (m > left) m = left;
+
+#ifdef PCODEREPLICA_AVX2
+         if (useAVX2)
+            sampleAVX2(samples, &window[0], phase - start, step, m);
+         else
+#endif
+            sampleScalar(samples, &window[0], phase - start, step, m);
+         samples += m;
+         left -= m;
+         phase += m * step;
+      }
+   }
+
+   void PCodeReplica::generatePacked( uint32_t* words, const long n )
+   {
+         // a block of samples at a time, a multiple of 32
+      const long BLOCK = 4096;
+      int8_t samples[BLOCK];
+      for (long k=0; k<n; k+=BLOCK)
+      {
+         long m = (n-k < BLOCK) ? n-k : BLOCK;
+         generate(samples, m);
+#ifdef PCODEREPLICA_AVX2
+         if (useAVX2)
+            packAVX2(words + k/MAX_BIT, samples, m);
+         else
+#endif
+            packScalar(words + k/MAX_BIT, samples, m);
+      }
+   }
+
+   void PCodeReplica::fillWindow( const long chip )
+   {
+      windowBegin = chip / MAX_BIT;
+      windowEnd = windowBegin + WINDOW_WORDS;
+      if (windowEnd > NUM_6SEC_WORDS) windowEnd = NUM_6SEC_WORDS;
+      gen.getCurrentWords(&window[0], windowBegin, windowEnd);
+   }
+}     // end of namespace
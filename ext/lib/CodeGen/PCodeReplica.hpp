@@ -0,0 +1,147 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#ifndef PCODEREPLICA_HPP
+#define PCODEREPLICA_HPP
+
+#include <vector>
+#include "gpstkplatform.h"
+#include "GNSSconstants.hpp"
+#include "GPSZcount.hpp"
+#include "SVPCodeGen.hpp"
+
+namespace gpstk
+{
+/// @ingroup code
+//@{
+   /**
+    *  PCodeReplica generates the P-code of one SV as a stream of samples at
+    *  an arbitrary sample rate, e.g. as the replica for a correlator.  The
+    *  stream starts a given number of chips after a Z-count; each call to
+    *  generate( ) or generatePacked( ) continues where the previous one
+    *  stopped, across six-second boundaries.
+    *
+    *  Sample k is the chip at chipOffset + k * chipRate / sampleRate chips
+    *  after the start Z-count (rounded down to the chip).  The chip position
+    *  is kept as a fixed-point number with FRAC_BITS bits of fraction, so
+    *  the replica drifts less than 2^-(FRAC_BITS+1) chips per sample from
+    *  the exact rate.
+    *
+    *  The chips are generated from X1Sequence and X2Sequence a window of
+    *  WINDOW_WORDS words at a time with SVPCodeGen::getCurrentWords( ),
+    *  without a CodeBuffer.  Sampling the window is done eight samples at a
+    *  time with AVX2 gather instructions when the CPU supports them.  As
+    *  with SVPCodeGen, X1Sequence::allocateMemory( ) and
+    *  X2Sequence::allocateMemory( ) must be called first.
+    */
+   class PCodeReplica
+   {
+   public:
+         /// Bits of fraction in the chip position
+      static const int FRAC_BITS = 36;
+
+         /// Number of 32-chip words generated at a time
+      static const long WINDOW_WORDS = 1024;
+
+      /**
+       *  @param SVPRNID PRN ID of the SV, 1-210 as for SVPCodeGen
+       *  @param z Z-count; rounded BACK to a four Z-count boundary
+       *  @param chipOffset chips after z of the first sample, >= 0
+       *  @param sampleRate samples per second
+       *  @param chipRate code chips per second, including any code Doppler
+       *  @throw Exception if an argument is out of range
+       */
+      PCodeReplica( const int SVPRNID,
+                    const gpstk::GPSZcount& z,
+                    const double chipOffset,
+                    const double sampleRate,
+                    const double chipRate = PY_CHIP_FREQ_GPS );
+
+      /**
+       *  Generate the next n samples as +1 (chip 0) or -1 (chip 1).
+       */
+      void generate( int8_t* samples, const long n );
+
+      /**
+       *  Generate the next n samples as bits, 32 to a word, with the first
+       *  sample in the MSB of words[0] as in CodeBuffer.  A bit is the value
+       *  of the chip.  If n is not a multiple of 32, the unused bits of the
+       *  last word are 0.
+       */
+      void generatePacked( uint32_t* words, const long n );
+
+      /**
+       *  Change the chip rate (e.g. for a new code Doppler) from the next
+       *  sample on.
+       *  @throw Exception if chipRate is out of range
+       */
+      void setChipRate( const double chipRate );
+
+         /// Return the chips after the start Z-count of the next sample.
+      double getChipOffset( ) const;
+
+      /**
+       *  Choose the implementation.  The kernel is passed to the SVPCodeGen
+       *  that fills the window; AVX2_KERNEL (or AUTO_KERNEL on a CPU with
+       *  AVX2) also samples the window with AVX2.
+       *  @throw Exception if AVX2_KERNEL is not supported
+       */
+      void setKernel( const SVPCodeGen::Kernel k );
+
+   private:
+         /// Generate the window of words that holds chip.
+      void fillWindow( const long chip );
+
+      gpstk::SVPCodeGen gen;
+      double sampleRate;
+         /// Chips per sample, FRAC_BITS of fraction
+      uint64_t step;
+         /// Chip of the next sample in the current six seconds
+      uint64_t phase;
+         /// Six-second intervals since the start Z-count
+      long sixSeconds;
+         /// Words [windowBegin, windowEnd) of the current six seconds
+      std::vector<uint32_t> window;
+      long windowBegin;
+      long windowEnd;
+      bool useAVX2;
+   };
+   //@}
+}     // end of namespace
+#endif // PCODEREPLICA_HPP
@@ -38,14 +38,82 @@
 
 
 #include <iostream>
+#include <thread>
 #include "SVPCodeGen.hpp"
 #include "GPSWeekZcount.hpp"
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SVPCODEGEN_AVX2
+#include <immintrin.h>
+#endif
+
 using namespace std;
 namespace gpstk
 {
    const long LAST_6SEC_ZCOUNT_OF_WEEK = 403200 - 4;
 
+      // Number of words in a block of the multi-SV getCurrentSixSeconds( ).
+      // 16K words of X1 (64 KB) stay in L2 cache while every SV uses them.
+   const long SIX_SEC_BLOCK_WORDS = 16384;
+
+   namespace
+   {
+         /*
+            Combine n words of X1 with n words of X2 starting at bit offset
+            'offset' (0 to MAX_BIT-1) of x2[0].  Reads x2[0] through x2[n].
+         */
+      template <class Word>
+      void combineScalar( Word* out, const uint32_t* x1,
+                          const uint32_t* x2, const unsigned offset,
+                          const long n )
+      {
+         const unsigned shift = MAX_BIT - offset;
+         uint64_t pair = x2[0];
+         for (long k=0; k<n; ++k)
+         {
+            pair = (pair << MAX_BIT) | x2[k+1];
+            out[k] = x1[k] ^ static_cast<uint32_t>(pair >> shift);
+         }
+      }
+
+#ifdef SVPCODEGEN_AVX2
+         // Same as combineScalar, eight words at a time.
+      template <class Word>
+      __attribute__((target("avx2")))
+      void combineAVX2( Word* out, const uint32_t* x1,
+                        const uint32_t* x2, const unsigned offset,
+                        const long n )
+      {
+            // _mm256_srl_epi32 by MAX_BIT gives 0, as merge( ) wants
+            // for an offset of 0
+         const __m128i left = _mm_cvtsi32_si128(offset);
+         const __m128i right = _mm_cvtsi32_si128(MAX_BIT - offset);
+         long k = 0;
+         for (; k+8<=n; k+=8)
+         {
+            __m256i w1 = _mm256_loadu_si256((const __m256i*)(x2+k));
+            __m256i w2 = _mm256_loadu_si256((const __m256i*)(x2+k+1));
+            __m256i v = _mm256_or_si256(_mm256_sll_epi32(w1, left),
+                                        _mm256_srl_epi32(w2, right));
+            v = _mm256_xor_si256(v,
+                   _mm256_loadu_si256((const __m256i*)(x1+k)));
+            if (sizeof(Word) == 8)
+            {
+               _mm256_storeu_si256((__m256i*)(out+k),
+                  _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+               _mm256_storeu_si256((__m256i*)(out+k+4),
+                  _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+            }
+            else
+            {
+               _mm256_storeu_si256((__m256i*)(out+k), v);
+            }
+         }
+         if (k<n) combineScalar(out+k, x1+k, x2+k, offset, n-k);
+      }
+#endif
+   }
+
    SVPCodeGen::SVPCodeGen( const int SVPRNID, const gpstk::CommonTime& dt )
    {
       if (SVPRNID < 0 || SVPRNID > 210)
@@ -55,9 +123,97 @@ namespace gpstk
       }
       currentZTime = dt;
       PRNID = SVPRNID;
+      setKernel(AUTO_KERNEL);
+   }
+
+   bool SVPCodeGen::haveAVX2( )
+   {
+#ifdef SVPCODEGEN_AVX2
+      static const bool avx2 = __builtin_cpu_supports("avx2");
+      return avx2;
+#else
+      return false;
+#endif
+   }
+
+   void SVPCodeGen::setKernel( const Kernel k )
+   {
+      if (k==AUTO_KERNEL)
+      {
+         kernel = haveAVX2() ? AVX2_KERNEL : SCALAR_KERNEL;
+         return;
+      }
+      if (k==AVX2_KERNEL && !haveAVX2())
+      {
+         gpstk::Exception e("AVX2 is not supported on this CPU");
+         GPSTK_THROW(e);
+      }
+      kernel = k;
    }
 
    void SVPCodeGen::getCurrentSixSeconds( CodeBuffer& pcb )
+   {
+      long X2start = startX2Count();
+      pcb.updateBufferStatus( currentZTime, P_CODE );
+      generateWords(&pcb[0], X2start, 0, NUM_6SEC_WORDS);
+   }
+
+   void SVPCodeGen::getCurrentWords( uint32_t* words, const long begin,
+                                     const long end )
+   {
+      long X2start = startX2Count();
+      generateWords(words, X2start, begin, end);
+   }
+
+   void SVPCodeGen::getCurrentSixSeconds( const vector<SVPCodeGen*>& gens,
+                                          const vector<CodeBuffer*>& pcbs,
+                                          unsigned int nThreads )
+   {
+      if (gens.size() != pcbs.size())
+      {
+         gpstk::Exception e("Must provide one CodeBuffer per SVPCodeGen");
+         GPSTK_THROW(e);
+      }
+      vector<long> X2starts(gens.size());
+      for (size_t j=0; j<gens.size(); ++j)
+      {
+         X2starts[j] = gens[j]->startX2Count();
+         pcbs[j]->updateBufferStatus( gens[j]->currentZTime, P_CODE );
+      }
+
+      long numBlocks = (NUM_6SEC_WORDS + SIX_SEC_BLOCK_WORDS - 1) /
+                       SIX_SEC_BLOCK_WORDS;
+      if (nThreads < 1) nThreads = 1;
+      if (nThreads > numBlocks) nThreads = numBlocks;
+
+         // Interleave the blocks, so that the threads move through X1
+         // together.
+      vector<thread> threads;
+      for (unsigned int t=1; t<nThreads; ++t)
+         threads.push_back(thread(generateBlocks, cref(gens), cref(pcbs),
+                                  cref(X2starts), t, nThreads));
+      generateBlocks(gens, pcbs, X2starts, 0, nThreads);
+      for (size_t t=0; t<threads.size(); ++t)
+         threads[t].join();
+   }
+
+   void SVPCodeGen::generateBlocks( const vector<SVPCodeGen*>& gens,
+                                    const vector<CodeBuffer*>& pcbs,
+                                    const vector<long>& X2starts,
+                                    const long first, const long stride )
+   {
+      for (long begin=first*SIX_SEC_BLOCK_WORDS; begin<NUM_6SEC_WORDS;
+           begin+=stride*SIX_SEC_BLOCK_WORDS)
+      {
+         long end = begin + SIX_SEC_BLOCK_WORDS;
+         if (end > NUM_6SEC_WORDS) end = NUM_6SEC_WORDS;
+         for (size_t j=0; j<gens.size(); ++j)
+            gens[j]->generateWords(&(*pcbs[j])[begin], X2starts[j],
+                                   begin, end);
+      }
+   }
+
+   long SVPCodeGen::startX2Count( )
    {
          // Compute appropriate X2A offset
       int dayAdvance = (PRNID - 1) / 37;
@@ -96,16 +252,60 @@ namespace gpstk
          */
       if ( X1count==LAST_6SEC_ZCOUNT_OF_WEEK) X2Seq.setEOWX2Epoch(true);
        else X2Seq.setEOWX2Epoch(false);
-   
-         // Update the time and code state in the CodeBuffer object
-      pcb.updateBufferStatus( currentZTime, P_CODE );
-   
-         // Starting at the beginning of the interval, step through
-         // the six second period loading the code buffer as we go.
-      for ( long i=0;i<NUM_6SEC_WORDS;++i )
+
+      return X2count;
+   }
+
+   template <class Word>
+   void SVPCodeGen::generateWords( Word* out, const long X2start,
+                                   const long begin, const long end )
+   {
+         // X2 count of word 'begin'; it wraps at most once in six seconds
+      long X2count = X2start + begin * MAX_BIT;
+      if (X2count>=MAX_X2_TEST) X2count -= MAX_X2_TEST;
+
+      if (kernel==REFERENCE_KERNEL)
       {
-         pcb[i] = X1Seq[i] ^ X2Seq[X2count];
-         X2count += MAX_BIT;
+            // Starting at the beginning of the interval, step through
+            // the six second period loading the code buffer as we go.
+         for ( long i=begin;i<end;++i )
+         {
+            out[i-begin] = X1Seq[i] ^ X2Seq[X2count];
+            X2count += MAX_BIT;
+            if (X2count>=MAX_X2_TEST) X2count -= MAX_X2_TEST;
+         }
+         return;
+      }
+
+      const uint32_t* x1 = &X1Seq[0];
+      const uint32_t* x2 = X2Seq.getWords();
+      long i = begin;
+      while (i<end)
+      {
+            // A word that straddles the rollover of the X2 sequence
+         if (X2count > MAX_X2_TEST - MAX_BIT)
+         {
+            out[i-begin] = X1Seq[i] ^ X2Seq[X2count];
+            ++i;
+            X2count += MAX_BIT;
+            if (X2count>=MAX_X2_TEST) X2count -= MAX_X2_TEST;
+            continue;
+         }
+
+            // The run of words up to the rollover, all at the same offset
+         long n = (MAX_X2_TEST - MAX_BIT - X2count) / MAX_BIT + 1;
+         if (n > end-i) n = end-i;
+         long adjustedCount = X2count + X2A_EPOCH_DELAY;
+         const uint32_t* w = x2 + adjustedCount / MAX_BIT;
+         unsigned offset = adjustedCount % MAX_BIT;
+#ifdef SVPCODEGEN_AVX2
+         if (kernel==AVX2_KERNEL)
+            combineAVX2(out+i-begin, x1+i, w, offset, n);
+         else
+#endif
+            combineScalar(out+i-begin, x1+i, w, offset, n);
+         i += n;
+         X2count += n * MAX_BIT;
          if (X2count>=MAX_X2_TEST) X2count -= MAX_X2_TEST;
       }
    }
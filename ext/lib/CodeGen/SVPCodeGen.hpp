@@ -40,6 +40,7 @@
 #ifndef SVPCODEGEN_HPP
 #define SVPCODEGEN_HPP
 
+#include <vector>
 #include "CommonTime.hpp"
 #include "PCodeConst.hpp"
 #include "CodeBuffer.hpp"
@@ -92,10 +93,30 @@ namespace gpstk
     *  means that it is necessary to keep track of the bit position within the
     *  X2 sequence and "chop out" 32 bits at a time.  See documentation for the
     *  class X2Sequence for more information.
+    *
+    *  Between rollovers of the X2 sequence, the X2 bits for successive words
+    *  are successive words of the X2 sequence shifted by the same number of
+    *  bits.  getCurrentSixSeconds( ) uses this to combine the sequences a
+    *  run of words at a time, either eight words at a time with AVX2
+    *  instructions or one word at a time from 64-bit loads, chosen at run
+    *  time by the CPU; see setKernel( ).  Only the words that straddle a
+    *  rollover use X2Sequence::operator[].  All the kernels produce the same
+    *  bits, in the same CodeBuffer format.  The static getCurrentSixSeconds( )
+    *  generates code for many SVs at once, e.g. all 37 PRNs, in blocks that
+    *  share the X1 words, and divides the blocks among threads.
     */
    class SVPCodeGen
    {
    public:
+      /// The implementations of getCurrentSixSeconds( )
+      enum Kernel
+      {
+         AUTO_KERNEL,      ///< the fastest one the CPU supports (default)
+         REFERENCE_KERNEL, ///< the original loop on X2Sequence::operator[]
+         SCALAR_KERNEL,    ///< one word at a time from 64-bit loads
+         AVX2_KERNEL       ///< eight words at a time with AVX2
+      };
+
       /**
        *  SVPCodeGen::SVPCodeGen( const int PRNID, const CommonTime ) - 
        *  Instantiate and initialize a SVPCodeGen object.  Based on the
@@ -117,6 +138,42 @@ namespace gpstk
        *  the sequence.
        */
       void getCurrentSixSeconds( CodeBuffer& pcb );
+
+      /**
+       *  Generate six seconds of code for several SVs at once, as
+       *  gens[i]->getCurrentSixSeconds(*pcbs[i]) for each i.  The six
+       *  seconds are divided into blocks, each small enough that its X1
+       *  words stay in cache while the blocks of all the SVs are generated,
+       *  and the blocks are divided among nThreads threads (including the
+       *  calling thread).  Each generator uses its own kernel.
+       *  @throw Exception if gens and pcbs differ in size
+       */
+      static void getCurrentSixSeconds( const std::vector<SVPCodeGen*>& gens,
+                                        const std::vector<CodeBuffer*>& pcbs,
+                                        unsigned int nThreads = 1 );
+
+      /**
+       *  Generate words [begin, end) of the current six seconds into
+       *  words[0] to words[end-begin-1], in the format of CodeBuffer but
+       *  without its storage, e.g. to work through six seconds a block at
+       *  a time.  0 <= begin <= end <= NUM_6SEC_WORDS.
+       */
+      void getCurrentWords( uint32_t* words, const long begin,
+                            const long end );
+
+      /**
+       *  Choose the implementation of getCurrentSixSeconds( ).  AUTO_KERNEL
+       *  selects AVX2_KERNEL if the CPU supports it and SCALAR_KERNEL
+       *  otherwise.
+       *  @throw Exception if AVX2_KERNEL is not supported
+       */
+      void setKernel( const Kernel k );
+
+      /// Return the implementation in use (never AUTO_KERNEL).
+      Kernel getKernel( ) const { return kernel; }
+
+      /// Return true if AVX2_KERNEL is available on this CPU and compiler.
+      static bool haveAVX2( );
          
       /**
        * Generally, the only action is to increment the Z-count by 
@@ -140,10 +197,36 @@ namespace gpstk
       void setCurrentZCount(const gpstk::GPSZcount& z);
      
    private:
+      /**
+       *  Set the X2 sequence (regular or EOW) for the current six seconds.
+       *  @return the X2 chip count for the first word
+       */
+      long startX2Count( );
+
+      /**
+       *  Generate words [begin, end) of the current six seconds into
+       *  out[0] to out[end-begin-1], given the X2 chip count X2start of
+       *  word 0.
+       */
+      template <class Word>
+      void generateWords( Word* out, const long X2start,
+                          const long begin, const long end );
+
+      /**
+       *  Generate blocks first, first+stride, ... of the current six seconds
+       *  for each of gens into the corresponding pcbs; X2starts are the
+       *  values returned by startX2Count( ).
+       */
+      static void generateBlocks( const std::vector<SVPCodeGen*>& gens,
+                                  const std::vector<CodeBuffer*>& pcbs,
+                                  const std::vector<long>& X2starts,
+                                  const long first, const long stride );
+
       gpstk::X1Sequence X1Seq;
       gpstk::X2Sequence X2Seq;
       gpstk::CommonTime currentZTime;
       int PRNID;
+      Kernel kernel;
    };
    //@}
 }     // end of namespace
@@ -183,6 +183,13 @@ namespace gpstk
              */
          void setEOWX2Epoch( const bool tf );
 
+            /** Return the packed X2 bits in use (regular or EOW), MSB
+             *  first; bit i of the sequence, numbered from -37 as in
+             *  operator[], is bit (i+37)%32 of word (i+37)/32.  There are
+             *  NUM_X2_WORDS words, of which MAX_X2_COUNT bits are valid.
+             */
+         const uint32_t* getWords( ) const { return(bitsP); }
+
       private:
          uint32_t *bitsP;
          static uint32_t* X2Bits;
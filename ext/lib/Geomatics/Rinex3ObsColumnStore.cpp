@@ -0,0 +1,281 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsColumnStore.cpp  Columnar (struct-of-arrays) store of RINEX
+/// observation data, indexed by epoch, satellite slot and obs type.
+
+#include "Rinex3ObsColumnStore.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::clear(void)
+{
+   obstypes.clear();
+   sats.clear();
+   slotForSat.clear();
+   times.clear();
+   clocks.clear();
+   flags.clear();
+   values.clear();
+   llis.clear();
+   ssis.clear();
+   dataBlanks.clear();
+   lliBlanks.clear();
+   ssiBlanks.clear();
+   present.clear();
+   firstEpoch.clear();
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::setObsTypes(const vector<string>& ots)
+{
+   clear();
+   obstypes = ots;
+}
+
+//------------------------------------------------------------------------------------
+int Rinex3ObsColumnStore::addObsType(const string& ot)
+{
+   const int nobs(obstypes.size());
+   obstypes.push_back(ot);
+   if(sats.size() == 0) return nobs;
+
+   // insert an empty column after the last column of each slot
+   vector< vector<double> > newvalues(sats.size()*(nobs+1));
+   vector< vector<unsigned char> > newllis(newvalues.size()), newssis(newvalues.size());
+   vector< vector<bool> > newdblanks(newvalues.size()),
+                          newlblanks(newvalues.size()), newsblanks(newvalues.size());
+   for(unsigned int slot=0; slot<sats.size(); slot++) {
+      for(int obs=0; obs<nobs; obs++) {
+         newvalues[slot*(nobs+1)+obs].swap(values[slot*nobs+obs]);
+         newllis[slot*(nobs+1)+obs].swap(llis[slot*nobs+obs]);
+         newssis[slot*(nobs+1)+obs].swap(ssis[slot*nobs+obs]);
+         newdblanks[slot*(nobs+1)+obs].swap(dataBlanks[slot*nobs+obs]);
+         newlblanks[slot*(nobs+1)+obs].swap(lliBlanks[slot*nobs+obs]);
+         newsblanks[slot*(nobs+1)+obs].swap(ssiBlanks[slot*nobs+obs]);
+      }
+   }
+   values.swap(newvalues);
+   llis.swap(newllis);
+   ssis.swap(newssis);
+   dataBlanks.swap(newdblanks);
+   lliBlanks.swap(newlblanks);
+   ssiBlanks.swap(newsblanks);
+
+   return nobs;
+}
+
+//------------------------------------------------------------------------------------
+unsigned int Rinex3ObsColumnStore::addEpoch(const CommonTime& tt, double clk,
+                                            short flag)
+{
+   if(times.size() > 0 && tt < times.back()) {
+      Exception e("Epochs must be added in time order");
+      GPSTK_THROW(e);
+   }
+   times.push_back(tt);
+   clocks.push_back(clk);
+   flags.push_back(flag);
+   return times.size()-1;
+}
+
+//------------------------------------------------------------------------------------
+int Rinex3ObsColumnStore::addSlot(const RinexSatID& sat)
+{
+   map<RinexSatID,int>::const_iterator it(slotForSat.find(sat));
+   if(it != slotForSat.end()) return it->second;
+
+   const int slot(sats.size());
+   sats.push_back(sat);
+   slotForSat[sat] = slot;
+   present.push_back(vector<unsigned char>());
+   firstEpoch.push_back(0);
+   values.resize(values.size() + obstypes.size());
+   llis.resize(values.size());
+   ssis.resize(values.size());
+   dataBlanks.resize(values.size());
+   lliBlanks.resize(values.size());
+   ssiBlanks.resize(values.size());
+
+   return slot;
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::setDatum(unsigned int epoch, int slot, int obs,
+                                    const RinexDatum& rd)
+{
+   if(epoch >= times.size() || slot < 0 || slot >= int(sats.size())
+         || obs < 0 || obs >= int(obstypes.size())) {
+      Exception e("Invalid index in Rinex3ObsColumnStore::setDatum");
+      GPSTK_THROW(e);
+   }
+
+   // the columns of a slot start at its first datum
+   if(present[slot].empty())
+      firstEpoch[slot] = epoch;
+   else if(epoch < firstEpoch[slot])
+      prependEpochs(slot, epoch);
+   const unsigned int i(epoch - firstEpoch[slot]);
+
+   const unsigned int col(column(slot,obs));
+   // columns grow only as far as they are written; fill gaps as blank
+   if(values[col].size() <= i) {
+      values[col].resize(i+1, 0.0);
+      llis[col].resize(i+1, 0);
+      ssis[col].resize(i+1, 0);
+      dataBlanks[col].resize(i+1, true);
+      lliBlanks[col].resize(i+1, true);
+      ssiBlanks[col].resize(i+1, true);
+   }
+   values[col][i] = rd.data;
+   llis[col][i] = static_cast<unsigned char>(rd.lli);
+   ssis[col][i] = static_cast<unsigned char>(rd.ssi);
+   dataBlanks[col][i] = rd.dataBlank;
+   lliBlanks[col][i] = rd.lliBlank;
+   ssiBlanks[col][i] = rd.ssiBlank;
+
+   if(present[slot].size() <= i) present[slot].resize(i+1, 0);
+   present[slot][i] = 1;
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::prependEpochs(int slot, unsigned int epoch)
+{
+   const unsigned int n(firstEpoch[slot] - epoch);
+   for(unsigned int obs=0; obs<obstypes.size(); obs++) {
+      const unsigned int col(column(slot,obs));
+      if(values[col].empty()) continue;
+      values[col].insert(values[col].begin(), n, 0.0);
+      llis[col].insert(llis[col].begin(), n, 0);
+      ssis[col].insert(ssis[col].begin(), n, 0);
+      dataBlanks[col].insert(dataBlanks[col].begin(), n, true);
+      lliBlanks[col].insert(lliBlanks[col].begin(), n, true);
+      ssiBlanks[col].insert(ssiBlanks[col].begin(), n, true);
+   }
+   present[slot].insert(present[slot].begin(), n, 0);
+   firstEpoch[slot] = epoch;
+}
+
+//------------------------------------------------------------------------------------
+RinexDatum Rinex3ObsColumnStore::getDatum(unsigned int epoch, int slot, int obs)
+   const
+{
+   RinexDatum rd;
+   const unsigned int col(column(slot,obs));
+   unsigned int i;
+   if(row(epoch,slot,i) && i < values[col].size()) {
+      rd.data = values[col][i];
+      rd.lli = llis[col][i];
+      rd.ssi = ssis[col][i];
+      rd.dataBlank = dataBlanks[col][i];
+      rd.lliBlank = lliBlanks[col][i];
+      rd.ssiBlank = ssiBlanks[col][i];
+   }
+   else
+      rd.dataBlank = rd.lliBlank = rd.ssiBlank = true;
+   return rd;
+}
+
+//------------------------------------------------------------------------------------
+Rinex3ObsData Rinex3ObsColumnStore::getEpoch(unsigned int epoch) const
+{
+   Rinex3ObsData rod;
+   rod.time = times[epoch];
+   rod.clockOffset = clocks[epoch];
+   rod.epochFlag = flags[epoch];
+   rod.numSVs = 0;
+
+   map<RinexSatID,int>::const_iterator it;
+   for(it = slotForSat.begin(); it != slotForSat.end(); ++it) {
+      if(!hasData(epoch,it->second)) continue;
+      vector<RinexDatum>& data(rod.obs[it->first]);
+      data.resize(obstypes.size());
+      for(unsigned int obs=0; obs<obstypes.size(); obs++)
+         data[obs] = getDatum(epoch,it->second,obs);
+      rod.numSVs++;
+   }
+
+   return rod;
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore::compact(void)
+{
+   times.shrink_to_fit();
+   clocks.shrink_to_fit();
+   flags.shrink_to_fit();
+   for(unsigned int i=0; i<values.size(); i++) {
+      values[i].shrink_to_fit();
+      llis[i].shrink_to_fit();
+      ssis[i].shrink_to_fit();
+      dataBlanks[i].shrink_to_fit();
+      lliBlanks[i].shrink_to_fit();
+      ssiBlanks[i].shrink_to_fit();
+   }
+   for(unsigned int i=0; i<present.size(); i++)
+      present[i].shrink_to_fit();
+}
+
+//------------------------------------------------------------------------------------
+size_t Rinex3ObsColumnStore::getMemoryUsed(void) const
+{
+   size_t n(0);
+   n += times.capacity()*sizeof(CommonTime);
+   n += clocks.capacity()*sizeof(double);
+   n += flags.capacity()*sizeof(short);
+   n += sats.capacity()*sizeof(RinexSatID);
+   n += slotForSat.size()*(sizeof(RinexSatID)+sizeof(int)+4*sizeof(void*));
+   n += 3*values.capacity()*sizeof(vector<double>);
+   n += 3*dataBlanks.capacity()*sizeof(vector<bool>);
+   for(unsigned int i=0; i<values.size(); i++)
+      n += values[i].capacity()*sizeof(double)
+         + llis[i].capacity() + ssis[i].capacity()
+         + (dataBlanks[i].capacity() + lliBlanks[i].capacity()
+            + ssiBlanks[i].capacity())/8;
+   n += present.capacity()*sizeof(vector<unsigned char>);
+   n += firstEpoch.capacity()*sizeof(unsigned int);
+   for(unsigned int i=0; i<present.size(); i++)
+      n += present[i].capacity();
+   return n;
+}
+
+}  // end namespace gpstk
@@ -0,0 +1,263 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsColumnStore.hpp  Columnar (struct-of-arrays) store of RINEX
+/// observation data, indexed by epoch, satellite slot and obs type.
+
+#ifndef GPSTK_RINEX3_OBS_COLUMN_STORE_INCLUDE
+#define GPSTK_RINEX3_OBS_COLUMN_STORE_INCLUDE
+
+//------------------------------------------------------------------------------------
+// system includes
+#include <string>
+#include <vector>
+#include <map>
+
+// GPSTk
+#include "Exception.hpp"
+#include "CommonTime.hpp"
+#include "RinexSatID.hpp"
+#include "RinexDatum.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk {
+
+//--------------------------------------------------------------------------------
+/// Columnar store of RINEX observation data. Rather than one Rinex3ObsData
+/// (a map of satellites to vectors of RinexDatum) per epoch, the data are held
+/// as one contiguous column per (satellite slot, obs type), each column being
+/// indexed by epoch. Values are stored as double, LLI and SSI as one byte each,
+/// the blank flags of the RinexDatum as one bit each, and a per-slot byte array
+/// records which epochs the satellite has data at.
+/// Epoch-level data (time, clock offset, epoch flag) are held in parallel arrays.
+///
+/// Satellites are assigned a slot the first time they are seen; obs types are
+/// identified by their index in the list given to setObsTypes()/addObsType().
+/// The columns of a slot start at the first epoch written for that satellite,
+/// and each is only as long as the last epoch written to it, so a satellite
+/// costs nothing before it rises or after it sets; it does pay for the epochs
+/// in between, including any gaps in its data. Reads outside a column return
+/// empty data.
+///
+/// This is the storage used by Rinex3ObsFileLoader when saveTheDataAsColumns()
+/// is set; it is typically several times smaller than the equivalent
+/// vector<Rinex3ObsData>, and columns can be read directly (e.g. into SatPass)
+/// without building a Rinex3ObsData per epoch.
+class Rinex3ObsColumnStore
+{
+public:
+   /// empty constructor
+   Rinex3ObsColumnStore(void) { }
+
+   /// remove all data, satellites and obs types
+   void clear(void);
+
+   /// define the obs types (e.g. 4-char RINEX 3 ObsIDs); removes all data
+   /// @param[in] ots vector of obs type labels, in index order
+   void setObsTypes(const std::vector<std::string>& ots);
+
+   /// append an obs type; existing data is kept, with the new type empty
+   /// @param[in] ot obs type label
+   /// @return index of the new obs type
+   int addObsType(const std::string& ot);
+
+   /// add an epoch at the end of the store
+   /// @param[in] tt time tag; must not precede the previous epoch
+   /// @param[in] clk receiver clock offset
+   /// @param[in] flag RINEX epoch flag
+   /// @return index of the new epoch
+   unsigned int addEpoch(const CommonTime& tt, double clk=0.0, short flag=0);
+
+   /// find the slot of a satellite
+   /// @param[in] sat satellite of interest
+   /// @return slot index, or -1 if the satellite is not in the store
+   int getSlot(const RinexSatID& sat) const
+   {
+      std::map<RinexSatID,int>::const_iterator it(slotForSat.find(sat));
+      return (it == slotForSat.end() ? -1 : it->second);
+   }
+
+   /// find or create the slot of a satellite
+   /// @param[in] sat satellite of interest
+   /// @return slot index
+   int addSlot(const RinexSatID& sat);
+
+   /// store a datum
+   /// @param[in] epoch index of the epoch, < getNumEpochs()
+   /// @param[in] slot satellite slot from addSlot()
+   /// @param[in] obs index of the obs type
+   /// @param[in] rd datum to store
+   /// @throw Exception if any index is out of range
+   void setDatum(unsigned int epoch, int slot, int obs, const RinexDatum& rd);
+
+   /// @return true if the satellite in this slot has data at this epoch
+   bool hasData(unsigned int epoch, int slot) const
+   {
+      const std::vector<unsigned char>& col(present[slot]);
+      unsigned int i;
+      return (row(epoch,slot,i) && i < col.size() && col[i] != 0);
+   }
+
+   /// @return data value, or 0 if there is none
+   double getValue(unsigned int epoch, int slot, int obs) const
+   {
+      const std::vector<double>& col(values[column(slot,obs)]);
+      unsigned int i;
+      return (row(epoch,slot,i) && i < col.size() ? col[i] : 0.0);
+   }
+
+   /// @return LLI, or 0 if there is none
+   unsigned short getLLI(unsigned int epoch, int slot, int obs) const
+   {
+      const std::vector<unsigned char>& col(llis[column(slot,obs)]);
+      unsigned int i;
+      return (row(epoch,slot,i) && i < col.size() ? col[i] : 0);
+   }
+
+   /// @return SSI, or 0 if there is none
+   unsigned short getSSI(unsigned int epoch, int slot, int obs) const
+   {
+      const std::vector<unsigned char>& col(ssis[column(slot,obs)]);
+      unsigned int i;
+      return (row(epoch,slot,i) && i < col.size() ? col[i] : 0);
+   }
+
+   /// @return true if the datum at this epoch/slot/obs was blank in the file,
+   /// or was never stored
+   bool isDataBlank(unsigned int epoch, int slot, int obs) const
+   {
+      const std::vector<bool>& col(dataBlanks[column(slot,obs)]);
+      unsigned int i;
+      return (!row(epoch,slot,i) || i >= col.size() || col[i]);
+   }
+
+   /// @return the datum stored at this epoch/slot/obs, including its blank
+   /// flags, or an empty RinexDatum with all fields blank
+   RinexDatum getDatum(unsigned int epoch, int slot, int obs) const;
+
+   /// direct access to a column of values
+   /// @param[in] slot satellite slot
+   /// @param[in] obs index of the obs type
+   /// @param[out] first index of the epoch of the first value
+   /// @param[out] len number of epochs in the column (may be < getNumEpochs())
+   /// @return pointer to the value at epoch first, or 0 if the column is empty
+   const double *getValueColumn(int slot, int obs, unsigned int& first,
+                                unsigned int& len) const
+   {
+      const std::vector<double>& col(values[column(slot,obs)]);
+      first = firstEpoch[slot];
+      len = col.size();
+      return (len > 0 ? &col[0] : 0);
+   }
+
+   /// build a Rinex3ObsData for one epoch, with obs vectors parallel to the
+   /// obs types of this store; only satellites with data are included.
+   /// @param[in] epoch index of the epoch
+   /// @return the Rinex3ObsData
+   Rinex3ObsData getEpoch(unsigned int epoch) const;
+
+   /// release excess capacity; call after loading is complete
+   void compact(void);
+
+   /// @return number of epochs
+   unsigned int getNumEpochs(void) const { return times.size(); }
+   /// @return number of satellite slots
+   int getNumSlots(void) const { return sats.size(); }
+   /// @return number of obs types
+   int getNumObsTypes(void) const { return obstypes.size(); }
+   /// @return obs type labels
+   const std::vector<std::string>& getObsTypes(void) const { return obstypes; }
+   /// @return satellite in a slot
+   const RinexSatID& getSat(int slot) const { return sats[slot]; }
+   /// @return map of satellite to slot, in satellite order
+   const std::map<RinexSatID,int>& getSlotMap(void) const { return slotForSat; }
+   /// @return time of an epoch
+   const CommonTime& getTime(unsigned int epoch) const { return times[epoch]; }
+   /// @return clock offset at an epoch
+   double getClockOffset(unsigned int epoch) const { return clocks[epoch]; }
+   /// @return epoch flag at an epoch
+   short getEpochFlag(unsigned int epoch) const { return flags[epoch]; }
+
+   /// @return approximate number of bytes of heap memory used by the store
+   size_t getMemoryUsed(void) const;
+
+private:
+   /// @return index into values/llis/ssis of the column for slot, obs
+   unsigned int column(int slot, int obs) const
+      { return slot*obstypes.size() + obs; }
+
+   /// find the index of an epoch within the columns of a slot
+   /// @return false if the epoch precedes the slot's first epoch
+   bool row(unsigned int epoch, int slot, unsigned int& i) const
+   {
+      if(epoch < firstEpoch[slot]) return false;
+      i = epoch - firstEpoch[slot];
+      return true;
+   }
+
+   /// start the columns of a slot at an earlier epoch
+   void prependEpochs(int slot, unsigned int epoch);
+
+   std::vector<std::string> obstypes;     ///< obs type labels
+   std::vector<RinexSatID> sats;          ///< satellite for each slot
+   std::map<RinexSatID,int> slotForSat;   ///< slot for each satellite
+
+   std::vector<CommonTime> times;         ///< time of each epoch
+   std::vector<double> clocks;            ///< clock offset of each epoch
+   std::vector<short> flags;              ///< epoch flag of each epoch
+
+   /// for each slot, the epoch at which its columns start
+   std::vector<unsigned int> firstEpoch;
+
+   /// columns of data, index column(slot,obs), each indexed by epoch less
+   /// firstEpoch of the slot
+   std::vector< std::vector<double> > values;
+   std::vector< std::vector<unsigned char> > llis;    ///< parallel to values
+   std::vector< std::vector<unsigned char> > ssis;    ///< parallel to values
+   /// RinexDatum blank flags, parallel to values, one bit per epoch
+   std::vector< std::vector<bool> > dataBlanks;
+   std::vector< std::vector<bool> > lliBlanks;        ///< parallel to values
+   std::vector< std::vector<bool> > ssiBlanks;        ///< parallel to values
+   /// for each slot, indexed as the columns, non-zero where the satellite has data
+   std::vector< std::vector<unsigned char> > present;
+
+}; // end class Rinex3ObsColumnStore
+
+} // end namespace gpstk
+
+#endif      // GPSTK_RINEX3_OBS_COLUMN_STORE_INCLUDE
@@ -42,6 +42,11 @@
 //------------------------------------------------------------------------------------
 // system includes
 #include <iostream>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 
 // GPSTk
 #include "Exception.hpp"
@@ -52,6 +57,7 @@
 #include "Rinex3ObsData.hpp"
 #include "Rinex3ObsStream.hpp"
 #include "MostCommonValue.hpp"
+#include "WorkerPool.hpp"
 
 // geomatics
 #include "Rinex3ObsFileLoader.hpp"
@@ -67,30 +73,465 @@ namespace gpstk
 const double Rinex3ObsFileLoader::dttol(0.001);
 
 //------------------------------------------------------------------------------------
-// Read the files already defined
-// param[out] errmsg an error/warning message, blank for success
-// param[out] msg an informative message
-// return 0 ok, >0 number of files read
-int Rinex3ObsFileLoader::loadFiles(string& errmsg, string& msg)
+namespace {
+   // Decoding headers and data only reads the static RinexObsID tables, which
+   // change only in RinexObsID::newID(), so files are decoded without a lock.
+
+   // Write the reading throughput of one file to msg.
+   void reportRead(ostream& ossx, const string& filename, long nrecords,
+                   long nbytes, double seconds)
+   {
+      ossx << " Read file " << filename << ": " << nrecords
+         << " records, " << nbytes << " bytes in " << fixed
+         << setprecision(3) << seconds << " s ("
+         << setprecision(0)
+         << (seconds > 0.0 ? nrecords/seconds : 0.0)
+         << " records/s, " << setprecision(2)
+         << (seconds > 0.0 ? nbytes/seconds/1.e6 : 0.0)
+         << " MB/s)" << endl;
+   }
+
+   // One input file, with a bounded queue of records read ahead of the merge
+   // in loadFiles(). The stream, header and flags set before 'started' belong to
+   // the thread reading the file; the rest is shared under FileReaderPool::mtx.
+   struct FileReader
+   {
+      FileReader(void) : started(false), opened(false), headerOK(false),
+                         dataOK(true), done(false), dropped(false), busy(false),
+                         nrecords(0), nbytes(0), seconds(0.0) { }
+      string filename;                    ///< file name, blank if not to be read
+      std::unique_ptr<Rinex3ObsStream> strm; ///< open while records remain
+      bool started;                       ///< true once the header was read
+      bool opened;                        ///< true if the file could be opened
+      bool headerOK;                      ///< true if the header was read
+      bool dataOK;                        ///< false if reading stopped on an error
+      bool done;                          ///< true when no more records will come
+      bool dropped;                       ///< true if loadFiles() gave up on it
+      bool busy;                          ///< true while a thread is reading it
+      string errtext;                     ///< text of the header or data exception
+      Rinex3ObsHeader roh;                ///< the header
+      deque<Rinex3ObsData> records;       ///< records read, not yet merged
+      long nrecords;                      ///< number of records read
+      long nbytes;                        ///< size of the file
+      double seconds;                     ///< wall-clock time spent reading
+   };
+
+   // Messages and time order state of one file, as merged by loadFiles().
+   struct FileLog
+   {
+      FileLog(void) : onOrder(false) { }
+      ostringstream errs;                 ///< errors, reported in file order
+      bool onOrder;                       ///< true within out-of-order records
+      vector<int> nOrder;                 ///< number of out-of-order records
+      vector<CommonTime> timeOrder;       ///< epoch preceding them
+   };
+
+   // Open a file and read its header.
+   // return true if records follow the header
+   bool openFile(FileReader& fr)
+   {
+      try {
+         fr.strm.reset(new Rinex3ObsStream(fr.filename.c_str()));
+         if(!fr.strm->is_open()) return false;
+         fr.opened = true;
+         fr.strm->seekg(0, ios::end);
+         fr.nbytes = fr.strm->tellg();
+         fr.strm->seekg(0, ios::beg);
+         fr.strm->exceptions(fstream::failbit);
+         *fr.strm >> fr.roh;
+         fr.headerOK = true;
+      }
+      catch(Exception& e) {
+         fr.errtext = e.getText(0);
+      }
+      catch(std::exception& e) {
+         fr.errtext = string("std except: ") + e.what();
+      }
+      return fr.headerOK;
+   }
+
+   // Read up to n records from an open file into recs.
+   // return true if the file has ended, at EOF or on an error
+   bool readRecords(FileReader& fr, vector<Rinex3ObsData>& recs, unsigned int n)
+   {
+      try {
+         Rinex3ObsData rod;
+         for(unsigned int i=0; i<n; i++) {
+            *fr.strm >> rod;
+            if(fr.strm->eof() || !fr.strm->good()) return true;
+            recs.push_back(rod);
+         }
+         return false;
+      }
+      catch(Exception& e) {
+         fr.dataOK = false;
+         fr.errtext = e.getText(0);
+      }
+      catch(std::exception& e) {
+         fr.dataOK = false;
+         fr.errtext = string("std except: ") + e.what();
+      }
+      return true;
+   }
+
+   // Readers for a list of files, each keeping up to 'depth' records queued
+   // ahead of the merge; the threads top up the files most in need.
+   // The destructor stops and joins the threads, also when loadFiles throws.
+   class FileReaderPool
+   {
+   public:
+      FileReaderPool(vector<FileReader>& fr, int nthreads, unsigned int nrec)
+         : files(fr), depth(nrec), stop(false), workers(nthreads)
+      {
+         workers.start([this](unsigned int) { work(); });
+      }
+
+      ~FileReaderPool(void)
+      {
+         {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
+         }
+         cv.notify_all();
+         // workers, the last member, is destroyed first and waits for the threads
+      }
+
+      // wait for the header of file nf to be read
+      FileReader& header(unsigned int nf)
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         while(!files[nf].started) cv.wait(lock);
+         return files[nf];
+      }
+
+      // move the next record of file nf into rod
+      // return false if the file has no more records
+      bool pop(unsigned int nf, Rinex3ObsData& rod)
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         FileReader& fr(files[nf]);
+         while(fr.records.empty() && !fr.done && !fr.dropped) cv.wait(lock);
+         if(fr.records.empty() || fr.dropped) return false;
+         std::swap(rod, fr.records.front());
+         fr.records.pop_front();
+         cv.notify_all();
+         return true;
+      }
+
+      // stop reading file nf
+      void drop(unsigned int nf)
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         files[nf].dropped = true;
+         files[nf].records.clear();
+      }
+
+   private:
+      // open file nf if need be and read until its queue is full; called and
+      // returns with the lock held, which is released while reading
+      void read(unsigned int nf, std::unique_lock<std::mutex>& lock)
+      {
+         FileReader& fr(files[nf]);
+         fr.busy = true;
+         bool first(!fr.started);
+         unsigned int n(depth - fr.records.size());
+         lock.unlock();
+
+         std::chrono::steady_clock::time_point t0(std::chrono::steady_clock::now());
+         vector<Rinex3ObsData> recs;
+         bool end(first && !openFile(fr));
+         if(!end) end = readRecords(fr, recs, n);
+         if(end) fr.strm.reset();
+         fr.seconds += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - t0).count();
+
+         lock.lock();
+         fr.started = true;
+         fr.done = end;
+         fr.nrecords += recs.size();
+         if(!fr.dropped)
+            for(unsigned int i=0; i<recs.size(); i++)
+               fr.records.push_back(recs[i]);
+         fr.busy = false;
+         cv.notify_all();
+      }
+
+      // thread function: top up the emptiest queue until there are none left
+      void work(void)
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         while(!stop) {
+            int nf(-1);
+            bool more(false);
+            for(unsigned int i=0; i<files.size(); i++) {
+               const FileReader& fr(files[i]);
+               if(fr.done || fr.dropped) continue;
+               more = true;
+               if(fr.busy || fr.records.size() >= depth) continue;
+               if(nf == -1 || fr.records.size() < files[nf].records.size())
+                  nf = i;
+            }
+            if(!more) return;
+            if(nf == -1)
+               cv.wait(lock);
+            else
+               read(nf, lock);
+         }
+      }
+
+      vector<FileReader>& files;
+      unsigned int depth;                 ///< maximum records queued per file
+      bool stop;                          ///< tells the threads to quit
+      std::mutex mtx;
+      std::condition_variable cv;
+      WorkerPool workers;                 ///< the threads, running work()
+   };
+}
+
+//------------------------------------------------------------------------------------
+// Update the wanted obs types, counts and column store from a header.
+void Rinex3ObsFileLoader::processHeader(const Rinex3ObsHeader& roh,
+                                        const string& filename, ostream& ossx)
 {
-try {
-   int nint;
    unsigned int i,j;
-   double dt;
-   string str;
+   map< RinexSatID, vector<int> >::iterator soit;     // SatObsCountMap
 
    // current latest RINEX version
    // critical to ObsID identification independent of RINEX version
    const double currVer(Rinex3ObsBase::currentVersion);
 
-   // Rinex3ObsHeader from Rinex3ObsHeader class GPSTk class
-   // roh = rinex obs header
-   Rinex3ObsHeader roh;
-   // Rinex3ObsData from Rinex3ObsData class in GPSTk
-   // rod = rinex obs data, and outrod = output rinex obs data?
-   Rinex3ObsData rod, outrod;
-   vector<string>::const_iterator vit;
+   // update list of wanted obs types
+   // create iterator for looping through roh.mapObsTypes
+   // make it a const_iterator, so that it can be used for access only,
+   // and cannot be used for modification
+   // the roh.mapObsTypes is of type RinexObsMap, which has format
+   // map<string,RinexObsVec> == map<string,vector<RinexObsID>>
+   // A map where string values are the keys and vector<RinexObsID>
+   // are the values mapped to those strings
+   map<string,vector<RinexObsID> >::const_iterator kt;
+   for(kt = roh.mapObsTypes.begin(); kt != roh.mapObsTypes.end(); kt++) {
+      for(i=0; i<kt->second.size(); i++) {
+         // need 4-char string version of ObsID
+         string sys = kt->first;                      // system
+         string rot = kt->second[i].asString(currVer);// 3-char id
+         string srot = sys + rot;                     // 4-char id
+         string code = rot.substr(2,1);               // tracking code
+
+         // is this ObsID Wanted? and should it be added?
+         // NB RinexObsID::operator==() handles '*' but does not compare sys
+         // NB input (loadObsID()) checks validity of ObsIDs
+
+         for(j=0; j<inputWantedObsTypes.size(); j++) {
+            if(vectorindex(wantedObsTypes,srot) != -1)
+               continue;                                 // already there
+
+            // wsrot = wanted string rinex obs type
+            string wsrot(inputWantedObsTypes[j]);
+
+            string wsys(wsrot.substr(0,1));
+            if(wsys != "*" && wsys != sys)               // different systems
+               continue;
+
+            string wcode(wsrot.substr(3,1));
+            if(wcode != "*" && wcode != code)            // different codes
+               continue;
+
+            if(wsrot.substr(1,2) != rot.substr(0,2))     // diff type-freq
+               continue;
+
+            // ok add it
+            wantedObsTypes.push_back(srot);              // add it
+            // the number of observations for each observation type
+            countWantedObsTypes.push_back(0);
+
+            // keep the column store parallel to wantedObsTypes
+            if(saveData && saveColumns) columnStore.addObsType(srot);
+
+            ossx << " Add obs type " << srot
+                  << " =~ " << inputWantedObsTypes[j]
+                  << " from " << filename << endl;
+         }
+      }
+   }  // end loop over obs types in header
+
+   // must keep SatObsCountMap vectors parallel to wantedObsTypes
+   if(SatObsCountMap.size() > 0) {                       // table exists
+      vector<int> v(SatObsCountMap.begin()->second);
+      j = wantedObsTypes.size();
+      if(v.size() < j) {                                 // vectors are short
+         soit = SatObsCountMap.begin();
+         for( ; soit != SatObsCountMap.end(); ++soit)
+            soit->second.resize(j , 0);                  // extend with zeros
+      }
+   }
+
+   headers.push_back(roh);
+}
+
+//------------------------------------------------------------------------------------
+// Edit, count and (optionally) save one epoch of data.
+// return false if no more data should be read
+bool Rinex3ObsFileLoader::processEpoch(Rinex3ObsData& rod, Rinex3ObsHeader& roh,
+                                       bool& onOrder, vector<int>& nOrder,
+                                       vector<CommonTime>& timeOrder)
+{
+   int nint;
+   unsigned int i;
+   double dt;
    map< RinexSatID, vector<int> >::iterator soit;     // SatObsCountMap
+
+   // current latest RINEX version
+   // critical to ObsID identification independent of RINEX version
+   const double currVer(Rinex3ObsBase::currentVersion);
+
+   rod.time.setTimeSystem(TimeSystem::Any);
+
+   // skip aux header, etc
+   if(rod.epochFlag != 0 && rod.epochFlag != 1) return true;
+
+   // decimate to dtdec-even sec-of-week
+   if(dtdec > 0.0) {
+      double sow(static_cast<GPSWeekSecond>(rod.time).sow);
+      //LOG(INFO) << fixed << setprecision(3) << "Dt " << dt
+      //<< " dtdec " << dtdec << " sow " << sow
+      //<< " test " << ::fabs(sow-dtdec*long(0.5+sow/dtdec));
+      if(::fabs(sow - dtdec*long(0.5+sow/dtdec)) > 0.5)
+         return true;
+   }
+
+   // consider timestep
+   if(prevtime != CommonTime::BEGINNING_OF_TIME) {
+      // compute time since the previous epoch
+      dt = rod.time - prevtime;
+
+      if(dt >= dttol) {      // positive dt only
+         // add to the timestep estimator
+         mcv.add(dt);
+      }
+      else if(dt < dttol) {  // negative, and positive but tiny (< dttol)
+         //if(isLenient) {
+            if(!onOrder) {
+               nOrder.push_back(0);
+               timeOrder.push_back(prevtime);
+               onOrder = true;
+            }
+            nOrder[nOrder.size()-1]++;
+            return true;
+         //}
+         //GPSTK_THROW(Exception(string("Records out of time order: dt ")
+         //   + StringUtils::asString<double>(dt) + string(" at time ")
+         //   + printTime(rod.time,timefmt)));
+      }
+      onOrder = false;
+   }
+
+   // set previous time to current time
+   prevtime = rod.time;
+   // ignore data outside of time limits given by user
+   if(rod.time < startTime) return true;
+   if(rod.time > stopTime) return false;
+   if(rod.time < begDataTime) begDataTime = rod.time;
+   if(rod.time > endDataTime) endDataTime = rod.time;
+
+   // The integer number of epochs is advanced
+   nepochs++;
+   if(nepochsToRead > -1 && nepochs >= nepochsToRead) return false;
+
+   // prepare output rod
+   Rinex3ObsData outrod;
+   outrod.time = rod.time;
+   outrod.clockOffset = rod.clockOffset;
+   outrod.epochFlag = rod.epochFlag;
+   //?? outrod.auxHeader.clear();
+   outrod.numSVs = 0;
+   outrod.obs.clear();
+
+   // index of this epoch in the column store, created with its first datum
+   int colEpoch(-1);
+
+   // loop over satellites, counting data per ObsID
+   Rinex3ObsData::DataMap::const_iterator it;
+   for(it=rod.obs.begin(); it != rod.obs.end(); ++it) {
+      // Create new RinexSatID variable called sat, initialize with the
+      // it->first pointer from rod.obs current iteration
+      RinexSatID sat(it->first);
+
+      // is the sat excluded?  NB it does not exclude sat=(sys,-1)
+      if(exSats.size() > 0 &&
+         find(exSats.begin(), exSats.end(), sat) != exSats.end())
+            continue;
+
+      // Exract GNSS system from sat ID, creating new string variable sys
+      string sys(sat.toString().substr(0,1));
+      // Extract the observation types from the rinex obs header object
+      // roh corresponding to the GNSS system from the sat ID, creating
+      // new RinexObsID vector types
+      const vector<RinexObsID> types(roh.mapObsTypes[sys]);
+      // slot of this sat in the column store, found with its first datum
+      int colSlot(-1);
+
+      // loop over obs
+      for(i=0; i<it->second.size(); i++) {
+         // if the obs data is equal to zero, then do not consider that
+         // obs value (equivalent to missing data)
+         if(it->second[i].data == 0.0) continue;   // don't count missing
+
+         // combine the system and obs type into total rinex obs ID
+         string srot = sys + types[i].asString(currVer); // 4-char RinexObsID
+
+         // is it wanted? nint is the index into
+         // wantedObsTypes, SatObsCountMap and outrod.obs
+         // vectorindex returns the index of the value srot in wantedObsTypes
+         // if it doesn't exist in that vector, return -1
+         nint = vectorindex(wantedObsTypes,srot);
+         if(nint == -1) continue;
+
+         // count the sat/obs
+         // map<RinexSatID, std::vector<int>>
+         soit = SatObsCountMap.find(sat);
+         if(soit == SatObsCountMap.end()) {           // add the sat
+            vector<int> v(wantedObsTypes.size(),0);   // keep parallel
+            SatObsCountMap[sat] = v;                  // creates map entry
+         }
+         SatObsCountMap[sat][nint]++;
+         countWantedObsTypes[nint]++;
+
+         // add it to the column store
+         if(saveData && saveColumns) {
+            if(colEpoch == -1)
+               colEpoch = columnStore.addEpoch(rod.time, rod.clockOffset,
+                                               rod.epochFlag);
+            if(colSlot == -1)
+               colSlot = columnStore.addSlot(sat);
+            columnStore.setDatum(colEpoch, colSlot, nint, it->second[i]);
+         }
+         // add it to outrod
+         else if(saveData) {
+            // if the satellite is not in outrod.obs
+            if(outrod.obs.find(sat) == outrod.obs.end()) {
+               vector<RinexDatum> v(wantedObsTypes.size());
+               outrod.obs[sat] = v;
+               outrod.numSVs++;
+            }
+            outrod.obs[sat][nint] = it->second[i];
+         }
+      }
+   }
+
+   // if saving data, save
+   if(saveData && outrod.obs.size() > 0) datastore.push_back(outrod);
+
+   return true;
+}
+
+//------------------------------------------------------------------------------------
+// Read the files already defined
+// param[out] errmsg an error/warning message, blank for success
+// param[out] msg an informative message
+// return 0 ok, >0 number of files read
+int Rinex3ObsFileLoader::loadFiles(string& errmsg, string& msg)
+{
+try {
    ostringstream oss, ossx;
 
    prevtime = CommonTime::BEGINNING_OF_TIME;
@@ -98,17 +539,51 @@ try {
    prevtime.setTimeSystem(TimeSystem::Any);
 
    // read the files
+   int nread(nthreads > 1 ? mergeFiles(oss, ossx) : readFilesInOrder(oss, ossx));
+
+   // time steps
+   rawdt = mcv.bestDT();
+   nominalDT = (dtdec > 0.0 ? (dtdec > rawdt ? dtdec : rawdt) : rawdt);
+
+   if(saveData && saveColumns) columnStore.compact();
+
+   if(!errmsg.empty()) errmsg += string("\n");
+   errmsg += oss.str();
+   if(!errmsg.empty()) {
+      StringUtils::stripTrailing(errmsg,'\n');
+      StringUtils::stripTrailing(errmsg,'\r');
+   }
+   msg = ossx.str();
+   if(!msg.empty()) {
+      StringUtils::stripTrailing(msg,'\n');
+      StringUtils::stripTrailing(msg,'\r');
+   }
+
+   return nread;
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
+catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+// Read the files one after the other, in the order given
+// return number of files read
+int Rinex3ObsFileLoader::readFilesInOrder(ostream& oss, ostream& ossx)
+{
+   unsigned int i;
+   typedef std::chrono::steady_clock Clock;
+
    // initialize number read counter to zero
    int nread(0);
    // loop over file names
    for(unsigned int nf=0; nf<filenames.size(); nf++) {
       // set the file name to a particular string
       string filename(filenames[nf]);
-      // strip any blank values from beginning of file name
+      // strip any blank values from beginning and end of file name
       StringUtils::stripLeading(filename);
-      // strip any blank values from end of file name
       StringUtils::stripTrailing(filename);
-      // If the file name list is empty, then an error in the file name
+      // If the file name is empty, then an error in the file name list
       if(filename.empty()) {
          oss << "Error - file name " << nf+1 << " is blank";
          continue;
@@ -119,85 +594,33 @@ try {
       vector<int> nOrder;
       vector<CommonTime> timeOrder;
 
+      // throughput of this file, timing only the reading
+      bool opened(false);
+      long nrecords(0), nbytes(0);
+      double seconds(0.0);
+
       // read one file
       for(;;) {
          // open file ---------------------------------------------
-         // converts file name from a string to a vector of characters using c_str
          Rinex3ObsStream strm(filename.c_str());
          // if the obs stream is not successfully opened
          if(!strm.is_open()) {
             oss << "Error - could not open file " << filename << endl;
             break;
          }
+         opened = true;
+         strm.seekg(0, ios::end);
+         nbytes = strm.tellg();
+         strm.seekg(0, ios::beg);
          strm.exceptions(fstream::failbit);
 
          // read header -------------------------------------------
+         Rinex3ObsHeader roh;
          try {
+            Clock::time_point t0(Clock::now());
             strm >> roh;
-
-            // update list of wanted obs types
-            // create iterator for looping through roh.mapObsTypes
-            // make it a const_iterator, so that it can be used for access only,
-            // and cannot be used for modification
-            // the roh.mapObsTypes is of type RinexObsMap, which has format
-            // map<string,RinexObsVec> == map<string,vector<RinexObsID>>
-            // A map where string values are the keys and vector<RinexObsID>
-            // are the values mapped to those strings
-            map<string,vector<RinexObsID> >::const_iterator kt;
-            for(kt = roh.mapObsTypes.begin(); kt != roh.mapObsTypes.end(); kt++) {
-               for(i=0; i<kt->second.size(); i++) {
-                  // need 4-char string version of ObsID
-                  string sys = kt->first;                      // system
-                  string rot = kt->second[i].asString(currVer);// 3-char id
-                  string srot = sys + rot;                     // 4-char id
-                  string code = rot.substr(2,1);               // tracking code
-
-                  // is this ObsID Wanted? and should it be added?
-                  // NB RinexObsID::operator==() handles '*' but does not compare sys
-                  // NB input (loadObsID()) checks validity of ObsIDs
-
-                  for(j=0; j<inputWantedObsTypes.size(); j++) {
-                     if(vectorindex(wantedObsTypes,srot) != -1)
-                        continue;                                 // already there
-
-                     // wsrot = wanted string rinex obs type
-                     string wsrot(inputWantedObsTypes[j]);
-                     
-                     string wsys(wsrot.substr(0,1));
-                     if(wsys != "*" && wsys != sys)               // different systems
-                        continue;
-
-                     string wcode(wsrot.substr(3,1));
-                     if(wcode != "*" && wcode != code)            // different codes
-                        continue;
-
-                     if(wsrot.substr(1,2) != rot.substr(0,2))     // diff type-freq
-                        continue;
-
-                     // ok add it
-                     wantedObsTypes.push_back(srot);              // add it
-                     // the number of observations for each observation type
-                     countWantedObsTypes.push_back(0);
-                        
-                     ossx << " Add obs type " << srot
-                           << " =~ " << inputWantedObsTypes[j]
-                           << " from " << filename << endl;
-                  }
-               }
-            }  // end loop over obs types in header
-
-            // must keep SatObsCountMap vectors parallel to wantedObsTypes
-            if(SatObsCountMap.size() > 0) {                       // table exists
-               vector<int> v(SatObsCountMap.begin()->second);
-               j = wantedObsTypes.size();
-               if(v.size() < j) {                                 // vectors are short
-                  soit = SatObsCountMap.begin();
-                  for( ; soit != SatObsCountMap.end(); ++soit)
-                     soit->second.resize(j , 0);                  // extend with zeros
-               }
-            }
-
-            headers.push_back(roh);
+            seconds += std::chrono::duration<double>(Clock::now() - t0).count();
+            processHeader(roh, filename, ossx);
          }
          catch(Exception& e) {
             oss << "Error - failed to read header for file " << filename
@@ -207,11 +630,12 @@ try {
          }
 
          // loop over epochs --------------------------------------
-         // while(1) always true, so only breaks out of loop with a break statement
+         Rinex3ObsData rod;
          while(1) {
             try {
+               Clock::time_point t0(Clock::now());
                strm >> rod;
-               rod.time.setTimeSystem(TimeSystem::Any);
+               seconds += std::chrono::duration<double>(Clock::now() - t0).count();
             }
             catch(Exception& e) {
                oss << "Error - failed to read data in file " << filename
@@ -221,170 +645,153 @@ try {
 
             // EOF or error
             if(strm.eof() || !strm.good()) break;
+            nrecords++;
 
-            // skip aux header, etc
-            if(rod.epochFlag != 0 && rod.epochFlag != 1) continue;
+            // stop at the stop time or after nepochsToRead epochs
+            if(!processEpoch(rod, roh, onOrder, nOrder, timeOrder)) break;
+         }  // end loop over epochs
 
-            // decimate to dtdec-even sec-of-week
-            if(dtdec > 0.0) {
-               double sow(static_cast<GPSWeekSecond>(rod.time).sow);
-               //LOG(INFO) << fixed << setprecision(3) << "Dt " << dt
-               //<< " dtdec " << dtdec << " sow " << sow
-               //<< " test " << ::fabs(sow-dtdec*long(0.5+sow/dtdec));
-               if(::fabs(sow - dtdec*long(0.5+sow/dtdec)) > 0.5)
-                  continue;
-            }
+         strm.close();
 
-            // consider timestep
-            if(prevtime != CommonTime::BEGINNING_OF_TIME) {
-               // compute time since the previous epoch
-               dt = rod.time - prevtime;
+         break;      // mandatory
+      }  // end for(;;)
 
-               if(dt >= dttol) {      // positive dt only
-                  // add to the timestep estimator
-                  mcv.add(dt);
-               }
-               else if(dt < dttol) {  // negative, and positive but tiny (< dttol)
-                  //if(isLenient) {
-                     if(!onOrder) {
-                        nOrder.push_back(0);
-                        timeOrder.push_back(prevtime);
-                        onOrder = true;
-                     }
-                     nOrder[nOrder.size()-1]++;
-                     continue;
-                  //}
-                  //GPSTK_THROW(Exception(string("Records out of time order: dt ")
-                  //   + StringUtils::asString<double>(dt) + string(" at time ")
-                  //   + printTime(rod.time,timefmt)));
-               }
-               onOrder = false;
-            }
+      nread++;
 
-            // set previous time to current time
-            prevtime = rod.time;
-            // ignore data outside of time limits given by user
-            if(rod.time < startTime) continue;
-            if(rod.time > stopTime) break;
-            if(rod.time < begDataTime) begDataTime = rod.time;
-            if(rod.time > endDataTime) endDataTime = rod.time;
-
-            // The integer number of epochs is advanced
-            nepochs++;
-            if(nepochsToRead > -1 && nepochs >= nepochsToRead) break;
-
-            // prepare output rod
-            outrod.time = rod.time;
-            outrod.clockOffset = rod.clockOffset;
-            outrod.epochFlag = rod.epochFlag;
-            //?? outrod.auxHeader.clear();
-            outrod.numSVs = 0;
-            outrod.obs.clear();
-
-            // loop over satellites, counting data per ObsID
-            Rinex3ObsData::DataMap::const_iterator it;
-            for(it=rod.obs.begin(); it != rod.obs.end(); ++it) {
-               // Create new RinexSatID variable called sat, initialize with the
-               // it->first pointer from rod.obs current iteration
-               RinexSatID sat(it->first);
-
-               // is the sat excluded?  NB it does not exclude sat=(sys,-1)
-               if(exSats.size() > 0 &&
-                  find(exSats.begin(), exSats.end(), sat) != exSats.end())
-                     continue;
+      // warn of time order problems
+      for(i=0; i<timeOrder.size(); i++)
+         oss << "Warning - in file " << filename << " " << nOrder[i]
+            << " data records following epoch "
+            << printTime(timeOrder[i],timefmt) << " are out of time order" << endl;
 
-               // Exract GNSS system from sat ID, creating new string variable sys
-               string sys(sat.toString().substr(0,1));
-               // Extract the observation types from the rinex obs header object
-               // roh corresponding to the GNSS system from the sat ID, creating
-               // new RinexObsID vector types
-               const vector<RinexObsID> types(roh.mapObsTypes[sys]);
-
-               // loop over obs
-               for(i=0; i<it->second.size(); i++) {
-                  // if the obs data is equal to zero, then do not consider that
-                  // obs value (equivalent to missing data)
-                  if(it->second[i].data == 0.0) continue;   // don't count missing
-
-                  // combine the system and obs type into total rinex obs ID
-                  string srot = sys + types[i].asString(currVer); // 4-char RinexObsID
-
-                  // is it wanted? nint is the index into
-                  // wantedObsTypes, SatObsCountMap and outrod.obs
-                  // vectorindex returns the index of the value srot in wantedObsTypes
-                  // if it doesn't exist in that vector, return -1
-                  nint = vectorindex(wantedObsTypes,srot);
-                  if(nint == -1) continue;
-
-                  // count the sat/obs
-                  // map<RinexSatID, std::vector<int>>
-                  soit = SatObsCountMap.find(sat);
-                  if(soit == SatObsCountMap.end()) {           // add the sat
-                     vector<int> v(wantedObsTypes.size(),0);   // keep parallel
-                     SatObsCountMap[sat] = v;                  // creates map entry
-                  }
-                  SatObsCountMap[sat][nint]++;
-                  countWantedObsTypes[nint]++;
-
-                  // add it to outrod
-                  if(saveData) {
-                     // if the satellite is not in outrod.obs
-                     if(outrod.obs.find(sat) == outrod.obs.end()) {
-                        vector<RinexDatum> v(wantedObsTypes.size());
-                        outrod.obs[sat] = v;
-                        outrod.numSVs++;
-                     }
-                     outrod.obs[sat][nint] = it->second[i];
-                  }
-               }
-            }
+      if(opened) reportRead(ossx, filename, nrecords, nbytes, seconds);
 
-            // if saving data, save
-            if(saveData && outrod.obs.size() > 0) datastore.push_back(outrod);
+      if(nepochsToRead > -1 && nepochs >= nepochsToRead) break;
 
-         }  // end loop over epochs
+   }  // end loop over files
 
-         // time steps
-         rawdt = mcv.bestDT();
-         nominalDT = (dtdec > 0.0 ? (dtdec > rawdt ? dtdec : rawdt) : rawdt);
+   return nread;
+}
 
-         strm.close();
+//------------------------------------------------------------------------------------
+// Read the files with a pool of threads, merging their epochs in time order
+// return number of files read
+int Rinex3ObsFileLoader::mergeFiles(ostream& oss, ostream& ossx)
+{
+   unsigned int i,nf;
+
+   // maximum number of records read ahead of the merge, per file
+   static const unsigned int nqueue(64);
+
+   // the files are read with bounded read-ahead by a pool of threads, and
+   // their records merged in time order below
+   vector<FileReader> readers(filenames.size());
+   for(nf=0; nf<filenames.size(); nf++) {
+      readers[nf].filename = filenames[nf];
+      // strip any blank values from beginning and end of file name
+      StringUtils::stripLeading(readers[nf].filename);
+      StringUtils::stripTrailing(readers[nf].filename);
+      if(readers[nf].filename.empty())
+         readers[nf].started = readers[nf].done = true;
+   }
+   std::unique_ptr<FileReaderPool> pool(new FileReaderPool(readers,
+                  std::min<int>(nthreads, filenames.size()), nqueue));
 
-         break;      // mandatory
-      }  // end for(;;)
+   // per-file messages and time order state, reported in file order at the end
+   vector<FileLog> logs(filenames.size());
 
+   // read the headers, in file order
+   // initialize number read counter to zero
+   int nread(0);
+   vector<unsigned int> active;           // files with data still to merge
+   for(nf=0; nf<filenames.size(); nf++) {
+      const string& filename(readers[nf].filename);
+      // If the file name is empty, then an error in the file name list
+      if(filename.empty()) {
+         logs[nf].errs << "Error - file name " << nf+1 << " is blank";
+         continue;
+      }
       nread++;
 
-      // warn of time order problems
-      if(timeOrder.size() > 0) {
-         for(i=0; i<timeOrder.size(); i++)
-            oss << "Warning - in file " << filename << " " << nOrder[i]
-               << " data records following epoch "
-               << printTime(timeOrder[i],timefmt) << " are out of time order" << endl;
+      FileReader& fr(pool->header(nf));
+      if(!fr.opened) {
+         logs[nf].errs << "Error - could not open file " << filename << endl;
+         continue;
       }
 
-      if(nepochsToRead > -1 && nepochs >= nepochsToRead) break;
-
-   }  // end loop over files
+      if(!fr.headerOK) {
+         logs[nf].errs << "Error - failed to read header for file " << filename
+            << " with exception " << fr.errtext << endl;
+         continue;
+      }
+      try {
+         processHeader(fr.roh, filename, ossx);
+      }
+      catch(Exception& e) {
+         pool->drop(nf);
+         logs[nf].errs << "Error - failed to read header for file " << filename
+            << " with exception " << e.getText(0) << endl;
+         continue;
+      }
+      active.push_back(nf);
+   }
 
-   if(!errmsg.empty()) errmsg += string("\n");
-   errmsg += oss.str();
-   if(!errmsg.empty()) {
-      StringUtils::stripTrailing(errmsg,'\n');
-      StringUtils::stripTrailing(errmsg,'\r');
+   // merge the epochs of all files in time order; records with the same time go
+   // in file order, so the later ones are counted as out of time order
+   vector<Rinex3ObsData> next(filenames.size());
+   vector<bool> hasNext(filenames.size(), false);
+   while(active.size() > 0) {
+      int nmin(-1);
+      for(i=0; i<active.size(); i++) {
+         nf = active[i];
+         if(!hasNext[nf]) {
+            hasNext[nf] = pool->pop(nf, next[nf]);
+            if(!hasNext[nf]) {
+               // the error ended the file after the last record
+               if(!readers[nf].dataOK)
+                  logs[nf].errs << "Error - failed to read data in file "
+                     << readers[nf].filename << " with exception "
+                     << readers[nf].errtext << endl;
+               active.erase(active.begin()+i);
+               i--;
+               continue;
+            }
+            next[nf].time.setTimeSystem(TimeSystem::Any);
+         }
+         if(nmin == -1 || next[nf].time < next[nmin].time)
+            nmin = nf;
+      }
+      if(nmin == -1) break;
+
+      hasNext[nmin] = false;
+      // stop at the stop time or after nepochsToRead epochs
+      FileLog& log(logs[nmin]);
+      if(!processEpoch(next[nmin], readers[nmin].roh, log.onOrder, log.nOrder,
+                       log.timeOrder))
+         break;
    }
-   msg = ossx.str();
-   if(!msg.empty()) {
-      StringUtils::stripTrailing(msg,'\n');
-      StringUtils::stripTrailing(msg,'\r');
+
+   // stop the threads before reading their statistics
+   pool.reset();
+
+   for(nf=0; nf<filenames.size(); nf++) {
+      const FileLog& log(logs[nf]);
+      oss << log.errs.str();
+
+      // warn of time order problems
+      for(i=0; i<log.timeOrder.size(); i++)
+         oss << "Warning - in file " << readers[nf].filename << " "
+            << log.nOrder[i] << " data records following epoch "
+            << printTime(log.timeOrder[i],timefmt) << " are out of time order"
+            << endl;
+
+      const FileReader& fr(readers[nf]);
+      if(fr.opened)
+         reportRead(ossx, fr.filename, fr.nrecords, fr.nbytes, fr.seconds);
    }
 
    return nread;
 }
-catch(Exception& e) { GPSTK_RETHROW(e); }
-catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(E); }
-catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
-}
 
 //------------------------------------------------------------------------------------
 string Rinex3ObsFileLoader::asString(void)
@@ -398,7 +805,7 @@ string Rinex3ObsFileLoader::asString(void)
          << filenames[i] << endl;
    oss << " Interval " << fixed << setprecision(2) << getDT() << "sec, obs types";
    for(i=0; i<wantedObsTypes.size(); i++) oss << " " << wantedObsTypes[i];
-   oss << ", store size " << datastore.size();
+   oss << ", store size " << getStoreSize();
    oss << "\n";
    oss << " Time limits: begin  " << printTime(begDataTime,longfmt) << "\n"
        << "                end  " << printTime(endDataTime,longfmt) << "\n";
@@ -430,7 +837,7 @@ int Rinex3ObsFileLoader::WriteSatPassList(const map<char, vector<string> >& sysS
 {
 try {
    if(!dataSaved()) return -3;
-   if(datastore.size() == 0) return -4;
+   if(getStoreSize() == 0) return -4;
 
    char sys;
    int npass(0);
@@ -438,8 +845,6 @@ try {
    unsigned short flag;
    GSatID sat;
    map<GSatID,unsigned int> indexForSat;
-   // satellite iterator
-   map<GSatID,unsigned int>::const_iterator satit;
    // observation iterator
    map<char,vector<string> >::const_iterator obsit;
 
@@ -461,6 +866,55 @@ try {
    vector<double> data(nobs,0.0);
    vector<unsigned short> ssi(nobs,0), lli(nobs,0);
 
+   // loop over the column store; read the columns directly, satellites in the
+   // same (RinexSatID) order as the Rinex3ObsData map
+   if(saveData && saveColumns) {
+      const map<RinexSatID,int>& slots(columnStore.getSlotMap());
+      for(unsigned int nds=0; nds<columnStore.getNumEpochs(); nds++) {
+
+         // loop over satellites
+         map<RinexSatID,int>::const_iterator it;
+         map<char, vector<int> >::const_iterator jt;
+         for(it = slots.begin(); it != slots.end(); ++it) {
+            const int slot(it->second);
+            if(!columnStore.hasData(nds,slot)) continue;
+            sys = it->first.systemChar();
+            jt = indexLoadOT.find(sys);
+            if(jt == indexLoadOT.end())      // skip unwanted system
+               continue;
+            sat = GSatID(it->first);         // converts from RinexSatID
+
+            // get obstypes for this sys
+            obsit = sysSPOT.find(sys);
+            if(obsit == sysSPOT.end())       // sysSPOT not found for system sys
+               return -5;
+
+            // pull data out of store and put in arrays
+            flag = SatPass::OK;
+            for(i=0; i<jt->second.size(); i++) {
+               int ind = jt->second[i];
+               if(ind < 0) {
+                  data[i] = 0.0;
+                  ssi[i] = lli[i] = 0;
+               }
+               else {
+                  data[i] = columnStore.getValue(nds,slot,ind);
+                  ssi[i] = columnStore.getSSI(nds,slot,ind);
+                  lli[i] = columnStore.getLLI(nds,slot,ind);
+                  if(::fabs(data[i]) < 1.e-8) flag = SatPass::BAD;
+               }
+            }
+
+            addSatPassData(sat, columnStore.getTime(nds), obsit->second,
+                           data, lli, ssi, flag, indexForSat, SPList, npass);
+
+         }  // end loop over satellites
+
+      }  // end loop over column store
+
+      return npass;
+   }
+
    // loop over the data store = vector<Rinex3ObsData>
    for(unsigned int nds=0; nds<datastore.size(); nds++) {
 
@@ -509,30 +963,8 @@ try {
             }
          }
 
-         // find the current SatPass for this sat
-         satit = indexForSat.find(sat);
-         if(satit == indexForSat.end()) {       // create a new one
-            SatPass newSP(sat,nominalDT,obsit->second);
-            SPList.push_back(newSP);
-            npass++;
-            indexForSat[sat] = SPList.size()-1;
-            satit = indexForSat.find(sat);
-         }
-
-         // add the data to the SatPass
-         do {
-            i = SPList[satit->second].addData(
-                  datastore[nds].time, obsit->second, data, lli, ssi, flag);
-
-            if(i == -1) {        // there was a gap - break into two passes
-               SatPass newSP(sat,nominalDT,obsit->second);
-               SPList.push_back(newSP);
-               npass++;
-               indexForSat[sat] = SPList.size()-1;
-               satit = indexForSat.find(sat);
-            }
-
-         } while(i == -1);       // will iterate only once, if there is a gap
+         addSatPassData(sat, datastore[nds].time, obsit->second,
+                        data, lli, ssi, flag, indexForSat, SPList, npass);
 
       }  // end loop over satellites
 
@@ -543,6 +975,45 @@ try {
 catch(Exception& e) { GPSTK_RETHROW(e); }
 }
 
+//------------------------------------------------------------------------------------
+// Add one satellite's data at one epoch to the SatPass list, starting a new
+// SatPass for a new satellite or after a gap; used by WriteSatPassList.
+void Rinex3ObsFileLoader::addSatPassData(const GSatID& sat, const CommonTime& ttag,
+                                         const vector<string>& obstypes,
+                                         const vector<double>& data,
+                                         const vector<unsigned short>& lli,
+                                         const vector<unsigned short>& ssi,
+                                         const unsigned short flag,
+                                         map<GSatID,unsigned int>& indexForSat,
+                                         vector<SatPass>& SPList, int& npass)
+{
+   int i;
+
+   // find the current SatPass for this sat
+   map<GSatID,unsigned int>::const_iterator satit = indexForSat.find(sat);
+   if(satit == indexForSat.end()) {       // create a new one
+      SatPass newSP(sat,nominalDT,obstypes);
+      SPList.push_back(newSP);
+      npass++;
+      indexForSat[sat] = SPList.size()-1;
+      satit = indexForSat.find(sat);
+   }
+
+   // add the data to the SatPass
+   do {
+      i = SPList[satit->second].addData(ttag, obstypes, data, lli, ssi, flag);
+
+      if(i == -1) {        // there was a gap - break into two passes
+         SatPass newSP(sat,nominalDT,obstypes);
+         SPList.push_back(newSP);
+         npass++;
+         indexForSat[sat] = SPList.size()-1;
+         satit = indexForSat.find(sat);
+      }
+
+   } while(i == -1);       // will iterate only once, if there is a gap
+}
+
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 // Dump the SatObsCount table
@@ -607,7 +1078,12 @@ void Rinex3ObsFileLoader::dumpStoreEpoch(ostream& s, const Rinex3ObsData& rod) c
 // param ostream s to which to write
 void Rinex3ObsFileLoader::dumpStoreData(ostream& s) const
 {
-   s << "\nDump the ROFL data(" << datastore.size() << "):" << endl;
+   s << "\nDump the ROFL data(" << getStoreSize() << "):" << endl;
+   if(saveData && saveColumns) {
+      for(unsigned int i=0; i<columnStore.getNumEpochs(); i++)
+         dumpStoreEpoch(s,columnStore.getEpoch(i));
+      return;
+   }
    for(unsigned int i=0; i<datastore.size(); i++) {
       const Rinex3ObsData& rod(datastore[i]);
       dumpStoreEpoch(s,rod);
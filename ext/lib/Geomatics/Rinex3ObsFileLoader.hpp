@@ -57,6 +57,8 @@
 
 // gpstk-geomatics
 #include "SatPass.hpp"
+#include "GSatID.hpp"
+#include "Rinex3ObsColumnStore.hpp"
 
 namespace gpstk {
 
@@ -66,6 +68,8 @@ namespace gpstk {
 /// subset of the data into a store.
 /// NB. more than one file can be given, but it is assumed these files are "congruent"
 /// - from the same site, with the same obs types, and in time order - as if one file.
+/// When reading with more than one thread (setNumThreads()), the epochs of all the
+/// files are merged in time order, so those files need not be given in time order.
 /// The operation of the class is as follows.
 /// 1. Declare an object, and give it a list of (Rinex Obs) files
 ///    [cf. ctor(filename) or ctor(filenames) or member files(filenames)].
@@ -84,6 +88,8 @@ private:
    std::vector<std::string> filenames;    ///< input RINEX obs file names
    int nepochsToRead;                     ///< number of epochs to read (default:all)
    bool saveData;                         ///< if true save the data (F)
+   bool saveColumns;                      ///< if true save in columnStore (F)
+   int nthreads;                          ///< number of file reading threads (1)
    std::string timefmt;                   ///< format for time tags in output
    // editing
    double dtdec;                          ///< decimate to this time step
@@ -120,13 +126,49 @@ private:
    std::vector<std::string> obstypes;     ///< RINEX obs types found in data
    std::vector<Rinex3ObsHeader> headers;  ///< headers from reading filenames
 
-   /// vector of all input data - filled only if saveData is true.
+   /// vector of all input data - filled only if saveData is true and
+   /// saveColumns is false.
    std::vector<Rinex3ObsData> datastore;
 
+   /// columnar store of all input data - filled only if saveData and
+   /// saveColumns are true; obs type indexes parallel wantedObsTypes.
+   Rinex3ObsColumnStore columnStore;
+
+   /// add one satellite's data at one epoch to SPList; used by WriteSatPassList
+   void addSatPassData(const GSatID& sat, const CommonTime& ttag,
+                       const std::vector<std::string>& obstypes,
+                       const std::vector<double>& data,
+                       const std::vector<unsigned short>& lli,
+                       const std::vector<unsigned short>& ssi,
+                       const unsigned short flag,
+                       std::map<GSatID,unsigned int>& indexForSat,
+                       std::vector<SatPass>& SPList, int& npass);
+
+   /// update wanted obs types and counts with a new header, and save it;
+   /// used by loadFiles
+   void processHeader(const Rinex3ObsHeader& roh, const std::string& filename,
+                      std::ostream& ossx);
+
+   /// read the files one after the other; used by loadFiles with one thread
+   /// @return number of files read
+   int readFilesInOrder(std::ostream& oss, std::ostream& ossx);
+
+   /// read the files with a pool of threads, merging their epochs in time
+   /// order; used by loadFiles with more than one thread
+   /// @return number of files read
+   int mergeFiles(std::ostream& oss, std::ostream& ossx);
+
+   /// edit, count and save one epoch of data; used by loadFiles
+   /// @return false if no more data should be read, from any file
+   bool processEpoch(Rinex3ObsData& rod, Rinex3ObsHeader& roh, bool& onOrder,
+                     std::vector<int>& nOrder, std::vector<CommonTime>& timeOrder);
+
    /// initialization used by the constructors
    void init(void)
    {
       saveData = false;
+      saveColumns = false;
+      nthreads = 1;
       nepochsToRead = -1;
       timefmt = std::string("%04Y/%02m/%02d %02H:%02M:%02S");
       reset();
@@ -179,6 +221,7 @@ public:
       obstypes.clear();
       mcv.reset();
       datastore.clear();
+      columnStore.clear();
       exSats.clear();
       headers.clear();
       inputWantedObsTypes.clear();
@@ -238,6 +281,25 @@ public:
    /// @return bool if true, then save the data, otherwise just the headers
    inline bool dataSaved(void) { return saveData; }
 
+   /// when the data is saved (saveTheData(true)), save it in a
+   /// Rinex3ObsColumnStore (getColumnStore()) rather than a vector<Rinex3ObsData>
+   /// (getStore()); this uses much less memory.
+   /// @param b bool if true, then save the data in columns
+   inline void saveTheDataAsColumns(bool b) { saveColumns = b; }
+   /// access save data as columns flag
+   /// @return bool if true, then the data is saved in the column store
+   inline bool dataSavedAsColumns(void) const { return saveData && saveColumns; }
+
+   /// read the files with a pool of threads, merging their epochs in time
+   /// order; for files given in time order, without overlap, the output is
+   /// identical to reading with one thread.
+   /// @param n number of threads; 1 (default) reads the files one after the
+   /// other, in the order given
+   inline void setNumThreads(int n) { nthreads = (n < 1 ? 1 : n); }
+   /// access the number of file reading threads
+   /// @return number of threads used by loadFiles()
+   inline int getNumThreads(void) const { return nthreads; }
+
    /// set the start time
    /// @param[in] tt start time, ignore data before this time
    inline void setStartTime(const CommonTime& tt) { startTime = tt; }
@@ -301,18 +363,28 @@ public:
 
    /// get the size of the data store
    /// @return size (number of epochs) in the store
-   inline const int getStoreSize(void) const { return datastore.size(); }
+   inline const int getStoreSize(void) const
+      { return (dataSavedAsColumns() ? columnStore.getNumEpochs()
+                                     : datastore.size()); }
 
    /// access the data store
    /// @return const ref to the datastore: vector<Rinex3ObsData>
    inline const std::vector<Rinex3ObsData>& getStore(void) const
       { return datastore; }
 
+   /// access the columnar data store, filled if saveTheData(true) and
+   /// saveTheDataAsColumns(true)
+   /// @return const ref to the column store; obs type indexes are parallel to
+   ///   getWantedObsTypes()
+   inline const Rinex3ObsColumnStore& getColumnStore(void) const
+      { return columnStore; }
+
    // Read the files ----------------------------------------------------
 
    /// Read the files already defined
    /// @param[out] errmsg an error/warning message, blank for success
-   /// @param[out] msg an informative message
+   /// @param[out] msg an informative message, including the reading
+   ///   throughput of each file
    /// @return 0 ok, >0 number of files read
    int loadFiles(std::string& errmsg, std::string& msg);
 
@@ -0,0 +1,202 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+
+#include "PCodeReplica.hpp"
+#include "SVPCodeGen.hpp"
+#include "GPSWeekZcount.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+class PCodeReplica_T
+{
+public:
+   PCodeReplica_T()
+         : zcount(1854, 201600), prn(5), first(prn), second(prn)
+   {
+      X1Sequence::allocateMemory();
+      X2Sequence::allocateMemory();
+         // the code of two consecutive six-second intervals, the truth
+      SVPCodeGen gen(prn, GPSWeekZcount(zcount.getWeek(), zcount.getZcount()));
+      gen.setKernel(SVPCodeGen::REFERENCE_KERNEL);
+      gen.getCurrentSixSeconds(first);
+      gen.increment4ZCounts();
+      gen.getCurrentSixSeconds(second);
+   }
+
+   ~PCodeReplica_T()
+   {
+      X1Sequence::deAllocateMemory();
+      X2Sequence::deAllocateMemory();
+   }
+
+
+      /// Return chip i after zcount from the reference buffers.
+   int chip(long i)
+   {
+      const long chips = NUM_6SEC_WORDS * MAX_BIT;
+      return (i < chips) ? first.getBit(i) : second.getBit(i - chips);
+   }
+
+
+      /** Count the samples that differ from the reference, generating n
+       * samples a block of 'block' at a time.  The rates are chosen so that
+       * the chip positions are exact in binary. */
+   long countDiffs(SVPCodeGen::Kernel kernel, double chipOffset,
+                   double chipsPerSample, long n, long block)
+   {
+      PCodeReplica rep(prn, zcount, chipOffset, 1e6, 1e6 * chipsPerSample);
+      rep.setKernel(kernel);
+      vector<int8_t> samples(n);
+      for (long k=0; k<n; k+=block)
+         rep.generate(&samples[k], min(block, n-k));
+      long diffs = 0;
+      for (long k=0; k<n; ++k)
+      {
+         long i = (long)std::floor(chipOffset + k * chipsPerSample);
+         if (samples[k] != 1 - 2 * chip(i)) ++diffs;
+      }
+      return diffs;
+   }
+
+
+      /// Compare the samples of one kernel against CodeBuffer::getBit.
+   unsigned sampleTest(SVPCodeGen::Kernel kernel, const string& name)
+   {
+      TUDEF("PCodeReplica", "generate(" + name + ")");
+
+         // two samples per chip, odd block sizes
+      TUASSERTE(long, 0, countDiffs(kernel, 0.25, 0.5, 100000, 777));
+         // 4/3 samples per chip, crossing many windows
+      TUASSERTE(long, 0, countDiffs(kernel, 12345.5, 0.75, 200000, 100000));
+         // one sample every four chips
+      TUASSERTE(long, 0, countDiffs(kernel, 3.0, 4.0, 50000, 50000));
+         // across the six-second boundary
+      TUASSERTE(long, 0, countDiffs(kernel, NUM_6SEC_WORDS*MAX_BIT - 20000.,
+                                    0.625, 80000, 4099));
+
+      TURETURN();
+   }
+
+
+      /// Compare generatePacked against generate.
+   unsigned packedTest()
+   {
+      TUDEF("PCodeReplica", "generatePacked");
+
+      const long n = 10000 + 17;
+      PCodeReplica rep1(prn, zcount, 1000.0, 25e6);
+      PCodeReplica rep2(prn, zcount, 1000.0, 25e6);
+      vector<int8_t> samples(n);
+      vector<uint32_t> words((n + 31) / 32);
+      rep1.generate(&samples[0], n);
+      rep2.generatePacked(&words[0], n);
+      long diffs = 0;
+      for (long k=0; k<n; ++k)
+      {
+         uint32_t bit = (words[k/32] >> (31 - k%32)) & 1;
+         if ((samples[k] < 0) != (bit == 1)) ++diffs;
+      }
+      TUASSERTE(long, 0, diffs);
+         // unused bits of the last word are 0
+      TUASSERTE(uint32_t, 0, words.back() & ((1u << (32 - n%32)) - 1));
+      TUASSERTFE(rep1.getChipOffset(), rep2.getChipOffset());
+      TUASSERTFEPS(1000.0 + n * 10.23 / 25, rep1.getChipOffset(), 1e-6);
+
+      TURETURN();
+   }
+
+
+      /// Invalid arguments
+   unsigned argTest()
+   {
+      TUDEF("PCodeReplica", "PCodeReplica");
+
+      try
+      {
+         PCodeReplica rep(prn, zcount, -1.0, 25e6);
+         TUFAIL("negative chip offset should throw");
+      }
+      catch (Exception& e)
+      {
+         TUPASS("negative chip offset");
+      }
+      try
+      {
+         PCodeReplica rep(prn, zcount, 0.0, 0.0);
+         TUFAIL("zero sample rate should throw");
+      }
+      catch (Exception& e)
+      {
+         TUPASS("zero sample rate");
+      }
+
+      TURETURN();
+   }
+
+
+   GPSZcount zcount;
+   int prn;
+   CodeBuffer first, second;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   PCodeReplica_T testClass;
+
+   errorTotal += testClass.sampleTest(SVPCodeGen::SCALAR_KERNEL, "scalar");
+   if (SVPCodeGen::haveAVX2())
+      errorTotal += testClass.sampleTest(SVPCodeGen::AVX2_KERNEL, "avx2");
+   else
+      cout << "AVX2 not supported, not tested" << endl;
+   errorTotal += testClass.packedTest();
+   errorTotal += testClass.argTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,180 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <vector>
+#include <iostream>
+
+#include "SVPCodeGen.hpp"
+#include "GPSWeekSecond.hpp"
+#include "GPSWeekZcount.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+class SVPCodeGen_T
+{
+public:
+   SVPCodeGen_T()
+   {
+      X1Sequence::allocateMemory();
+      X2Sequence::allocateMemory();
+         // beginning, middle and final six seconds of the week
+      times.push_back(GPSWeekSecond(1854, 0));
+      times.push_back(GPSWeekSecond(1854, 302400));
+      times.push_back(GPSWeekZcount(1854, 403196));
+         // PRNs 38 and up are the later days of the week of PRNs 1-37
+      prns.push_back(1);
+      prns.push_back(5);
+      prns.push_back(37);
+      prns.push_back(38);
+      prns.push_back(100);
+   }
+
+   ~SVPCodeGen_T()
+   {
+      X1Sequence::deAllocateMemory();
+      X2Sequence::deAllocateMemory();
+   }
+
+
+      /// Return the number of words that differ between two buffers.
+   long countDiffs(const CodeBuffer& a, const CodeBuffer& b)
+   {
+      long diffs = 0;
+      for (long i=0; i<NUM_6SEC_WORDS; ++i)
+         if (a[i] != b[i]) ++diffs;
+      return diffs;
+   }
+
+
+      /// Compare one kernel against the reference loop.
+   unsigned kernelTest(SVPCodeGen::Kernel kernel, const string& name)
+   {
+      TUDEF("SVPCodeGen", "getCurrentSixSeconds(" + name + ")");
+
+      for (size_t t=0; t<times.size(); ++t)
+      {
+         for (size_t p=0; p<prns.size(); ++p)
+         {
+            SVPCodeGen ref(prns[p], times[t]);
+            ref.setKernel(SVPCodeGen::REFERENCE_KERNEL);
+            SVPCodeGen gen(prns[p], times[t]);
+            gen.setKernel(kernel);
+            TUASSERTE(SVPCodeGen::Kernel, kernel, gen.getKernel());
+            CodeBuffer refBuf(prns[p]), genBuf(prns[p]);
+            ref.getCurrentSixSeconds(refBuf);
+            gen.getCurrentSixSeconds(genBuf);
+            TUASSERTE(long, 0, countDiffs(refBuf, genBuf));
+         }
+      }
+
+      TURETURN();
+   }
+
+
+      /// Generate several PRNs at once with several threads.
+   unsigned multiTest()
+   {
+      TUDEF("SVPCodeGen", "getCurrentSixSeconds(multi)");
+
+      for (size_t t=0; t<times.size(); ++t)
+      {
+         vector<SVPCodeGen*> gens;
+         vector<CodeBuffer*> bufs;
+         for (size_t p=0; p<prns.size(); ++p)
+         {
+            gens.push_back(new SVPCodeGen(prns[p], times[t]));
+            bufs.push_back(new CodeBuffer(prns[p]));
+         }
+            // mix the kernels
+         gens[0]->setKernel(SVPCodeGen::SCALAR_KERNEL);
+         SVPCodeGen::getCurrentSixSeconds(gens, bufs, 3);
+
+         for (size_t p=0; p<prns.size(); ++p)
+         {
+            SVPCodeGen ref(prns[p], times[t]);
+            ref.setKernel(SVPCodeGen::REFERENCE_KERNEL);
+            CodeBuffer refBuf(prns[p]);
+            ref.getCurrentSixSeconds(refBuf);
+            TUASSERTE(long, 0, countDiffs(refBuf, *bufs[p]));
+            TUASSERT(refBuf.getCurrentTime() == bufs[p]->getCurrentTime());
+            delete gens[p];
+            delete bufs[p];
+         }
+      }
+
+      vector<SVPCodeGen*> gens(2, static_cast<SVPCodeGen*>(NULL));
+      vector<CodeBuffer*> bufs(1, static_cast<CodeBuffer*>(NULL));
+      try
+      {
+         SVPCodeGen::getCurrentSixSeconds(gens, bufs);
+         TUFAIL("mismatched vectors should throw");
+      }
+      catch (Exception& e)
+      {
+         TUPASS("mismatched vectors");
+      }
+
+      TURETURN();
+   }
+
+
+   vector<CommonTime> times;
+   vector<int> prns;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   SVPCodeGen_T testClass;
+
+   errorTotal += testClass.kernelTest(SVPCodeGen::SCALAR_KERNEL, "scalar");
+   if (SVPCodeGen::haveAVX2())
+      errorTotal += testClass.kernelTest(SVPCodeGen::AVX2_KERNEL, "avx2");
+   else
+      cout << "AVX2 not supported, not tested" << endl;
+   errorTotal += testClass.multiTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,498 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsColumnStore_T.cpp Test Rinex3ObsColumnStore, and the columnar
+/// and multi-threaded modes of Rinex3ObsFileLoader.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include "Rinex3ObsColumnStore.hpp"
+#include "Rinex3ObsFileLoader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "TestUtil.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+using namespace gpstk;
+
+//------------------------------------------------------------------------------------
+class Rinex3ObsColumnStore_T
+{
+public:
+   /// test the store on its own
+   unsigned storeTest();
+   /// compare the loader's column store with its vector<Rinex3ObsData>
+   unsigned loaderTest();
+   /// compare loading several files with threads and without
+   unsigned threadTest();
+   /// load files given out of time order, and a limited number of epochs
+   unsigned orderTest();
+   /// load a file with blank fields in columns and write it back
+   unsigned roundTripTest();
+   /// load one file both ways and compare
+   void compareLoad(TestUtil& testFramework, const string& filename);
+};
+
+//------------------------------------------------------------------------------------
+unsigned Rinex3ObsColumnStore_T::storeTest()
+{
+   TUDEF("Rinex3ObsColumnStore", "setDatum");
+
+   Rinex3ObsColumnStore store;
+   vector<string> ots;
+   ots.push_back("GC1C");
+   ots.push_back("GL1C");
+   store.setObsTypes(ots);
+
+   RinexSatID g01(1,SatelliteSystem::GPS), g02(2,SatelliteSystem::GPS);
+   CommonTime t0(CommonTime::BEGINNING_OF_TIME), t1(t0);
+   t0.setTimeSystem(TimeSystem::Any);
+   t1 = t0 + 30.;
+   RinexDatum rd;
+   rd.data = 21000000.123;
+   rd.lli = 1;
+   rd.ssi = 7;
+   rd.ssiBlank = true;
+
+   TUASSERTE(unsigned, 0, store.addEpoch(t0,1.e-4,0));
+   TUASSERTE(int, 0, store.addSlot(g01));
+   TUASSERTE(int, 0, store.addSlot(g01));
+   TUCATCH(store.setDatum(0, 0, 1, rd));
+   TUTHROW(store.setDatum(1, 0, 1, rd));
+   TUTHROW(store.setDatum(0, 0, 2, rd));
+   TUTHROW(store.addEpoch(t0 - 30.));
+
+   TUASSERTE(unsigned, 1, store.addEpoch(t1));
+   TUASSERTE(int, 1, store.addSlot(g02));
+   TUCATCH(store.setDatum(1, 1, 0, rd));
+
+   TUASSERTE(int, -1, store.getSlot(RinexSatID(3,SatelliteSystem::GPS)));
+   TUASSERTE(bool, true, store.hasData(0,0));
+   TUASSERTE(bool, false, store.hasData(1,0));
+   TUASSERTE(bool, false, store.hasData(0,1));
+   TUASSERTE(bool, true, store.hasData(1,1));
+   TUASSERTFE(rd.data, store.getValue(0,0,1));
+   TUASSERTFE(0.0, store.getValue(0,0,0));
+   TUASSERTFE(0.0, store.getValue(1,0,1));
+   TUASSERTE(unsigned short, 1, store.getLLI(0,0,1));
+   TUASSERTE(unsigned short, 7, store.getSSI(0,0,1));
+   TUASSERTE(unsigned short, 0, store.getSSI(1,0,1));
+   TUASSERTE(bool, true, store.getDatum(0,0,1).ssiBlank);
+   TUASSERTE(bool, false, store.getDatum(0,0,1).lliBlank);
+   TUASSERTE(bool, false, store.isDataBlank(0,0,1));
+   // a datum never stored is blank
+   TUASSERTE(bool, true, store.getDatum(0,0,0).ssiBlank);
+   TUASSERTE(bool, true, store.isDataBlank(0,0,0));
+
+   // adding an obs type keeps the existing data in place
+   TUASSERTE(int, 2, store.addObsType("GC2W"));
+   TUASSERTFE(rd.data, store.getValue(0,0,1));
+   TUASSERTFE(rd.data, store.getValue(1,1,0));
+   TUASSERTFE(0.0, store.getValue(1,1,2));
+   TUCATCH(store.setDatum(1, 1, 2, rd));
+   TUASSERTFE(rd.data, store.getValue(1,1,2));
+
+   // columns of G02 start at its first epoch
+   unsigned int first, len;
+   const double *col = store.getValueColumn(1, 0, first, len);
+   TUASSERTE(unsigned, 1, first);
+   TUASSERTE(unsigned, 1, len);
+   TUASSERTFE(rd.data, col[0]);
+
+   Rinex3ObsData rod(store.getEpoch(0));
+   TUASSERTE(CommonTime, t0, rod.time);
+   TUASSERTFE(1.e-4, rod.clockOffset);
+   TUASSERTE(short, 1, rod.numSVs);
+   TUASSERTE(size_t, 1, rod.obs.size());
+   TUASSERTE(size_t, 3, rod.obs[g01].size());
+   TUASSERTFE(rd.data, rod.obs[g01][1].data);
+
+   // storing an earlier epoch moves the start of the columns back
+   TUCATCH(store.setDatum(0, 1, 1, rd));
+   TUASSERTE(bool, true, store.hasData(0,1));
+   TUASSERTFE(rd.data, store.getValue(0,1,1));
+   TUASSERTFE(rd.data, store.getValue(1,1,0));
+   TUASSERTE(bool, true, store.isDataBlank(0,1,0));
+   col = store.getValueColumn(1, 0, first, len);
+   TUASSERTE(unsigned, 0, first);
+   TUASSERTE(unsigned, 2, len);
+   TUASSERTFE(rd.data, col[1]);
+
+   store.compact();
+   TUASSERT(store.getMemoryUsed() > 0);
+   store.clear();
+   TUASSERTE(unsigned, 0, store.getNumEpochs());
+   TUASSERTE(int, 0, store.getNumSlots());
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+// Remove the " Read file" throughput lines from a loadFiles() msg
+// return number of lines removed
+static int stripThroughput(string& msg)
+{
+   istringstream iss(msg);
+   string line;
+   int n(0);
+   msg.clear();
+   while(getline(iss, line)) {
+      if(line.find(" Read file ") == 0) { n++; continue; }
+      msg += (msg.empty() ? "" : "\n") + line;
+   }
+   return n;
+}
+
+//------------------------------------------------------------------------------------
+void Rinex3ObsColumnStore_T::compareLoad(TestUtil& testFramework,
+                                         const string& filename)
+{
+   const char *ots[] = { "GC1C", "GL1C", "GC2W", "GL2W", "RC1C", "EC1X" };
+   Rinex3ObsFileLoader vload(filename), cload(filename);
+   for(unsigned int i=0; i<sizeof(ots)/sizeof(ots[0]); i++) {
+      vload.loadObsID(ots[i]);
+      cload.loadObsID(ots[i]);
+   }
+   vload.saveTheData(true);
+   cload.saveTheData(true);
+   cload.saveTheDataAsColumns(true);
+   TUASSERTE(bool, true, cload.dataSaved());
+   TUASSERTE(bool, true, cload.dataSavedAsColumns());
+
+   string verr, vmsg, cerr, cmsg;
+   TUASSERTE(int, 1, vload.loadFiles(verr, vmsg));
+   TUASSERTE(int, 1, cload.loadFiles(cerr, cmsg));
+   TUASSERTE(string, verr, cerr);
+   stripThroughput(vmsg);
+   stripThroughput(cmsg);
+   TUASSERTE(string, vmsg, cmsg);
+
+   const vector<Rinex3ObsData>& vstore(vload.getStore());
+   const Rinex3ObsColumnStore& cstore(cload.getColumnStore());
+   TUASSERT(vstore.size() > 0);
+   TUASSERTE(int, vload.getStoreSize(), cload.getStoreSize());
+   TUASSERTE(unsigned, vstore.size(), cstore.getNumEpochs());
+   TUASSERTE(int, vload.getWantedObsTypes().size(), cstore.getNumObsTypes());
+
+   for(unsigned int i=0; i<vstore.size() && i<cstore.getNumEpochs(); i++) {
+      Rinex3ObsData rod(cstore.getEpoch(i));
+      TUASSERTE(CommonTime, vstore[i].time, rod.time);
+      TUASSERTE(short, vstore[i].numSVs, rod.numSVs);
+      TUASSERTE(size_t, vstore[i].obs.size(), rod.obs.size());
+      Rinex3ObsData::DataMap::const_iterator vit, cit;
+      for(vit = vstore[i].obs.begin(), cit = rod.obs.begin();
+          vit != vstore[i].obs.end() && cit != rod.obs.end(); ++vit, ++cit) {
+         TUASSERTE(RinexSatID, vit->first, cit->first);
+         TUASSERTE(size_t, vit->second.size(), cit->second.size());
+         for(unsigned int j=0; j<vit->second.size(); j++) {
+            TUASSERTE(double, vit->second[j].data, cit->second[j].data);
+            TUASSERTE(short, vit->second[j].lli, cit->second[j].lli);
+            TUASSERTE(short, vit->second[j].ssi, cit->second[j].ssi);
+            // the vector store leaves obs types missing from the file
+            // unflagged, where the column store marks them blank
+            if(vit->second[j].data == 0.0 && cit->second[j].dataBlank)
+               continue;
+            TUASSERTE(bool, vit->second[j].dataBlank, cit->second[j].dataBlank);
+            TUASSERTE(bool, vit->second[j].lliBlank, cit->second[j].lliBlank);
+            TUASSERTE(bool, vit->second[j].ssiBlank, cit->second[j].ssiBlank);
+         }
+      }
+   }
+
+   // SatPass lists must be the same from either store
+   map<char, vector<string> > sysSPOT;
+   map<char, vector<int> > indexLoadOT;
+   sysSPOT['G'].push_back("L1");
+   sysSPOT['G'].push_back("C1");
+   indexLoadOT['G'].push_back(1);
+   indexLoadOT['G'].push_back(0);
+   vector<SatPass> vSPList, cSPList;
+   int vnpass = vload.WriteSatPassList(sysSPOT, indexLoadOT, vSPList);
+   int cnpass = cload.WriteSatPassList(sysSPOT, indexLoadOT, cSPList);
+   TUASSERT(vnpass > 0);
+   TUASSERTE(int, vnpass, cnpass);
+   TUASSERTE(size_t, vSPList.size(), cSPList.size());
+   for(unsigned int i=0; i<vSPList.size() && i<cSPList.size(); i++) {
+      TUASSERTE(GSatID, vSPList[i].getSat(), cSPList[i].getSat());
+      TUASSERTE(int, vSPList[i].size(), cSPList[i].size());
+      TUASSERTE(int, vSPList[i].getNgood(), cSPList[i].getNgood());
+      for(unsigned int j=0; j<vSPList[i].size() && j<cSPList[i].size(); j++) {
+         TUASSERTE(double, vSPList[i].data(j,"L1"), cSPList[i].data(j,"L1"));
+         TUASSERTE(double, vSPList[i].data(j,"C1"), cSPList[i].data(j,"C1"));
+      }
+   }
+}
+
+//------------------------------------------------------------------------------------
+unsigned Rinex3ObsColumnStore_T::loaderTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "saveTheDataAsColumns");
+   string dp(getPathData() + getFileSep());
+   compareLoad(testFramework, dp + "test_input_rinex3_76193040.14o");
+   compareLoad(testFramework,
+               dp + "inputs" + getFileSep() + "igs" + getFileSep() + "nrmg0150.16o");
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+unsigned Rinex3ObsColumnStore_T::threadTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "setNumThreads");
+   string dp(getPathData() + getFileSep());
+   string igs(dp + "inputs" + getFileSep() + "igs" + getFileSep());
+   // in time order and without overlap, so that reading in order and merging
+   // give the same result
+   vector<string> files;
+   files.push_back(dp + "test_input_rinex2_obs_BadEpochFlag.06o");
+   files.push_back("  ");
+   files.push_back(dp + "test_input_rinex3_76193040.14o");
+   files.push_back(dp + "arlm200a.15o");
+   files.push_back(dp + "no_such_file.16o");
+   files.push_back(igs + "nrmg0150.16o");
+
+   for(int columns=0; columns<2; columns++) {
+      Rinex3ObsFileLoader sload(files), tload(files);
+      sload.loadObsID("*C1*");
+      sload.loadObsID("GL1C");
+      sload.loadObsID("GL2W");
+      tload.loadObsID("*C1*");
+      tload.loadObsID("GL1C");
+      tload.loadObsID("GL2W");
+      sload.saveTheData(true);
+      tload.saveTheData(true);
+      sload.saveTheDataAsColumns(columns != 0);
+      tload.saveTheDataAsColumns(columns != 0);
+      TUASSERTE(int, 1, tload.getNumThreads());
+      tload.setNumThreads(3);
+      TUASSERTE(int, 3, tload.getNumThreads());
+
+      string serr, smsg, terr, tmsg;
+      int nread = sload.loadFiles(serr, smsg);
+      TUASSERTE(int, files.size()-1, nread);
+      TUASSERTE(int, nread, tload.loadFiles(terr, tmsg));
+      TUASSERT(!serr.empty());
+      TUASSERTE(string, serr, terr);
+      // msg is the same apart from the throughput line of each file opened
+      TUASSERTE(int, 4, stripThroughput(smsg));
+      TUASSERTE(int, 4, stripThroughput(tmsg));
+      TUASSERTE(string, smsg, tmsg);
+
+      TUASSERTE(double, sload.getDT(), tload.getDT());
+      TUASSERTE(CommonTime, sload.getDataBeginTime(), tload.getDataBeginTime());
+      TUASSERTE(CommonTime, sload.getDataEndTime(), tload.getDataEndTime());
+      TUASSERT(sload.getWantedObsTypes() == tload.getWantedObsTypes());
+      TUASSERT(sload.getTotalObsCounts() == tload.getTotalObsCounts());
+      TUASSERT(sload.getWantedSatObsCountMap() == tload.getWantedSatObsCountMap());
+      TUASSERTE(string, sload.asString(), tload.asString());
+
+      TUASSERT(sload.getStoreSize() > 0);
+      TUASSERTE(int, sload.getStoreSize(), tload.getStoreSize());
+      if(columns) {
+         ostringstream sdump, tdump;
+         sload.dumpStoreData(sdump);
+         tload.dumpStoreData(tdump);
+         TUASSERTE(string, sdump.str(), tdump.str());
+         continue;
+      }
+
+      // read in order, the vector store has only the obs types found so far,
+      // where merging has read all the headers first; the data are the same
+      const vector<Rinex3ObsData>& sstore(sload.getStore());
+      const vector<Rinex3ObsData>& tstore(tload.getStore());
+      for(unsigned int i=0; i<sstore.size() && i<tstore.size(); i++) {
+         TUASSERTE(CommonTime, sstore[i].time, tstore[i].time);
+         TUASSERTE(size_t, sstore[i].obs.size(), tstore[i].obs.size());
+         Rinex3ObsData::DataMap::const_iterator sit, tit;
+         for(sit = sstore[i].obs.begin(), tit = tstore[i].obs.begin();
+             sit != sstore[i].obs.end() && tit != tstore[i].obs.end();
+             ++sit, ++tit) {
+            TUASSERTE(RinexSatID, sit->first, tit->first);
+            TUASSERT(sit->second.size() <= tit->second.size());
+            for(unsigned int j=0; j<tit->second.size(); j++) {
+               double data(j < sit->second.size() ? sit->second[j].data : 0.0);
+               TUASSERTE(double, data, tit->second[j].data);
+            }
+         }
+      }
+   }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+unsigned Rinex3ObsColumnStore_T::orderTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   string dp(getPathData() + getFileSep());
+   string later(dp + "inputs" + getFileSep() + "igs" + getFileSep() + "nrmg0150.16o");
+   string earlier(dp + "test_input_rinex3_76193040.14o");
+   vector<string> files;
+   files.push_back(later);
+   files.push_back(earlier);
+
+   // with threads, files given out of time order are merged into time order
+   Rinex3ObsFileLoader lload(later), eload(earlier), mload(files);
+   lload.loadObsID("GC1C");
+   eload.loadObsID("GC1C");
+   mload.loadObsID("GC1C");
+   lload.saveTheData(true);
+   eload.saveTheData(true);
+   mload.saveTheData(true);
+   mload.setNumThreads(3);
+   string err, msg;
+   TUASSERTE(int, 1, lload.loadFiles(err, msg));
+   TUASSERTE(int, 1, eload.loadFiles(err, msg));
+   err.clear();
+   TUASSERTE(int, 2, mload.loadFiles(err, msg));
+   TUASSERT(err.find("out of time order") == string::npos);
+   TUASSERT(eload.getStoreSize() > 0);
+   TUASSERTE(int, eload.getStoreSize() + lload.getStoreSize(),
+             mload.getStoreSize());
+   TUASSERTE(CommonTime, eload.getDataBeginTime(), mload.getDataBeginTime());
+   TUASSERTE(CommonTime, lload.getDataEndTime(), mload.getDataEndTime());
+   const vector<Rinex3ObsData>& store(mload.getStore());
+   for(unsigned int i=1; i<store.size(); i++)
+      TUASSERT(store[i-1].time < store[i].time);
+
+   // reading stops after the requested number of epochs
+   Rinex3ObsFileLoader nload(files);
+   nload.loadObsID("GC1C");
+   nload.saveTheData(true);
+   nload.nEpochsToRead(10);
+   nload.setNumThreads(3);
+   TUASSERTE(int, 2, nload.loadFiles(err, msg));
+   TUASSERTE(int, 9, nload.getStoreSize());
+   TUASSERTE(CommonTime, eload.getDataBeginTime(), nload.getDataBeginTime());
+   // the epoch that reaches the limit ends the data, but is not stored
+   TUASSERTE(CommonTime, eload.getStore()[9].time, nload.getDataEndTime());
+
+   // with one thread, files are read in the order given, and the data of the
+   // earlier file are out of time order
+   Rinex3ObsFileLoader sload(files);
+   sload.loadObsID("GC1C");
+   sload.saveTheData(true);
+   err.clear();
+   TUASSERTE(int, 2, sload.loadFiles(err, msg));
+   TUASSERT(err.find("Warning - in file " + earlier) != string::npos);
+   TUASSERTE(int, lload.getStoreSize(), sload.getStoreSize());
+   TUASSERTE(CommonTime, lload.getDataBeginTime(), sload.getDataBeginTime());
+   TUASSERTE(CommonTime, lload.getDataEndTime(), sload.getDataEndTime());
+
+   // reading stops in the first file after the requested number of epochs
+   vector<string> ordered;
+   ordered.push_back(earlier);
+   ordered.push_back(later);
+   Rinex3ObsFileLoader snload(ordered);
+   snload.loadObsID("GC1C");
+   snload.saveTheData(true);
+   snload.nEpochsToRead(10);
+   TUASSERTE(int, 1, snload.loadFiles(err, msg));
+   TUASSERTE(int, 9, snload.getStoreSize());
+   TUASSERTE(CommonTime, eload.getStore()[9].time, snload.getDataEndTime());
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+unsigned Rinex3ObsColumnStore_T::roundTripTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "saveTheDataAsColumns");
+   string input(getPathData() + getFileSep() + "test_input_rinex3_76193040.14o");
+   string tmp(getPathTestTemp() + getFileSep());
+   string expFile(tmp + "test_output_rinex3_columns_exp.14o");
+   string gotFile(tmp + "test_output_rinex3_columns_got.14o");
+
+   // load every obs type of the (GPS only) file, in header order, so the
+   // column store's epochs can be written with the file's own header
+   Rinex3ObsStream istrm(input.c_str());
+   Rinex3ObsHeader hdr;
+   istrm >> hdr;
+   Rinex3ObsFileLoader cload(input);
+   const vector<RinexObsID>& rots(hdr.mapObsTypes["G"]);
+   for(unsigned int i=0; i<rots.size(); i++)
+      cload.loadObsID(string("G") + rots[i].asString());
+   cload.saveTheData(true);
+   cload.saveTheDataAsColumns(true);
+   string err, msg;
+   TUASSERTE(int, 1, cload.loadFiles(err, msg));
+   const Rinex3ObsColumnStore& cstore(cload.getColumnStore());
+   TUASSERTE(int, rots.size(), cstore.getNumObsTypes());
+
+   // the expected output is the file written straight from the stream
+   Rinex3ObsStream estrm(expFile.c_str(), ios::out);
+   Rinex3ObsStream gstrm(gotFile.c_str(), ios::out);
+   estrm << hdr;
+   gstrm << hdr;
+   Rinex3ObsData rod;
+   unsigned int nblank(0);
+   while(istrm >> rod) {
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it = rod.obs.begin(); it != rod.obs.end(); ++it)
+         for(unsigned int j=0; j<it->second.size(); j++)
+            if(it->second[j].dataBlank || it->second[j].ssiBlank) nblank++;
+      estrm << rod;
+   }
+   for(unsigned int i=0; i<cstore.getNumEpochs(); i++)
+      gstrm << cstore.getEpoch(i);
+   estrm.close();
+   gstrm.close();
+   TUASSERT(nblank > 0);
+   TUCMPFILE(expFile, gotFile, 0);
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int main(void)
+{
+   unsigned errorTotal(0);
+   Rinex3ObsColumnStore_T testClass;
+
+   errorTotal += testClass.storeTest();
+   errorTotal += testClass.loaderTest();
+   errorTotal += testClass.threadTest();
+   errorTotal += testClass.orderTest();
+   errorTotal += testClass.roundTripTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
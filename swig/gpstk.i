@@ -347,6 +347,7 @@ namespace std { class fstream {}; }
 %include "SP3Stream.hpp"
 %include "PositionSatStore.hpp"
 %include "SP3EphemerisStore.hpp"
+%include "XvtStoreSnapshot.hpp"
 %include "RinexUtilities.hpp"
 
 // SEM format:
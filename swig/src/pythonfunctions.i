@@ -204,6 +204,7 @@ STR_DUMP_DETAIL_HELPER(GloEphemerisStore)
 STR_DUMP_DETAIL_HELPER(GPSEphemerisStore)
 STR_DUMP_DETAIL_HELPER(Rinex3EphemerisStore)
 STR_DUMP_DETAIL_HELPER(SP3EphemerisStore)
+STR_DUMP_DETAIL_HELPER(XvtStoreSnapshot)
 
 
 